@@ -66,6 +66,9 @@ public class Index implements Cloneable, Serializable {
     /** Whether the posting lists of this index field should have interleaved features (num occs, field length) in document id stream. */
     private boolean interleavedFeatures = false;
 
+    /** Whether the posting lists of this index field should have per block max weights, used by block max wand. */
+    private boolean blockMaxWeights = false;
+
     public Index(String name) {
         this(name, false);
     }
@@ -128,6 +131,7 @@ public class Index implements Cloneable, Serializable {
         return prefix == index.prefix &&
                 normalized == index.normalized &&
                 interleavedFeatures == index.interleavedFeatures &&
+                blockMaxWeights == index.blockMaxWeights &&
                 Objects.equals(name, index.name) &&
                 rankType == index.rankType &&
                 Objects.equals(aliases, index.aliases) &&
@@ -139,7 +143,7 @@ public class Index implements Cloneable, Serializable {
 
     @Override
     public int hashCode() {
-        return Objects.hash(name, rankType, prefix, aliases, stemming, normalized, type, boolIndex, hnswIndexParams, interleavedFeatures);
+        return Objects.hash(name, rankType, prefix, aliases, stemming, normalized, type, boolIndex, hnswIndexParams, interleavedFeatures, blockMaxWeights);
     }
 
     public String toString() {
@@ -203,4 +207,12 @@ public class Index implements Cloneable, Serializable {
         return interleavedFeatures;
     }
 
+    public void setBlockMaxWeights(boolean value) {
+        blockMaxWeights = value;
+    }
+
+    public boolean useBlockMaxWeights() {
+        return blockMaxWeights;
+    }
+
 }
@@ -214,6 +214,15 @@ public class AttributeFields extends Derived implements AttributesConfig.Produce
         if (attribute.isFastAccess()) {
             aaB.fastaccess(true);
         }
+        if (attribute.isPaged()) {
+            aaB.paged(true);
+        }
+        if (attribute.isPacked()) {
+            aaB.packed(true);
+        }
+        if (attribute.maxDeltaRatio() > 0.0) {
+            aaB.maxdeltaratio(attribute.maxDeltaRatio());
+        }
         if (attribute.isMutable()) {
             aaB.ismutable(true);
         }
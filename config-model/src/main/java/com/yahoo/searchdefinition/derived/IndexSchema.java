@@ -120,7 +120,8 @@ public class IndexSchema extends Derived implements IndexschemaConfig.Producer {
                 .prefix(f.hasPrefix())
                 .phrases(f.hasPhrases())
                 .positions(f.hasPositions())
-                .interleavedfeatures(f.useInterleavedFeatures());
+                .interleavedfeatures(f.useInterleavedFeatures())
+                .blockmaxweights(f.useBlockMaxWeights());
             if (!f.getCollectionType().equals("SINGLE")) {
                 ifB.collectiontype(IndexschemaConfig.Indexfield.Collectiontype.Enum.valueOf(f.getCollectionType()));
             }
@@ -182,6 +183,9 @@ public class IndexSchema extends Derived implements IndexschemaConfig.Producer {
         private BooleanIndexDefinition boolIndex = null;
         // Whether the posting lists of this index field should have interleaved features (num occs, field length) in document id stream.
         private boolean interleavedFeatures = false;
+        // Whether the posting lists of this index field should have per block max weights, used by block max wand.
+        // Only weighted set fields have element weights that vary between documents.
+        private boolean blockMaxWeights = false;
 
         public IndexField(String name, Index.Type type, DataType sdFieldType) {
             this.name = name;
@@ -192,6 +196,7 @@ public class IndexSchema extends Derived implements IndexschemaConfig.Producer {
             if (type.equals(Index.Type.TEXT)) {
                 prefix = index.isPrefix();
                 interleavedFeatures = index.useInterleavedFeatures();
+                blockMaxWeights = index.useBlockMaxWeights() && (sdFieldType instanceof WeightedSetDataType);
             }
             sdType = index.getType();
             boolIndex = index.getBooleanIndexDefiniton();
@@ -215,6 +220,7 @@ public class IndexSchema extends Derived implements IndexschemaConfig.Producer {
         public boolean hasPhrases() { return phrases; }
         public boolean hasPositions() { return positions; }
         public boolean useInterleavedFeatures() { return interleavedFeatures; }
+        public boolean useBlockMaxWeights() { return blockMaxWeights; }
 
         public BooleanIndexDefinition getBooleanIndexDefinition() {
             return boolIndex;
@@ -57,6 +57,9 @@ public final class Attribute implements Cloneable, Serializable {
     private boolean fastAccess = false;
     private boolean huge = false;
     private boolean mutable = false;
+    private boolean paged = false;
+    private boolean packed = false;
+    private double maxDeltaRatio = 0.0;
     private int arity = BooleanIndexDefinition.DEFAULT_ARITY;
     private long lowerBound = BooleanIndexDefinition.DEFAULT_LOWER_BOUND;
     private long upperBound = BooleanIndexDefinition.DEFAULT_UPPER_BOUND;
@@ -193,11 +196,14 @@ public final class Attribute implements Cloneable, Serializable {
     public boolean isHuge()               { return huge; }
     public boolean isPosition()           { return isPosition; }
     public boolean isMutable()            { return mutable; }
+    public boolean isPaged()              { return paged; }
+    public boolean isPacked()             { return packed; }
 
     public int arity() { return arity; }
     public long lowerBound() { return lowerBound; }
     public long upperBound() { return upperBound; }
     public double densePostingListThreshold() { return densePostingListThreshold; }
+    public double maxDeltaRatio() { return maxDeltaRatio; }
     public Optional<TensorType> tensorType() { return tensorType; }
     public Optional<StructuredDataType> referenceDocumentType() { return referenceDocumentType; }
 
@@ -224,10 +230,13 @@ public final class Attribute implements Cloneable, Serializable {
     public void setFastAccess(boolean fastAccess)                { this.fastAccess = fastAccess; }
     public void setPosition(boolean position)                    { this.isPosition = position; }
     public void setMutable(boolean mutable)                      { this.mutable = mutable; }
+    public void setPaged(boolean paged)                          { this.paged = paged; }
+    public void setPacked(boolean packed)                        { this.packed = packed; }
     public void setArity(int arity)                              { this.arity = arity; }
     public void setLowerBound(long lowerBound)                   { this.lowerBound = lowerBound; }
     public void setUpperBound(long upperBound)                   { this.upperBound = upperBound; }
     public void setDensePostingListThreshold(double threshold)   { this.densePostingListThreshold = threshold; }
+    public void setMaxDeltaRatio(double ratio)                   { this.maxDeltaRatio = ratio; }
     public void setTensorType(TensorType tensorType)             { this.tensorType = Optional.of(tensorType); }
     public void setDistanceMetric(DistanceMetric metric)         { this.distanceMetric = Optional.of(metric); }
     public void setHnswIndexParams(HnswIndexParams params)       { this.hnswIndexParams = Optional.of(params); }
@@ -349,7 +358,7 @@ public final class Attribute implements Cloneable, Serializable {
     public int hashCode() {
         return Objects.hash(
                 name, type, collectionType, sorting, isPrefetch(), fastAccess, removeIfZero, createIfNonExistent,
-                isPosition, huge, enableBitVectors, enableOnlyBitVector, tensorType, referenceDocumentType, distanceMetric, hnswIndexParams);
+                isPosition, huge, paged, packed, maxDeltaRatio, enableBitVectors, enableOnlyBitVector, tensorType, referenceDocumentType, distanceMetric, hnswIndexParams);
     }
 
     @Override
@@ -373,6 +382,9 @@ public final class Attribute implements Cloneable, Serializable {
         // if (this.noSearch != other.noSearch) return false; No backend consequences so compatible for now
         if (this.fastSearch != other.fastSearch) return false;
         if (this.huge != other.huge) return false;
+        if (this.paged != other.paged) return false;
+        if (this.packed != other.packed) return false;
+        if (this.maxDeltaRatio != other.maxDeltaRatio) return false;
         if (! this.sorting.equals(other.sorting)) return false;
         if (! Objects.equals(tensorType, other.tensorType)) return false;
         if (! Objects.equals(referenceDocumentType, other.referenceDocumentType)) return false;
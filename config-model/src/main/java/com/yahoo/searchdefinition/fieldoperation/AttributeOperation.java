@@ -18,6 +18,9 @@ public class AttributeOperation implements FieldOperation, FieldOperationContain
     private Boolean fastSearch;
     private Boolean fastAccess;
     private Boolean mutable;
+    private Boolean paged;
+    private Boolean packed;
+    private Double maxDeltaRatio;
     private Boolean enableBitVectors;
     private Boolean enableOnlyBitVector;
     //TODO: Husk sorting!!
@@ -63,6 +66,30 @@ public class AttributeOperation implements FieldOperation, FieldOperationContain
         this.fastSearch = fastSearch;
     }
 
+    public Boolean getPaged() {
+        return paged;
+    }
+
+    public void setPaged(Boolean paged) {
+        this.paged = paged;
+    }
+
+    public Boolean getPacked() {
+        return packed;
+    }
+
+    public void setPacked(Boolean packed) {
+        this.packed = packed;
+    }
+
+    public Double getMaxDeltaRatio() {
+        return maxDeltaRatio;
+    }
+
+    public void setMaxDeltaRatio(Double maxDeltaRatio) {
+        this.maxDeltaRatio = maxDeltaRatio;
+    }
+
     public Boolean getFastAccess() {
         return fastAccess;
     }
@@ -147,6 +174,15 @@ public class AttributeOperation implements FieldOperation, FieldOperationContain
         if (mutable != null) {
             attribute.setMutable(mutable);
         }
+        if (paged != null) {
+            attribute.setPaged(paged);
+        }
+        if (packed != null) {
+            attribute.setPacked(packed);
+        }
+        if (maxDeltaRatio != null) {
+            attribute.setMaxDeltaRatio(maxDeltaRatio);
+        }
         if (enableBitVectors != null) {
             attribute.setEnableBitVectors(enableBitVectors);
         }
@@ -31,6 +31,7 @@ public class IndexOperation implements FieldOperation {
     private OptionalLong upperBound = OptionalLong.empty();
     private OptionalDouble densePostingListThreshold = OptionalDouble.empty();
     private Optional<Boolean> enableBm25 = Optional.empty();
+    private Optional<Boolean> enableBlockMaxWand = Optional.empty();
 
     private Optional<HnswIndexParams.Builder> hnswIndexParams = Optional.empty();
 
@@ -94,6 +95,9 @@ public class IndexOperation implements FieldOperation {
         if (enableBm25.isPresent()) {
             index.setInterleavedFeatures(enableBm25.get());
         }
+        if (enableBlockMaxWand.isPresent()) {
+            index.setBlockMaxWeights(enableBlockMaxWand.get());
+        }
         if (hnswIndexParams.isPresent()) {
             index.setHnswIndexParams(hnswIndexParams.get().build());
         }
@@ -127,6 +131,10 @@ public class IndexOperation implements FieldOperation {
         enableBm25 = Optional.of(value);
     }
 
+    public void setEnableBlockMaxWand(boolean value) {
+        enableBlockMaxWand = Optional.of(value);
+    }
+
     public void setHnswIndexParams(HnswIndexParams.Builder params) {
         this.hnswIndexParams = Optional.of(params);
     }
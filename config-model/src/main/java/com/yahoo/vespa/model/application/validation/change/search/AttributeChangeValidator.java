@@ -93,6 +93,9 @@ public class AttributeChangeValidator {
                 validateAttributeSetting(currAttr, nextAttr, Attribute::isFastSearch, "fast-search", result);
                 validateAttributeSetting(currAttr, nextAttr, Attribute::isFastAccess, "fast-access", result);
                 validateAttributeSetting(currAttr, nextAttr, Attribute::isHuge, "huge", result);
+                validateAttributeSetting(currAttr, nextAttr, Attribute::isPaged, "paged", result);
+                validateAttributeSetting(currAttr, nextAttr, Attribute::isPacked, "packed", result);
+                validateAttributeSetting(currAttr, nextAttr, Attribute::maxDeltaRatio, "max-delta-ratio", result);
                 validateAttributeSetting(currAttr, nextAttr, Attribute::densePostingListThreshold, "dense-posting-list-threshold", result);
                 validateAttributeSetting(currAttr, nextAttr, Attribute::isEnabledOnlyBitVector, "rank: filter", result);
                 validateAttributeSetting(currAttr, nextAttr, AttributeChangeValidator::hasHnswIndex, "indexing: index", result);
@@ -112,6 +112,120 @@ public class AttributeSettingsTestCase extends SchemaTestCase {
         SDField field = (SDField) search.getDocument().getField("f");
         return field.getAttributes().get(field.getName());
     }
+    @Test
+    public void requireThatPagedIsDefaultOff() throws ParseException {
+        Attribute attr = getAttributeF(
+                "search test {\n" +
+                "  document test { \n" +
+                "    field f type int { \n" +
+                "      indexing: attribute \n" +
+                "    }\n" +
+                "  }\n" +
+                "}\n");
+        assertFalse(attr.isPaged());
+    }
+
+    @Test
+    public void requireThatPagedConfigIsProperlyPropagated() throws ParseException {
+        Search search = getSearch(
+                "search test {\n" +
+                "  document test { \n" +
+                "    field a type long { \n" +
+                "      indexing: attribute \n" +
+                "    }\n" +
+                "    field p type long { \n" +
+                "      indexing: attribute \n" +
+                "      attribute: paged \n" +
+                "    }\n" +
+                "  }\n" +
+                "}\n");
+        AttributeFields attributes = new AttributeFields(search);
+        AttributesConfig.Builder builder = new AttributesConfig.Builder();
+        attributes.getConfig(builder);
+        AttributesConfig cfg = builder.build();
+        assertEquals("a", cfg.attribute().get(0).name());
+        assertFalse(cfg.attribute().get(0).paged());
+
+        assertEquals("p", cfg.attribute().get(1).name());
+        assertTrue(cfg.attribute().get(1).paged());
+    }
+
+    @Test
+    public void requireThatPackedIsDefaultOff() throws ParseException {
+        Attribute attr = getAttributeF(
+                "search test {\n" +
+                "  document test { \n" +
+                "    field f type int { \n" +
+                "      indexing: attribute \n" +
+                "    }\n" +
+                "  }\n" +
+                "}\n");
+        assertFalse(attr.isPacked());
+    }
+
+    @Test
+    public void requireThatPackedConfigIsProperlyPropagated() throws ParseException {
+        Search search = getSearch(
+                "search test {\n" +
+                "  document test { \n" +
+                "    field a type int { \n" +
+                "      indexing: attribute \n" +
+                "    }\n" +
+                "    field p type int { \n" +
+                "      indexing: attribute \n" +
+                "      attribute: packed \n" +
+                "    }\n" +
+                "  }\n" +
+                "}\n");
+        AttributeFields attributes = new AttributeFields(search);
+        AttributesConfig.Builder builder = new AttributesConfig.Builder();
+        attributes.getConfig(builder);
+        AttributesConfig cfg = builder.build();
+        assertEquals("a", cfg.attribute().get(0).name());
+        assertFalse(cfg.attribute().get(0).packed());
+
+        assertEquals("p", cfg.attribute().get(1).name());
+        assertTrue(cfg.attribute().get(1).packed());
+    }
+
+    @Test
+    public void requireThatMaxDeltaRatioIsDefaultZero() throws ParseException {
+        Attribute attr = getAttributeF(
+                "search test {\n" +
+                "  document test { \n" +
+                "    field f type int { \n" +
+                "      indexing: attribute \n" +
+                "    }\n" +
+                "  }\n" +
+                "}\n");
+        assertEquals(0.0, attr.maxDeltaRatio(), 0.0);
+    }
+
+    @Test
+    public void requireThatMaxDeltaRatioConfigIsProperlyPropagated() throws ParseException {
+        Search search = getSearch(
+                "search test {\n" +
+                "  document test { \n" +
+                "    field a type long { \n" +
+                "      indexing: attribute \n" +
+                "    }\n" +
+                "    field d type long { \n" +
+                "      indexing: attribute \n" +
+                "      attribute: max-delta-ratio: 0.25 \n" +
+                "    }\n" +
+                "  }\n" +
+                "}\n");
+        AttributeFields attributes = new AttributeFields(search);
+        AttributesConfig.Builder builder = new AttributesConfig.Builder();
+        attributes.getConfig(builder);
+        AttributesConfig cfg = builder.build();
+        assertEquals("a", cfg.attribute().get(0).name());
+        assertEquals(0.0, cfg.attribute().get(0).maxdeltaratio(), 0.0);
+
+        assertEquals("d", cfg.attribute().get(1).name());
+        assertEquals(0.25, cfg.attribute().get(1).maxdeltaratio(), 0.0);
+    }
+
     @Test
     public void requireThatMutableIsDefaultOff() throws ParseException {
         Attribute attr = getAttributeF(
@@ -220,6 +334,9 @@ public class AttributeSettingsTestCase extends SchemaTestCase {
         single.setFastSearch(true);
         single.setHuge(true);
         single.setFastAccess(true);
+        single.setPaged(true);
+        single.setPacked(true);
+        single.setMaxDeltaRatio(0.5);
         single.setPosition(true);
         single.setArity(5);
         single.setLowerBound(7);
@@ -242,6 +359,9 @@ public class AttributeSettingsTestCase extends SchemaTestCase {
         assertTrue(array.isFastSearch());
         assertTrue(array.isHuge());
         assertTrue(array.isFastAccess());
+        assertTrue(array.isPaged());
+        assertTrue(array.isPacked());
+        assertEquals(0.5, array.maxDeltaRatio(), 0.0);
         assertTrue(array.isPosition());
         assertEquals(5, array.arity());
         assertEquals(7, array.lowerBound());
@@ -85,6 +85,30 @@ public class AttributeChangeValidatorTest {
                         "Field 'f1' changed: add attribute 'huge'"));
     }
 
+    @Test
+    public void changing_paged_require_restart() throws Exception {
+        new Fixture("field f1 type long { indexing: attribute }",
+                "field f1 type long { indexing: attribute \n attribute: paged }").
+                assertValidation(newRestartAction(
+                        "Field 'f1' changed: add attribute 'paged'"));
+    }
+
+    @Test
+    public void changing_packed_require_restart() throws Exception {
+        new Fixture("field f1 type long { indexing: attribute }",
+                "field f1 type long { indexing: attribute \n attribute: packed }").
+                assertValidation(newRestartAction(
+                        "Field 'f1' changed: add attribute 'packed'"));
+    }
+
+    @Test
+    public void changing_max_delta_ratio_require_restart() throws Exception {
+        new Fixture("field f1 type long { indexing: attribute }",
+                "field f1 type long { indexing: attribute \n attribute: max-delta-ratio: 0.1 }").
+                assertValidation(newRestartAction(
+                        "Field 'f1' changed: change property 'max-delta-ratio' from '0.0' to '0.1'"));
+    }
+
     @Test
     public void changing_dense_posting_list_threshold_require_restart() throws Exception {
         new Fixture(
@@ -0,0 +1,248 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/eval/eval/batch_function.h>
+#include <vespa/eval/eval/function.h>
+#include <vespa/eval/eval/llvm/compiled_function.h>
+#include <vespa/eval/eval/test/eval_spec.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <cmath>
+
+using namespace vespalib::eval;
+using vespalib::ConstArrayRef;
+using vespalib::make_string;
+
+//-----------------------------------------------------------------------------
+
+// parameter columns for a batch, one column per parameter
+struct Batch {
+    std::vector<std::vector<double>> columns;
+    size_t num_lanes;
+    Batch(size_t num_params, size_t num_lanes_in)
+        : columns(num_params, std::vector<double>(num_lanes_in, 0.0)), num_lanes(num_lanes_in) {}
+    ~Batch();
+    std::vector<double> lane(size_t idx) const {
+        std::vector<double> result;
+        for (const auto &column: columns) {
+            result.push_back(column[idx]);
+        }
+        return result;
+    }
+    std::vector<const double *> params() const {
+        std::vector<const double *> result;
+        for (const auto &column: columns) {
+            result.push_back(column.data());
+        }
+        return result;
+    }
+};
+Batch::~Batch() = default;
+
+Batch make_batch(size_t num_params, size_t num_lanes) {
+    Batch batch(num_params, num_lanes);
+    for (size_t p = 0; p < num_params; ++p) {
+        for (size_t i = 0; i < num_lanes; ++i) {
+            batch.columns[p][i] = double((i * 7 + p * 3) % 11) / 4.0;
+        }
+    }
+    return batch;
+}
+
+std::vector<double> eval_batch(const BatchFunction &fun, BatchFunction::Context &ctx, const Batch &batch) {
+    auto params = batch.params();
+    auto result = fun.eval(ctx, ConstArrayRef<const double *>(params), batch.num_lanes);
+    return std::vector<double>(result.begin(), result.end());
+}
+
+void verify_lanes(const Function &function, const Batch &batch) {
+    BatchFunction batch_fun(function);
+    BatchFunction::Context ctx(batch_fun);
+    CompiledFunction compiled(function, PassParams::ARRAY, gbdt::Optimize::none);
+    auto fun = compiled.get_function();
+    auto result = eval_batch(batch_fun, ctx, batch);
+    ASSERT_EQ(result.size(), batch.num_lanes);
+    for (size_t i = 0; i < batch.num_lanes; ++i) {
+        auto lane = batch.lane(i);
+        EXPECT_DOUBLE_EQ(fun(lane.data()), result[i]) << "lane " << i;
+    }
+}
+
+vespalib::string make_tree(size_t seed, bool use_in) {
+    double a = double(seed % 5) / 4.0;
+    double b = double((seed * 3) % 5) / 4.0;
+    vespalib::string cond = use_in
+                            ? make_string("(b in [%g,%g])", b, a)
+                            : make_string("(b<%g)", b);
+    return make_string("if((a<%g),if(%s,%zu,%zu),if(!(c>=%g),%zu,%zu))",
+                       a, cond.c_str(), seed, seed + 1, a, seed + 2, seed + 3);
+}
+
+vespalib::string make_forest(size_t num_trees, bool use_in) {
+    vespalib::string forest = make_tree(0, use_in);
+    for (size_t i = 1; i < num_trees; ++i) {
+        forest.append("+");
+        forest.append(make_tree(i, use_in));
+    }
+    return forest;
+}
+
+//-----------------------------------------------------------------------------
+
+std::vector<vespalib::string> unsupported = {
+    "map(",
+    "join(",
+    "merge(",
+    "reduce(",
+    "rename(",
+    "tensor(",
+    "concat("
+};
+
+bool is_unsupported(const vespalib::string &expression) {
+    if (expression.find("{") != vespalib::string::npos) {
+        return true;
+    }
+    for (const auto &prefix: unsupported) {
+        if (starts_with(expression, prefix)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+struct MyEvalTest : test::EvalSpec::EvalTest {
+    size_t pass_cnt = 0;
+    size_t fail_cnt = 0;
+    void next_expression(const std::vector<vespalib::string> &, const vespalib::string &) override {}
+    void handle_case(const std::vector<vespalib::string> &param_names,
+                     const std::vector<double> &param_values,
+                     const vespalib::string &expression,
+                     double expected_result) override
+    {
+        auto function = Function::parse(param_names, expression);
+        ASSERT_TRUE(!function->has_error());
+        if (is_unsupported(expression) || BatchFunction::detect_issues(*function)) {
+            return;
+        }
+        BatchFunction fun(*function);
+        BatchFunction::Context ctx(fun);
+        Batch batch(param_values.size(), 3);
+        for (size_t p = 0; p < param_values.size(); ++p) {
+            batch.columns[p].assign(batch.num_lanes, param_values[p]);
+        }
+        auto result = eval_batch(fun, ctx, batch);
+        for (double value: result) {
+            if (is_same(expected_result, value)) {
+                ++pass_cnt;
+            } else {
+                fprintf(stderr, "verifying: %s -> %g ... FAIL: got %g\n",
+                        as_string(param_names, param_values, expression).c_str(),
+                        expected_result, value);
+                ++fail_cnt;
+            }
+        }
+    }
+};
+
+//-----------------------------------------------------------------------------
+
+TEST(BatchFunctionTest, require_that_batch_evaluation_passes_all_conformance_tests) {
+    MyEvalTest eval_test;
+    test::EvalSpec spec;
+    spec.add_all_cases();
+    spec.each_case(eval_test);
+    EXPECT_GT(eval_test.pass_cnt, 1000u);
+    EXPECT_EQ(0u, eval_test.fail_cnt);
+}
+
+TEST(BatchFunctionTest, require_that_each_lane_is_evaluated_separately) {
+    auto function = Function::parse({"a", "b", "c"}, "if(a<b,a*2,b+c)+max(a,c)-(b in [0.5,1.25])+pow(a,2)/(c+1)");
+    verify_lanes(*function, make_batch(3, 1));
+    verify_lanes(*function, make_batch(3, 17));
+    verify_lanes(*function, make_batch(3, 256));
+}
+
+TEST(BatchFunctionTest, require_that_constant_sub_expressions_are_folded) {
+    auto function = Function::parse({"a", "b"}, "a+b+max(1,2)/1");
+    BatchFunction fun(*function);
+    EXPECT_EQ(2u, fun.program_size());
+    verify_lanes(*function, make_batch(2, 5));
+}
+
+TEST(BatchFunctionTest, require_that_parameters_and_constants_can_be_the_result) {
+    auto param = Function::parse({"a", "b"}, "b");
+    auto constant = Function::parse({"a"}, "1+2");
+    BatchFunction param_fun(*param);
+    BatchFunction const_fun(*constant);
+    EXPECT_EQ(0u, param_fun.program_size());
+    EXPECT_EQ(0u, const_fun.program_size());
+    BatchFunction::Context param_ctx(param_fun);
+    BatchFunction::Context const_ctx(const_fun);
+    auto batch = make_batch(2, 4);
+    EXPECT_EQ(batch.columns[1], eval_batch(param_fun, param_ctx, batch));
+    EXPECT_EQ(std::vector<double>(4, 3.0), eval_batch(const_fun, const_ctx, make_batch(1, 4)));
+}
+
+TEST(BatchFunctionTest, require_that_context_can_be_reused_with_different_batch_sizes) {
+    auto function = Function::parse({"a", "b"}, "(a+1)*(b-2)+3");
+    BatchFunction fun(*function);
+    BatchFunction::Context ctx(fun);
+    CompiledFunction compiled(*function, PassParams::ARRAY);
+    for (size_t num_lanes: {2, 300, 1, 64, 0, 500}) {
+        auto batch = make_batch(2, num_lanes);
+        auto result = eval_batch(fun, ctx, batch);
+        ASSERT_EQ(num_lanes, result.size());
+        for (size_t i = 0; i < num_lanes; ++i) {
+            auto lane = batch.lane(i);
+            EXPECT_EQ(compiled.get_function()(lane.data()), result[i]);
+        }
+    }
+}
+
+TEST(BatchFunctionTest, require_that_small_forests_are_evaluated_as_expressions) {
+    auto function = Function::parse({"a", "b", "c"}, make_forest(BatchFunction::forest_limit - 1, false));
+    BatchFunction fun(*function);
+    EXPECT_EQ(0u, fun.num_forests());
+    verify_lanes(*function, make_batch(3, 32));
+}
+
+TEST(BatchFunctionTest, require_that_forests_can_be_evaluated_with_fast_forest) {
+    auto function = Function::parse({"a", "b", "c"}, make_forest(50, false));
+    BatchFunction fun(*function);
+    EXPECT_EQ(1u, fun.num_forests());
+    EXPECT_EQ(1u, fun.program_size());
+    verify_lanes(*function, make_batch(3, 32));
+}
+
+TEST(BatchFunctionTest, require_that_forests_with_set_membership_checks_can_be_evaluated) {
+    auto function = Function::parse({"a", "b", "c"}, make_forest(50, true));
+    BatchFunction fun(*function);
+    EXPECT_EQ(1u, fun.num_forests());
+    verify_lanes(*function, make_batch(3, 32));
+}
+
+TEST(BatchFunctionTest, require_that_forests_can_be_part_of_larger_expressions) {
+    auto forest = make_forest(20, false);
+    auto function = Function::parse({"a", "b", "c"}, make_string("sigmoid(%s)*a+(%s)", forest.c_str(), forest.c_str()));
+    BatchFunction fun(*function);
+    EXPECT_EQ(2u, fun.num_forests());
+    verify_lanes(*function, make_batch(3, 32));
+}
+
+TEST(BatchFunctionTest, require_that_missing_values_select_the_default_branch_of_forests) {
+    auto function = Function::parse({"a", "b", "c"}, make_forest(50, false));
+    Batch batch = make_batch(3, 8);
+    for (size_t i = 0; i < batch.num_lanes; i += 2) {
+        batch.columns[2][i] = std::numeric_limits<double>::quiet_NaN();
+    }
+    verify_lanes(*function, batch);
+}
+
+TEST(BatchFunctionTest, require_that_tensor_expressions_have_issues) {
+    auto simple = Function::parse("a+b");
+    auto complex = Function::parse("join(a,b,f(a,b)(a+b))");
+    EXPECT_FALSE(BatchFunction::detect_issues(*simple));
+    EXPECT_TRUE(BatchFunction::detect_issues(*complex));
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
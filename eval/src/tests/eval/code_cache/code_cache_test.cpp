@@ -0,0 +1,218 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/eval/eval/llvm/code_cache.h>
+#include <vespa/eval/eval/llvm/compiled_function.h>
+#include <vespa/eval/eval/function.h>
+#include <vespa/eval/eval/vm_forest.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+using namespace vespalib::eval;
+
+namespace fs = std::filesystem;
+
+//-----------------------------------------------------------------------------
+
+const vespalib::string cache_dir("tmp_code_cache");
+
+class CodeCacheTest : public ::testing::Test {
+protected:
+    CodeCache::SP cache;
+    CodeCacheTest() : cache() {
+        fs::remove_all(fs::path(cache_dir.c_str()));
+        cache = std::make_shared<CodeCache>(cache_dir);
+    }
+    ~CodeCacheTest() override;
+    size_t num_entries() const {
+        size_t cnt = 0;
+        for (const auto &entry: fs::directory_iterator(fs::path(cache_dir.c_str()))) {
+            (void) entry;
+            ++cnt;
+        }
+        return cnt;
+    }
+    bool has(const vespalib::string &key) const {
+        return fs::exists(fs::path((cache_dir + "/" + key + ".o").c_str()));
+    }
+    vespalib::string path(const vespalib::string &key) const {
+        return cache_dir + "/" + key + ".o";
+    }
+    size_t file_size(const vespalib::string &key) const {
+        return fs::file_size(fs::path(path(key).c_str()));
+    }
+    void truncate(const vespalib::string &key, size_t size) {
+        fs::resize_file(fs::path(path(key).c_str()), size);
+    }
+    void flip_last_byte(const vespalib::string &key) {
+        std::fstream file(path(key).c_str(), std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(-1, std::ios::end);
+        char c = file.get();
+        file.seekp(-1, std::ios::end);
+        file.put(c ^ 0x5a);
+    }
+    void set_age(const vespalib::string &key, int hours) {
+        fs::last_write_time(fs::path((cache_dir + "/" + key + ".o").c_str()),
+                            fs::file_time_type::clock::now() - std::chrono::hours(hours));
+    }
+};
+
+CodeCacheTest::~CodeCacheTest() {
+    cache.reset();
+    fs::remove_all(fs::path(cache_dir.c_str()));
+}
+
+void verify_stats(const CodeCache &cache, size_t hits, size_t misses, size_t errors) {
+    auto stats = cache.get_stats();
+    EXPECT_EQ(hits, stats.hits);
+    EXPECT_EQ(misses, stats.misses);
+    EXPECT_EQ(errors, stats.errors);
+}
+
+//-----------------------------------------------------------------------------
+
+TEST_F(CodeCacheTest, require_that_stored_object_code_can_be_loaded) {
+    vespalib::string object;
+    EXPECT_FALSE(cache->load("foo", object));
+    cache->store("foo", "object code\0with zero", 21);
+    ASSERT_TRUE(cache->load("foo", object));
+    EXPECT_EQ(vespalib::string("object code\0with zero", 21), object);
+    EXPECT_FALSE(cache->load("bar", object));
+    verify_stats(*cache, 1, 2, 0);
+}
+
+TEST_F(CodeCacheTest, require_that_stored_object_code_replaces_earlier_entry) {
+    vespalib::string object;
+    cache->store("foo", "old", 3);
+    cache->store("foo", "new", 3);
+    ASSERT_TRUE(cache->load("foo", object));
+    EXPECT_EQ("new", object);
+    EXPECT_EQ(1u, num_entries());
+}
+
+TEST_F(CodeCacheTest, require_that_object_code_is_kept_by_new_cache_for_same_directory) {
+    vespalib::string object;
+    cache->store("foo", "code", 4);
+    CodeCache other(cache_dir);
+    ASSERT_TRUE(other.load("foo", object));
+    EXPECT_EQ("code", object);
+    verify_stats(other, 1, 0, 0);
+}
+
+TEST_F(CodeCacheTest, require_that_truncated_entry_is_counted_as_miss_and_removed) {
+    vespalib::string object;
+    cache->store("foo", "object code", 11);
+    truncate("foo", file_size("foo") - 1);
+    EXPECT_FALSE(cache->load("foo", object));
+    EXPECT_FALSE(has("foo"));
+    verify_stats(*cache, 0, 1, 1);
+    cache->store("foo", "object code", 11);
+    ASSERT_TRUE(cache->load("foo", object));
+    EXPECT_EQ("object code", object);
+}
+
+TEST_F(CodeCacheTest, require_that_corrupted_entry_is_counted_as_miss_and_removed) {
+    vespalib::string object;
+    cache->store("foo", "object code", 11);
+    flip_last_byte("foo");
+    EXPECT_FALSE(cache->load("foo", object));
+    EXPECT_FALSE(has("foo"));
+    verify_stats(*cache, 0, 1, 1);
+}
+
+TEST_F(CodeCacheTest, require_that_entry_stored_for_other_key_is_counted_as_miss_and_removed) {
+    vespalib::string object;
+    cache->store("foo", "object code", 11);
+    fs::copy_file(fs::path(path("foo").c_str()), fs::path(path("bar").c_str()));
+    EXPECT_FALSE(cache->load("bar", object));
+    EXPECT_FALSE(has("bar"));
+    EXPECT_TRUE(cache->load("foo", object));
+    verify_stats(*cache, 1, 1, 1);
+}
+
+TEST_F(CodeCacheTest, require_that_store_leaves_no_temporary_files) {
+    cache->store("foo", "old", 3);
+    cache->store("bar", "code", 4);
+    EXPECT_EQ(2u, num_entries());
+    EXPECT_TRUE(has("foo"));
+    EXPECT_TRUE(has("bar"));
+}
+
+TEST_F(CodeCacheTest, require_that_pruning_removes_least_recently_used_entries) {
+    vespalib::string object(100, 'x');
+    cache->store("a", object.data(), object.size());
+    cache->store("b", object.data(), object.size());
+    cache->store("c", object.data(), object.size());
+    set_age("a", 3);
+    set_age("b", 2);
+    set_age("c", 1);
+    EXPECT_TRUE(cache->load("a", object));
+    cache->prune(250);
+    EXPECT_TRUE(has("a"));
+    EXPECT_FALSE(has("b"));
+    EXPECT_TRUE(has("c"));
+    cache->prune(300);
+    EXPECT_EQ(2u, num_entries());
+    cache->prune(0);
+    EXPECT_EQ(0u, num_entries());
+}
+
+TEST_F(CodeCacheTest, require_that_cache_can_be_bound) {
+    EXPECT_FALSE(CodeCache::get_bound());
+    {
+        auto binding = CodeCache::bind(cache);
+        EXPECT_EQ(cache, CodeCache::get_bound());
+    }
+    EXPECT_FALSE(CodeCache::get_bound());
+}
+
+//-----------------------------------------------------------------------------
+
+void verify_compiled(const vespalib::string &expr, PassParams pass_params,
+                     const gbdt::Optimize::Chain &forest_optimizers,
+                     const std::vector<std::vector<double>> &inputs)
+{
+    auto function = Function::parse({"a", "b"}, expr);
+    CompiledFunction expect(*function, pass_params, forest_optimizers);
+    CompiledFunction actual(*function, pass_params, forest_optimizers);
+    for (const auto &params: inputs) {
+        if (pass_params == PassParams::ARRAY) {
+            EXPECT_EQ(expect.get_function()(params.data()), actual.get_function()(params.data()));
+        } else {
+            auto resolve = [](void *ctx, size_t idx){ return ((const double *)ctx)[idx]; };
+            void *ctx = const_cast<double *>(params.data());
+            EXPECT_EQ(expect.get_lazy_function()(resolve, ctx), actual.get_lazy_function()(resolve, ctx));
+        }
+    }
+}
+
+TEST_F(CodeCacheTest, require_that_compiled_functions_use_bound_cache) {
+    auto binding = CodeCache::bind(cache);
+    auto function = Function::parse("a+b*2");
+    CompiledFunction first(*function, PassParams::ARRAY);
+    verify_stats(*cache, 0, 1, 0);
+    EXPECT_EQ(1u, num_entries());
+    CompiledFunction second(*function, PassParams::ARRAY);
+    verify_stats(*cache, 1, 1, 0);
+    EXPECT_EQ(1u, num_entries());
+    std::vector<double> params({3.0, 5.0});
+    EXPECT_EQ(13.0, first.get_function()(params.data()));
+    EXPECT_EQ(13.0, second.get_function()(params.data()));
+    CompiledFunction other(*Function::parse("a-b*2"), PassParams::ARRAY);
+    verify_stats(*cache, 1, 2, 0);
+    EXPECT_EQ(2u, num_entries());
+    EXPECT_EQ(-7.0, other.get_function()(params.data()));
+}
+
+TEST_F(CodeCacheTest, require_that_cached_code_binds_forests_and_set_lookups) {
+    auto binding = CodeCache::bind(cache);
+    std::vector<std::vector<double>> inputs({{0.5, 1.5}, {1.5, 3.0}, {1.5, 11.0}});
+    vespalib::string forest("if(a<1,1,2)+if(b<2,3,4)+if(a<2,5,6)");
+    vespalib::string lookup("(b in [1,2,3,4,5,6,7,8,9,10])+a");
+    verify_compiled(forest, PassParams::ARRAY, gbdt::VMForest::optimize_chain, inputs);
+    verify_compiled(forest, PassParams::LAZY, gbdt::VMForest::optimize_chain, inputs);
+    verify_compiled(lookup, PassParams::ARRAY, gbdt::Optimize::none, inputs);
+    verify_stats(*cache, 3, 3, 0);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
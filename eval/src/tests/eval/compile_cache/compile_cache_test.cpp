@@ -141,6 +141,14 @@ TEST("require that agents can share functions in the cache") {
     TEST_DO(verify_cache(1, 2));
 }
 
+TEST("require that functions compiled with different forest optimizers are cached separately") {
+    auto function = Function::parse("x+y");
+    CompileCache::Token::UP token_a = CompileCache::compile(*function, PassParams::ARRAY);
+    CompileCache::Token::UP token_b = CompileCache::compile(*function, PassParams::ARRAY, gbdt::Optimize::none);
+    CompileCache::Token::UP token_c = CompileCache::compile(*function, PassParams::ARRAY, gbdt::Optimize::best);
+    TEST_DO(verify_cache(2, 3));
+}
+
 TEST("require that cache usage works") {
     TEST_DO(verify_cache(0, 0));
     CompileCache::Token::UP token_a = CompileCache::compile(*Function::parse("x+y"), PassParams::SEPARATE);
@@ -4,6 +4,7 @@
 #include <vespa/eval/eval/fast_forest.h>
 #include <vespa/eval/eval/vm_forest.h>
 #include <vespa/eval/eval/llvm/compiled_function.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
 #include "model.cpp"
 
 using namespace vespalib::eval;
@@ -23,6 +24,35 @@ void estimate_cost(size_t num_params, const char *label, const T &impl) {
             label, (us_min / 10.0), (us_med / 10.0), (us_max / 10.0), (us_nan / 10.0));
 }
 
+// compare evaluating 100 different documents one at a time with evaluating them as a batch
+void estimate_batch_cost(size_t num_params, const char *label, const FastForest &forest) {
+    constexpr size_t num_docs = 100;
+    std::vector<std::vector<double>> columns(num_params, std::vector<double>(num_docs));
+    std::vector<const double *> params;
+    for (size_t p = 0; p < num_params; ++p) {
+        for (size_t doc = 0; doc < num_docs; ++doc) {
+            columns[p][doc] = double(((doc * 7) + (p * 13)) % 100) / 100.0;
+        }
+        params.push_back(columns[p].data());
+    }
+    auto ctx = forest.create_context();
+    std::vector<float> row(num_params);
+    std::vector<double> result(num_docs);
+    double ms_single = vespalib::BenchmarkTimer::benchmark([&](){
+                for (size_t doc = 0; doc < num_docs; ++doc) {
+                    for (size_t p = 0; p < num_params; ++p) {
+                        row[p] = columns[p][doc];
+                    }
+                    result[doc] = forest.eval(*ctx, &row[0]);
+                }
+            }, 5.0) * 1000.0;
+    double ms_batch = vespalib::BenchmarkTimer::benchmark([&](){
+                forest.eval_batch(*ctx, params, num_docs, &result[0]);
+            }, 5.0) * 1000.0;
+    fprintf(stderr, "[%12s] (per 100 docs): [single] %6.3f ms, [batch] %6.3f ms\n",
+            label, ms_single, ms_batch);
+}
+
 void run_fast_forest_bench() {
     for (size_t tree_size: std::vector<size_t>({8,16,32,64,128,256})) {
         for (size_t num_trees: std::vector<size_t>({100, 500, 2500, 5000, 10000})) {
@@ -36,6 +66,7 @@ void run_fast_forest_bench() {
                             auto forest = FastForest::try_convert(*function, min_bits, 64);
                             if (forest) {
                                 estimate_cost(function->num_params(), forest->impl_name().c_str(), *forest);
+                                estimate_batch_cost(function->num_params(), forest->impl_name().c_str(), *forest);
                             }
                             if (min_bits > 64) {
                                 break;
@@ -9,6 +9,7 @@
 #include <vespa/eval/eval/interpreted_function.h>
 #include <vespa/eval/eval/simple_tensor_engine.h>
 #include <vespa/vespalib/util/stringfmt.h>
+#include <thread>
 #include "model.cpp"
 
 using namespace vespalib::eval;
@@ -50,6 +51,36 @@ double eval_ff(const FastForest &ff, FastForest::Context &ctx, const std::vector
     return ff.eval(ctx, &my_params[0]);
 }
 
+// parameter columns with some missing values, one column per parameter
+std::vector<std::vector<double>> make_columns(size_t num_params, size_t num_docs) {
+    std::vector<std::vector<double>> columns(num_params, std::vector<double>(num_docs));
+    for (size_t p = 0; p < num_params; ++p) {
+        for (size_t doc = 0; doc < num_docs; ++doc) {
+            columns[p][doc] = (((doc * 7) + (p * 3)) % 13 == 0)
+                              ? std::numeric_limits<double>::quiet_NaN()
+                              : double(((doc * 5) + (p * 11)) % 17) / 16.0;
+        }
+    }
+    return columns;
+}
+
+void verify_eval_batch(const FastForest &ff, const std::vector<std::vector<double>> &columns, size_t num_docs) {
+    std::vector<const double *> params;
+    for (const auto &column: columns) {
+        params.push_back(column.data());
+    }
+    auto ctx = ff.create_context();
+    std::vector<double> result(num_docs, 31212.0);
+    ff.eval_batch(*ctx, params, num_docs, result.data());
+    for (size_t doc = 0; doc < num_docs; ++doc) {
+        std::vector<double> row;
+        for (const auto &column: columns) {
+            row.push_back(column[doc]);
+        }
+        EXPECT_EQUAL(eval_ff(ff, *ctx, row), result[doc]);
+    }
+}
+
 //-----------------------------------------------------------------------------
 
 TEST("require that tree stats can be calculated") {
@@ -407,6 +438,86 @@ TEST("require that fast forest evaluation is correct for all tree size categorie
     }
 }
 
+TEST("require that fast forest batch evaluation gives the same result as single evaluation") {
+    for (size_t tree_size: std::vector<size_t>({7,15,30,61,127})) {
+        vespalib::string expression = Model().max_features(35).less_percent(100).invert_percent(50).make_forest(127, tree_size);
+        auto function = Function::parse(expression);
+        auto forest = FastForest::try_convert(*function);
+        if ((tree_size <= 64) || is_little_endian()) {
+            ASSERT_TRUE(forest);
+            TEST_STATE(forest->impl_name().c_str());
+            auto columns = make_columns(function->num_params(), 37);
+            for (size_t num_docs: std::vector<size_t>({0, 1, 8, 13, 37})) {
+                verify_eval_batch(*forest, columns, num_docs);
+            }
+        }
+    }
+}
+
+TEST("require that fast forest can be used for forests not using all parameters") {
+    auto function = Function::parse({"a", "b", "c"}, "if((a<0.5),1.0,2.0)+if(!(c>=0.25),10.0,20.0)");
+    auto forest = FastForest::try_convert(*function);
+    ASSERT_TRUE(forest);
+    auto ctx = forest->create_context();
+    EXPECT_EQUAL(11.0, eval_ff(*forest, *ctx, {0.0, 0.0, 0.0}));
+    EXPECT_EQUAL(22.0, eval_ff(*forest, *ctx, {1.0, 0.0, 1.0}));
+    EXPECT_EQUAL(12.0, eval_ff(*forest, *ctx, {1.0, 1.0, std::numeric_limits<double>::quiet_NaN()}));
+    verify_eval_batch(*forest, make_columns(3, 20), 20);
+}
+
+TEST("require that fast forest can be selected by the forest optimizer") {
+    auto function = Function::parse(Model().max_features(35).less_percent(100).invert_percent(50).make_forest(60, 20));
+    CompiledFunction compiled(*function, PassParams::ARRAY, FastForest::optimize_chain);
+    ASSERT_EQUAL(1u, compiled.get_forests().size());
+    std::vector<double> inputs(function->num_params(), 0.5);
+    std::vector<double> inputs_nan(function->num_params(), std::numeric_limits<double>::quiet_NaN());
+    EXPECT_EQUAL(eval_double(*function, inputs), eval_compiled(compiled, inputs));
+    EXPECT_EQUAL(eval_double(*function, inputs_nan), eval_compiled(compiled, inputs_nan));
+}
+
+TEST("require that fast forest models can be evaluated alternately by multiple threads") {
+    auto function_a = Function::parse(Model().less_percent(100).invert_percent(50).make_forest(60, 20));
+    auto function_b = Function::parse(Model().max_features(10).less_percent(100).make_forest(30, 10));
+    auto trees_a = extract_trees(function_a->root());
+    auto trees_b = extract_trees(function_b->root());
+    auto model_a = Optimize::apply_chain(FastForest::optimize_chain, ForestStats(trees_a), trees_a);
+    auto model_b = Optimize::apply_chain(FastForest::optimize_chain, ForestStats(trees_b), trees_b);
+    ASSERT_TRUE(model_a.valid() && model_b.valid());
+    auto forest_a = FastForest::try_convert(*function_a);
+    auto forest_b = FastForest::try_convert(*function_b);
+    ASSERT_TRUE(forest_a && forest_b);
+    auto columns_a = make_columns(function_a->num_params(), 10);
+    auto columns_b = make_columns(function_b->num_params(), 10);
+    auto verify = [&]() {
+        auto ctx_a = forest_a->create_context();
+        auto ctx_b = forest_b->create_context();
+        for (size_t doc = 0; doc < 10; ++doc) {
+            std::vector<double> params_a;
+            std::vector<double> params_b;
+            for (const auto &column: columns_a) {
+                params_a.push_back(column[doc]);
+            }
+            for (const auto &column: columns_b) {
+                params_b.push_back(column[doc]);
+            }
+            EXPECT_EQUAL(eval_ff(*forest_a, *ctx_a, params_a), model_a.eval(model_a.forest.get(), &params_a[0]));
+            EXPECT_EQUAL(eval_ff(*forest_b, *ctx_b, params_b), model_b.eval(model_b.forest.get(), &params_b[0]));
+        }
+    };
+    std::thread thread(verify);
+    verify();
+    thread.join();
+}
+
+TEST("require that models with in checks are rejected by the fast forest optimizer") {
+    auto function = Function::parse(Model().less_percent(100).make_forest(300, 30));
+    auto trees = extract_trees(function->root());
+    ForestStats stats(trees);
+    EXPECT_TRUE(Optimize::apply_chain(FastForest::optimize_chain, stats, trees).valid());
+    stats.total_in_checks = 1;
+    EXPECT_TRUE(!Optimize::apply_chain(FastForest::optimize_chain, stats, trees).valid());
+}
+
 //-----------------------------------------------------------------------------
 
 TEST("require that GDBT expressions can be detected") {
@@ -260,6 +260,39 @@ TEST("require that value types preserve cell type") {
     EXPECT_TRUE(type("tensor<float>(x[10])").cell_type() == CellType::FLOAT);
 }
 
+ValueType storage_type(const vespalib::string &spec) { return ValueType::from_storage_spec(spec); }
+
+TEST("require that storage cell types are only parsed as storage types") {
+    EXPECT_TRUE(ValueType::from_spec("tensor<bfloat16>(x[10])").is_error());
+    EXPECT_TRUE(ValueType::from_spec("tensor<int8>(x[10])").is_error());
+    EXPECT_TRUE(storage_type("tensor<bfloat16>(x[10])").cell_type() == CellType::BFLOAT16);
+    EXPECT_TRUE(storage_type("tensor<int8>(x[10])").cell_type() == CellType::INT8);
+    EXPECT_EQUAL(storage_type("tensor<float>(x[10])"), type("tensor<float>(x[10])"));
+    EXPECT_EQUAL(storage_type("tensor(x{})"), type("tensor(x{})"));
+    EXPECT_TRUE(storage_type("tensor<int16>(x[10])").is_error());
+}
+
+TEST("require that storage cell types are decayed to float") {
+    EXPECT_EQUAL("tensor<bfloat16>(x[10])", storage_type("tensor<bfloat16>(x[10])").to_spec());
+    EXPECT_EQUAL("tensor<int8>(x[10])", storage_type("tensor<int8>(x[10])").to_spec());
+    EXPECT_TRUE(storage_type("tensor<int8>(x[10])").has_storage_cell_type());
+    EXPECT_TRUE(!type("tensor<float>(x[10])").has_storage_cell_type());
+    EXPECT_EQUAL(storage_type("tensor<int8>(x[10])").decay_cell_type(), type("tensor<float>(x[10])"));
+    EXPECT_EQUAL(storage_type("tensor<bfloat16>(x[10])").decay_cell_type(), type("tensor<float>(x[10])"));
+    EXPECT_EQUAL(type("tensor(x[10])").decay_cell_type(), type("tensor(x[10])"));
+    EXPECT_EQUAL(storage_type("tensor<int8>(x[10],y[5])").reduce({"y"}), type("tensor<float>(x[10])"));
+    EXPECT_EQUAL(storage_type("tensor<int8>(x[10])").rename({"x"}, {"y"}), type("tensor<float>(y[10])"));
+    EXPECT_EQUAL(ValueType::join(storage_type("tensor<int8>(x[10])"), storage_type("tensor<bfloat16>(x[10])")), type("tensor<float>(x[10])"));
+    EXPECT_EQUAL(ValueType::join(storage_type("tensor<int8>(x[10])"), type("tensor(x[10])")), type("tensor(x[10])"));
+    EXPECT_EQUAL(ValueType::join(storage_type("tensor<int8>(x[10])"), type("double")), type("tensor<float>(x[10])"));
+    EXPECT_EQUAL(ValueType::join(type("double"), storage_type("tensor<bfloat16>(x[10])")), type("tensor<float>(x[10])"));
+    EXPECT_EQUAL(ValueType::merge(storage_type("tensor<int8>(x[10])"), storage_type("tensor<int8>(x[10])")), type("tensor<float>(x[10])"));
+    EXPECT_EQUAL(ValueType::concat(storage_type("tensor<int8>(x[10])"), type("double"), "x"), type("tensor<float>(x[11])"));
+    EXPECT_TRUE(ValueType::unify_cell_types(storage_type("tensor<int8>(x[10])"), type("double")) == CellType::FLOAT);
+    EXPECT_EQUAL(ValueType::cell_size(CellType::INT8), 1u);
+    EXPECT_EQUAL(ValueType::cell_size(CellType::BFLOAT16), 2u);
+}
+
 TEST("require that dimension names can be obtained") {
     EXPECT_EQUAL(type("double").dimension_names(), str_list({}));
     EXPECT_EQUAL(type("tensor(y[30],x[10])").dimension_names(), str_list({"x", "y"}));
@@ -0,0 +1,473 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "batch_function.h"
+#include "node_visitor.h"
+#include "node_traverser.h"
+#include "operation.h"
+#include "inline_operation.h"
+#include "vm_forest.h"
+#include <vespa/eval/eval/llvm/compiled_function.h>
+#include <vespa/vespalib/util/typify.h>
+#include <algorithm>
+#include <cassert>
+
+namespace vespalib::eval {
+
+using namespace nodes;
+using operation::op1_t;
+using operation::op2_t;
+
+using State = BatchFunction::State;
+using Op = BatchFunction::Op;
+
+namespace {
+
+//-----------------------------------------------------------------------------
+
+template <typename OP1>
+void my_map_op(State &state, const Op &op) {
+    OP1 my_op1((op1_t)op.param);
+    operation::apply_op1_vec(state.temp(op.dst), state.columns[op.arg[0]], state.num_lanes, my_op1);
+}
+
+template <typename OP2>
+void my_join_op(State &state, const Op &op) {
+    OP2 my_op2((op2_t)op.param);
+    operation::apply_op2_vec_vec(state.temp(op.dst), state.columns[op.arg[0]], state.columns[op.arg[1]], state.num_lanes, my_op2);
+}
+
+void my_if_op(State &state, const Op &op) {
+    double *dst = state.temp(op.dst);
+    const double *cond = state.columns[op.arg[0]];
+    const double *true_value = state.columns[op.arg[1]];
+    const double *false_value = state.columns[op.arg[2]];
+    for (size_t i = 0; i < state.num_lanes; ++i) {
+        dst[i] = (cond[i] != 0.0) ? true_value[i] : false_value[i];
+    }
+}
+
+void my_in_op(State &state, const Op &op) {
+    const auto &entries = *(const std::vector<double> *)(op.param);
+    double *dst = state.temp(op.dst);
+    const double *src = state.columns[op.arg[0]];
+    for (size_t i = 0; i < state.num_lanes; ++i) {
+        double value = src[i];
+        double found = 0.0;
+        for (double entry: entries) {
+            found = (value == entry) ? 1.0 : found;
+        }
+        dst[i] = found;
+    }
+}
+
+void my_forest_op(State &state, const Op &op) {
+    const auto &forest = *(const BatchFunction::Forest *)(op.param);
+    double *dst = state.temp(op.dst);
+    size_t num_params = state.double_params.size();
+    if (forest.fast_forest) {
+        auto &ctx = *state.forest_contexts[forest.ctx_idx];
+        ConstArrayRef<const double *> params(state.columns.data(), num_params);
+        forest.fast_forest->eval_batch(ctx, params, state.num_lanes, dst);
+    } else {
+        double *params = state.double_params.data();
+        for (size_t i = 0; i < state.num_lanes; ++i) {
+            for (size_t p = 0; p < num_params; ++p) {
+                params[p] = state.columns[p][i];
+            }
+            dst[i] = forest.optimized.eval(forest.optimized.forest.get(), params);
+        }
+    }
+}
+
+struct MyGetMapOp {
+    template <typename OP1> static auto invoke() { return my_map_op<OP1>; }
+};
+
+struct MyGetJoinOp {
+    template <typename OP2> static auto invoke() { return my_join_op<OP2>; }
+};
+
+//-----------------------------------------------------------------------------
+
+// Column references used while building the program. Parameters use
+// their own index, while constants and temporaries are tagged and
+// resolved when the number of constants is known.
+constexpr uint32_t const_tag = (1u << 30);
+constexpr uint32_t temp_tag = (1u << 31);
+constexpr uint32_t tag_mask = (const_tag | temp_tag);
+
+struct ProgramBuilder : public NodeVisitor, public NodeTraverser {
+    size_t                                num_params;
+    Stash                                &stash;
+    std::vector<double>                  &constants;
+    std::vector<Op>                      &program;
+    std::vector<const BatchFunction::Forest *> &forests;
+    std::vector<uint32_t>                 stack;
+    size_t                                num_temps;
+    size_t                                max_temps;
+
+    ProgramBuilder(size_t num_params_in, Stash &stash_in, std::vector<double> &constants_in,
+                   std::vector<Op> &program_in, std::vector<const BatchFunction::Forest *> &forests_in)
+        : num_params(num_params_in), stash(stash_in), constants(constants_in), program(program_in),
+          forests(forests_in), stack(), num_temps(0), max_temps(0) {}
+
+    //-------------------------------------------------------------------------
+
+    void make_const(double value) {
+        stack.push_back(const_tag | constants.size());
+        constants.push_back(value);
+    }
+
+    void make_param(size_t param_idx) {
+        assert(param_idx < num_params);
+        stack.push_back(param_idx);
+    }
+
+    void make_op(BatchFunction::op_function function, uint64_t param, size_t num_args) {
+        assert(stack.size() >= num_args);
+        Op op{function, param, 0, {0, 0, 0}};
+        for (size_t i = num_args; i-- > 0; ) {
+            op.arg[i] = stack.back();
+            if ((stack.back() & temp_tag) != 0) {
+                --num_temps;
+            }
+            stack.pop_back();
+        }
+        op.dst = (temp_tag | num_temps);
+        stack.push_back(op.dst);
+        max_temps = std::max(max_temps, ++num_temps);
+        program.push_back(op);
+    }
+
+    void make_map(op1_t function) {
+        make_op(typify_invoke<1,operation::TypifyOp1,MyGetMapOp>(function), (uint64_t)function, 1);
+    }
+
+    void make_join(op2_t function) {
+        make_op(typify_invoke<1,operation::TypifyOp2,MyGetJoinOp>(function), (uint64_t)function, 2);
+    }
+
+    bool maybe_make_forest(const Node &node) {
+        if (!node.is_forest()) {
+            return false;
+        }
+        auto trees = gbdt::extract_trees(node);
+        if (trees.size() < BatchFunction::forest_limit) {
+            return false;
+        }
+        const BatchFunction::Forest *forest = nullptr;
+        if (auto fast_forest = gbdt::FastForest::try_convert(node, num_params)) {
+            forest = &stash.create<BatchFunction::Forest>(forests.size(), std::move(fast_forest));
+        } else {
+            gbdt::ForestStats stats(trees);
+            auto optimized = gbdt::Optimize::apply_chain(gbdt::VMForest::optimize_chain, stats, trees);
+            if (!optimized.valid()) {
+                return false;
+            }
+            forest = &stash.create<BatchFunction::Forest>(forests.size(), std::move(optimized));
+        }
+        forests.push_back(forest);
+        make_op(my_forest_op, (uint64_t)forest, 0);
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+
+    void visit(const Number &node) override {
+        make_const(node.value());
+    }
+    void visit(const Symbol &node) override {
+        make_param(node.id());
+    }
+    void visit(const String &node) override {
+        make_const(node.hash());
+    }
+    void visit(const In &node) override {
+        auto &entries = stash.create<std::vector<double>>();
+        for (size_t i = 0; i < node.num_entries(); ++i) {
+            entries.push_back(node.get_entry(i).get_const_value());
+        }
+        make_op(my_in_op, (uint64_t)&entries, 1);
+    }
+    void visit(const Neg &) override {
+        make_map(operation::Neg::f);
+    }
+    void visit(const Not &) override {
+        make_map(operation::Not::f);
+    }
+    void visit(const If &) override {
+        make_op(my_if_op, 0, 3);
+    }
+    void visit(const Error &) override {
+        abort();
+    }
+    void visit(const TensorMap &) override { abort(); }
+    void visit(const TensorJoin &) override { abort(); }
+    void visit(const TensorMerge &) override { abort(); }
+    void visit(const TensorReduce &) override { abort(); }
+    void visit(const TensorRename &) override { abort(); }
+    void visit(const TensorConcat &) override { abort(); }
+    void visit(const TensorCreate &) override { abort(); }
+    void visit(const TensorLambda &) override { abort(); }
+    void visit(const TensorPeek &) override { abort(); }
+    void visit(const Add &) override {
+        make_join(operation::Add::f);
+    }
+    void visit(const Sub &) override {
+        make_join(operation::Sub::f);
+    }
+    void visit(const Mul &) override {
+        make_join(operation::Mul::f);
+    }
+    void visit(const Div &) override {
+        make_join(operation::Div::f);
+    }
+    void visit(const Mod &) override {
+        make_join(operation::Mod::f);
+    }
+    void visit(const Pow &) override {
+        make_join(operation::Pow::f);
+    }
+    void visit(const Equal &) override {
+        make_join(operation::Equal::f);
+    }
+    void visit(const NotEqual &) override {
+        make_join(operation::NotEqual::f);
+    }
+    void visit(const Approx &) override {
+        make_join(operation::Approx::f);
+    }
+    void visit(const Less &) override {
+        make_join(operation::Less::f);
+    }
+    void visit(const LessEqual &) override {
+        make_join(operation::LessEqual::f);
+    }
+    void visit(const Greater &) override {
+        make_join(operation::Greater::f);
+    }
+    void visit(const GreaterEqual &) override {
+        make_join(operation::GreaterEqual::f);
+    }
+    void visit(const And &) override {
+        make_join(operation::And::f);
+    }
+    void visit(const Or &) override {
+        make_join(operation::Or::f);
+    }
+    void visit(const Cos &) override {
+        make_map(operation::Cos::f);
+    }
+    void visit(const Sin &) override {
+        make_map(operation::Sin::f);
+    }
+    void visit(const Tan &) override {
+        make_map(operation::Tan::f);
+    }
+    void visit(const Cosh &) override {
+        make_map(operation::Cosh::f);
+    }
+    void visit(const Sinh &) override {
+        make_map(operation::Sinh::f);
+    }
+    void visit(const Tanh &) override {
+        make_map(operation::Tanh::f);
+    }
+    void visit(const Acos &) override {
+        make_map(operation::Acos::f);
+    }
+    void visit(const Asin &) override {
+        make_map(operation::Asin::f);
+    }
+    void visit(const Atan &) override {
+        make_map(operation::Atan::f);
+    }
+    void visit(const Exp &) override {
+        make_map(operation::Exp::f);
+    }
+    void visit(const Log10 &) override {
+        make_map(operation::Log10::f);
+    }
+    void visit(const Log &) override {
+        make_map(operation::Log::f);
+    }
+    void visit(const Sqrt &) override {
+        make_map(operation::Sqrt::f);
+    }
+    void visit(const Ceil &) override {
+        make_map(operation::Ceil::f);
+    }
+    void visit(const Fabs &) override {
+        make_map(operation::Fabs::f);
+    }
+    void visit(const Floor &) override {
+        make_map(operation::Floor::f);
+    }
+    void visit(const Atan2 &) override {
+        make_join(operation::Atan2::f);
+    }
+    void visit(const Ldexp &) override {
+        make_join(operation::Ldexp::f);
+    }
+    void visit(const Pow2 &) override {
+        make_join(operation::Pow::f);
+    }
+    void visit(const Fmod &) override {
+        make_join(operation::Mod::f);
+    }
+    void visit(const Min &) override {
+        make_join(operation::Min::f);
+    }
+    void visit(const Max &) override {
+        make_join(operation::Max::f);
+    }
+    void visit(const IsNan &) override {
+        make_map(operation::IsNan::f);
+    }
+    void visit(const Relu &) override {
+        make_map(operation::Relu::f);
+    }
+    void visit(const Sigmoid &) override {
+        make_map(operation::Sigmoid::f);
+    }
+    void visit(const Elu &) override {
+        make_map(operation::Elu::f);
+    }
+    void visit(const Erf &) override {
+        make_map(operation::Erf::f);
+    }
+
+    //-------------------------------------------------------------------------
+
+    bool open(const Node &node) override {
+        if (node.is_const()) {
+            make_const(node.get_const_value());
+            return false;
+        }
+        return !maybe_make_forest(node);
+    }
+    void close(const Node &node) override { node.accept(*this); }
+
+    //-------------------------------------------------------------------------
+
+    // resolve a tagged column reference into a column index
+    uint32_t resolve_column(uint32_t ref) const {
+        if ((ref & const_tag) != 0) {
+            return num_params + (ref & ~tag_mask);
+        } else if ((ref & temp_tag) != 0) {
+            return num_params + constants.size() + (ref & ~tag_mask);
+        }
+        return ref;
+    }
+
+    // resolve a tagged temporary reference into a cell column index
+    uint32_t resolve_cells(uint32_t ref) const {
+        assert((ref & temp_tag) != 0);
+        return constants.size() + (ref & ~tag_mask);
+    }
+};
+
+} // namespace vespalib::eval::<unnamed>
+
+//-----------------------------------------------------------------------------
+
+BatchFunction::Forest::Forest(size_t ctx_idx_in, gbdt::FastForest::UP fast_forest_in)
+    : ctx_idx(ctx_idx_in),
+      fast_forest(std::move(fast_forest_in)),
+      optimized()
+{
+}
+
+BatchFunction::Forest::Forest(size_t ctx_idx_in, gbdt::Optimize::Result optimized_in)
+    : ctx_idx(ctx_idx_in),
+      fast_forest(),
+      optimized(std::move(optimized_in))
+{
+}
+
+BatchFunction::Forest::~Forest() = default;
+
+BatchFunction::State::State(const BatchFunction &fun)
+    : columns(fun._num_params + fun._constants.size() + fun._num_temps, nullptr),
+      cells(),
+      capacity(0),
+      num_lanes(0),
+      forest_contexts(),
+      double_params(fun._num_params, 0.0)
+{
+    for (const Forest *forest: fun._forests) {
+        forest_contexts.push_back(forest->fast_forest ? forest->fast_forest->create_context() : gbdt::FastForest::Context::UP());
+    }
+}
+
+BatchFunction::State::~State() = default;
+
+BatchFunction::Context::Context(const BatchFunction &fun)
+    : _state(fun)
+{
+}
+
+BatchFunction::BatchFunction(const nodes::Node &root, size_t num_params)
+    : _num_params(num_params),
+      _constants(),
+      _num_temps(0),
+      _program(),
+      _result(0),
+      _forests(),
+      _stash()
+{
+    ProgramBuilder builder(_num_params, _stash, _constants, _program, _forests);
+    root.traverse(builder);
+    assert(builder.stack.size() == 1);
+    for (Op &op: _program) {
+        for (uint32_t &arg: op.arg) {
+            arg = builder.resolve_column(arg);
+        }
+        op.dst = builder.resolve_cells(op.dst);
+    }
+    _num_temps = builder.max_temps;
+    _result = builder.resolve_column(builder.stack.back());
+}
+
+BatchFunction::~BatchFunction() = default;
+
+void
+BatchFunction::prepare(State &state, size_t num_lanes) const
+{
+    size_t num_cells = _constants.size() + _num_temps;
+    state.capacity = num_lanes;
+    state.cells.resize(num_cells * num_lanes);
+    for (size_t i = 0; i < _constants.size(); ++i) {
+        std::fill_n(state.temp(i), num_lanes, _constants[i]);
+    }
+    for (size_t i = 0; i < num_cells; ++i) {
+        state.columns[_num_params + i] = state.temp(i);
+    }
+}
+
+ConstArrayRef<double>
+BatchFunction::eval(Context &ctx, ConstArrayRef<const double *> params, size_t num_lanes) const
+{
+    State &state = ctx._state;
+    assert(params.size() == _num_params);
+    if (num_lanes > state.capacity) {
+        prepare(state, num_lanes);
+    }
+    state.num_lanes = num_lanes;
+    for (size_t i = 0; i < _num_params; ++i) {
+        state.columns[i] = params[i];
+    }
+    for (const Op &op: _program) {
+        op.function(state, op);
+    }
+    return ConstArrayRef<double>(state.columns[_result], num_lanes);
+}
+
+Function::Issues
+BatchFunction::detect_issues(const Function &function)
+{
+    // the same (non-tensor) nodes as compiled functions are supported
+    return CompiledFunction::detect_issues(function);
+}
+
+}
@@ -0,0 +1,101 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "function.h"
+#include "fast_forest.h"
+#include "gbdt.h"
+#include <vespa/vespalib/util/arrayref.h>
+#include <vespa/vespalib/util/stash.h>
+#include <vector>
+
+namespace vespalib::eval {
+
+namespace nodes { struct Node; }
+
+/**
+ * A Function that has been prepared for evaluation over batches of
+ * parameter values. Each parameter is passed as a column with one
+ * value per lane (typically one lane per document), and the
+ * expression is evaluated one node at a time for all lanes using
+ * simple loops that are suitable for vectorization. Both branches of
+ * if-expressions are evaluated, selecting the result for each lane
+ * afterwards. GBDT forests are evaluated a block of lanes at a time
+ * using FastForest when possible and lane by lane using VMForest
+ * otherwise.
+ *
+ * Only functions where all values are numbers are supported. The
+ * BatchFunction::Context class is used to keep track of the run-time
+ * state related to the evaluation of a batch function. The result of
+ * an evaluation is only valid until either the context is destructed
+ * or the context is re-used to perform another evaluation.
+ **/
+class BatchFunction
+{
+public:
+    struct State;
+    struct Op;
+    using op_function = void (*)(State &, const Op &);
+    struct Op {
+        op_function function;
+        uint64_t    param;
+        uint32_t    dst;
+        uint32_t    arg[3];
+    };
+    struct Forest {
+        size_t                 ctx_idx;
+        gbdt::FastForest::UP   fast_forest;
+        gbdt::Optimize::Result optimized;
+        Forest(size_t ctx_idx_in, gbdt::FastForest::UP fast_forest_in);
+        Forest(size_t ctx_idx_in, gbdt::Optimize::Result optimized_in);
+        ~Forest();
+    };
+    struct State {
+        std::vector<const double *>                columns;
+        std::vector<double>                        cells;
+        size_t                                     capacity;
+        size_t                                     num_lanes;
+        std::vector<gbdt::FastForest::Context::UP> forest_contexts;
+        std::vector<double>                        double_params;
+
+        explicit State(const BatchFunction &fun);
+        ~State();
+        double *temp(uint32_t idx) { return &cells[idx * capacity]; }
+    };
+    class Context {
+        friend class BatchFunction;
+    private:
+        State _state;
+    public:
+        explicit Context(const BatchFunction &fun);
+    };
+
+    // minimum number of trees in a forest for it to be evaluated as a forest
+    static constexpr size_t forest_limit = 16;
+
+private:
+    size_t                      _num_params;
+    std::vector<double>         _constants;
+    size_t                      _num_temps;
+    std::vector<Op>             _program;
+    uint32_t                    _result;
+    std::vector<const Forest *> _forests;
+    Stash                       _stash;
+
+    void prepare(State &state, size_t num_lanes) const;
+
+public:
+    using UP = std::unique_ptr<BatchFunction>;
+    BatchFunction(const nodes::Node &root, size_t num_params);
+    explicit BatchFunction(const Function &function)
+        : BatchFunction(function.root(), function.num_params()) {}
+    BatchFunction(BatchFunction &&rhs) = default;
+    ~BatchFunction();
+    size_t num_params() const { return _num_params; }
+    size_t program_size() const { return _program.size(); }
+    size_t num_forests() const { return _forests.size(); }
+    ConstArrayRef<double> eval(Context &ctx, ConstArrayRef<const double *> params, size_t num_lanes) const;
+    static Function::Issues detect_issues(const Function &function);
+};
+
+}
@@ -7,7 +7,9 @@
 #include <vespa/eval/eval/operator_nodes.h>
 #include <vespa/vespalib/util/benchmark_timer.h>
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <limits>
 #include <arpa/inet.h>
 
 namespace vespalib::eval::gbdt {
@@ -20,6 +22,18 @@ namespace {
 
 constexpr size_t bits_per_byte = 8;
 
+// number of documents evaluated together by eval_batch
+constexpr size_t block_size = 4;
+
+// feature values and tree masks for all documents in a block, using
+// vector types to make sure the masks are updated for all documents
+// at once on any cpu architecture.
+using FeatureBlock = float __attribute__((vector_size(block_size * sizeof(float))));
+using SelectBlock = int32_t __attribute__((vector_size(block_size * sizeof(int32_t))));
+template <typename T> struct MaskBlock {
+    typedef T type __attribute__((vector_size(block_size * sizeof(T))));
+};
+
 bool is_little_endian() {
     uint32_t value = 0;
     uint8_t bytes[4] = {0, 1, 2, 3};
@@ -121,7 +135,6 @@ State::State(size_t num_params, const std::vector<const nodes::Node *> &trees)
         max_leafs = std::max(max_leafs, leafs[tree_id].size());
     }
     for (CmpNodes &cmp_range: cmp_nodes) {
-        assert(!cmp_range.empty());
         std::sort(cmp_range.begin(), cmp_range.end());
     }
 }
@@ -146,7 +159,8 @@ constexpr size_t max_leafs() { return (sizeof(T) * bits_per_byte); }
 template <typename T>
 struct FixedContext : FastForest::Context {
     std::vector<T> masks;
-    FixedContext(size_t num_trees) : masks(num_trees) {}
+    std::vector<T> block_masks;
+    FixedContext(size_t num_trees) : masks(num_trees), block_masks() {}
 };
 
 template <typename T>
@@ -197,9 +211,15 @@ struct FixedForest : FastForest {
     static void apply_masks(T *ctx_masks, const DMask *pos, const DMask *end);
     double get_result(const T *ctx_masks) const;
 
+    static void apply_block_masks(T *ctx_masks, const Mask *pos, const Mask *end, const FeatureBlock &features, float limit);
+    static void apply_block_masks(T *ctx_masks, const DMask *pos, const DMask *end, const FeatureBlock &features);
+    void get_block_result(const T *ctx_masks, size_t num_docs, double *result) const;
+
     vespalib::string impl_name() const override { return fixed_impl_name<T>(); }
     Context::UP create_context() const override;
     double eval(Context &context, const float *params) const override;
+    void eval_batch(Context &context, ConstArrayRef<const double *> params,
+                    size_t num_docs, double *result) const override;
 };
 
 template <typename T>
@@ -306,6 +326,69 @@ FixedForest<T>::get_result(const T *ctx_masks) const
     return (result1 + result2);
 }
 
+// Block masks are stored tree by tree, with one mask per document in
+// the block for each tree. A mask is applied to the documents with a
+// feature value above the threshold; missing (NaN) values never are.
+template <typename T>
+void
+FixedForest<T>::apply_block_masks(T *ctx_masks, const Mask *pos, const Mask *end, const FeatureBlock &features, float limit)
+{
+    using Block = typename MaskBlock<T>::type;
+    for (; (pos < end) && !(limit < pos->value); ++pos) {
+        SelectBlock keep = ~(features >= pos->value);
+        Block masks;
+        T *dst = ctx_masks + (pos->tree * block_size);
+        memcpy(&masks, dst, sizeof(Block));
+        masks &= (__builtin_convertvector(keep, Block) | pos->bits);
+        memcpy(dst, &masks, sizeof(Block));
+    }
+}
+
+template <typename T>
+void
+FixedForest<T>::apply_block_masks(T *ctx_masks, const DMask *pos, const DMask *end, const FeatureBlock &features)
+{
+    using Block = typename MaskBlock<T>::type;
+    SelectBlock keep = (features == features);
+    for (; pos < end; ++pos) {
+        Block masks;
+        T *dst = ctx_masks + (pos->tree * block_size);
+        memcpy(&masks, dst, sizeof(Block));
+        masks &= (__builtin_convertvector(keep, Block) | pos->bits);
+        memcpy(dst, &masks, sizeof(Block));
+    }
+}
+
+// leafs are summed in the same order as in get_result to give the same result
+template <typename T>
+void
+FixedForest<T>::get_block_result(const T *ctx_masks, size_t num_docs, double *result) const
+{
+    double result1[block_size] = {};
+    double result2[block_size] = {};
+    const float *leafs = &_padded_leafs[0];
+    size_t leaf_cnt = _max_leafs;
+    uint32_t tree = 0;
+    for (; (tree + 3) < _num_trees; tree += 4, leafs += (leaf_cnt * 4)) {
+        const T *masks = ctx_masks + (tree * block_size);
+        for (size_t i = 0; i < num_docs; ++i) {
+            result1[i] += leafs[(0 * leaf_cnt) + get_lsb(masks[(0 * block_size) + i])];
+            result2[i] += leafs[(1 * leaf_cnt) + get_lsb(masks[(1 * block_size) + i])];
+            result1[i] += leafs[(2 * leaf_cnt) + get_lsb(masks[(2 * block_size) + i])];
+            result2[i] += leafs[(3 * leaf_cnt) + get_lsb(masks[(3 * block_size) + i])];
+        }
+    }
+    for (; tree < _num_trees; ++tree, leafs += leaf_cnt) {
+        const T *masks = ctx_masks + (tree * block_size);
+        for (size_t i = 0; i < num_docs; ++i) {
+            result1[i] += leafs[get_lsb(masks[i])];
+        }
+    }
+    for (size_t i = 0; i < num_docs; ++i) {
+        result[i] = (result1[i] + result2[i]);
+    }
+}
+
 template <typename T>
 FastForest::Context::UP
 FixedForest<T>::create_context() const
@@ -335,6 +418,42 @@ FixedForest<T>::eval(Context &context, const float *params) const
     return get_result(ctx_masks);
 }
 
+template <typename T>
+void
+FixedForest<T>::eval_batch(Context &context, ConstArrayRef<const double *> params,
+                           size_t num_docs, double *result) const
+{
+    assert(params.size() == _mask_sizes.size());
+    auto &ctx = static_cast<FixedContext<T>&>(context);
+    ctx.block_masks.resize(_num_trees * block_size);
+    T *ctx_masks = &ctx.block_masks[0];
+    FeatureBlock features;
+    for (size_t first = 0; first < num_docs; first += block_size) {
+        size_t cnt = std::min(block_size, num_docs - first);
+        memset(ctx_masks, 0xff, _num_trees * block_size * sizeof(T));
+        const Mask *mask_pos = &_masks[0];
+        for (size_t p = 0; p < _mask_sizes.size(); ++p) {
+            // unused slots in the last block never select any masks
+            float limit = -std::numeric_limits<float>::infinity();
+            bool has_nan = false;
+            for (size_t i = 0; i < block_size; ++i) {
+                features[i] = (i < cnt) ? float(params[p][first + i]) : -std::numeric_limits<float>::infinity();
+                limit = std::max(limit, features[i]);
+                has_nan |= std::isnan(features[i]);
+            }
+            apply_block_masks(ctx_masks, mask_pos, mask_pos + _mask_sizes[p], features, limit);
+            if (has_nan) {
+                apply_block_masks(ctx_masks,
+                                  &_default_masks[_default_offsets[p]],
+                                  &_default_masks[_default_offsets[p + 1]],
+                                  features);
+            }
+            mask_pos += _mask_sizes[p];
+        }
+        get_block_result(ctx_masks, cnt, result + first);
+    }
+}
+
 //-----------------------------------------------------------------------------
 // implementation using multiple words for each tree
 //-----------------------------------------------------------------------------
@@ -620,6 +739,70 @@ MultiWordForest::eval(Context &context, const float *params) const
     return get_result(ctx_words);
 }
 
+//-----------------------------------------------------------------------------
+
+FastForest::UP build_forest(const State &state, size_t min_fixed, size_t max_fixed) {
+    if (auto forest = FixedForest<uint8_t>::try_build(state, min_fixed, max_fixed)) {
+        return forest;
+    }
+    if (auto forest = FixedForest<uint16_t>::try_build(state, min_fixed, max_fixed)) {
+        return forest;
+    }
+    if (auto forest = FixedForest<uint32_t>::try_build(state, min_fixed, max_fixed)) {
+        return forest;
+    }
+    if (auto forest = FixedForest<uint64_t>::try_build(state, min_fixed, max_fixed)) {
+        return forest;
+    }
+    return MultiWordForest::try_build(state);
+}
+
+/**
+ * Makes a FastForest usable from compiled functions through the gbdt
+ * optimization pipeline.
+ **/
+struct FastForestModel : Forest {
+    static std::atomic<uint64_t> next_id;
+    FastForest::UP forest;
+    size_t num_params;
+    uint64_t id;
+    FastForestModel(FastForest::UP forest_in, size_t num_params_in)
+        : forest(std::move(forest_in)), num_params(num_params_in), id(next_id++) {}
+
+    // Compiled functions may be called by multiple threads at the
+    // same time, so evaluation state is kept per thread. Contexts are
+    // kept for a few recently used models, identified by id since the
+    // address of a model may be reused by a later one.
+    struct ThreadState {
+        static constexpr size_t max_contexts = 8;
+        std::vector<std::pair<uint64_t,FastForest::Context::UP>> contexts;
+        std::vector<float> params;
+        ThreadState() : contexts(), params() {}
+        FastForest::Context &context(const FastForestModel &model) {
+            for (const auto &entry: contexts) {
+                if (entry.first == model.id) {
+                    return *entry.second;
+                }
+            }
+            if (contexts.size() == max_contexts) {
+                contexts.erase(contexts.begin());
+            }
+            contexts.emplace_back(model.id, model.forest->create_context());
+            return *contexts.back().second;
+        }
+    };
+
+    static double eval(const Forest *self, const double *args) {
+        thread_local ThreadState state;
+        const auto &model = static_cast<const FastForestModel &>(*self);
+        FastForest::Context &ctx = state.context(model);
+        state.params.assign(args, args + model.num_params);
+        return model.forest->eval(ctx, state.params.data());
+    }
+};
+
+std::atomic<uint64_t> FastForestModel::next_id(0);
+
 }
 
 //-----------------------------------------------------------------------------
@@ -635,27 +818,18 @@ FastForest::~FastForest() = default;
 FastForest::UP
 FastForest::try_convert(const Function &fun, size_t min_fixed, size_t max_fixed)
 {
-    const auto &root = fun.root();
+    return try_convert(fun.root(), fun.num_params(), min_fixed, max_fixed);
+}
+
+FastForest::UP
+FastForest::try_convert(const nodes::Node &root, size_t num_params, size_t min_fixed, size_t max_fixed)
+{
     if (root.is_forest()) {
         auto trees = gbdt::extract_trees(root);
         gbdt::ForestStats stats(trees);
         if (stats.total_in_checks == 0) {
-            State state(fun.num_params(), trees);
-            if (auto forest = FixedForest<uint8_t>::try_build(state, min_fixed, max_fixed)) {
-                return forest;
-            }
-            if (auto forest = FixedForest<uint16_t>::try_build(state, min_fixed, max_fixed)) {
-                return forest;
-            }
-            if (auto forest = FixedForest<uint32_t>::try_build(state, min_fixed, max_fixed)) {
-                return forest;
-            }
-            if (auto forest = FixedForest<uint64_t>::try_build(state, min_fixed, max_fixed)) {
-                return forest;
-            }
-            if (auto forest = MultiWordForest::try_build(state)) {
-                return forest;
-            }
+            State state(num_params, trees);
+            return build_forest(state, min_fixed, max_fixed);
         }
     }
     return FastForest::UP();
@@ -669,4 +843,33 @@ FastForest::estimate_cost_us(const std::vector<double> &params, double budget) c
     return BenchmarkTimer::benchmark([&](){ eval(*ctx, &my_params[0]); }, budget) * 1000.0 * 1000.0;
 }
 
+void
+FastForest::eval_batch(Context &context, ConstArrayRef<const double *> params,
+                       size_t num_docs, double *result) const
+{
+    std::vector<float> my_params(params.size());
+    for (size_t doc = 0; doc < num_docs; ++doc) {
+        for (size_t i = 0; i < params.size(); ++i) {
+            my_params[i] = params[i][doc];
+        }
+        result[doc] = eval(context, &my_params[0]);
+    }
+}
+
+Optimize::Result
+FastForest::optimize(const ForestStats &stats,
+                     const std::vector<const nodes::Node *> &trees)
+{
+    if (stats.total_in_checks == 0) {
+        State state(stats.num_params, trees);
+        if (auto forest = build_forest(state, 8, 64)) {
+            return Optimize::Result(std::make_unique<FastForestModel>(std::move(forest), stats.num_params),
+                                    FastForestModel::eval);
+        }
+    }
+    return Optimize::Result();
+}
+
+Optimize::Chain FastForest::optimize_chain({optimize});
+
 }
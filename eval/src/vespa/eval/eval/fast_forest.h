@@ -3,6 +3,8 @@
 #pragma once
 
 #include "function.h"
+#include "gbdt.h"
+#include <vespa/vespalib/util/arrayref.h>
 #include <vespa/vespalib/util/optimized.h>
 #include <memory>
 #include <cassert>
@@ -17,6 +19,11 @@ namespace vespalib::eval::gbdt {
  * Comparisons must be on the form 'feature < const' or '!(feature >=
  * const)'. The inverted form is used to signal that the true branch
  * should be selected when the feature value is missing (NaN).
+ *
+ * Multiple documents may be evaluated together using eval_batch. The
+ * documents are then handled in small blocks, where the tree masks of
+ * all documents in a block are updated together for each threshold,
+ * which lets the compiler use wide vector instructions.
  **/
 class FastForest
 {
@@ -33,10 +40,17 @@ public:
         using UP = std::unique_ptr<Context>;
     };
     static UP try_convert(const Function &fun, size_t min_fixed = 8, size_t max_fixed = 64);
+    static UP try_convert(const nodes::Node &root, size_t num_params, size_t min_fixed = 8, size_t max_fixed = 64);
     virtual vespalib::string impl_name() const = 0;
     virtual Context::UP create_context() const = 0;
     virtual double eval(Context &context, const float *params) const = 0;
+    // params contains one column per feature, with one value per document
+    virtual void eval_batch(Context &context, ConstArrayRef<const double *> params,
+                            size_t num_docs, double *result) const;
     double estimate_cost_us(const std::vector<double> &params, double budget = 5.0) const;
+    static Optimize::Result optimize(const ForestStats &stats,
+                                     const std::vector<const nodes::Node *> &trees);
+    static Optimize::Chain optimize_chain;
 };
 
 }
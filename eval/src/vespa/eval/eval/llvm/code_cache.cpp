@@ -0,0 +1,223 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "code_cache.h"
+#include <vespa/vespalib/io/fileutil.h>
+#include <vespa/vespalib/stllike/hash_fun.h>
+#include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <unistd.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".eval.eval.llvm.code_cache");
+
+namespace fs = std::filesystem;
+
+namespace vespalib::eval {
+
+namespace {
+
+// written in front of the key and the object code in each cache entry
+struct EntryHeader {
+    static constexpr uint32_t MAGIC = 0x436f4465; // 'CoDe'
+    uint32_t magic;
+    uint32_t key_size;
+    uint64_t object_size;
+    uint64_t checksum;
+};
+
+uint64_t checksum(const char *object, size_t size) {
+    return hashValue(object, size);
+}
+
+} // namespace vespalib::eval::<unnamed>
+
+std::mutex CodeCache::_lock{};
+CodeCache::SP CodeCache::_bound{};
+
+vespalib::string
+CodeCache::make_path(const vespalib::string &key) const
+{
+    return _dir + "/" + key + ".o";
+}
+
+void
+CodeCache::unbind()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _bound.reset();
+}
+
+CodeCache::CodeCache(const vespalib::string &dir)
+    : _dir(dir),
+      _hits(0),
+      _misses(0),
+      _errors(0),
+      _tmp_id(0)
+{
+    std::error_code ec;
+    fs::create_directories(fs::path(_dir.c_str()), ec);
+    if (ec) {
+        LOG(warning, "could not create code cache directory '%s': %s", _dir.c_str(), ec.message().c_str());
+    }
+}
+
+CodeCache::~CodeCache() = default;
+
+bool
+CodeCache::load(const vespalib::string &key, vespalib::string &object)
+{
+    vespalib::string path = make_path(key);
+    std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+    if (!file) {
+        ++_misses;
+        return false;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (file.bad()) {
+        LOG(warning, "could not read cached code from '%s'", path.c_str());
+        ++_errors;
+        ++_misses;
+        return false;
+    }
+    EntryHeader header;
+    bool valid = (data.size() >= sizeof(header));
+    if (valid) {
+        memcpy(&header, data.data(), sizeof(header));
+        const char *entry_key = data.data() + sizeof(header);
+        const char *entry_object = entry_key + header.key_size;
+        valid = ((header.magic == EntryHeader::MAGIC) &&
+                 (data.size() == sizeof(header) + header.key_size + header.object_size) &&
+                 (header.object_size > 0) &&
+                 (vespalib::stringref(entry_key, header.key_size) == key) &&
+                 (header.checksum == checksum(entry_object, header.object_size)));
+    }
+    if (!valid) {
+        // partially written or corrupted entry; remove it to have it replaced
+        LOG(warning, "removing invalid cached code in '%s'", path.c_str());
+        std::error_code ec;
+        fs::remove(fs::path(path.c_str()), ec);
+        ++_errors;
+        ++_misses;
+        return false;
+    }
+    object.assign(data.data() + sizeof(header) + header.key_size, header.object_size);
+    // touch the entry to keep it when pruning the cache
+    std::error_code ec;
+    fs::last_write_time(fs::path(path.c_str()), fs::file_time_type::clock::now(), ec);
+    ++_hits;
+    return true;
+}
+
+void
+CodeCache::store(const vespalib::string &key, const char *object, size_t size)
+{
+    vespalib::string path = make_path(key);
+    vespalib::string tmp_path = make_string("%s.tmp.%d.%zu", path.c_str(), int(getpid()), _tmp_id++);
+    EntryHeader header;
+    header.magic = EntryHeader::MAGIC;
+    header.key_size = key.size();
+    header.object_size = size;
+    header.checksum = checksum(object, size);
+    bool written = false;
+    try {
+        File file(tmp_path);
+        file.open(File::CREATE | File::TRUNC);
+        file.write(&header, sizeof(header), 0);
+        file.write(key.data(), key.size(), sizeof(header));
+        file.write(object, size, sizeof(header) + key.size());
+        // make sure the entry is complete on disk before it becomes visible
+        file.sync();
+        written = file.close();
+    } catch (const IoException &e) {
+        LOG(debug, "could not write '%s': %s", tmp_path.c_str(), e.getMessage().c_str());
+    }
+    std::error_code ec;
+    if (written) {
+        fs::rename(fs::path(tmp_path.c_str()), fs::path(path.c_str()), ec);
+    }
+    if (written && !ec) {
+        try {
+            File::sync(_dir);
+        } catch (const IoException &e) {
+            LOG(debug, "could not sync code cache directory '%s': %s", _dir.c_str(), e.getMessage().c_str());
+        }
+    }
+    if (!written || ec) {
+        LOG(warning, "could not store cached code in '%s'", path.c_str());
+        fs::remove(fs::path(tmp_path.c_str()), ec);
+        ++_errors;
+    }
+}
+
+void
+CodeCache::prune(size_t max_bytes)
+{
+    struct Entry {
+        fs::file_time_type time;
+        size_t size;
+        fs::path path;
+    };
+    std::vector<Entry> entries;
+    size_t total = 0;
+    std::error_code ec;
+    for (const auto &dir_entry: fs::directory_iterator(fs::path(_dir.c_str()), ec)) {
+        std::error_code entry_ec;
+        if (dir_entry.is_regular_file(entry_ec)) {
+            size_t size = dir_entry.file_size(entry_ec);
+            auto time = dir_entry.last_write_time(entry_ec);
+            if (!entry_ec) {
+                entries.push_back(Entry{time, size, dir_entry.path()});
+                total += size;
+            }
+        }
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry &a, const Entry &b){ return (a.time < b.time); });
+    size_t removed = 0;
+    for (const auto &entry: entries) {
+        if (total <= max_bytes) {
+            break;
+        }
+        if (fs::remove(entry.path, ec)) {
+            total -= entry.size;
+            ++removed;
+        }
+    }
+    if (removed > 0) {
+        LOG(info, "pruned code cache '%s': removed %zu of %zu entries", _dir.c_str(), removed, entries.size());
+    }
+}
+
+CodeCache::Stats
+CodeCache::get_stats() const
+{
+    Stats stats;
+    stats.hits = _hits.load(std::memory_order_relaxed);
+    stats.misses = _misses.load(std::memory_order_relaxed);
+    stats.errors = _errors.load(std::memory_order_relaxed);
+    return stats;
+}
+
+CodeCache::Binding::UP
+CodeCache::bind(SP cache)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    assert(!_bound);
+    _bound = std::move(cache);
+    return std::make_unique<Binding>(Binding::ctor_tag());
+}
+
+CodeCache::SP
+CodeCache::get_bound()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    return _bound;
+}
+
+}
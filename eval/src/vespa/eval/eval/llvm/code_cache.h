@@ -0,0 +1,86 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/string.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace vespalib::eval {
+
+/**
+ * A persistent cache of machine code generated by LLVM, stored as one
+ * object file per compiled module in a local directory. The key of a
+ * module is a hash of its IR together with the LLVM version and the
+ * target cpu, which means that cached code can be shared between all
+ * users in the process (like multiple document databases) and reused
+ * after a restart. The generated code does not contain addresses of
+ * run-time objects (like gbdt forests); they are bound when the code
+ * is loaded. Entries are written to a temporary file that is synced
+ * and renamed into place, and each entry records its key, size and
+ * checksum. Entries that do not match when loaded (e.g. truncated by
+ * a crash) are counted as misses and removed.
+ *
+ * A single cache can be bound to be used by all subsequent
+ * compilations (see LLVMWrapper) for as long as the binding is alive.
+ **/
+class CodeCache
+{
+public:
+    struct Stats {
+        size_t hits;
+        size_t misses;
+        size_t errors;
+        Stats() : hits(0), misses(0), errors(0) {}
+    };
+    using SP = std::shared_ptr<CodeCache>;
+
+    class Binding {
+    private:
+        friend class CodeCache;
+        struct ctor_tag {};
+    public:
+        Binding(Binding &&) = delete;
+        Binding(const Binding &) = delete;
+        Binding &operator=(Binding &&) = delete;
+        Binding &operator=(const Binding &) = delete;
+        using UP = std::unique_ptr<Binding>;
+        explicit Binding(ctor_tag) {}
+        ~Binding() { CodeCache::unbind(); }
+    };
+
+private:
+    vespalib::string    _dir;
+    std::atomic<size_t> _hits;
+    std::atomic<size_t> _misses;
+    std::atomic<size_t> _errors;
+    std::atomic<size_t> _tmp_id;
+
+    static std::mutex _lock;
+    static SP _bound;
+
+    vespalib::string make_path(const vespalib::string &key) const;
+    static void unbind();
+
+public:
+    explicit CodeCache(const vespalib::string &dir);
+    ~CodeCache();
+    const vespalib::string &dir() const { return _dir; }
+
+    // look up the object code stored for the given key
+    bool load(const vespalib::string &key, vespalib::string &object);
+
+    // store object code for the given key, replacing any existing entry
+    void store(const vespalib::string &key, const char *object, size_t size);
+
+    // remove the least recently used entries until at most max_bytes are used
+    void prune(size_t max_bytes);
+
+    Stats get_stats() const;
+
+    static Binding::UP bind(SP cache);
+    static SP get_bound();
+};
+
+}
@@ -48,12 +48,17 @@ CompileCache::detach_executor(uint64_t tag)
 };
 
 CompileCache::Token::UP
-CompileCache::compile(const Function &function, PassParams pass_params)
+CompileCache::compile(const Function &function, PassParams pass_params,
+                      const gbdt::Optimize::Chain &forest_optimizers)
 {
     Token::UP token;
     Executor::Task::UP task;
     std::shared_ptr<Executor> executor;
     vespalib::string key = gen_key(function, pass_params);
+    if (&forest_optimizers != &gbdt::Optimize::best) {
+        const gbdt::Optimize::Chain *chain = &forest_optimizers;
+        key.append(reinterpret_cast<const char *>(&chain), sizeof(chain));
+    }
     {
         std::lock_guard<std::mutex> guard(_lock);
         auto pos = _cached.find(key);
@@ -64,7 +69,7 @@ CompileCache::compile(const Function &function, PassParams pass_params)
             auto res = _cached.emplace(std::move(key), Value::ctor_tag());
             assert(res.second);
             token = std::make_unique<Token>(res.first, Token::ctor_tag());
-            task = std::make_unique<CompileTask>(function, pass_params, res.first->second.result);
+            task = std::make_unique<CompileTask>(function, pass_params, forest_optimizers, res.first->second.result);
             if (!_executor_stack.empty()) {
                 executor = _executor_stack.back().second;
             }
@@ -141,7 +146,7 @@ CompileCache::count_pending()
 void
 CompileCache::CompileTask::run()
 {
-    auto compiled = std::make_unique<CompiledFunction>(*function, pass_params);
+    auto compiled = std::make_unique<CompiledFunction>(*function, pass_params, forest_optimizers);
     std::lock_guard<std::mutex> guard(result->lock);
     result->compiled_function = std::move(compiled);
     result->cf.store(result->compiled_function.get(), std::memory_order_release);
@@ -17,7 +17,9 @@ namespace eval {
  * expression AST is used to produce a binary key that in turn is used
  * to query the cache. The cache itself will not keep anything alive,
  * but will let you find compiled functions that are currently in use
- * by others.
+ * by others. Functions compiled with different forest optimizers are
+ * cached separately; the optimizer chain must outlive the cache
+ * entries (typically a static chain like gbdt::Optimize::best).
  **/
 class CompileCache
 {
@@ -89,7 +91,11 @@ public:
         ~ExecutorBinding() { detach_executor(_tag); }
     };
 
-    static Token::UP compile(const Function &function, PassParams pass_params);
+    static Token::UP compile(const Function &function, PassParams pass_params,
+                             const gbdt::Optimize::Chain &forest_optimizers);
+    static Token::UP compile(const Function &function, PassParams pass_params) {
+        return compile(function, pass_params, gbdt::Optimize::best);
+    }
     static void wait_pending();
     static ExecutorBinding::UP bind(std::shared_ptr<Executor> executor) {
         return std::make_unique<ExecutorBinding>(std::move(executor), ExecutorBinding::ctor_tag());
@@ -103,9 +109,12 @@ private:
     struct CompileTask : public Executor::Task {
         std::shared_ptr<Function const> function;
         PassParams pass_params;
+        const gbdt::Optimize::Chain &forest_optimizers;
         Result::SP result;
-        CompileTask(const Function &function_in, PassParams pass_params_in, Result::SP result_in)
-            : function(function_in.shared_from_this()), pass_params(pass_params_in), result(std::move(result_in)) {}
+        CompileTask(const Function &function_in, PassParams pass_params_in,
+                    const gbdt::Optimize::Chain &forest_optimizers_in, Result::SP result_in)
+            : function(function_in.shared_from_this()), pass_params(pass_params_in),
+              forest_optimizers(forest_optimizers_in), result(std::move(result_in)) {}
         void run() override;
     };
 };
@@ -24,6 +24,12 @@
 #if LLVM_VERSION_MAJOR > 9
 #include <llvm/Support/ManagedStatic.h>
 #endif
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
 #include <vespa/eval/eval/check_type.h>
 #include <vespa/vespalib/stllike/hash_set.h>
 #include <vespa/vespalib/util/approx.h>
@@ -93,6 +99,7 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
     const gbdt::Optimize::Chain &forest_optimizers;
     std::vector<gbdt::Forest::UP> &forests;
     std::vector<PluginState::UP> &plugin_state;
+    std::vector<InjectedSymbol> &injected;
 
     llvm::FunctionType *make_call_1_fun_t() {
         std::vector<llvm::Type*> param_types;
@@ -149,7 +156,8 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
                     PassParams pass_params_in,
                     const gbdt::Optimize::Chain &forest_optimizers_in,
                     std::vector<gbdt::Forest::UP> &forests_out,
-                    std::vector<PluginState::UP> &plugin_state_out)
+                    std::vector<PluginState::UP> &plugin_state_out,
+                    std::vector<InjectedSymbol> &injected_out)
         : context(context_in),
           module(module_in),
           builder(context),
@@ -162,7 +170,8 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
           forest_end(nullptr),
           forest_optimizers(forest_optimizers_in),
           forests(forests_out),
-          plugin_state(plugin_state_out)
+          plugin_state(plugin_state_out),
+          injected(injected_out)
     {
         std::vector<llvm::Type*> param_types;
         if (pass_params == PassParams::SEPARATE) {
@@ -238,6 +247,19 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
 
     //-------------------------------------------------------------------------
 
+    // Run-time addresses are referenced through external symbols that
+    // are bound when the code is loaded. This keeps the generated code
+    // independent of the current process, making it possible to cache.
+    llvm::Value *inject(void *address, llvm::Type *type, const char *name) {
+        auto *symbol = new llvm::GlobalVariable(module, builder.getInt8Ty(), true,
+                                                llvm::GlobalValue::ExternalLinkage, nullptr,
+                                                vespalib::make_string("%s_%zu", name, injected.size()).c_str());
+        injected.push_back(InjectedSymbol{symbol, address});
+        return builder.CreateBitCast(symbol, type, name);
+    }
+
+    //-------------------------------------------------------------------------
+
     bool try_optimize_forest(const Node &item) {
         auto trees = gbdt::extract_trees(item);
         gbdt::ForestStats stats(trees);
@@ -249,14 +271,14 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
         void *eval_ptr = (void *) optimize_result.eval;
         gbdt::Forest *forest = forests.back().get();
         llvm::PointerType *eval_funptr_t = make_eval_forest_funptr_t();
-        llvm::Value *eval_fun = builder.CreateIntToPtr(builder.getInt64((uint64_t)eval_ptr), eval_funptr_t, "inject_eval");
-        llvm::Value *ctx = builder.CreateIntToPtr(builder.getInt64((uint64_t)forest), builder.getVoidTy()->getPointerTo(), "inject_ctx");
+        llvm::Value *eval_fun = inject(eval_ptr, eval_funptr_t, "inject_eval");
+        llvm::Value *ctx = inject(forest, builder.getVoidTy()->getPointerTo(), "inject_ctx");
         if (pass_params == PassParams::ARRAY) {
 	    push(builder.CreateCall(eval_fun, {ctx, params[0]}, "call_eval"));
         } else {
             assert(pass_params == PassParams::LAZY);
             llvm::PointerType *proxy_funptr_t = make_eval_forest_proxy_funptr_t();
-            llvm::Value *proxy_fun = builder.CreateIntToPtr(builder.getInt64((uint64_t)vespalib_eval_forest_proxy), proxy_funptr_t, "inject_eval_proxy");
+            llvm::Value *proxy_fun = inject((void *) vespalib_eval_forest_proxy, proxy_funptr_t, "inject_eval_proxy");
             push(builder.CreateCall(proxy_fun, {eval_fun, ctx, params[0], params[1], builder.getInt64(stats.num_params)}));
         }
         return true;
@@ -409,8 +431,8 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
             void *call_ptr = (void *) SetMemberHash::check_membership;
             PluginState *state = plugin_state.back().get();
             llvm::PointerType *funptr_t = make_check_membership_funptr_t();
-            llvm::Value *call_fun = builder.CreateIntToPtr(builder.getInt64((uint64_t)call_ptr), funptr_t, "inject_call_addr");
-            llvm::Value *ctx = builder.CreateIntToPtr(builder.getInt64((uint64_t)state), builder.getVoidTy()->getPointerTo(), "inject_ctx");
+            llvm::Value *call_fun = inject(call_ptr, funptr_t, "inject_call_addr");
+            llvm::Value *ctx = inject(state, builder.getVoidTy()->getPointerTo(), "inject_ctx");
             push(builder.CreateCall(call_fun, {ctx, lhs}, "call_check_membership"));
         } else {
             // build explicit code to check all set members
@@ -651,6 +673,51 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
 
 FunctionBuilder::~FunctionBuilder() { }
 
+/**
+ * Adapts a CodeCache to be used by the LLVM execution engine. The key
+ * is calculated from the module before it is compiled, since code
+ * generation will modify the module.
+ **/
+class CachedModule : public llvm::ObjectCache {
+private:
+    CodeCache        &_cache;
+    vespalib::string  _key;
+public:
+    CachedModule(CodeCache &cache, const llvm::Module &module, const llvm::TargetMachine &target)
+        : _cache(cache), _key()
+    {
+        std::string ir;
+        llvm::raw_string_ostream ir_stream(ir);
+        module.print(ir_stream, nullptr);
+        ir_stream.flush();
+        llvm::MD5 hasher;
+        hasher.update(LLVM_VERSION_STRING);
+        hasher.update(target.getTargetTriple().str());
+        hasher.update(target.getTargetCPU());
+        hasher.update(target.getTargetFeatureString());
+        hasher.update(llvm::sys::getHostCPUName());
+        hasher.update(ir);
+        llvm::MD5::MD5Result result;
+        hasher.final(result);
+        llvm::SmallString<32> hex;
+        llvm::MD5::stringifyResult(result, hex);
+        _key.assign(hex.data(), hex.size());
+    }
+    ~CachedModule() override;
+    void notifyObjectCompiled(const llvm::Module *, llvm::MemoryBufferRef object) override {
+        _cache.store(_key, object.getBufferStart(), object.getBufferSize());
+    }
+    std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *) override {
+        vespalib::string object;
+        if (!_cache.load(_key, object)) {
+            return std::unique_ptr<llvm::MemoryBuffer>();
+        }
+        return llvm::MemoryBuffer::getMemBufferCopy(llvm::StringRef(object.data(), object.size()));
+    }
+};
+
+CachedModule::~CachedModule() = default;
+
 } // namespace vespalib::eval::<unnamed>
 
 struct InitializeNativeTarget {
@@ -677,7 +744,8 @@ LLVMWrapper::LLVMWrapper()
       _engine(),
       _functions(),
       _forests(),
-      _plugin_state()
+      _plugin_state(),
+      _injected()
 {
     _context = std::make_unique<llvm::LLVMContext>();
     _module = std::make_unique<llvm::Module>("LLVMWrapper", *_context);
@@ -691,7 +759,7 @@ LLVMWrapper::make_function(size_t num_params, PassParams pass_params, const Node
     FunctionBuilder builder(*_context, *_module,
                             vespalib::make_string("f%zu", function_id),
                             num_params, pass_params,
-                            forest_optimizers, _forests, _plugin_state);
+                            forest_optimizers, _forests, _plugin_state, _injected);
     builder.build_root(root);
     _functions.push_back(builder.build());
     return function_id;
@@ -704,7 +772,7 @@ LLVMWrapper::make_forest_fragment(size_t num_params, const std::vector<const Nod
     FunctionBuilder builder(*_context, *_module,
                             vespalib::make_string("f%zu", function_id),
                             num_params, PassParams::ARRAY,
-                            gbdt::Optimize::none, _forests, _plugin_state);
+                            gbdt::Optimize::none, _forests, _plugin_state, _injected);
     builder.build_forest_fragment(fragment);
     _functions.push_back(builder.build());
     return function_id;
@@ -716,9 +784,21 @@ LLVMWrapper::compile(llvm::raw_ostream * dumpStream)
     if (dumpStream) {
         _module->print(*dumpStream, nullptr);
     }
+    const llvm::Module &module = *_module;
     _engine.reset(llvm::EngineBuilder(std::move(_module)).setOptLevel(llvm::CodeGenOpt::Aggressive).create());
     assert(_engine && "llvm jit not available for your platform");
-    _engine->finalizeObject();
+    for (const auto &symbol: _injected) {
+        _engine->addGlobalMapping(symbol.symbol, symbol.address);
+    }
+    std::unique_ptr<CachedModule> cached_module;
+    if (auto code_cache = CodeCache::get_bound()) {
+        cached_module = std::make_unique<CachedModule>(*code_cache, module, *_engine->getTargetMachine());
+        _engine->setObjectCache(cached_module.get());
+        _engine->finalizeObject();
+        _engine->setObjectCache(nullptr);
+    } else {
+        _engine->finalizeObject();
+    }
 }
 
 void *
@@ -730,6 +810,7 @@ LLVMWrapper::get_function_address(size_t function_id)
 LLVMWrapper::~LLVMWrapper() {
     _plugin_state.clear();
     _forests.clear();
+    _injected.clear();
     _functions.clear();
     _engine.reset();
     _module.reset();
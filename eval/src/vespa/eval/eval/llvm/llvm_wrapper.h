@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "code_cache.h"
 #include <vespa/eval/eval/function.h>
 #include <vespa/eval/eval/gbdt.h>
 
@@ -35,9 +36,20 @@ struct PluginState {
     virtual ~PluginState() {}
 };
 
+/**
+ * An external symbol in the generated code that is bound to a
+ * run-time address when the code is loaded.
+ **/
+struct InjectedSymbol {
+    const llvm::GlobalValue *symbol;
+    void                    *address;
+};
+
 /**
  * Stuff related to LLVM code generation is wrapped in this
- * class. This is mostly used by the CompiledFunction class.
+ * class. This is mostly used by the CompiledFunction class. If a
+ * CodeCache is bound, it is used to look up previously generated
+ * machine code before compiling.
  **/
 class LLVMWrapper
 {
@@ -48,6 +60,7 @@ private:
     std::vector<llvm::Function*>           _functions;
     std::vector<gbdt::Forest::UP>          _forests;
     std::vector<PluginState::UP>           _plugin_state;
+    std::vector<InjectedSymbol>            _injected;
 
     void compile(llvm::raw_ostream * dumpStream);
 public:
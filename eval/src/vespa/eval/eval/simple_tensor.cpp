@@ -29,6 +29,8 @@ uint32_t cell_type_to_id(CellType cell_type) {
     switch (cell_type) {
     case CellType::DOUBLE: return DOUBLE_CELL_TYPE;
     case CellType::FLOAT: return FLOAT_CELL_TYPE;
+    case CellType::BFLOAT16:
+    case CellType::INT8: break; // storage only
     }
     abort();
 }
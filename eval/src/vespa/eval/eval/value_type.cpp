@@ -23,6 +23,8 @@ CellType unify(CellType b) {
     switch (b) {
     case CellType::DOUBLE: return unify<A,double>();
     case CellType::FLOAT: return unify<A,float>();
+    case CellType::BFLOAT16:
+    case CellType::INT8: return unify<A,float>();
     }
     abort();
 }
@@ -31,10 +33,16 @@ CellType unify(CellType a, CellType b) {
     switch (a) {
     case CellType::DOUBLE: return unify<double>(b);
     case CellType::FLOAT: return unify<float>(b);
+    case CellType::BFLOAT16:
+    case CellType::INT8: return unify<float>(b);
     }
     abort();
 }
 
+CellType decay(CellType cell_type) {
+    return ValueType::is_storage_cell_type(cell_type) ? CellType::FLOAT : cell_type;
+}
+
 size_t my_dimension_index(const std::vector<Dimension> &list, const vespalib::string &name) {
     for (size_t idx = 0; idx < list.size(); ++idx) {
         if (list[idx].name == name) {
@@ -211,6 +219,27 @@ ValueType::dimension_names() const
     return result;
 }
 
+size_t
+ValueType::cell_size(CellType cell_type)
+{
+    switch (cell_type) {
+    case CellType::DOUBLE: return sizeof(double);
+    case CellType::FLOAT: return sizeof(float);
+    case CellType::BFLOAT16: return sizeof(BFloat16);
+    case CellType::INT8: return sizeof(int8_t);
+    }
+    abort();
+}
+
+ValueType
+ValueType::decay_cell_type() const
+{
+    if (!is_storage_cell_type(_cell_type)) {
+        return *this;
+    }
+    return ValueType(_type, decay(_cell_type), std::vector<Dimension>(_dimensions));
+}
+
 ValueType
 ValueType::reduce(const std::vector<vespalib::string> &dimensions_in) const
 {
@@ -231,7 +260,7 @@ ValueType::reduce(const std::vector<vespalib::string> &dimensions_in) const
     if (removed != dimensions_in.size()) {
         return error_type();
     }
-    return tensor_type(std::move(result), _cell_type);
+    return tensor_type(std::move(result), decay(_cell_type));
 }
 
 ValueType
@@ -249,7 +278,7 @@ ValueType::rename(const std::vector<vespalib::string> &from,
     if (!renamer.matched_all()) {
         return error_type();
     }
-    return tensor_type(dim_list, _cell_type);
+    return tensor_type(dim_list, decay(_cell_type));
 }
 
 ValueType
@@ -277,6 +306,12 @@ ValueType::from_spec(const vespalib::string &spec, std::vector<ValueType::Dimens
     return value_type::from_spec(spec, unsorted);
 }
 
+ValueType
+ValueType::from_storage_spec(const vespalib::string &spec)
+{
+    return value_type::from_storage_spec(spec);
+}
+
 vespalib::string
 ValueType::to_spec() const
 {
@@ -289,9 +324,9 @@ ValueType::join(const ValueType &lhs, const ValueType &rhs)
     if (lhs.is_error() || rhs.is_error()) {
         return error_type();
     } else if (lhs.is_double()) {
-        return rhs;
+        return rhs.decay_cell_type();
     } else if (rhs.is_double()) {
-        return lhs;
+        return lhs.decay_cell_type();
     }
     MyJoin result(lhs._dimensions, rhs._dimensions);
     if (result.mismatch) {
@@ -317,9 +352,9 @@ ValueType::merge(const ValueType &lhs, const ValueType &rhs)
 CellType
 ValueType::unify_cell_types(const ValueType &a, const ValueType &b) {
     if (a.is_double()) {
-        return b.cell_type();
+        return decay(b.cell_type());
     } else if (b.is_double()) {
-        return a.cell_type();
+        return decay(a.cell_type());
     }
     return unify(a.cell_type(), b.cell_type());
 }
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <vespa/vespalib/util/typify.h>
+#include <vespa/vespalib/util/bfloat16.h>
 #include <vespa/vespalib/stllike/string.h>
 #include <vector>
 
@@ -17,7 +18,12 @@ class ValueType
 {
 public:
     enum class Type { ERROR, DOUBLE, TENSOR };
-    enum class CellType : char { FLOAT, DOUBLE };
+    // BFLOAT16 and INT8 are storage cell types; they are used to
+    // reduce the memory footprint of dense tensor attributes. They
+    // are only parsed by from_storage_spec, and values taking part in
+    // expression evaluation always have FLOAT or DOUBLE cells (see
+    // decay_cell_type).
+    enum class CellType : char { FLOAT, DOUBLE, BFLOAT16, INT8 };
     struct Dimension {
         using size_type = uint32_t;
         static constexpr size_type npos = -1;
@@ -72,15 +78,23 @@ public:
     }
     bool operator!=(const ValueType &rhs) const { return !(*this == rhs); }
 
+    bool has_storage_cell_type() const { return is_storage_cell_type(_cell_type); }
+    ValueType decay_cell_type() const;
     ValueType reduce(const std::vector<vespalib::string> &dimensions_in) const;
     ValueType rename(const std::vector<vespalib::string> &from,
                      const std::vector<vespalib::string> &to) const;
 
+    static bool is_storage_cell_type(CellType cell_type) {
+        return ((cell_type == CellType::BFLOAT16) || (cell_type == CellType::INT8));
+    }
+    static size_t cell_size(CellType cell_type);
     static ValueType error_type() { return ValueType(Type::ERROR); }
     static ValueType double_type() { return ValueType(Type::DOUBLE); }
     static ValueType tensor_type(std::vector<Dimension> dimensions_in, CellType cell_type = CellType::DOUBLE);
     static ValueType from_spec(const vespalib::string &spec);
     static ValueType from_spec(const vespalib::string &spec, std::vector<ValueType::Dimension> &unsorted);
+    // also accepts storage cell types; only for tensor attribute types
+    static ValueType from_storage_spec(const vespalib::string &spec);
     vespalib::string to_spec() const;
     static ValueType join(const ValueType &lhs, const ValueType &rhs);
     static ValueType merge(const ValueType &lhs, const ValueType &rhs);
@@ -96,6 +110,8 @@ std::ostream &operator<<(std::ostream &os, const ValueType &type);
 template <typename CT> inline bool check_cell_type(ValueType::CellType type);
 template <> inline bool check_cell_type<double>(ValueType::CellType type) { return (type == ValueType::CellType::DOUBLE); }
 template <> inline bool check_cell_type<float>(ValueType::CellType type) { return (type == ValueType::CellType::FLOAT); }
+template <> inline bool check_cell_type<BFloat16>(ValueType::CellType type) { return (type == ValueType::CellType::BFLOAT16); }
+template <> inline bool check_cell_type<int8_t>(ValueType::CellType type) { return (type == ValueType::CellType::INT8); }
 
 template <typename LCT, typename RCT> struct UnifyCellTypes{};
 template <> struct UnifyCellTypes<double, double> { using type = double; };
@@ -106,6 +122,8 @@ template <> struct UnifyCellTypes<float,  float>  { using type = float; };
 template <typename CT> inline ValueType::CellType get_cell_type();
 template <> inline ValueType::CellType get_cell_type<double>() { return ValueType::CellType::DOUBLE; }
 template <> inline ValueType::CellType get_cell_type<float>() { return ValueType::CellType::FLOAT; }
+template <> inline ValueType::CellType get_cell_type<BFloat16>() { return ValueType::CellType::BFLOAT16; }
+template <> inline ValueType::CellType get_cell_type<int8_t>() { return ValueType::CellType::INT8; }
 
 struct TypifyCellType {
     template <typename T> using Result = TypifyResultType<T>;
@@ -113,6 +131,22 @@ struct TypifyCellType {
         switch(value) {
         case ValueType::CellType::DOUBLE: return f(Result<double>());
         case ValueType::CellType::FLOAT:  return f(Result<float>());
+        case ValueType::CellType::BFLOAT16:
+        case ValueType::CellType::INT8:   break; // storage only, see decay_cell_type
+        }
+        abort();
+    }
+};
+
+// also resolves storage cell types; used by code working directly on stored cells
+struct TypifyStorageCellType {
+    template <typename T> using Result = TypifyResultType<T>;
+    template <typename F> static decltype(auto) resolve(ValueType::CellType value, F &&f) {
+        switch(value) {
+        case ValueType::CellType::DOUBLE:   return f(Result<double>());
+        case ValueType::CellType::FLOAT:    return f(Result<float>());
+        case ValueType::CellType::BFLOAT16: return f(Result<BFloat16>());
+        case ValueType::CellType::INT8:     return f(Result<int8_t>());
         }
         abort();
     }
@@ -16,6 +16,8 @@ const char *to_name(CellType cell_type) {
     switch (cell_type) {
     case CellType::DOUBLE: return "double";
     case CellType::FLOAT: return "float";
+    case CellType::BFLOAT16: return "bfloat16";
+    case CellType::INT8: return "int8";
     }
     abort();
 }
@@ -154,7 +156,7 @@ std::vector<ValueType::Dimension> parse_dimension_list(ParseContext &ctx) {
     return list;
 }
 
-CellType parse_cell_type(ParseContext &ctx) {
+CellType parse_cell_type(ParseContext &ctx, bool allow_storage_cell_types) {
     auto mark = ctx.mark();
     ctx.skip_spaces();
     ctx.eat('<');
@@ -167,6 +169,10 @@ CellType parse_cell_type(ParseContext &ctx) {
     }
     if (cell_type == "float") {
         return CellType::FLOAT;
+    } else if (allow_storage_cell_types && (cell_type == "bfloat16")) {
+        return CellType::BFLOAT16;
+    } else if (allow_storage_cell_types && (cell_type == "int8")) {
+        return CellType::INT8;
     } else if (cell_type != "double") {
         ctx.fail();
     }
@@ -177,7 +183,7 @@ CellType parse_cell_type(ParseContext &ctx) {
 
 ValueType
 parse_spec(const char *pos_in, const char *end_in, const char *&pos_out,
-           std::vector<ValueType::Dimension> *unsorted)
+           std::vector<ValueType::Dimension> *unsorted, bool allow_storage_cell_types)
 {
     ParseContext ctx(pos_in, end_in, pos_out);
     vespalib::string type_name = parse_ident(ctx);
@@ -186,7 +192,7 @@ parse_spec(const char *pos_in, const char *end_in, const char *&pos_out,
     } else if (type_name == "double") {
         return ValueType::double_type();
     } else if (type_name == "tensor") {
-        ValueType::CellType cell_type = parse_cell_type(ctx);
+        ValueType::CellType cell_type = parse_cell_type(ctx, allow_storage_cell_types);
         std::vector<ValueType::Dimension> list = parse_dimension_list(ctx);
         if (!ctx.failed()) {
             if (unsorted != nullptr) {
@@ -212,6 +218,18 @@ from_spec(const vespalib::string &spec)
     return type;
 }
 
+ValueType
+from_storage_spec(const vespalib::string &spec)
+{
+    const char *after = nullptr;
+    const char *end = spec.data() + spec.size();
+    ValueType type = parse_spec(spec.data(), end, after, nullptr, true);
+    if (after != end) {
+        return ValueType::error_type();
+    }
+    return type;
+}
+
 ValueType
 from_spec(const vespalib::string &spec, std::vector<ValueType::Dimension> &unsorted)
 {
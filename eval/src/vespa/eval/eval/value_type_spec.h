@@ -7,9 +7,11 @@
 namespace vespalib::eval::value_type {
 
 ValueType parse_spec(const char *pos_in, const char *end_in, const char *&pos_out,
-                     std::vector<ValueType::Dimension> *unsorted = nullptr);
+                     std::vector<ValueType::Dimension> *unsorted = nullptr,
+                     bool allow_storage_cell_types = false);
 
 ValueType from_spec(const vespalib::string &spec);
+ValueType from_storage_spec(const vespalib::string &spec);
 ValueType from_spec(const vespalib::string &spec, std::vector<ValueType::Dimension> &unsorted);
 vespalib::string to_spec(const ValueType &type);
 
@@ -19,6 +19,8 @@ struct TypedCells {
 
     explicit TypedCells(ConstArrayRef<double> cells) : data(cells.begin()), type(CellType::DOUBLE), size(cells.size()) {}
     explicit TypedCells(ConstArrayRef<float> cells) : data(cells.begin()), type(CellType::FLOAT), size(cells.size()) {}
+    explicit TypedCells(ConstArrayRef<BFloat16> cells) : data(cells.begin()), type(CellType::BFLOAT16), size(cells.size()) {}
+    explicit TypedCells(ConstArrayRef<int8_t> cells) : data(cells.begin()), type(CellType::INT8), size(cells.size()) {}
 
     TypedCells() : data(nullptr), type(CellType::DOUBLE), size(0) {}
     TypedCells(const void *dp, CellType ct, size_t sz) : data(dp), type(ct), size(sz) {}
@@ -41,6 +43,14 @@ struct TypedCells {
             const float *p = (const float *)data;
             return p[idx];
         }
+        if (type == CellType::BFLOAT16) {
+            const BFloat16 *p = (const BFloat16 *)data;
+            return p[idx];
+        }
+        if (type == CellType::INT8) {
+            const int8_t *p = (const int8_t *)data;
+            return p[idx];
+        }
         abort();
     }
 
@@ -55,6 +65,8 @@ decltype(auto) dispatch_1(const TypedCells &a, Args &&...args) {
     switch (a.type) {
         case CellType::DOUBLE: return TGT::call(a.unsafe_typify<double>(), std::forward<Args>(args)...);
         case CellType::FLOAT:  return TGT::call(a.unsafe_typify<float>(),  std::forward<Args>(args)...);
+        case CellType::BFLOAT16:
+        case CellType::INT8:   break; // storage only
     }
     abort();
 }
@@ -64,6 +76,8 @@ decltype(auto) dispatch_2(A1 &&a, const TypedCells &b, Args &&...args) {
     switch (b.type) {
         case CellType::DOUBLE: return dispatch_1<TGT>(std::forward<A1>(a), b.unsafe_typify<double>(), std::forward<Args>(args)...);
         case CellType::FLOAT:  return dispatch_1<TGT>(std::forward<A1>(a), b.unsafe_typify<float>(),  std::forward<Args>(args)...);
+        case CellType::BFLOAT16:
+        case CellType::INT8:   break; // storage only
     }
     abort();
 }
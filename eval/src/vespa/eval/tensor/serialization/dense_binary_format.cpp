@@ -68,6 +68,9 @@ void decodeCells(CellType cell_type, nbostream &stream, size_t cellsSize, V &cel
     case CellType::FLOAT:
         decodeCells<float>(stream, cellsSize, cells);
         break;
+    case CellType::BFLOAT16:
+    case CellType::INT8:
+        abort(); // storage only
     }
 }
 
@@ -86,6 +89,9 @@ DenseBinaryFormat::serialize(nbostream &stream, const DenseTensorView &tensor)
     case CellType::FLOAT:
         encodeCells<float>(stream, cells);
         break;
+    case CellType::BFLOAT16:
+    case CellType::INT8:
+        abort(); // storage only, decay before serializing
     }
 }
 
@@ -94,6 +94,9 @@ size_t encodeCells(nbostream &stream, const Tensor &tensor, CellType cell_type)
     case CellType::FLOAT:
         return encodeCells<float>(stream, tensor);
         break;
+    case CellType::BFLOAT16:
+    case CellType::INT8:
+        break; // storage only
     }
     return 0;
 }
@@ -126,6 +129,9 @@ void decodeCells(CellType cell_type, nbostream &stream, size_t dimensionsSize, s
     case CellType::FLOAT:
         decodeCells<float>(stream, dimensionsSize, cellsSize, builder);
         break;
+    case CellType::BFLOAT16:
+    case CellType::INT8:
+        abort(); // storage only
     }
 }
 
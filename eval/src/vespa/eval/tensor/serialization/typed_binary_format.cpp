@@ -39,6 +39,9 @@ uint32_t cell_type_to_encoding(CellType cell_type) {
         return DOUBLE_VALUE_TYPE;
     case CellType::FLOAT:
         return FLOAT_VALUE_TYPE;
+    case CellType::BFLOAT16:
+    case CellType::INT8:
+        break; // storage only
     }
     abort();
 }
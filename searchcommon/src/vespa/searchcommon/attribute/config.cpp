@@ -14,12 +14,16 @@ Config::Config() :
     _isFilter(false),
     _fastAccess(false),
     _mutable(false),
+    _paged(false),
+    _packed(false),
+    _maxDeltaRatio(0.0),
     _growStrategy(),
     _compactionStrategy(),
     _predicateParams(),
     _tensorType(vespalib::eval::ValueType::error_type()),
     _distance_metric(DistanceMetric::Euclidean),
-    _hnsw_index_params()
+    _hnsw_index_params(),
+    _ivf_pq_index_params()
 {
 }
 
@@ -33,12 +37,16 @@ Config::Config(BasicType bt, CollectionType ct, bool fastSearch_, bool huge_)
       _isFilter(false),
       _fastAccess(false),
       _mutable(false),
+      _paged(false),
+      _packed(false),
+      _maxDeltaRatio(0.0),
       _growStrategy(),
       _compactionStrategy(),
       _predicateParams(),
       _tensorType(vespalib::eval::ValueType::error_type()),
       _distance_metric(DistanceMetric::Euclidean),
-      _hnsw_index_params()
+      _hnsw_index_params(),
+      _ivf_pq_index_params()
 {
 }
 
@@ -60,13 +68,17 @@ Config::operator==(const Config &b) const
            _isFilter == b._isFilter &&
            _fastAccess == b._fastAccess &&
            _mutable == b._mutable &&
+           _paged == b._paged &&
+           _packed == b._packed &&
+           _maxDeltaRatio == b._maxDeltaRatio &&
            _growStrategy == b._growStrategy &&
            _compactionStrategy == b._compactionStrategy &&
            _predicateParams == b._predicateParams &&
            (_basicType.type() != BasicType::Type::TENSOR ||
             _tensorType == b._tensorType) &&
             _distance_metric == b._distance_metric &&
-            _hnsw_index_params == b._hnsw_index_params;
+            _hnsw_index_params == b._hnsw_index_params &&
+            _ivf_pq_index_params == b._ivf_pq_index_params;
 }
 
 }
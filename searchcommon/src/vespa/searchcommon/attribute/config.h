@@ -5,6 +5,7 @@
 #include "basictype.h"
 #include "collectiontype.h"
 #include "hnsw_index_params.h"
+#include "ivf_pq_index_params.h"
 #include "predicate_params.h"
 #include <vespa/searchcommon/common/compaction_strategy.h>
 #include <vespa/searchcommon/common/growstrategy.h>
@@ -38,6 +39,7 @@ public:
     vespalib::eval::ValueType tensorType() const { return _tensorType; }
     DistanceMetric distance_metric() const { return _distance_metric; }
     const std::optional<HnswIndexParams>& hnsw_index_params() const { return _hnsw_index_params; }
+    const std::optional<IvfPqIndexParams>& ivf_pq_index_params() const { return _ivf_pq_index_params; }
 
     /**
      * Check if attribute posting list can consist of a bitvector in
@@ -60,6 +62,28 @@ public:
      */
     bool fastAccess() const { return _fastAccess; }
 
+    /**
+     * Check if this attribute should be kept compressed on disk and paged
+     * into memory on demand, instead of being fully resident.
+     * Only used for single value integer attributes without fast-search.
+     */
+    bool paged() const { return _paged; }
+
+    /**
+     * Check if this attribute should keep its values bit packed in memory,
+     * using as few bits per value as the range of stored values allows.
+     * Only used for single value integer attributes without fast-search.
+     */
+    bool packed() const { return _packed; }
+
+    /**
+     * Max fraction of documents changed since the last full save for which
+     * a save only records the changed documents, relative to the last full
+     * save. 0.0 disables delta saves.
+     * Only used for single value numeric attributes without fast-search.
+     */
+    double maxDeltaRatio() const { return _maxDeltaRatio; }
+
     const GrowStrategy & getGrowStrategy() const { return _growStrategy; }
     const CompactionStrategy &getCompactionStrategy() const { return _compactionStrategy; }
     Config & setHuge(bool v)                         { _huge = v; return *this;}
@@ -82,6 +106,15 @@ public:
         _hnsw_index_params.reset();
         return *this;
     }
+    Config& set_ivf_pq_index_params(const IvfPqIndexParams& params) {
+        assert(_distance_metric == params.distance_metric());
+        _ivf_pq_index_params = params;
+        return *this;
+    }
+    Config& clear_ivf_pq_index_params() {
+        _ivf_pq_index_params.reset();
+        return *this;
+    }
 
     /**
      * Enable attribute posting list to consist of a bitvector in
@@ -110,6 +143,9 @@ public:
 
     Config & setMutable(bool isMutable) { _mutable = isMutable; return *this; }
     Config & setFastAccess(bool v) { _fastAccess = v; return *this; }
+    Config & setPaged(bool v) { _paged = v; return *this; }
+    Config & setPacked(bool v) { _packed = v; return *this; }
+    Config & setMaxDeltaRatio(double v) { _maxDeltaRatio = v; return *this; }
     Config & setGrowStrategy(const GrowStrategy &gs) { _growStrategy = gs; return *this; }
     Config &setCompactionStrategy(const CompactionStrategy &compactionStrategy) { _compactionStrategy = compactionStrategy; return *this; }
     bool operator!=(const Config &b) const { return !(operator==(b)); }
@@ -125,12 +161,16 @@ private:
     bool           _isFilter;
     bool           _fastAccess;
     bool           _mutable;
+    bool           _paged;
+    bool           _packed;
+    double         _maxDeltaRatio;
     GrowStrategy   _growStrategy;
     CompactionStrategy _compactionStrategy;
     PredicateParams    _predicateParams;
     vespalib::eval::ValueType _tensorType;
     DistanceMetric _distance_metric;
     std::optional<HnswIndexParams> _hnsw_index_params;
+    std::optional<IvfPqIndexParams> _ivf_pq_index_params;
 };
 
 }
@@ -0,0 +1,41 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "distance_metric.h"
+#include <cstdint>
+
+namespace search::attribute {
+
+/**
+ * Configuration parameters for an ivf-pq index (inverted file of coarse centroids with product quantized codes)
+ * used together with a 1-dimensional indexed tensor for approximate nearest neighbor search.
+ */
+class IvfPqIndexParams {
+private:
+    uint32_t _num_centroids;
+    uint32_t _num_subquantizers;
+    // This is always the same as in the attribute config, and is duplicated here to simplify usage.
+    DistanceMetric _distance_metric;
+
+public:
+    IvfPqIndexParams(uint32_t num_centroids_in,
+                     uint32_t num_subquantizers_in,
+                     DistanceMetric distance_metric_in)
+            : _num_centroids(num_centroids_in),
+              _num_subquantizers(num_subquantizers_in),
+              _distance_metric(distance_metric_in)
+    {}
+
+    uint32_t num_centroids() const { return _num_centroids; }
+    uint32_t num_subquantizers() const { return _num_subquantizers; }
+    DistanceMetric distance_metric() const { return _distance_metric; }
+
+    bool operator==(const IvfPqIndexParams& rhs) const {
+        return (_num_centroids == rhs._num_centroids &&
+                _num_subquantizers == rhs._num_subquantizers &&
+                _distance_metric == rhs._distance_metric);
+    }
+};
+
+}
@@ -82,6 +82,56 @@ saveAttr(const vespalib::string &name, const Config &cfg, SerialNum serialNum, S
     writer->markValidSnapshot(serialNum);
 }
 
+Config get_int32_sv_delta(bool fastSearch)
+{
+    Config ret(int32_sv);
+    ret.setMaxDeltaRatio(0.5);
+    ret.setFastSearch(fastSearch);
+    return ret;
+}
+
+vespalib::string
+makeSnapshot(const vespalib::string &name, SerialNum serialNum)
+{
+    auto diskLayout = AttributeDiskLayout::create(test_dir);
+    auto writer = diskLayout->createAttributeDir(name)->getWriter();
+    writer->createInvalidSnapshot(serialNum);
+    auto snapshotdir = writer->getSnapshotDir(serialNum);
+    vespalib::mkdir(snapshotdir);
+    return snapshotdir + "/" + name;
+}
+
+void
+markValidSnapshot(const vespalib::string &name, SerialNum serialNum)
+{
+    auto diskLayout = AttributeDiskLayout::create(test_dir);
+    diskLayout->createAttributeDir(name)->getWriter()->markValidSnapshot(serialNum);
+}
+
+/*
+ * Saves a full snapshot at serialNum and a delta snapshot (only doc 2
+ * changed) at serialNum + 1.
+ */
+void
+saveDeltaAttr(const vespalib::string &name, SerialNum serialNum, SerialNum createSerialNum)
+{
+    auto av = search::AttributeFactory::createAttribute(makeSnapshot(name, serialNum), get_int32_sv_delta(false));
+    av->setCreateSerialNum(createSerialNum);
+    av->addReservedDoc();
+    av->addDocs(9);
+    auto &iav = dynamic_cast<search::IntegerAttribute &>(*av);
+    for (uint32_t docId = 1; docId < 10; ++docId) {
+        iav.update(docId, docId);
+    }
+    av->commit();
+    av->save();
+    markValidSnapshot(name, serialNum);
+    iav.update(2, 42);
+    av->commit();
+    av->save(makeSnapshot(name, serialNum + 1));
+    markValidSnapshot(name, serialNum + 1);
+}
+
 }
 
 struct Fixture
@@ -106,7 +156,7 @@ Fixture::~Fixture() = default;
 std::unique_ptr<AttributeInitializer>
 Fixture::createInitializer(const AttributeSpec &spec, SerialNum serialNum)
 {
-    return std::make_unique<AttributeInitializer>(_diskLayout->createAttributeDir(spec.getName()), "test.subdb", spec, serialNum, _factory);
+    return std::make_unique<AttributeInitializer>(_diskLayout->createAttributeDir(spec.getName()), "test.subdb", spec, serialNum, _factory, nullptr);
 }
 
 TEST("require that integer attribute can be initialized")
@@ -158,6 +208,24 @@ TEST("require that predicate attributes can be initialized")
     EXPECT_EQUAL(2u, av->getNumDocs());
 }
 
+TEST("require that predicate attributes can be initialized after restart")
+{
+    saveAttr("a", predicate, 10, 2);
+    Fixture f;
+    {
+        auto av = f.createInitializer({"a", predicate}, 5)->init().getAttribute();
+        EXPECT_EQUAL(2u, av->getNumDocs());
+        uint32_t docId;
+        av->addDoc(docId);
+        av->commit();
+        EXPECT_TRUE(av->save(makeSnapshot("a", 20)));
+        markValidSnapshot("a", 20);
+    }
+    auto av = f.createInitializer({"a", predicate}, 15)->init().getAttribute();
+    EXPECT_EQUAL(2u, av->getCreateSerialNum());
+    EXPECT_EQUAL(3u, av->getNumDocs());
+}
+
 TEST("require that predicate attributes will not be initialized with future-created attribute")
 {
     saveAttr("a", predicate, 10, 8);
@@ -203,6 +271,27 @@ TEST("require that tensor attributes will not be initialized with mismatching ty
     EXPECT_EQUAL(1u, av->getNumDocs());
 }
 
+TEST("require that delta saved integer attribute can be initialized")
+{
+    saveDeltaAttr("a", 10, 2);
+    Fixture f;
+    auto av = f.createInitializer({"a", get_int32_sv_delta(false)}, 5)->init().getAttribute();
+    EXPECT_EQUAL(2u, av->getCreateSerialNum());
+    EXPECT_EQUAL(10u, av->getNumDocs());
+    EXPECT_EQUAL(1, av->getInt(1));
+    EXPECT_EQUAL(42, av->getInt(2));
+    EXPECT_EQUAL(9, av->getInt(9));
+}
+
+TEST("require that delta saved integer attribute is not loaded with fast search")
+{
+    saveDeltaAttr("a", 10, 2);
+    Fixture f;
+    auto av = f.createInitializer({"a", get_int32_sv_delta(true)}, 5)->init().getAttribute();
+    EXPECT_EQUAL(5u, av->getCreateSerialNum());
+    EXPECT_EQUAL(1u, av->getNumDocs());
+}
+
 TEST("require that too old attribute is not loaded")
 {
     saveAttr("a", int32_sv, 3, 2);
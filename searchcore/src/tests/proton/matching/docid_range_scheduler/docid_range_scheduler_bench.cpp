@@ -82,6 +82,33 @@ struct SpikeWork : public Work {
     }
 };
 
+struct ClusteredWork : public Work {
+    std::vector<DocidRange> clusters;
+    size_t cost;
+    uint32_t seed;
+    ClusteredWork(size_t num_clusters, uint32_t cluster_size, size_t cost_in, uint32_t seed_in, uint32_t docid_limit)
+        : clusters(), cost(cost_in), seed(seed_in)
+    {
+        uint32_t state = seed;
+        for (size_t i = 0; i < num_clusters; ++i) {
+            state = (state * 1103515245u) + 12345u;
+            uint32_t begin = 1 + ((state >> 8) % (docid_limit - cluster_size));
+            clusters.emplace_back(begin, begin + cluster_size);
+        }
+    }
+    vespalib::string desc() const override {
+        return make_string("clustered(clusters:%zu,size:%zu,%zu,seed:%u)",
+                           clusters.size(), clusters.empty() ? 0 : clusters[0].size(), cost, seed);
+    }
+    void perform(uint32_t docid) const override {
+        for (const auto &cluster: clusters) {
+            if ((docid >= cluster.begin) && (docid < cluster.end)) {
+                (void) do_work(cost);
+            }
+        }
+    }
+};
+
 struct WorkList {
     std::vector<Work::UP> work_list;
     WorkList() : work_list() {
@@ -95,6 +122,11 @@ struct WorkList {
         work_list.push_back(std::make_unique<SpikeWork>(99001, 100001, 1000));
         work_list.push_back(std::make_unique<SpikeWork>(99901, 100001, 10000));
         work_list.push_back(std::make_unique<SpikeWork>(99991, 100001, 100000));
+        // skewed hit distributions where a few threads land on dense regions of the docid space
+        work_list.push_back(std::make_unique<ClusteredWork>(1, 1000, 1000, 1, 100001));
+        work_list.push_back(std::make_unique<ClusteredWork>(3, 300, 1000, 2, 100001));
+        work_list.push_back(std::make_unique<ClusteredWork>(10, 100, 1000, 3, 100001));
+        work_list.push_back(std::make_unique<ClusteredWork>(50, 10, 10000, 4, 100001));
     }
 };
 
@@ -138,6 +170,17 @@ struct AdaptiveSchedulerFactory : public SchedulerFactory {
     }
 };
 
+struct WorkStealingSchedulerFactory : public SchedulerFactory {
+    size_t num_threads;
+    size_t min_task;
+    WorkStealingSchedulerFactory(size_t num_threads_in, size_t min_task_in)
+        : num_threads(num_threads_in), min_task(min_task_in) {}
+    vespalib::string desc() const override { return make_string("work-stealing(threads:%zu,min_task:%zu)", num_threads, min_task); }
+    DocidRangeScheduler::UP create(uint32_t docid_limit) const override {
+        return std::make_unique<WorkStealingDocidRangeScheduler>(num_threads, min_task, docid_limit);
+    }
+};
+
 struct SchedulerList {
     std::vector<SchedulerFactory::UP> factory_list;
     SchedulerList(size_t num_threads) : factory_list() {
@@ -151,6 +194,10 @@ struct SchedulerList {
         factory_list.push_back(std::make_unique<AdaptiveSchedulerFactory>(num_threads, 100));
         factory_list.push_back(std::make_unique<AdaptiveSchedulerFactory>(num_threads, 10));
         factory_list.push_back(std::make_unique<AdaptiveSchedulerFactory>(num_threads, 1));
+        factory_list.push_back(std::make_unique<WorkStealingSchedulerFactory>(num_threads, 1000));
+        factory_list.push_back(std::make_unique<WorkStealingSchedulerFactory>(num_threads, 100));
+        factory_list.push_back(std::make_unique<WorkStealingSchedulerFactory>(num_threads, 10));
+        factory_list.push_back(std::make_unique<WorkStealingSchedulerFactory>(num_threads, 1));
     }
 };
 
@@ -305,4 +305,182 @@ TEST_MT_FF("require that the adaptive scheduler handles fewer documents than thr
 
 //-----------------------------------------------------------------------------
 
+TEST("require that the work stealing scheduler starts by taking half of an equal part of the docid space") {
+    WorkStealingDocidRangeScheduler scheduler(4, 1, 17);
+    EXPECT_EQUAL(scheduler.unassigned_size(), 16u);
+    TEST_DO(verify_range(scheduler.first_range(0), DocidRange(1, 3)));
+    TEST_DO(verify_range(scheduler.first_range(1), DocidRange(5, 7)));
+    TEST_DO(verify_range(scheduler.first_range(2), DocidRange(9, 11)));
+    TEST_DO(verify_range(scheduler.first_range(3), DocidRange(13, 15)));
+    EXPECT_EQUAL(scheduler.total_size(0), 2u);
+    EXPECT_EQUAL(scheduler.total_size(1), 2u);
+    EXPECT_EQUAL(scheduler.total_size(2), 2u);
+    EXPECT_EQUAL(scheduler.total_size(3), 2u);
+    EXPECT_EQUAL(scheduler.unassigned_size(), 8u);
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(3, 4)));
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(4, 5)));
+    EXPECT_EQUAL(scheduler.total_size(0), 4u);
+    EXPECT_EQUAL(scheduler.unassigned_size(), 6u);
+}
+
+TEST("require that the work stealing scheduler reports the full span to all threads") {
+    WorkStealingDocidRangeScheduler scheduler(3, 1, 16);
+    TEST_DO(verify_range(scheduler.total_span(0), DocidRange(1,16)));
+    TEST_DO(verify_range(scheduler.total_span(1), DocidRange(1,16)));
+    TEST_DO(verify_range(scheduler.total_span(2), DocidRange(1,16)));
+}
+
+TEST("require that idle threads steal the upper half of remaining work from other threads") {
+    WorkStealingDocidRangeScheduler scheduler(3, 1, 25);
+    TEST_DO(verify_range(scheduler.first_range(0), DocidRange(1, 5)));
+    TEST_DO(verify_range(scheduler.first_range(1), DocidRange(9, 13)));
+    TEST_DO(verify_range(scheduler.first_range(2), DocidRange(17, 21)));
+    TEST_DO(verify_range(scheduler.next_range(2), DocidRange(21, 23)));
+    TEST_DO(verify_range(scheduler.next_range(2), DocidRange(23, 24)));
+    TEST_DO(verify_range(scheduler.next_range(2), DocidRange(24, 25)));
+    // both thread 0 and 1 have 4 docids left, thread 0 is visited first
+    TEST_DO(verify_range(scheduler.next_range(2), DocidRange(7, 8)));
+    TEST_DO(verify_range(scheduler.next_range(2), DocidRange(8, 9)));
+    TEST_DO(verify_range(scheduler.next_range(2), DocidRange(15, 16)));
+    TEST_DO(verify_range(scheduler.next_range(2), DocidRange(16, 17)));
+    TEST_DO(verify_range(scheduler.next_range(1), DocidRange(13, 14)));
+    TEST_DO(verify_range(scheduler.next_range(1), DocidRange(14, 15)));
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(5, 6)));
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(6, 7)));
+    EXPECT_EQUAL(scheduler.total_size(0), 6u);
+    EXPECT_EQUAL(scheduler.total_size(1), 6u);
+    EXPECT_EQUAL(scheduler.total_size(2), 12u);
+    EXPECT_EQUAL(scheduler.unassigned_size(), 0u);
+}
+
+TEST("require that the work stealing scheduler only shares work when there is nothing left to steal") {
+    WorkStealingDocidRangeScheduler scheduler(2, 1, 9);
+    TEST_DO(verify_range(scheduler.first_range(0), DocidRange(1, 3)));
+    TEST_DO(verify_range(scheduler.first_range(1), DocidRange(5, 7)));
+    TEST_DO(verify_range(scheduler.share_range(1, DocidRange(5, 7)), DocidRange(5, 7)));
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(3, 4)));
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(4, 5)));
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(8, 9)));
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(7, 8)));
+    EXPECT_EQUAL(scheduler.unassigned_size(), 0u);
+    TEST_DO(verify_range(scheduler.share_range(1, DocidRange(6, 7)), DocidRange(6, 7)));
+    TEST_DO(verify_range(scheduler.share_range(1, DocidRange(5, 7)), DocidRange(5, 6)));
+    EXPECT_EQUAL(scheduler.unassigned_size(), 1u);
+    EXPECT_EQUAL(scheduler.total_size(1), 1u);
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(6, 7)));
+    EXPECT_EQUAL(scheduler.total_size(0), 7u);
+}
+
+TEST("require that the work stealing scheduler respects the minimal task size") {
+    WorkStealingDocidRangeScheduler scheduler(2, 3, 21);
+    TEST_DO(verify_range(scheduler.first_range(0), DocidRange(1, 6)));
+    TEST_DO(verify_range(scheduler.first_range(1), DocidRange(11, 16)));
+    // a range with size 5 will not be split
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(6, 11)));
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(16, 21)));
+    TEST_DO(verify_range(scheduler.share_range(1, DocidRange(11, 16)), DocidRange(11, 16)));
+    // a range with size 6 will be split
+    TEST_DO(verify_range(scheduler.share_range(1, DocidRange(10, 16)), DocidRange(10, 13)));
+}
+
+TEST_MT_FF("require that the work stealing scheduler terminates when all workers request more work",
+           4, WorkStealingDocidRangeScheduler(num_threads, 1, 16), TimeBomb(60))
+{
+    (void) f1.first_range(thread_id);
+    for (DocidRange range = f1.next_range(thread_id); !range.empty(); range = f1.next_range(thread_id)) {
+    }
+    TEST_BARRIER();
+    EXPECT_EQUAL(f1.total_size(0) + f1.total_size(1) + f1.total_size(2) + f1.total_size(3), 15u);
+    EXPECT_EQUAL(f1.unassigned_size(), 0u);
+}
+
+TEST_MT_FF("require that idle work stealing threads wait for work to be shared",
+           2, WorkStealingDocidRangeScheduler(num_threads, 1, 9), TimeBomb(60))
+{
+    if (thread_id == 0) {
+        TEST_DO(verify_range(f1.first_range(0), DocidRange(1, 3)));
+        TEST_BARRIER();
+        TEST_BARRIER();
+        // thread 1 has taken the last of our work; wait until it is idle again
+        wait_idle(f1, 1);
+        TEST_DO(verify_range(f1.share_range(0, DocidRange(1, 3)), DocidRange(1, 2)));
+        TEST_BARRIER();
+    } else {
+        TEST_BARRIER();
+        TEST_DO(verify_range(f1.first_range(1), DocidRange(5, 7)));
+        TEST_DO(verify_range(f1.next_range(1), DocidRange(7, 8)));
+        TEST_DO(verify_range(f1.next_range(1), DocidRange(8, 9)));
+        TEST_DO(verify_range(f1.next_range(1), DocidRange(4, 5)));
+        TEST_DO(verify_range(f1.next_range(1), DocidRange(3, 4)));
+        TEST_BARRIER();
+        TEST_DO(verify_range(f1.next_range(1), DocidRange(2, 3)));
+        TEST_BARRIER();
+    }
+    EXPECT_TRUE(f1.next_range(thread_id).empty());
+    TEST_BARRIER();
+    EXPECT_EQUAL(f1.total_size(0), 1u);
+    EXPECT_EQUAL(f1.total_size(1), 7u);
+}
+
+struct DocidCounts {
+    std::vector<std::atomic<uint32_t>> counts;
+    DocidCounts(size_t docid_limit) : counts(docid_limit) {}
+};
+
+TEST_MT_FFF("require that the work stealing scheduler assigns each docid exactly once when threads share work",
+            4, WorkStealingDocidRangeScheduler(num_threads, 1, 5000), DocidCounts(5000), TimeBomb(60))
+{
+    IdleObserver observer = f1.make_idle_observer();
+    for (DocidRange range = f1.first_range(thread_id); !range.empty(); range = f1.next_range(thread_id)) {
+        for (uint32_t docid = range.begin; docid < range.end; ++docid) {
+            f2.counts[docid]++;
+            if ((thread_id == 0) && (docid < 100)) {
+                // thread 0 lands on a dense region of the docid space
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            if ((observer.get() > 0) && (docid + 1 < range.end)) {
+                range.end = f1.share_range(thread_id, DocidRange(docid + 1, range.end)).end;
+            }
+        }
+    }
+    TEST_BARRIER();
+    if (thread_id == 0) {
+        size_t total = 0;
+        for (size_t i = 0; i < num_threads; ++i) {
+            total += f1.total_size(i);
+        }
+        EXPECT_EQUAL(total, 4999u);
+        EXPECT_EQUAL(f2.counts[0].load(), 0u);
+        for (uint32_t docid = 1; docid < 5000; ++docid) {
+            EXPECT_EQUAL(f2.counts[docid].load(), 1u);
+        }
+    }
+}
+
+TEST_MT_FF("require that the work stealing scheduler handles no documents",
+           4, WorkStealingDocidRangeScheduler(num_threads, 1, 1), TimeBomb(60))
+{
+    for (DocidRange docid_range = f1.first_range(thread_id);
+         !docid_range.empty();
+         docid_range = f1.next_range(thread_id))
+    {
+        TEST_ERROR("no threads should get any work");
+    }
+}
+
+TEST_MT_FF("require that the work stealing scheduler handles fewer documents than threads",
+           4, WorkStealingDocidRangeScheduler(num_threads, 1, 3), TimeBomb(60))
+{
+    for (DocidRange docid_range = f1.first_range(thread_id);
+         !docid_range.empty();
+         docid_range = f1.next_range(thread_id))
+    {
+        EXPECT_TRUE(docid_range.size() == 1);
+    }
+    TEST_BARRIER();
+    EXPECT_EQUAL(f1.total_size(0) + f1.total_size(1) + f1.total_size(2) + f1.total_size(3), 2u);
+}
+
+//-----------------------------------------------------------------------------
+
 TEST_MAIN() { TEST_RUN_ALL(); }
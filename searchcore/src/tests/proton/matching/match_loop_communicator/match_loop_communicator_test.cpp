@@ -13,6 +13,8 @@ using RangePair = MatchLoopCommunicator::RangePair;
 using Matches = MatchLoopCommunicator::Matches;
 using Hit = MatchLoopCommunicator::Hit;
 using Hits = MatchLoopCommunicator::Hits;
+using TaggedHit = MatchLoopCommunicator::TaggedHit;
+using TaggedHits = MatchLoopCommunicator::TaggedHits;
 using search::queryeval::SortedHitSequence;
 
 Hits makeScores(size_t id) {
@@ -26,23 +28,32 @@ Hits makeScores(size_t id) {
     return Box<Hit>();
 }
 
-Hits selectBest(MatchLoopCommunicator &com, const Hits &hits) {
+TaggedHits get_second_phase_work(MatchLoopCommunicator &com, const Hits &hits, size_t thread_id) {
     std::vector<uint32_t> refs;
     for (size_t i = 0; i < hits.size(); ++i) {
         refs.push_back(i);
     }
-    return com.selectBest(SortedHitSequence(&hits[0], &refs[0], refs.size()));
+    return com.get_second_phase_work(SortedHitSequence(&hits[0], &refs[0], refs.size()), thread_id);
 }
 
-RangePair makeRanges(size_t id) {
-    switch (id) {
-    case 0: return std::make_pair(Range(5, 5), Range(7, 7));
-    case 1: return std::make_pair(Range(2, 2), Range(8, 8));
-    case 2: return std::make_pair(Range(3, 3), Range(6, 6));
-    case 3: return std::make_pair(Range(1, 1), Range(5, 5));
-    case 4: return std::make_pair(Range(4, 4), Range(9, 9));
+// simulate second phase ranking by multiplying the first phase score with a factor
+std::pair<Hits,RangePair> complete_second_phase(MatchLoopCommunicator &com, TaggedHits my_work, size_t thread_id,
+                                                double factor = 1.0)
+{
+    for (auto &hit: my_work) {
+        hit.first.second *= factor;
     }
-    return std::make_pair(Range(-50, -60), Range(60, 50));
+    return com.complete_second_phase(std::move(my_work), thread_id);
+}
+
+Hits selectBest(MatchLoopCommunicator &com, const Hits &hits, size_t thread_id) {
+    auto my_work = get_second_phase_work(com, hits, thread_id);
+    return complete_second_phase(com, std::move(my_work), thread_id).first;
+}
+
+RangePair rangeCover(MatchLoopCommunicator &com, const Hits &hits, size_t thread_id, double factor) {
+    auto my_work = get_second_phase_work(com, hits, thread_id);
+    return complete_second_phase(com, std::move(my_work), thread_id, factor).second;
 }
 
 void equal(size_t count, const Hits & a, const Hits & b) {
@@ -66,102 +77,119 @@ struct EveryOdd : public search::queryeval::IDiversifier {
 };
 
 TEST_F("require that selectBest gives appropriate results for single thread", MatchLoopCommunicator(num_threads, 3)) {
-    TEST_DO(equal(2u, make_box<Hit>({1, 5}, {2, 4}), selectBest(f1, make_box<Hit>({1, 5}, {2, 4}))));
-    TEST_DO(equal(3u, make_box<Hit>({1, 5}, {2, 4}, {3, 3}), selectBest(f1, make_box<Hit>({1, 5}, {2, 4}, {3, 3}))));
-    TEST_DO(equal(3u, make_box<Hit>({1, 5}, {2, 4}, {3, 3}), selectBest(f1, make_box<Hit>({1, 5}, {2, 4}, {3, 3}, {4, 2}))));
+    TEST_DO(equal(2u, make_box<Hit>({1, 5}, {2, 4}), selectBest(f1, make_box<Hit>({1, 5}, {2, 4}), 0)));
+    TEST_DO(equal(3u, make_box<Hit>({1, 5}, {2, 4}, {3, 3}), selectBest(f1, make_box<Hit>({1, 5}, {2, 4}, {3, 3}), 0)));
+    TEST_DO(equal(3u, make_box<Hit>({1, 5}, {2, 4}, {3, 3}), selectBest(f1, make_box<Hit>({1, 5}, {2, 4}, {3, 3}, {4, 2}), 0)));
 }
 
 TEST_F("require that selectBest gives appropriate results for single thread with filter",
        MatchLoopCommunicator(num_threads, 3, std::make_unique<EveryOdd>()))
 {
-    TEST_DO(equal(1u, make_box<Hit>({1, 5}), selectBest(f1, make_box<Hit>({1, 5}, {2, 4}))));
-    TEST_DO(equal(2u, make_box<Hit>({1, 5}, {3, 3}), selectBest(f1, make_box<Hit>({1, 5}, {2, 4}, {3, 3}))));
-    TEST_DO(equal(3u, make_box<Hit>({1, 5}, {3, 3}, {5, 1}), selectBest(f1, make_box<Hit>({1, 5}, {2, 4}, {3, 3}, {4, 2}, {5, 1}, {6, 0}))));
+    TEST_DO(equal(1u, make_box<Hit>({1, 5}), selectBest(f1, make_box<Hit>({1, 5}, {2, 4}), 0)));
+    TEST_DO(equal(2u, make_box<Hit>({1, 5}, {3, 3}), selectBest(f1, make_box<Hit>({1, 5}, {2, 4}, {3, 3}), 0)));
+    TEST_DO(equal(3u, make_box<Hit>({1, 5}, {3, 3}, {5, 1}), selectBest(f1, make_box<Hit>({1, 5}, {2, 4}, {3, 3}, {4, 2}, {5, 1}, {6, 0}), 0)));
 }
 
 TEST_MT_F("require that selectBest works with no hits", 10, MatchLoopCommunicator(num_threads, 10)) {
-    EXPECT_TRUE(selectBest(f1, Box<Hit>()).empty());
+    EXPECT_TRUE(selectBest(f1, Box<Hit>(), thread_id).empty());
 }
 
 TEST_MT_F("require that selectBest works with too many hits from all threads", 5, MatchLoopCommunicator(num_threads, 13)) {
     if (thread_id < 3) {
-        TEST_DO(equal(3u, makeScores(thread_id), selectBest(f1, makeScores(thread_id))));
+        TEST_DO(equal(3u, makeScores(thread_id), selectBest(f1, makeScores(thread_id), thread_id)));
     } else {
-        TEST_DO(equal(2u, makeScores(thread_id), selectBest(f1, makeScores(thread_id))));
+        TEST_DO(equal(2u, makeScores(thread_id), selectBest(f1, makeScores(thread_id), thread_id)));
     }
 }
 
 TEST_MT_F("require that selectBest works with some exhausted threads", 5, MatchLoopCommunicator(num_threads, 22)) {
     if (thread_id < 2) {
-        TEST_DO(equal(5u, makeScores(thread_id), selectBest(f1, makeScores(thread_id))));
+        TEST_DO(equal(5u, makeScores(thread_id), selectBest(f1, makeScores(thread_id), thread_id)));
     } else {
-        TEST_DO(equal(4u, makeScores(thread_id), selectBest(f1, makeScores(thread_id))));
+        TEST_DO(equal(4u, makeScores(thread_id), selectBest(f1, makeScores(thread_id), thread_id)));
     }
 }
 
 TEST_MT_F("require that selectBest can select all hits from all threads", 5, MatchLoopCommunicator(num_threads, 100)) {
-    EXPECT_EQUAL(5u, selectBest(f1, makeScores(thread_id)).size());
+    EXPECT_EQUAL(5u, selectBest(f1, makeScores(thread_id), thread_id).size());
 }
 
 TEST_MT_F("require that selectBest works with some empty threads", 10, MatchLoopCommunicator(num_threads, 7)) {
     if (thread_id < 2) {
-        TEST_DO(equal(2u, makeScores(thread_id), selectBest(f1, makeScores(thread_id))));
+        TEST_DO(equal(2u, makeScores(thread_id), selectBest(f1, makeScores(thread_id), thread_id)));
     } else if (thread_id < 5) {
-        TEST_DO(equal(1u, makeScores(thread_id), selectBest(f1, makeScores(thread_id))));
+        TEST_DO(equal(1u, makeScores(thread_id), selectBest(f1, makeScores(thread_id), thread_id)));
     } else {
-        EXPECT_TRUE(selectBest(f1, makeScores(thread_id)).empty());
+        EXPECT_TRUE(selectBest(f1, makeScores(thread_id), thread_id).empty());
     }
 }
 
-TEST_F("require that rangeCover is identity function for single thread", MatchLoopCommunicator(num_threads, 5)) {
-    RangePair res = f1.rangeCover(std::make_pair(Range(2, 4), Range(3, 5)));
-    TEST_DO(equal_range(Range(2, 4), res.first));
-    TEST_DO(equal_range(Range(3, 5), res.second));
-}
-
-TEST_MT_F("require that rangeCover can mix ranges from multiple threads", 5, MatchLoopCommunicator(num_threads, 5)) {
-    RangePair res = f1.rangeCover(makeRanges(thread_id));
-    TEST_DO(equal_range(Range(1, 5), res.first));
-    TEST_DO(equal_range(Range(5, 9), res.second));
+TEST_F("require that ranges are calculated from the selected hits for single thread", MatchLoopCommunicator(num_threads, 3)) {
+    RangePair res = rangeCover(f1, make_box<Hit>({1, 5}, {2, 4}, {3, 3}, {4, 2}), 0, 10.0);
+    TEST_DO(equal_range(Range(3, 5), res.first));
+    TEST_DO(equal_range(Range(30, 50), res.second));
 }
 
-TEST_MT_F("require that invalid ranges are ignored", 10, MatchLoopCommunicator(num_threads, 5)) {
-    RangePair res = f1.rangeCover(makeRanges(thread_id));
-    TEST_DO(equal_range(Range(1, 5), res.first));
-    TEST_DO(equal_range(Range(5, 9), res.second));
+TEST_MT_F("require that ranges are calculated from the selected hits of all threads", 5, MatchLoopCommunicator(num_threads, 13)) {
+    RangePair res = rangeCover(f1, makeScores(thread_id), thread_id, 2.0);
+    TEST_DO(equal_range(Range(3.2, 5.4), res.first));
+    TEST_DO(equal_range(Range(6.4, 10.8), res.second));
 }
 
-TEST_MT_F("require that only invalid ranges produce default invalid range", 3, MatchLoopCommunicator(num_threads, 5)) {
-    RangePair res = f1.rangeCover(makeRanges(10));
+TEST_MT_F("require that no selected hits produce default invalid ranges", 3, MatchLoopCommunicator(num_threads, 5)) {
+    RangePair res = rangeCover(f1, Box<Hit>(), thread_id, 2.0);
     Range expect;
     TEST_DO(equal_range(expect, res.first));
     TEST_DO(equal_range(expect, res.second));
 }
 
+TEST_MT_F("require that second phase work is evenly distributed among search threads", 5, MatchLoopCommunicator(num_threads, 13)) {
+    Hits my_hits;
+    if (thread_id == 0) {
+        for (uint32_t i = 0; i < 20; ++i) {
+            my_hits.emplace_back(i + 1, 100.0 - i);
+        }
+    }
+    auto my_work = get_second_phase_work(f1, my_hits, thread_id);
+    EXPECT_EQUAL((thread_id < 3) ? 3u : 2u, my_work.size());
+    for (const auto &hit: my_work) {
+        EXPECT_EQUAL(0u, hit.second);
+        EXPECT_EQUAL(100.0 - (hit.first.first - 1), hit.first.second);
+    }
+    auto [kept_hits, ranges] = complete_second_phase(f1, std::move(my_work), thread_id, 2.0);
+    if (thread_id == 0) {
+        ASSERT_EQUAL(13u, kept_hits.size());
+        for (uint32_t i = 0; i < 13; ++i) {
+            EXPECT_EQUAL(i + 1, kept_hits[i].first);
+            EXPECT_EQUAL(2.0 * (100.0 - i), kept_hits[i].second);
+        }
+    } else {
+        EXPECT_TRUE(kept_hits.empty());
+    }
+    TEST_DO(equal_range(Range(88, 100), ranges.first));
+    TEST_DO(equal_range(Range(176, 200), ranges.second));
+}
+
+TEST_MT_F("require that re-ranked hits are returned to the thread that produced them", 5, MatchLoopCommunicator(num_threads, 22)) {
+    auto my_work = get_second_phase_work(f1, makeScores(thread_id), thread_id);
+    EXPECT_EQUAL((thread_id < 2) ? 5u : 4u, my_work.size());
+    auto kept_hits = complete_second_phase(f1, std::move(my_work), thread_id, 3.0).first;
+    Hits expect = makeScores(thread_id);
+    for (auto &hit: expect) {
+        hit.second *= 3.0;
+    }
+    TEST_DO(equal((thread_id < 2) ? 5u : 4u, expect, kept_hits));
+}
+
 TEST_F("require that hits dropped due to lack of diversity affects range cover result",
        MatchLoopCommunicator(num_threads, 3, std::make_unique<EveryOdd>()))
 {
-    TEST_DO(equal(3u, make_box<Hit>({1, 5}, {3, 3}, {5, 1}), selectBest(f1, make_box<Hit>({1, 5}, {2, 4}, {3, 3}, {4, 2}, {5, 1}))));
+    auto my_work = get_second_phase_work(f1, make_box<Hit>({1, 5}, {2, 4}, {3, 3}, {4, 2}, {5, 1}), 0);
+    auto [kept_hits, ranges] = complete_second_phase(f1, std::move(my_work), 0, 10.0);
+    TEST_DO(equal(3u, make_box<Hit>({1, 50}, {3, 30}, {5, 10}), kept_hits));
     // best dropped: 4
-    std::vector<RangePair> input = {
-        std::make_pair(Range(), Range()),
-        std::make_pair(Range(3, 5), Range(1, 10)),
-        std::make_pair(Range(5, 10), Range(1, 10)),
-        std::make_pair(Range(1, 3), Range(1, 10))
-    };
-    std::vector<RangePair> expect = {
-        std::make_pair(Range(), Range()),
-        std::make_pair(Range(4, 5), Range(1, 10)),
-        std::make_pair(Range(5, 10), Range(1, 10)),
-        std::make_pair(Range(4, 4), Range(1, 10))
-    };
-    ASSERT_EQUAL(input.size(), expect.size());
-    for (size_t i = 0; i < input.size(); ++i) {
-        auto output = f1.rangeCover(input[i]);
-        TEST_STATE(vespalib::make_string("case: %zu", i).c_str());
-        TEST_DO(equal_range(expect[i].first, output.first));
-        TEST_DO(equal_range(expect[i].second, output.second));
-    }
+    TEST_DO(equal_range(Range(4, 5), ranges.first));
+    TEST_DO(equal_range(Range(10, 50), ranges.second));
 }
 
 TEST_MT_F("require that count_matches will count hits and docs across threads", 4, MatchLoopCommunicator(num_threads, 5)) {
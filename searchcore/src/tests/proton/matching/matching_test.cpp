@@ -56,6 +56,7 @@ using search::attribute::test::MockAttributeContext;
 using search::index::schema::DataType;
 using storage::spi::Timestamp;
 using search::fef::indexproperties::hitcollector::HeapSize;
+using search::fef::indexproperties::matching::SecondPhaseRankBatchSize;
 
 using vespalib::nbostream;
 using vespalib::eval::TensorSpec;
@@ -225,9 +226,9 @@ struct MyWorld {
         searchContext.attr().addResult(attribute, term, result);
     }
 
-    void setupSecondPhaseRanking() {
+    void setupSecondPhaseRanking(const vespalib::string &second_phase = "attribute(a2)") {
         Properties cfg;
-        cfg.add(indexproperties::rank::SecondPhase::NAME, "attribute(a2)");
+        cfg.add(indexproperties::rank::SecondPhase::NAME, second_phase);
         cfg.add(indexproperties::hitcollector::HeapSize::NAME, "3");
         config.import(cfg);
     }
@@ -254,6 +255,15 @@ struct MyWorld {
                                                                  .doc(600).doc(700).doc(800).doc(900));
     }
 
+    // like basicResults, but the term occurs at position (10 - docid/100) in each document
+    void positionResults() {
+        FakeResult result;
+        for (uint32_t docid = 100; docid < NUM_DOCS; docid += 100) {
+            result.doc(docid).pos(10 - docid/100);
+        }
+        searchContext.idx(0).getFake().addResult("f1", "spread", result);
+    }
+
     static void setStackDump(Request &request, const vespalib::string &stack_dump) {
         request.stackDump.assign(stack_dump.data(), stack_dump.data() + stack_dump.size());
     }
@@ -440,6 +450,21 @@ TEST("require that matching is performed (multi-threaded)") {
     }
 }
 
+TEST("require that matching is performed with the work stealing scheduler (multi-threaded)") {
+    for (size_t threads = 1; threads <= 16; ++threads) {
+        MyWorld world;
+        world.basicSetup();
+        world.basicResults();
+        SearchRequest::SP request = world.createSimpleRequest("f1", "spread");
+        request->propertiesMap.lookupCreate(MapNames::RANK).add("vespa.matching.work_stealing", "true");
+        SearchReply::UP reply = world.performSearch(request, threads);
+        EXPECT_EQUAL(9u, world.matchingStats.docsMatched());
+        ASSERT_TRUE(reply->hits.size() == 9u);
+        EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::900").getGlobalId(),  reply->hits[0].gid);
+        EXPECT_EQUAL(900.0, reply->hits[0].metric);
+    }
+}
+
 TEST("require that matching also returns hits when only bitvector is used (multi-threaded)") {
     for (size_t threads = 1; threads <= 16; ++threads) {
         MyWorld world;
@@ -502,6 +527,69 @@ TEST("require that re-ranking is performed (multi-threaded)") {
     }
 }
 
+TEST("require that re-ranking in batches gives the same result as re-ranking one document at a time") {
+    // a batch size of 2 splits the 3 re-ranked hits into a full and a partial batch
+    for (vespalib::string batch_size: {"0", "1", "2", "64"}) {
+        TEST_STATE(batch_size.c_str());
+        MyWorld world;
+        world.basicSetup();
+        world.setupSecondPhaseRanking();
+        world.basicResults();
+        SearchRequest::SP request = world.createSimpleRequest("f1", "spread");
+        auto & rankProperies = request->propertiesMap.lookupCreate(MapNames::RANK);
+        rankProperies.add(SecondPhaseRankBatchSize::NAME, batch_size);
+        SearchReply::UP reply = world.performSearch(request, 1);
+        EXPECT_EQUAL(3u, world.matchingStats.docsReRanked());
+        ASSERT_TRUE(reply->hits.size() == 9u);
+        EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::900").getGlobalId(),  reply->hits[0].gid);
+        EXPECT_EQUAL(1800.0, reply->hits[0].metric);
+        EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::800").getGlobalId(),  reply->hits[1].gid);
+        EXPECT_EQUAL(1600.0, reply->hits[1].metric);
+        EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::700").getGlobalId(),  reply->hits[2].gid);
+        EXPECT_EQUAL(1400.0, reply->hits[2].metric);
+        EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::600").getGlobalId(),  reply->hits[3].gid);
+        EXPECT_EQUAL(600.0, reply->hits[3].metric);
+    }
+}
+
+TEST("require that re-ranking by other threads gives the same result as re-ranking in a single thread") {
+    // the best hits are all found by the thread matching the highest docids,
+    // but re-ranked by the threads given second phase work. Both rank phases
+    // use the same match data, so the search iterator from the first phase
+    // is used to unpack documents outside the docid range of the thread.
+    std::vector<std::pair<document::GlobalId, search::HitRank>> expect;
+    for (size_t threads = 1; threads <= 16; ++threads) {
+        MyWorld world;
+        world.basicSetup();
+        world.set_property(indexproperties::rank::FirstPhase::NAME,
+                           "rankingExpression(\"attribute(a1)+fieldTermMatch(f1,0).firstPosition\")");
+        world.setupSecondPhaseRanking("fieldTermMatch(f1,0).firstPosition");
+        world.positionResults();
+        SearchRequest::SP request = world.createSimpleRequest("f1", "spread");
+        SearchReply::UP reply = world.performSearch(request, threads);
+        EXPECT_EQUAL(9u, world.matchingStats.docsMatched());
+        EXPECT_EQUAL(3u, world.matchingStats.docsReRanked());
+        ASSERT_EQUAL(9u, reply->hits.size());
+        if (threads == 1) {
+            EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::700").getGlobalId(),  reply->hits[0].gid);
+            EXPECT_EQUAL(3.0, reply->hits[0].metric);
+            EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::800").getGlobalId(),  reply->hits[1].gid);
+            EXPECT_EQUAL(2.0, reply->hits[1].metric);
+            EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::900").getGlobalId(),  reply->hits[2].gid);
+            EXPECT_EQUAL(1.0, reply->hits[2].metric);
+            for (const auto &hit: reply->hits) {
+                expect.emplace_back(hit.gid, hit.metric);
+            }
+        } else {
+            TEST_STATE(vespalib::make_string("threads: %zu", threads).c_str());
+            for (size_t i = 0; i < expect.size(); ++i) {
+                EXPECT_EQUAL(expect[i].first, reply->hits[i].gid);
+                EXPECT_EQUAL(expect[i].second, reply->hits[i].metric);
+            }
+        }
+    }
+}
+
 TEST("require that re-ranking is not diverse when not requested to be.") {
     MyWorld world;
     world.basicSetup();
@@ -554,31 +642,35 @@ TEST("require that re-ranking is diverse with diversity = 1/1") {
 }
 
 TEST("require that re-ranking is diverse with diversity = 1/10") {
-    MyWorld world;
-    world.basicSetup();
-    world.setupSecondPhaseRanking();
-    world.basicResults();
-    SearchRequest::SP request = world.createSimpleRequest("f1", "spread");
-    auto & rankProperies = request->propertiesMap.lookupCreate(MapNames::RANK);
-    rankProperies.add(DiversityAttribute::NAME, "a3")
-                 .add(DiversityMinGroups::NAME, "3")
-                 .add(DiversityCutoffStrategy::NAME, "strict");
-    SearchReply::UP reply = world.performSearch(request, 1);
-    EXPECT_EQUAL(9u, world.matchingStats.docsMatched());
-    EXPECT_EQUAL(9u, world.matchingStats.docsRanked());
-    EXPECT_EQUAL(1u, world.matchingStats.docsReRanked());
-    ASSERT_TRUE(reply->hits.size() == 9u);
-    EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::900").getGlobalId(),  reply->hits[0].gid);
-    EXPECT_EQUAL(1800.0, reply->hits[0].metric);
-    //TODO This is of course incorrect until the selectBest method sees everything.
-    EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::800").getGlobalId(),  reply->hits[1].gid);
-    EXPECT_EQUAL(800.0, reply->hits[1].metric);
-    EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::700").getGlobalId(),  reply->hits[2].gid);
-    EXPECT_EQUAL(700.0, reply->hits[2].metric);
-    EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::600").getGlobalId(),  reply->hits[3].gid);
-    EXPECT_EQUAL(600.0, reply->hits[3].metric);
-    EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::500").getGlobalId(),  reply->hits[4].gid);
-    EXPECT_EQUAL(500.0, reply->hits[4].metric);
+    // all hits are in the same a3 group, so only the single best hit is re-ranked,
+    // no matter how the hits are spread across the match threads
+    for (size_t threads = 1; threads <= 16; ++threads) {
+        TEST_STATE(vespalib::make_string("threads: %zu", threads).c_str());
+        MyWorld world;
+        world.basicSetup();
+        world.setupSecondPhaseRanking();
+        world.basicResults();
+        SearchRequest::SP request = world.createSimpleRequest("f1", "spread");
+        auto & rankProperies = request->propertiesMap.lookupCreate(MapNames::RANK);
+        rankProperies.add(DiversityAttribute::NAME, "a3")
+                     .add(DiversityMinGroups::NAME, "3")
+                     .add(DiversityCutoffStrategy::NAME, "strict");
+        SearchReply::UP reply = world.performSearch(request, threads);
+        EXPECT_EQUAL(9u, world.matchingStats.docsMatched());
+        EXPECT_EQUAL(9u, world.matchingStats.docsRanked());
+        EXPECT_EQUAL(1u, world.matchingStats.docsReRanked());
+        ASSERT_TRUE(reply->hits.size() == 9u);
+        EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::900").getGlobalId(),  reply->hits[0].gid);
+        EXPECT_EQUAL(1800.0, reply->hits[0].metric);
+        EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::800").getGlobalId(),  reply->hits[1].gid);
+        EXPECT_EQUAL(800.0, reply->hits[1].metric);
+        EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::700").getGlobalId(),  reply->hits[2].gid);
+        EXPECT_EQUAL(700.0, reply->hits[2].metric);
+        EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::600").getGlobalId(),  reply->hits[3].gid);
+        EXPECT_EQUAL(600.0, reply->hits[3].metric);
+        EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::500").getGlobalId(),  reply->hits[4].gid);
+        EXPECT_EQUAL(500.0, reply->hits[4].metric);
+    }
 }
 
 TEST("require that sortspec can be used (multi-threaded)") {
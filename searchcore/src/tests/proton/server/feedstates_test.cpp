@@ -59,6 +59,21 @@ struct InstantExecutor : vespalib::Executor {
     }
 };
 
+struct QueuedExecutor : vespalib::Executor {
+    std::vector<Task::UP> tasks;
+    Task::UP execute(Task::UP task) override {
+        tasks.push_back(std::move(task));
+        return Task::UP();
+    }
+    void runAll() {
+        std::vector<Task::UP> toRun;
+        toRun.swap(tasks);
+        for (auto &task : toRun) {
+            task->run();
+        }
+    }
+};
+
 struct Fixture
 {
     MyFeedView feed_view1;
@@ -68,7 +83,9 @@ struct Fixture
     MemoryConfigStore config_store;
     BucketDBOwner _bucketDB;
     bucketdb::BucketDBHandler _bucketDBHandler;
+    QueuedExecutor decode_executor;
     ReplayTransactionLogState state;
+    ReplayTransactionLogState decode_ahead_state;
 
     Fixture();
     ~Fixture();
@@ -82,7 +99,10 @@ Fixture::Fixture()
       config_store(),
       _bucketDB(),
       _bucketDBHandler(_bucketDB),
-      state("doctypename", feed_view_ptr, _bucketDBHandler, replay_config, config_store)
+      decode_executor(),
+      state("doctypename", feed_view_ptr, _bucketDBHandler, replay_config, config_store),
+      decode_ahead_state("doctypename", feed_view_ptr, _bucketDBHandler, replay_config, config_store,
+                         decode_executor, 4)
 {
 }
 Fixture::~Fixture() = default;
@@ -127,6 +147,38 @@ TEST_F("require that active FeedView can change during replay", Fixture)
     EXPECT_EQUAL(1, f.feed_view2.remove_handled);
 }
 
+TEST_F("require that packets are decoded ahead of replay", Fixture)
+{
+    RemoveOperationContext opCtx(10);
+    TlsReplayProgress progress("test", 5, 15);
+    auto wrap = std::make_shared<PacketWrapper>(*opCtx.packet, &progress);
+    QueuedExecutor executor;
+
+    f.decode_ahead_state.receive(wrap, executor);
+    EXPECT_EQUAL(0u, wrap->gate.getCount());
+    EXPECT_EQUAL(1u, f.decode_executor.tasks.size());
+    EXPECT_EQUAL(1u, executor.tasks.size());
+    f.decode_executor.runAll();
+    EXPECT_EQUAL(0, f.feed_view1.remove_handled);
+    executor.runAll();
+    EXPECT_EQUAL(1, f.feed_view1.remove_handled);
+    EXPECT_EQUAL(10u, progress.getCurrent());
+}
+
+TEST_F("require that decoded packets are replayed by active FeedView", Fixture)
+{
+    RemoveOperationContext opCtx(10);
+    auto wrap = std::make_shared<PacketWrapper>(*opCtx.packet, nullptr);
+    QueuedExecutor executor;
+
+    f.decode_ahead_state.receive(wrap, executor);
+    f.decode_executor.runAll();
+    f.feed_view_ptr = &f.feed_view2;
+    executor.runAll();
+    EXPECT_EQUAL(0, f.feed_view1.remove_handled);
+    EXPECT_EQUAL(1, f.feed_view2.remove_handled);
+}
+
 TEST_F("require that replay progress is tracked", Fixture)
 {
     RemoveOperationContext opCtx(10);
@@ -0,0 +1,196 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchcore/proton/flushengine/flushcontext.h>
+#include <vespa/searchcore/proton/flushengine/tls_stats_map.h>
+#include <vespa/searchcore/proton/server/predictive_flush.h>
+#include <vespa/searchcore/proton/test/dummy_flush_handler.h>
+#include <vespa/searchcore/proton/test/dummy_flush_target.h>
+#include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/gtest/gtest.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP("predictive_flush_test");
+
+using namespace proton;
+using search::SerialNum;
+using searchcorespi::IFlushTarget;
+using vespalib::Slime;
+
+namespace {
+
+constexpr uint64_t gibi = UINT64_C(1024) * UINT64_C(1024) * UINT64_C(1024);
+
+using MemoryGain = IFlushTarget::MemoryGain;
+using StringList = std::vector<vespalib::string>;
+
+class MyFlushTarget : public test::DummyFlushTarget {
+private:
+    MemoryGain _memoryGain;
+    SerialNum  _flushedSerial;
+    uint64_t   _bytesToWrite;
+    bool       _urgentFlush;
+public:
+    MyFlushTarget(const vespalib::string &name, MemoryGain memoryGain, SerialNum flushedSerial,
+                  uint64_t bytesToWrite, bool urgentFlush)
+        : test::DummyFlushTarget(name),
+          _memoryGain(memoryGain),
+          _flushedSerial(flushedSerial),
+          _bytesToWrite(bytesToWrite),
+          _urgentFlush(urgentFlush)
+    {
+    }
+    MemoryGain getApproxMemoryGain() const override { return _memoryGain; }
+    SerialNum getFlushedSerialNum() const override { return _flushedSerial; }
+    uint64_t getApproxBytesToWriteToDisk() const override { return _bytesToWrite; }
+    bool needUrgentFlush() const override { return _urgentFlush; }
+};
+
+MemoryFlush::Config
+memoryConfig(uint64_t maxGlobalMemory, uint64_t maxGlobalTlsSize)
+{
+    return MemoryFlush::Config(maxGlobalMemory, maxGlobalTlsSize, 1.0, 1000000, 1.0, std::chrono::hours(24));
+}
+
+}
+
+class PredictiveFlushTest : public ::testing::Test {
+protected:
+    IFlushHandler::SP             _handler;
+    FlushContext::List            _targets;
+    flushengine::TlsStatsMap::Map _tls;
+    PredictiveFlush               _flush;
+
+    PredictiveFlushTest()
+        : _handler(std::make_shared<test::DummyFlushHandler>("handler")),
+          _targets(),
+          _tls(),
+          _flush(memoryConfig(100, 20 * gibi), PredictiveFlush::CostConfig(0.0, 1000.0, 0.5), vespalib::system_clock::now())
+    {
+        _tls["handler"] = flushengine::TlsStats(0, 1, 2000);
+    }
+    ~PredictiveFlushTest() override;
+
+    void add(const vespalib::string &name, int64_t memoryGain, uint64_t bytesToWrite,
+             SerialNum flushedSerial = 2000, bool urgentFlush = false) {
+        auto target = std::make_shared<MyFlushTarget>(name, MemoryGain(memoryGain, 0), flushedSerial,
+                                                      bytesToWrite, urgentFlush);
+        _targets.push_back(std::make_shared<FlushContext>(_handler, target, 2000));
+    }
+    StringList getFlushTargets() {
+        flushengine::TlsStatsMap::Map map(_tls);
+        FlushContext::List targets = _flush.getFlushTargets(_targets, flushengine::TlsStatsMap(std::move(map)));
+        StringList result;
+        for (const auto &ctx : targets) {
+            result.push_back(ctx->getTarget()->getName());
+        }
+        return result;
+    }
+    void flushDone(size_t idx, uint64_t bytesToWrite, double seconds) {
+        _flush.flushDone(*_targets[idx], bytesToWrite, vespalib::from_s(seconds));
+    }
+};
+
+PredictiveFlushTest::~PredictiveFlushTest() = default;
+
+TEST_F(PredictiveFlushTest, no_targets_are_selected_when_limits_are_not_exceeded)
+{
+    add("t1", 10, 1000);
+    add("t2", 20, 1000);
+    EXPECT_EQ(StringList(), getFlushTargets());
+    EXPECT_TRUE(_flush.getLastDecision().empty());
+}
+
+TEST_F(PredictiveFlushTest, cheapest_targets_bringing_memory_below_limit_are_selected)
+{
+    add("attribute", 80, 1000000000);
+    add("memoryindex", 30, 1000);
+    add("small", 20, 1000);
+    EXPECT_EQ(StringList({"memoryindex", "small"}), getFlushTargets());
+    auto decision = _flush.getLastDecision();
+    ASSERT_EQ(3u, decision.size());
+    EXPECT_EQ("handler.attribute", decision[0].name);
+    EXPECT_FALSE(decision[0].selected);
+    EXPECT_TRUE(decision[1].selected);
+    EXPECT_TRUE(decision[2].selected);
+    EXPECT_GT(decision[1].score(), decision[2].score());
+    EXPECT_GT(decision[2].score(), decision[0].score());
+}
+
+TEST_F(PredictiveFlushTest, urgent_targets_are_always_selected_first)
+{
+    add("memoryindex", 80, 1000);
+    add("urgent", 10, 1000000000, 2000, true);
+    add("small", 30, 1000);
+    EXPECT_EQ(StringList({"urgent", "memoryindex"}), getFlushTargets());
+    auto decision = _flush.getLastDecision();
+    ASSERT_EQ(3u, decision.size());
+    EXPECT_EQ("handler.urgent", decision[0].name);
+    EXPECT_TRUE(decision[0].forced);
+    EXPECT_FALSE(decision[1].forced);
+    EXPECT_FALSE(decision[2].selected);
+}
+
+TEST_F(PredictiveFlushTest, flush_history_is_moving_average_of_earlier_flushes)
+{
+    add("t1", 60, 1000);
+    flushDone(0, 1000, 2.0);
+    auto history = _flush.getHistory("handler.t1");
+    EXPECT_EQ(1u, history.flushCount);
+    EXPECT_DOUBLE_EQ(1000.0, history.bytesToWrite);
+    EXPECT_DOUBLE_EQ(2.0, history.flushTime);
+    flushDone(0, 3000, 4.0);
+    history = _flush.getHistory("handler.t1");
+    EXPECT_EQ(2u, history.flushCount);
+    EXPECT_DOUBLE_EQ(2000.0, history.bytesToWrite);
+    EXPECT_DOUBLE_EQ(3.0, history.flushTime);
+    EXPECT_EQ(0u, _flush.getHistory("handler.t2").flushCount);
+}
+
+TEST_F(PredictiveFlushTest, slow_earlier_flushes_make_target_more_expensive)
+{
+    add("t1", 61, 1000);
+    add("t2", 60, 1000);
+    EXPECT_EQ(StringList({"t1"}), getFlushTargets());
+    flushDone(0, 1000, 10.0);
+    flushDone(1, 1000, 1.0);
+    EXPECT_EQ(StringList({"t2"}), getFlushTargets());
+    auto decision = _flush.getLastDecision();
+    ASSERT_EQ(2u, decision.size());
+    EXPECT_DOUBLE_EQ(1000.0 + 1000.0 * 10.0, decision[0].cost);
+    EXPECT_DOUBLE_EQ(1000.0 + 1000.0 * 1.0, decision[1].cost);
+}
+
+TEST_F(PredictiveFlushTest, targets_releasing_transaction_log_are_selected_when_tls_size_is_exceeded)
+{
+    _flush.setConfig(memoryConfig(1000, 2 * gibi));
+    _tls["handler"] = flushengine::TlsStats(10 * gibi, 1001, 2000);
+    add("recent", 10, 1000, 1900);
+    add("oldest", 10, 1000, 1000);
+    EXPECT_EQ(StringList({"oldest"}), getFlushTargets());
+    auto decision = _flush.getLastDecision();
+    ASSERT_EQ(2u, decision.size());
+    EXPECT_EQ("handler.oldest", decision[0].name);
+    EXPECT_GT(decision[0].benefit, decision[1].benefit);
+}
+
+TEST_F(PredictiveFlushTest, state_contains_last_decision_and_history)
+{
+    add("attribute", 60, 1000000000);
+    add("memoryindex", 70, 1000);
+    getFlushTargets();
+    flushDone(1, 1000, 1.0);
+    Slime state;
+    _flush.reportState(state.setObject());
+    const auto &decision = state.get()["lastDecision"];
+    ASSERT_EQ(2u, decision.children());
+    EXPECT_EQ("handler.memoryindex", decision[0]["name"].asString().make_string());
+    EXPECT_TRUE(decision[0]["selected"].asBool());
+    EXPECT_EQ("handler.attribute", decision[1]["name"].asString().make_string());
+    EXPECT_FALSE(decision[1]["selected"].asBool());
+    const auto &history = state.get()["history"];
+    ASSERT_EQ(1u, history.children());
+    EXPECT_EQ("handler.memoryindex", history[0]["name"].asString().make_string());
+    EXPECT_EQ(1, history[0]["flushCount"].asLong());
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
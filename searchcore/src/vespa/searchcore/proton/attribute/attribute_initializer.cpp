@@ -13,6 +13,7 @@
 #include <vespa/searchlib/util/fileutil.h>
 #include <vespa/searchlib/attribute/attribute_header.h>
 #include <vespa/searchlib/attribute/attributevector.h>
+#include <vespa/searchlib/attribute/paged_integer_block_file.h>
 #include <vespa/fastos/file.h>
 
 #include <vespa/log/log.h>
@@ -87,6 +88,56 @@ collectionTypeString(const CollectionType &type, bool detailed)
     return os.str();
 }
 
+bool
+isPagedIntegerType(const Config &cfg)
+{
+    switch (cfg.basicType().type()) {
+    case BasicType::INT8:
+    case BasicType::INT16:
+    case BasicType::INT32:
+    case BasicType::INT64:
+        return cfg.collectionType().type() == CollectionType::SINGLE;
+    default:
+        return false;
+    }
+}
+
+/*
+ * Paged single value integer attributes save their data in a compressed
+ * format that only a paged attribute can load. A paged attribute can also
+ * load data saved by a plain attribute.
+ */
+bool
+usesPagedFormat(const Config &cfg)
+{
+    return cfg.paged() && !cfg.fastSearch();
+}
+
+/*
+ * Delta saves (only changed documents, relative to a linked base data file)
+ * can only be loaded by plain single value numeric attributes.
+ */
+bool
+usesPlainNumericFormat(const Config &cfg)
+{
+    switch (cfg.basicType().type()) {
+    case BasicType::INT8:
+    case BasicType::INT16:
+    case BasicType::INT32:
+    case BasicType::INT64:
+        if (cfg.paged() || cfg.packed()) {
+            return false;
+        }
+        break;
+    case BasicType::FLOAT:
+    case BasicType::DOUBLE:
+        break;
+    default:
+        return false;
+    }
+    return (cfg.collectionType().type() == CollectionType::SINGLE) && !cfg.fastSearch();
+}
+
 bool
 headerTypeOK(const AttributeHeader &header, const Config &cfg)
 {
@@ -110,6 +161,13 @@ headerTypeOK(const AttributeHeader &header, const Config &cfg)
             }
         }
     }
+    if (isPagedIntegerType(cfg) && !header.getEnumerated() &&
+        header.getVersion() == search::attribute::PagedIntegerBlockFile::VERSION && !usesPagedFormat(cfg)) {
+        return false;
+    }
+    if (header.getDelta() && !usesPlainNumericFormat(cfg)) {
+        return false;
+    }
     return true;
 }
 
@@ -193,7 +251,7 @@ AttributeInitializer::loadAttribute(const AttributeVectorSP &attr,
     assert(attr->hasLoadData());
     vespalib::Timer timer;
     EventLogger::loadAttributeStart(_documentSubDbName, attr->getName());
-    if (!attr->load()) {
+    if (!attr->load(_shared_executor)) {
         LOG(warning, "Could not load attribute vector '%s' from disk. Returning empty attribute vector",
             attr->getBaseFileName().c_str());
         return false;
@@ -234,12 +292,14 @@ AttributeInitializer::AttributeInitializer(const std::shared_ptr<AttributeDirect
                                            const vespalib::string &documentSubDbName,
                                            const AttributeSpec &spec,
                                            uint64_t currentSerialNum,
-                                           const IAttributeFactory &factory)
+                                           const IAttributeFactory &factory,
+                                           vespalib::Executor *shared_executor)
     : _attrDir(attrDir),
       _documentSubDbName(documentSubDbName),
       _spec(spec),
       _currentSerialNum(currentSerialNum),
       _factory(factory),
+      _shared_executor(shared_executor),
       _header(),
       _header_ok(false)
 {
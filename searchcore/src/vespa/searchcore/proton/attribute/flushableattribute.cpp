@@ -173,6 +173,9 @@ FlushableAttribute::FlushableAttribute(const AttributeVectorSP attr,
     if (config.basicType() == search::attribute::BasicType::Type::TENSOR &&
         config.tensorType().is_tensor() && config.tensorType().is_dense() && config.hnsw_index_params().has_value()) {
         _replay_operation_cost = 100.0; // replaying operations to hnsw index is 100 times more expensive than reading from tls
+    } else if (config.basicType() == search::attribute::BasicType::Type::TENSOR &&
+               config.tensorType().is_tensor() && config.tensorType().is_dense() && config.ivf_pq_index_params().has_value()) {
+        _replay_operation_cost = 10.0; // assigning and encoding vectors in ivf-pq index is cheaper than linking them in hnsw index
     }
 }
 
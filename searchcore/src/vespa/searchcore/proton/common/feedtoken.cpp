@@ -35,6 +35,17 @@ State::fail()
     }
 }
 
+void
+State::commitFailed(const vespalib::string & reason)
+{
+    // The result might still be set by the feed thread, so a new one is sent.
+    bool alreadySent = _alreadySent.exchange(true);
+    if ( !alreadySent ) {
+        using storage::spi::Result;
+        _transport.send(std::make_unique<Result>(Result::ErrorType::TRANSIENT_ERROR, reason), false);
+    }
+}
+
 OwningState::~OwningState() {
     ack();
 }
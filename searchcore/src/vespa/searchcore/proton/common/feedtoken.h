@@ -3,6 +3,7 @@
 
 #include <vespa/persistence/spi/persistenceprovider.h>
 #include <vespa/searchlib/common/idestructorcallback.h>
+#include <vespa/searchlib/transactionlog/common.h>
 #include <atomic>
 
 namespace proton {
@@ -25,14 +26,18 @@ public:
 /**
  * This holds the result of the feed operation until it is either failed or acked.
  * Guarantees that the result is propagated back to the invoker via ITransport interface.
+ * A failed commit to the transaction log is replied with a transient error.
  */
-class State : public search::IDestructorCallback {
+class State : public search::IDestructorCallback,
+              public search::transactionlog::ICommitFailureHandler
+{
 public:
     State(const State &) = delete;
     State & operator = (const State &) = delete;
     State(ITransport & transport);
     ~State() override;
     void fail();
+    void commitFailed(const vespalib::string & reason) override;
     void setResult(ResultUP result, bool documentWasFound) {
         _documentWasFound = documentWasFound;
         _result = std::move(result);
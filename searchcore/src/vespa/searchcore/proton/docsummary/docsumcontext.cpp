@@ -61,6 +61,27 @@ DocsumContext::initState()
     }
 }
 
+namespace {
+
+/*
+ * Docsums are prefetched in batches of this size, so that a request that
+ * times out does not read documents it will not use.
+ */
+constexpr uint32_t PREFETCH_BATCH_SIZE = 64;
+
+}
+
+void
+DocsumContext::prefetchDocsums(const IDocsumWriter::ResolveClassInfo & rci, uint32_t from)
+{
+    if (rci.mustSkip || rci.allGenerated || ((from % PREFETCH_BATCH_SIZE) != 0) || _request.expired()) {
+        return;
+    }
+    uint32_t to = std::min(from + PREFETCH_BATCH_SIZE, _docsumState._docsumcnt);
+    std::vector<uint32_t> docIds(_docsumState._docsumbuf + from, _docsumState._docsumbuf + to);
+    _docsumStore.prefetch(docIds);
+}
+
 DocsumReply::UP
 DocsumContext::createReply()
 {
@@ -71,6 +92,7 @@ DocsumContext::createReply()
     SymbolTable::UP symbols = std::make_unique<SymbolTable>();
     IDocsumWriter::ResolveClassInfo rci = _docsumWriter.resolveClassInfo(_docsumState._args.getResultClassName(), _docsumStore.getSummaryClassId());
     for (uint32_t i = 0; i < _docsumState._docsumcnt; ++i) {
+        prefetchDocsums(rci, i);
         buf.reset();
         uint32_t docId = _docsumState._docsumbuf[i];
         reply->docsums[i].docid = docId;
@@ -116,6 +138,7 @@ DocsumContext::createSlimeReply()
                                                                          _docsumStore.getSummaryClassId());
     uint32_t i(0);
     for (i = 0; (i < _docsumState._docsumcnt) && !_request.expired(); ++i) {
+        prefetchDocsums(rci, i);
         uint32_t docId = _docsumState._docsumbuf[i];
         Cursor & docSumC = array.addObject();
         ObjectSymbolInserter inserter(docSumC, docsumSym);
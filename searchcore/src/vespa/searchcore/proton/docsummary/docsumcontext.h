@@ -32,6 +32,7 @@ private:
     matching::SessionManager             & _sessionMgr;
 
     void initState();
+    void prefetchDocsums(const search::docsummary::IDocsumWriter::ResolveClassInfo & rci, uint32_t from);
     search::engine::DocsumReply::UP createReply();
     std::unique_ptr<vespalib::Slime> createSlimeReply();
 
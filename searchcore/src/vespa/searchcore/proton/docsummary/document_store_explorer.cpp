@@ -5,6 +5,7 @@
 
 using vespalib::slime::Cursor;
 using vespalib::slime::Inserter;
+using search::DataStoreCompactionStats;
 using search::DataStoreFileChunkStats;
 using search::DataStoreStorageStats;
 
@@ -27,6 +28,23 @@ setMemoryUsage(Cursor &object, const vespalib::MemoryUsage &usage)
     memory.setLong("onHoldBytes", usage.allocatedBytesOnHold());
 }
 
+void
+setCompaction(Cursor &object, const DataStoreCompactionStats &stats, const vespalib::string &baseDir)
+{
+    Cursor &compaction = object.setObject("compaction");
+    compaction.setBool("active", stats.active());
+    if (stats.active()) {
+        compaction.setString("name", search::DataStoreFileChunkId(stats.nameId()).createName(baseDir));
+        compaction.setLong("numChunks", stats.numChunks());
+        compaction.setLong("compactedChunks", stats.compactedChunks());
+        compaction.setDouble("progress", stats.progress());
+        compaction.setLong("numThreads", stats.numThreads());
+        compaction.setLong("bytesRead", stats.bytesRead());
+        compaction.setDouble("bytesPerSecond", stats.bytesPerSecond());
+        compaction.setLong("maxBytesPerSecond", stats.maxBytesPerSecond());
+    }
+}
+
 }
 
 void
@@ -42,6 +60,7 @@ DocumentStoreExplorer::get_state(const Inserter &inserter, bool full) const
     object.setLong("lastSerialNum", storageStats.lastSerialNum());
     object.setLong("docIdLimit", storageStats.docIdLimit());
     setMemoryUsage(object, store.getMemoryUsage());
+    setCompaction(object, store.getCompactionStats(), store.getBaseDir());
     if (full) {
         const vespalib::string &baseDir = store.getBaseDir();
         std::vector<DataStoreFileChunkStats> chunks;
@@ -77,13 +77,22 @@ ShrinkSummaryLidSpaceFlushTarget::initFlush(SerialNum currentSerial)
     return future.get();
 }
 
+/**
+ * Prefetching docsums only pays off when the document store can read them asynchronously in one batch.
+ */
+bool
+usesAsyncSummaryReads(const TuneFileSummary & tune)
+{
+    return (tune._randRead.getAsyncQueueDepth() > 0) && ! tune._randRead.getWantMemoryMap();
+}
+
 }
 
 SummaryManager::SummarySetup::
 SummarySetup(const vespalib::string & baseDir, const DocTypeName & docTypeName, const SummaryConfig & summaryCfg,
              const SummarymapConfig & summarymapCfg, const JuniperrcConfig & juniperCfg,
              search::IAttributeManager::SP attributeMgr, search::IDocumentStore::SP docStore,
-             std::shared_ptr<const DocumentTypeRepo> repo)
+             std::shared_ptr<const DocumentTypeRepo> repo, bool prefetchDocsums)
     : _docsumWriter(),
       _wordFolder(std::make_unique<Fast_NormalizeWordFolder>()),
       _juniperProps(juniperCfg),
@@ -92,7 +101,8 @@ SummarySetup(const vespalib::string & baseDir, const DocTypeName & docTypeName,
       _docStore(std::move(docStore)),
       _fieldCacheRepo(),
       _repo(repo),
-      _markupFields()
+      _markupFields(),
+      _prefetchDocsums(prefetchDocsums)
 {
     auto resultConfig = std::make_unique<ResultConfig>();
     if (!resultConfig->ReadConfig(summaryCfg, make_string("SummaryManager(%s)", baseDir.c_str()).c_str())) {
@@ -133,7 +143,8 @@ SummarySetup(const vespalib::string & baseDir, const DocTypeName & docTypeName,
 IDocsumStore::UP
 SummaryManager::SummarySetup::createDocsumStore(const vespalib::string &resultClassName) {
     return std::make_unique<DocumentStoreAdapter>(*_docStore, *_repo, getResultConfig(), resultClassName,
-                                                  _fieldCacheRepo->getFieldCache(resultClassName), _markupFields);
+                                                  _fieldCacheRepo->getFieldCache(resultClassName), _markupFields,
+                                                  _prefetchDocsums);
 }
 
 
@@ -143,7 +154,8 @@ SummaryManager::createSummarySetup(const SummaryConfig & summaryCfg, const Summa
                                    const search::IAttributeManager::SP &attributeMgr)
 {
     return std::make_shared<SummarySetup>(_baseDir, _docTypeName, summaryCfg, summarymapCfg,
-                                          juniperCfg, attributeMgr, _docStore, repo);
+                                          juniperCfg, attributeMgr, _docStore, repo,
+                                          usesAsyncSummaryReads(_tuneFileSummary));
 }
 
 SummaryManager::SummaryManager(vespalib::ThreadExecutor & executor, const LogDocumentStore::Config & storeConfig,
@@ -34,6 +34,7 @@ public:
         FieldCacheRepo::UP                    _fieldCacheRepo;
         const std::shared_ptr<const document::DocumentTypeRepo>  _repo;
         std::set<vespalib::string>            _markupFields;
+        bool                                  _prefetchDocsums;
     public:
         SummarySetup(const vespalib::string & baseDir,
                      const DocTypeName & docTypeName,
@@ -42,7 +43,8 @@ public:
                      const vespa::config::search::summary::JuniperrcConfig & juniperCfg,
                      search::IAttributeManager::SP attributeMgr,
                      search::IDocumentStore::SP docStore,
-                     std::shared_ptr<const document::DocumentTypeRepo> repo);
+                     std::shared_ptr<const document::DocumentTypeRepo> repo,
+                     bool prefetchDocsums);
 
         search::docsummary::IDocsumWriter & getDocsumWriter() const override { return *_docsumWriter; }
         search::docsummary::ResultConfig & getResultConfig() override { return *_docsumWriter->GetResultConfig(); }
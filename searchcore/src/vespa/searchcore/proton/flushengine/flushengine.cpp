@@ -60,16 +60,19 @@ FlushEngine::FlushMeta::~FlushMeta() = default;
 
 FlushEngine::FlushInfo::FlushInfo()
     : FlushMeta("", 0),
-      _target()
+      _target(),
+      _bytesToWrite(0)
 {
 }
 
 FlushEngine::FlushInfo::~FlushInfo() = default;
 
 
-FlushEngine::FlushInfo::FlushInfo(uint32_t taskId, const IFlushTarget::SP &target, const vespalib::string & destination)
+FlushEngine::FlushInfo::FlushInfo(uint32_t taskId, const IFlushTarget::SP &target, const vespalib::string & destination,
+                                  uint64_t bytesToWrite)
     : FlushMeta(destination, taskId),
-      _target(target)
+      _target(target),
+      _bytesToWrite(bytesToWrite)
 {
 }
 
@@ -349,10 +352,14 @@ void
 FlushEngine::flushDone(const FlushContext &ctx, uint32_t taskId)
 {
     vespalib::duration duration = vespalib::duration::zero();
+    uint64_t bytesToWrite = 0;
     {
         std::lock_guard<std::mutex> guard(_lock);
-        duration = _flushing[taskId].elapsed();
+        const FlushInfo &flush = _flushing[taskId];
+        duration = flush.elapsed();
+        bytesToWrite = flush._bytesToWrite;
     }
+    _strategy->flushDone(ctx, bytesToWrite, duration);
     if (LOG_WOULD_LOG(event)) {
         FlushStats stats = ctx.getTarget()->getLastFlushStats();
         EventLogger::flushComplete(ctx.getName(), vespalib::count_ms(duration), ctx.getTarget()->getFlushedSerialNum(),
@@ -404,11 +411,12 @@ uint32_t
 FlushEngine::initFlush(const IFlushHandler::SP &handler, const IFlushTarget::SP &target)
 {
     uint32_t taskId(0);
+    uint64_t bytesToWrite = target->getApproxBytesToWriteToDisk();
     {
         std::lock_guard<std::mutex> guard(_lock);
         taskId = _taskId++;
         vespalib::string name(FlushContext::createName(*handler, *target));
-        FlushInfo flush(taskId, target, name);
+        FlushInfo flush(taskId, target, name, bytesToWrite);
         _flushing[taskId] = flush;
     }
     LOG(debug, "FlushEngine::initFlush(handler='%s', target='%s') => taskId='%d'",
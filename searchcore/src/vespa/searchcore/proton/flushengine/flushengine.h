@@ -39,10 +39,12 @@ private:
     struct FlushInfo : public FlushMeta
     {
         FlushInfo();
-        FlushInfo(uint32_t taskId, const IFlushTarget::SP &target, const vespalib::string &destination);
+        FlushInfo(uint32_t taskId, const IFlushTarget::SP &target, const vespalib::string &destination,
+                  uint64_t bytesToWrite);
         ~FlushInfo();
 
         IFlushTarget::SP  _target;
+        uint64_t          _bytesToWrite;
     };
     typedef std::map<uint32_t, FlushInfo> FlushMap;
     typedef HandlerMap<IFlushHandler> FlushHandlerMap;
@@ -3,6 +3,9 @@
 
 #include "iflushhandler.h"
 #include "flushcontext.h"
+#include <vespa/vespalib/util/time.h>
+
+namespace vespalib::slime { struct Cursor; }
 
 namespace proton {
 
@@ -36,6 +39,26 @@ public:
     virtual FlushContext::List getFlushTargets(const FlushContext::List & targetList,
                                                const flushengine::TlsStatsMap &
                                                tlsStatsMap) const = 0;
+
+    /**
+     * Called when a flush of a target has completed. Strategies can use
+     * this to learn how expensive it is to flush each target.
+     * @param ctx The context of the flushed target.
+     * @param bytesToWrite The approximate number of bytes to write to disk,
+     *                     sampled when the flush was started.
+     * @param duration The time used by the flush.
+     */
+    virtual void flushDone(const FlushContext &ctx, uint64_t bytesToWrite, vespalib::duration duration) {
+        (void) ctx;
+        (void) bytesToWrite;
+        (void) duration;
+    }
+
+    /**
+     * Reports the internal state of this strategy, e.g. the reasoning behind
+     * its last decision, to a state explorer.
+     */
+    virtual void reportState(vespalib::slime::Cursor &object) const { (void) object; }
 protected:
     IFlushStrategy() = default;
 };
@@ -15,11 +15,13 @@ private:
 public:
     DiskIndexWrapper(const vespalib::string &indexDir,
                      const search::TuneFileSearch &tuneFileSearch,
-                     size_t cacheSize);
+                     size_t cacheSize,
+                     search::diskindex::PostingListCache::SP postingListCache = search::diskindex::PostingListCache::SP());
 
     DiskIndexWrapper(const DiskIndexWrapper &oldIndex,
                      const search::TuneFileSearch &tuneFileSearch,
-                     size_t cacheSize);
+                     size_t cacheSize,
+                     search::diskindex::PostingListCache::SP postingListCache = search::diskindex::PostingListCache::SP());
 
     /**
      * Implements searchcorespi::IndexSearchable
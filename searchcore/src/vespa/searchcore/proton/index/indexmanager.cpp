@@ -7,6 +7,7 @@
 #include <vespa/searchlib/diskindex/fusion.h>
 
 using search::diskindex::Fusion;
+using search::diskindex::PostingListCache;
 using search::common::FileHeaderContext;
 using search::common::SerialNumFileHeaderContext;
 using search::index::Schema;
@@ -27,8 +28,11 @@ namespace proton::index {
 IndexManager::MaintainerOperations::MaintainerOperations(const FileHeaderContext &fileHeaderContext,
                                                          const TuneFileIndexManager &tuneFileIndexManager,
                                                          size_t cacheSize,
+                                                         size_t postingListCacheSize,
                                                          IThreadingService &threadingService)
     : _cacheSize(cacheSize),
+      _postingListCache(postingListCacheSize > 0 ? std::make_shared<PostingListCache>(postingListCacheSize)
+                                                 : PostingListCache::SP()),
       _fileHeaderContext(fileHeaderContext),
       _tuneFileIndexing(tuneFileIndexManager._indexing),
       _tuneFileSearch(tuneFileIndexManager._search),
@@ -48,14 +52,14 @@ IndexManager::MaintainerOperations::createMemoryIndex(const Schema& schema,
 IDiskIndex::SP
 IndexManager::MaintainerOperations::loadDiskIndex(const vespalib::string &indexDir)
 {
-    return std::make_shared<DiskIndexWrapper>(indexDir, _tuneFileSearch, _cacheSize);
+    return std::make_shared<DiskIndexWrapper>(indexDir, _tuneFileSearch, _cacheSize, _postingListCache);
 }
 
 IDiskIndex::SP
 IndexManager::MaintainerOperations::reloadDiskIndex(const IDiskIndex &oldIndex)
 {
     return std::make_shared<DiskIndexWrapper>(dynamic_cast<const DiskIndexWrapper &>(oldIndex),
-                                              _tuneFileSearch, _cacheSize);
+                                              _tuneFileSearch, _cacheSize, _postingListCache);
 }
 
 bool
@@ -82,7 +86,8 @@ IndexManager::IndexManager(const vespalib::string &baseDir,
                            const search::TuneFileIndexManager &tuneFileIndexManager,
                            const search::TuneFileAttributes &tuneFileAttributes,
                            const FileHeaderContext &fileHeaderContext) :
-    _operations(fileHeaderContext, tuneFileIndexManager, indexConfig.cacheSize, threadingService),
+    _operations(fileHeaderContext, tuneFileIndexManager, indexConfig.cacheSize,
+                indexConfig.postingListCacheSize, threadingService),
     _maintainer(IndexMaintainerConfig(baseDir, indexConfig.warmup, indexConfig.maxFlushed, schema, serialNum, tuneFileAttributes),
                 IndexMaintainerContext(threadingService, reconfigurer, fileHeaderContext, warmupExecutor),
                 _operations)
@@ -91,6 +96,18 @@ IndexManager::IndexManager(const vespalib::string &baseDir,
 
 IndexManager::~IndexManager() = default;
 
+search::SearchableStats
+IndexManager::getSearchableStats() const
+{
+    search::SearchableStats stats = _maintainer.getSearchableStats();
+    const auto &postingListCache = _operations.getPostingListCache();
+    if (postingListCache) {
+        stats.postingListCacheStats(postingListCache->getCacheStats());
+        stats.bitVectorCacheStats(postingListCache->getBitVectorCacheStats());
+    }
+    return stats;
+}
+
 void
 IndexManager::compactLidSpace(uint32_t lidLimit, SerialNum serialNum)
 {
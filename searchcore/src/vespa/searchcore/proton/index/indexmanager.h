@@ -6,6 +6,7 @@
 #include <vespa/searchcorespi/index/indexmaintainer.h>
 #include <vespa/searchcorespi/index/ithreadingservice.h>
 #include <vespa/searchcorespi/index/warmupconfig.h>
+#include <vespa/searchlib/diskindex/posting_list_cache.h>
 
 namespace proton::index {
 
@@ -13,14 +14,19 @@ struct IndexConfig {
     using WarmupConfig = searchcorespi::index::WarmupConfig;
     IndexConfig() : IndexConfig(WarmupConfig(), 2, 0) { }
     IndexConfig(WarmupConfig warmup_, size_t maxFlushed_, size_t cacheSize_)
+        : IndexConfig(warmup_, maxFlushed_, cacheSize_, 0)
+    { }
+    IndexConfig(WarmupConfig warmup_, size_t maxFlushed_, size_t cacheSize_, size_t postingListCacheSize_)
         : warmup(warmup_),
           maxFlushed(maxFlushed_),
-          cacheSize(cacheSize_)
+          cacheSize(cacheSize_),
+          postingListCacheSize(postingListCacheSize_)
     { }
 
     const WarmupConfig warmup;
     const size_t       maxFlushed;
     const size_t       cacheSize;
+    const size_t       postingListCacheSize;
 };
 
 /**
@@ -37,6 +43,7 @@ public:
         using IDiskIndex = searchcorespi::index::IDiskIndex;
         using IMemoryIndex = searchcorespi::index::IMemoryIndex;
         const size_t _cacheSize;
+        search::diskindex::PostingListCache::SP _postingListCache;
         const search::common::FileHeaderContext &_fileHeaderContext;
         const search::TuneFileIndexing _tuneFileIndexing;
         const search::TuneFileSearch _tuneFileSearch;
@@ -46,6 +53,7 @@ public:
         MaintainerOperations(const search::common::FileHeaderContext &fileHeaderContext,
                              const search::TuneFileIndexManager &tuneFileIndexManager,
                              size_t cacheSize,
+                             size_t postingListCacheSize,
                              searchcorespi::index::IThreadingService &threadingService);
 
         IMemoryIndex::SP createMemoryIndex(const Schema& schema,
@@ -57,6 +65,8 @@ public:
                        const std::vector<vespalib::string> &sources,
                        const SelectorArray &docIdSelector,
                        search::SerialNum lastSerialNum) override;
+
+        const search::diskindex::PostingListCache::SP &getPostingListCache() const { return _postingListCache; }
     };
 
 private:
@@ -114,9 +124,7 @@ public:
         return _maintainer.getSearchable();
     }
 
-    search::SearchableStats getSearchableStats() const override {
-        return _maintainer.getSearchableStats();
-    }
+    search::SearchableStats getSearchableStats() const override;
 
     searchcorespi::IFlushTarget::List getFlushTargets() override {
         return _maintainer.getFlushTargets();
@@ -160,4 +160,170 @@ AdaptiveDocidRangeScheduler::share_range(size_t thread_id, DocidRange todo)
 
 //-----------------------------------------------------------------------------
 
+DocidRange
+WorkStealingDocidRangeScheduler::take_front(size_t thread_id)
+{
+    Worker &worker = _workers[thread_id];
+    uint64_t old_value = worker.todo.load(std::memory_order_acquire);
+    for (;;) {
+        DocidRange todo = unpack(old_value);
+        if (todo.empty()) {
+            return DocidRange();
+        }
+        size_t size = (todo.size() >= (2 * _min_task)) ? (todo.size() / 2) : todo.size();
+        DocidRange work(todo.begin, todo.begin + size);
+        if (worker.todo.compare_exchange_weak(old_value, pack(DocidRange(work.end, todo.end)),
+                                              std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            worker.assigned += work.size();
+            return work;
+        }
+    }
+}
+
+bool
+WorkStealingDocidRangeScheduler::steal(size_t thread_id)
+{
+    for (;;) {
+        size_t victim = thread_id;
+        uint64_t old_value = 0;
+        size_t best_size = 0;
+        for (size_t i = 1; i < _workers.size(); ++i) {
+            size_t candidate = (thread_id + i) % _workers.size();
+            uint64_t value = _workers[candidate].todo.load(std::memory_order_acquire);
+            if (unpack(value).size() > best_size) {
+                victim = candidate;
+                old_value = value;
+                best_size = unpack(value).size();
+            }
+        }
+        if (best_size == 0) {
+            return false;
+        }
+        DocidRange todo = unpack(old_value);
+        uint32_t keep = (todo.size() >= (2 * _min_task)) ? (todo.size() / 2) : 0;
+        DocidRange stolen(todo.begin + keep, todo.end);
+        if (_workers[victim].todo.compare_exchange_strong(old_value, pack(DocidRange(todo.begin, stolen.begin)),
+                                                          std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            // our own slot is empty, and empty slots are never touched by other threads
+            _workers[thread_id].todo.store(pack(stolen));
+            wake_waiting(false);
+            return true;
+        }
+    }
+}
+
+WorkStealingDocidRangeScheduler::WorkStealingDocidRangeScheduler(size_t num_threads, uint32_t min_task, uint32_t docid_limit)
+    : _total(1, docid_limit),
+      _min_task(std::max(1u, min_task)),
+      _workers(num_threads),
+      _num_idle(0),
+      _num_busy(num_threads),
+      _num_waiting(0),
+      _lock(),
+      _cond()
+{
+    DocidRangeSplitter splitter(_total, num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        _workers[i].todo.store(pack(splitter.get(i)), std::memory_order_relaxed);
+    }
+}
+
+WorkStealingDocidRangeScheduler::~WorkStealingDocidRangeScheduler() = default;
+
+bool
+WorkStealingDocidRangeScheduler::has_work() const
+{
+    for (const Worker &worker: _workers) {
+        if (!unpack(worker.todo.load()).empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+WorkStealingDocidRangeScheduler::wake_waiting(bool all)
+{
+    // pairs with the sequentially consistent increment in 'next_range'
+    // followed by checking for work while holding the lock
+    if (_num_waiting.load() > 0) {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (all) {
+            _cond.notify_all();
+        } else {
+            _cond.notify_one();
+        }
+    }
+}
+
+DocidRange
+WorkStealingDocidRangeScheduler::next_range(size_t thread_id)
+{
+    Worker &worker = _workers[thread_id];
+    for (;;) {
+        DocidRange work = take_front(thread_id);
+        if (!work.empty()) {
+            if (worker.is_idle) {
+                worker.is_idle = false;
+                _num_busy.fetch_add(1);
+                _num_idle.fetch_sub(1);
+            }
+            return work;
+        }
+        if (!worker.is_idle) {
+            worker.is_idle = true;
+            _num_idle.fetch_add(1);
+            if (_num_busy.fetch_sub(1) == 1) {
+                wake_waiting(true);
+            }
+        }
+        if (!steal(thread_id)) {
+            std::unique_lock<std::mutex> guard(_lock);
+            _num_waiting.fetch_add(1);
+            _cond.wait(guard, [this]{ return (has_work() || (_num_busy.load() == 0)); });
+            _num_waiting.fetch_sub(1);
+            if ((_num_busy.load() == 0) && !has_work()) {
+                // nothing left to steal and nobody left to share work with us
+                return DocidRange();
+            }
+        }
+    }
+}
+
+size_t
+WorkStealingDocidRangeScheduler::unassigned_size() const
+{
+    size_t sum = 0;
+    for (const Worker &worker: _workers) {
+        sum += unpack(worker.todo.load(std::memory_order_relaxed)).size();
+    }
+    return sum;
+}
+
+DocidRange
+WorkStealingDocidRangeScheduler::share_range(size_t thread_id, DocidRange todo)
+{
+    Worker &worker = _workers[thread_id];
+    uint64_t old_value = worker.todo.load(std::memory_order_acquire);
+    if ((todo.size() < (2 * _min_task)) || !unpack(old_value).empty()) {
+        // too little to share, or there is already work left to steal from us
+        return todo;
+    }
+    DocidRange keep(todo.begin, todo.begin + (todo.size() / 2));
+    for (;;) {
+        DocidRange rest = unpack(old_value);
+        assert(rest.begin == todo.end);
+        if (worker.todo.compare_exchange_weak(old_value, pack(DocidRange(keep.end, rest.end))))
+        {
+            worker.assigned -= (todo.end - keep.end);
+            wake_waiting(false);
+            return keep;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
 }
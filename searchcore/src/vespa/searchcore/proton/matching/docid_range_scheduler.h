@@ -204,4 +204,56 @@ public:
     DocidRange share_range(size_t, DocidRange todo) override;
 };
 
+/**
+ * A lock-free scheduler that begins by giving each thread an equal
+ * part of the docid space, which is kept in a per-thread slot. The
+ * owner takes work from the front of its own slot (half of what is
+ * left, but at least 'min_task' docids at a time), while idle threads
+ * steal the upper half of the largest remaining range found in the
+ * slots of other threads. Both operations are a single compare and
+ * swap of the packed range, so threads landing on dense regions of
+ * the docid space will have their remaining work taken over without
+ * any shared lock. Work that has already been handed out to a thread
+ * is made available for stealing again by 'share_range' when no other
+ * work is left to steal. Threads that find nothing to steal block
+ * until more work is shared or all threads are idle. The lock is only
+ * taken to wait and to wake up waiting threads, never when taking or
+ * stealing work.
+ **/
+class WorkStealingDocidRangeScheduler : public DocidRangeScheduler
+{
+private:
+    struct alignas(64) Worker {
+        std::atomic<uint64_t> todo;
+        size_t                assigned;
+        bool                  is_idle;
+        Worker() : todo(0), assigned(0), is_idle(false) {}
+    };
+    DocidRange          _total;
+    uint32_t            _min_task;
+    std::vector<Worker> _workers;
+    std::atomic<size_t> _num_idle;
+    std::atomic<size_t> _num_busy;
+    std::atomic<size_t> _num_waiting;
+    std::mutex              _lock;
+    std::condition_variable _cond;
+
+    static uint64_t pack(DocidRange range) { return ((uint64_t(range.begin) << 32) | range.end); }
+    static DocidRange unpack(uint64_t value) { return DocidRange(value >> 32, value & 0xffffffff); }
+    VESPA_DLL_LOCAL DocidRange take_front(size_t thread_id);
+    VESPA_DLL_LOCAL bool steal(size_t thread_id);
+    VESPA_DLL_LOCAL bool has_work() const;
+    VESPA_DLL_LOCAL void wake_waiting(bool all);
+public:
+    WorkStealingDocidRangeScheduler(size_t num_threads, uint32_t min_task, uint32_t docid_limit);
+    ~WorkStealingDocidRangeScheduler();
+    DocidRange first_range(size_t thread_id) override { return next_range(thread_id); }
+    DocidRange next_range(size_t thread_id) override;
+    DocidRange total_span(size_t) const override { return _total; }
+    size_t total_size(size_t thread_id) const override { return _workers[thread_id].assigned; }
+    size_t unassigned_size() const override;
+    IdleObserver make_idle_observer() const override { return IdleObserver(_num_idle); }
+    DocidRange share_range(size_t thread_id, DocidRange todo) override;
+};
+
 }
@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "document_scorer.h"
+#include <algorithm>
 #include <cassert>
 
 using search::feature_t;
@@ -25,7 +26,8 @@ extractScoreFeature(const RankProgram &rankProgram)
 
 DocumentScorer::DocumentScorer(RankProgram &rankProgram,
                                SearchIterator &searchItr)
-    : _searchItr(searchItr),
+    : _rankProgram(rankProgram),
+      _searchItr(searchItr),
       _scoreFeature(extractScoreFeature(rankProgram))
 {
 }
@@ -36,4 +38,31 @@ DocumentScorer::score(uint32_t docId)
     return doScore(docId);
 }
 
+void
+DocumentScorer::score(TaggedHits &hits)
+{
+    auto sort_on_docid = [](const TaggedHit &a, const TaggedHit &b){ return (a.first.first < b.first.first); };
+    std::sort(hits.begin(), hits.end(), sort_on_docid);
+    if (_rankProgram.batch_size() == 0) {
+        for (auto &hit: hits) {
+            hit.first.second = doScore(hit.first.first);
+        }
+        return;
+    }
+    for (size_t begin = 0; begin < hits.size(); ) {
+        size_t end = begin;
+        for (; (end < hits.size()) && !_rankProgram.batch_full(); ++end) {
+            uint32_t docId = hits[end].first.first;
+            _searchItr.unpack(docId);
+            _rankProgram.add_to_batch(docId);
+        }
+        auto scores = _rankProgram.execute_batch();
+        for (size_t i = begin; i < end; ++i) {
+            hits[i].first.second = scores[i - begin];
+        }
+        _rankProgram.clear_batch();
+        begin = end;
+    }
+}
+
 }
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "i_match_loop_communicator.h"
 #include <vespa/searchlib/fef/rank_program.h>
 #include <vespa/searchlib/queryeval/hitcollector.h>
 #include <vespa/searchlib/queryeval/searchiterator.h>
@@ -12,14 +13,20 @@ namespace proton::matching {
  * Class used to calculate the rank score for a set of documents using
  * a rank program for calculation and a search iterator for unpacking match data.
  * The calculateScore() function is always called in increasing docId order.
+ * When the rank program is set up for batches, the hits given to
+ * score(TaggedHits &) are scored in batches of that size.
  */
 class DocumentScorer : public search::queryeval::HitCollector::DocumentScorer
 {
 private:
+    search::fef::RankProgram &_rankProgram;
     search::queryeval::SearchIterator &_searchItr;
     search::fef::LazyValue _scoreFeature;
 
 public:
+    using TaggedHit = IMatchLoopCommunicator::TaggedHit;
+    using TaggedHits = IMatchLoopCommunicator::TaggedHits;
+
     DocumentScorer(search::fef::RankProgram &rankProgram,
                    search::queryeval::SearchIterator &searchItr);
 
@@ -29,6 +36,9 @@ public:
     }
 
     virtual search::feature_t score(uint32_t docId) override;
+
+    // calculate the score of all the given hits (in increasing docId order)
+    void score(TaggedHits &hits);
 };
 
 }
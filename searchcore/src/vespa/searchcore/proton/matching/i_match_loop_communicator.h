@@ -17,6 +17,8 @@ struct IMatchLoopCommunicator {
     using SortedHitSequence = search::queryeval::SortedHitSequence;
     using Hit = SortedHitSequence::Hit;
     using Hits = std::vector<Hit>;
+    using TaggedHit = std::pair<Hit,size_t>;
+    using TaggedHits = std::vector<TaggedHit>;
     struct Matches {
         size_t hits;
         size_t docs;
@@ -28,8 +30,16 @@ struct IMatchLoopCommunicator {
         }
     };
     virtual double estimate_match_frequency(const Matches &matches) = 0;
-    virtual Hits selectBest(SortedHitSequence sortedHits) = 0;
-    virtual RangePair rangeCover(const RangePair &ranges) = 0;
+
+    // select the globally best hits for second phase ranking and
+    // distribute them evenly across all threads. Each hit is tagged
+    // with the id of the thread that produced it.
+    virtual TaggedHits get_second_phase_work(SortedHitSequence sortedHits, size_t thread_id) = 0;
+
+    // hand the re-ranked hits back to the threads that produced them
+    // and calculate the global first and second phase score ranges.
+    virtual std::pair<Hits,RangePair> complete_second_phase(TaggedHits my_results, size_t thread_id) = 0;
+
     virtual ~IMatchLoopCommunicator() {}
 };
 
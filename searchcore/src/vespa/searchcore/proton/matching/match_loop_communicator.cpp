@@ -2,6 +2,8 @@
 
 #include "match_loop_communicator.h"
 #include <vespa/vespalib/util/priority_queue.h>
+#include <algorithm>
+#include <limits>
 
 namespace proton:: matching {
 
@@ -9,10 +11,11 @@ MatchLoopCommunicator::MatchLoopCommunicator(size_t threads, size_t topN)
     : MatchLoopCommunicator(threads, topN, std::unique_ptr<IDiversifier>())
 {}
 MatchLoopCommunicator::MatchLoopCommunicator(size_t threads, size_t topN, std::unique_ptr<IDiversifier> diversifier)
-    : _best_dropped(),
+    : _best_scores(),
+      _best_dropped(),
       _estimate_match_frequency(threads),
-      _selectBest(threads, topN, _best_dropped, std::move(diversifier)),
-      _rangeCover(threads, _best_dropped)
+      _get_second_phase_work(threads, topN, _best_scores, _best_dropped, std::move(diversifier)),
+      _complete_second_phase(threads, _best_scores, _best_dropped)
 {}
 MatchLoopCommunicator::~MatchLoopCommunicator() = default;
 
@@ -33,24 +36,32 @@ MatchLoopCommunicator::EstimateMatchFrequency::mingle()
     }
 }
 
-MatchLoopCommunicator::SelectBest::SelectBest(size_t n, size_t topN_in, BestDropped &best_dropped_in, std::unique_ptr<IDiversifier> diversifier)
-    : vespalib::Rendezvous<SortedHitSequence, Hits>(n),
+MatchLoopCommunicator::GetSecondPhaseWork::GetSecondPhaseWork(size_t n, size_t topN_in, Range &best_scores_in, BestDropped &best_dropped_in, std::unique_ptr<IDiversifier> diversifier)
+    : vespalib::Rendezvous<SortedHitSequence, TaggedHits>(n),
       topN(topN_in),
+      best_scores(best_scores_in),
       best_dropped(best_dropped_in),
       _diversifier(std::move(diversifier))
 {}
-MatchLoopCommunicator::SelectBest::~SelectBest() = default;
+MatchLoopCommunicator::GetSecondPhaseWork::~GetSecondPhaseWork() = default;
 
 template<typename Q, typename F>
 void
-MatchLoopCommunicator::SelectBest::mingle(Q &queue, F &&accept)
+MatchLoopCommunicator::GetSecondPhaseWork::mingle(Q &queue, F &&accept)
 {
+    best_scores = Range();
     best_dropped.valid = false;
     for (size_t picked = 0; picked < topN && !queue.empty(); ) {
         uint32_t i = queue.front();
         const Hit & hit = in(i).get();
         if (accept(hit.first)) {
-            out(i).push_back(hit);
+            // hits are picked in order of decreasing score
+            if (picked == 0) {
+                best_scores = Range(hit.second, hit.second);
+            } else {
+                best_scores.low = hit.second;
+            }
+            out(picked % size()).emplace_back(hit, i);
             ++picked;
         } else if (!best_dropped.valid) {
             best_dropped.valid = true;
@@ -66,13 +77,13 @@ MatchLoopCommunicator::SelectBest::mingle(Q &queue, F &&accept)
 }
 
 void
-MatchLoopCommunicator::SelectBest::mingle()
+MatchLoopCommunicator::GetSecondPhaseWork::mingle()
 {
-    size_t est_out = (topN / size()) + 16;
+    size_t est_out = (topN / size()) + 1;
     vespalib::PriorityQueue<uint32_t, SelectCmp> queue(SelectCmp(*this));
     for (size_t i = 0; i < size(); ++i) {
+        out(i).reserve(est_out);
         if (in(i).valid()) {
-            out(i).reserve(est_out);
             queue.push(i);
         }
     }
@@ -83,30 +94,34 @@ MatchLoopCommunicator::SelectBest::mingle()
     }
 }
 
+MatchLoopCommunicator::CompleteSecondPhase::~CompleteSecondPhase() = default;
+
 void
-MatchLoopCommunicator::RangeCover::mingle()
+MatchLoopCommunicator::CompleteSecondPhase::mingle()
 {
-    size_t i = 0;
-    while (i < size() && (!in(i).first.isValid() || !in(i).second.isValid())) {
-        ++i;
-    }
-    if (i < size()) {
-        RangePair result = in(i++);
-        for (; i < size(); ++i) {
-            if (in(i).first.isValid() && in(i).second.isValid()) {
-                result.first.low = std::min(result.first.low, in(i).first.low);
-                result.first.high = std::max(result.first.high, in(i).first.high);
-                result.second.low = std::min(result.second.low, in(i).second.low);
-                result.second.high = std::max(result.second.high, in(i).second.high);
-            }
+    RangePair ranges;
+    Range &final_scores = ranges.second;
+    final_scores = Range(std::numeric_limits<search::feature_t>::max(),
+                         -std::numeric_limits<search::feature_t>::max());
+    for (size_t i = 0; i < size(); ++i) {
+        for (const auto &[hit, tag]: in(i)) {
+            out(tag).first.push_back(hit);
+            final_scores.low = std::min(final_scores.low, hit.second);
+            final_scores.high = std::max(final_scores.high, hit.second);
         }
+    }
+    if (final_scores.isValid()) {
+        ranges.first = best_scores;
         if (best_dropped.valid) {
-            result.first.low = std::max(result.first.low, best_dropped.score);
-            result.first.high = std::max(result.first.low, result.first.high);
-        }
-        for (size_t j = 0; j < size(); ++j) {
-            out(j) = result;
+            ranges.first.low = std::max(ranges.first.low, best_dropped.score);
+            ranges.first.high = std::max(ranges.first.low, ranges.first.high);
         }
+    } else {
+        ranges = RangePair();
+    }
+    for (size_t i = 0; i < size(); ++i) {
+        std::sort(out(i).first.begin(), out(i).first.end()); // sort on docId
+        out(i).second = ranges;
     }
 }
 
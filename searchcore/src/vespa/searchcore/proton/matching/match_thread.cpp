@@ -77,6 +77,7 @@ MatchThread::Context::Context(double rankDropLimit, MatchTools &tools, HitCollec
       _score_feature(get_score_feature(tools.rank_program())),
       _ranking(tools.rank_program()),
       _rankDropLimit(rankDropLimit),
+      _batched(tools.rank_program().batch_size() > 0),
       _hits(hits),
       _doom(tools.getDoom())
 {
@@ -85,7 +86,33 @@ MatchThread::Context::Context(double rankDropLimit, MatchTools &tools, HitCollec
 template <bool use_rank_drop_limit>
 void
 MatchThread::Context::rankHit(uint32_t docId) {
-    double score = _score_feature.as_number(docId);
+    if (_batched) {
+        _ranking.add_to_batch(docId);
+        if (_ranking.batch_full()) {
+            rankBatch<use_rank_drop_limit>();
+        }
+    } else {
+        addScoredHit<use_rank_drop_limit>(docId, _score_feature.as_number(docId));
+    }
+}
+
+template <bool use_rank_drop_limit>
+void
+MatchThread::Context::rankBatch() {
+    auto docids = _ranking.batch_docids();
+    if (docids.empty()) {
+        return;
+    }
+    auto scores = _ranking.execute_batch();
+    for (size_t i = 0; i < docids.size(); ++i) {
+        addScoredHit<use_rank_drop_limit>(docids[i], scores[i]);
+    }
+    _ranking.clear_batch();
+}
+
+template <bool use_rank_drop_limit>
+void
+MatchThread::Context::addScoredHit(uint32_t docId, double score) {
     // convert NaN and Inf scores to -Inf
     if (__builtin_expect(std::isnan(score) || std::isinf(score), false)) {
         score = -HUGE_VAL;
@@ -175,6 +202,9 @@ MatchThread::inner_match_loop(Context &context, MatchTools &tools, DocidRange &d
             docId = Strategy::seek_next(*search, docId + 1);
         }
     }
+    if (do_rank) {
+        context.rankBatch<use_rank_drop_limit>();
+    }
     return docId;
 }
 
@@ -293,35 +323,34 @@ MatchThread::findMatches(MatchTools &tools)
     trace->addEvent(4, "Start match and first phase rank");
     match_loop_helper(tools, hits);
     if (tools.has_second_phase_rank()) {
-        { // 2nd phase ranking
-            trace->addEvent(4, "Start second phase rerank");
-            tools.setup_second_phase();
-            DocidRange docid_range = scheduler.total_span(thread_id);
-            tools.search().initRange(docid_range.begin, docid_range.end);
-            auto sorted_hit_seq = matchToolsFactory.should_diversify()
-                                  ? hits.getSortedHitSequence(matchParams.arraySize)
-                                  : hits.getSortedHitSequence(matchParams.heapSize);
-            trace->addEvent(5, "Synchronize before second phase rerank");
-            WaitTimer select_best_timer(wait_time_s);
-            auto kept_hits = communicator.selectBest(sorted_hit_seq);
-            select_best_timer.done();
+        trace->addEvent(4, "Start second phase rerank");
+        tools.setup_second_phase();
+        // any document may be given to this thread for re-ranking
+        DocidRange docid_range(1, matchParams.numDocs);
+        tools.search().initRange(docid_range.begin, docid_range.end);
+        auto sorted_hit_seq = matchToolsFactory.should_diversify()
+                              ? hits.getSortedHitSequence(matchParams.arraySize)
+                              : hits.getSortedHitSequence(matchParams.heapSize);
+        trace->addEvent(5, "Synchronize before second phase rerank");
+        WaitTimer get_second_phase_work_timer(wait_time_s);
+        auto my_work = communicator.get_second_phase_work(sorted_hit_seq, thread_id);
+        get_second_phase_work_timer.done();
+        if (tools.getDoom().hard_doom()) {
+            my_work.clear();
+        }
+        if (!my_work.empty()) {
             DocumentScorer scorer(tools.rank_program(), tools.search());
-            if (tools.getDoom().hard_doom()) {
-                kept_hits.clear();
-            }
-            uint32_t reRanked = hits.reRank(scorer, std::move(kept_hits));
-            if (auto onReRankTask = matchToolsFactory.createOnReRankTask()) {
-                onReRankTask->run(hits.getReRankedHits());
-            }
-            thread_stats.docsReRanked(reRanked);
+            scorer.score(my_work);
         }
-        { // rank scaling
-            trace->addEvent(5, "Synchronize before rank scaling");
-            auto my_ranges = hits.getRanges();
-            WaitTimer range_cover_timer(wait_time_s);
-            auto ranges = communicator.rangeCover(my_ranges);
-            range_cover_timer.done();
-            hits.setRanges(ranges);
+        thread_stats.docsReRanked(my_work.size());
+        trace->addEvent(5, "Synchronize before rank scaling");
+        WaitTimer complete_second_phase_timer(wait_time_s);
+        auto [kept_hits, ranges] = communicator.complete_second_phase(std::move(my_work), thread_id);
+        complete_second_phase_timer.done();
+        hits.setReRankedHits(std::move(kept_hits));
+        hits.setRanges(ranges);
+        if (auto onReRankTask = matchToolsFactory.createOnReRankTask()) {
+            onReRankTask->run(hits.getReRankedHits());
         }
     }
     trace->addEvent(4, "Create result set");
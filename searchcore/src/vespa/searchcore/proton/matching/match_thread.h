@@ -70,6 +70,8 @@ private:
                 uint32_t num_threads) __attribute__((noinline));
         template <bool use_rank_drop_limit>
         void rankHit(uint32_t docId);
+        template <bool use_rank_drop_limit>
+        void rankBatch() __attribute__((noinline));
         void addHit(uint32_t docId) { _hits.addHit(docId, search::zero_rank_value); }
         bool isBelowLimit() const { return matches < _matches_limit; }
         bool    isAtLimit() const { return matches == _matches_limit; }
@@ -77,10 +79,14 @@ private:
         vespalib::duration timeLeft() const { return _doom.soft_left(); }
         uint32_t        matches;
     private:
+        template <bool use_rank_drop_limit>
+        void addScoredHit(uint32_t docId, double score);
+
         uint32_t        _matches_limit;
         LazyValue       _score_feature;
         RankProgram    &_ranking;
         double          _rankDropLimit;
+        bool            _batched;
         HitCollector   &_hits;
         const Doom     &_doom;
     };
@@ -69,7 +69,8 @@ extractDiversityParams(const RankSetup &rankSetup, const Properties &rankPropert
 AttributeBlueprintParams
 extractAttributeBlueprintParams(const RankSetup& rank_setup, const Properties &rankProperties)
 {
-    return AttributeBlueprintParams(NearestNeighborBruteForceLimit::lookup(rankProperties, rank_setup.get_nearest_neighbor_brute_force_limit()));
+    return AttributeBlueprintParams(NearestNeighborBruteForceLimit::lookup(rankProperties, rank_setup.get_nearest_neighbor_brute_force_limit()),
+                                    NearestNeighborTargetHitsMaxAdjustmentFactor::lookup(rankProperties, rank_setup.get_nearest_neighbor_target_hits_max_adjustment_factor()));
 }
 
 } // namespace proton::matching::<unnamed>
@@ -132,12 +133,15 @@ MatchTools::setup_first_phase()
 {
     setup(_rankSetup.create_first_phase_program(),
           TermwiseLimit::lookup(_queryEnv.getProperties(), _rankSetup.get_termwise_limit()));
+    _rank_program->setup_batch(RankBatchSize::lookup(_queryEnv.getProperties(), _rankSetup.get_rank_batch_size()));
 }
 
 void
 MatchTools::setup_second_phase()
 {
     setup(_rankSetup.create_second_phase_program());
+    _rank_program->setup_batch(SecondPhaseRankBatchSize::lookup(_queryEnv.getProperties(),
+                                                                _rankSetup.get_second_phase_rank_batch_size()));
 }
 
 void
@@ -196,6 +200,7 @@ MatchToolsFactory(QueryLimiter               & queryLimiter,
         trace.addEvent(5, "MTF: Handle Global Filters");
         double global_filter_limit = GlobalFilterLimit::lookup(rankProperties, rankSetup.get_global_filter_limit());
         _query.handle_global_filters(searchContext.getDocIdLimit(), global_filter_limit);
+        _query.trace_nearest_neighbor_searches(trace);
         _query.freeze();
         trace.addEvent(5, "MTF: prepareSharedState");
         _rankSetup.prepareSharedState(_queryEnv, _queryEnv.getObjectStore());
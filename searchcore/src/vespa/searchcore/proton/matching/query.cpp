@@ -10,8 +10,12 @@
 #include <vespa/document/datatype/positiondatatype.h>
 #include <vespa/searchlib/common/geo_location_spec.h>
 #include <vespa/searchlib/common/geo_location_parser.h>
+#include <vespa/searchlib/engine/trace.h>
 #include <vespa/searchlib/parsequery/stackdumpiterator.h>
 #include <vespa/searchlib/queryeval/intermediate_blueprints.h>
+#include <vespa/searchlib/queryeval/nearest_neighbor_blueprint.h>
+#include <vespa/searchlib/tensor/dense_tensor_attribute.h>
+#include <vespa/vespalib/util/stringfmt.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".proton.matching.query");
@@ -34,6 +38,7 @@ using search::queryeval::AndNotBlueprint;
 using search::queryeval::RankBlueprint;
 using search::queryeval::IntermediateBlueprint;
 using search::queryeval::Blueprint;
+using search::queryeval::NearestNeighborBlueprint;
 using search::queryeval::IRequestContext;
 using search::queryeval::SearchIterator;
 using vespalib::string;
@@ -149,6 +154,21 @@ lastConsequtiveRankOrAndNot(Blueprint * blueprint) {
     return prev;
 }
 
+void
+trace_nearest_neighbor_blueprints(const Blueprint &blueprint, search::engine::Trace &trace)
+{
+    if (const auto *nns = dynamic_cast<const NearestNeighborBlueprint *>(&blueprint)) {
+        trace.addEvent(5, vespalib::make_string("Nearest neighbor search on '%s': algorithm=%s, target_hits=%u, explore_k=%u",
+                                                nns->get_attribute_tensor().getName().c_str(),
+                                                NearestNeighborBlueprint::algorithm_name(nns->get_algorithm()),
+                                                nns->get_target_num_hits(), nns->get_explore_k()));
+    } else if (const auto *intermediate = dynamic_cast<const IntermediateBlueprint *>(&blueprint)) {
+        for (size_t i = 0; i < intermediate->childCnt(); ++i) {
+            trace_nearest_neighbor_blueprints(intermediate->getChild(i), trace);
+        }
+    }
+}
+
 }  // namespace
 
 Query::Query() = default;
@@ -258,6 +278,14 @@ Query::handle_global_filters(uint32_t docid_limit, double global_filter_limit)
     }
 }
 
+void
+Query::trace_nearest_neighbor_searches(search::engine::Trace &trace) const
+{
+    if (trace.shouldTrace(5)) {
+        trace_nearest_neighbor_blueprints(*_blueprint, trace);
+    }
+}
+
 void
 Query::freeze()
 {
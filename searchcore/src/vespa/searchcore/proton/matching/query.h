@@ -10,6 +10,8 @@
 #include <vespa/searchlib/queryeval/blueprint.h>
 #include <vespa/searchlib/queryeval/irequestcontext.h>
 
+namespace search::engine { class Trace; }
+
 namespace proton::matching {
 
 class ViewResolver;
@@ -93,6 +95,12 @@ public:
     void optimize();
     void fetchPostings();
     void handle_global_filters(uint32_t docidLimit, double global_filter_limit);
+
+    /**
+     * Add a trace event for each nearest neighbor search in the query,
+     * telling which algorithm was chosen for it.
+     **/
+    void trace_nearest_neighbor_searches(search::engine::Trace &trace) const;
     void freeze();
 
     /**
@@ -0,0 +1,27 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "compile_cache_metrics.h"
+
+namespace proton {
+
+CompileCacheMetrics::CompileCacheMetrics(metrics::MetricSet *parent)
+    : MetricSet("compile_cache", {}, "Metrics for the on-disk cache of compiled ranking expressions", parent),
+      hits("hits", {}, "The number of compilations that used machine code from the cache", this),
+      misses("misses", {}, "The number of compilations that did not find machine code in the cache", this),
+      errors("errors", {}, "The number of failures to read or write cached machine code", this),
+      lastStats()
+{
+}
+
+CompileCacheMetrics::~CompileCacheMetrics() = default;
+
+void
+CompileCacheMetrics::update(const vespalib::eval::CodeCache::Stats &stats)
+{
+    hits.inc(stats.hits - lastStats.hits);
+    misses.inc(stats.misses - lastStats.misses);
+    errors.inc(stats.errors - lastStats.errors);
+    lastStats = stats;
+}
+
+} // namespace proton
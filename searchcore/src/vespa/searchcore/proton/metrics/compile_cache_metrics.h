@@ -0,0 +1,26 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/metrics/metrics.h>
+#include <vespa/eval/eval/llvm/code_cache.h>
+
+namespace proton {
+
+/**
+ * Metrics for the on-disk cache of machine code generated when
+ * compiling ranking expressions.
+ */
+struct CompileCacheMetrics : metrics::MetricSet
+{
+    metrics::LongCountMetric hits;
+    metrics::LongCountMetric misses;
+    metrics::LongCountMetric errors;
+    vespalib::eval::CodeCache::Stats lastStats;
+
+    CompileCacheMetrics(metrics::MetricSet *parent);
+    ~CompileCacheMetrics();
+    void update(const vespalib::eval::CodeCache::Stats &stats);
+};
+
+} // namespace proton
@@ -21,7 +21,8 @@ ContentProtonMetrics::ContentProtonMetrics()
     : metrics::MetricSet("content.proton", {}, "Search engine metrics", nullptr),
       transactionLog(this),
       resourceUsage(this),
-      executor(this)
+      executor(this),
+      compileCache(this)
 {
 }
 
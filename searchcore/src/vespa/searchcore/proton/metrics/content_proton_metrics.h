@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "compile_cache_metrics.h"
 #include "executor_metrics.h"
 #include "resource_usage_metrics.h"
 #include "trans_log_server_metrics.h"
@@ -35,6 +36,7 @@ struct ContentProtonMetrics : metrics::MetricSet
     TransLogServerMetrics transactionLog;
     ResourceUsageMetrics resourceUsage;
     ProtonExecutorMetrics executor;
+    CompileCacheMetrics compileCache;
 
     ContentProtonMetrics();
     ~ContentProtonMetrics();
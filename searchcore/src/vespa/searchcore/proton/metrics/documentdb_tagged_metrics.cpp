@@ -66,13 +66,25 @@ DocumentDBTaggedMetrics::SubDBMetrics::DocumentStoreMetrics::CacheMetrics::Cache
 
 DocumentDBTaggedMetrics::SubDBMetrics::DocumentStoreMetrics::CacheMetrics::~CacheMetrics() = default;
 
+DocumentDBTaggedMetrics::SubDBMetrics::DocumentStoreMetrics::AsyncReadMetrics::AsyncReadMetrics(MetricSet *parent)
+    : MetricSet("async_read", {}, "Metrics for batched asynchronous reads from the document store", parent),
+      batches("batches", {}, "Number of batches of reads issued", this),
+      reads("reads", {}, "Number of reads issued in batches", this),
+      queueDepth("queue_depth", {}, "Number of reads in flight, sampled each time reads are submitted", this),
+      maxQueueDepth("max_queue_depth", {}, "Max number of reads in flight since startup", this)
+{
+}
+
+DocumentDBTaggedMetrics::SubDBMetrics::DocumentStoreMetrics::AsyncReadMetrics::~AsyncReadMetrics() = default;
+
 DocumentDBTaggedMetrics::SubDBMetrics::DocumentStoreMetrics::DocumentStoreMetrics(MetricSet *parent)
     : MetricSet("document_store", {}, "Document store metrics for this document sub DB", parent),
       diskUsage("disk_usage", {}, "Disk space usage in bytes", this),
       diskBloat("disk_bloat", {}, "Disk space bloat in bytes", this),
       maxBucketSpread("max_bucket_spread", {}, "Max bucket spread in underlying files (sum(unique buckets in each chunk)/unique buckets in file)", this),
       memoryUsage(this),
-      cache(this)
+      cache(this),
+      asyncRead(this)
 {
 }
 
@@ -99,11 +111,26 @@ DocumentDBTaggedMetrics::AttributeMetrics::ResourceUsageMetrics::ResourceUsageMe
 
 DocumentDBTaggedMetrics::AttributeMetrics::ResourceUsageMetrics::~ResourceUsageMetrics() = default;
 
+DocumentDBTaggedMetrics::IndexMetrics::PostingListCacheMetrics::PostingListCacheMetrics(MetricSet *parent)
+    : MetricSet("posting_list_cache", {}, "Metrics for the cache of posting lists and bit vectors read from disk indexes", parent),
+      memoryUsage("memory_usage", {}, "Memory usage of the cache (in bytes)", this),
+      elements("elements", {}, "Number of elements in the cache", this),
+      hitRate("hit_rate", {}, "Rate of posting list hits in the cache compared to number of posting list lookups", this),
+      lookups("lookups", {}, "Number of posting list lookups in the cache (hits + misses)", this),
+      invalidations("invalidations", {}, "Number of invalidations (erased elements) in the cache. ", this),
+      bitVectorHitRate("bit_vector_hit_rate", {}, "Rate of bit vector hits in the cache compared to number of bit vector lookups", this),
+      bitVectorLookups("bit_vector_lookups", {}, "Number of bit vector lookups in the cache (hits + misses)", this)
+{
+}
+
+DocumentDBTaggedMetrics::IndexMetrics::PostingListCacheMetrics::~PostingListCacheMetrics() = default;
+
 DocumentDBTaggedMetrics::IndexMetrics::IndexMetrics(MetricSet *parent)
     : MetricSet("index", {}, "Index metrics (memory and disk) for this document db", parent),
       diskUsage("disk_usage", {}, "Disk space usage in bytes", this),
       memoryUsage(this),
-      docsInMemory("docs_in_memory", {}, "Number of documents in memory index", this)
+      docsInMemory("docs_in_memory", {}, "Number of documents in memory index", this),
+      postingListCache(this)
 {
 }
 
@@ -62,11 +62,23 @@ struct DocumentDBTaggedMetrics : metrics::MetricSet
                 ~CacheMetrics() override;
             };
 
+            struct AsyncReadMetrics : metrics::MetricSet
+            {
+                metrics::LongCountMetric batches;
+                metrics::LongCountMetric reads;
+                metrics::LongAverageMetric queueDepth;
+                metrics::LongValueMetric maxQueueDepth;
+
+                AsyncReadMetrics(metrics::MetricSet *parent);
+                ~AsyncReadMetrics() override;
+            };
+
             metrics::LongValueMetric diskUsage;
             metrics::LongValueMetric diskBloat;
             metrics::DoubleValueMetric maxBucketSpread;
             MemoryUsageMetrics memoryUsage;
             CacheMetrics cache;
+            AsyncReadMetrics asyncRead;
 
             DocumentStoreMetrics(metrics::MetricSet *parent);
             ~DocumentStoreMetrics() override;
@@ -101,9 +113,24 @@ struct DocumentDBTaggedMetrics : metrics::MetricSet
 
     struct IndexMetrics : metrics::MetricSet
     {
+        struct PostingListCacheMetrics : metrics::MetricSet
+        {
+            metrics::LongValueMetric memoryUsage;
+            metrics::LongValueMetric elements;
+            metrics::LongAverageMetric hitRate;
+            metrics::LongCountMetric lookups;
+            metrics::LongCountMetric invalidations;
+            metrics::LongAverageMetric bitVectorHitRate;
+            metrics::LongCountMetric bitVectorLookups;
+
+            PostingListCacheMetrics(metrics::MetricSet *parent);
+            ~PostingListCacheMetrics() override;
+        };
+
         metrics::LongValueMetric diskUsage;
         MemoryUsageMetrics memoryUsage;
         metrics::LongValueMetric docsInMemory;
+        PostingListCacheMetrics postingListCache;
 
         IndexMetrics(metrics::MetricSet *parent);
         ~IndexMetrics() override;
@@ -13,7 +13,11 @@ TransLogServerMetrics::DomainMetrics::DomainMetrics(metrics::MetricSet *parent,
             "Transaction log metrics for a document type", parent),
       entries("entries", {}, "The current number of entries in the transaction log", this),
       diskUsage("disk_usage", {}, "The disk usage (in bytes) of the transaction log", this),
-      replayTime("replay_time", {}, "The replay time (in seconds) of the transaction log during start-up", this)
+      replayTime("replay_time", {}, "The replay time (in seconds) of the transaction log during start-up", this),
+      commitBatches("commit_batches", {}, "The number of batches of commits written to the transaction log", this),
+      commitBatchSize("commit_batch_size", {}, "The average number of commits written per batch", this),
+      syncLatency("sync_latency", {}, "The average time (in seconds) used to sync a batch of commits", this),
+      lastCommitStats()
 {
 }
 
@@ -25,6 +29,17 @@ TransLogServerMetrics::DomainMetrics::update(const DomainInfo &stats)
     entries.set(stats.numEntries);
     diskUsage.set(stats.byteSize);
     replayTime.set(stats.maxSessionRunTime.count());
+    const auto &commitStats = stats.commitStats;
+    uint64_t batches = commitStats.batches - lastCommitStats.batches;
+    uint64_t syncs = commitStats.syncs - lastCommitStats.syncs;
+    commitBatches.inc(batches);
+    if (batches > 0) {
+        commitBatchSize.set(double(commitStats.commits - lastCommitStats.commits) / batches);
+    }
+    if (syncs > 0) {
+        syncLatency.set((commitStats.syncTime - lastCommitStats.syncTime).count() / syncs);
+    }
+    lastCommitStats = commitStats;
 }
 
 void
@@ -18,6 +18,10 @@ public:
         metrics::LongValueMetric entries;
         metrics::LongValueMetric diskUsage;
         metrics::DoubleValueMetric replayTime;
+        metrics::LongCountMetric commitBatches;
+        metrics::DoubleAverageMetric commitBatchSize;
+        metrics::DoubleAverageMetric syncLatency;
+        search::transactionlog::CommitStats lastCommitStats;
 
         typedef std::unique_ptr<DomainMetrics> UP;
         DomainMetrics(metrics::MetricSet *parent, const vespalib::string &documentType);
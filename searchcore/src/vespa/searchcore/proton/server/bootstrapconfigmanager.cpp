@@ -89,6 +89,7 @@ BootstrapConfigManager::update(const ConfigSnapshot & snapshot)
         tune._summary._write.setFromConfig<ProtonConfig::Summary::Write>(conf.summary.write.io);
         tune._summary._seqRead.setFromConfig<ProtonConfig::Summary::Read>(conf.summary.read.io);
         tune._summary._randRead.setFromConfig<ProtonConfig::Summary::Read, ProtonConfig::Summary::Read::Mmap>(conf.summary.read.io, conf.summary.read.mmap);
+        tune._summary._randRead.setAsyncQueueDepth(std::max(0, conf.summary.read.async.queuedepth));
 
         newProtonConfig = ProtonConfigSP(protonConfig.release());
         newTuneFileDocumentDB = tuneFileDocumentDB;
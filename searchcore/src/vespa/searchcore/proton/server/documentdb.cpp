@@ -85,7 +85,8 @@ makeSubDBConfig(const ProtonConfig::Distribution & distCfg, const Allocation & a
 
 index::IndexConfig
 makeIndexConfig(const ProtonConfig::Index & cfg) {
-    return index::IndexConfig(WarmupConfig(vespalib::from_s(cfg.warmup.time), cfg.warmup.unpack), cfg.maxflushed, cfg.cache.size);
+    return index::IndexConfig(WarmupConfig(vespalib::from_s(cfg.warmup.time), cfg.warmup.unpack), cfg.maxflushed,
+                              cfg.cache.size, cfg.cache.postinglist.maxbytes);
 }
 
 ProtonConfig::Documentdb _G_defaultProtonDocumentDBConfig;
@@ -69,12 +69,62 @@ updateDiskUsageMetric(metrics::LongValueMetric &metric, uint64_t diskUsage, Tota
 }
 
 void
-updateIndexMetrics(DocumentDBTaggedMetrics &metrics, const search::SearchableStats &stats, TotalStats &totalStats)
+updateCacheHitRate(const CacheStats &current, const CacheStats &last,
+                   metrics::LongAverageMetric &cacheHitRate)
+{
+    if (current.lookups() < last.lookups() || current.hits < last.hits) {
+        LOG(warning, "Not adding cache hit rate metrics as values calculated "
+                     "are corrupt. current.lookups=%zu, last.lookups=%zu, current.hits=%zu, last.hits=%zu.",
+            current.lookups(), last.lookups(), current.hits, last.hits);
+    } else {
+        if ((current.lookups() - last.lookups()) > 0xffffffffull
+            || (current.hits - last.hits) > 0xffffffffull)
+        {
+            LOG(warning, "Cache hit rate metrics to add are suspiciously high."
+                         " lookups diff=%zu, hits diff=%zu.",
+                current.lookups() - last.lookups(), current.hits - last.hits);
+        }
+        cacheHitRate.addTotalValueWithCount(current.hits - last.hits, current.lookups() - last.lookups());
+    }
+}
+
+void
+updateCountMetric(uint64_t currVal, uint64_t lastVal, metrics::LongCountMetric &metric)
+{
+    uint64_t delta = (currVal >= lastVal) ? (currVal - lastVal) : 0;
+    metric.inc(delta);
+}
+
+void
+updatePostingListCacheMetrics(DocumentDBTaggedMetrics::IndexMetrics::PostingListCacheMetrics &metrics,
+                              const CacheStats &cacheStats, CacheStats &lastCacheStats,
+                              const CacheStats &bitVectorStats, CacheStats &lastBitVectorStats,
+                              TotalStats &totalStats)
+{
+    totalStats.memoryUsage.incAllocatedBytes(cacheStats.memory_used);
+    metrics.memoryUsage.set(cacheStats.memory_used);
+    metrics.elements.set(cacheStats.elements);
+    updateCacheHitRate(cacheStats, lastCacheStats, metrics.hitRate);
+    updateCountMetric(cacheStats.lookups(), lastCacheStats.lookups(), metrics.lookups);
+    updateCountMetric(cacheStats.invalidations, lastCacheStats.invalidations, metrics.invalidations);
+    lastCacheStats = cacheStats;
+    updateCacheHitRate(bitVectorStats, lastBitVectorStats, metrics.bitVectorHitRate);
+    updateCountMetric(bitVectorStats.lookups(), lastBitVectorStats.lookups(), metrics.bitVectorLookups);
+    lastBitVectorStats = bitVectorStats;
+}
+
+void
+updateIndexMetrics(DocumentDBTaggedMetrics &metrics, const search::SearchableStats &stats,
+                   CacheStats &lastPostingListCacheStats, CacheStats &lastBitVectorCacheStats,
+                   TotalStats &totalStats)
 {
     DocumentDBTaggedMetrics::IndexMetrics &indexMetrics = metrics.index;
     updateDiskUsageMetric(indexMetrics.diskUsage, stats.sizeOnDisk(), totalStats);
     updateMemoryUsageMetrics(indexMetrics.memoryUsage, stats.memoryUsage(), totalStats);
     indexMetrics.docsInMemory.set(stats.docsInMemory());
+    updatePostingListCacheMetrics(indexMetrics.postingListCache, stats.postingListCacheStats(),
+                                  lastPostingListCacheStats, stats.bitVectorCacheStats(),
+                                  lastBitVectorCacheStats, totalStats);
 }
 
 struct TempAttributeMetric
@@ -208,37 +258,11 @@ updateDocumentsMetrics(DocumentDBTaggedMetrics &metrics, const DocumentSubDBColl
     docsMetrics.removed.set(removed);
 }
 
-void
-updateDocumentStoreCacheHitRate(const CacheStats &current, const CacheStats &last,
-                                metrics::LongAverageMetric &cacheHitRate)
-{
-    if (current.lookups() < last.lookups() || current.hits < last.hits) {
-        LOG(warning, "Not adding document store cache hit rate metrics as values calculated "
-                     "are corrupt. current.lookups=%zu, last.lookups=%zu, current.hits=%zu, last.hits=%zu.",
-            current.lookups(), last.lookups(), current.hits, last.hits);
-    } else {
-        if ((current.lookups() - last.lookups()) > 0xffffffffull
-            || (current.hits - last.hits) > 0xffffffffull)
-        {
-            LOG(warning, "Document store cache hit rate metrics to add are suspiciously high."
-                         " lookups diff=%zu, hits diff=%zu.",
-                current.lookups() - last.lookups(), current.hits - last.hits);
-        }
-        cacheHitRate.addTotalValueWithCount(current.hits - last.hits, current.lookups() - last.lookups());
-    }
-}
-
-void
-updateCountMetric(uint64_t currVal, uint64_t lastVal, metrics::LongCountMetric &metric)
-{
-    uint64_t delta = (currVal >= lastVal) ? (currVal - lastVal) : 0;
-    metric.inc(delta);
-}
-
 void
 updateDocumentStoreMetrics(DocumentDBTaggedMetrics::SubDBMetrics::DocumentStoreMetrics &metrics,
                            const IDocumentSubDB *subDb,
                            CacheStats &lastCacheStats,
+                           search::AsyncReadStats &lastAsyncReadStats,
                            TotalStats &totalStats)
 {
     const ISummaryManager::SP &summaryMgr = subDb->getSummaryManager();
@@ -253,19 +277,34 @@ updateDocumentStoreMetrics(DocumentDBTaggedMetrics::SubDBMetrics::DocumentStoreM
     totalStats.memoryUsage.incAllocatedBytes(cacheStats.memory_used);
     metrics.cache.memoryUsage.set(cacheStats.memory_used);
     metrics.cache.elements.set(cacheStats.elements);
-    updateDocumentStoreCacheHitRate(cacheStats, lastCacheStats, metrics.cache.hitRate);
+    updateCacheHitRate(cacheStats, lastCacheStats, metrics.cache.hitRate);
     updateCountMetric(cacheStats.lookups(), lastCacheStats.lookups(), metrics.cache.lookups);
     updateCountMetric(cacheStats.invalidations, lastCacheStats.invalidations, metrics.cache.invalidations);
     lastCacheStats = cacheStats;
+
+    search::AsyncReadStats asyncReadStats = backingStore.getAsyncReadStats();
+    updateCountMetric(asyncReadStats.batches, lastAsyncReadStats.batches, metrics.asyncRead.batches);
+    updateCountMetric(asyncReadStats.reads, lastAsyncReadStats.reads, metrics.asyncRead.reads);
+    if (asyncReadStats.queueDepthSamples > lastAsyncReadStats.queueDepthSamples) {
+        metrics.asyncRead.queueDepth.addTotalValueWithCount(asyncReadStats.queueDepthSum - lastAsyncReadStats.queueDepthSum,
+                                                            asyncReadStats.queueDepthSamples - lastAsyncReadStats.queueDepthSamples);
+    }
+    metrics.asyncRead.maxQueueDepth.set(asyncReadStats.maxQueueDepth);
+    lastAsyncReadStats = asyncReadStats;
 }
 
 void
 updateDocumentStoreMetrics(DocumentDBTaggedMetrics &metrics, const DocumentSubDBCollection &subDBs,
-                           DocumentDBMetricsUpdater::DocumentStoreCacheStats &lastDocStoreCacheStats, TotalStats &totalStats)
+                           DocumentDBMetricsUpdater::DocumentStoreCacheStats &lastDocStoreCacheStats,
+                           DocumentDBMetricsUpdater::DocumentStoreAsyncReadStats &lastDocStoreAsyncReadStats,
+                           TotalStats &totalStats)
 {
-    updateDocumentStoreMetrics(metrics.ready.documentStore, subDBs.getReadySubDB(), lastDocStoreCacheStats.readySubDb, totalStats);
-    updateDocumentStoreMetrics(metrics.removed.documentStore, subDBs.getRemSubDB(), lastDocStoreCacheStats.removedSubDb, totalStats);
-    updateDocumentStoreMetrics(metrics.notReady.documentStore, subDBs.getNotReadySubDB(), lastDocStoreCacheStats.notReadySubDb, totalStats);
+    updateDocumentStoreMetrics(metrics.ready.documentStore, subDBs.getReadySubDB(), lastDocStoreCacheStats.readySubDb,
+                               lastDocStoreAsyncReadStats.readySubDb, totalStats);
+    updateDocumentStoreMetrics(metrics.removed.documentStore, subDBs.getRemSubDB(), lastDocStoreCacheStats.removedSubDb,
+                               lastDocStoreAsyncReadStats.removedSubDb, totalStats);
+    updateDocumentStoreMetrics(metrics.notReady.documentStore, subDBs.getNotReadySubDB(), lastDocStoreCacheStats.notReadySubDb,
+                               lastDocStoreAsyncReadStats.notReadySubDb, totalStats);
 }
 
 template <typename MetricSetType>
@@ -288,12 +327,13 @@ DocumentDBMetricsUpdater::updateMetrics(DocumentDBTaggedMetrics &metrics)
 {
     TotalStats totalStats;
     ExecutorThreadingServiceStats threadingServiceStats = _writeService.getStats();
-    updateIndexMetrics(metrics, _subDBs.getReadySubDB()->getSearchableStats(), totalStats);
+    updateIndexMetrics(metrics, _subDBs.getReadySubDB()->getSearchableStats(), _lastPostingListCacheStats,
+                       _lastBitVectorCacheStats, totalStats);
     updateAttributeMetrics(metrics, _subDBs, totalStats);
     updateMatchingMetrics(metrics, *_subDBs.getReadySubDB());
     updateSessionCacheMetrics(metrics, _sessionManager);
     updateDocumentsMetrics(metrics, _subDBs);
-    updateDocumentStoreMetrics(metrics, _subDBs, _lastDocStoreCacheStats, totalStats);
+    updateDocumentStoreMetrics(metrics, _subDBs, _lastDocStoreCacheStats, _lastDocStoreAsyncReadStats, totalStats);
     updateMiscMetrics(metrics, threadingServiceStats);
 
     metrics.totalMemoryUsage.update(totalStats.memoryUsage);
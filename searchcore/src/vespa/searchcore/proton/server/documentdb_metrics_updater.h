@@ -2,6 +2,7 @@
 #pragma once
 
 #include <vespa/searchcore/proton/metrics/documentdb_tagged_metrics.h>
+#include <vespa/searchlib/docstore/async_read_stats.h>
 #include <vespa/searchlib/docstore/cachestats.h>
 
 namespace proton {
@@ -28,6 +29,13 @@ public:
         DocumentStoreCacheStats() : readySubDb(), notReadySubDb(), removedSubDb() {}
     };
 
+    struct DocumentStoreAsyncReadStats {
+        search::AsyncReadStats readySubDb;
+        search::AsyncReadStats notReadySubDb;
+        search::AsyncReadStats removedSubDb;
+        DocumentStoreAsyncReadStats() : readySubDb(), notReadySubDb(), removedSubDb() {}
+    };
+
 private:
     const DocumentSubDBCollection &_subDBs;
     ExecutorThreadingService &_writeService;
@@ -36,6 +44,11 @@ private:
     const AttributeUsageFilter &_writeFilter;
     // Last updated document store cache statistics. Necessary due to metrics implementation is upside down.
     DocumentStoreCacheStats _lastDocStoreCacheStats;
+    // Last updated document store async read statistics.
+    DocumentStoreAsyncReadStats _lastDocStoreAsyncReadStats;
+    // Last updated posting list cache statistics.
+    search::CacheStats _lastPostingListCacheStats;
+    search::CacheStats _lastBitVectorCacheStats;
 
     void updateMiscMetrics(DocumentDBTaggedMetrics &metrics, const ExecutorThreadingServiceStats &threadingServiceStats);
     void updateAttributeResourceUsageMetrics(DocumentDBTaggedMetrics::AttributeMetrics &metrics);
@@ -195,7 +195,10 @@ deriveConfig(const ProtonConfig::Summary & summary, const ProtonConfig::Flush::M
             .setMaxNumLids(log.maxnumlids)
             .setMaxDiskBloatFactor(std::min(flush.diskbloatfactor, flush.each.diskbloatfactor))
             .setMaxBucketSpread(log.maxbucketspread).setMinFileSizeFactor(log.minfilesizefactor)
+            .setMaxDictionaryBytes(chunk.dictionary.maxbytes)
             .compactCompression(deriveCompression(log.compact.compression))
+            .setCompactThreads(std::max(1, log.compact.threads))
+            .setMaxCompactBytesPerSecond(std::max(0l, log.compact.maxbytespersecond))
             .setFileConfig(fileConfig).disableCrcOnRead(chunk.skipcrconread);
     return LogDocumentStore::Config(config, logConfig);
 }
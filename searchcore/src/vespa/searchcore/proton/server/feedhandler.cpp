@@ -45,6 +45,9 @@ namespace proton {
 
 namespace {
 
+// Max number of transaction log packets decoded ahead of replay.
+constexpr uint32_t MAX_REPLAY_PACKETS_DECODED_AHEAD = 16;
+
 bool
 ignoreOperation(const DocumentOperation &op) {
     return (op.getPrevTimestamp() != 0) && (op.getTimestamp() < op.getPrevTimestamp());
@@ -393,7 +396,8 @@ FeedHandler::replayTransactionLog(SerialNum flushedIndexMgrSerial, SerialNum flu
     assert(_activeFeedView);
     assert(_bucketDBHandler);
     auto state = make_shared<ReplayTransactionLogState>
-                          (getDocTypeName(), _activeFeedView, *_bucketDBHandler, _replayConfig, config_store);
+                          (getDocTypeName(), _activeFeedView, *_bucketDBHandler, _replayConfig, config_store,
+                           _writeService.shared(), MAX_REPLAY_PACKETS_DECODED_AHEAD);
     changeFeedState(state);
     // Resurrected attribute vector might cause oldestFlushedSerial to
     // be lower than _prunedSerialNum, so don't warn for now.
@@ -11,6 +11,8 @@
 #include <vespa/searchlib/common/idestructorcallback.h>
 #include <vespa/vespalib/util/closuretask.h>
 #include <vespa/vespalib/util/lambdatask.h>
+#include <condition_variable>
+#include <mutex>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".proton.server.feedstates");
@@ -140,8 +142,100 @@ void startDispatch(IReplayPacketHandler *packet_handler, const Packet::Entry &en
     packet_handler->optionalCommit(entry.serial());
 }
 
+bool
+canDecodeAhead(const Packet &packet)
+{
+    vespalib::nbostream_longlivedbuf handle(packet.getHandle().data(), packet.getHandle().size());
+    while ( !handle.empty() ) {
+        Packet::Entry entry;
+        entry.deserialize(handle);
+        if ( ! ReplayPacketDispatcher::canDecodeAhead(entry)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * The feed operations of a packet, deserialized by the decode executor.
+ */
+class DecodedPacket {
+    std::vector<std::unique_ptr<FeedOperation>> _ops;
+    std::exception_ptr _error;
+    vespalib::Gate _decoded;
+
+public:
+    DecodedPacket() : _ops(), _error(), _decoded() {}
+
+    void decode(const Packet &packet, const document::DocumentTypeRepo &repo) {
+        try {
+            vespalib::nbostream_longlivedbuf handle(packet.getHandle().data(), packet.getHandle().size());
+            _ops.reserve(packet.size());
+            while ( !handle.empty() ) {
+                Packet::Entry entry;
+                entry.deserialize(handle);
+                _ops.push_back(ReplayPacketDispatcher::decodeEntry(entry, repo));
+            }
+        } catch (...) {
+            _error = std::current_exception();
+        }
+        _decoded.countDown();
+    }
+
+    const std::vector<std::unique_ptr<FeedOperation>> &awaitOperations() {
+        _decoded.await();
+        if (_error) {
+            std::rethrow_exception(_error);
+        }
+        return _ops;
+    }
+};
+
+void
+replayDecodedPacket(IReplayPacketHandler &packet_handler, DecodedPacket &decoded, TlsReplayProgress *progress)
+{
+    // Called in executor thread, in the same order as the packets were received.
+    ReplayPacketDispatcher dispatcher(packet_handler);
+    for (const auto &op : decoded.awaitOperations()) {
+        LOG(spam, "replay decoded operation: serial(%" PRIu64 "), type(%u)", op->getSerialNum(), op->getType());
+        dispatcher.replayOperation(*op);
+        packet_handler.optionalCommit(op->getSerialNum());
+        if (progress != nullptr) {
+            handleProgress(*progress, op->getSerialNum());
+        }
+    }
+}
+
 }  // namespace
 
+/**
+ * Bounds the number of packets that are decoded ahead of replay.
+ */
+class ReplayTransactionLogState::PendingPackets {
+    std::mutex _lock;
+    std::condition_variable _cond;
+    uint32_t _pending;
+    const uint32_t _maxPending;
+
+public:
+    explicit PendingPackets(uint32_t maxPending)
+        : _lock(),
+          _cond(),
+          _pending(0),
+          _maxPending(std::max(1u, maxPending))
+    { }
+    void acquire() {
+        std::unique_lock<std::mutex> guard(_lock);
+        _cond.wait(guard, [this] { return _pending < _maxPending; });
+        ++_pending;
+    }
+    void release() {
+        std::lock_guard<std::mutex> guard(_lock);
+        --_pending;
+        _cond.notify_all();
+    }
+};
+
 ReplayTransactionLogState::ReplayTransactionLogState(
         const vespalib::string &name,
         IFeedView *& feed_view_ptr,
@@ -150,13 +244,53 @@ ReplayTransactionLogState::ReplayTransactionLogState(
         FeedConfigStore &config_store)
     : FeedState(REPLAY_TRANSACTION_LOG),
       _doc_type_name(name),
-      _packet_handler(std::make_unique<TransactionLogReplayPacketHandler>(feed_view_ptr, bucketDBHandler, replay_config, config_store))
+      _packet_handler(std::make_unique<TransactionLogReplayPacketHandler>(feed_view_ptr, bucketDBHandler, replay_config, config_store)),
+      _decodeExecutor(nullptr),
+      _pendingPackets()
 { }
 
+ReplayTransactionLogState::ReplayTransactionLogState(
+        const vespalib::string &name,
+        IFeedView *& feed_view_ptr,
+        IBucketDBHandler &bucketDBHandler,
+        IReplayConfig &replay_config,
+        FeedConfigStore &config_store,
+        Executor &decodeExecutor,
+        uint32_t maxPendingPackets)
+    : FeedState(REPLAY_TRANSACTION_LOG),
+      _doc_type_name(name),
+      _packet_handler(std::make_unique<TransactionLogReplayPacketHandler>(feed_view_ptr, bucketDBHandler, replay_config, config_store)),
+      _decodeExecutor(&decodeExecutor),
+      _pendingPackets(std::make_shared<PendingPackets>(maxPendingPackets))
+{ }
+
+ReplayTransactionLogState::~ReplayTransactionLogState() = default;
+
 void
 ReplayTransactionLogState::receive(const PacketWrapper::SP &wrap, Executor &executor) {
-    EntryHandler closure = makeClosure(&startDispatch, _packet_handler.get());
-    executor.execute(makeLambdaTask([wrap = wrap, dispatch = std::move(closure)] () mutable { handlePacket(*wrap, std::move(dispatch)); }));
+    if (_decodeExecutor == nullptr || ! canDecodeAhead(wrap->packet)) {
+        EntryHandler closure = makeClosure(&startDispatch, _packet_handler.get());
+        executor.execute(makeLambdaTask([wrap = wrap, dispatch = std::move(closure)] () mutable { handlePacket(*wrap, std::move(dispatch)); }));
+        return;
+    }
+    _pendingPackets->acquire();
+    auto decoded = std::make_shared<DecodedPacket>();
+    // No config change can be pending in the executor thread, so the repo stays alive until the packet is decoded.
+    const document::DocumentTypeRepo &repo = _packet_handler->getDeserializeRepo();
+    Executor::Task::UP rejected = _decodeExecutor->execute(makeLambdaTask([decoded, packet = wrap->packet, &repo]() {
+        decoded->decode(packet, repo);
+    }));
+    if (rejected) {
+        rejected->run();
+    }
+    executor.execute(makeLambdaTask([packet_handler = _packet_handler.get(), decoded, progress = wrap->progress,
+                                     pending = _pendingPackets]() {
+        replayDecodedPacket(*packet_handler, *decoded, progress);
+        pending->release();
+    }));
+    // The packet is copied, so the sender can continue with the next packet.
+    wrap->result = RPC::OK;
+    wrap->gate.countDown();
 }
 
 }  // namespace proton
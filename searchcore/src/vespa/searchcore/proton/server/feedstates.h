@@ -43,10 +43,20 @@ public:
 /**
  * The feed handler is replaying the transaction log.
  * Replayed messages from the transaction log are sent to the active feed view.
+ *
+ * When given a decode executor, packets are deserialized into feed operations
+ * by that executor while earlier packets are replayed, with at most
+ * maxPendingPackets packets decoded ahead. Packets with config changes are
+ * replayed without decoding ahead, as later packets must be deserialized
+ * with the new document type repo.
  */
 class ReplayTransactionLogState : public FeedState {
+    class PendingPackets;
+
     vespalib::string _doc_type_name;
     std::unique_ptr<IReplayPacketHandler> _packet_handler;
+    vespalib::Executor *_decodeExecutor;
+    std::shared_ptr<PendingPackets> _pendingPackets;
 
 public:
     ReplayTransactionLogState(const vespalib::string &name,
@@ -54,6 +64,14 @@ public:
             bucketdb::IBucketDBHandler &bucketDBHandler,
             IReplayConfig &replay_config,
             FeedConfigStore &config_store);
+    ReplayTransactionLogState(const vespalib::string &name,
+            IFeedView *& feed_view_ptr,
+            bucketdb::IBucketDBHandler &bucketDBHandler,
+            IReplayConfig &replay_config,
+            FeedConfigStore &config_store,
+            vespalib::Executor &decodeExecutor,
+            uint32_t maxPendingPackets);
+    ~ReplayTransactionLogState() override;
 
     void handleOperation(FeedToken, FeedOperationUP op) override {
         throwExceptionInHandleOperation(_doc_type_name, *op);
@@ -32,23 +32,6 @@ getName(const IFlushHandler & handler, const IFlushTarget & target)
 
 static constexpr uint64_t gibi = UINT64_C(1024) * UINT64_C(1024) * UINT64_C(1024);
 
-uint64_t
-estimateNeededTlsSizeForFlushTarget(const TlsStats &tlsStats, SerialNum flushedSerialNum)
-{
-    if (flushedSerialNum < tlsStats.getFirstSerial()) {
-        return tlsStats.getNumBytes();
-    }
-    int64_t numEntries = tlsStats.getLastSerial() - tlsStats.getFirstSerial() + 1;
-    if (numEntries <= 0) {
-        return 0u;
-    }
-    if (flushedSerialNum >= tlsStats.getLastSerial()) {
-        return 0u;
-    }
-    double bytesPerEntry = static_cast<double>(tlsStats.getNumBytes()) / numEntries;
-    return bytesPerEntry * (tlsStats.getLastSerial() - flushedSerialNum);
-}
-
 }
 
 MemoryFlush::Config::Config()
@@ -88,6 +71,28 @@ MemoryFlush::MemoryFlush()
 
 MemoryFlush::~MemoryFlush() = default;
 
+uint64_t
+MemoryFlush::estimateNeededTlsSizeForFlushTarget(const TlsStats &tlsStats, SerialNum flushedSerialNum)
+{
+    if (flushedSerialNum < tlsStats.getFirstSerial()) {
+        return tlsStats.getNumBytes();
+    }
+    int64_t numEntries = tlsStats.getLastSerial() - tlsStats.getFirstSerial() + 1;
+    if (numEntries <= 0) {
+        return 0u;
+    }
+    if (flushedSerialNum >= tlsStats.getLastSerial()) {
+        return 0u;
+    }
+    double bytesPerEntry = static_cast<double>(tlsStats.getNumBytes()) / numEntries;
+    return bytesPerEntry * (tlsStats.getLastSerial() - flushedSerialNum);
+}
+
+size_t
+MemoryFlush::computeGain(const IFlushTarget::DiskGain & gain) {
+    return std::max(INT64_C(100000000), std::max(gain.getBefore(), gain.getAfter()));
+}
+
 MemoryFlush::Config
 MemoryFlush::getConfig() const
 {
@@ -117,11 +122,6 @@ getOrderName(MemoryFlush::OrderType &orderType)
     return "DEFAULT";
 }
 
-size_t
-computeGain(const IFlushTarget::DiskGain & gain) {
-    return std::max(INT64_C(100000000), std::max(gain.getBefore(), gain.getAfter()));
-}
-
 }
 
 FlushContext::List
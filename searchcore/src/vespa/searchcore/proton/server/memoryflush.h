@@ -7,6 +7,8 @@
 
 namespace proton {
 
+namespace flushengine { class TlsStats; }
+
 class MemoryFlush : public IFlushStrategy
 {
 public:
@@ -59,6 +61,9 @@ private:
         const flushengine::TlsStatsMap &_tlsStatsMap;
     };
 
+protected:
+    vespalib::system_time getStartTime() const { return _startTime; }
+
 public:
     using SP = std::shared_ptr<MemoryFlush>;
 
@@ -73,6 +78,17 @@ public:
 
     void setConfig(const Config &config);
     Config getConfig() const;
+
+    /**
+     * Estimates the part of the transaction log that must be kept for a
+     * target that has flushed up to the given serial number.
+     */
+    static uint64_t estimateNeededTlsSizeForFlushTarget(const flushengine::TlsStats &tlsStats,
+                                                        search::SerialNum flushedSerialNum);
+    /**
+     * Returns the disk size used as base when calculating disk bloat.
+     */
+    static size_t computeGain(const searchcorespi::IFlushTarget::DiskGain &gain);
 };
 
 } // namespace proton
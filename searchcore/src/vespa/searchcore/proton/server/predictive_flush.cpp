@@ -0,0 +1,262 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "predictive_flush.h"
+#include <vespa/searchcore/proton/flushengine/tls_stats_map.h>
+#include <vespa/vespalib/data/slime/cursor.h>
+#include <vespa/vespalib/stllike/asciistream.h>
+#include <algorithm>
+#include <limits>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".proton.server.predictive_flush");
+
+using search::SerialNum;
+using searchcorespi::IFlushTarget;
+using vespalib::slime::Cursor;
+
+namespace proton {
+
+namespace {
+
+struct Estimate
+{
+    FlushContext::SP      ctx;
+    const IFlushHandler * handler;
+    SerialNum             flushedSerial;
+    int64_t               memoryGain;
+    int64_t               diskGain;
+    size_t                candidate;
+    bool                  selected;
+};
+
+/*
+ * Returns how much of the transaction logs must be kept when all selected
+ * targets, and the given target, have been flushed.
+ */
+uint64_t
+tlsSizeToKeep(const std::vector<Estimate> &estimates, const flushengine::TlsStatsMap &tlsStatsMap,
+              const Estimate *flushed)
+{
+    std::map<const IFlushHandler *, SerialNum> oldestUnflushed;
+    for (const auto &estimate : estimates) {
+        auto itr = oldestUnflushed.emplace(estimate.handler, std::numeric_limits<SerialNum>::max()).first;
+        if (!estimate.selected && &estimate != flushed) {
+            itr->second = std::min(itr->second, estimate.flushedSerial);
+        }
+    }
+    uint64_t result = 0;
+    for (const auto &entry : oldestUnflushed) {
+        const flushengine::TlsStats &tlsStats = tlsStatsMap.getTlsStats(entry.first->getName());
+        result += MemoryFlush::estimateNeededTlsSizeForFlushTarget(tlsStats, entry.second);
+    }
+    return result;
+}
+
+double
+pressure(double total, double limit)
+{
+    return (limit > 0.0) ? (total / limit) : 1.0;
+}
+
+}
+
+PredictiveFlush::CostConfig::CostConfig()
+    : fixedFlushCost(16 * 1024 * 1024),
+      timeCost(64 * 1024 * 1024),
+      historyWeight(0.25)
+{ }
+
+PredictiveFlush::CostConfig::CostConfig(double fixedFlushCost_in, double timeCost_in, double historyWeight_in)
+    : fixedFlushCost(fixedFlushCost_in),
+      timeCost(timeCost_in),
+      historyWeight(historyWeight_in)
+{ }
+
+PredictiveFlush::Candidate::Candidate(const vespalib::string &name_in, double cost_in, double benefit_in, bool forced_in)
+    : name(name_in),
+      cost(cost_in),
+      benefit(benefit_in),
+      forced(forced_in),
+      selected(false)
+{ }
+
+PredictiveFlush::Candidate::~Candidate() = default;
+
+PredictiveFlush::PredictiveFlush(const Config &config, const CostConfig &costConfig, vespalib::system_time startTime)
+    : MemoryFlush(config, startTime),
+      _costConfig(costConfig),
+      _historyLock(),
+      _history(),
+      _lastDecision(),
+      _lastDecisionTime()
+{ }
+
+PredictiveFlush::~PredictiveFlush() = default;
+
+double
+PredictiveFlush::estimateCost(const IFlushTarget &target, const History &history) const
+{
+    double bytesToWrite = target.getApproxBytesToWriteToDisk();
+    double flushTime = 0.0;
+    if (history.flushCount > 0) {
+        if (bytesToWrite == 0.0) {
+            bytesToWrite = history.bytesToWrite;
+        }
+        flushTime = (history.bytesToWrite > 0.0)
+                    ? (history.flushTime * bytesToWrite / history.bytesToWrite)
+                    : history.flushTime;
+    }
+    return std::max(1.0, bytesToWrite + _costConfig.fixedFlushCost + flushTime * _costConfig.timeCost);
+}
+
+void
+PredictiveFlush::setLastDecision(std::vector<Candidate> decision, vespalib::system_time now) const
+{
+    std::lock_guard<std::mutex> guard(_historyLock);
+    _lastDecision = std::move(decision);
+    _lastDecisionTime = now;
+}
+
+FlushContext::List
+PredictiveFlush::getFlushTargets(const FlushContext::List &targetList,
+                                 const flushengine::TlsStatsMap &tlsStatsMap) const
+{
+    vespalib::system_time now(vespalib::system_clock::now());
+    FlushContext::List ordered = MemoryFlush::getFlushTargets(targetList, tlsStatsMap);
+    if (ordered.empty()) {
+        setLastDecision(std::vector<Candidate>(), now);
+        return ordered;
+    }
+    const Config config(getConfig());
+    std::vector<Estimate> estimates;
+    estimates.reserve(ordered.size());
+    uint64_t totalMemory(0);
+    IFlushTarget::DiskGain totalDisk;
+    for (const auto &ctx : ordered) {
+        const IFlushTarget &target(*ctx->getTarget());
+        int64_t mgain(std::max(INT64_C(0), target.getApproxMemoryGain().gain()));
+        IFlushTarget::DiskGain dgain(target.getApproxDiskGain());
+        totalMemory += mgain;
+        totalDisk += dgain;
+        estimates.push_back({ctx, ctx->getHandler().get(), target.getFlushedSerialNum(),
+                             mgain, std::max(INT64_C(0), dgain.gain()), 0, false});
+    }
+    double diskLimit = config.globalDiskBloatFactor * computeGain(totalDisk);
+    uint64_t tlsSize = tlsSizeToKeep(estimates, tlsStatsMap, nullptr);
+    double memoryPressure = pressure(totalMemory, config.maxGlobalMemory);
+    double tlsPressure = pressure(tlsSize, config.maxGlobalTlsSize);
+    double diskPressure = pressure(std::max(INT64_C(0), totalDisk.gain()), diskLimit);
+
+    std::vector<Candidate> candidates;
+    candidates.reserve(estimates.size());
+    {
+        std::lock_guard<std::mutex> guard(_historyLock);
+        for (auto &estimate : estimates) {
+            const IFlushTarget &target(*estimate.ctx->getTarget());
+            auto itr = _history.find(estimate.ctx->getName());
+            double cost = estimateCost(target, (itr != _history.end()) ? itr->second : History());
+            double benefit = estimate.memoryGain * memoryPressure +
+                             (tlsSize - tlsSizeToKeep(estimates, tlsStatsMap, &estimate)) * tlsPressure +
+                             estimate.diskGain * diskPressure;
+            vespalib::system_time lastFlushTime = target.getLastFlushTime();
+            vespalib::duration timeDiff(now - (lastFlushTime > vespalib::system_time() ? lastFlushTime : getStartTime()));
+            bool forced = target.needUrgentFlush() ||
+                          (estimate.memoryGain >= config.maxMemoryGain) ||
+                          (estimate.diskGain > config.diskBloatFactor * computeGain(target.getApproxDiskGain())) ||
+                          (timeDiff >= config.maxTimeGain);
+            estimate.candidate = candidates.size();
+            candidates.emplace_back(estimate.ctx->getName(), cost, benefit, forced);
+        }
+    }
+    std::stable_sort(estimates.begin(), estimates.end(), [&candidates](const Estimate &lhs, const Estimate &rhs) {
+        const Candidate &lc = candidates[lhs.candidate];
+        const Candidate &rc = candidates[rhs.candidate];
+        if (lc.forced != rc.forced) {
+            return lc.forced;
+        }
+        return lc.score() > rc.score();
+    });
+
+    FlushContext::List result;
+    uint64_t memory = totalMemory;
+    int64_t disk = std::max(INT64_C(0), totalDisk.gain());
+    for (auto &estimate : estimates) {
+        bool overLimit = (memory >= config.maxGlobalMemory) ||
+                         (tlsSizeToKeep(estimates, tlsStatsMap, nullptr) > config.maxGlobalTlsSize) ||
+                         (disk > diskLimit);
+        if (!candidates[estimate.candidate].forced && !overLimit && !result.empty()) {
+            break;
+        }
+        estimate.selected = true;
+        candidates[estimate.candidate].selected = true;
+        memory -= estimate.memoryGain;
+        disk -= estimate.diskGain;
+        result.push_back(estimate.ctx);
+    }
+    if (LOG_WOULD_LOG(debug)) {
+        vespalib::asciistream oss;
+        for (size_t i = 0; i < result.size(); ++i) {
+            const Candidate &candidate = candidates[estimates[i].candidate];
+            if (i > 0) {
+                oss << ",";
+            }
+            oss << candidate.name << "(cost=" << candidate.cost << ",benefit=" << candidate.benefit << ")";
+        }
+        LOG(debug, "getFlushTargets(): selected %zu of %zu targets: [%s]", result.size(), estimates.size(), oss.str().data());
+    }
+    setLastDecision(std::move(candidates), now);
+    return result;
+}
+
+void
+PredictiveFlush::flushDone(const FlushContext &ctx, uint64_t bytesToWrite, vespalib::duration duration)
+{
+    std::lock_guard<std::mutex> guard(_historyLock);
+    History &history = _history[ctx.getName()];
+    double weight = (history.flushCount == 0) ? 1.0 : _costConfig.historyWeight;
+    history.bytesToWrite += weight * (bytesToWrite - history.bytesToWrite);
+    history.flushTime += weight * (vespalib::to_s(duration) - history.flushTime);
+    ++history.flushCount;
+}
+
+void
+PredictiveFlush::reportState(Cursor &object) const
+{
+    std::lock_guard<std::mutex> guard(_historyLock);
+    object.setString("lastDecisionTime", vespalib::to_string(_lastDecisionTime));
+    Cursor &decision = object.setArray("lastDecision");
+    for (const auto &candidate : _lastDecision) {
+        Cursor &entry = decision.addObject();
+        entry.setString("name", candidate.name);
+        entry.setDouble("cost", candidate.cost);
+        entry.setDouble("benefit", candidate.benefit);
+        entry.setDouble("score", candidate.score());
+        entry.setBool("forced", candidate.forced);
+        entry.setBool("selected", candidate.selected);
+    }
+    Cursor &history = object.setArray("history");
+    for (const auto &entry : _history) {
+        Cursor &target = history.addObject();
+        target.setString("name", entry.first);
+        target.setLong("flushCount", entry.second.flushCount);
+        target.setDouble("bytesToWrite", entry.second.bytesToWrite);
+        target.setDouble("flushTime", entry.second.flushTime);
+    }
+}
+
+PredictiveFlush::History
+PredictiveFlush::getHistory(const vespalib::string &name) const
+{
+    std::lock_guard<std::mutex> guard(_historyLock);
+    auto itr = _history.find(name);
+    return (itr != _history.end()) ? itr->second : History();
+}
+
+std::vector<PredictiveFlush::Candidate>
+PredictiveFlush::getLastDecision() const
+{
+    std::lock_guard<std::mutex> guard(_historyLock);
+    return _lastDecision;
+}
+
+} // namespace proton
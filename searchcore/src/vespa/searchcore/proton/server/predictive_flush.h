@@ -0,0 +1,93 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "memoryflush.h"
+#include <map>
+#include <vector>
+
+namespace proton {
+
+/**
+ * Flush strategy extending MemoryFlush with a cost model for the flush
+ * targets. MemoryFlush decides when flushing is needed. When it is, each
+ * target gets an estimated cost, in bytes written, based on the bytes it
+ * would write now and the time earlier flushes of the same target used,
+ * and an estimated benefit, being the memory, transaction log and disk
+ * bloat released, weighted by how close each resource is to its limit.
+ *
+ * Targets that must be flushed on their own (urgent, or above a per
+ * target limit) are selected first, followed by the targets with the best
+ * benefit per cost until the memory, transaction log and disk bloat totals
+ * are expected to be within their limits. The remaining targets are left
+ * alone, so large targets are not rewritten while cheaper targets can
+ * bring the totals down.
+ */
+class PredictiveFlush : public MemoryFlush
+{
+public:
+    struct CostConfig
+    {
+        /// Fixed cost of doing a flush, in bytes written.
+        double fixedFlushCost;
+        /// Cost of each second spent flushing, in bytes written.
+        double timeCost;
+        /// Weight of the last flush when updating the flush history.
+        double historyWeight;
+        CostConfig();
+        CostConfig(double fixedFlushCost_in, double timeCost_in, double historyWeight_in);
+    };
+
+    /**
+     * Moving averages of earlier flushes of a target.
+     */
+    struct History
+    {
+        uint32_t flushCount;
+        double   bytesToWrite;
+        double   flushTime;
+        History() : flushCount(0), bytesToWrite(0.0), flushTime(0.0) { }
+    };
+
+    /**
+     * Estimates for a target when the flush targets were last selected.
+     */
+    struct Candidate
+    {
+        vespalib::string name;
+        double           cost;
+        double           benefit;
+        bool             forced;
+        bool             selected;
+        Candidate(const vespalib::string &name_in, double cost_in, double benefit_in, bool forced_in);
+        ~Candidate();
+        double score() const { return benefit / cost; }
+    };
+
+private:
+    const CostConfig                  _costConfig;
+    mutable std::mutex                _historyLock;
+    std::map<vespalib::string, History> _history;
+    mutable std::vector<Candidate>    _lastDecision;
+    mutable vespalib::system_time     _lastDecisionTime;
+
+    double estimateCost(const searchcorespi::IFlushTarget &target, const History &history) const;
+    void setLastDecision(std::vector<Candidate> decision, vespalib::system_time now) const;
+
+public:
+    using SP = std::shared_ptr<PredictiveFlush>;
+
+    PredictiveFlush(const Config &config, const CostConfig &costConfig, vespalib::system_time startTime);
+    ~PredictiveFlush() override;
+
+    FlushContext::List
+    getFlushTargets(const FlushContext::List &targetList,
+                    const flushengine::TlsStatsMap &tlsStatsMap) const override;
+
+    void flushDone(const FlushContext &ctx, uint64_t bytesToWrite, vespalib::duration duration) override;
+    void reportState(vespalib::slime::Cursor &object) const override;
+
+    History getHistory(const vespalib::string &name) const;
+    std::vector<Candidate> getLastDecision() const;
+};
+
+} // namespace proton
@@ -6,6 +6,7 @@
 #include "flushhandlerproxy.h"
 #include "memoryflush.h"
 #include "persistencehandlerproxy.h"
+#include "predictive_flush.h"
 #include "prepare_restart_handler.h"
 #include "proton.h"
 #include "proton_config_snapshot.h"
@@ -213,6 +214,8 @@ Proton::Proton(const config::ConfigUri & configUri,
       _warmupExecutor(),
       _sharedExecutor(),
       _compile_cache_executor_binding(),
+      _code_cache(),
+      _code_cache_binding(),
       _queryLimiter(),
       _clock(0.001),
       _threadPool(128 * 1024),
@@ -271,9 +274,17 @@ Proton::init(const BootstrapConfig::SP & configSnapshot)
     IFlushStrategy::SP strategy;
     const ProtonConfig::Flush & flush(protonConfig.flush);
     switch (flush.strategy) {
-    case ProtonConfig::Flush::Strategy::MEMORY: {
-        auto memoryFlush = std::make_shared<MemoryFlush>(
-                MemoryFlushConfigUpdater::convertConfig(flush.memory, hwInfo.memory()), vespalib::system_clock::now());
+    case ProtonConfig::Flush::Strategy::MEMORY:
+    case ProtonConfig::Flush::Strategy::PREDICTIVE: {
+        MemoryFlush::Config memoryFlushConfig = MemoryFlushConfigUpdater::convertConfig(flush.memory, hwInfo.memory());
+        MemoryFlush::SP memoryFlush;
+        if (flush.strategy == ProtonConfig::Flush::Strategy::PREDICTIVE) {
+            PredictiveFlush::CostConfig costConfig(flush.predictive.fixedflushcost, flush.predictive.timecost,
+                                                   flush.predictive.historyweight);
+            memoryFlush = std::make_shared<PredictiveFlush>(memoryFlushConfig, costConfig, vespalib::system_clock::now());
+        } else {
+            memoryFlush = std::make_shared<MemoryFlush>(memoryFlushConfig, vespalib::system_clock::now());
+        }
         _memoryFlushConfigUpdater = std::make_unique<MemoryFlushConfigUpdater>(memoryFlush, flush.memory, hwInfo.memory());
         _diskMemUsageSampler->notifier().addDiskMemUsageListener(_memoryFlushConfigUpdater.get());
         strategy = memoryFlush;
@@ -305,6 +316,11 @@ Proton::init(const BootstrapConfig::SP & configSnapshot)
     const size_t sharedThreads = derive_shared_threads(protonConfig, hwInfo.cpu());
     _sharedExecutor = std::make_shared<vespalib::BlockingThreadStackExecutor>(sharedThreads, 128*1024, sharedThreads*16, proton_shared_executor);
     _compile_cache_executor_binding = vespalib::eval::CompileCache::bind(_sharedExecutor);
+    if (protonConfig.compilecache.enabled) {
+        _code_cache = std::make_shared<vespalib::eval::CodeCache>(protonConfig.basedir + "/compilecache");
+        _code_cache->prune(protonConfig.compilecache.maxbytes);
+        _code_cache_binding = vespalib::eval::CodeCache::bind(_code_cache);
+    }
     InitializeThreads initializeThreads;
     if (protonConfig.initialize.threads > 0) {
         initializeThreads = std::make_shared<vespalib::ThreadStackExecutor>(protonConfig.initialize.threads, 128 * 1024, initialize_executor);
@@ -450,6 +466,7 @@ Proton::~Proton()
     _tls.reset();
     _warmupExecutor.reset();
     _compile_cache_executor_binding.reset();
+    _code_cache_binding.reset();
     _sharedExecutor.reset();
     _clock.stop();
     LOG(debug, "Explicit destructor done");
@@ -731,6 +748,9 @@ Proton::updateMetrics(const vespalib::MonitorGuard &)
         metrics.resourceUsage.memoryMappings.set(usageFilter.getMemoryStats().getMappingsCount());
         metrics.resourceUsage.openFileDescriptors.set(FastOS_File::count_open_files());
         metrics.resourceUsage.feedingBlocked.set((usageFilter.acceptWriteOperation() ? 0.0 : 1.0));
+        if (_code_cache) {
+            metrics.compileCache.update(_code_cache->get_stats());
+        }
     }
     {
         ContentProtonMetrics::ProtonExecutorMetrics &metrics = _metricsEngine->root().executor;
@@ -9,85 +9,137 @@ using vespalib::IllegalStateException;
 
 namespace proton {
 
-template <typename OperationType>
+ReplayPacketDispatcher::ReplayPacketDispatcher(IReplayPacketHandler &handler)
+    : _handler(handler)
+{
+}
+
+
 void
-ReplayPacketDispatcher::replay(OperationType &op, vespalib::nbostream &is, const Packet::Entry &entry)
+ReplayPacketDispatcher::replayEntry(const Packet::Entry &entry)
 {
-    op.deserialize(is, _handler.getDeserializeRepo());
-    op.setSerialNum(entry.serial());
-    store(op);
-    _handler.replay(op);
+    if (entry.type() == FeedOperation::NEW_CONFIG) {
+        vespalib::nbostream is(entry.data().c_str(), entry.data().size());
+        NewConfigOperation op(entry.serial(), _handler.getNewConfigStreamHandler());
+        op.deserialize(is, _handler.getDeserializeRepo());
+        _handler.replay(op);
+        checkConsumed(is, entry);
+    } else {
+        std::unique_ptr<FeedOperation> op = decodeEntry(entry, _handler.getDeserializeRepo());
+        replayOperation(*op);
+    }
 }
 
 
-ReplayPacketDispatcher::ReplayPacketDispatcher(IReplayPacketHandler &handler)
-    : _handler(handler)
+bool
+ReplayPacketDispatcher::canDecodeAhead(const Packet::Entry &entry)
 {
+    return (entry.type() != FeedOperation::NEW_CONFIG);
 }
 
 
-void
-ReplayPacketDispatcher::replayEntry(const Packet::Entry &entry)
+std::unique_ptr<FeedOperation>
+ReplayPacketDispatcher::decodeEntry(const Packet::Entry &entry, const document::DocumentTypeRepo &repo)
 {
-    vespalib::nbostream is(entry.data().c_str(), entry.data().size());
+    std::unique_ptr<FeedOperation> op;
     switch (entry.type()) {
-    case FeedOperation::PUT: {
-        PutOperation op;
-        replay(op, is, entry);
+    case FeedOperation::PUT:
+        op = std::make_unique<PutOperation>();
         break;
-    } case FeedOperation::REMOVE: {
-        RemoveOperationWithDocId op;
-        replay(op, is, entry);
+    case FeedOperation::REMOVE:
+        op = std::make_unique<RemoveOperationWithDocId>();
         break;
-    } case FeedOperation::REMOVE_GID: {
-        RemoveOperationWithGid op;
-        replay(op, is, entry);
+    case FeedOperation::REMOVE_GID:
+        op = std::make_unique<RemoveOperationWithGid>();
         break;
-    } case FeedOperation::UPDATE: {
-        UpdateOperation op(static_cast<FeedOperation::Type>(entry.type()));
-        replay(op, is, entry);
+    case FeedOperation::UPDATE:
+        op = std::make_unique<UpdateOperation>(static_cast<FeedOperation::Type>(entry.type()));
         break;
-    } case FeedOperation::NOOP: {
-        NoopOperation op;
-        replay(op, is, entry);
+    case FeedOperation::NOOP:
+        op = std::make_unique<NoopOperation>();
         break;
-    } case FeedOperation::NEW_CONFIG: {
-        NewConfigOperation op(entry.serial(), _handler.getNewConfigStreamHandler());
-        op.deserialize(is, _handler.getDeserializeRepo());
-        _handler.replay(op);
-        break;
-    } case FeedOperation::DELETE_BUCKET: {
-        DeleteBucketOperation op;
-        replay(op, is, entry);
+    case FeedOperation::DELETE_BUCKET:
+        op = std::make_unique<DeleteBucketOperation>();
         break;
-    } case FeedOperation::SPLIT_BUCKET: {
-        SplitBucketOperation op;
-        replay(op, is, entry);
+    case FeedOperation::SPLIT_BUCKET:
+        op = std::make_unique<SplitBucketOperation>();
         break;
-    } case FeedOperation::JOIN_BUCKETS: {
-        JoinBucketsOperation op;
-        replay(op, is, entry);
+    case FeedOperation::JOIN_BUCKETS:
+        op = std::make_unique<JoinBucketsOperation>();
         break;
-    } case FeedOperation::PRUNE_REMOVED_DOCUMENTS: {
-        PruneRemovedDocumentsOperation op;
-        replay(op, is, entry);
+    case FeedOperation::PRUNE_REMOVED_DOCUMENTS:
+        op = std::make_unique<PruneRemovedDocumentsOperation>();
         break;
-    } case FeedOperation::MOVE: {
-        MoveOperation op;
-        replay(op, is, entry);
+    case FeedOperation::MOVE:
+        op = std::make_unique<MoveOperation>();
         break;
-    } case FeedOperation::CREATE_BUCKET: {
-        CreateBucketOperation op;
-        replay(op, is, entry);
+    case FeedOperation::CREATE_BUCKET:
+        op = std::make_unique<CreateBucketOperation>();
         break;
-    } case FeedOperation::COMPACT_LID_SPACE: {
-        CompactLidSpaceOperation op;
-        replay(op, is, entry);
+    case FeedOperation::COMPACT_LID_SPACE:
+        op = std::make_unique<CompactLidSpaceOperation>();
         break;
-    } default:
+    default:
         throw IllegalStateException
             (make_string("Got packet entry with unknown type id '%u' from TLS", entry.type()));
     }
+    vespalib::nbostream is(entry.data().c_str(), entry.data().size());
+    op->deserialize(is, repo);
+    op->setSerialNum(entry.serial());
+    checkConsumed(is, entry);
+    return op;
+}
+
+
+void
+ReplayPacketDispatcher::replayOperation(const FeedOperation &op)
+{
+    store(op);
+    switch (op.getType()) {
+    case FeedOperation::PUT:
+        _handler.replay(static_cast<const PutOperation &>(op));
+        break;
+    case FeedOperation::REMOVE:
+    case FeedOperation::REMOVE_GID:
+        _handler.replay(static_cast<const RemoveOperation &>(op));
+        break;
+    case FeedOperation::UPDATE:
+        _handler.replay(static_cast<const UpdateOperation &>(op));
+        break;
+    case FeedOperation::NOOP:
+        _handler.replay(static_cast<const NoopOperation &>(op));
+        break;
+    case FeedOperation::DELETE_BUCKET:
+        _handler.replay(static_cast<const DeleteBucketOperation &>(op));
+        break;
+    case FeedOperation::SPLIT_BUCKET:
+        _handler.replay(static_cast<const SplitBucketOperation &>(op));
+        break;
+    case FeedOperation::JOIN_BUCKETS:
+        _handler.replay(static_cast<const JoinBucketsOperation &>(op));
+        break;
+    case FeedOperation::PRUNE_REMOVED_DOCUMENTS:
+        _handler.replay(static_cast<const PruneRemovedDocumentsOperation &>(op));
+        break;
+    case FeedOperation::MOVE:
+        _handler.replay(static_cast<const MoveOperation &>(op));
+        break;
+    case FeedOperation::CREATE_BUCKET:
+        _handler.replay(static_cast<const CreateBucketOperation &>(op));
+        break;
+    case FeedOperation::COMPACT_LID_SPACE:
+        _handler.replay(static_cast<const CompactLidSpaceOperation &>(op));
+        break;
+    default:
+        throw IllegalStateException
+            (make_string("Can not replay operation with type id '%u'", op.getType()));
+    }
+}
+
+
+void
+ReplayPacketDispatcher::checkConsumed(const vespalib::nbostream &is, const Packet::Entry &entry)
+{
     if ( ! is.empty()) {
         throw document::DeserializeException
             (make_string("Too much data in packet entry (type id '%u', %ld bytes)",
@@ -5,6 +5,8 @@
 #include "ireplaypackethandler.h"
 #include <vespa/searchlib/transactionlog/common.h>
 
+namespace document { class DocumentTypeRepo; }
+
 namespace proton {
 
 class FeedOperation;
@@ -19,8 +21,7 @@ private:
     typedef search::transactionlog::Packet Packet;
     IReplayPacketHandler &_handler;
 
-    template <typename OperationType>
-    void replay(OperationType &op, vespalib::nbostream &is, const Packet::Entry &entry);
+    static void checkConsumed(const vespalib::nbostream &is, const Packet::Entry &entry);
 
 protected:
     virtual void store(const FeedOperation &op);
@@ -30,6 +31,18 @@ public:
     virtual ~ReplayPacketDispatcher();
 
     void replayEntry(const Packet::Entry &entry);
+
+    /**
+     * Deserializes a packet entry into a feed operation that can be
+     * replayed later by replayOperation(). Does not depend on the handler,
+     * so entries can be decoded ahead of replay in other threads.
+     * New config entries are not handled, as they are deserialized through
+     * the config stream handler when replayed.
+     */
+    static std::unique_ptr<FeedOperation> decodeEntry(const Packet::Entry &entry,
+                                                      const document::DocumentTypeRepo &repo);
+    static bool canDecodeAhead(const Packet::Entry &entry);
+    void replayOperation(const FeedOperation &op);
 };
 
 } // namespace proton
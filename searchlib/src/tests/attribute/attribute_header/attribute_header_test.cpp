@@ -13,6 +13,7 @@ using namespace search;
 using namespace search::attribute;
 
 using HnswIPO = std::optional<HnswIndexParams>;
+using IvfPqIPO = std::optional<IvfPqIndexParams>;
 using vespalib::eval::ValueType;
 
 const Config tensor_cfg(BasicType::TENSOR, CollectionType::SINGLE);
@@ -25,7 +26,7 @@ constexpr uint64_t create_serial_num = 17;
 constexpr uint32_t version = 19;
 
 vespalib::GenericHeader
-populate_header(const HnswIPO& hnsw_params)
+populate_header(const HnswIPO& hnsw_params, const IvfPqIPO& ivf_pq_params)
 {
     AttributeHeader header(file_name,
                            tensor_cfg.basicType(),
@@ -34,6 +35,7 @@ populate_header(const HnswIPO& hnsw_params)
                            false,
                            PersistentPredicateParams(),
                            hnsw_params,
+                           ivf_pq_params,
                            num_docs,
                            unique_value_count,
                            total_value_count,
@@ -46,9 +48,9 @@ populate_header(const HnswIPO& hnsw_params)
 }
 
 void
-verify_roundtrip_serialization(const HnswIPO& hnsw_params_in)
+verify_roundtrip_serialization(const HnswIPO& hnsw_params_in, const IvfPqIPO& ivf_pq_params_in = IvfPqIPO())
 {
-    auto gen_header = populate_header(hnsw_params_in);
+    auto gen_header = populate_header(hnsw_params_in, ivf_pq_params_in);
     auto attr_header = AttributeHeader::extractTags(gen_header);
 
     EXPECT_EQ(tensor_cfg.basicType(), attr_header.getBasicType());
@@ -65,6 +67,11 @@ verify_roundtrip_serialization(const HnswIPO& hnsw_params_in)
     if (hnsw_params_in.has_value()) {
         EXPECT_EQ(hnsw_params_in.value(), hnsw_params_out.value());
     }
+    const auto& ivf_pq_params_out = attr_header.get_ivf_pq_index_params();
+    EXPECT_EQ(ivf_pq_params_in.has_value(), ivf_pq_params_out.has_value());
+    if (ivf_pq_params_in.has_value()) {
+        EXPECT_EQ(ivf_pq_params_in.value(), ivf_pq_params_out.value());
+    }
 }
 
 TEST(AttributeHeaderTest, can_be_added_to_and_extracted_from_generic_header)
@@ -73,6 +80,8 @@ TEST(AttributeHeaderTest, can_be_added_to_and_extracted_from_generic_header)
     verify_roundtrip_serialization(HnswIPO({16, 100, DistanceMetric::Angular}));
     verify_roundtrip_serialization(HnswIPO({16, 100, DistanceMetric::GeoDegrees}));
     verify_roundtrip_serialization(HnswIPO());
+    verify_roundtrip_serialization(HnswIPO(), IvfPqIPO({1024, 16, DistanceMetric::Euclidean}));
+    verify_roundtrip_serialization(HnswIPO(), IvfPqIPO({256, 8, DistanceMetric::Angular}));
 }
 
 GTEST_MAIN_RUN_ALL_TESTS()
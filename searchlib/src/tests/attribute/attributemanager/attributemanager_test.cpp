@@ -328,6 +328,37 @@ AttributeManagerTest::testConfigConvert()
         auto out = ConfigConverter::convert(a);
         EXPECT_FALSE(out.hnsw_index_params().has_value());
     }
+    { // ivf-pq index default params (enabled)
+        CACA a;
+        a.index.ivfpq.enabled = true;
+        auto out = ConfigConverter::convert(a);
+        EXPECT_FALSE(out.hnsw_index_params().has_value());
+        EXPECT_TRUE(out.ivf_pq_index_params().has_value());
+        const auto& params = out.ivf_pq_index_params().value();
+        EXPECT_EQUAL(1024u, params.num_centroids());
+        EXPECT_EQUAL(16u, params.num_subquantizers());
+    }
+    { // ivf-pq index params (enabled)
+        CACA a;
+        a.distancemetric = AttributesConfig::Attribute::Distancemetric::ANGULAR;
+        a.index.ivfpq.enabled = true;
+        a.index.ivfpq.numcentroids = 256;
+        a.index.ivfpq.numsubquantizers = 8;
+        auto out = ConfigConverter::convert(a);
+        EXPECT_TRUE(out.ivf_pq_index_params().has_value());
+        const auto& params = out.ivf_pq_index_params().value();
+        EXPECT_EQUAL(256u, params.num_centroids());
+        EXPECT_EQUAL(8u, params.num_subquantizers());
+        EXPECT_TRUE(params.distance_metric() == DistanceMetric::Angular);
+    }
+    { // ivf-pq index params (hnsw takes precedence)
+        CACA a;
+        a.index.hnsw.enabled = true;
+        a.index.ivfpq.enabled = true;
+        auto out = ConfigConverter::convert(a);
+        EXPECT_TRUE(out.hnsw_index_params().has_value());
+        EXPECT_FALSE(out.ivf_pq_index_params().has_value());
+    }
 }
 
 bool gt_attribute(const attribute::IAttributeVector * a, const attribute::IAttributeVector * b) {
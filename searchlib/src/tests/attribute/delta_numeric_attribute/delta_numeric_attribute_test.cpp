@@ -0,0 +1,287 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/attribute/attribute_header.h>
+#include <vespa/searchlib/attribute/attributefactory.h>
+#include <vespa/searchlib/attribute/floatbase.h>
+#include <vespa/searchlib/attribute/integerbase.h>
+#include <vespa/searchlib/attribute/singlenumericdeltasaver.h>
+#include <vespa/searchlib/test/directory_handler.h>
+#include <vespa/searchlib/util/fileutil.h>
+#include <vespa/searchcommon/attribute/config.h>
+#include <vespa/vespalib/data/fileheader.h>
+#include <vespa/vespalib/gtest/gtest.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP("delta_numeric_attribute_test");
+
+using search::AttributeFactory;
+using search::AttributeVector;
+using search::FloatingPointAttribute;
+using search::IntegerAttribute;
+using search::SingleValueNumericDeltaSaver;
+using search::attribute::AttributeHeader;
+using search::attribute::BasicType;
+using search::attribute::Config;
+using search::test::DirectoryHandler;
+
+namespace {
+
+const vespalib::string test_dir = "delta_numeric_attribute_data";
+
+Config
+deltaConfig(BasicType basicType, double maxDeltaRatio)
+{
+    Config cfg(basicType);
+    cfg.setMaxDeltaRatio(maxDeltaRatio);
+    return cfg;
+}
+
+vespalib::string
+snapshot(const vespalib::string &name)
+{
+    vespalib::mkdir(test_dir + "/" + name);
+    return test_dir + "/" + name + "/attr";
+}
+
+bool
+hasBase(const vespalib::string &snapshotName)
+{
+    return vespalib::fileExists(test_dir + "/" + snapshotName + "/attr." + SingleValueNumericDeltaSaver::BASE_SUFFIX);
+}
+
+off_t
+datSize(const vespalib::string &snapshotName)
+{
+    return vespalib::getFileSize(test_dir + "/" + snapshotName + "/attr.dat");
+}
+
+AttributeHeader
+datHeader(const vespalib::string &snapshotName)
+{
+    auto file = search::FileUtil::openFile(test_dir + "/" + snapshotName + "/attr.dat");
+    vespalib::FileHeader header;
+    header.readFile(*file);
+    return AttributeHeader::extractTags(header);
+}
+
+}
+
+class DeltaNumericAttributeTest : public ::testing::Test {
+protected:
+    DirectoryHandler      _dir;
+    AttributeVector::SP   _attr;
+    std::vector<int64_t>  _expected;
+    double                _maxDeltaRatio;
+
+    DeltaNumericAttributeTest()
+        : ::testing::Test(),
+          _dir(test_dir),
+          _attr(),
+          _expected(),
+          _maxDeltaRatio(0.1)
+    {
+    }
+    ~DeltaNumericAttributeTest() override;
+
+    void create(const vespalib::string &name) {
+        _attr = AttributeFactory::createAttribute(name, deltaConfig(BasicType::INT64, _maxDeltaRatio));
+    }
+    IntegerAttribute &attr() { return dynamic_cast<IntegerAttribute &>(*_attr); }
+
+    void populate(uint32_t numDocs) {
+        create(test_dir + "/attr");
+        _attr->addReservedDoc();
+        _attr->addDocs(numDocs - 1);
+        _expected.assign(numDocs, _attr->getInt(0));
+        for (uint32_t docId = 1; docId < numDocs; ++docId) {
+            update(docId, 1000 + docId);
+        }
+        _attr->commit();
+    }
+    void update(uint32_t docId, int64_t value) {
+        attr().update(docId, value);
+        _expected[docId] = value;
+    }
+    void addDocs(uint32_t numDocs) {
+        uint32_t docId = 0;
+        for (uint32_t i = 0; i < numDocs; ++i) {
+            _attr->addDoc(docId);
+            _expected.push_back(_attr->getInt(docId));
+            update(docId, 5000 + docId);
+        }
+        _attr->commit();
+    }
+    void save(const vespalib::string &snapshotName) {
+        EXPECT_TRUE(_attr->save(snapshot(snapshotName)));
+    }
+    void load(const vespalib::string &snapshotName) {
+        create(test_dir + "/" + snapshotName + "/attr");
+        EXPECT_TRUE(_attr->load());
+    }
+    void assertValues() {
+        EXPECT_EQ(_expected.size(), _attr->getNumDocs());
+        for (uint32_t docId = 1; docId < _expected.size(); ++docId) {
+            EXPECT_EQ(_expected[docId], _attr->getInt(docId)) << "docId=" << docId;
+        }
+    }
+};
+
+DeltaNumericAttributeTest::~DeltaNumericAttributeTest() = default;
+
+TEST_F(DeltaNumericAttributeTest, first_save_is_full_save)
+{
+    populate(1000);
+    save("s1");
+    EXPECT_FALSE(hasBase("s1"));
+    EXPECT_FALSE(datHeader("s1").getDelta());
+    EXPECT_EQ(0u, datHeader("s1").getVersion());
+    load("s1");
+    assertValues();
+}
+
+TEST_F(DeltaNumericAttributeTest, delta_save_only_writes_changed_documents)
+{
+    populate(1000);
+    save("s1");
+    update(17, 42);
+    update(500, 43);
+    attr().clearDoc(700);
+    _expected[700] = _attr->getInt(0);
+    _attr->commit();
+    save("s2");
+    EXPECT_TRUE(hasBase("s2"));
+    EXPECT_TRUE(datHeader("s2").getDelta());
+    EXPECT_EQ(SingleValueNumericDeltaSaver::DELTA_VERSION, datHeader("s2").getVersion());
+    EXPECT_EQ(datSize("s1"), vespalib::getFileSize(test_dir + "/s2/attr." + SingleValueNumericDeltaSaver::BASE_SUFFIX));
+    EXPECT_LT(datSize("s2") + 7000, datSize("s1"));
+    vespalib::rmdir(test_dir + "/s1", true);
+    load("s2");
+    assertValues();
+}
+
+TEST_F(DeltaNumericAttributeTest, estimated_save_size_reflects_delta_save)
+{
+    populate(1000);
+    uint64_t fullEstimate = _attr->getEstimatedSaveByteSize();
+    save("s1");
+    EXPECT_EQ(4096u, _attr->getEstimatedSaveByteSize());
+    update(17, 42);
+    update(500, 43);
+    _attr->commit();
+    uint64_t deltaEstimate = _attr->getEstimatedSaveByteSize();
+    EXPECT_EQ(4096u + 2 * (sizeof(uint32_t) + sizeof(int64_t)), deltaEstimate);
+    for (uint32_t docId = 1; docId < 200; ++docId) {
+        update(docId, 7);
+    }
+    _attr->commit();
+    EXPECT_EQ(fullEstimate, _attr->getEstimatedSaveByteSize());
+}
+
+TEST_F(DeltaNumericAttributeTest, delta_saves_are_cumulative_and_survive_reload)
+{
+    populate(1000);
+    save("s1");
+    update(10, 1);
+    _attr->commit();
+    save("s2");
+    update(20, 2);
+    _attr->commit();
+    save("s3");
+    EXPECT_TRUE(hasBase("s3"));
+    vespalib::rmdir(test_dir + "/s1", true);
+    vespalib::rmdir(test_dir + "/s2", true);
+    load("s3");
+    assertValues();
+    update(30, 3);
+    _attr->commit();
+    save("s4");
+    EXPECT_TRUE(hasBase("s4"));
+    vespalib::rmdir(test_dir + "/s3", true);
+    load("s4");
+    assertValues();
+}
+
+TEST_F(DeltaNumericAttributeTest, full_save_is_done_when_too_many_documents_have_changed)
+{
+    populate(1000);
+    save("s1");
+    for (uint32_t docId = 1; docId < 200; ++docId) {
+        update(docId, 7);
+    }
+    _attr->commit();
+    save("s2");
+    EXPECT_FALSE(hasBase("s2"));
+    update(300, 8);
+    _attr->commit();
+    save("s3");
+    EXPECT_TRUE(hasBase("s3"));
+    EXPECT_EQ(datSize("s2"), vespalib::getFileSize(test_dir + "/s3/attr." + SingleValueNumericDeltaSaver::BASE_SUFFIX));
+    vespalib::rmdir(test_dir + "/s1", true);
+    vespalib::rmdir(test_dir + "/s2", true);
+    load("s3");
+    assertValues();
+}
+
+TEST_F(DeltaNumericAttributeTest, added_documents_are_included_in_delta)
+{
+    populate(1000);
+    save("s1");
+    addDocs(20);
+    save("s2");
+    EXPECT_TRUE(hasBase("s2"));
+    load("s2");
+    assertValues();
+}
+
+TEST_F(DeltaNumericAttributeTest, shrunk_and_regrown_lid_space_is_saved)
+{
+    populate(1000);
+    save("s1");
+    _attr->compactLidSpace(950);
+    _attr->commit();
+    _attr->shrinkLidSpace();
+    _expected.resize(950);
+    addDocs(10);
+    save("s2");
+    EXPECT_TRUE(hasBase("s2"));
+    load("s2");
+    assertValues();
+}
+
+TEST_F(DeltaNumericAttributeTest, delta_saves_are_not_used_when_disabled)
+{
+    _maxDeltaRatio = 0.0;
+    populate(1000);
+    save("s1");
+    update(17, 42);
+    _attr->commit();
+    save("s2");
+    EXPECT_FALSE(hasBase("s2"));
+    load("s2");
+    assertValues();
+}
+
+TEST_F(DeltaNumericAttributeTest, delta_save_works_for_floating_point_attribute)
+{
+    _attr = AttributeFactory::createAttribute(test_dir + "/attr", deltaConfig(BasicType::DOUBLE, 0.5));
+    _attr->addReservedDoc();
+    _attr->addDocs(9);
+    auto &fattr = dynamic_cast<FloatingPointAttribute &>(*_attr);
+    for (uint32_t docId = 1; docId < 10; ++docId) {
+        fattr.update(docId, docId * 0.5);
+    }
+    _attr->commit();
+    save("s1");
+    fattr.update(3, 42.25);
+    _attr->commit();
+    save("s2");
+    EXPECT_TRUE(hasBase("s2"));
+    _attr = AttributeFactory::createAttribute(test_dir + "/s2/attr", deltaConfig(BasicType::DOUBLE, 0.5));
+    EXPECT_TRUE(_attr->load());
+    EXPECT_EQ(10u, _attr->getNumDocs());
+    EXPECT_EQ(1.0, _attr->getFloat(2));
+    EXPECT_EQ(42.25, _attr->getFloat(3));
+    EXPECT_EQ(4.5, _attr->getFloat(9));
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -0,0 +1,288 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/attribute/attributefactory.h>
+#include <vespa/searchlib/attribute/integerbase.h>
+#include <vespa/searchlib/attribute/packed_integer_vector.h>
+#include <vespa/searchlib/attribute/single_packed_numeric_attribute.h>
+#include <vespa/searchlib/common/bitvector.h>
+#include <vespa/searchlib/fef/termfieldmatchdata.h>
+#include <vespa/searchlib/query/query_term_simple.h>
+#include <vespa/searchlib/queryeval/executeinfo.h>
+#include <vespa/searchlib/queryeval/searchiterator.h>
+#include <vespa/searchlib/test/directory_handler.h>
+#include <vespa/searchcommon/attribute/config.h>
+#include <vespa/vespalib/gtest/gtest.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP("packed_numeric_attribute_test");
+
+using search::AttributeFactory;
+using search::AttributeVector;
+using search::IntegerAttribute;
+using search::IntegerAttributeTemplate;
+using search::QueryTermSimple;
+using search::SingleValuePackedNumericAttribute;
+using search::attribute::BasicType;
+using search::attribute::Config;
+using search::attribute::PackedIntegerVector;
+using search::attribute::SearchContextParams;
+using search::fef::TermFieldMatchData;
+using search::queryeval::ExecuteInfo;
+using search::test::DirectoryHandler;
+
+using PackedInt64Attribute = SingleValuePackedNumericAttribute<IntegerAttributeTemplate<int64_t>>;
+
+namespace {
+
+const vespalib::string test_dir = "packed_numeric_attribute_data";
+constexpr int64_t undefined = std::numeric_limits<int64_t>::min();
+const PackedIntegerVector::ValueType int64_type(undefined + 1, std::numeric_limits<int64_t>::max(), undefined);
+
+Config
+packedConfig(BasicType basicType, bool packed = true)
+{
+    Config cfg(basicType);
+    cfg.setPacked(packed);
+    return cfg;
+}
+
+int64_t
+valueForDoc(uint32_t docId)
+{
+    return ((docId % 7) == 3) ? undefined : (1000 + (docId * 37) % 100);
+}
+
+}
+
+TEST(PackedIntegerVectorTest, layout_is_narrowest_power_of_two_width)
+{
+    EXPECT_EQ(PackedIntegerVector::Layout(7, 1), PackedIntegerVector::chooseLayout(int64_type, 7, 7, false));
+    EXPECT_EQ(PackedIntegerVector::Layout(-3, 2), PackedIntegerVector::chooseLayout(int64_type, -3, -1, false));
+    EXPECT_EQ(PackedIntegerVector::Layout(1000, 8), PackedIntegerVector::chooseLayout(int64_type, 1000, 1200, false));
+    EXPECT_EQ(PackedIntegerVector::Layout(0, 32), PackedIntegerVector::chooseLayout(int64_type, 0, 70000, false));
+    EXPECT_EQ(PackedIntegerVector::Layout(undefined + 1, 64),
+              PackedIntegerVector::chooseLayout(int64_type, -1, int64_t(1) << 40, true));
+}
+
+TEST(PackedIntegerVectorTest, headroom_is_split_around_value_range)
+{
+    auto layout = PackedIntegerVector::chooseLayout(int64_type, 1000, 1099, true);
+    EXPECT_EQ(8u, layout.bits);
+    EXPECT_EQ(1000 - (255 - 100) / 2, layout.base);
+    PackedIntegerVector::ValueType int8_type(-127, 127, -128);
+    EXPECT_EQ(PackedIntegerVector::Layout(-127, 8), PackedIntegerVector::chooseLayout(int8_type, 100, 127, true));
+    EXPECT_EQ(PackedIntegerVector::Layout(-10, 4), PackedIntegerVector::chooseLayout(int8_type, -5, -2, true));
+}
+
+TEST(PackedIntegerVectorTest, values_and_matches_are_found_for_all_widths)
+{
+    for (int64_t span : std::vector<int64_t>({ 1, 3, 10, 200, 50000, int64_t(1) << 40 })) {
+        PackedIntegerVector vector(int64_type, PackedIntegerVector::chooseLayout(int64_type, -5, -5 + span - 1, false), 1000);
+        std::vector<int64_t> values;
+        for (uint32_t docId = 0; docId < 1000; ++docId) {
+            values.push_back(((docId % 5) == 0) ? undefined : (-5 + int64_t(docId * 7919) % span));
+            vector.set(docId, values.back());
+        }
+        int64_t low = -5 + span / 3;
+        int64_t high = -5 + span / 2;
+        uint64_t lowCode = 0;
+        uint64_t highCode = 0;
+        ASSERT_TRUE(vector.getCodeRange(low, high, lowCode, highCode));
+        std::vector<uint32_t> expHits;
+        for (uint32_t docId = 0; docId < 1000; ++docId) {
+            EXPECT_EQ(values[docId], vector.get(docId));
+            if (values[docId] != undefined && values[docId] >= low && values[docId] <= high) {
+                expHits.push_back(docId);
+            }
+        }
+        std::vector<uint32_t> hits;
+        for (uint32_t docId = vector.findNextMatch(3, 1000, lowCode, highCode); docId < 1000;
+             docId = vector.findNextMatch(docId + 1, 1000, lowCode, highCode))
+        {
+            hits.push_back(docId);
+        }
+        expHits.erase(expHits.begin(), std::lower_bound(expHits.begin(), expHits.end(), 3u));
+        EXPECT_EQ(expHits, hits) << "span=" << span;
+    }
+}
+
+TEST(PackedIntegerVectorTest, code_range_outside_layout_is_empty)
+{
+    PackedIntegerVector vector(int64_type, PackedIntegerVector::Layout(100, 4), 64);
+    uint64_t lowCode = 0;
+    uint64_t highCode = 0;
+    EXPECT_FALSE(vector.getCodeRange(0, 99, lowCode, highCode));
+    EXPECT_FALSE(vector.getCodeRange(115, 200, lowCode, highCode));
+    EXPECT_TRUE(vector.getCodeRange(0, 1000, lowCode, highCode));
+    EXPECT_EQ(1u, lowCode);
+    EXPECT_EQ(15u, highCode);
+}
+
+class PackedNumericAttributeTest : public ::testing::Test {
+protected:
+    DirectoryHandler _dir;
+    AttributeVector::SP _attr;
+
+    PackedNumericAttributeTest()
+        : ::testing::Test(),
+          _dir(test_dir),
+          _attr()
+    {
+    }
+    ~PackedNumericAttributeTest() override;
+
+    void create(bool packed = true) {
+        _attr = AttributeFactory::createAttribute(test_dir + "/attr", packedConfig(BasicType::INT64, packed));
+    }
+    IntegerAttribute &attr() { return dynamic_cast<IntegerAttribute &>(*_attr); }
+    const PackedInt64Attribute &packed() { return dynamic_cast<const PackedInt64Attribute &>(*_attr); }
+
+    void populate(uint32_t numDocs) {
+        _attr->addReservedDoc();
+        _attr->addDocs(numDocs - 1);
+        for (uint32_t docId = 1; docId < numDocs; ++docId) {
+            if (valueForDoc(docId) != undefined) {
+                attr().update(docId, valueForDoc(docId));
+            }
+        }
+        _attr->commit();
+    }
+    void saveAndLoad(bool packed = true) {
+        EXPECT_TRUE(_attr->save());
+        create(packed);
+        EXPECT_TRUE(_attr->load());
+    }
+    void assertValues(uint32_t numDocs) {
+        EXPECT_EQ(numDocs, _attr->getNumDocs());
+        for (uint32_t docId = 1; docId < numDocs; ++docId) {
+            EXPECT_EQ(valueForDoc(docId), _attr->getInt(docId)) << "docId=" << docId;
+        }
+    }
+    std::vector<uint32_t> search(const vespalib::string &term, bool strict) {
+        auto ctx = _attr->getSearch(std::make_unique<QueryTermSimple>(term, QueryTermSimple::WORD),
+                                    SearchContextParams());
+        TermFieldMatchData tfmd;
+        ctx->fetchPostings(ExecuteInfo::create(strict, 1.0));
+        auto itr = ctx->createIterator(&tfmd, strict);
+        uint32_t docIdLimit = _attr->getCommittedDocIdLimit();
+        itr->initRange(1, docIdLimit);
+        std::vector<uint32_t> hits;
+        for (uint32_t docId = 1; docId < docIdLimit; ++docId) {
+            if (itr->seek(docId)) {
+                hits.push_back(docId);
+            } else if (strict) {
+                docId = itr->getDocId() - 1;
+            }
+        }
+        return hits;
+    }
+    std::vector<uint32_t> get_hits(const vespalib::string &term, bool strict) {
+        auto ctx = _attr->getSearch(std::make_unique<QueryTermSimple>(term, QueryTermSimple::WORD),
+                                    SearchContextParams());
+        TermFieldMatchData tfmd;
+        ctx->fetchPostings(ExecuteInfo::create(strict, 1.0));
+        auto itr = ctx->createIterator(&tfmd, strict);
+        itr->initRange(1, _attr->getCommittedDocIdLimit());
+        auto bv = itr->get_hits(1);
+        std::vector<uint32_t> hits;
+        bv->foreach_truebit([&](uint32_t docId) { hits.push_back(docId); });
+        return hits;
+    }
+};
+
+PackedNumericAttributeTest::~PackedNumericAttributeTest() = default;
+
+template <typename T>
+bool
+isPacked(BasicType basicType, bool packed = true)
+{
+    auto attr = AttributeFactory::createAttribute("attr", packedConfig(basicType, packed));
+    return dynamic_cast<const SingleValuePackedNumericAttribute<IntegerAttributeTemplate<T>> *>(attr.get()) != nullptr;
+}
+
+TEST_F(PackedNumericAttributeTest, packed_config_creates_packed_attribute_for_integer_types)
+{
+    EXPECT_TRUE(isPacked<int8_t>(BasicType::INT8));
+    EXPECT_TRUE(isPacked<int16_t>(BasicType::INT16));
+    EXPECT_TRUE(isPacked<int32_t>(BasicType::INT32));
+    EXPECT_TRUE(isPacked<int64_t>(BasicType::INT64));
+    EXPECT_FALSE(isPacked<int64_t>(BasicType::INT64, false));
+}
+
+TEST_F(PackedNumericAttributeTest, width_is_selected_from_value_range_when_loading)
+{
+    uint32_t numDocs = 1000;
+    create();
+    populate(numDocs);
+    assertValues(numDocs);
+    saveAndLoad();
+    EXPECT_EQ(8u, packed().getBitsPerValue());
+    assertValues(numDocs);
+}
+
+TEST_F(PackedNumericAttributeTest, width_is_increased_when_update_does_not_fit)
+{
+    uint32_t numDocs = 1000;
+    create();
+    populate(numDocs);
+    saveAndLoad();
+    attr().update(5, 1000000);
+    _attr->commit();
+    EXPECT_EQ(32u, packed().getBitsPerValue());
+    EXPECT_EQ(1000000, _attr->getInt(5));
+    EXPECT_EQ(valueForDoc(6), _attr->getInt(6));
+    attr().update(6, -(int64_t(1) << 40));
+    _attr->commit();
+    EXPECT_EQ(64u, packed().getBitsPerValue());
+    EXPECT_EQ(1000000, _attr->getInt(5));
+    EXPECT_EQ(-(int64_t(1) << 40), _attr->getInt(6));
+    EXPECT_EQ(valueForDoc(7), _attr->getInt(7));
+}
+
+TEST_F(PackedNumericAttributeTest, attribute_data_is_compatible_with_plain_attribute)
+{
+    uint32_t numDocs = 1000;
+    create(false);
+    populate(numDocs);
+    saveAndLoad(true);
+    assertValues(numDocs);
+    saveAndLoad(false);
+    assertValues(numDocs);
+}
+
+TEST_F(PackedNumericAttributeTest, search_finds_values_with_strict_and_non_strict_iterators)
+{
+    uint32_t numDocs = 1000;
+    create();
+    populate(numDocs);
+    saveAndLoad();
+    std::vector<uint32_t> expHits;
+    for (uint32_t docId = 1; docId < numDocs; ++docId) {
+        int64_t value = valueForDoc(docId);
+        if (value != undefined && value >= 1010 && value <= 1020) {
+            expHits.push_back(docId);
+        }
+    }
+    EXPECT_FALSE(expHits.empty());
+    EXPECT_EQ(expHits, search("[1010;1020]", true));
+    EXPECT_EQ(expHits, search("[1010;1020]", false));
+    EXPECT_EQ(expHits, get_hits("[1010;1020]", true));
+    EXPECT_EQ(expHits, get_hits("[1010;1020]", false));
+    EXPECT_TRUE(search("[2000;3000]", true).empty());
+}
+
+TEST_F(PackedNumericAttributeTest, shrunk_lid_space_is_saved)
+{
+    uint32_t numDocs = 1000;
+    uint32_t shrunkDocs = 500;
+    create();
+    populate(numDocs);
+    _attr->compactLidSpace(shrunkDocs);
+    _attr->commit();
+    _attr->shrinkLidSpace();
+    EXPECT_EQ(shrunkDocs, _attr->getNumDocs());
+    saveAndLoad();
+    assertValues(shrunkDocs);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -0,0 +1,325 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/attribute/attributefactory.h>
+#include <vespa/searchlib/attribute/attributefilesavetarget.h>
+#include <vespa/searchlib/attribute/attributesaver.h>
+#include <vespa/searchlib/attribute/integerbase.h>
+#include <vespa/searchlib/attribute/paged_integer_block.h>
+#include <vespa/searchlib/attribute/paged_single_numeric_attribute.h>
+#include <vespa/searchlib/common/tunefileinfo.h>
+#include <vespa/searchlib/index/dummyfileheadercontext.h>
+#include <vespa/searchlib/query/query_term_simple.h>
+#include <vespa/searchlib/test/directory_handler.h>
+#include <vespa/searchcommon/attribute/config.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <thread>
+
+#include <vespa/log/log.h>
+LOG_SETUP("paged_numeric_attribute_test");
+
+using search::AttributeFactory;
+using search::AttributeFileSaveTarget;
+using search::AttributeSaver;
+using search::AttributeVector;
+using search::IntegerAttribute;
+using search::IntegerAttributeTemplate;
+using search::PagedSingleValueNumericAttribute;
+using search::QueryTermSimple;
+using search::TuneFileAttributes;
+using search::attribute::BasicType;
+using search::attribute::Config;
+using search::attribute::PagedIntegerBlock;
+using search::attribute::SearchContextParams;
+using search::index::DummyFileHeaderContext;
+using search::test::DirectoryHandler;
+
+using PagedInt64Attribute = PagedSingleValueNumericAttribute<IntegerAttributeTemplate<int64_t>>;
+
+namespace {
+
+const vespalib::string test_dir = "paged_numeric_attribute_data";
+constexpr int64_t undefined = std::numeric_limits<int64_t>::min();
+
+std::vector<int64_t>
+encodeAndDecode(const std::vector<int64_t> &values, uint8_t expBits)
+{
+    std::vector<uint64_t> words(3, 0);  // Block is appended after existing words
+    auto entry = PagedIntegerBlock::encode(values.data(), values.size(), undefined, words);
+    EXPECT_EQ(3u, entry.offset);
+    EXPECT_EQ(expBits, entry.bits);
+    EXPECT_EQ((values.size() * expBits + 63) / 64, entry.numWords);
+    EXPECT_EQ(3u + entry.numWords, words.size());
+    std::vector<int64_t> result(values.size());
+    PagedIntegerBlock::decode(entry, words.data() + entry.offset, values.size(), undefined, result.data());
+    return result;
+}
+
+Config
+pagedConfig(BasicType basicType, bool paged = true)
+{
+    Config cfg(basicType);
+    cfg.setPaged(paged);
+    return cfg;
+}
+
+int64_t
+valueForDoc(uint32_t docId)
+{
+    return ((docId % 7) == 3) ? undefined : (1000 + (docId * 37) % 500);
+}
+
+}
+
+TEST(PagedIntegerBlockTest, values_are_packed_relative_to_smallest_value)
+{
+    std::vector<int64_t> values({ 1000, 1003, 1001, 1007 });
+    EXPECT_EQ(values, encodeAndDecode(values, 3));
+}
+
+TEST(PagedIntegerBlockTest, undefined_values_are_kept_out_of_frame_of_reference)
+{
+    std::vector<int64_t> values({ 1000, undefined, 1003, undefined });
+    EXPECT_EQ(values, encodeAndDecode(values, 3));
+}
+
+TEST(PagedIntegerBlockTest, block_with_single_value_uses_no_bits)
+{
+    EXPECT_EQ(std::vector<int64_t>(5, 42), encodeAndDecode(std::vector<int64_t>(5, 42), 0));
+    EXPECT_EQ(std::vector<int64_t>(5, undefined), encodeAndDecode(std::vector<int64_t>(5, undefined), 0));
+}
+
+TEST(PagedIntegerBlockTest, values_spanning_word_boundaries_are_packed)
+{
+    std::vector<int64_t> values;
+    for (uint32_t i = 0; i < PagedIntegerBlock::BLOCK_SIZE; ++i) {
+        values.push_back(-5000 + int64_t(i * 7919) % 100000);
+    }
+    EXPECT_EQ(values, encodeAndDecode(values, 17));
+}
+
+TEST(PagedIntegerBlockTest, full_value_range_is_packed)
+{
+    std::vector<int64_t> values({ undefined + 1, std::numeric_limits<int64_t>::max(), 0, undefined });
+    EXPECT_EQ(values, encodeAndDecode(values, 64));
+}
+
+class PagedNumericAttributeTest : public ::testing::Test {
+protected:
+    DirectoryHandler _dir;
+    AttributeVector::SP _attr;
+
+    PagedNumericAttributeTest()
+        : ::testing::Test(),
+          _dir(test_dir),
+          _attr()
+    {
+    }
+    ~PagedNumericAttributeTest() override;
+
+    void create(bool paged = true) {
+        _attr = AttributeFactory::createAttribute(test_dir + "/attr", pagedConfig(BasicType::INT64, paged));
+    }
+    IntegerAttribute &attr() { return dynamic_cast<IntegerAttribute &>(*_attr); }
+    const PagedInt64Attribute &paged() { return dynamic_cast<const PagedInt64Attribute &>(*_attr); }
+
+    void populate(uint32_t numDocs) {
+        _attr->addReservedDoc();
+        _attr->addDocs(numDocs - 1);
+        for (uint32_t docId = 1; docId < numDocs; ++docId) {
+            if (valueForDoc(docId) != undefined) {
+                attr().update(docId, valueForDoc(docId));
+            }
+        }
+        _attr->commit();
+    }
+    void saveAndLoad(bool paged = true) {
+        EXPECT_TRUE(_attr->save());
+        create(paged);
+        EXPECT_TRUE(_attr->load());
+    }
+    void saveToFile(AttributeSaver &saver) {
+        TuneFileAttributes tuneFile;
+        DummyFileHeaderContext fileHeaderContext;
+        AttributeFileSaveTarget saveTarget(tuneFile, fileHeaderContext);
+        EXPECT_TRUE(saver.save(saveTarget));
+    }
+    void assertValues(uint32_t numDocs) {
+        EXPECT_EQ(numDocs, _attr->getNumDocs());
+        for (uint32_t docId = 1; docId < numDocs; ++docId) {
+            EXPECT_EQ(valueForDoc(docId), _attr->getInt(docId)) << "docId=" << docId;
+        }
+    }
+    std::vector<uint32_t> search(const vespalib::string &term) {
+        auto ctx = _attr->getSearch(std::make_unique<QueryTermSimple>(term, QueryTermSimple::WORD),
+                                    SearchContextParams());
+        std::vector<uint32_t> hits;
+        for (uint32_t docId = 1; docId < _attr->getCommittedDocIdLimit(); ++docId) {
+            if (ctx->matches(docId)) {
+                hits.push_back(docId);
+            }
+        }
+        return hits;
+    }
+};
+
+PagedNumericAttributeTest::~PagedNumericAttributeTest() = default;
+
+TEST_F(PagedNumericAttributeTest, paged_config_creates_paged_attribute_for_integer_types)
+{
+    for (auto basicType : { BasicType::INT8, BasicType::INT16, BasicType::INT32, BasicType::INT64 }) {
+        auto attr = AttributeFactory::createAttribute("attr", pagedConfig(basicType));
+        EXPECT_EQ(1u, attr->getVersion());
+    }
+    EXPECT_EQ(0u, AttributeFactory::createAttribute("attr", pagedConfig(BasicType::INT64, false))->getVersion());
+    EXPECT_EQ(0u, AttributeFactory::createAttribute("attr", pagedConfig(BasicType::DOUBLE))->getVersion());
+}
+
+TEST_F(PagedNumericAttributeTest, values_are_paged_in_after_load)
+{
+    uint32_t numDocs = 10 * PagedIntegerBlock::BLOCK_SIZE + 17;
+    create();
+    populate(numDocs);
+    assertValues(numDocs);
+    saveAndLoad();
+    EXPECT_EQ(0u, paged().getCacheStats().blocks);
+    assertValues(numDocs);
+    auto stats = paged().getCacheStats();
+    EXPECT_EQ(11u, stats.misses);
+    EXPECT_EQ(11u, stats.blocks);
+    EXPECT_LT(0u, stats.hits);
+}
+
+TEST_F(PagedNumericAttributeTest, updates_and_added_docs_are_kept_after_save_and_load)
+{
+    uint32_t numDocs = 3 * PagedIntegerBlock::BLOCK_SIZE;
+    create();
+    populate(numDocs);
+    saveAndLoad();
+    attr().update(5, 42);
+    attr().clearDoc(PagedIntegerBlock::BLOCK_SIZE + 1);
+    uint32_t docId = 0;
+    _attr->addDoc(docId);
+    EXPECT_EQ(numDocs, docId);
+    attr().update(docId, -7);
+    _attr->commit();
+    EXPECT_EQ(42, _attr->getInt(5));
+    EXPECT_EQ(valueForDoc(6), _attr->getInt(6));
+    EXPECT_EQ(undefined, _attr->getInt(PagedIntegerBlock::BLOCK_SIZE + 1));
+    EXPECT_EQ(-7, _attr->getInt(docId));
+    saveAndLoad();
+    EXPECT_EQ(numDocs + 1, _attr->getNumDocs());
+    EXPECT_EQ(42, _attr->getInt(5));
+    EXPECT_EQ(valueForDoc(6), _attr->getInt(6));
+    EXPECT_EQ(undefined, _attr->getInt(PagedIntegerBlock::BLOCK_SIZE + 1));
+    EXPECT_EQ(valueForDoc(2 * PagedIntegerBlock::BLOCK_SIZE + 1), _attr->getInt(2 * PagedIntegerBlock::BLOCK_SIZE + 1));
+    EXPECT_EQ(-7, _attr->getInt(docId));
+}
+
+TEST_F(PagedNumericAttributeTest, concurrent_reads_decode_each_block_once)
+{
+    uint32_t numDocs = 4 * PagedIntegerBlock::BLOCK_SIZE;
+    create();
+    populate(numDocs);
+    saveAndLoad();
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < 4; ++i) {
+        threads.emplace_back([this, numDocs]() {
+            for (uint32_t docId = 1; docId < numDocs; ++docId) {
+                EXPECT_EQ(valueForDoc(docId), _attr->getInt(docId));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    auto stats = paged().getCacheStats();
+    EXPECT_EQ(4u, stats.misses);
+    EXPECT_EQ(4u, stats.blocks);
+}
+
+TEST_F(PagedNumericAttributeTest, plain_attribute_data_can_be_loaded_as_paged)
+{
+    uint32_t numDocs = 2 * PagedIntegerBlock::BLOCK_SIZE + 5;
+    create(false);
+    populate(numDocs);
+    saveAndLoad(true);
+    assertValues(numDocs);
+    saveAndLoad(true);
+    assertValues(numDocs);
+}
+
+TEST_F(PagedNumericAttributeTest, search_finds_values_in_paged_blocks)
+{
+    uint32_t numDocs = 4 * PagedIntegerBlock::BLOCK_SIZE;
+    create();
+    populate(numDocs);
+    saveAndLoad();
+    std::vector<uint32_t> expHits;
+    for (uint32_t docId = 1; docId < numDocs; ++docId) {
+        int64_t value = valueForDoc(docId);
+        if (value != undefined && value >= 1100 && value <= 1110) {
+            expHits.push_back(docId);
+        }
+    }
+    EXPECT_FALSE(expHits.empty());
+    EXPECT_EQ(expHits, search("[1100;1110]"));
+}
+
+TEST_F(PagedNumericAttributeTest, shrunk_lid_space_is_saved)
+{
+    uint32_t numDocs = 2 * PagedIntegerBlock::BLOCK_SIZE;
+    uint32_t shrunkDocs = PagedIntegerBlock::BLOCK_SIZE + 10;
+    create();
+    populate(numDocs);
+    saveAndLoad();
+    _attr->compactLidSpace(shrunkDocs);
+    _attr->commit();
+    _attr->shrinkLidSpace();
+    EXPECT_EQ(shrunkDocs, _attr->getNumDocs());
+    saveAndLoad();
+    assertValues(shrunkDocs);
+}
+
+TEST_F(PagedNumericAttributeTest, saved_data_file_replaces_blocks_not_changed_since_save)
+{
+    uint32_t numDocs = 3 * PagedIntegerBlock::BLOCK_SIZE;
+    uint32_t changedDoc = PagedIntegerBlock::BLOCK_SIZE + 1;
+    create();
+    populate(numDocs);
+    EXPECT_EQ(3u, paged().getDirtyBlockCount());
+    auto saver = _attr->initSave(test_dir + "/saved");
+    ASSERT_TRUE(saver);
+    attr().update(changedDoc, 42);
+    _attr->commit();
+    saveToFile(*saver);
+    EXPECT_EQ(3u, paged().getDirtyBlockCount());
+    _attr->commit();
+    EXPECT_EQ(1u, paged().getDirtyBlockCount());
+    EXPECT_EQ(42, _attr->getInt(changedDoc));
+    for (uint32_t docId = 1; docId < numDocs; ++docId) {
+        if (docId != changedDoc) {
+            EXPECT_EQ(valueForDoc(docId), _attr->getInt(docId)) << "docId=" << docId;
+        }
+    }
+    auto stats = paged().getCacheStats();
+    EXPECT_EQ(2u, stats.misses);
+    EXPECT_EQ(2u, stats.blocks);
+}
+
+TEST_F(PagedNumericAttributeTest, saved_data_file_is_ignored_when_newer_save_is_initiated)
+{
+    uint32_t numDocs = 2 * PagedIntegerBlock::BLOCK_SIZE;
+    create();
+    populate(numDocs);
+    auto saver = _attr->initSave(test_dir + "/saved");
+    auto newerSaver = _attr->initSave(test_dir + "/newer");
+    saveToFile(*saver);
+    _attr->commit();
+    EXPECT_EQ(2u, paged().getDirtyBlockCount());
+    saveToFile(*newerSaver);
+    _attr->commit();
+    EXPECT_EQ(0u, paged().getDirtyBlockCount());
+    assertValues(numDocs);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
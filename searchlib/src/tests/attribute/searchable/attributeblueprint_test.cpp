@@ -373,6 +373,61 @@ TEST(AttributeBlueprintTest, nearest_neighbor_blueprint_is_created_by_attribute_
     expect_nearest_neighbor_blueprint("tensor<float>(x[2])", x_2_double, x_2_float);
 }
 
+TEST(AttributeBlueprintTest, nearest_neighbor_blueprint_splits_batch_of_query_points)
+{
+    // the batch dimension (y) is ordered after the attribute tensor dimension (x)
+    TensorSpec batch = TensorSpec("tensor<float>(x[2],y[3])")
+            .add({{"x", 0}, {"y", 0}}, 1).add({{"x", 1}, {"y", 0}}, 2)
+            .add({{"x", 0}, {"y", 1}}, 3).add({{"x", 1}, {"y", 1}}, 4)
+            .add({{"x", 0}, {"y", 2}}, 5).add({{"x", 1}, {"y", 2}}, 6);
+    NearestNeighborFixture f(make_tensor_attribute(field, "tensor(x[2])"));
+    f.set_query_tensor(batch);
+    auto result = f.create_blueprint();
+    const auto& nearest = downcast<const NearestNeighborBlueprint>(*result);
+    ASSERT_TRUE(nearest.is_batch());
+    const auto& points = nearest.get_batch_query_tensors();
+    ASSERT_EQ(3u, points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        auto exp = TensorSpec("tensor(x[2])").add({{"x", 0}}, 2 * i + 1).add({{"x", 1}}, 2 * i + 2);
+        EXPECT_EQ(exp, DefaultTensorEngine::ref().to_spec(*points[i]));
+    }
+    EXPECT_EQ(7u, nearest.get_target_num_hits());
+}
+
+void
+expect_int8_cells(const vespalib::tensor::DenseTensorView& tensor, const std::vector<int8_t>& exp)
+{
+    auto cells = tensor.cellsRef().typify<int8_t>();
+    EXPECT_EQ(exp, std::vector<int8_t>(cells.begin(), cells.end()));
+}
+
+TEST(AttributeBlueprintTest, nearest_neighbor_blueprint_quantizes_query_tensor_as_int8_attribute)
+{
+    // query cells are rounded to nearest and saturated, as when stored in the attribute
+    TensorSpec x_3_double = TensorSpec("tensor(x[3])").add({{"x", 0}}, 1.6).add({{"x", 1}}, -1.6).add({{"x", 2}}, 300);
+    NearestNeighborFixture f(make_tensor_attribute(field, "tensor<int8>(x[3])"));
+    f.set_query_tensor(x_3_double);
+    auto result = f.create_blueprint();
+    const auto& nearest = downcast<const NearestNeighborBlueprint>(*result);
+    expect_int8_cells(nearest.get_query_tensor(), {2, -2, 127});
+}
+
+TEST(AttributeBlueprintTest, nearest_neighbor_blueprint_quantizes_batch_of_query_points_as_int8_attribute)
+{
+    TensorSpec batch = TensorSpec("tensor<float>(x[2],y[2])")
+            .add({{"x", 0}, {"y", 0}}, 1.6).add({{"x", 1}, {"y", 0}}, -1.6)
+            .add({{"x", 0}, {"y", 1}}, 300).add({{"x", 1}, {"y", 1}}, -300);
+    NearestNeighborFixture f(make_tensor_attribute(field, "tensor<int8>(x[2])"));
+    f.set_query_tensor(batch);
+    auto result = f.create_blueprint();
+    const auto& nearest = downcast<const NearestNeighborBlueprint>(*result);
+    ASSERT_TRUE(nearest.is_batch());
+    const auto& points = nearest.get_batch_query_tensors();
+    ASSERT_EQ(2u, points.size());
+    expect_int8_cells(*points[0], {2, -2});
+    expect_int8_cells(*points[1], {127, -128});
+}
+
 void
 expect_empty_blueprint(AttributeVector::SP attr, const TensorSpec& query_tensor, bool insert_query_tensor = true)
 {
@@ -395,6 +450,8 @@ TEST(AttributeBlueprintTest, empty_blueprint_is_created_when_nearest_neighbor_te
     TensorSpec sparse_x = TensorSpec("tensor(x{})").add({{"x", 0}}, 3);
     TensorSpec dense_y_2 = TensorSpec("tensor(y[2])").add({{"y", 0}}, 3).add({{"y", 1}}, 5);
     TensorSpec dense_x_3 = TensorSpec("tensor(x[3])").add({{"x", 0}}, 3).add({{"x", 1}}, 5).add({{"x", 2}}, 7);
+    TensorSpec dense_y_2_z_2 = TensorSpec("tensor(y[2],z[2])").add({{"y", 0}, {"z", 0}}, 3);
+    TensorSpec dense_x_3_z_2 = TensorSpec("tensor(x[3],z[2])").add({{"x", 0}, {"z", 0}}, 3);
     expect_empty_blueprint(make_int_attribute(field)); // attribute is not a tensor
     expect_empty_blueprint(make_tensor_attribute(field, "tensor(x{})")); // attribute is not a dense tensor
     expect_empty_blueprint(make_tensor_attribute(field, "tensor(x[2],y[2])")); // tensor type is not of order 1
@@ -402,6 +459,8 @@ TEST(AttributeBlueprintTest, empty_blueprint_is_created_when_nearest_neighbor_te
     expect_empty_blueprint(make_tensor_attribute(field, "tensor(x[2])"), sparse_x); // query tensor is not dense
     expect_empty_blueprint(make_tensor_attribute(field, "tensor(x[2])"), dense_y_2); // tensor types are not compatible
     expect_empty_blueprint(make_tensor_attribute(field, "tensor(x[2])"), dense_x_3); // tensor types are not same size
+    expect_empty_blueprint(make_tensor_attribute(field, "tensor(x[2])"), dense_y_2_z_2); // batch without attribute dimension
+    expect_empty_blueprint(make_tensor_attribute(field, "tensor(x[2])"), dense_x_3_z_2); // batch with wrong dimension size
 }
 
 TEST(AttributeBlueprintTest, attribute_field_blueprint_wraps_filter_search_iterator)
@@ -19,6 +19,7 @@
 #include <vespa/searchlib/test/searchiteratorverifier.h>
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/vespalib/util/compress.h>
+#include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/searchlib/attribute/attributevector.hpp>
 
 #include <vespa/log/log.h>
@@ -273,6 +274,10 @@ private:
     void single_bool_attribute_search_context_handles_true_and_false_queries();
     void single_bool_attribute_search_iterator_handles_true_and_false_queries();
 
+    template <typename VectorType, typename ValueType>
+    void requireThatTermwiseHitsMatchSeekAndUnpack(const vespalib::string & name, const Config & cfg);
+    void requireThatTermwiseHitsMatchSeekAndUnpack();
+
     // init maps with config objects
     void initIntegerConfig();
     void initFloatConfig();
@@ -1904,6 +1909,145 @@ SearchContextTest::single_bool_attribute_search_iterator_handles_true_and_false_
     EXPECT_EQUAL(false_exp, f.search_iterator("0", true));
 }
 
+namespace {
+
+SimpleResult
+toResult(const BitVector & bv, uint32_t beginId, uint32_t endId)
+{
+    SimpleResult result;
+    bv.foreach_truebit([&](uint32_t docId) { result.addHit(docId); }, beginId, endId - 1);
+    return result;
+}
+
+}
+
+template <typename VectorType, typename ValueType>
+void
+SearchContextTest::requireThatTermwiseHitsMatchSeekAndUnpack(const vespalib::string & name, const Config & cfg)
+{
+    LOG(info, "requireThatTermwiseHitsMatchSeekAndUnpack: vector '%s'", name.c_str());
+    // docid limit 301 leaves a tail of 45 docs after the last full block of 64 docs
+    const uint32_t numDocs = 300;
+    AttributePtr ptr = AttributeFactory::createAttribute(name, cfg);
+    auto & vec = dynamic_cast<VectorType &>(*ptr);
+    addDocs(vec, numDocs);
+    for (uint32_t docId = 1; docId <= numDocs; ++docId) {
+        EXPECT_TRUE(vec.update(docId, static_cast<ValueType>((docId * 7) % 11)));
+    }
+    ptr->commit(true);
+    const uint32_t docIdLimit = ptr->getCommittedDocIdLimit();
+    ASSERT_EQUAL(numDocs + 1, docIdLimit);
+
+    for (bool strict : {false, true}) {
+        for (uint32_t beginId : {1u, 37u, 64u, 100u}) {
+            for (uint32_t endId : {docIdLimit, 256u, 250u, 120u}) {
+                TEST_STATE(vespalib::make_string("strict=%d, begin=%u, end=%u", strict, beginId, endId).c_str());
+                SimpleResult expected;
+                for (uint32_t docId = beginId; docId < endId; ++docId) {
+                    uint32_t value = (docId * 7) % 11;
+                    if ((3 <= value) && (value <= 6)) {
+                        expected.addHit(docId);
+                    }
+                }
+
+                // one doc at a time
+                SimpleResult seekResult;
+                DocSet seekHits;
+                {
+                    TermFieldMatchData tfmd;
+                    SearchContextPtr sc = getSearch(vec, "[3;6]");
+                    sc->fetchPostings(queryeval::ExecuteInfo::create(strict, 1.0));
+                    SearchBasePtr sb = sc->createIterator(&tfmd, strict);
+                    sb->initRange(beginId, endId);
+                    for (uint32_t docId = beginId; docId < endId; ++docId) {
+                        if (sb->seek(docId)) {
+                            sb->unpack(docId);
+                            EXPECT_EQUAL(docId, tfmd.getDocId());
+                            seekResult.addHit(docId);
+                            seekHits.put(docId);
+                        }
+                    }
+                }
+                EXPECT_EQUAL(expected, seekResult);
+
+                TermFieldMatchData tfmd;
+                SearchContextPtr sc = getSearch(vec, "[3;6]");
+                sc->fetchPostings(queryeval::ExecuteInfo::create(strict, 1.0));
+                { // get_hits
+                    SearchBasePtr sb = sc->createIterator(&tfmd, strict);
+                    sb->initRange(beginId, endId);
+                    EXPECT_EQUAL(seekResult, toResult(*sb->get_hits(beginId), beginId, endId));
+                }
+                { // and_hits_into
+                    SearchBasePtr sb = sc->createIterator(&tfmd, strict);
+                    sb->initRange(beginId, endId);
+                    BitVector::UP result = BitVector::create(beginId, endId);
+                    SimpleResult andExpected;
+                    for (uint32_t docId = beginId; docId < endId; ++docId) {
+                        if ((docId % 3) != 0) {
+                            result->setBit(docId);
+                            if ((seekHits.count(docId) != 0)) {
+                                andExpected.addHit(docId);
+                            }
+                        }
+                    }
+                    result->invalidateCachedCount();
+                    sb->and_hits_into(*result, beginId);
+                    EXPECT_EQUAL(andExpected, toResult(*result, beginId, endId));
+                }
+                { // or_hits_into
+                    SearchBasePtr sb = sc->createIterator(&tfmd, strict);
+                    sb->initRange(beginId, endId);
+                    BitVector::UP result = BitVector::create(beginId, endId);
+                    SimpleResult orExpected;
+                    for (uint32_t docId = beginId; docId < endId; ++docId) {
+                        if ((docId % 5) == 0) {
+                            result->setBit(docId);
+                        }
+                        if (((docId % 5) == 0) || (seekHits.count(docId) != 0)) {
+                            orExpected.addHit(docId);
+                        }
+                    }
+                    result->invalidateCachedCount();
+                    sb->or_hits_into(*result, beginId);
+                    EXPECT_EQUAL(orExpected, toResult(*result, beginId, endId));
+                }
+            }
+        }
+    }
+}
+
+void
+SearchContextTest::requireThatTermwiseHitsMatchSeekAndUnpack()
+{
+    // single value attributes without fast-search, producing termwise hits by scanning the value array in blocks
+    {
+        Config cfg(BasicType::INT8, CollectionType::SINGLE);
+        TEST_DO((requireThatTermwiseHitsMatchSeekAndUnpack<IntegerAttribute, largeint_t>("s-int8", cfg)));
+    }
+    {
+        Config cfg(BasicType::INT32, CollectionType::SINGLE);
+        TEST_DO((requireThatTermwiseHitsMatchSeekAndUnpack<IntegerAttribute, largeint_t>("s-int32", cfg)));
+    }
+    {
+        Config cfg(BasicType::INT32, CollectionType::SINGLE);
+        cfg.setIsFilter(true);
+        TEST_DO((requireThatTermwiseHitsMatchSeekAndUnpack<IntegerAttribute, largeint_t>("s-filter-int32", cfg)));
+    }
+    {
+        Config cfg(BasicType::INT64, CollectionType::SINGLE);
+        TEST_DO((requireThatTermwiseHitsMatchSeekAndUnpack<IntegerAttribute, largeint_t>("s-int64", cfg)));
+    }
+    {
+        Config cfg(BasicType::FLOAT, CollectionType::SINGLE);
+        TEST_DO((requireThatTermwiseHitsMatchSeekAndUnpack<FloatingPointAttribute, double>("s-float", cfg)));
+    }
+    {
+        Config cfg(BasicType::DOUBLE, CollectionType::SINGLE);
+        TEST_DO((requireThatTermwiseHitsMatchSeekAndUnpack<FloatingPointAttribute, double>("s-double", cfg)));
+    }
+}
+
 void
 SearchContextTest::initIntegerConfig()
 {
@@ -2036,6 +2180,7 @@ SearchContextTest::Main()
     TEST_DO(requireThatOutOfBoundsSearchTermGivesZeroHits());
     TEST_DO(single_bool_attribute_search_context_handles_true_and_false_queries());
     TEST_DO(single_bool_attribute_search_iterator_handles_true_and_false_queries());
+    TEST_DO(requireThatTermwiseHitsMatchSeekAndUnpack());
 
     TEST_DONE();
 }
@@ -7,12 +7,17 @@
 #include <vespa/fastos/file.h>
 #include <vespa/searchlib/attribute/attribute_read_guard.h>
 #include <vespa/searchlib/attribute/attributeguard.h>
+#include <vespa/searchlib/fef/matchdata.h>
+#include <vespa/searchlib/fef/termfieldmatchdataarray.h>
 #include <vespa/searchlib/queryeval/nearest_neighbor_blueprint.h>
+#include <vespa/searchlib/queryeval/simpleresult.h>
 #include <vespa/searchlib/tensor/default_nearest_neighbor_index_factory.h>
 #include <vespa/searchlib/tensor/dense_tensor_attribute.h>
+#include <vespa/searchlib/tensor/distance_functions.h>
 #include <vespa/searchlib/tensor/doc_vector_access.h>
 #include <vespa/searchlib/tensor/generic_tensor_attribute.h>
 #include <vespa/searchlib/tensor/hnsw_index.h>
+#include <vespa/searchlib/tensor/ivf_pq_index.h>
 #include <vespa/searchlib/tensor/nearest_neighbor_index.h>
 #include <vespa/searchlib/tensor/nearest_neighbor_index_factory.h>
 #include <vespa/searchlib/tensor/nearest_neighbor_index_saver.h>
@@ -33,13 +38,16 @@ using search::AttributeGuard;
 using search::AttributeVector;
 using search::attribute::DistanceMetric;
 using search::attribute::HnswIndexParams;
+using search::attribute::IvfPqIndexParams;
 using search::queryeval::GlobalFilter;
 using search::queryeval::NearestNeighborBlueprint;
+using search::queryeval::SimpleResult;
 using search::tensor::DefaultNearestNeighborIndexFactory;
 using search::tensor::DenseTensorAttribute;
 using search::tensor::DocVectorAccess;
 using search::tensor::GenericTensorAttribute;
 using search::tensor::HnswIndex;
+using search::tensor::IvfPqIndex;
 using search::tensor::HnswNode;
 using search::tensor::NearestNeighborIndex;
 using search::tensor::NearestNeighborIndexFactory;
@@ -118,6 +126,7 @@ private:
     generation_t _trim_gen;
     mutable size_t _memory_usage_cnt;
     int _index_value;
+    search::tensor::SquaredEuclideanDistance<double> _distance_func;
 
 public:
     MockNearestNeighborIndex(const DocVectorAccess& vectors)
@@ -129,7 +138,8 @@ public:
           _transfer_gen(std::numeric_limits<generation_t>::max()),
           _trim_gen(std::numeric_limits<generation_t>::max()),
           _memory_usage_cnt(0),
-          _index_value(0)
+          _index_value(0),
+          _distance_func()
     {
     }
     void clear() {
@@ -237,7 +247,7 @@ public:
     }
 
     
-    const search::tensor::DistanceFunction *distance_function() const override { return nullptr; }
+    const search::tensor::DistanceFunction *distance_function() const override { return &_distance_func; }
 };
 
 class MockNearestNeighborIndexFactory : public NearestNeighborIndexFactory {
@@ -251,6 +261,15 @@ class MockNearestNeighborIndexFactory : public NearestNeighborIndexFactory {
         assert(cell_type == ValueType::CellType::DOUBLE);
         return std::make_unique<MockNearestNeighborIndex>(vectors);
     }
+    std::unique_ptr<NearestNeighborIndex> make(const DocVectorAccess& vectors,
+                                               size_t vector_size,
+                                               ValueType::CellType cell_type,
+                                               const search::attribute::IvfPqIndexParams& params) const override {
+        (void) vector_size;
+        (void) params;
+        assert(cell_type == ValueType::CellType::DOUBLE);
+        return std::make_unique<MockNearestNeighborIndex>(vectors);
+    }
 };
 
 const vespalib::string test_dir = "test_data/";
@@ -321,6 +340,12 @@ struct Fixture {
         setup();
     }
 
+    void set_ivf_pq_index_params(const IvfPqIndexParams &params) {
+        _cfg.clear_hnsw_index_params();
+        _cfg.set_ivf_pq_index_params(params);
+        setup();
+    }
+
     std::shared_ptr<TensorAttribute> makeAttr() {
         if (_useDenseTensorAttribute) {
             assert(_denseTensors);
@@ -348,6 +373,10 @@ struct Fixture {
         return get_nearest_neighbor_index<HnswIndex>();
     }
 
+    IvfPqIndex& ivf_pq_index() {
+        return get_nearest_neighbor_index<IvfPqIndex>();
+    }
+
     MockNearestNeighborIndex& mock_index() {
         return get_nearest_neighbor_index<MockNearestNeighborIndex>();
     }
@@ -704,6 +733,34 @@ TEST_F("Hnsw index is integrated in dense tensor attribute and can be saved and
     expect_level_0(1, index_b.get_node(2));
 }
 
+class DenseTensorAttributeIvfPqIndex : public Fixture {
+public:
+    DenseTensorAttributeIvfPqIndex() : Fixture(vec_2d_spec, true, false, false) {
+        set_ivf_pq_index_params(IvfPqIndexParams(2, 2, DistanceMetric::Euclidean));
+    }
+};
+
+TEST_F("Ivf-pq index is integrated in dense tensor attribute and can be saved and loaded", DenseTensorAttributeIvfPqIndex)
+{
+    f.set_tensor(1, vec_2d(3, 5));
+    f.set_tensor(2, vec_2d(7, 9));
+
+    auto &index_a = f.ivf_pq_index();
+    EXPECT_EQUAL(2u, index_a.config().num_centroids());
+    EXPECT_EQUAL(2u, index_a.config().num_subquantizers());
+    EXPECT_TRUE(index_a.has_document(1));
+    EXPECT_TRUE(index_a.has_document(2));
+    f.save();
+    EXPECT_TRUE(vespalib::fileExists(attr_name + ".nnidx"));
+
+    f.load();
+    auto &index_b = f.ivf_pq_index();
+    EXPECT_NOT_EQUAL(&index_a, &index_b);
+    EXPECT_TRUE(index_b.has_document(1));
+    EXPECT_TRUE(index_b.has_document(2));
+    EXPECT_FALSE(index_b.has_document(3));
+}
+
 class DenseTensorAttributeMockIndex : public Fixture {
 public:
     DenseTensorAttributeMockIndex() : Fixture(vec_2d_spec, true, true, true) {}
@@ -887,15 +944,15 @@ public:
         return std::unique_ptr<QueryTensor>(tensor);
     }
 
-    std::unique_ptr<NearestNeighborBlueprint> make_blueprint(double brute_force_limit = 0.05) {
+    std::unique_ptr<NearestNeighborBlueprint> make_blueprint(double brute_force_limit = 0.05, bool approximate = true) {
         search::queryeval::FieldSpec field("foo", 0, 0);
         auto bp = std::make_unique<NearestNeighborBlueprint>(
             field,
             as_dense_tensor(),
             createDenseTensor(vec_2d(17, 42)),
-            3, true, 5, brute_force_limit);
+            3, approximate, 5, brute_force_limit, 4.0);
         EXPECT_EQUAL(11u, bp->getState().estimate().estHits);
-        EXPECT_TRUE(bp->may_approximate());
+        EXPECT_EQUAL(approximate, bp->may_approximate());
         return bp;
     }
 };
@@ -907,6 +964,8 @@ TEST_F("NN blueprint handles empty filter", NearestNeighborBlueprintFixture)
     bp->set_global_filter(*empty_filter);
     EXPECT_EQUAL(3u, bp->getState().estimate().estHits);
     EXPECT_TRUE(bp->may_approximate());
+    EXPECT_TRUE(bp->get_algorithm() == NearestNeighborBlueprint::Algorithm::INDEX_TOP_K);
+    EXPECT_EQUAL(8u, bp->get_explore_k());
 }
 
 TEST_F("NN blueprint handles strong filter", NearestNeighborBlueprintFixture)
@@ -919,6 +978,9 @@ TEST_F("NN blueprint handles strong filter", NearestNeighborBlueprintFixture)
     bp->set_global_filter(*strong_filter);
     EXPECT_EQUAL(1u, bp->getState().estimate().estHits);
     EXPECT_TRUE(bp->may_approximate());
+    EXPECT_TRUE(bp->get_algorithm() == NearestNeighborBlueprint::Algorithm::INDEX_TOP_K_WITH_FILTER);
+    // explore_k is adjusted by 11 (1 / hit ratio), limited to max adjustment factor (4)
+    EXPECT_EQUAL(32u, bp->get_explore_k());
 }
 
 TEST_F("NN blueprint handles weak filter", NearestNeighborBlueprintFixture)
@@ -946,8 +1008,42 @@ TEST_F("NN blueprint handles strong filter triggering brute force search", Neare
     filter->invalidateCachedCount();
     auto strong_filter = GlobalFilter::create(std::move(filter));
     bp->set_global_filter(*strong_filter);
+    // exact search over the filter is done up front
+    EXPECT_EQUAL(1u, bp->getState().estimate().estHits);
+    EXPECT_FALSE(bp->may_approximate());
+    EXPECT_TRUE(bp->get_algorithm() == NearestNeighborBlueprint::Algorithm::EXACT_FILTER_FIRST);
+}
+
+TEST_F("NN blueprint finds exact nearest neighbors in filter when triggering brute force search", NearestNeighborBlueprintFixture)
+{
+    auto bp = f.make_blueprint(0.9);
+    auto filter = search::BitVector::create(11);
+    for (uint32_t docid : {2, 4, 5, 8, 10}) {
+        filter->setBit(docid);
+    }
+    filter->invalidateCachedCount();
+    auto global_filter = GlobalFilter::create(std::move(filter));
+    bp->set_global_filter(*global_filter);
+    EXPECT_EQUAL(3u, bp->getState().estimate().estHits);
+    EXPECT_TRUE(bp->get_algorithm() == NearestNeighborBlueprint::Algorithm::EXACT_FILTER_FIRST);
+    auto md = search::fef::MatchData::makeTestInstance(1, 1);
+    search::fef::TermFieldMatchDataArray tfmda;
+    tfmda.add(md->resolveTermField(0));
+    auto search = bp->createLeafSearch(tfmda, true);
+    EXPECT_EQUAL(SimpleResult({4, 5, 8}), SimpleResult().searchStrict(*search, 11));
+}
+
+TEST_F("NN blueprint does not search filter up front for exact search", NearestNeighborBlueprintFixture)
+{
+    auto bp = f.make_blueprint(0.2, false);
+    auto filter = search::BitVector::create(11);
+    filter->setBit(3);
+    filter->invalidateCachedCount();
+    auto strong_filter = GlobalFilter::create(std::move(filter));
+    bp->set_global_filter(*strong_filter);
     EXPECT_EQUAL(11u, bp->getState().estimate().estHits);
     EXPECT_FALSE(bp->may_approximate());
+    EXPECT_TRUE(bp->get_algorithm() == NearestNeighborBlueprint::Algorithm::EXACT);
 }
 
 TEST_MAIN() { TEST_RUN_ALL(); }
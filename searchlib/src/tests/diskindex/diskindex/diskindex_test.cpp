@@ -17,6 +17,7 @@
 #include <vespa/vespalib/io/fileutil.h>
 #include <iostream>
 #include <set>
+#include <thread>
 
 using search::BitVectorIterator;
 using namespace search::fef;
@@ -62,6 +63,8 @@ private:
     void requireThatBlueprintIsCreated();
     void requireThatBlueprintCanCreateSearchIterators();
     void requireThatSearchIteratorsConforms();
+    void require_that_posting_list_cache_is_shared_between_reads();
+    void require_that_concurrent_cache_misses_read_posting_list_once();
 public:
     Test();
     ~Test();
@@ -303,6 +306,77 @@ Test::requireThatBlueprintCanCreateSearchIterators()
     }
 }
 
+void
+Test::require_that_posting_list_cache_is_shared_between_reads()
+{
+    auto cache = std::make_shared<PostingListCache>(1024 * 1024);
+    DiskIndex index("index/1", 0, cache);
+    ASSERT_TRUE(index.setup(TuneFileSearch()));
+    { // posting list for word 'w1' in field 'f1'
+        LookupResult::UP r = index.lookup(0, "w1");
+        auto h1 = index.readCachedPostingList(*r);
+        auto h2 = index.readCachedPostingList(*r);
+        ASSERT_TRUE(h1);
+        EXPECT_TRUE(h1.get() == h2.get());
+        TermFieldMatchDataArray mda;
+        std::unique_ptr<SearchIterator> sb(h2->createIterator(r->counts, mda));
+        sb->initFullRange();
+        EXPECT_EQUAL("1,3", toString(*sb));
+    }
+    { // bit vector for word 'w2' in field 'f2'
+        LookupResult::UP r = index.lookup(1, "w2");
+        auto bv1 = index.readCachedBitVector(*r);
+        auto bv2 = index.readCachedBitVector(*r);
+        ASSERT_TRUE(bv1);
+        EXPECT_TRUE(bv1.get() == bv2.get());
+        EXPECT_EQUAL(17u, bv2->countTrueBits());
+    }
+    { // no bit vector for word 'w1' in field 'f2', nothing cached
+        LookupResult::UP r = index.lookup(1, "w1");
+        EXPECT_TRUE(!index.readCachedBitVector(*r));
+    }
+    CacheStats stats = cache->getCacheStats();
+    EXPECT_EQUAL(1u, stats.hits);
+    EXPECT_EQUAL(1u, stats.misses);
+    EXPECT_EQUAL(2u, stats.elements);
+    EXPECT_LESS(0u, stats.memory_used);
+    CacheStats bitVectorStats = cache->getBitVectorCacheStats();
+    EXPECT_EQUAL(1u, bitVectorStats.hits);
+    EXPECT_EQUAL(2u, bitVectorStats.misses);
+    { // a new disk index instance (e.g. after fusion) does not see entries of the old one
+        DiskIndex newIndex("index/1", 0, cache);
+        ASSERT_TRUE(newIndex.setup(TuneFileSearch()));
+        LookupResult::UP r = newIndex.lookup(0, "w1");
+        EXPECT_TRUE(newIndex.readCachedPostingList(*r));
+        EXPECT_EQUAL(2u, cache->getCacheStats().misses);
+        EXPECT_EQUAL(3u, cache->getCacheStats().elements);
+    }
+}
+
+void
+Test::require_that_concurrent_cache_misses_read_posting_list_once()
+{
+    auto cache = std::make_shared<PostingListCache>(1024 * 1024);
+    DiskIndex index("index/1", 0, cache);
+    ASSERT_TRUE(index.setup(TuneFileSearch()));
+    LookupResult::UP r = index.lookup(0, "w1");
+    constexpr size_t num_threads = 4;
+    std::vector<std::shared_ptr<const PostingListHandle>> handles(num_threads);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&index, &r, &handles, i]() { handles[i] = index.readCachedPostingList(*r); });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (const auto &handle : handles) {
+        EXPECT_TRUE(handle.get() == handles[0].get());
+    }
+    CacheStats stats = cache->getCacheStats();
+    EXPECT_EQUAL(1u, stats.misses);
+    EXPECT_EQUAL(num_threads - 1, stats.hits);
+}
+
 Test::Test() = default;
 
 Test::~Test() = default;
@@ -339,6 +413,8 @@ Test::Main()
     TEST_DO(requireThatWeCanReadBitVector());
     TEST_DO(requireThatBlueprintIsCreated());
     TEST_DO(requireThatBlueprintCanCreateSearchIterators());
+    TEST_DO(require_that_posting_list_cache_is_shared_between_reads());
+    TEST_DO(require_that_concurrent_cache_misses_read_posting_list_once());
 
     TEST_DO(openIndex("index/2", true, false, false, false, false));
     TEST_DO(requireThatLookupIsWorking(false, false, false));
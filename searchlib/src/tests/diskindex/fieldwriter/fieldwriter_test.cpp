@@ -196,7 +196,7 @@ WrappedFieldWriter::open()
     _fieldWriter = std::make_unique<FieldWriter>(_docIdLimit, _numWordIds);
     _fieldWriter->open(_namepref,
                        minSkipDocs, minChunkDocs,
-                       _dynamicK, _encode_interleaved_features,
+                       _dynamicK, _encode_interleaved_features, false,
                        _schema, _indexId,
                        FieldLengthInfo(4.5, 42),
                        tuneFileWrite, fileHeaderContext);
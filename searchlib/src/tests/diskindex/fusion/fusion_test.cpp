@@ -4,6 +4,7 @@
 #include <vespa/searchlib/diskindex/fusion.h>
 #include <vespa/searchlib/diskindex/indexbuilder.h>
 #include <vespa/searchlib/diskindex/zcposoccrandread.h>
+#include <vespa/searchlib/fef/matchdatalayout.h>
 #include <vespa/searchlib/fef/fieldpositionsiterator.h>
 #include <vespa/searchlib/fef/termfieldmatchdata.h>
 #include <vespa/searchlib/index/docbuilder.h>
@@ -11,6 +12,8 @@
 #include <vespa/searchlib/memoryindex/document_inverter.h>
 #include <vespa/searchlib/memoryindex/field_index_collection.h>
 #include <vespa/searchlib/memoryindex/posting_iterator.h>
+#include <vespa/searchlib/queryeval/iblockmaxweights.h>
+#include <vespa/searchlib/queryeval/wand/parallel_weak_and_search.h>
 #include <vespa/searchlib/test/index/mock_field_length_inspector.h>
 #include <vespa/searchlib/util/filekit.h>
 #include <vespa/vespalib/btree/btreenode.hpp>
@@ -19,7 +22,12 @@
 #include <vespa/vespalib/io/fileutil.h>
 #include <vespa/vespalib/util/threadstackexecutor.h>
 #include <vespa/vespalib/util/sequencedtaskexecutor.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/searchcommon/common/schemaconfigurer.h>
+#include <vespa/config-indexschema.h>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cassert>
 
 #include <vespa/log/log.h>
 LOG_SETUP("fusion_test");
@@ -28,16 +36,23 @@ namespace search {
 
 using document::Document;
 using fef::FieldPositionsIterator;
+using fef::MatchDataLayout;
+using fef::TermFieldHandle;
 using fef::TermFieldMatchData;
 using fef::TermFieldMatchDataArray;
 using memoryindex::DocumentInverter;
 using memoryindex::FieldIndexCollection;
+using queryeval::IBlockMaxWeights;
+using queryeval::ParallelWeakAndSearch;
 using queryeval::SearchIterator;
+using queryeval::SharedWeakAndPriorityQueue;
 using search::common::FileHeaderContext;
 using search::index::schema::CollectionType;
 using search::index::schema::DataType;
 using search::index::test::MockFieldLengthInspector;
 using vespalib::SequencedTaskExecutor;
+using vespa::config::search::IndexschemaConfig;
+using vespa::config::search::IndexschemaConfigBuilder;
 
 using namespace index;
 
@@ -551,6 +566,164 @@ TEST_F(FusionTest, require_that_interleaved_features_can_be_reconstructed)
     clean_field_length_testdirs();
 }
 
+namespace {
+
+constexpr uint32_t block_max_num_docs = 1000;
+
+int32_t
+block_max_tag_weight(uint32_t doc_id)
+{
+    // a few documents have high weights, the rest have low weights
+    return ((doc_id % 97) == 0) ? 1000 : 1 + (doc_id % 5);
+}
+
+Schema
+make_block_max_schema()
+{
+    IndexschemaConfigBuilder builder;
+    IndexschemaConfigBuilder::Indexfield text;
+    text.name = "text";
+    text.datatype = IndexschemaConfig::Indexfield::Datatype::STRING;
+    text.collectiontype = IndexschemaConfig::Indexfield::Collectiontype::SINGLE;
+    text.blockmaxweights = true;
+    builder.indexfield.push_back(text);
+    IndexschemaConfigBuilder::Indexfield tags;
+    tags.name = "tags";
+    tags.datatype = IndexschemaConfig::Indexfield::Datatype::STRING;
+    tags.collectiontype = IndexschemaConfig::Indexfield::Collectiontype::WEIGHTEDSET;
+    tags.blockmaxweights = true;
+    builder.indexfield.push_back(tags);
+    Schema schema;
+    SchemaBuilder::build(builder, schema);
+    return schema;
+}
+
+void
+make_block_max_index(const Schema &schema, const vespalib::string &dump_dir)
+{
+    MockFieldLengthInspector field_length_inspector;
+    FieldIndexCollection fic(schema, field_length_inspector);
+    DocBuilder b(schema);
+    auto invertThreads = SequencedTaskExecutor::create(2);
+    auto pushThreads = SequencedTaskExecutor::create(2);
+    DocumentInverter inv(schema, *invertThreads, *pushThreads, fic);
+    for (uint32_t doc_id = 1; doc_id < block_max_num_docs; ++doc_id) {
+        b.startDocument(vespalib::make_string("id:ns:searchdocument::%u", doc_id));
+        b.startIndexField("text").addStr("a").endField();
+        b.startIndexField("tags").startElement(block_max_tag_weight(doc_id)).addStr("wx").endElement().endField();
+        inv.invertDocument(doc_id, *b.endDocument());
+        invertThreads->sync();
+        myPushDocument(inv);
+        pushThreads->sync();
+    }
+    IndexBuilder ib(schema);
+    TuneFileIndexing tuneFileIndexing;
+    DummyFileHeaderContext fileHeaderContext;
+    ib.setPrefix(dump_dir);
+    ib.open(block_max_num_docs, 2, field_length_inspector, tuneFileIndexing, fileHeaderContext);
+    fic.dump(ib);
+    ib.close();
+}
+
+SearchIterator::UP
+make_disk_term_iterator(DiskIndex &d, const vespalib::string &field, const vespalib::string &term, TermFieldMatchData &tfmd,
+                        std::vector<index::PostingListHandle::UP> &handles)
+{
+    DiskIndex::LookupResult::UP lookup_result(d.lookup(d.getSchema().getIndexFieldId(field), term));
+    assert(lookup_result);
+    handles.push_back(d.readPostingList(*lookup_result));
+    assert(handles.back());
+    TermFieldMatchDataArray tfmda;
+    tfmda.add(&tfmd);
+    return handles.back()->createIterator(lookup_result->counts, tfmda);
+}
+
+void
+assert_block_max_wand(DiskIndex &d)
+{
+    const std::vector<int32_t> weights({10, 20});
+    MatchDataLayout layout;
+    std::vector<TermFieldHandle> handles;
+    for (size_t i = 0; i < weights.size(); ++i) {
+        handles.push_back(layout.allocTermField(0));
+    }
+    fef::MatchData::UP children_md = layout.createMatchData();
+    TermFieldMatchData &text_tfmd = *children_md->resolveTermField(handles[0]);
+    TermFieldMatchData &tags_tfmd = *children_md->resolveTermField(handles[1]);
+    std::vector<index::PostingListHandle::UP> posting_handles;
+    queryeval::wand::Terms terms;
+    terms.push_back(queryeval::wand::Term(make_disk_term_iterator(d, "text", "a", text_tfmd, posting_handles).release(),
+                                          weights[0], block_max_num_docs - 1, &text_tfmd));
+    terms.push_back(queryeval::wand::Term(make_disk_term_iterator(d, "tags", "wx", tags_tfmd, posting_handles).release(),
+                                          weights[1], block_max_num_docs - 1, &tags_tfmd));
+    // block max weights are only written for the weighted set field
+    const std::vector<bool> exp_block_max({false, true});
+    for (size_t i = 0; i < terms.size(); ++i) {
+        auto *block_max = dynamic_cast<IBlockMaxWeights *>(terms[i].search);
+        ASSERT_TRUE(block_max != nullptr);
+        terms[i].search->initRange(1, block_max_num_docs);
+        int32_t max_weight = 0;
+        uint32_t last_doc_id = 0;
+        EXPECT_EQ(exp_block_max[i], block_max->get_block_max_weight(1, max_weight, last_doc_id));
+        if (exp_block_max[i]) {
+            EXPECT_LE(1u, last_doc_id);
+            EXPECT_LE(1, max_weight);
+        }
+    }
+    TermFieldMatchData root_tfmd;
+    SharedWeakAndPriorityQueue heap(10);
+    SearchIterator::UP sb(ParallelWeakAndSearch::create(terms, ParallelWeakAndSearch::MatchParams(heap, 0, 1.0, 1),
+                                                        ParallelWeakAndSearch::RankParams(root_tfmd, std::move(children_md)),
+                                                        true));
+    std::vector<int64_t> all_scores;
+    for (uint32_t doc_id = 1; doc_id < block_max_num_docs; ++doc_id) {
+        all_scores.push_back(weights[0] + weights[1] * block_max_tag_weight(doc_id));
+    }
+    std::sort(all_scores.begin(), all_scores.end(), std::greater<>());
+    int64_t min_top_score = all_scores[heap.getScoresToTrack() - 1];
+    uint32_t top_hits = 0;
+    sb->initRange(1, block_max_num_docs);
+    for (sb->seek(1); !sb->isAtEnd(); sb->seek(sb->getDocId() + 1)) {
+        uint32_t doc_id = sb->getDocId();
+        sb->unpack(doc_id);
+        int64_t exp_score = weights[0] + weights[1] * block_max_tag_weight(doc_id);
+        EXPECT_EQ(exp_score, static_cast<int64_t>(root_tfmd.getRawScore()));
+        if (exp_score >= min_top_score) {
+            ++top_hits;
+        }
+    }
+    EXPECT_EQ(static_cast<uint32_t>(std::count_if(all_scores.begin(), all_scores.end(),
+                                                  [=](int64_t score) { return score >= min_top_score; })),
+              top_hits);
+}
+
+}
+
+TEST_F(FusionTest, require_that_block_max_weights_from_index_schema_config_are_used_by_parallel_weak_and)
+{
+    vespalib::rmdir("bmdump1", true);
+    vespalib::rmdir("bmdump2", true);
+    _schema = make_block_max_schema();
+    ASSERT_TRUE(_schema.getIndexField(_schema.getIndexFieldId("text")).use_block_max_weights());
+    make_block_max_index(_schema, "bmdump1");
+    {
+        vespalib::ThreadStackExecutor executor(4, 0x10000);
+        TuneFileIndexing tuneFileIndexing;
+        DummyFileHeaderContext fileHeaderContext;
+        SelectorArray selector(block_max_num_docs, 0);
+        ASSERT_TRUE(Fusion::merge(_schema, "bmdump2", {"bmdump1"}, selector, false,
+                                  tuneFileIndexing, fileHeaderContext, executor));
+    }
+    for (const vespalib::string dump_dir : {"bmdump1", "bmdump2"}) {
+        SCOPED_TRACE(dump_dir);
+        DiskIndex disk_index(dump_dir);
+        ASSERT_TRUE(disk_index.setup(TuneFileSearch()));
+        assert_block_max_wand(disk_index);
+    }
+    vespalib::rmdir("bmdump1", true);
+    vespalib::rmdir("bmdump2", true);
+}
+
 }
 
 }
@@ -0,0 +1,191 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/searchlib/docstore/async_io_reader.h>
+#include <vespa/searchlib/docstore/randreaders.h>
+#include <vespa/searchlib/test/directory_handler.h>
+#include <vespa/vespalib/data/databuffer.h>
+#include <vespa/fastos/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP("async_io_reader_test");
+
+using namespace search;
+
+namespace {
+
+constexpr size_t FILE_SIZE = 1024 * 1024;
+
+char
+expectedByte(size_t offset)
+{
+    return static_cast<char>((offset * 7 + (offset >> 12)) & 0xff);
+}
+
+struct Fixture {
+    test::DirectoryHandler dir;
+    vespalib::string       fileName;
+    int                    fd;
+
+    Fixture()
+        : dir("async_io_reader_dir"),
+          fileName("async_io_reader_dir/data"),
+          fd(-1)
+    {
+        std::vector<char> data(FILE_SIZE);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = expectedByte(i);
+        }
+        FastOS_File file(fileName.c_str());
+        ASSERT_TRUE(file.OpenWriteOnlyTruncate());
+        file.WriteBuf(&data[0], data.size());
+        ASSERT_TRUE(file.Close());
+        fd = ::open(fileName.c_str(), O_RDONLY);
+        ASSERT_TRUE(fd >= 0);
+    }
+    ~Fixture() {
+        ::close(fd);
+    }
+};
+
+struct Reads {
+    std::vector<std::vector<char>>         buffers;
+    std::vector<AsyncIoReader::Request> requests;
+
+    Reads(int fd, size_t numReads) {
+        buffers.resize(numReads);
+        for (size_t i = 0; i < numReads; ++i) {
+            size_t size = 1 + (i * 4099) % 20000;
+            uint64_t offset = (i * 104729) % (FILE_SIZE - size);
+            buffers[i].resize(size);
+            requests.emplace_back(fd, offset, size, &buffers[i][0]);
+        }
+    }
+    bool verify() const {
+        for (size_t i = 0; i < requests.size(); ++i) {
+            const auto & request = requests[i];
+            if (request.result != ssize_t(request.size)) {
+                return false;
+            }
+            for (size_t j = 0; j < request.size; ++j) {
+                if (buffers[i][j] != expectedByte(request.offset + j)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+
+void
+requireThatBatchIsRead(AsyncIoReader & reader, int fd)
+{
+    Reads reads(fd, 100);
+    reader.read(reads.requests);
+    EXPECT_TRUE(reads.verify());
+    AsyncReadStats stats = reader.getStats();
+    EXPECT_EQUAL(1u, stats.batches);
+    EXPECT_EQUAL(100u, stats.reads);
+    EXPECT_LESS_EQUAL(stats.maxQueueDepth, reader.getQueueDepth());
+    EXPECT_GREATER(stats.queueDepthSamples, 0u);
+}
+
+}
+
+TEST_F("require that batch of reads is read with io_uring if available", Fixture)
+{
+    AsyncIoReader reader(16, 4);
+    EXPECT_EQUAL(AsyncIoReader::ioUringSupported(), reader.usesIoUring());
+    LOG(info, "io_uring supported: %s", AsyncIoReader::ioUringSupported() ? "yes" : "no");
+    TEST_DO(requireThatBatchIsRead(reader, f.fd));
+}
+
+TEST_F("require that batch of reads is read with fallback threads", Fixture)
+{
+    AsyncIoReader reader(16, 4, false);
+    EXPECT_FALSE(reader.usesIoUring());
+    TEST_DO(requireThatBatchIsRead(reader, f.fd));
+}
+
+TEST_F("require that batch of reads is read without fallback threads", Fixture)
+{
+    AsyncIoReader reader(16, 0, false);
+    TEST_DO(requireThatBatchIsRead(reader, f.fd));
+}
+
+TEST_F("require that queue depth is bounded when batch is larger than queue depth", Fixture)
+{
+    AsyncIoReader reader(4, 2);
+    Reads reads(f.fd, 50);
+    reader.read(reads.requests);
+    EXPECT_TRUE(reads.verify());
+    EXPECT_LESS_EQUAL(reader.getStats().maxQueueDepth, 4u);
+}
+
+TEST_F("require that read past end of file gives short result", Fixture)
+{
+    AsyncIoReader reader(4, 2);
+    std::vector<char> buf(1000);
+    std::vector<AsyncIoReader::Request> requests;
+    requests.emplace_back(f.fd, FILE_SIZE - 100, buf.size(), &buf[0]);
+    reader.read(requests);
+    EXPECT_EQUAL(100, requests[0].result);
+}
+
+TEST_F("require that failed read gives negative result", Fixture)
+{
+    AsyncIoReader reader(4, 2);
+    std::vector<char> buf(1000);
+    std::vector<AsyncIoReader::Request> requests;
+    requests.emplace_back(-1, 0, buf.size(), &buf[0]);
+    reader.read(requests);
+    EXPECT_EQUAL(-EBADF, requests[0].result);
+}
+
+template <typename RandRead>
+void
+requireThatPreparedReadsCanBeIssuedBatched(const vespalib::string & fileName)
+{
+    RandRead file(fileName);
+    AsyncIoReader reader(8, 2);
+    std::vector<vespalib::DataBuffer> buffers(20);
+    std::vector<FileRandRead::PreparedRead> prepared;
+    std::vector<AsyncIoReader::Request> requests;
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        size_t offset = 1 + i * 50000;
+        prepared.push_back(file.prepareRead(offset, buffers[i], 3000));
+        ASSERT_TRUE(prepared.back().valid());
+        requests.emplace_back(prepared[i].fd, prepared[i].offset, prepared[i].size, prepared[i].dst);
+    }
+    reader.read(requests);
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        ASSERT_TRUE(requests[i].result >= ssize_t(prepared[i].required()));
+        FileRandRead::finishRead(prepared[i], buffers[i]);
+        ASSERT_EQUAL(3000u, buffers[i].getDataLen());
+        size_t offset = 1 + i * 50000;
+        for (size_t j = 0; j < 3000; ++j) {
+            ASSERT_EQUAL(expectedByte(offset + j), buffers[i].getData()[j]);
+        }
+    }
+}
+
+TEST_F("require that normal rand read can prepare reads issued by async reader", Fixture)
+{
+    requireThatPreparedReadsCanBeIssuedBatched<NormalRandRead>(f.fileName);
+}
+
+TEST_F("require that direct io rand read can prepare reads issued by async reader", Fixture)
+{
+    requireThatPreparedReadsCanBeIssuedBatched<DirectIORandRead>(f.fileName);
+}
+
+TEST_F("require that mmap rand read does not prepare reads", Fixture)
+{
+    MMapRandRead file(f.fileName, 0, 0);
+    vespalib::DataBuffer buffer;
+    EXPECT_FALSE(file.prepareRead(0, buffer, 100).valid());
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -8,11 +8,15 @@
 #include <vespa/searchlib/docstore/chunkformats.h>
 #include <vespa/vespalib/objects/hexdump.h>
 #include <vespa/vespalib/stllike/string.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/util/zstdcompressor.h>
+#include <vespa/vespalib/data/databuffer.h>
 
 LOG_SETUP("chunk_test");
 
 using namespace search;
 using vespalib::compression::CompressionConfig;
+using vespalib::compression::ZStdDictionary;
 
 TEST("require that Chunk obey limits")
 {
@@ -98,4 +102,70 @@ TEST("require that V2 can create and handle lz4, zstd, and none") {
     verifyChunkCompression(CompressionConfig::ZSTD, MY_LONG_STRING, strlen(MY_LONG_STRING), 282);
 }
 
+vespalib::string
+makeDocument(uint32_t id, const char * genre)
+{
+    return vespalib::make_string("{\"title\":\"Song number %u\",\"artist\":\"Artist %u\",\"year\":%u,\"genre\":\"%s\"}",
+                                 id * 13, id % 89, 1950 + (id % 70), genre);
+}
+
+std::unique_ptr<ZStdDictionary>
+trainDictionary(const char * genre)
+{
+    vespalib::string samples;
+    std::vector<size_t> sampleSizes;
+    for (uint32_t i(0); i < 2000; i++) {
+        vespalib::string doc = makeDocument(i, genre);
+        samples += doc;
+        sampleSizes.push_back(doc.size());
+    }
+    return ZStdDictionary::train(samples.data(), sampleSizes, 4096);
+}
+
+void
+packChunk(vespalib::DataBuffer & buffer, const ZStdDictionary * dictionary)
+{
+    Chunk chunk(0, Chunk::Config(0x1000));
+    for (uint32_t lid(1); lid <= 10; lid++) {
+        vespalib::string doc = makeDocument(lid * 1000, "rock");
+        chunk.append(lid, doc.data(), doc.size());
+    }
+    chunk.pack(7, buffer, CompressionConfig(CompressionConfig::ZSTD, 9, 100), dictionary);
+}
+
+TEST("require that chunks can be compressed and decompressed with zstd dictionary") {
+    auto trained = trainDictionary("rock");
+    ASSERT_TRUE(trained);
+    ZStdDictionary dictionary(trained->getBuffer(), 9);
+    vespalib::DataBuffer plain;
+    vespalib::DataBuffer compressed;
+    packChunk(plain, nullptr);
+    packChunk(compressed, &dictionary);
+    EXPECT_LESS(compressed.getDataLen(), plain.getDataLen());
+
+    Chunk chunk(0, compressed.getData(), compressed.getDataLen(), false, trained.get());
+    EXPECT_EQUAL(10u, chunk.count());
+    EXPECT_EQUAL(7u, chunk.getLastSerial());
+    vespalib::DataBuffer doc;
+    chunk.read(3, doc);
+    EXPECT_EQUAL(makeDocument(3000, "rock"), vespalib::string(doc.getData(), doc.getDataLen()));
+
+    Chunk plainChunk(0, plain.getData(), plain.getDataLen(), false, trained.get());
+    EXPECT_EQUAL(10u, plainChunk.count());
+}
+
+TEST("require that chunks compressed with zstd dictionary can not be read without it") {
+    auto dictionary = trainDictionary("rock");
+    auto other = trainDictionary("jazz");
+    ASSERT_TRUE(dictionary && other);
+    ASSERT_NOT_EQUAL(dictionary->getId(), other->getId());
+    ZStdDictionary compressing(dictionary->getBuffer(), 9);
+    vespalib::DataBuffer compressed;
+    packChunk(compressed, &compressing);
+    EXPECT_EXCEPTION(Chunk(0, compressed.getData(), compressed.getDataLen()), ChunkException,
+                     "no dictionary is available");
+    EXPECT_EXCEPTION(Chunk(0, compressed.getData(), compressed.getDataLen(), false, other.get()), ChunkException,
+                     "but dictionary");
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
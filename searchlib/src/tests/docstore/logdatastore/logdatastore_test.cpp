@@ -6,6 +6,7 @@
 #include <vespa/document/datatype/documenttype.h>
 #include <vespa/document/fieldvalue/document.h>
 #include <vespa/searchlib/docstore/chunkformats.h>
+#include <vespa/searchlib/docstore/compacter.h>
 #include <vespa/searchlib/docstore/logdocumentstore.h>
 #include <vespa/searchlib/docstore/storebybucket.h>
 #include <vespa/searchlib/docstore/visitcache.h>
@@ -16,6 +17,7 @@
 #include <vespa/vespalib/util/exceptions.h>
 #include <vespa/vespalib/util/threadstackexecutor.h>
 #include <iomanip>
+#include <map>
 
 using document::BucketId;
 using namespace search::docstore;
@@ -265,6 +267,45 @@ TEST("testGrowingChunkedByNumLids") {
     verifyGrowing(config,10, 10);
 }
 
+TEST("testGrowingChunkedBySizeWithParallelThrottledCompaction") {
+    LogDataStore::Config config;
+    config.setMaxFileSize(100000).setMaxDiskBloatFactor(0.1).setMaxBucketSpread(3.0).setMinFileSizeFactor(0.2)
+            .setCompactThreads(4).setMaxCompactBytesPerSecond(100000000)
+            .compactCompression({CompressionConfig::LZ4})
+            .setFileConfig({{CompressionConfig::LZ4, 9, 60}, 1000});
+    verifyGrowing(config, 40, 120);
+}
+
+TEST("require that compaction throttler limits read bandwidth and tracks progress") {
+    docstore::CompactionThrottler throttler(7, 4, 2, 1000000);
+    vespalib::Timer timer;
+    for (size_t i(0); i < 4; i++) {
+        throttler.beforeRead(100000);
+        throttler.updateProgress();
+    }
+    EXPECT_GREATER_EQUAL(vespalib::count_ms(timer.elapsed()), 300);
+    DataStoreCompactionStats stats = throttler.getStats();
+    EXPECT_TRUE(stats.active());
+    EXPECT_EQUAL(7u, stats.nameId());
+    EXPECT_EQUAL(4u, stats.numChunks());
+    EXPECT_EQUAL(4u, stats.compactedChunks());
+    EXPECT_EQUAL(2u, stats.numThreads());
+    EXPECT_EQUAL(400000u, stats.bytesRead());
+    EXPECT_EQUAL(1.0, stats.progress());
+    EXPECT_LESS_EQUAL(stats.bytesPerSecond(), 1400000.0);
+    EXPECT_EQUAL(1000000u, stats.maxBytesPerSecond());
+}
+
+TEST("require that data store has no compaction stats when not compacting") {
+    DirectoryHandler tmpDir("nocompaction");
+    vespalib::ThreadStackExecutor executor(1, 128*1024);
+    DummyFileHeaderContext fileHeaderContext;
+    MyTlSyncer tlSyncer;
+    LogDataStore datastore(executor, "nocompaction", LogDataStore::Config(), GrowStrategy(),
+                           TuneFileSummary(), fileHeaderContext, tlSyncer, nullptr);
+    EXPECT_FALSE(datastore.getCompactionStats().active());
+}
+
 void fetchAndTest(IDataStore & datastore, uint32_t lid, const void *a, size_t sz)
 {
     vespalib::DataBuffer buf;
@@ -476,6 +517,10 @@ public:
         VerifyVisitor vv(*this, expected, allowCaching);
         _datastore->visit(lids, _repo, vv);
     }
+    void verifyPrefetch(const std::vector<uint32_t> & lids) {
+        VerifyVisitor vv(*this, lids, false);
+        _datastore->prefetch(lids, _repo, vv);
+    }
     void recreate();
 
 private:
@@ -660,6 +705,37 @@ TEST("test that the integrated visit cache works.") {
     TEST_DO(verifyCacheStats(ds.getCacheStats(), 101, 108, 99, BASE_SZ+340));
 }
 
+TEST("test that documents read in a batch prefetch are added to the cache") {
+    VisitCacheStore vcs(DocumentStore::Config::UpdateStrategy::INVALIDATE);
+    IDocumentStore & ds = vcs.getStore();
+    for (size_t i(1); i <= 10; i++) {
+        vcs.write(i);
+    }
+    TEST_DO(verifyCacheStats(ds.getCacheStats(), 0, 0, 0, 0));
+    vcs.verifyPrefetch({3,5,7});
+    TEST_DO(verifyCacheStats(ds.getCacheStats(), 0, 3, 3, 3*221));
+    vcs.verifyRead(5);
+    TEST_DO(verifyCacheStats(ds.getCacheStats(), 1, 3, 3, 3*221));
+    vcs.verifyPrefetch({3,5,7,9});
+    TEST_DO(verifyCacheStats(ds.getCacheStats(), 4, 4, 4, 4*221));
+    vcs.write(7);
+    TEST_DO(verifyCacheStats(ds.getCacheStats(), 4, 4, 3, 3*221));
+}
+
+TEST("test that a visit without visit caching leaves the document cache alone") {
+    VisitCacheStore vcs(DocumentStore::Config::UpdateStrategy::INVALIDATE);
+    IDocumentStore & ds = vcs.getStore();
+    for (size_t i(1); i <= 10; i++) {
+        vcs.write(i);
+    }
+    vcs.verifyVisit({3,5,7}, false);
+    TEST_DO(verifyCacheStats(ds.getCacheStats(), 0, 0, 0, 0));
+    vcs.verifyPrefetch({3});
+    TEST_DO(verifyCacheStats(ds.getCacheStats(), 0, 1, 1, 221));
+    vcs.verifyVisit({3,5,7,9}, false);
+    TEST_DO(verifyCacheStats(ds.getCacheStats(), 0, 1, 1, 221));
+}
+
 TEST("testWriteRead") {
     FastOS_File::RemoveDirectory("empty");
     const char * bufA = "aaaaaaaaaaaaaaaaaaaaa";
@@ -1055,6 +1131,108 @@ TEST("require that config equality operator detects inequality") {
     EXPECT_FALSE(C() == C().setFileConfig(WriteableFileChunk::Config({}, 70)));
     EXPECT_FALSE(C() == C().disableCrcOnRead(true));
     EXPECT_FALSE(C() == C().compactCompression({CompressionConfig::ZSTD}));
+    EXPECT_FALSE(C() == C().setMaxDictionaryBytes(1));
+    EXPECT_FALSE(C() == C().setCompactThreads(2));
+    EXPECT_FALSE(C() == C().setMaxCompactBytesPerSecond(1));
+}
+
+vespalib::string
+genDictionaryData(uint32_t lid)
+{
+    vespalib::asciistream os;
+    os << "<document id=\"id:ns:music::" << lid << "\"><title>Title number " << lid
+       << "</title><artist>Artist " << (lid % 37) << "</artist><genre>" << ((lid % 3) ? "rock" : "jazz")
+       << "</genre><year>" << (1950 + lid % 70) << "</year></document>";
+    return os.str();
+}
+
+TEST("require that documents can be written and read back when chunks are compressed with trained dictionary") {
+    DummyFileHeaderContext fileHeaderContext;
+    vespalib::ThreadStackExecutor executor(1, 0x20000);
+    MyTlSyncer tlSyncer;
+    LogDataStore::Config config;
+    config.setMaxFileSize(30000).setMaxDictionaryBytes(4096)
+          .compactCompression({CompressionConfig::ZSTD, 3, 100})
+          .setFileConfig({{CompressionConfig::ZSTD, 3, 100}, 512});
+    constexpr uint32_t numDocs = 2000;
+    {
+        search::test::DirectoryHandler dir("dictionary");
+        dir.cleanup(false);
+        LogDataStore store(executor, "dictionary", config, GrowStrategy(), TuneFileSummary(), fileHeaderContext, tlSyncer, nullptr);
+        for (uint32_t lid = 0; lid < numDocs; ++lid) {
+            vespalib::string data = genDictionaryData(lid);
+            store.write(lid + 1, lid, data.c_str(), data.size());
+        }
+        store.initFlush(numDocs);
+        store.flush(numDocs);
+        EXPECT_GREATER(store.getFileChunkStats().size(), 1u);
+    }
+    search::test::DirectoryHandler dir("dictionary");
+    LogDataStore store(executor, "dictionary", config, GrowStrategy(), TuneFileSummary(), fileHeaderContext, tlSyncer, nullptr);
+    for (uint32_t lid = 0; lid < numDocs; ++lid) {
+        vespalib::DataBuffer buffer;
+        store.read(lid, buffer);
+        EXPECT_EQUAL(genDictionaryData(lid), vespalib::string(buffer.getData(), buffer.getDataLen()));
+    }
+}
+
+class CollectingBufferVisitor : public IBufferVisitor {
+public:
+    std::map<uint32_t, vespalib::string> buffers;
+    void visit(uint32_t lid, vespalib::ConstBufferRef buffer) override {
+        buffers[lid] = vespalib::string(buffer.c_str(), buffer.size());
+    }
+};
+
+void
+requireThatBatchedReadsAreAsync(TuneFileSummary tune)
+{
+    DummyFileHeaderContext fileHeaderContext;
+    vespalib::ThreadStackExecutor executor(1, 0x20000);
+    MyTlSyncer tlSyncer;
+    LogDataStore::Config config;
+    config.setMaxFileSize(30000).setFileConfig({{CompressionConfig::LZ4}, 512});
+    constexpr uint32_t numDocs = 2000;
+    {
+        search::test::DirectoryHandler dir("async");
+        dir.cleanup(false);
+        LogDataStore store(executor, "async", config, GrowStrategy(), TuneFileSummary(), fileHeaderContext, tlSyncer, nullptr);
+        for (uint32_t lid = 0; lid < numDocs; ++lid) {
+            vespalib::string data = genDictionaryData(lid);
+            store.write(lid + 1, lid, data.c_str(), data.size());
+        }
+        store.initFlush(numDocs);
+        store.flush(numDocs);
+    }
+    search::test::DirectoryHandler dir("async");
+    tune._randRead.setAsyncQueueDepth(8);
+    LogDataStore store(executor, "async", config, GrowStrategy(), tune, fileHeaderContext, tlSyncer, nullptr);
+    IDataStore::LidVector lids;
+    for (uint32_t i = 0; i < 100; ++i) {
+        lids.push_back((i * 61) % numDocs);
+    }
+    CollectingBufferVisitor visitor;
+    store.read(lids, visitor);
+    EXPECT_EQUAL(lids.size(), visitor.buffers.size());
+    for (uint32_t lid : lids) {
+        EXPECT_EQUAL(genDictionaryData(lid), visitor.buffers[lid]);
+    }
+    AsyncReadStats stats = store.getAsyncReadStats();
+    EXPECT_EQUAL(1u, stats.batches);
+    EXPECT_GREATER(stats.reads, 1u);
+    EXPECT_LESS_EQUAL(stats.maxQueueDepth, 8u);
+}
+
+TEST("require that batched reads are done asynchronously with normal io") {
+    TuneFileSummary tune;
+    tune._randRead.setWantNormal();
+    TEST_DO(requireThatBatchedReadsAreAsync(tune));
+}
+
+TEST("require that batched reads are done asynchronously with direct io") {
+    TuneFileSummary tune;
+    tune._randRead.setWantDirectIO();
+    TEST_DO(requireThatBatchedReadsAreAsync(tune));
 }
 
 TEST_MAIN() {
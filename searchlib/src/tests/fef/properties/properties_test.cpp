@@ -234,6 +234,14 @@ TEST("test stuff") {
             p.add("vespa.eval.use_fast_forest", "true");
             EXPECT_EQUAL(eval::UseFastForest::check(p), true);
         }
+        { // vespa.eval.use_batch_functions
+            EXPECT_EQUAL(eval::UseBatchFunctions::NAME, vespalib::string("vespa.eval.use_batch_functions"));
+            EXPECT_EQUAL(eval::UseBatchFunctions::DEFAULT_VALUE, true);
+            Properties p;
+            EXPECT_EQUAL(eval::UseBatchFunctions::check(p), true);
+            p.add("vespa.eval.use_batch_functions", "false");
+            EXPECT_EQUAL(eval::UseBatchFunctions::check(p), false);
+        }
         { // vespa.rank.firstphase
             EXPECT_EQUAL(rank::FirstPhase::NAME, vespalib::string("vespa.rank.firstphase"));
             EXPECT_EQUAL(rank::FirstPhase::DEFAULT_VALUE, vespalib::string("nativeRank"));
@@ -294,6 +302,14 @@ TEST("test stuff") {
             p.add("vespa.matching.termwise_limit", "0.05");
             EXPECT_EQUAL(matching::TermwiseLimit::lookup(p), 0.05);
         }
+        { // vespa.matching.second_phase.rank_batch_size
+            EXPECT_EQUAL(matching::SecondPhaseRankBatchSize::NAME, vespalib::string("vespa.matching.second_phase.rank_batch_size"));
+            EXPECT_EQUAL(matching::SecondPhaseRankBatchSize::DEFAULT_VALUE, 64u);
+            Properties p;
+            EXPECT_EQUAL(matching::SecondPhaseRankBatchSize::lookup(p), 64u);
+            p.add("vespa.matching.second_phase.rank_batch_size", "0");
+            EXPECT_EQUAL(matching::SecondPhaseRankBatchSize::lookup(p), 0u);
+        }
         { // vespa.matching.numthreads
             EXPECT_EQUAL(matching::NumThreadsPerSearch::NAME, vespalib::string("vespa.matching.numthreadspersearch"));
             EXPECT_EQUAL(matching::NumThreadsPerSearch::DEFAULT_VALUE, std::numeric_limits<uint32_t>::max());
@@ -311,6 +327,15 @@ TEST("test stuff") {
             p.add("vespa.matching.minhitsperthread", "50");
             EXPECT_EQUAL(matching::MinHitsPerThread::lookup(p), 50u);
         }
+        { // vespa.matching.work_stealing
+            EXPECT_EQUAL(matching::WorkStealing::NAME, vespalib::string("vespa.matching.work_stealing"));
+            EXPECT_EQUAL(matching::WorkStealing::DEFAULT_VALUE, false);
+            Properties p;
+            EXPECT_EQUAL(matching::WorkStealing::check(p), false);
+            EXPECT_EQUAL(matching::WorkStealing::check(p, true), true);
+            p.add("vespa.matching.work_stealing", "true");
+            EXPECT_EQUAL(matching::WorkStealing::check(p), true);
+        }
         {
             EXPECT_EQUAL(matching::NumSearchPartitions::NAME, vespalib::string("vespa.matching.numsearchpartitions"));
             EXPECT_EQUAL(matching::NumSearchPartitions::DEFAULT_VALUE, 1u);
@@ -383,6 +383,12 @@ TEST_F("require that fast-forest gbdt evaluation is disabled by default", Fixtur
     EXPECT_EQUAL(f1.final_executor_name(), "search::features::CompiledRankingExpressionExecutor");
 }
 
+TEST_F("require that fast-forest gbdt evaluation can be used for forests inside larger expressions", Fixture()) {
+    f1.use_fast_forest().add_expr("rank", "1+(" + tree_expr + ")").compile();
+    EXPECT_EQUAL(f1.get(), 22.0);
+    EXPECT_EQUAL(f1.final_executor_name(), "search::features::CompiledRankingExpressionExecutor");
+}
+
 TEST_F("require that fast-forest gbdt evaluation is pure", Fixture()) {
     f1.use_fast_forest().add_expr("rank", tree_expr).compile();
     EXPECT_EQUAL(3u, count_features(f1.program));
@@ -391,4 +397,92 @@ TEST_F("require that fast-forest gbdt evaluation is pure", Fixture()) {
     EXPECT_EQUAL(f1.final_executor_name(), "search::features::FastForestExecutor");
 }
 
+std::vector<double> get_batch(RankProgram &program, const std::vector<uint32_t> &docids) {
+    for (uint32_t docid: docids) {
+        program.add_to_batch(docid);
+    }
+    auto scores = program.execute_batch();
+    std::vector<double> result(scores.begin(), scores.end());
+    program.clear_batch();
+    return result;
+}
+
+TEST_F("require that seed can be calculated for batches of documents", Fixture()) {
+    f1.lazy_expressions(false);
+    f1.add_expr("rank", "docid*2+ivalue(5)+value(1)").compile();
+    ASSERT_TRUE(f1.program.setup_batch(4));
+    EXPECT_EQUAL(4u, f1.program.batch_size());
+    f1.program.add_to_batch(3);
+    EXPECT_FALSE(f1.program.batch_full());
+    f1.program.clear_batch();
+    EXPECT_TRUE(std::vector<double>({12.0, 16.0, 20.0, 24.0}) == get_batch(f1.program, {3, 5, 7, 9}));
+    EXPECT_TRUE(std::vector<double>({8.0}) == get_batch(f1.program, {1}));
+    EXPECT_EQUAL(f1.get(expr_feature("rank"), 2), 10.0);
+}
+
+TEST_F("require that batch is full when batch size documents have been added", Fixture()) {
+    f1.lazy_expressions(false);
+    f1.add_expr("rank", "docid+1").compile();
+    ASSERT_TRUE(f1.program.setup_batch(2));
+    f1.program.add_to_batch(1);
+    EXPECT_FALSE(f1.program.batch_full());
+    f1.program.add_to_batch(2);
+    EXPECT_TRUE(f1.program.batch_full());
+    EXPECT_TRUE(std::vector<uint32_t>({1, 2}) == std::vector<uint32_t>(f1.program.batch_docids().begin(),
+                                                                        f1.program.batch_docids().end()));
+}
+
+TEST_F("require that values from executors not supporting batches are calculated per document", Fixture()) {
+    f1.lazy_expressions(false);
+    f1.add_expr("rank", "track(docid)+docid").compile();
+    ASSERT_TRUE(f1.program.setup_batch(8));
+    EXPECT_EQUAL(f1.track_cnt, 0u);
+    f1.program.add_to_batch(3);
+    f1.program.add_to_batch(4);
+    EXPECT_EQUAL(f1.track_cnt, 2u);
+    auto scores = f1.program.execute_batch();
+    EXPECT_EQUAL(f1.track_cnt, 2u);
+    EXPECT_TRUE(std::vector<double>({6.0, 8.0}) == std::vector<double>(scores.begin(), scores.end()));
+}
+
+TEST_F("require that batches are not used when seed executor does not support them", Fixture()) {
+    f1.add("mysum(docid,ivalue(1))").compile();
+    EXPECT_FALSE(f1.program.setup_batch(8));
+    EXPECT_EQUAL(0u, f1.program.batch_size());
+    EXPECT_EQUAL(f1.get(3), 4.0);
+}
+
+TEST_F("require that batches are not used for lazy ranking expressions", Fixture()) {
+    f1.lazy_expressions(true);
+    f1.add_expr("rank", "docid+1").compile();
+    EXPECT_FALSE(f1.program.setup_batch(8));
+}
+
+TEST_F("require that batches are not used for const seed", Fixture()) {
+    f1.lazy_expressions(false);
+    f1.add_expr("rank", "value(1)+2").compile();
+    EXPECT_FALSE(f1.program.setup_batch(8));
+}
+
+TEST_F("require that batches are not used with multiple seeds", Fixture()) {
+    f1.lazy_expressions(false);
+    f1.add_expr("a", "docid+1");
+    f1.add_expr("b", "docid+2");
+    f1.compile();
+    EXPECT_FALSE(f1.program.setup_batch(8));
+}
+
+TEST_F("require that batch size 0 disables batches", Fixture()) {
+    f1.lazy_expressions(false);
+    f1.add_expr("rank", "docid+1").compile();
+    EXPECT_FALSE(f1.program.setup_batch(0));
+}
+
+TEST_F("require that fast-forest gbdt evaluation can be done in batches", Fixture()) {
+    f1.use_fast_forest().add_expr("rank", "if(docid<2,1,2)+if(ivalue(2)<1,10,20)").compile();
+    EXPECT_EQUAL(f1.final_executor_name(), "search::features::FastForestExecutor");
+    ASSERT_TRUE(f1.program.setup_batch(4));
+    EXPECT_TRUE(std::vector<double>({21.0, 22.0, 22.0}) == get_batch(f1.program, {1, 2, 3}));
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
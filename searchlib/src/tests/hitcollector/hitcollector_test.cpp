@@ -236,6 +236,25 @@ TEST_F("testReRank - partial", AscendingScoreFixture)
     TEST_DO(checkResult(*rs, f.expBv.get()));
 }
 
+TEST_F("require that re-ranked hits can be set", AscendingScoreFixture)
+{
+    f.addHits();
+    f.hc.setReRankedHits({{12, 300}, {17, 217}, {19, 219}});
+
+    std::vector<RankedHit> expRh;
+    for (uint32_t i = 10; i < 20; ++i) {  // 10 last are the best
+        expRh.push_back(RankedHit(i, f.calculateScore(i)));
+    }
+    expRh[2]._rankValue = 300;
+    expRh[7]._rankValue = 217;
+    expRh[9]._rankValue = 219;
+    EXPECT_EQUAL(3u, f.hc.getReRankedHits().size());
+
+    std::unique_ptr<ResultSet> rs = f.hc.getResultSet();
+    TEST_DO(checkResult(*rs, expRh));
+    TEST_DO(checkResult(*rs, f.expBv.get()));
+}
+
 TEST_F("require that hits for 2nd phase candidates can be retrieved", DescendingScoreFixture)
 {
     f.addHits();
@@ -30,6 +30,7 @@ using CellType = vespalib::eval::ValueType::CellType;
 using vespalib::eval::TensorSpec;
 using vespalib::tensor::Tensor;
 using vespalib::tensor::DenseTensorView;
+using vespalib::tensor::TypedCells;
 using vespalib::tensor::DefaultTensorEngine;
 using search::tensor::DistanceFunction;
 using search::attribute::DistanceMetric;
@@ -205,12 +206,13 @@ TEST("require that NearestNeighborIterator returns filtered results") {
 }
 
 template <bool strict>
-std::vector<feature_t> get_rawscores(Fixture &env, const DenseTensorView &qtv) {
+std::vector<feature_t> get_rawscores(Fixture &env, const DenseTensorView &qtv,
+                                     vespalib::ConstArrayRef<TypedCells> batch = vespalib::ConstArrayRef<TypedCells>()) {
     auto md = MatchData::makeTestInstance(2, 2);
     auto &tfmd = *(md->resolveTermField(0));
     auto &attr = *(env._tensorAttr);
     NearestNeighborDistanceHeap dh(2);
-    auto search = NearestNeighborIterator::create(strict, tfmd, qtv, attr, dh, nullptr, env.dist_fun());
+    auto search = NearestNeighborIterator::create(strict, tfmd, qtv, attr, dh, nullptr, env.dist_fun(), batch);
     uint32_t limit = attr.getNumDocs();
     uint32_t docid = 1;
     search->initRange(docid, limit);
@@ -256,6 +258,39 @@ TEST("require that NearestNeighborIterator sets expected rawscore") {
     TEST_DO(verify_iterator_sets_expected_rawscore(denseSpecFloat, denseSpecFloat));
 }
 
+void
+verify_iterator_uses_closest_query_point_in_batch(const vespalib::string& attribute_tensor_type_spec)
+{
+    Fixture fixture(attribute_tensor_type_spec);
+    fixture.ensureSpace(6);
+    fixture.setTensor(1, 3.0, 4.0);
+    fixture.setTensor(2, 5.0, 12.0);
+    fixture.setTensor(3, 6.0, 8.0);
+    fixture.setTensor(4, 5.0, 12.0);
+    fixture.setTensor(5, 8.0, 6.0);
+    fixture.setTensor(6, 4.0, 3.0);
+    auto nullTensor = createTensor(attribute_tensor_type_spec, 0.0, 0.0);
+    auto otherTensor = createTensor(attribute_tensor_type_spec, 8.0, 6.0);
+    std::vector<TypedCells> batch = {nullTensor->cellsRef(), otherTensor->cellsRef()};
+    // distances to closest query point: 5, sqrt(45), sqrt(8), sqrt(45), 0, 5
+    std::vector<feature_t> expected{5.0, std::sqrt(45.0), std::sqrt(8.0), 0.0};
+    std::vector<feature_t> got = get_rawscores<true>(fixture, *nullTensor, batch);
+    EXPECT_EQUAL(got.size(), expected.size());
+    for (size_t i = 0; i < expected.size() && i < got.size(); ++i) {
+        EXPECT_APPROX(1.0/(1.0+expected[i]), got[i], EPS);
+    }
+    got = get_rawscores<false>(fixture, *nullTensor, batch);
+    EXPECT_EQUAL(got.size(), expected.size());
+    for (size_t i = 0; i < expected.size() && i < got.size(); ++i) {
+        EXPECT_APPROX(1.0/(1.0+expected[i]), got[i], EPS);
+    }
+}
+
+TEST("require that NearestNeighborIterator uses closest query point in batch") {
+    TEST_DO(verify_iterator_uses_closest_query_point_in_batch(denseSpecDouble));
+    TEST_DO(verify_iterator_uses_closest_query_point_in_batch(denseSpecFloat));
+}
+
 TEST("require that NnsIndexIterator works as expected") {
     std::vector<NnsIndexIterator::Hit> hits{{2,4.0}, {3,9.0}, {5,1.0}, {8,16.0}, {9,36.0}};
     auto md = MatchData::makeTestInstance(2, 2);
@@ -12,6 +12,8 @@
 #include <vespa/searchlib/test/weightedchildrenverifiers.h>
 #include <vespa/searchlib/test/document_weight_attribute_helper.h>
 #include <vespa/searchlib/queryeval/document_weight_search_iterator.h>
+#include <vespa/searchlib/queryeval/fake_search.h>
+#include <vespa/searchlib/queryeval/iblockmaxweights.h>
 #include <vespa/searchlib/fef/fef.h>
 
 using namespace search::query;
@@ -628,6 +630,151 @@ TEST_F("require that asString() on blueprint works", BlueprintAsStringFixture)
     EXPECT_EQUAL(expStr, bp->asString());
 }
 
+/**
+ * Fake search exposing per block max weights (blocks of a fixed number
+ * of documents) and counting the number of unpacks.
+ */
+class BlockMaxSearch : public FakeSearch, public IBlockMaxWeights
+{
+    std::vector<std::pair<uint32_t, int32_t>> _blocks; // (last docid, max weight)
+    size_t    _block;
+    uint32_t &_unpacks;
+
+public:
+    BlockMaxSearch(const FakeResult &result, TermFieldMatchData &tfmd, uint32_t block_docs, uint32_t &unpacks)
+        : FakeSearch("tag", "field", "term", result, search::fef::TermFieldMatchDataArray().add(&tfmd)),
+          _blocks(),
+          _block(0),
+          _unpacks(unpacks)
+    {
+        const auto &docs = result.inspect();
+        for (size_t i = 0; i < docs.size(); i += block_docs) {
+            int32_t max_weight = std::numeric_limits<int32_t>::min();
+            size_t end = std::min(docs.size(), i + block_docs);
+            for (size_t j = i; j < end; ++j) {
+                int32_t weight = 0;
+                for (const auto &elem : docs[j].elements) {
+                    weight += elem.weight;
+                }
+                max_weight = std::max(max_weight, weight);
+            }
+            _blocks.emplace_back(docs[end - 1].docId, max_weight);
+        }
+    }
+    void doUnpack(uint32_t docid) override {
+        ++_unpacks;
+        FakeSearch::doUnpack(docid);
+    }
+    void initRange(uint32_t begin, uint32_t end) override {
+        FakeSearch::initRange(begin, end);
+        _block = 0;
+    }
+    bool get_block_max_weight(uint32_t docid, int32_t &max_weight, uint32_t &last_docid) override {
+        while (_block < _blocks.size() && _blocks[_block].first < docid) {
+            ++_block;
+        }
+        if (_block == _blocks.size()) {
+            return false;
+        }
+        last_docid = _blocks[_block].first;
+        max_weight = _blocks[_block].second;
+        return true;
+    }
+};
+
+/**
+ * Fake search without block max weights, counting the number of unpacks.
+ */
+class CountingSearch : public FakeSearch
+{
+    uint32_t &_unpacks;
+
+public:
+    CountingSearch(const FakeResult &result, TermFieldMatchData &tfmd, uint32_t &unpacks)
+        : FakeSearch("tag", "field", "term", result, search::fef::TermFieldMatchDataArray().add(&tfmd)),
+          _unpacks(unpacks)
+    {}
+    void doUnpack(uint32_t docid) override {
+        ++_unpacks;
+        FakeSearch::doUnpack(docid);
+    }
+};
+
+struct BlockMaxFixture
+{
+    static constexpr uint32_t num_docs = 10000;
+    std::vector<FakeResult> results;
+    std::vector<int32_t>    weights;
+    TermFieldMatchData      root_tfmd;
+    uint32_t                unpacks;
+
+    BlockMaxFixture()
+        : results(),
+          weights({10, 20, 30}),
+          root_tfmd(),
+          unpacks(0)
+    {
+        for (uint32_t t = 0; t < weights.size(); ++t) {
+            FakeResult result;
+            for (uint32_t docid = 1; docid < num_docs; ++docid) {
+                if ((docid % (t + 2)) == 0) {
+                    // a few documents have high weights, the rest have low weights
+                    uint32_t weight = ((docid * 7919 + t) % 997 == 0) ? 1000 : 1 + (docid + t) % 5;
+                    result.doc(docid).elem(0).weight(weight).pos(0);
+                }
+            }
+            results.push_back(result);
+        }
+    }
+    FakeResult search(bool block_max, bool strict) {
+        unpacks = 0;
+        MatchDataLayout layout;
+        std::vector<TermFieldHandle> handles;
+        for (size_t i = 0; i < weights.size(); ++i) {
+            handles.push_back(layout.allocTermField(0));
+        }
+        MatchData::UP children_md = layout.createMatchData();
+        wand::Terms terms;
+        for (size_t i = 0; i < weights.size(); ++i) {
+            TermFieldMatchData &tfmd = *children_md->resolveTermField(handles[i]);
+            SearchIterator *child = block_max
+                                    ? static_cast<SearchIterator *>(new BlockMaxSearch(results[i], tfmd, 16, unpacks))
+                                    : static_cast<SearchIterator *>(new CountingSearch(results[i], tfmd, unpacks));
+            terms.push_back(wand::Term(child, weights[i], results[i].inspect().size(), &tfmd));
+        }
+        SharedWeakAndPriorityQueue heap(10);
+        SearchIterator::UP sb(ParallelWeakAndSearch::create(terms, MatchParams(heap, 0, 1.0, 1),
+                                                            RankParams(root_tfmd, std::move(children_md)), strict));
+        FakeResult hits;
+        sb->initRange(1, num_docs);
+        for (uint32_t docid = 1; docid < num_docs; ) {
+            if (sb->seek(docid)) {
+                sb->unpack(docid);
+                hits.doc(docid).score(root_tfmd.getRawScore());
+                ++docid;
+            } else if (strict) {
+                docid = sb->getDocId();
+            } else {
+                ++docid;
+            }
+        }
+        return hits;
+    }
+};
+
+TEST_F("require that block max weights give the same result with fewer unpacks", BlockMaxFixture)
+{
+    for (bool strict : {true, false}) {
+        TEST_STATE(strict ? "strict" : "non-strict");
+        FakeResult expect = f.search(false, strict);
+        uint32_t plain_unpacks = f.unpacks;
+        FakeResult actual = f.search(true, strict);
+        EXPECT_EQUAL(expect, actual);
+        EXPECT_GREATER(expect.inspect().size(), 10u);
+        EXPECT_LESS(f.unpacks, plain_unpacks);
+    }
+}
+
 using MatchParams = ParallelWeakAndSearch::MatchParams;
 using RankParams = ParallelWeakAndSearch::RankParams;
 
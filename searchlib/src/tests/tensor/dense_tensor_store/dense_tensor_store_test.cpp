@@ -8,6 +8,7 @@ LOG_SETUP("dense_tensor_store_test");
 #include <vespa/eval/tensor/default_tensor_engine.h>
 #include <vespa/eval/tensor/tensor.h>
 #include <vespa/eval/tensor/dense/mutable_dense_tensor_view.h>
+#include <limits>
 
 using search::tensor::DenseTensorStore;
 using vespalib::eval::TensorSpec;
@@ -29,7 +30,7 @@ struct Fixture
 {
     DenseTensorStore store;
     Fixture(const vespalib::string &tensorType)
-        : store(ValueType::from_spec(tensorType))
+        : store(ValueType::from_storage_spec(tensorType))
     {}
     void assertSetAndGetTensor(const TensorSpec &tensorSpec) {
         Tensor::UP expTensor = makeTensor(tensorSpec);
@@ -68,6 +69,56 @@ TEST_F("require that correct empty tensor is returned for 1d bound tensor", Fixt
                                    add({{"x", 2}}, 0));
 }
 
+TEST_F("require that int8 cells are stored in one byte and returned as float", Fixture("tensor<int8>(x[3])"))
+{
+    EXPECT_EQUAL(1u, f.store.getCellSize());
+    Tensor::UP tensor = makeTensor(TensorSpec("tensor<float>(x[3])").
+                                   add({{"x", 0}}, 2).
+                                   add({{"x", 1}}, -3).
+                                   add({{"x", 2}}, 127));
+    EntryRef ref = f.store.setTensor(*tensor);
+    auto cells = f.store.get_typed_cells(ref);
+    EXPECT_TRUE(cells.type == ValueType::CellType::INT8);
+    EXPECT_EQUAL(-3.0, cells.get(1));
+    Tensor::UP actTensor = f.store.getTensor(ref);
+    EXPECT_EQUAL("tensor<float>(x[3])", actTensor->type().to_spec());
+    EXPECT_EQUAL(tensor->toSpec(), actTensor->toSpec());
+}
+
+TEST_F("require that int8 cells are rounded and saturated when stored", Fixture("tensor<int8>(x[6])"))
+{
+    Tensor::UP tensor = makeTensor(TensorSpec("tensor(x[6])").
+                                   add({{"x", 0}}, 2.6).
+                                   add({{"x", 1}}, -2.6).
+                                   add({{"x", 2}}, 300).
+                                   add({{"x", 3}}, -300).
+                                   add({{"x", 4}}, 127.4).
+                                   add({{"x", 5}}, std::numeric_limits<double>::quiet_NaN()));
+    EntryRef ref = f.store.setTensor(*tensor);
+    auto cells = f.store.get_typed_cells(ref);
+    EXPECT_EQUAL(3.0, cells.get(0));
+    EXPECT_EQUAL(-3.0, cells.get(1));
+    EXPECT_EQUAL(127.0, cells.get(2));
+    EXPECT_EQUAL(-128.0, cells.get(3));
+    EXPECT_EQUAL(127.0, cells.get(4));
+    EXPECT_EQUAL(0.0, cells.get(5));
+}
+
+TEST_F("require that bfloat16 cells are stored in two bytes and returned as float", Fixture("tensor<bfloat16>(x[3])"))
+{
+    EXPECT_EQUAL(2u, f.store.getCellSize());
+    Tensor::UP tensor = makeTensor(TensorSpec("tensor<float>(x[3])").
+                                   add({{"x", 0}}, 1.5).
+                                   add({{"x", 1}}, -256).
+                                   add({{"x", 2}}, 1.0 + 1.0/1024));
+    EntryRef ref = f.store.setTensor(*tensor);
+    Tensor::UP actTensor = f.store.getTensor(ref);
+    EXPECT_EQUAL(TensorSpec("tensor<float>(x[3])").
+                 add({{"x", 0}}, 1.5).
+                 add({{"x", 1}}, -256).
+                 add({{"x", 2}}, 1.0), actTensor->toSpec());
+}
+
 void
 assertArraySize(const vespalib::string &tensorType, uint32_t expArraySize) {
     Fixture f(tensorType);
@@ -80,6 +131,8 @@ TEST("require that array size is calculated correctly")
     TEST_DO(assertArraySize("tensor(x[10])", 96));
     TEST_DO(assertArraySize("tensor(x[3])", 32));
     TEST_DO(assertArraySize("tensor(x[10],y[10])", 800));
+    TEST_DO(assertArraySize("tensor<int8>(x[100])", 128));
+    TEST_DO(assertArraySize("tensor<bfloat16>(x[100])", 224));
 }
 
 TEST_MAIN() { TEST_RUN_ALL(); }
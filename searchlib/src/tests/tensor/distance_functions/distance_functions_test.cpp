@@ -142,6 +142,75 @@ TEST(DistanceFunctionsTest, innerproduct_gives_expected_score)
     EXPECT_LT(i44, 0.000001);
 }
 
+TEST(DistanceFunctionsTest, int8_cells_give_same_distances_as_double_cells)
+{
+    using CellType = vespalib::eval::ValueType::CellType;
+    std::vector<double> d1{1.0, -2.0, 3.0, 127.0, -128.0};
+    std::vector<double> d2{-5.0, 0.0, 4.0, -1.0, 100.0};
+    std::vector<int8_t> i1{1, -2, 3, 127, -128};
+    std::vector<int8_t> i2{-5, 0, 4, -1, 100};
+    for (auto metric : {DistanceMetric::Euclidean, DistanceMetric::Angular, DistanceMetric::InnerProduct}) {
+        auto expect = make_distance_function(metric, CellType::DOUBLE);
+        auto actual = make_distance_function(metric, CellType::INT8);
+        EXPECT_DOUBLE_EQ(expect->calc(t(d1), t(d2)), actual->calc(TypedCells(i1), TypedCells(i2)));
+        EXPECT_DOUBLE_EQ(expect->calc_with_limit(t(d1), t(d2), 1e9),
+                         actual->calc_with_limit(TypedCells(i1), TypedCells(i2), 1e9));
+    }
+}
+
+TEST(DistanceFunctionsTest, bfloat16_cells_give_same_distances_as_double_cells)
+{
+    using CellType = vespalib::eval::ValueType::CellType;
+    using vespalib::BFloat16;
+    // all values are exactly representable as bfloat16
+    std::vector<double> d1{1.0, -2.5, 0.125, 96.0};
+    std::vector<double> d2{-5.0, 0.0, 4.0, -1.75};
+    std::vector<BFloat16> b1{1.0f, -2.5f, 0.125f, 96.0f};
+    std::vector<BFloat16> b2{-5.0f, 0.0f, 4.0f, -1.75f};
+    for (auto metric : {DistanceMetric::Euclidean, DistanceMetric::Angular, DistanceMetric::InnerProduct}) {
+        auto expect = make_distance_function(metric, CellType::DOUBLE);
+        auto actual = make_distance_function(metric, CellType::BFLOAT16);
+        EXPECT_FLOAT_EQ(expect->calc(t(d1), t(d2)), actual->calc(TypedCells(b1), TypedCells(b2)));
+    }
+}
+
+template <typename CT>
+void verify_batch_gives_same_distances_as_calc(vespalib::eval::ValueType::CellType cell_type)
+{
+    // more rows than handled by the batched kernels in one call
+    constexpr size_t num_rows = 100;
+    constexpr size_t sz = 19;
+    std::vector<CT> query;
+    for (size_t i = 0; i < sz; ++i) {
+        query.push_back(CT(int(i % 7) - 3));
+    }
+    std::vector<std::vector<CT>> rows(num_rows);
+    std::vector<TypedCells> rhs;
+    for (size_t row = 0; row < num_rows; ++row) {
+        for (size_t i = 0; i < sz; ++i) {
+            rows[row].push_back(CT(int((row * 5 + i * 3) % 11) - 5));
+        }
+        rhs.push_back(TypedCells(rows[row]));
+    }
+    for (auto metric : {DistanceMetric::Euclidean, DistanceMetric::Angular, DistanceMetric::InnerProduct}) {
+        auto dist_fun = make_distance_function(metric, cell_type);
+        std::vector<double> result(num_rows);
+        dist_fun->calc_batch(TypedCells(query), rhs.data(), num_rows, result.data());
+        for (size_t row = 0; row < num_rows; ++row) {
+            EXPECT_DOUBLE_EQ(dist_fun->calc(TypedCells(query), rhs[row]), result[row]);
+        }
+    }
+}
+
+TEST(DistanceFunctionsTest, batch_gives_same_distances_as_calc)
+{
+    using CellType = vespalib::eval::ValueType::CellType;
+    verify_batch_gives_same_distances_as_calc<double>(CellType::DOUBLE);
+    verify_batch_gives_same_distances_as_calc<float>(CellType::FLOAT);
+    verify_batch_gives_same_distances_as_calc<int8_t>(CellType::INT8);
+    verify_batch_gives_same_distances_as_calc<vespalib::BFloat16>(CellType::BFLOAT16);
+}
+
 TEST(GeoDegreesTest, gives_expected_score)
 {
     auto ct = vespalib::eval::ValueType::CellType::DOUBLE;
@@ -5,11 +5,17 @@
 #include <vespa/searchlib/tensor/distance_functions.h>
 #include <vespa/searchlib/tensor/doc_vector_access.h>
 #include <vespa/searchlib/tensor/hnsw_index.h>
+#include <vespa/searchlib/tensor/nearest_neighbor_index_builder.h>
+#include <vespa/searchlib/tensor/nearest_neighbor_index_saver.h>
 #include <vespa/searchlib/tensor/random_level_generator.h>
 #include <vespa/searchlib/tensor/inv_log_level_generator.h>
+#include <vespa/searchlib/util/bufferwriter.h>
+#include <vespa/searchlib/util/fileutil.h>
 #include <vespa/vespalib/gtest/gtest.h>
 #include <vespa/vespalib/util/generationhandler.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
 #include <vespa/vespalib/data/slime/slime.h>
+#include <random>
 #include <vector>
 
 #include <vespa/log/log.h>
@@ -21,6 +27,8 @@ using namespace search::tensor;
 using namespace vespalib::slime;
 using vespalib::Slime;
 using search::BitVector;
+using search::BufferWriter;
+using search::fileutil::LoadedBuffer;
 
 
 template <typename FloatType>
@@ -620,5 +628,166 @@ TEST_F(TwoPhaseTest, two_phase_add)
     expect_levels(7, {{2}, {4}});
 }
 
+class IndexBuilderTest : public HnswIndexTest {
+public:
+    static constexpr uint32_t num_docs = 1000;
+    vespalib::ThreadStackExecutor executor;
+
+    IndexBuilderTest()
+        : HnswIndexTest(),
+          executor(4, 128 * 1024)
+    {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> dist(0.0, 100.0);
+        for (uint32_t docid = 1; docid < num_docs; ++docid) {
+            vectors.set(docid, {dist(rng), dist(rng), dist(rng), dist(rng)});
+        }
+        index = std::make_unique<HnswIndex>(vectors, std::make_unique<FloatSqEuclideanDistance>(),
+                                            std::make_unique<InvLogLevelGenerator>(8),
+                                            HnswIndex::Config(16, 8, 100, 0, true));
+    }
+    ~IndexBuilderTest() override;
+    void build(uint32_t max_pending, uint32_t min_sequential_adds) {
+        NearestNeighborIndexBuilder builder(*index, vectors, gen_handler, executor, max_pending, min_sequential_adds);
+        for (uint32_t docid = 1; docid < num_docs; ++docid) {
+            builder.add(docid);
+            EXPECT_LE(builder.pending(), max_pending);
+            if ((docid % 100) == 0) {
+                commit();
+            }
+        }
+        builder.drain();
+        EXPECT_EQ(0u, builder.pending());
+        commit();
+    }
+    uint32_t count_self_found() const {
+        uint32_t found = 0;
+        for (uint32_t docid = 1; docid < num_docs; ++docid) {
+            auto result = index->find_top_k(1, vectors.get_vector(docid), 10);
+            if (!result.empty() && result[0].docid == docid) {
+                ++found;
+            }
+        }
+        return found;
+    }
+};
+
+IndexBuilderTest::~IndexBuilderTest() = default;
+
+TEST_F(IndexBuilderTest, all_documents_are_added_when_building_with_multiple_threads)
+{
+    build(16, 100);
+    for (uint32_t docid = 1; docid < num_docs; ++docid) {
+        EXPECT_FALSE(index->get_node(docid).empty());
+    }
+    EXPECT_TRUE(index->check_link_symmetry());
+    EXPECT_GE(count_self_found(), (num_docs - 1) * 0.95);
+}
+
+TEST_F(IndexBuilderTest, documents_can_be_added_using_only_the_sequential_path)
+{
+    build(16, num_docs);
+    EXPECT_TRUE(index->check_link_symmetry());
+    EXPECT_EQ(num_docs - 1, index->count_reachable_nodes());
+}
+
+TEST_F(IndexBuilderTest, batch_search_gives_same_result_as_searching_for_each_vector)
+{
+    build(16, num_docs);
+    std::vector<vespalib::tensor::TypedCells> queries;
+    for (uint32_t docid = 1; docid < num_docs; docid += 7) {
+        queries.push_back(vectors.get_vector(docid));
+    }
+    auto filter = BitVector::create(num_docs);
+    for (uint32_t docid = 1; docid < num_docs; docid += 3) {
+        filter->setBit(docid);
+    }
+    std::vector<const BitVector *> filters = {nullptr, filter.get()};
+    for (const BitVector *batch_filter : filters) {
+        auto batch_result = index->find_top_k_batch(10, queries, batch_filter, 50);
+        ASSERT_EQ(queries.size(), batch_result.size());
+        for (size_t i = 0; i < queries.size(); ++i) {
+            auto exp = batch_filter
+                       ? index->find_top_k_with_filter(10, queries[i], *batch_filter, 50)
+                       : index->find_top_k(10, queries[i], 50);
+            ASSERT_EQ(exp.size(), batch_result[i].size());
+            for (size_t j = 0; j < exp.size(); ++j) {
+                EXPECT_EQ(exp[j].docid, batch_result[i][j].docid);
+                EXPECT_DOUBLE_EQ(exp[j].distance, batch_result[i][j].distance);
+            }
+        }
+    }
+}
+
+TEST_F(IndexBuilderTest, batch_search_in_empty_index_gives_empty_results)
+{
+    std::vector<vespalib::tensor::TypedCells> queries = {vectors.get_vector(1), vectors.get_vector(2)};
+    auto result = index->find_top_k_batch(10, queries, nullptr, 50);
+    ASSERT_EQ(2u, result.size());
+    EXPECT_TRUE(result[0].empty());
+    EXPECT_TRUE(result[1].empty());
+}
+
+class VectorBufferWriter : public BufferWriter {
+private:
+    char tmp[1024];
+public:
+    std::vector<char> output;
+    VectorBufferWriter() {
+        setup(tmp, 1024);
+    }
+    ~VectorBufferWriter() override {}
+    void flush() override {
+        output.insert(output.end(), tmp, tmp + usedLen());
+        rewind();
+    }
+};
+
+class OwnedLoadedBuffer : public LoadedBuffer {
+private:
+    std::vector<char> _data;
+public:
+    OwnedLoadedBuffer(std::vector<char> data)
+        : LoadedBuffer(nullptr, 0),
+          _data(std::move(data))
+    {
+        _buffer = _data.data();
+        _size = _data.size();
+    }
+};
+
+TEST_F(IndexBuilderTest, index_can_be_served_from_mapped_save_file_and_modified)
+{
+    build(16, num_docs);
+    VectorBufferWriter writer;
+    index->make_saver()->save(writer);
+    auto mapped = std::make_unique<HnswIndex>(vectors, std::make_unique<FloatSqEuclideanDistance>(),
+                                              std::make_unique<InvLogLevelGenerator>(8),
+                                              HnswIndex::Config(16, 8, 100, 0, true));
+    ASSERT_TRUE(mapped->load_mapped(std::make_unique<OwnedLoadedBuffer>(std::move(writer.output))));
+    EXPECT_LT(mapped->memory_usage().usedBytes(), index->memory_usage().usedBytes());
+    for (uint32_t docid = 1; docid < num_docs; docid += 10) {
+        auto exp = index->find_top_k(10, vectors.get_vector(docid), 50);
+        auto act = mapped->find_top_k(10, vectors.get_vector(docid), 50);
+        ASSERT_EQ(exp.size(), act.size());
+        for (size_t i = 0; i < exp.size(); ++i) {
+            EXPECT_EQ(exp[i].docid, act[i].docid);
+        }
+    }
+    index = std::move(mapped);
+    for (uint32_t docid = 1; docid < 100; ++docid) {
+        index->remove_document(docid);
+    }
+    commit();
+    EXPECT_TRUE(index->check_link_symmetry());
+    EXPECT_EQ(num_docs - 100, index->count_reachable_nodes());
+    for (uint32_t docid = 1; docid < 100; ++docid) {
+        index->add_document(docid);
+    }
+    commit();
+    EXPECT_TRUE(index->check_link_symmetry());
+    EXPECT_EQ(num_docs - 1, index->count_reachable_nodes());
+    EXPECT_GE(count_self_found(), (num_docs - 1) * 0.95);
+}
 
 GTEST_MAIN_RUN_ALL_TESTS()
@@ -0,0 +1,191 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/eval/tensor/dense/typed_cells.h>
+#include <vespa/searchlib/tensor/distance_functions.h>
+#include <vespa/searchlib/tensor/doc_vector_access.h>
+#include <vespa/searchlib/tensor/hnsw_index.h>
+#include <vespa/searchlib/tensor/inv_log_level_generator.h>
+#include <vespa/searchlib/tensor/nearest_neighbor_index_builder.h>
+#include <vespa/vespalib/util/generationhandler.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <vespa/vespalib/util/time.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+/**
+ * Measures build throughput of an HnswIndex when adding all documents
+ * with the single-threaded add path versus fanning out the prepare step
+ * over a varying number of threads using NearestNeighborIndexBuilder.
+ * Recall@10 against an exact scan is reported to show the impact on quality.
+ *
+ * Usage: searchlib_hnsw_index_builder_benchmark_app [num_docs] [dims] [max_threads]
+ */
+
+using namespace search::tensor;
+using vespalib::GenerationHandler;
+
+namespace {
+
+constexpr uint32_t max_pending = 1000;
+constexpr uint32_t min_sequential_adds = 10000;
+constexpr uint32_t commit_interval = 1000;
+constexpr uint32_t num_queries = 100;
+constexpr uint32_t top_k = 10;
+
+class RandomVectors : public DocVectorAccess {
+private:
+    uint32_t _dims;
+    std::vector<float> _cells;
+public:
+    RandomVectors(uint32_t num_docs, uint32_t dims)
+        : _dims(dims),
+          _cells(size_t(num_docs) * dims)
+    {
+        std::mt19937_64 rng(0x1234deadbeef5678uLL);
+        std::uniform_real_distribution<float> dist(-1.0, 1.0);
+        for (float &cell : _cells) {
+            cell = dist(rng);
+        }
+    }
+    uint32_t size() const { return _cells.size() / _dims; }
+    vespalib::tensor::TypedCells get_vector(uint32_t docid) const override {
+        vespalib::ConstArrayRef<float> ref(&_cells[size_t(docid) * _dims], _dims);
+        return vespalib::tensor::TypedCells(ref);
+    }
+};
+
+struct BuildResult {
+    double seconds;
+    double recall;
+};
+
+class Benchmark {
+private:
+    const RandomVectors& _vectors;
+    std::vector<std::vector<uint32_t>> _exact;
+    GenerationHandler _gen_handler;
+    std::unique_ptr<HnswIndex> _index;
+
+    void commit() {
+        _index->transfer_hold_lists(_gen_handler.getCurrentGeneration());
+        _gen_handler.incGeneration();
+        _gen_handler.updateFirstUsedGeneration();
+        _index->trim_hold_lists(_gen_handler.getFirstUsedGeneration());
+    }
+
+    void make_index() {
+        uint32_t m = 16;
+        _index = std::make_unique<HnswIndex>(_vectors, std::make_unique<SquaredEuclideanDistance<float>>(),
+                                             std::make_unique<InvLogLevelGenerator>(m),
+                                             HnswIndex::Config(2*m, m, 200, 10, true));
+    }
+
+    void calc_exact() {
+        SquaredEuclideanDistance<float> distance;
+        for (uint32_t query = 1; query <= num_queries; ++query) {
+            auto query_vector = _vectors.get_vector(query);
+            std::vector<std::pair<double, uint32_t>> all;
+            for (uint32_t docid = 1; docid < _vectors.size(); ++docid) {
+                all.emplace_back(distance.calc(query_vector, _vectors.get_vector(docid)), docid);
+            }
+            std::partial_sort(all.begin(), all.begin() + top_k, all.end());
+            std::vector<uint32_t> best;
+            for (uint32_t i = 0; i < top_k; ++i) {
+                best.push_back(all[i].second);
+            }
+            std::sort(best.begin(), best.end());
+            _exact.push_back(std::move(best));
+        }
+    }
+
+    double calc_recall() const {
+        uint32_t found = 0;
+        for (uint32_t query = 1; query <= num_queries; ++query) {
+            const auto &exact = _exact[query - 1];
+            for (const auto &hit : _index->find_top_k(top_k, _vectors.get_vector(query), 100)) {
+                if (std::binary_search(exact.begin(), exact.end(), hit.docid)) {
+                    ++found;
+                }
+            }
+        }
+        return double(found) / (num_queries * top_k);
+    }
+
+public:
+    Benchmark(const RandomVectors& vectors)
+        : _vectors(vectors),
+          _exact(),
+          _gen_handler(),
+          _index()
+    {
+        calc_exact();
+    }
+    ~Benchmark() = default;
+
+    BuildResult build_single_threaded() {
+        make_index();
+        vespalib::Timer timer;
+        for (uint32_t docid = 1; docid < _vectors.size(); ++docid) {
+            _index->add_document(docid);
+            if ((docid % commit_interval) == 0) {
+                commit();
+            }
+        }
+        commit();
+        return {vespalib::to_s(timer.elapsed()), calc_recall()};
+    }
+
+    BuildResult build_multi_threaded(uint32_t num_threads) {
+        make_index();
+        vespalib::ThreadStackExecutor executor(num_threads, 128 * 1024);
+        vespalib::Timer timer;
+        {
+            NearestNeighborIndexBuilder builder(*_index, _vectors, _gen_handler, executor,
+                                                max_pending, min_sequential_adds);
+            for (uint32_t docid = 1; docid < _vectors.size(); ++docid) {
+                builder.add(docid);
+                if ((docid % commit_interval) == 0) {
+                    commit();
+                }
+            }
+            builder.drain();
+        }
+        commit();
+        return {vespalib::to_s(timer.elapsed()), calc_recall()};
+    }
+};
+
+void
+report(const char *name, uint32_t num_docs, const BuildResult& result, double baseline_seconds)
+{
+    fprintf(stderr, "%-18s: %8.2f s, %10.0f docs/s, speedup %5.2f, recall@%u %.3f\n",
+            name, result.seconds, num_docs / result.seconds, baseline_seconds / result.seconds,
+            top_k, result.recall);
+}
+
+}
+
+int
+main(int argc, char **argv)
+{
+    uint32_t num_docs = (argc > 1) ? atoi(argv[1]) : 50000;
+    uint32_t dims = (argc > 2) ? atoi(argv[2]) : 128;
+    uint32_t max_threads = (argc > 3) ? atoi(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+    num_docs = std::max(num_docs, num_queries + 1);
+    fprintf(stderr, "building hnsw index of %u random %u-dimensional vectors\n", num_docs, dims);
+    RandomVectors vectors(num_docs + 1, dims);
+    Benchmark benchmark(vectors);
+    auto baseline = benchmark.build_single_threaded();
+    report("single threaded", num_docs, baseline, baseline.seconds);
+    for (uint32_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        auto result = benchmark.build_multi_threaded(num_threads);
+        char name[32];
+        snprintf(name, sizeof(name), "%u prepare threads", num_threads);
+        report(name, num_docs, result, baseline.seconds);
+    }
+    return 0;
+}
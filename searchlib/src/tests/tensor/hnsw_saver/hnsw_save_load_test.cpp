@@ -6,6 +6,7 @@
 #include <vespa/searchlib/util/bufferwriter.h>
 #include <vespa/searchlib/util/fileutil.h>
 #include <vespa/vespalib/gtest/gtest.h>
+#include <cstring>
 #include <vector>
 
 #include <vespa/log/log.h>
@@ -71,14 +72,15 @@ class CopyGraphTest : public ::testing::Test {
 public:
     HnswGraph original;
     HnswGraph copy;
+    std::vector<char> mapped_data;
 
     void expect_empty_d(uint32_t docid) const {
         EXPECT_FALSE(copy.node_refs[docid].load_acquire().valid());
+        EXPECT_FALSE(copy.has_node(docid, copy.get_node_ref(docid)));
     }
 
     void expect_level_0(uint32_t docid, const V& exp_links) const {
-        auto levels = copy.get_level_array(docid);
-        EXPECT_GE(levels.size(), 1);
+        EXPECT_GE(copy.get_num_levels(docid), 1);
         auto links = copy.get_link_array(docid, 0);
         EXPECT_EQ(exp_links.size(), links.size());
         for (size_t i = 0; i < exp_links.size() && i < links.size(); ++i) {
@@ -87,8 +89,7 @@ public:
     }
 
     void expect_level_1(uint32_t docid, const V& exp_links) const {
-        auto levels = copy.get_level_array(docid);
-        EXPECT_EQ(2, levels.size());
+        EXPECT_EQ(2, copy.get_num_levels(docid));
         auto links = copy.get_link_array(docid, 1);
         EXPECT_EQ(exp_links.size(), links.size());
         for (size_t i = 0; i < exp_links.size() && i < links.size(); ++i) {
@@ -107,6 +108,19 @@ public:
         LoadedBuffer buffer(&data[0], data.size());
         loader.load(buffer);
     }
+    void map_copy(std::vector<char> data) {
+        mapped_data = std::move(data);
+        LoadedBuffer buffer(&mapped_data[0], mapped_data.size());
+        auto mapped = MappedHnswGraph::make_view(buffer);
+        ASSERT_TRUE(mapped);
+        copy.set_base(std::move(mapped));
+    }
+    std::vector<char> save_copy() const {
+        HnswIndexSaver saver(copy);
+        VectorBufferWriter vector_writer;
+        saver.save(vector_writer);
+        return vector_writer.output;
+    }
 
     void expect_copy_as_populated() const {
         EXPECT_EQ(copy.size(), 7);
@@ -148,4 +162,57 @@ TEST_F(CopyGraphTest, later_changes_ignored)
     expect_copy_as_populated();
 }
 
+TEST_F(CopyGraphTest, reconstructs_graph_from_old_streamed_format)
+{
+    std::vector<uint32_t> words = {2, 1, 7,
+                                   0,
+                                   1, 3, 2, 4, 6,
+                                   2, 3, 1, 4, 6, 1, 4,
+                                   0,
+                                   2, 3, 1, 2, 6, 1, 2,
+                                   0,
+                                   1, 3, 1, 2, 4};
+    std::vector<char> data(words.size() * sizeof(uint32_t));
+    memcpy(&data[0], &words[0], data.size());
+    load_copy(data);
+    expect_copy_as_populated();
+}
+
+TEST_F(CopyGraphTest, serves_graph_from_mapped_base)
+{
+    populate(original);
+    map_copy(save_original());
+    expect_copy_as_populated();
+    EXPECT_TRUE(copy.in_base(1));
+    EXPECT_FALSE(copy.get_node_ref(1).valid());
+    EXPECT_EQ(save_original(), save_copy());
+}
+
+TEST_F(CopyGraphTest, changes_to_mapped_base_are_applied_in_memory)
+{
+    populate(original);
+    map_copy(save_original());
+    modify(original);
+    modify(copy);
+    EXPECT_FALSE(copy.in_base(1));
+    EXPECT_TRUE(copy.get_node_ref(1).valid());
+    EXPECT_EQ(HnswGraph::BaseNodeState::REMOVED, copy.get_base_node_state(2));
+    EXPECT_EQ(HnswGraph::BaseNodeState::REMOVED, copy.get_base_node_state(6));
+    expect_empty_d(2);
+    expect_empty_d(6);
+    expect_level_0(1, {7, 4});
+    expect_level_1(4, {7});
+    expect_level_1(7, {4});
+    EXPECT_EQ(4, copy.get_entry_node().docid);
+    EXPECT_EQ(save_original(), save_copy());
+}
+
+TEST_F(CopyGraphTest, mapped_base_is_rejected_for_old_streamed_format)
+{
+    std::vector<char> data(3 * sizeof(uint32_t), 0);
+    LoadedBuffer buffer(&data[0], data.size());
+    EXPECT_FALSE(MappedHnswGraph::is_mappable_format(buffer));
+    EXPECT_FALSE(MappedHnswGraph::make_view(buffer));
+}
+
 GTEST_MAIN_RUN_ALL_TESTS()
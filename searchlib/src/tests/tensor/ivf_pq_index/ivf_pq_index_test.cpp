@@ -0,0 +1,446 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/eval/tensor/dense/typed_cells.h>
+#include <vespa/searchlib/common/bitvector.h>
+#include <vespa/searchlib/tensor/distance_functions.h>
+#include <vespa/searchlib/tensor/doc_vector_access.h>
+#include <vespa/searchlib/tensor/ivf_pq_index.h>
+#include <vespa/searchlib/tensor/nearest_neighbor_index_saver.h>
+#include <vespa/searchlib/tensor/product_quantizer.h>
+#include <vespa/searchlib/util/bufferwriter.h>
+#include <vespa/searchlib/util/fileutil.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <vespa/vespalib/util/generationhandler.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <vespa/log/log.h>
+LOG_SETUP("ivf_pq_index_test");
+
+using vespalib::GenerationHandler;
+using namespace search::tensor;
+using search::attribute::DistanceMetric;
+using search::BitVector;
+using search::BufferWriter;
+using search::fileutil::LoadedBuffer;
+
+class MyDocVectorAccess : public DocVectorAccess {
+private:
+    using Vector = std::vector<float>;
+    std::vector<Vector> _vectors;
+
+public:
+    MyDocVectorAccess() : _vectors() {}
+    MyDocVectorAccess& set(uint32_t docid, const Vector& vec) {
+        if (docid >= _vectors.size()) {
+            _vectors.resize(docid + 1);
+        }
+        _vectors[docid] = vec;
+        return *this;
+    }
+    vespalib::tensor::TypedCells get_vector(uint32_t docid) const override {
+        vespalib::ConstArrayRef<float> ref(_vectors[docid]);
+        return vespalib::tensor::TypedCells(ref);
+    }
+};
+
+class VectorBufferWriter : public BufferWriter {
+private:
+    char tmp[1024];
+public:
+    std::vector<char> output;
+    VectorBufferWriter() {
+        setup(tmp, 1024);
+    }
+    ~VectorBufferWriter() {}
+    void flush() override {
+        for (size_t i = 0; i < usedLen(); ++i) {
+            output.push_back(tmp[i]);
+        }
+        rewind();
+    }
+};
+
+using DocIds = std::vector<uint32_t>;
+
+constexpr uint32_t dims = 8;
+
+std::vector<float>
+random_vector(std::mt19937 &rng)
+{
+    // Vectors are clustered around a few points to give the coarse centroids some structure.
+    std::uniform_int_distribution<int> cluster(0, 7);
+    std::normal_distribution<float> noise(0.0, 1.0);
+    float center = cluster(rng) * 10.0;
+    std::vector<float> result(dims);
+    for (auto &cell : result) {
+        cell = center + noise(rng);
+    }
+    return result;
+}
+
+class IvfPqIndexTest : public ::testing::Test {
+public:
+    MyDocVectorAccess vectors;
+    GenerationHandler gen_handler;
+    std::unique_ptr<IvfPqIndex> index;
+    std::mt19937 rng;
+
+    IvfPqIndexTest()
+        : vectors(),
+          gen_handler(),
+          index(),
+          rng(4711)
+    {
+        vectors.set(1, {2, 2, 2, 2, 2, 2, 2, 2}).set(2, {3, 2, 2, 2, 2, 2, 2, 2})
+               .set(3, {2, 7, 2, 2, 2, 2, 2, 2}).set(4, {9, 9, 9, 9, 9, 9, 9, 9});
+        init(300);
+    }
+    void init(uint32_t min_training_docs) {
+        index = std::make_unique<IvfPqIndex>(vectors, dims, std::make_unique<SquaredEuclideanDistance<float>>(),
+                                             IvfPqIndex::Config(16, 4, min_training_docs, 8, 2, DistanceMetric::Euclidean));
+    }
+    void init_angular() {
+        index = std::make_unique<IvfPqIndex>(vectors, dims, std::make_unique<AngularDistance<float>>(),
+                                             IvfPqIndex::Config(16, 4, 300, 8, 2, DistanceMetric::Angular));
+    }
+    void add_document(uint32_t docid) {
+        index->add_document(docid);
+        commit();
+    }
+    void add_random_documents(uint32_t first_docid, uint32_t last_docid) {
+        for (uint32_t docid = first_docid; docid <= last_docid; ++docid) {
+            vectors.set(docid, random_vector(rng));
+            index->add_document(docid);
+        }
+        commit();
+    }
+    void remove_document(uint32_t docid) {
+        index->remove_document(docid);
+        commit();
+    }
+    void wait_for_training() {
+        index->wait_for_training();
+        commit();
+    }
+    uint32_t list_of(uint32_t docid) const {
+        for (uint32_t list = 0; list < index->config().num_centroids(); ++list) {
+            auto docids = index->get_list(list);
+            if (std::find(docids.begin(), docids.end(), docid) != docids.end()) {
+                return list;
+            }
+        }
+        return index->config().num_centroids();
+    }
+    size_t num_listed() const {
+        size_t listed = 0;
+        for (uint32_t list = 0; list < index->config().num_centroids(); ++list) {
+            listed += index->get_list(list).size();
+        }
+        return listed;
+    }
+    void commit() {
+        index->transfer_hold_lists(gen_handler.getCurrentGeneration());
+        gen_handler.incGeneration();
+        gen_handler.updateFirstUsedGeneration();
+        index->trim_hold_lists(gen_handler.getFirstUsedGeneration());
+    }
+    DocIds find_top_k(uint32_t k, const std::vector<float> &query, uint32_t explore_k,
+                      const BitVector *filter = nullptr) const {
+        vespalib::ConstArrayRef<float> ref(query);
+        vespalib::tensor::TypedCells qv(ref);
+        auto neighbors = (filter != nullptr) ? index->find_top_k_with_filter(k, qv, *filter, explore_k)
+                                             : index->find_top_k(k, qv, explore_k);
+        DocIds result;
+        for (const auto &neighbor : neighbors) {
+            result.push_back(neighbor.docid);
+        }
+        return result;
+    }
+    DocIds exact_top_k(uint32_t k, const std::vector<float> &query, uint32_t doc_id_limit) const {
+        SquaredEuclideanDistance<float> distance;
+        vespalib::ConstArrayRef<float> ref(query);
+        vespalib::tensor::TypedCells qv(ref);
+        std::vector<std::pair<double, uint32_t>> all;
+        for (uint32_t docid = 1; docid < doc_id_limit; ++docid) {
+            if (index->has_document(docid)) {
+                all.emplace_back(distance.calc(qv, vectors.get_vector(docid)), docid);
+            }
+        }
+        std::sort(all.begin(), all.end());
+        DocIds result;
+        for (uint32_t i = 0; i < k && i < all.size(); ++i) {
+            result.push_back(all[i].second);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+    double recall(uint32_t k, uint32_t explore_k, uint32_t doc_id_limit) {
+        uint32_t found = 0;
+        uint32_t num_queries = 50;
+        for (uint32_t i = 0; i < num_queries; ++i) {
+            auto query = random_vector(rng);
+            auto exact = exact_top_k(k, query, doc_id_limit);
+            for (uint32_t docid : find_top_k(k, query, explore_k)) {
+                if (std::binary_search(exact.begin(), exact.end(), docid)) {
+                    ++found;
+                }
+            }
+        }
+        return double(found) / (num_queries * k);
+    }
+    std::vector<char> save_index() const {
+        auto saver = index->make_saver();
+        VectorBufferWriter writer;
+        saver->save(writer);
+        return writer.output;
+    }
+    void load_index(std::vector<char> data, bool exp_success = true) {
+        init(300);
+        LoadedBuffer buffer(&data[0], data.size());
+        EXPECT_EQ(exp_success, index->load(buffer));
+    }
+};
+
+TEST_F(IvfPqIndexTest, untrained_index_is_searched_exhaustively)
+{
+    for (uint32_t docid = 1; docid <= 4; ++docid) {
+        add_document(docid);
+    }
+    EXPECT_FALSE(index->is_trained());
+    EXPECT_EQ(DocIds({1, 2}), find_top_k(2, {2, 2, 2, 2, 2, 2, 2, 2}, 2));
+    EXPECT_EQ(DocIds({1, 2, 3, 4}), find_top_k(10, {2, 2, 2, 2, 2, 2, 2, 2}, 10));
+    BitVector::UP filter = BitVector::create(5);
+    filter->setBit(2);
+    filter->setBit(4);
+    filter->invalidateCachedCount();
+    EXPECT_EQ(DocIds({2}), find_top_k(1, {2, 2, 2, 2, 2, 2, 2, 2}, 1, filter.get()));
+    remove_document(2);
+    EXPECT_EQ(DocIds({1, 3}), find_top_k(2, {2, 2, 2, 2, 2, 2, 2, 2}, 2));
+    EXPECT_FALSE(index->has_document(2));
+}
+
+TEST_F(IvfPqIndexTest, index_is_trained_when_enough_documents_are_added)
+{
+    add_random_documents(10, 308);
+    EXPECT_FALSE(index->is_trained());
+    add_random_documents(309, 309);
+    wait_for_training();
+    EXPECT_TRUE(index->is_trained());
+    EXPECT_TRUE(index->is_encoded(10));
+    EXPECT_TRUE(index->is_encoded(309));
+    add_random_documents(310, 2000);
+    EXPECT_TRUE(index->is_encoded(2000));
+    EXPECT_EQ(1991u, num_listed());
+}
+
+TEST_F(IvfPqIndexTest, documents_changed_while_training_are_handled_when_quantizer_is_installed)
+{
+    add_random_documents(1, 300);
+    // Training is started in the background, and the index is searched exhaustively until it is installed.
+    add_random_documents(301, 400);
+    remove_document(10);
+    remove_document(350);
+    vectors.set(10, random_vector(rng));
+    add_document(10);
+    wait_for_training();
+    ASSERT_TRUE(index->is_trained());
+    EXPECT_TRUE(index->is_encoded(400));
+    EXPECT_FALSE(index->has_document(350));
+    EXPECT_EQ(399u, num_listed());
+    // The document added again is encoded using its new vector.
+    const auto &quantizer = *index->quantizer();
+    auto vector = vectors.get_vector(10).typify<float>();
+    uint32_t list = quantizer.assign(vector.cbegin());
+    std::vector<uint8_t> codes(quantizer.code_size());
+    quantizer.encode(vector.cbegin(), list, codes.data());
+    EXPECT_EQ(list, list_of(10));
+    EXPECT_EQ(codes, std::vector<uint8_t>(index->get_codes(10), index->get_codes(10) + codes.size()));
+}
+
+TEST_F(IvfPqIndexTest, removed_documents_are_dropped_from_lists)
+{
+    add_random_documents(1, 1000);
+    wait_for_training();
+    uint32_t list = list_of(500);
+    auto docids = index->get_list(list);
+    ASSERT_GT(docids.size(), 2u);
+    for (uint32_t docid : docids) {
+        if (docid != 500) {
+            remove_document(docid);
+        }
+    }
+    EXPECT_EQ(std::vector<uint32_t>({500}), index->get_list(list));
+    EXPECT_EQ(1000u - (docids.size() - 1), num_listed());
+    EXPECT_LT(index->memory_usage().deadBytes(), docids.size() * sizeof(uint32_t));
+    add_random_documents(1001, 1100);
+    EXPECT_EQ(1100u - (docids.size() - 1), num_listed());
+}
+
+TEST_F(IvfPqIndexTest, trained_index_finds_most_of_the_nearest_neighbors)
+{
+    add_random_documents(1, 2000);
+    wait_for_training();
+    ASSERT_TRUE(index->is_trained());
+    double low_recall = recall(10, 10, 2001);
+    double high_recall = recall(10, 200, 2001);
+    EXPECT_GT(high_recall, 0.95);
+    EXPECT_GE(high_recall, low_recall);
+}
+
+TEST_F(IvfPqIndexTest, trained_index_can_search_with_filter_and_handle_removes)
+{
+    add_random_documents(1, 1000);
+    wait_for_training();
+    ASSERT_TRUE(index->is_trained());
+    auto query = vectors.get_vector(500).typify<float>();
+    std::vector<float> query_vector(query.begin(), query.end());
+    EXPECT_EQ(DocIds({500}), find_top_k(1, query_vector, 100));
+    BitVector::UP filter = BitVector::create(1001);
+    filter->setInterval(1, 1001);
+    filter->clearBit(500);
+    filter->invalidateCachedCount();
+    auto filtered = find_top_k(5, query_vector, 100, filter.get());
+    EXPECT_EQ(5u, filtered.size());
+    EXPECT_FALSE(std::binary_search(filtered.begin(), filtered.end(), 500u));
+    remove_document(500);
+    EXPECT_FALSE(index->has_document(500));
+    EXPECT_EQ(filtered, find_top_k(5, query_vector, 100));
+}
+
+TEST_F(IvfPqIndexTest, untrained_index_can_be_saved_and_loaded)
+{
+    for (uint32_t docid = 1; docid <= 4; ++docid) {
+        add_document(docid);
+    }
+    remove_document(3);
+    load_index(save_index());
+    EXPECT_FALSE(index->is_trained());
+    EXPECT_TRUE(index->has_document(1));
+    EXPECT_TRUE(index->has_document(2));
+    EXPECT_FALSE(index->has_document(3));
+    EXPECT_TRUE(index->has_document(4));
+    EXPECT_EQ(DocIds({1, 2}), find_top_k(2, {2, 2, 2, 2, 2, 2, 2, 2}, 2));
+}
+
+TEST_F(IvfPqIndexTest, trained_index_can_be_saved_and_loaded)
+{
+    add_random_documents(1, 1000);
+    wait_for_training();
+    remove_document(17);
+    ASSERT_TRUE(index->is_trained());
+    std::vector<std::vector<float>> queries;
+    std::vector<DocIds> expected;
+    for (uint32_t i = 0; i < 10; ++i) {
+        queries.push_back(random_vector(rng));
+        expected.push_back(find_top_k(10, queries.back(), 50));
+    }
+    auto old_codes = std::vector<uint8_t>(index->get_codes(42), index->get_codes(42) + 4);
+    load_index(save_index());
+    EXPECT_TRUE(index->is_trained());
+    EXPECT_FALSE(index->has_document(17));
+    EXPECT_TRUE(index->is_encoded(42));
+    EXPECT_EQ(old_codes, std::vector<uint8_t>(index->get_codes(42), index->get_codes(42) + 4));
+    for (uint32_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(expected[i], find_top_k(10, queries[i], 50));
+    }
+}
+
+TEST_F(IvfPqIndexTest, load_fails_when_config_does_not_match)
+{
+    add_document(1);
+    auto data = save_index();
+    index = std::make_unique<IvfPqIndex>(vectors, dims, std::make_unique<SquaredEuclideanDistance<float>>(),
+                                         IvfPqIndex::Config(32, 4, 300, 8, 2, DistanceMetric::Euclidean));
+    LoadedBuffer buffer(&data[0], data.size());
+    EXPECT_FALSE(index->load(buffer));
+}
+
+TEST_F(IvfPqIndexTest, memory_usage_per_document_is_small_when_trained)
+{
+    add_random_documents(1, 2000);
+    wait_for_training();
+    ASSERT_TRUE(index->is_trained());
+    auto before = index->memory_usage().usedBytes();
+    add_random_documents(2001, 4000);
+    auto after = index->memory_usage().usedBytes();
+    // Each document uses 4 bytes of codes, 4 bytes in a list and 4 bytes in the docid mapping.
+    EXPECT_LT((after - before) / 2000, 24u);
+}
+
+TEST_F(IvfPqIndexTest, angular_index_encodes_normalized_vectors)
+{
+    init_angular();
+    add_random_documents(1, 400);
+    wait_for_training();
+    ASSERT_TRUE(index->is_trained());
+    auto vector = vectors.get_vector(400).typify<float>();
+    std::vector<float> scaled(vector.begin(), vector.end());
+    for (auto &cell : scaled) {
+        cell *= 3.0;
+    }
+    vectors.set(401, scaled);
+    add_document(401);
+    EXPECT_EQ(list_of(400), list_of(401));
+    EXPECT_EQ(std::vector<uint8_t>(index->get_codes(400), index->get_codes(400) + 4),
+              std::vector<uint8_t>(index->get_codes(401), index->get_codes(401) + 4));
+    EXPECT_EQ(DocIds({400, 401}), find_top_k(2, scaled, 50));
+}
+
+TEST(ProductQuantizerTest, num_subquantizers_is_adjusted_to_divide_dims)
+{
+    EXPECT_EQ(16u, ProductQuantizer::adjust_num_subquantizers(128, 16));
+    EXPECT_EQ(8u, ProductQuantizer::adjust_num_subquantizers(8, 16));
+    EXPECT_EQ(10u, ProductQuantizer::adjust_num_subquantizers(100, 16));
+    EXPECT_EQ(1u, ProductQuantizer::adjust_num_subquantizers(7, 4));
+}
+
+TEST(ProductQuantizerTest, approximate_distance_is_exact_when_codebooks_cover_all_residuals)
+{
+    // 256 vectors with 2 sub-spaces, giving each vector its own codebook entry in each sub-space.
+    std::vector<float> sample;
+    for (uint32_t i = 0; i < ProductQuantizer::codebook_size; ++i) {
+        sample.insert(sample.end(), {float(i), float(i % 7), float(i % 13), float(i) * 0.5f});
+    }
+    ProductQuantizer pq(4, 1, 2, ProductQuantizer::Metric::SquaredEuclidean);
+    pq.train(sample, 4);
+    std::vector<float> query = {3.5, 2.0, 1.0, 7.0};
+    std::vector<float> table;
+    pq.make_distance_table(query.data(), 0, table);
+    auto &computer = vespalib::hwaccelrated::IAccelrated::getAccelerator();
+    for (uint32_t i = 0; i < ProductQuantizer::codebook_size; i += 17) {
+        const float *vector = &sample[i * 4];
+        EXPECT_EQ(0u, pq.assign(vector));
+        uint8_t codes[2];
+        pq.encode(vector, 0, codes);
+        double exact = computer.squaredEuclideanDistance(query.data(), vector, 4);
+        EXPECT_NEAR(exact, pq.approx_distance(table.data(), codes), 1e-3);
+    }
+}
+
+TEST(ProductQuantizerTest, approximate_inner_product_distance_is_exact_when_codebooks_cover_all_residuals)
+{
+    std::vector<float> sample;
+    for (uint32_t i = 0; i < ProductQuantizer::codebook_size; ++i) {
+        sample.insert(sample.end(), {float(i % 11), float(i % 7), float(i % 13), float(i) * 0.5f});
+    }
+    ProductQuantizer pq(4, 1, 2, ProductQuantizer::Metric::InnerProduct);
+    pq.train(sample, 4);
+    std::vector<float> query = {3.5, 2.0, 1.0, 7.0};
+    std::vector<float> table;
+    float bias = pq.make_distance_table(query.data(), 0, table);
+    std::vector<float> centroid_distances;
+    pq.centroid_distances(query.data(), centroid_distances);
+    EXPECT_EQ(bias, centroid_distances[0]);
+    auto &computer = vespalib::hwaccelrated::IAccelrated::getAccelerator();
+    for (uint32_t i = 0; i < ProductQuantizer::codebook_size; i += 17) {
+        const float *vector = &sample[i * 4];
+        uint8_t codes[2];
+        pq.encode(vector, 0, codes);
+        double exact = -computer.dotProduct(query.data(), vector, 4);
+        EXPECT_NEAR(exact, pq.approx_distance(table.data(), codes, bias), 1e-2);
+    }
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -4,6 +4,8 @@
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/vespalib/objects/identifiable.h>
 #include <vespa/searchlib/index/dummyfileheadercontext.h>
+#include <vespa/searchlib/common/gatecallback.h>
+#include <vespa/vespalib/util/gate.h>
 #include <vespa/fastos/file.h>
 #include <map>
 
@@ -15,6 +17,7 @@ using namespace transactionlog;
 using namespace document;
 using namespace vespalib;
 using search::index::DummyFileHeaderContext;
+using namespace std::chrono_literals;
 
 vespalib::string myhex(const void * b, size_t sz)
 {
@@ -52,6 +55,10 @@ private:
     void testMany();
     void testErase();
     void testSync();
+    void testGroupCommit();
+    void testGroupCommitMaxBytes();
+    void testGroupCommitOnShutdown();
+    void testGroupCommitToDeletedDomain();
     void testTruncateOnShortRead();
     void testTruncateOnVersionMismatch();
 };
@@ -771,6 +778,127 @@ Test::testSync()
 }
 
 
+namespace {
+
+void
+commitEntries(TransLogServer & tlss, const vespalib::string & domain, size_t numPackets,
+              Writer::DoneCallback onDone)
+{
+    for (size_t i(0); i < numPackets; i++) {
+        Packet p;
+        Packet::Entry e(i + 1, 1, vespalib::ConstBufferRef((const char *)&i, sizeof(i)));
+        ASSERT_TRUE(p.add(e));
+        tlss.commit(domain, p, onDone);
+    }
+}
+
+class FailureCallback : public IDestructorCallback,
+                        public ICommitFailureHandler
+{
+    std::atomic<size_t> & _failed;
+    vespalib::Gate      & _gate;
+public:
+    FailureCallback(std::atomic<size_t> & failed, vespalib::Gate & gate) : _failed(failed), _gate(gate) { }
+    ~FailureCallback() override { _gate.countDown(); }
+    void commitFailed(const vespalib::string &) override { ++_failed; }
+};
+
+}
+
+void
+Test::testGroupCommit()
+{
+    const unsigned int NUM_PACKETS = 10;
+
+    DummyFileHeaderContext fileHeaderContext;
+    TransLogServer tlss("test14", 18377, ".", fileHeaderContext, 0x1000000, 4, DomainPart::xxh64,
+                        GroupCommitConfig(500ms, 0x100000, true));
+    TransLogClient tls("tcp/localhost:18377");
+
+    createDomainTest(tls, "groupcommit", 0);
+    TransLogClient::Session::UP s1 = openDomainTest(tls, "groupcommit");
+    vespalib::Gate gate;
+    commitEntries(tlss, "groupcommit", NUM_PACKETS, std::make_shared<GateCallback>(gate));
+    EXPECT_TRUE(gate.await(60000));
+    checkFilledDomainTest(s1, NUM_PACKETS);
+
+    CommitStats stats = tlss.getDomainStats()["groupcommit"].commitStats;
+    EXPECT_EQUAL(NUM_PACKETS, stats.commits);
+    EXPECT_EQUAL(NUM_PACKETS, stats.entries);
+    EXPECT_LESS(stats.batches, NUM_PACKETS);
+    EXPECT_EQUAL(stats.batches, stats.syncs);
+    LOG(info, "testGroupCommit(): %" PRIu64 " batches, max %" PRIu64 " commits per batch",
+        stats.batches, stats.maxBatchCommits);
+
+    SerialNum syncedTo(0);
+    EXPECT_TRUE(s1->sync(NUM_PACKETS, syncedTo));
+    EXPECT_EQUAL(syncedTo, NUM_PACKETS);
+}
+
+void
+Test::testGroupCommitMaxBytes()
+{
+    const unsigned int NUM_PACKETS = 10;
+
+    DummyFileHeaderContext fileHeaderContext;
+    TransLogServer tlss("test15", 18377, ".", fileHeaderContext, 0x1000000, 4, DomainPart::xxh64,
+                        GroupCommitConfig(3600s, 1, false));
+    TransLogClient tls("tcp/localhost:18377");
+
+    createDomainTest(tls, "groupcommit", 0);
+    TransLogClient::Session::UP s1 = openDomainTest(tls, "groupcommit");
+    vespalib::Gate gate;
+    commitEntries(tlss, "groupcommit", NUM_PACKETS, std::make_shared<GateCallback>(gate));
+    // Every commit fills the batch, so no commit waits for the window to end.
+    EXPECT_EQUAL(0u, gate.getCount());
+    checkFilledDomainTest(s1, NUM_PACKETS);
+
+    CommitStats stats = tlss.getDomainStats()["groupcommit"].commitStats;
+    EXPECT_EQUAL(NUM_PACKETS, stats.batches);
+    EXPECT_EQUAL(0u, stats.syncs);
+}
+
+void
+Test::testGroupCommitOnShutdown()
+{
+    const unsigned int NUM_PACKETS = 10;
+
+    DummyFileHeaderContext fileHeaderContext;
+    vespalib::Gate gate;
+    {
+        TransLogServer tlss("test16", 18377, ".", fileHeaderContext, 0x1000000, 4, DomainPart::xxh64,
+                            GroupCommitConfig(3600s, 0x100000, true));
+        TransLogClient tls("tcp/localhost:18377");
+        createDomainTest(tls, "groupcommit", 0);
+        commitEntries(tlss, "groupcommit", NUM_PACKETS, std::make_shared<GateCallback>(gate));
+        EXPECT_EQUAL(1u, gate.getCount());
+    }
+    // The pending commits are written when the server is stopped.
+    EXPECT_EQUAL(0u, gate.getCount());
+    TransLogServer tlss("test16", 18377, ".", fileHeaderContext, 0x1000000);
+    TransLogClient tls("tcp/localhost:18377");
+    TransLogClient::Session::UP s1 = openDomainTest(tls, "groupcommit");
+    checkFilledDomainTest(s1, NUM_PACKETS);
+}
+
+void
+Test::testGroupCommitToDeletedDomain()
+{
+    const unsigned int NUM_PACKETS = 10;
+
+    DummyFileHeaderContext fileHeaderContext;
+    TransLogServer tlss("test17", 18377, ".", fileHeaderContext, 0x1000000, 4, DomainPart::xxh64,
+                        GroupCommitConfig(3600s, 0x100000, false));
+    TransLogClient tls("tcp/localhost:18377");
+    createDomainTest(tls, "groupcommit", 0);
+    std::atomic<size_t> failed(0);
+    vespalib::Gate gate;
+    commitEntries(tlss, "groupcommit", NUM_PACKETS, std::make_shared<FailureCallback>(failed, gate));
+    ASSERT_TRUE(tls.remove("groupcommit"));
+    EXPECT_TRUE(gate.await(60000));
+    EXPECT_EQUAL(NUM_PACKETS, failed.load());
+}
+
 void
 Test::testTruncateOnVersionMismatch()
 {
@@ -888,6 +1016,10 @@ int Test::Main()
     testRemove();
     
     testSync();
+    testGroupCommit();
+    testGroupCommitMaxBytes();
+    testGroupCommitOnShutdown();
+    testGroupCommitToDeletedDomain();
 
     testTruncateOnShortRead();
     testTruncateOnVersionMismatch();
@@ -500,11 +500,27 @@ bool check_valid_diversity_attr(const IAttributeVector *attr) {
     return (attr->hasEnum() || attr->isIntegerType() || attr->isFloatingPointType());
 }
 
+/**
+ * The query tensor (rhs) is compatible with the attribute tensor (lhs) if the dimensions are equal,
+ * or if it is a batch of query points: the dimension of the attribute tensor and one more indexed dimension.
+ */
 bool
 is_compatible_for_nearest_neighbor(const vespalib::eval::ValueType& lhs,
                                    const vespalib::eval::ValueType& rhs)
 {
-    return (lhs.dimensions() == rhs.dimensions());
+    if (lhs.dimensions() == rhs.dimensions()) {
+        return true;
+    }
+    if ((lhs.dimensions().size() != 1) || (rhs.dimensions().size() != 2)) {
+        return false;
+    }
+    const auto& vector_dim = lhs.dimensions()[0];
+    for (size_t i = 0; i < 2; ++i) {
+        if (rhs.dimensions()[i] == vector_dim) {
+            return rhs.dimensions()[1 - i].is_indexed();
+        }
+    }
+    return false;
 }
 
 //-----------------------------------------------------------------------------
@@ -710,7 +726,8 @@ public:
                                                                         n.get_target_num_hits(),
                                                                         n.get_allow_approximate(),
                                                                         n.get_explore_additional_hits(),
-                                                                        getRequestContext().get_attribute_blueprint_params().nearest_neighbor_brute_force_limit));
+                                                                        getRequestContext().get_attribute_blueprint_params().nearest_neighbor_brute_force_limit,
+                                                                        getRequestContext().get_attribute_blueprint_params().nearest_neighbor_target_hits_max_adjustment_factor));
     }
 };
 
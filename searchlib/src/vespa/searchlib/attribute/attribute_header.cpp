@@ -24,12 +24,17 @@ const vespalib::string hnsw_index_value = "hnsw";
 const vespalib::string hnsw_max_links_tag = "hnsw.max_links_per_node";
 const vespalib::string hnsw_neighbors_to_explore_tag = "hnsw.neighbors_to_explore_at_insert";
 const vespalib::string hnsw_distance_metric = "hnsw.distance_metric";
+const vespalib::string ivf_pq_index_value = "ivf_pq";
+const vespalib::string ivf_pq_num_centroids_tag = "ivf_pq.num_centroids";
+const vespalib::string ivf_pq_num_subquantizers_tag = "ivf_pq.num_subquantizers";
+const vespalib::string ivf_pq_distance_metric = "ivf_pq.distance_metric";
 const vespalib::string euclidean = "euclidean";
 const vespalib::string angular = "angular";
 const vespalib::string geodegrees = "geodegrees";
 const vespalib::string innerproduct = "innerproduct";
 const vespalib::string doc_id_limit_tag = "docIdLimit";
 const vespalib::string enumerated_tag = "enumerated";
+const vespalib::string delta_tag = "delta";
 const vespalib::string unique_value_count_tag = "uniqueValueCount";
 const vespalib::string total_value_count_tag = "totalValueCount";
 
@@ -46,10 +51,12 @@ AttributeHeader::AttributeHeader(const vespalib::string &fileName)
       _collectionType(attribute::CollectionType::Type::SINGLE),
       _tensorType(vespalib::eval::ValueType::error_type()),
       _enumerated(false),
+      _delta(false),
       _collectionTypeParamsSet(false),
       _predicateParamsSet(false),
       _predicateParams(),
       _hnsw_index_params(),
+      _ivf_pq_index_params(),
       _numDocs(0),
       _uniqueValueCount(0),
       _totalValueCount(0),
@@ -65,6 +72,7 @@ AttributeHeader::AttributeHeader(const vespalib::string &fileName,
                                  bool enumerated,
                                  const attribute::PersistentPredicateParams &predicateParams,
                                  const std::optional<HnswIndexParams>& hnsw_index_params,
+                                 const std::optional<IvfPqIndexParams>& ivf_pq_index_params,
                                  uint32_t numDocs,
                                  uint64_t uniqueValueCount,
                                  uint64_t totalValueCount,
@@ -75,10 +83,12 @@ AttributeHeader::AttributeHeader(const vespalib::string &fileName,
       _collectionType(collectionType),
       _tensorType(tensorType),
       _enumerated(enumerated),
+      _delta(false),
       _collectionTypeParamsSet(false),
       _predicateParamsSet(false),
       _predicateParams(predicateParams),
       _hnsw_index_params(hnsw_index_params),
+      _ivf_pq_index_params(ivf_pq_index_params),
       _numDocs(numDocs),
       _uniqueValueCount(uniqueValueCount),
       _totalValueCount(totalValueCount),
@@ -143,7 +153,7 @@ AttributeHeader::internalExtractTags(const vespalib::GenericHeader &header)
     }
     if (_basicType.type() == BasicType::Type::TENSOR) {
         assert(header.hasTag(tensorTypeTag));
-        _tensorType = vespalib::eval::ValueType::from_spec(header.getTag(tensorTypeTag).asString());
+        _tensorType = vespalib::eval::ValueType::from_storage_spec(header.getTag(tensorTypeTag).asString());
         if (header.hasTag(hnsw_max_links_tag)) {
             assert(header.hasTag(hnsw_neighbors_to_explore_tag));
             assert(header.hasTag(hnsw_distance_metric));
@@ -153,6 +163,15 @@ AttributeHeader::internalExtractTags(const vespalib::GenericHeader &header)
             DistanceMetric distance_metric = to_distance_metric(header.getTag(hnsw_distance_metric).asString());
             _hnsw_index_params.emplace(max_links, neighbors_to_explore, distance_metric);
         }
+        if (header.hasTag(ivf_pq_num_centroids_tag)) {
+            assert(header.hasTag(ivf_pq_num_subquantizers_tag));
+            assert(header.hasTag(ivf_pq_distance_metric));
+
+            uint32_t num_centroids = header.getTag(ivf_pq_num_centroids_tag).asInteger();
+            uint32_t num_subquantizers = header.getTag(ivf_pq_num_subquantizers_tag).asInteger();
+            DistanceMetric distance_metric = to_distance_metric(header.getTag(ivf_pq_distance_metric).asString());
+            _ivf_pq_index_params.emplace(num_centroids, num_subquantizers, distance_metric);
+        }
     }
     if (_basicType.type() == BasicType::Type::PREDICATE) {
         if (header.hasTag(predicateArityTag)) {
@@ -173,6 +192,9 @@ AttributeHeader::internalExtractTags(const vespalib::GenericHeader &header)
     if (header.hasTag(enumerated_tag)) {
         _enumerated = header.getTag(enumerated_tag).asInteger() != 0;
     }
+    if (header.hasTag(delta_tag)) {
+        _delta = header.getTag(delta_tag).asInteger() != 0;
+    }
     if (header.hasTag(total_value_count_tag)) {
         _totalValueCount = header.getTag(total_value_count_tag).asInteger();
     }
@@ -211,6 +233,9 @@ AttributeHeader::addTags(vespalib::GenericHeader &header) const
     if (_enumerated) {
         header.putTag(Tag(enumerated_tag, 1));
     }
+    if (_delta) {
+        header.putTag(Tag(delta_tag, 1));
+    }
     if (_createSerialNum != 0u) {
         header.putTag(Tag(createSerialNumTag, _createSerialNum));
     }
@@ -222,6 +247,12 @@ AttributeHeader::addTags(vespalib::GenericHeader &header) const
             header.putTag(Tag(hnsw_max_links_tag, params.max_links_per_node()));
             header.putTag(Tag(hnsw_neighbors_to_explore_tag, params.neighbors_to_explore_at_insert()));
             header.putTag(Tag(hnsw_distance_metric, to_string(params.distance_metric())));
+        } else if (_ivf_pq_index_params.has_value()) {
+            header.putTag(Tag(nearest_neighbor_index_tag, ivf_pq_index_value));
+            const auto& params = *_ivf_pq_index_params;
+            header.putTag(Tag(ivf_pq_num_centroids_tag, params.num_centroids()));
+            header.putTag(Tag(ivf_pq_num_subquantizers_tag, params.num_subquantizers()));
+            header.putTag(Tag(ivf_pq_distance_metric, to_string(params.distance_metric())));
         }
     }
     if (_basicType.type() == attribute::BasicType::Type::PREDICATE) {
@@ -6,6 +6,7 @@
 #include <vespa/searchcommon/attribute/basictype.h>
 #include <vespa/searchcommon/attribute/collectiontype.h>
 #include <vespa/searchcommon/attribute/hnsw_index_params.h>
+#include <vespa/searchcommon/attribute/ivf_pq_index_params.h>
 #include <vespa/searchcommon/attribute/predicate_params.h>
 #include <vespa/eval/eval/value_type.h>
 #include <optional>
@@ -25,10 +26,12 @@ private:
     CollectionType _collectionType;
     vespalib::eval::ValueType _tensorType;
     bool        _enumerated;
+    bool        _delta;
     bool        _collectionTypeParamsSet;
     bool        _predicateParamsSet;
     PersistentPredicateParams _predicateParams;
     std::optional<HnswIndexParams> _hnsw_index_params;
+    std::optional<IvfPqIndexParams> _ivf_pq_index_params;
     uint32_t    _numDocs;
     uint64_t    _uniqueValueCount;
     uint64_t    _totalValueCount;
@@ -46,6 +49,7 @@ public:
                     bool enumerated,
                     const PersistentPredicateParams &predicateParams,
                     const std::optional<HnswIndexParams>& hnsw_index_params,
+                    const std::optional<IvfPqIndexParams>& ivf_pq_index_params,
                     uint32_t numDocs,
                     uint64_t uniqueValueCount,
                     uint64_t totalValueCount,
@@ -61,14 +65,18 @@ public:
     bool hasWeightedSetType() const;
     uint32_t getNumDocs() const { return _numDocs; }
     bool getEnumerated() const { return _enumerated; }
+    bool getDelta() const { return _delta; }
+    void setDelta(bool delta) { _delta = delta; }
     uint64_t getCreateSerialNum() const { return _createSerialNum; }
     uint32_t getVersion() const  { return _version; }
+    void setVersion(uint32_t version) { _version = version; }
     uint64_t get_total_value_count() const { return _totalValueCount; }
     uint64_t get_unique_value_count() const { return _uniqueValueCount; }
     const PersistentPredicateParams &getPredicateParams() const { return _predicateParams; }
     bool getPredicateParamsSet() const { return _predicateParamsSet; }
     bool getCollectionTypeParamsSet() const { return _collectionTypeParamsSet; }
     const std::optional<HnswIndexParams>& get_hnsw_index_params() const { return _hnsw_index_params; }
+    const std::optional<IvfPqIndexParams>& get_ivf_pq_index_params() const { return _ivf_pq_index_params; }
     static AttributeHeader extractTags(const vespalib::GenericHeader &header);
     void addTags(vespalib::GenericHeader &header) const;
 };
@@ -18,11 +18,31 @@ bool matches(const SC & sc, uint32_t doc) {
     return sc.find(doc, 0) >= 0;
 }
 
+/*
+ * Search contexts able to produce all hits in a doc id range at once,
+ * which is faster than testing one doc at a time when the hits are needed
+ * as a bitvector.
+ */
+template <typename SC, typename = void>
+struct has_get_hits : std::false_type {};
+
+template <typename SC>
+struct has_get_hits<SC, std::void_t<decltype(std::declval<const SC &>().get_hits(0u, 0u))>> : std::true_type {};
+
+template <typename SC>
+inline constexpr bool has_get_hits_v = has_get_hits<SC>::value;
+
 }
 
 template <typename SC>
 void
 AttributeIteratorBase::and_hits_into(const SC & sc, BitVector & result, uint32_t begin_id) const {
+    if constexpr (has_get_hits_v<SC>) {
+        if (result.getStartIndex() == begin_id) {
+            result.andWith(*sc.get_hits(begin_id, getEndId()));
+            return;
+        }
+    }
     result.foreach_truebit([&](uint32_t key) { if ( ! matches(sc, key)) { result.clearBit(key); }}, begin_id);
     result.invalidateCachedCount();
 }
@@ -30,6 +50,12 @@ AttributeIteratorBase::and_hits_into(const SC & sc, BitVector & result, uint32_t
 template <typename SC>
 void
 AttributeIteratorBase::or_hits_into(const SC & sc, BitVector & result, uint32_t begin_id) const {
+    if constexpr (has_get_hits_v<SC>) {
+        if (result.getStartIndex() == begin_id) {
+            result.orWith(*sc.get_hits(begin_id, getEndId()));
+            return;
+        }
+    }
     result.foreach_falsebit([&](uint32_t key) { if ( matches(sc, key)) { result.setBit(key); }}, begin_id);
     result.invalidateCachedCount();
 }
@@ -38,6 +64,9 @@ AttributeIteratorBase::or_hits_into(const SC & sc, BitVector & result, uint32_t
 template <typename SC>
 std::unique_ptr<BitVector>
 AttributeIteratorBase::get_hits(const SC & sc, uint32_t begin_id) const {
+    if constexpr (has_get_hits_v<SC>) {
+        return sc.get_hits(begin_id, getEndId());
+    }
     BitVector::UP result = BitVector::create(begin_id, getEndId());
     for (uint32_t docId(std::max(begin_id, getDocId())); docId < getEndId(); docId++) {
         if (matches(sc, docId)) {
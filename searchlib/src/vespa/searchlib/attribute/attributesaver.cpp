@@ -28,9 +28,15 @@ AttributeSaver::save(IAttributeSaveTarget &saveTarget)
         return false;
     }
     saveTarget.close();
+    onSaved(saveTarget);
     return true;
 }
 
+void
+AttributeSaver::onSaved(IAttributeSaveTarget &)
+{
+}
+
 bool
 AttributeSaver::hasGenerationGuard() const
 {
@@ -28,6 +28,11 @@ protected:
 
     virtual bool onSave(IAttributeSaveTarget &saveTarget) = 0;
 
+    /*
+     * Called after a successful save, when the save target is closed.
+     */
+    virtual void onSaved(IAttributeSaveTarget &saveTarget);
+
 public:
     virtual ~AttributeSaver();
 
@@ -316,6 +316,7 @@ AttributeVector::createAttributeHeader(vespalib::stringref fileName) const {
                                       getEnumeratedSave(),
                                       getConfig().predicateParams(),
                                       getConfig().hnsw_index_params(),
+                                      getConfig().ivf_pq_index_params(),
                                       getCommittedDocIdLimit(),
                                       getUniqueValueCount(),
                                       getTotalValueCount(),
@@ -372,8 +373,13 @@ AttributeVector::isEnumeratedSaveFormat() const
 
 bool
 AttributeVector::load() {
+    return load(nullptr);
+}
+
+bool
+AttributeVector::load(vespalib::Executor *executor) {
     assert(!_loaded);
-    bool loaded = onLoad();
+    bool loaded = onLoad(executor);
     if (loaded) {
         commit();
     }
@@ -382,6 +388,7 @@ AttributeVector::load() {
 }
 
 bool AttributeVector::onLoad() { return false; }
+bool AttributeVector::onLoad(vespalib::Executor *) { return onLoad(); }
 int32_t AttributeVector::getWeight(DocId, uint32_t) const { return 1; }
 
 bool AttributeVector::findEnum(const char *, EnumHandle &) const { return false; }
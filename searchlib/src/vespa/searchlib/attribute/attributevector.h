@@ -36,6 +36,7 @@ namespace document {
 }
 
 namespace vespalib {
+    class Executor;
     class GenericHeader;
 }
 
@@ -447,6 +448,12 @@ public:
 
     bool isEnumeratedSaveFormat() const;
     bool load();
+    /**
+     * Loads this attribute vector, using the given executor (if not nullptr)
+     * to parallelize costly parts of the load (e.g. rebuilding of indexes).
+     * The calling thread acts as the attribute write thread.
+     **/
+    bool load(vespalib::Executor *executor);
     void commit(bool forceStatUpdate = false);
     void commit(uint64_t firstSyncToken, uint64_t lastSyncToken);
     void setCreateSerialNum(uint64_t createSerialNum);
@@ -570,6 +577,7 @@ private:
     virtual bool applyWeight(DocId doc, const FieldValue& fv, const document::AssignValueUpdate& wAdjust);
     virtual void onSave(IAttributeSaveTarget & saveTarget);
     virtual bool onLoad();
+    virtual bool onLoad(vespalib::Executor *executor);
 
 
     BaseName                              _baseFileName;
@@ -68,6 +68,9 @@ ConfigConverter::convert(const AttributesConfig::Attribute & cfg)
     retval.setEnableOnlyBitVector(cfg.enableonlybitvector);
     retval.setIsFilter(cfg.enableonlybitvector);
     retval.setFastAccess(cfg.fastaccess);
+    retval.setPaged(cfg.paged);
+    retval.setPacked(cfg.packed);
+    retval.setMaxDeltaRatio(cfg.maxdeltaratio);
     retval.setMutable(cfg.ismutable);
     predicateParams.setArity(cfg.arity);
     predicateParams.setBounds(cfg.lowerbound, cfg.upperbound);
@@ -94,10 +97,13 @@ ConfigConverter::convert(const AttributesConfig::Attribute & cfg)
         retval.set_hnsw_index_params(HnswIndexParams(cfg.index.hnsw.maxlinkspernode,
                                                      cfg.index.hnsw.neighborstoexploreatinsert,
                                                      dm, cfg.index.hnsw.multithreadedindexing));
+    } else if (cfg.index.ivfpq.enabled) {
+        retval.set_ivf_pq_index_params(IvfPqIndexParams(cfg.index.ivfpq.numcentroids,
+                                                        cfg.index.ivfpq.numsubquantizers, dm));
     }
     if (retval.basicType().type() == BasicType::Type::TENSOR) {
         if (!cfg.tensortype.empty()) {
-            retval.setTensorType(ValueType::from_spec(cfg.tensortype));
+            retval.setTensorType(ValueType::from_storage_spec(cfg.tensortype));
         } else {
             retval.setTensorType(ValueType::tensor_type({}));
         }
@@ -1,7 +1,9 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "attributefactory.h"
+#include "paged_single_numeric_attribute.h"
 #include "predicate_attribute.h"
+#include "single_packed_numeric_attribute.h"
 #include "singlesmallnumericattribute.h"
 #include "reference_attribute.h"
 #include "singlenumericattribute.hpp"
@@ -26,13 +28,33 @@ AttributeFactory::createSingleStd(stringref name, const Config & info)
     case BasicType::UINT4:
         return std::make_shared<SingleValueNibbleNumericAttribute>(name, info.getGrowStrategy());
     case BasicType::INT8:
+        if (info.paged()) {
+            return std::make_shared<PagedSingleValueNumericAttribute<IntegerAttributeTemplate<int8_t>>>(name, info);
+        } else if (info.packed()) {
+            return std::make_shared<SingleValuePackedNumericAttribute<IntegerAttributeTemplate<int8_t>>>(name, info);
+        }
         return std::make_shared<SingleValueNumericAttribute<IntegerAttributeTemplate<int8_t>>>(name, info);
     case BasicType::INT16:
         // XXX: Unneeded since we don't have short document fields in java.
+        if (info.paged()) {
+            return std::make_shared<PagedSingleValueNumericAttribute<IntegerAttributeTemplate<int16_t>>>(name, info);
+        } else if (info.packed()) {
+            return std::make_shared<SingleValuePackedNumericAttribute<IntegerAttributeTemplate<int16_t>>>(name, info);
+        }
         return std::make_shared<SingleValueNumericAttribute<IntegerAttributeTemplate<int16_t>>>(name, info);
     case BasicType::INT32:
+        if (info.paged()) {
+            return std::make_shared<PagedSingleValueNumericAttribute<IntegerAttributeTemplate<int32_t>>>(name, info);
+        } else if (info.packed()) {
+            return std::make_shared<SingleValuePackedNumericAttribute<IntegerAttributeTemplate<int32_t>>>(name, info);
+        }
         return std::make_shared<SingleValueNumericAttribute<IntegerAttributeTemplate<int32_t>>>(name, info);
     case BasicType::INT64:
+        if (info.paged()) {
+            return std::make_shared<PagedSingleValueNumericAttribute<IntegerAttributeTemplate<int64_t>>>(name, info);
+        } else if (info.packed()) {
+            return std::make_shared<SingleValuePackedNumericAttribute<IntegerAttributeTemplate<int64_t>>>(name, info);
+        }
         return std::make_shared<SingleValueNumericAttribute<IntegerAttributeTemplate<int64_t>>>(name, info);
     case BasicType::FLOAT:
         return std::make_shared<SingleValueNumericAttribute<FloatingPointAttributeTemplate<float>>>(name, info);
@@ -38,6 +38,10 @@ public:
         return _children[ref].getData();
     }
 
+    bool has_block_max_weights() const { return false; }
+
+    bool get_block_max_weight(uint16_t, uint32_t, int32_t &, uint32_t &) { return false; }
+
     std::unique_ptr<BitVector> get_hits(uint32_t begin_id, uint32_t end_id);
     void or_hits_into(BitVector &result, uint32_t begin_id);
 
@@ -0,0 +1,40 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "numeric_range_hits.h"
+#include <vespa/searchlib/common/bitvector.h>
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
+
+namespace search::attribute {
+
+template <typename T>
+std::unique_ptr<BitVector>
+getNumericRangeHits(const T *values, T low, T high, uint32_t beginId, uint32_t endId)
+{
+    BitVector::UP result = BitVector::create(beginId, endId);
+    uint64_t *words = static_cast<uint64_t *>(result->getStart());
+    uint32_t firstBlockId = beginId & ~uint32_t(BitWord::WordLen - 1);
+    uint32_t endBlockId = endId & ~uint32_t(BitWord::WordLen - 1);
+    uint32_t docId = beginId;
+    if (firstBlockId < endBlockId) {
+        vespalib::hwaccelrated::IAccelrated::getAccelerator().rangeBits(values + firstBlockId, endBlockId - firstBlockId,
+                                                                        low, high, words + BitWord::wordNum(firstBlockId));
+        words[BitWord::wordNum(beginId)] &= ~BitWord::startBits(beginId);
+        docId = endBlockId;
+    }
+    for (; docId < endId; ++docId) {
+        if ((low <= values[docId]) && (values[docId] <= high)) {
+            result->setBit(docId);
+        }
+    }
+    result->invalidateCachedCount();
+    return result;
+}
+
+template std::unique_ptr<BitVector> getNumericRangeHits(const int8_t *, int8_t, int8_t, uint32_t, uint32_t);
+template std::unique_ptr<BitVector> getNumericRangeHits(const int16_t *, int16_t, int16_t, uint32_t, uint32_t);
+template std::unique_ptr<BitVector> getNumericRangeHits(const int32_t *, int32_t, int32_t, uint32_t, uint32_t);
+template std::unique_ptr<BitVector> getNumericRangeHits(const int64_t *, int64_t, int64_t, uint32_t, uint32_t);
+template std::unique_ptr<BitVector> getNumericRangeHits(const float *, float, float, uint32_t, uint32_t);
+template std::unique_ptr<BitVector> getNumericRangeHits(const double *, double, double, uint32_t, uint32_t);
+
+}
@@ -0,0 +1,22 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace search { class BitVector; }
+
+namespace search::attribute {
+
+/**
+ * Returns the docs in [beginId, endId) having a value in [low, high], given
+ * a plain array of values indexed by doc id. Values are compared 64 at a
+ * time using the accelerated range kernel, producing a full bitvector word
+ * per block instead of testing one doc at a time.
+ */
+template <typename T>
+std::unique_ptr<BitVector>
+getNumericRangeHits(const T *values, T low, T high, uint32_t beginId, uint32_t endId);
+
+}
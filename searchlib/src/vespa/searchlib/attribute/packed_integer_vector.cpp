@@ -0,0 +1,167 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "packed_integer_vector.h"
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+namespace search::attribute {
+
+namespace {
+
+uint32_t
+log2(uint32_t value)
+{
+    return 31 - __builtin_clz(value);
+}
+
+/*
+ * Narrowest power of two width with room for numValues defined values
+ * in addition to the undefined value.
+ */
+uint32_t
+bitsFor(uint64_t numValues)
+{
+    for (uint32_t bits = 1; bits < 64; bits <<= 1) {
+        if (((uint64_t(1) << bits) - 1) >= numValues) {
+            return bits;
+        }
+    }
+    return 64;
+}
+
+}
+
+PackedIntegerVector::PackedIntegerVector(const ValueType &valueType, const Layout &layout, uint32_t capacity)
+    : _valueType(valueType),
+      _layout(layout),
+      _capacity(0),
+      _laneShift(log2(64 / layout.bits)),
+      _laneMask((64 / layout.bits) - 1),
+      _bitShift(log2(layout.bits)),
+      _codeMask((layout.bits == 64) ? std::numeric_limits<uint64_t>::max() : ((uint64_t(1) << layout.bits) - 1)),
+      _words(),
+      _data(nullptr)
+{
+    assert(layout.bits == (1u << _bitShift));
+    size_t numWords = (uint64_t(capacity) + _laneMask) >> _laneShift;
+    _words = vespalib::alloc::Alloc::alloc(numWords * sizeof(uint64_t));
+    _data = static_cast<uint64_t *>(_words.get());
+    memset(_data, 0, numWords * sizeof(uint64_t));
+    _capacity = numWords << _laneShift;
+}
+
+PackedIntegerVector::~PackedIntegerVector() = default;
+
+PackedIntegerVector::Layout
+PackedIntegerVector::chooseLayout(const ValueType &valueType, int64_t minValue, int64_t maxValue, bool headroom)
+{
+    assert(minValue <= maxValue);
+    uint32_t fullBits = bitsFor(uint64_t(valueType.maxValue) - uint64_t(valueType.minValue) + 1);
+    uint64_t span = uint64_t(maxValue) - uint64_t(minValue) + 1;
+    uint64_t wanted = span;
+    if (headroom) {
+        wanted = (span > std::numeric_limits<uint64_t>::max() / 2) ? std::numeric_limits<uint64_t>::max() : 2 * span;
+    }
+    uint32_t bits = bitsFor(wanted);
+    if (bits >= fullBits) {
+        return Layout(valueType.minValue, fullBits);
+    }
+    uint64_t numCodes = (uint64_t(1) << bits) - 1;
+    uint64_t slack = headroom ? (numCodes - span) / 2 : 0;
+    int64_t base = (uint64_t(minValue) - uint64_t(valueType.minValue) > slack)
+                   ? int64_t(uint64_t(minValue) - slack)
+                   : valueType.minValue;
+    if (uint64_t(valueType.maxValue) - uint64_t(base) < numCodes - 1) {
+        base = int64_t(uint64_t(valueType.maxValue) - (numCodes - 1));
+    }
+    return Layout(base, bits);
+}
+
+void
+PackedIntegerVector::copyTo(PackedIntegerVector &dst, uint32_t numDocs) const
+{
+    assert(numDocs <= _capacity && numDocs <= dst._capacity);
+    if (dst._layout == _layout) {
+        size_t numWords = (uint64_t(numDocs) + _laneMask) >> _laneShift;
+        memcpy(dst._data, _data, numWords * sizeof(uint64_t));
+        return;
+    }
+    for (uint32_t doc = 0; doc < numDocs; ++doc) {
+        dst.set(doc, get(doc));
+    }
+}
+
+bool
+PackedIntegerVector::getCodeRange(int64_t low, int64_t high, uint64_t &lowCode, uint64_t &highCode) const
+{
+    if (low > high || high < _valueType.undefined) {
+        return false;
+    }
+    uint64_t maxCode = _codeMask;
+    if (low <= _valueType.undefined) {
+        lowCode = 0;
+    } else if (low <= _layout.base) {
+        lowCode = 1;
+    } else {
+        uint64_t offset = uint64_t(low) - uint64_t(_layout.base);
+        if (offset >= maxCode) {
+            return false;
+        }
+        lowCode = offset + 1;
+    }
+    if (high < _layout.base) {
+        highCode = 0;
+    } else {
+        uint64_t offset = uint64_t(high) - uint64_t(_layout.base);
+        highCode = (offset >= maxCode) ? maxCode : (offset + 1);
+    }
+    return lowCode <= highCode;
+}
+
+template <uint32_t BITS>
+uint32_t
+PackedIntegerVector::findNextMatchImpl(uint32_t docId, uint32_t endId, uint64_t lowCode, uint64_t codeSpan) const
+{
+    constexpr uint32_t LANES = 64 / BITS;
+    constexpr uint64_t MASK = (BITS == 64) ? std::numeric_limits<uint64_t>::max() : ((uint64_t(1) << BITS) - 1);
+    for (; docId < endId && (docId % LANES) != 0; ++docId) {
+        if (getCode(docId) - lowCode <= codeSpan) {
+            return docId;
+        }
+    }
+    for (; docId + LANES <= endId; docId += LANES) {
+        uint64_t word = _data[docId / LANES];
+        uint64_t hits = 0;
+        for (uint32_t lane = 0; lane < LANES; ++lane) {
+            uint64_t code = (word >> (lane * BITS)) & MASK;
+            hits |= uint64_t((code - lowCode) <= codeSpan) << lane;
+        }
+        if (hits != 0) {
+            return docId + __builtin_ctzll(hits);
+        }
+    }
+    for (; docId < endId; ++docId) {
+        if (getCode(docId) - lowCode <= codeSpan) {
+            return docId;
+        }
+    }
+    return endId;
+}
+
+uint32_t
+PackedIntegerVector::findNextMatch(uint32_t docId, uint32_t endId, uint64_t lowCode, uint64_t highCode) const
+{
+    uint64_t codeSpan = highCode - lowCode;
+    switch (_layout.bits) {
+    case 1: return findNextMatchImpl<1>(docId, endId, lowCode, codeSpan);
+    case 2: return findNextMatchImpl<2>(docId, endId, lowCode, codeSpan);
+    case 4: return findNextMatchImpl<4>(docId, endId, lowCode, codeSpan);
+    case 8: return findNextMatchImpl<8>(docId, endId, lowCode, codeSpan);
+    case 16: return findNextMatchImpl<16>(docId, endId, lowCode, codeSpan);
+    case 32: return findNextMatchImpl<32>(docId, endId, lowCode, codeSpan);
+    default: return findNextMatchImpl<64>(docId, endId, lowCode, codeSpan);
+    }
+}
+
+}
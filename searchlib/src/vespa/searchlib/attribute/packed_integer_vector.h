@@ -0,0 +1,111 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/util/alloc.h>
+#include <cstdint>
+
+namespace search::attribute {
+
+/**
+ * Fixed capacity vector of integer values bit packed into 64-bit words,
+ * using a power of two width so a value never spans two words.
+ *
+ * Code 0 is the undefined value and code c > 0 is the value base + c - 1,
+ * so codes are ordered like the values they represent and a value range
+ * maps to a single code range.
+ */
+class PackedIntegerVector {
+public:
+    /**
+     * Base and bit width used to pack values.
+     */
+    struct Layout {
+        int64_t  base;
+        uint32_t bits;
+        Layout(int64_t base_in, uint32_t bits_in) : base(base_in), bits(bits_in) { }
+        bool operator==(const Layout &rhs) const { return base == rhs.base && bits == rhs.bits; }
+    };
+
+    /**
+     * Defined values that can be stored, [minValue, maxValue], and the
+     * undefined value, which must be below minValue.
+     */
+    struct ValueType {
+        int64_t minValue;
+        int64_t maxValue;
+        int64_t undefined;
+        ValueType(int64_t minValue_in, int64_t maxValue_in, int64_t undefined_in)
+            : minValue(minValue_in), maxValue(maxValue_in), undefined(undefined_in)
+        { }
+    };
+
+    PackedIntegerVector(const ValueType &valueType, const Layout &layout, uint32_t capacity);
+    ~PackedIntegerVector();
+
+    /**
+     * Selects the narrowest layout holding the defined values in
+     * [minValue, maxValue]. With headroom the layout has room for at least
+     * as many values again, split around the given range, so that values
+     * drifting outside it do not cause a new layout for each update.
+     */
+    static Layout chooseLayout(const ValueType &valueType, int64_t minValue, int64_t maxValue, bool headroom);
+
+    const Layout &getLayout() const { return _layout; }
+    int64_t getMaxValue() const { return int64_t(uint64_t(_layout.base) + _codeMask - 1); }
+    uint32_t getCapacity() const { return _capacity; }
+    size_t getAllocatedBytes() const { return _words.size(); }
+
+    uint64_t getCode(uint32_t doc) const {
+        return (_data[doc >> _laneShift] >> ((doc & _laneMask) << _bitShift)) & _codeMask;
+    }
+    int64_t get(uint32_t doc) const {
+        uint64_t code = getCode(doc);
+        return (code == 0) ? _valueType.undefined : int64_t(uint64_t(_layout.base) + code - 1);
+    }
+    bool fits(int64_t value) const {
+        return (value == _valueType.undefined) ||
+            ((value >= _layout.base) && (uint64_t(value) - uint64_t(_layout.base) < _codeMask));
+    }
+    void set(uint32_t doc, int64_t value) {
+        uint64_t code = (value == _valueType.undefined) ? 0 : (uint64_t(value) - uint64_t(_layout.base) + 1);
+        uint64_t &word = _data[doc >> _laneShift];
+        uint32_t shift = (doc & _laneMask) << _bitShift;
+        word = (word & ~(_codeMask << shift)) | (code << shift);
+    }
+
+    /**
+     * Copies the first numDocs values to another vector, which must be able to hold them.
+     */
+    void copyTo(PackedIntegerVector &dst, uint32_t numDocs) const;
+
+    /**
+     * Maps the value range [low, high] to the codes representing it.
+     * Returns false if no stored value can be in the range.
+     */
+    bool getCodeRange(int64_t low, int64_t high, uint64_t &lowCode, uint64_t &highCode) const;
+
+    /**
+     * Returns the first doc in [docId, endId) with a code in
+     * [lowCode, highCode], or endId if there is none. Whole words are
+     * unpacked at a time with a fixed lane count, which the compiler can
+     * vectorize.
+     */
+    uint32_t findNextMatch(uint32_t docId, uint32_t endId, uint64_t lowCode, uint64_t highCode) const;
+
+private:
+    template <uint32_t BITS>
+    uint32_t findNextMatchImpl(uint32_t docId, uint32_t endId, uint64_t lowCode, uint64_t codeSpan) const;
+
+    ValueType             _valueType;
+    Layout                _layout;
+    uint32_t              _capacity;
+    uint32_t              _laneShift;
+    uint32_t              _laneMask;
+    uint32_t              _bitShift;
+    uint64_t              _codeMask;
+    vespalib::alloc::Alloc _words;
+    uint64_t            * _data;
+};
+
+}
@@ -0,0 +1,94 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "paged_integer_block.h"
+#include <algorithm>
+#include <cassert>
+
+namespace search::attribute {
+
+namespace {
+
+uint8_t
+bitsNeeded(uint64_t maxCode)
+{
+    return (maxCode == 0) ? 0 : (64 - __builtin_clzll(maxCode));
+}
+
+}
+
+PagedIntegerBlock::Entry
+PagedIntegerBlock::encode(const int64_t *values, uint32_t count, int64_t undefined, std::vector<uint64_t> &words)
+{
+    assert(count <= BLOCK_SIZE);
+    bool hasDefined = false;
+    bool hasUndefined = false;
+    int64_t minValue = 0;
+    int64_t maxValue = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        int64_t value = values[i];
+        if (value == undefined) {
+            hasUndefined = true;
+        } else if (!hasDefined) {
+            minValue = maxValue = value;
+            hasDefined = true;
+        } else {
+            minValue = std::min(minValue, value);
+            maxValue = std::max(maxValue, value);
+        }
+    }
+    Entry entry;
+    entry.offset = words.size();
+    entry.base = minValue;
+    entry.hasUndefined = hasUndefined ? 1 : 0;
+    uint64_t codeBias = hasUndefined ? 1 : 0;
+    uint64_t maxCode = hasDefined ? (uint64_t(maxValue) - uint64_t(minValue) + codeBias) : 0;
+    entry.bits = bitsNeeded(maxCode);
+    entry.numWords = (uint64_t(count) * entry.bits + 63) / 64;
+    if (entry.bits == 0) {
+        return entry;
+    }
+    words.resize(entry.offset + entry.numWords, 0);
+    uint64_t *dst = &words[entry.offset];
+    uint64_t bitPos = 0;
+    for (uint32_t i = 0; i < count; ++i, bitPos += entry.bits) {
+        uint64_t code = (values[i] == undefined) ? 0 : (uint64_t(values[i]) - uint64_t(minValue) + codeBias);
+        uint32_t word = bitPos >> 6;
+        uint32_t shift = bitPos & 63;
+        dst[word] |= code << shift;
+        if (shift + entry.bits > 64) {
+            dst[word + 1] |= code >> (64 - shift);
+        }
+    }
+    return entry;
+}
+
+void
+PagedIntegerBlock::decode(const Entry &entry, const uint64_t *words, uint32_t count, int64_t undefined, int64_t *values)
+{
+    uint64_t codeBias = entry.hasUndefined ? 1 : 0;
+    if (entry.bits == 0) {
+        int64_t value = entry.hasUndefined ? undefined : entry.base;
+        for (uint32_t i = 0; i < count; ++i) {
+            values[i] = value;
+        }
+        return;
+    }
+    uint64_t mask = (entry.bits == 64) ? ~uint64_t(0) : ((uint64_t(1) << entry.bits) - 1);
+    uint64_t bitPos = 0;
+    for (uint32_t i = 0; i < count; ++i, bitPos += entry.bits) {
+        uint32_t word = bitPos >> 6;
+        uint32_t shift = bitPos & 63;
+        uint64_t code = words[word] >> shift;
+        if (shift + entry.bits > 64) {
+            code |= words[word + 1] << (64 - shift);
+        }
+        code &= mask;
+        if (entry.hasUndefined && code == 0) {
+            values[i] = undefined;
+        } else {
+            values[i] = int64_t(uint64_t(entry.base) + code - codeBias);
+        }
+    }
+}
+
+}
@@ -0,0 +1,54 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace search::attribute {
+
+/**
+ * Compressed representation of a block of integer values, used by paged
+ * single value integer attributes.
+ *
+ * The values in a block are stored as offsets from the smallest value in
+ * the block (frame of reference), bit packed into 64-bit words using as few
+ * bits as needed for the largest offset. Undefined values are kept out of
+ * the frame of reference and get code 0 when present in the block.
+ */
+class PagedIntegerBlock {
+public:
+    static constexpr uint32_t BLOCK_BITS = 10;
+    static constexpr uint32_t BLOCK_SIZE = 1u << BLOCK_BITS;
+    static constexpr uint32_t BLOCK_MASK = BLOCK_SIZE - 1;
+
+    /**
+     * Describes where and how a block is packed. Stored as is in the
+     * block directory of the data file.
+     */
+    struct Entry {
+        uint64_t offset;       // First word of the block, relative to the start of the packed words
+        int64_t  base;
+        uint32_t numWords;
+        uint8_t  bits;
+        uint8_t  hasUndefined;
+        uint16_t padding;
+
+        Entry() : offset(0), base(0), numWords(0), bits(0), hasUndefined(0), padding(0) { }
+    };
+    static_assert(sizeof(Entry) == 24, "Entry is part of the file format");
+
+    static uint32_t numBlocks(uint32_t numDocs) { return (numDocs + BLOCK_MASK) >> BLOCK_BITS; }
+
+    /**
+     * Packs count values and appends the packed words to words.
+     */
+    static Entry encode(const int64_t *values, uint32_t count, int64_t undefined, std::vector<uint64_t> &words);
+
+    /**
+     * Unpacks count values from the packed words of a single block.
+     */
+    static void decode(const Entry &entry, const uint64_t *words, uint32_t count, int64_t undefined, int64_t *values);
+};
+
+}
@@ -0,0 +1,119 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "paged_integer_block_file.h"
+#include <vespa/fastos/file.h>
+#include <vespa/searchlib/util/bufferwriter.h>
+#include <vespa/vespalib/data/fileheader.h>
+#include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/stringfmt.h>
+
+using vespalib::IllegalStateException;
+using vespalib::make_string;
+
+namespace search::attribute {
+
+namespace {
+
+struct Prefix {
+    uint32_t blockSize;
+    uint32_t numDocs;
+    uint32_t numBlocks;
+    uint32_t reserved;
+};
+
+}
+
+PagedIntegerBlockFile::PagedIntegerBlockFile(std::unique_ptr<FastOS_FileInterface> file, uint64_t wordsOffset,
+                                             uint32_t numDocs, std::vector<Entry> entries)
+    : _file(std::move(file)),
+      _wordsOffset(wordsOffset),
+      _numDocs(numDocs),
+      _entries(std::move(entries))
+{
+}
+
+PagedIntegerBlockFile::~PagedIntegerBlockFile() = default;
+
+std::unique_ptr<PagedIntegerBlockFile>
+PagedIntegerBlockFile::open(const vespalib::string &fileName)
+{
+    auto file = std::make_unique<FastOS_File>(fileName.c_str());
+    if (!file->OpenReadOnly()) {
+        throw IllegalStateException(make_string("Failed opening '%s' for reading paged attribute blocks.",
+                                                fileName.c_str()));
+    }
+    vespalib::FileHeader header;
+    uint64_t headerLen = header.readFile(*file);
+    uint64_t fileSize = file->GetSize();
+    Prefix prefix;
+    if (fileSize < headerLen + sizeof(prefix)) {
+        throw IllegalStateException(make_string("Paged attribute file '%s' is truncated.", fileName.c_str()));
+    }
+    file->ReadBuf(&prefix, sizeof(prefix), headerLen);
+    if (prefix.blockSize != PagedIntegerBlock::BLOCK_SIZE ||
+        prefix.numBlocks != PagedIntegerBlock::numBlocks(prefix.numDocs))
+    {
+        throw IllegalStateException(make_string("Paged attribute file '%s' has unexpected block size %u or block count %u for %u docs.",
+                                                fileName.c_str(), prefix.blockSize, prefix.numBlocks, prefix.numDocs));
+    }
+    uint64_t wordsOffset = headerLen + sizeof(prefix) + uint64_t(prefix.numBlocks) * sizeof(Entry);
+    if (fileSize < wordsOffset) {
+        throw IllegalStateException(make_string("Paged attribute file '%s' is truncated.", fileName.c_str()));
+    }
+    std::vector<Entry> entries(prefix.numBlocks);
+    if (!entries.empty()) {
+        file->ReadBuf(&entries[0], entries.size() * sizeof(Entry), headerLen + sizeof(prefix));
+    }
+    for (const auto &entry : entries) {
+        if (wordsOffset + (entry.offset + entry.numWords) * sizeof(uint64_t) > fileSize || entry.bits > 64) {
+            throw IllegalStateException(make_string("Paged attribute file '%s' has a corrupt block directory.",
+                                                    fileName.c_str()));
+        }
+    }
+    return std::make_unique<PagedIntegerBlockFile>(std::move(file), wordsOffset, prefix.numDocs, std::move(entries));
+}
+
+void
+PagedIntegerBlockFile::write(BufferWriter &writer, uint32_t numDocs,
+                             const std::vector<Entry> &entries, const std::vector<uint64_t> &words)
+{
+    Prefix prefix;
+    prefix.blockSize = PagedIntegerBlock::BLOCK_SIZE;
+    prefix.numDocs = numDocs;
+    prefix.numBlocks = entries.size();
+    prefix.reserved = 0;
+    writer.write(&prefix, sizeof(prefix));
+    if (!entries.empty()) {
+        writer.write(&entries[0], entries.size() * sizeof(Entry));
+    }
+    if (!words.empty()) {
+        writer.write(&words[0], words.size() * sizeof(uint64_t));
+    }
+}
+
+vespalib::string
+PagedIntegerBlockFile::getFileName() const
+{
+    return _file->GetFileName();
+}
+
+void
+PagedIntegerBlockFile::readWords(uint32_t blockId, std::vector<uint64_t> &words) const
+{
+    const Entry &entry = _entries[blockId];
+    words.resize(entry.numWords);
+    if (entry.numWords > 0) {
+        _file->ReadBuf(&words[0], entry.numWords * sizeof(uint64_t),
+                       _wordsOffset + entry.offset * sizeof(uint64_t));
+    }
+}
+
+void
+PagedIntegerBlockFile::readBlock(uint32_t blockId, int64_t undefined, int64_t *values) const
+{
+    std::vector<uint64_t> words;
+    readWords(blockId, words);
+    PagedIntegerBlock::decode(_entries[blockId], words.data(), getBlockDocs(blockId), undefined, values);
+}
+
+}
@@ -0,0 +1,74 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "paged_integer_block.h"
+#include <vespa/vespalib/stllike/string.h>
+#include <algorithm>
+#include <memory>
+
+class FastOS_FileInterface;
+
+namespace search { class BufferWriter; }
+
+namespace search::attribute {
+
+/**
+ * Read access to the packed blocks in the data file of a saved paged
+ * integer attribute. The file is kept open, so blocks can still be read
+ * on demand after the attribute snapshot directory has been removed.
+ *
+ * Layout after the generic file header: block size, doc count, block
+ * count and a reserved word (all uint32_t), then the block directory
+ * and finally the packed words of all blocks.
+ */
+class PagedIntegerBlockFile {
+public:
+    using Entry = PagedIntegerBlock::Entry;
+
+    /**
+     * Attribute header version used for data files in this format.
+     */
+    static constexpr uint32_t VERSION = 1;
+
+    PagedIntegerBlockFile(std::unique_ptr<FastOS_FileInterface> file, uint64_t wordsOffset,
+                          uint32_t numDocs, std::vector<Entry> entries);
+    ~PagedIntegerBlockFile();
+
+    /**
+     * Opens the given data file and reads the block directory.
+     * Throws IllegalStateException if the file is not a valid paged data file.
+     */
+    static std::unique_ptr<PagedIntegerBlockFile> open(const vespalib::string &fileName);
+
+    static void write(BufferWriter &writer, uint32_t numDocs,
+                      const std::vector<Entry> &entries, const std::vector<uint64_t> &words);
+
+    uint32_t getNumDocs() const { return _numDocs; }
+    uint32_t getNumBlocks() const { return _entries.size(); }
+    uint32_t getBlockDocs(uint32_t blockId) const {
+        uint32_t start = blockId << PagedIntegerBlock::BLOCK_BITS;
+        return std::min(PagedIntegerBlock::BLOCK_SIZE, _numDocs - start);
+    }
+    const Entry &getEntry(uint32_t blockId) const { return _entries[blockId]; }
+    vespalib::string getFileName() const;
+    size_t getDirectorySize() const { return _entries.size() * sizeof(Entry); }
+
+    /**
+     * Reads the packed words of a block. Safe to call from multiple threads.
+     */
+    void readWords(uint32_t blockId, std::vector<uint64_t> &words) const;
+
+    /**
+     * Reads and unpacks the getBlockDocs(blockId) values of a block.
+     */
+    void readBlock(uint32_t blockId, int64_t undefined, int64_t *values) const;
+
+private:
+    std::unique_ptr<FastOS_FileInterface> _file;
+    uint64_t                              _wordsOffset;
+    uint32_t                              _numDocs;
+    std::vector<Entry>                    _entries;
+};
+
+}
@@ -0,0 +1,544 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "paged_single_numeric_attribute.h"
+#include "attributeiterators.hpp"
+#include "attributevector.hpp"
+#include "load_utils.h"
+#include "paged_integer_block_file.h"
+#include "paged_single_numeric_attribute_saver.h"
+#include "primitivereader.h"
+#include <vespa/searchlib/query/query_term_simple.h>
+#include <vespa/searchlib/queryeval/emptysearch.h>
+#include <vespa/vespalib/stllike/lrucache_map.hpp>
+#include <vespa/vespalib/util/rcuvector.hpp>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".searchlib.attribute.paged_single_numeric_attribute");
+
+namespace search {
+
+using attribute::PagedIntegerBlockFile;
+
+namespace {
+
+/*
+ * Holds a dropped resident block until readers no longer access it.
+ */
+template <typename T>
+class HeldBlock : public vespalib::GenerationHeldBase {
+    std::unique_ptr<T[]> _block;
+public:
+    HeldBlock(std::unique_ptr<T[]> block, size_t size)
+        : vespalib::GenerationHeldBase(size),
+          _block(std::move(block))
+    { }
+    ~HeldBlock() override;
+};
+
+template <typename T>
+HeldBlock<T>::~HeldBlock() = default;
+
+}
+
+template <typename B>
+PagedSingleValueNumericAttribute<B>::
+PagedSingleValueNumericAttribute(const vespalib::string & baseFileName, const AttributeVector::Config & c) :
+    B(baseFileName, c),
+    _blockFile(),
+    _dirtyBlocks(Block::numBlocks(c.getGrowStrategy().getDocsInitialCapacity()),
+                 c.getGrowStrategy().getDocsGrowPercent(),
+                 Block::numBlocks(c.getGrowStrategy().getDocsGrowDelta()),
+                 getGenerationHolder()),
+    _dirtyStorage(),
+    _changedSinceSave(),
+    _saveId(0),
+    _pendingBlockFile(std::make_shared<PendingBlockFile>()),
+    _cacheLock(),
+    _cache(BLOCK_CACHE_SIZE),
+    _loadingBlocks(),
+    _cacheHits(0),
+    _cacheMisses(0)
+{ }
+
+template <typename B>
+PagedSingleValueNumericAttribute<B>::~PagedSingleValueNumericAttribute()
+{
+    getGenerationHolder().clearHoldLists();
+}
+
+template <typename B>
+typename PagedSingleValueNumericAttribute<B>::CleanBlockSP
+PagedSingleValueNumericAttribute<B>::getCleanBlock(uint32_t blockId) const
+{
+    std::shared_ptr<const BlockFile> blockFile;
+    std::promise<CleanBlockSP> promise;
+    {
+        std::unique_lock<std::mutex> guard(_cacheLock);
+        CleanBlockSP *cached = _cache.findAndRef(blockId);
+        if (cached != nullptr) {
+            ++_cacheHits;
+            return *cached;
+        }
+        blockFile = _blockFile;
+        auto itr = _loadingBlocks.find(blockId);
+        if (itr != _loadingBlocks.end() && itr->second.blockFile == blockFile) {
+            // Another thread is decoding this block, wait for it instead of decoding it again.
+            ++_cacheHits;
+            std::shared_future<CleanBlockSP> loading = itr->second.block;
+            guard.unlock();
+            return loading.get();
+        }
+        ++_cacheMisses;
+        _loadingBlocks[blockId] = LoadingBlock{blockFile, promise.get_future().share()};
+    }
+    auto finishLoading = [&]() {
+        auto itr = _loadingBlocks.find(blockId);
+        if (itr != _loadingBlocks.end() && itr->second.blockFile == blockFile) {
+            _loadingBlocks.erase(itr);
+        }
+    };
+    CleanBlockSP block;
+    try {
+        std::vector<int64_t> values(Block::BLOCK_SIZE, attribute::getUndefined<T>());
+        blockFile->readBlock(blockId, attribute::getUndefined<T>(), &values[0]);
+        block = std::make_shared<CleanBlock>(values.begin(), values.end());
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> guard(_cacheLock);
+            finishLoading();
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+    {
+        std::lock_guard<std::mutex> guard(_cacheLock);
+        if (_blockFile == blockFile) {
+            _cache.insert(blockId, block);
+        }
+        finishLoading();
+    }
+    promise.set_value(block);
+    return block;
+}
+
+template <typename B>
+const typename PagedSingleValueNumericAttribute<B>::T *
+PagedSingleValueNumericAttribute<B>::acquireBlock(uint32_t blockId, CleanBlockSP &holder) const
+{
+    const T *block = _dirtyBlocks[blockId];
+    if (block != nullptr) {
+        holder.reset();
+        return block;
+    }
+    holder = getCleanBlock(blockId);
+    return &(*holder)[0];
+}
+
+template <typename B>
+typename PagedSingleValueNumericAttribute<B>::T *
+PagedSingleValueNumericAttribute<B>::getWritableBlock(uint32_t blockId)
+{
+    T *block = _dirtyBlocks[blockId];
+    if (block != nullptr) {
+        return block;
+    }
+    auto storage = std::make_unique<T[]>(Block::BLOCK_SIZE);
+    if (_blockFile && blockId < _blockFile->getNumBlocks()) {
+        CleanBlockSP clean = getCleanBlock(blockId);
+        std::copy(clean->begin(), clean->end(), storage.get());
+    } else {
+        std::fill(storage.get(), storage.get() + Block::BLOCK_SIZE, attribute::getUndefined<T>());
+    }
+    block = storage.get();
+    if (_dirtyStorage.size() <= blockId) {
+        _dirtyStorage.resize(blockId + 1);
+    }
+    _dirtyStorage[blockId] = std::move(storage);
+    std::atomic_thread_fence(std::memory_order_release);
+    _dirtyBlocks[blockId] = block;
+    return block;
+}
+
+template <typename B>
+bool
+PagedSingleValueNumericAttribute<B>::ensureBlocks(uint32_t numBlocks)
+{
+    bool incGen = false;
+    while (_dirtyBlocks.size() < numBlocks) {
+        incGen |= _dirtyBlocks.isFull();
+        _dirtyBlocks.push_back(nullptr);
+    }
+    if (_changedSinceSave.size() < numBlocks) {
+        _changedSinceSave.resize(numBlocks, false);
+    }
+    if (incGen) {
+        this->incGeneration();
+    }
+    return incGen;
+}
+
+template <typename B>
+void
+PagedSingleValueNumericAttribute<B>::resetBlocks()
+{
+    getGenerationHolder().clearHoldLists();
+    _dirtyBlocks.reset();
+    _dirtyStorage.clear();
+    _changedSinceSave.clear();
+    ++_saveId;  // Data file of an ongoing save no longer matches the resident blocks
+    BlockCache emptyCache(BLOCK_CACHE_SIZE);
+    std::lock_guard<std::mutex> guard(_cacheLock);
+    _blockFile.reset();
+    _cache.swap(emptyCache);
+    _loadingBlocks.clear();
+}
+
+template <typename B>
+void
+PagedSingleValueNumericAttribute<B>::applyPendingBlockFile()
+{
+    std::shared_ptr<const BlockFile> blockFile;
+    {
+        std::lock_guard<std::mutex> guard(_pendingBlockFile->lock);
+        if (!_pendingBlockFile->blockFile) {
+            return;
+        }
+        if (_pendingBlockFile->saveId == _saveId) {
+            blockFile = std::move(_pendingBlockFile->blockFile);
+        }
+        _pendingBlockFile->blockFile.reset();
+    }
+    if (!blockFile) {
+        return;
+    }
+    {
+        // Blocks decoded from the old file might be stale compared to the new file.
+        BlockCache emptyCache(BLOCK_CACHE_SIZE);
+        std::lock_guard<std::mutex> guard(_cacheLock);
+        _blockFile = blockFile;
+        _cache.swap(emptyCache);
+        _loadingBlocks.clear();
+    }
+    uint32_t numBlocks = std::min(blockFile->getNumBlocks(), static_cast<uint32_t>(_dirtyBlocks.size()));
+    for (uint32_t blockId = 0; blockId < numBlocks; ++blockId) {
+        if (_dirtyBlocks[blockId] != nullptr && !_changedSinceSave[blockId]) {
+            _dirtyBlocks[blockId] = nullptr;
+            getGenerationHolder().hold(std::make_unique<HeldBlock<T>>(std::move(_dirtyStorage[blockId]),
+                                                                      Block::BLOCK_SIZE * sizeof(T)));
+        }
+    }
+    this->incGeneration();
+    LOG(debug, "Paged attribute '%s' now reads %u blocks from saved data file, %zu blocks still resident",
+        this->getName().c_str(), blockFile->getNumBlocks(), getDirtyBlockCount());
+}
+
+template <typename B>
+void
+PagedSingleValueNumericAttribute<B>::onCommit()
+{
+    this->checkSetMaxValueCount(1);
+
+    {
+        // apply updates
+        typename B::ValueModifier valueGuard(this->getValueModifier());
+        for (const auto & change : this->_changes) {
+            if (change._type == ChangeBase::UPDATE) {
+                std::atomic_thread_fence(std::memory_order_release);
+                setValue(change._doc, change._data);
+            } else if (change._type >= ChangeBase::ADD && change._type <= ChangeBase::DIV) {
+                std::atomic_thread_fence(std::memory_order_release);
+                setValue(change._doc, this->applyArithmetic(getFast(change._doc), change));
+            } else if (change._type == ChangeBase::CLEARDOC) {
+                std::atomic_thread_fence(std::memory_order_release);
+                setValue(change._doc, this->_defaultValue._data);
+            }
+        }
+    }
+
+    std::atomic_thread_fence(std::memory_order_release);
+    applyPendingBlockFile();
+    this->removeAllOldGenerations();
+
+    this->_changes.clear();
+}
+
+template <typename B>
+void
+PagedSingleValueNumericAttribute<B>::onUpdateStat()
+{
+    vespalib::MemoryUsage usage = _dirtyBlocks.getMemoryUsage();
+    CacheStats cacheStats = getCacheStats();
+    size_t blockBytes = (getDirtyBlockCount() + cacheStats.blocks) * Block::BLOCK_SIZE * sizeof(T);
+    size_t directoryBytes = _blockFile ? _blockFile->getDirectorySize() : 0;
+    usage.incAllocatedBytes(blockBytes + directoryBytes);
+    usage.incUsedBytes(blockBytes + directoryBytes);
+    usage.mergeGenerationHeldBytes(getGenerationHolder().getHeldBytes());
+    usage.merge(this->getChangeVectorMemoryUsage());
+    uint32_t numDocs = B::getNumDocs();
+    this->updateStatistics(numDocs, numDocs,
+                           usage.allocatedBytes(), usage.usedBytes(), usage.deadBytes(), usage.allocatedBytesOnHold());
+}
+
+template <typename B>
+void
+PagedSingleValueNumericAttribute<B>::onAddDocs(DocId lidLimit) {
+    _dirtyBlocks.reserve(Block::numBlocks(lidLimit));
+}
+
+template <typename B>
+bool
+PagedSingleValueNumericAttribute<B>::addDoc(DocId & doc) {
+    doc = B::getNumDocs();
+    uint32_t blockId = doc >> Block::BLOCK_BITS;
+    bool incGen = ensureBlocks(blockId + 1);
+    setValue(doc, attribute::getUndefined<T>());
+    std::atomic_thread_fence(std::memory_order_release);
+    B::incNumDocs();
+    this->updateUncommittedDocIdLimit(doc);
+    if (!incGen) {
+        this->removeAllOldGenerations();
+    }
+    return true;
+}
+
+template <typename B>
+void
+PagedSingleValueNumericAttribute<B>::removeOldGenerations(generation_t firstUsed)
+{
+    getGenerationHolder().trimHoldLists(firstUsed);
+}
+
+template <typename B>
+void
+PagedSingleValueNumericAttribute<B>::onGenerationChange(generation_t generation)
+{
+    getGenerationHolder().transferHoldLists(generation - 1);
+}
+
+template <typename B>
+bool
+PagedSingleValueNumericAttribute<B>::onLoadEnumerated(ReaderBase &attrReader)
+{
+    uint32_t numDocs = attrReader.getEnumCount();
+    auto udatBuffer = attribute::LoadUtils::loadUDAT(*this);
+    assert((udatBuffer->size() % sizeof(T)) == 0);
+    vespalib::ConstArrayRef<T> map(reinterpret_cast<const T *>(udatBuffer->buffer()),
+                                   udatBuffer->size() / sizeof(T));
+    ensureBlocks(Block::numBlocks(numDocs));
+    for (uint32_t doc = 0; doc < numDocs; ++doc) {
+        uint32_t enumValue = attrReader.getNextEnum();
+        assert(enumValue < map.size());
+        setValue(doc, map[enumValue]);
+    }
+    this->setNumDocs(numDocs);
+    this->setCommittedDocIdLimit(numDocs);
+    return true;
+}
+
+template <typename B>
+bool
+PagedSingleValueNumericAttribute<B>::onLoadPaged()
+{
+    {
+        std::shared_ptr<const BlockFile> blockFile = PagedIntegerBlockFile::open(this->getBaseFileName() + ".dat");
+        std::lock_guard<std::mutex> guard(_cacheLock);
+        _blockFile = std::move(blockFile);
+    }
+    uint32_t numDocs = _blockFile->getNumDocs();
+    ensureBlocks(_blockFile->getNumBlocks());
+    this->setNumDocs(numDocs);
+    this->setCommittedDocIdLimit(numDocs);
+    LOG(debug, "Loaded paged attribute '%s': %u docs in %u blocks",
+        this->getName().c_str(), numDocs, _blockFile->getNumBlocks());
+    return true;
+}
+
+template <typename B>
+bool
+PagedSingleValueNumericAttribute<B>::onLoad()
+{
+    PrimitiveReader<T> attrReader(*this);
+    bool ok(attrReader.getHasLoadData());
+
+    if (!ok)
+        return false;
+
+    this->setCreateSerialNum(attrReader.getCreateSerialNum());
+    resetBlocks();
+
+    if (attrReader.getEnumerated())
+        return onLoadEnumerated(attrReader);
+    if (attrReader.getVersion() == PagedIntegerBlockFile::VERSION)
+        return onLoadPaged();
+
+    // Plain data file, saved before the attribute was paged. Kept resident until saved again.
+    const size_t sz(attrReader.getDataCount());
+    ensureBlocks(Block::numBlocks(sz));
+    for (uint32_t i = 0; i < sz; ++i) {
+        setValue(i, attrReader.getNextData());
+    }
+
+    B::setNumDocs(sz);
+    B::setCommittedDocIdLimit(sz);
+
+    return true;
+}
+
+template <typename B>
+uint32_t
+PagedSingleValueNumericAttribute<B>::getVersion() const
+{
+    return PagedIntegerBlockFile::VERSION;
+}
+
+template <typename B>
+typename PagedSingleValueNumericAttribute<B>::CacheStats
+PagedSingleValueNumericAttribute<B>::getCacheStats() const
+{
+    std::lock_guard<std::mutex> guard(_cacheLock);
+    return CacheStats{_cacheHits, _cacheMisses, _cache.size()};
+}
+
+template <typename B>
+size_t
+PagedSingleValueNumericAttribute<B>::getDirtyBlockCount() const
+{
+    return std::count_if(_dirtyStorage.begin(), _dirtyStorage.end(),
+                         [](const auto &storage) { return bool(storage); });
+}
+
+template <typename B>
+AttributeVector::SearchContext::UP
+PagedSingleValueNumericAttribute<B>::getSearch(QueryTermSimple::UP qTerm,
+                                               const attribute::SearchContextParams & params) const
+{
+    (void) params;
+    QueryTermSimple::RangeResult<T> res = qTerm->getRange<T>();
+    if (res.isEqual()) {
+        return std::make_unique<SingleSearchContext<NumericAttribute::Equal<T>>>(std::move(qTerm), *this);
+    } else {
+        return std::make_unique<SingleSearchContext<NumericAttribute::Range<T>>>(std::move(qTerm), *this);
+    }
+}
+
+template <typename B>
+void
+PagedSingleValueNumericAttribute<B>::clearDocs(DocId lidLow, DocId lidLimit)
+{
+    assert(lidLow <= lidLimit);
+    assert(lidLimit <= this->getNumDocs());
+    uint32_t count = 0;
+    constexpr uint32_t commit_interval = 1000;
+    for (DocId lid = lidLow; lid < lidLimit; ++lid) {
+        if (!attribute::isUndefined(getFast(lid))) {
+            this->clearDoc(lid);
+        }
+        if ((++count % commit_interval) == 0) {
+            this->commit();
+        }
+    }
+}
+
+template <typename B>
+void
+PagedSingleValueNumericAttribute<B>::onShrinkLidSpace()
+{
+    uint32_t committedDocIdLimit = this->getCommittedDocIdLimit();
+    assert(this->getNumDocs() >= committedDocIdLimit);
+    this->setNumDocs(committedDocIdLimit);
+}
+
+template <typename B>
+std::unique_ptr<AttributeSaver>
+PagedSingleValueNumericAttribute<B>::onInitSave(vespalib::stringref fileName)
+{
+    applyPendingBlockFile();
+    ++_saveId;
+    std::fill(_changedSinceSave.begin(), _changedSinceSave.end(), false);
+    const uint32_t numDocs(this->getCommittedDocIdLimit());
+    uint32_t numBlocks = Block::numBlocks(numDocs);
+    // Saving truncates the data file before unchanged blocks are copied from it,
+    // so they must be read up front when saving over the file blocks are read from.
+    bool overwritesBlockFile = _blockFile && (_blockFile->getFileName() == fileName + ".dat");
+    std::vector<std::unique_ptr<T[]>> blocks(numBlocks);
+    for (uint32_t blockId = 0; blockId < numBlocks; ++blockId) {
+        const T *block = _dirtyBlocks[blockId];
+        CleanBlockSP clean;
+        if (block == nullptr && overwritesBlockFile && blockId < _blockFile->getNumBlocks()) {
+            clean = getCleanBlock(blockId);
+            block = &(*clean)[0];
+        }
+        if (block != nullptr) {
+            blocks[blockId] = std::make_unique<T[]>(Block::BLOCK_SIZE);
+            std::copy(block, block + Block::BLOCK_SIZE, blocks[blockId].get());
+        }
+    }
+    auto onSaved = [pending = _pendingBlockFile, saveId = _saveId](std::shared_ptr<const BlockFile> blockFile) {
+        std::lock_guard<std::mutex> guard(pending->lock);
+        if (saveId >= pending->saveId) {
+            pending->saveId = saveId;
+            pending->blockFile = std::move(blockFile);
+        }
+    };
+    return std::make_unique<PagedSingleValueNumericAttributeSaver<T>>
+        (this->createAttributeHeader(fileName), overwritesBlockFile ? std::shared_ptr<const BlockFile>() : _blockFile,
+         std::move(blocks), numDocs, std::move(onSaved));
+}
+
+template <typename B>
+template <typename M>
+bool PagedSingleValueNumericAttribute<B>::SingleSearchContext<M>::valid() const { return M::isValid(); }
+
+template <typename B>
+template <typename M>
+PagedSingleValueNumericAttribute<B>::SingleSearchContext<M>::SingleSearchContext(QueryTermSimple::UP qTerm,
+                                                                                 const NumericAttribute & toBeSearched) :
+    M(*qTerm, true),
+    AttributeVector::SearchContext(toBeSearched),
+    _toBeSearched(static_cast<const PagedSingleValueNumericAttribute<B> &>(toBeSearched)),
+    _blockId(std::numeric_limits<uint32_t>::max()),
+    _block(nullptr),
+    _cleanBlock()
+{ }
+
+template <typename B>
+template <typename M>
+Int64Range
+PagedSingleValueNumericAttribute<B>::SingleSearchContext<M>::getAsIntegerTerm() const {
+    return M::getRange();
+}
+
+template <typename B>
+template <typename M>
+std::unique_ptr<queryeval::SearchIterator>
+PagedSingleValueNumericAttribute<B>::SingleSearchContext<M>::
+createFilterIterator(fef::TermFieldMatchData * matchData, bool strict)
+{
+    if (!valid()) {
+        return std::make_unique<queryeval::EmptySearch>();
+    }
+    if (getIsFilter()) {
+        return strict
+                 ? std::make_unique<FilterAttributeIteratorStrict<SingleSearchContext<M>>>(*this, matchData)
+                 : std::make_unique<FilterAttributeIteratorT<SingleSearchContext<M>>>(*this, matchData);
+    }
+    return strict
+             ? std::make_unique<AttributeIteratorStrict<SingleSearchContext<M>>>(*this, matchData)
+             : std::make_unique<AttributeIteratorT<SingleSearchContext<M>>>(*this, matchData);
+}
+
+template class PagedSingleValueNumericAttribute<IntegerAttributeTemplate<int8_t>>;
+template class PagedSingleValueNumericAttribute<IntegerAttributeTemplate<int16_t>>;
+template class PagedSingleValueNumericAttribute<IntegerAttributeTemplate<int32_t>>;
+template class PagedSingleValueNumericAttribute<IntegerAttributeTemplate<int64_t>>;
+
+}
+
+namespace vespalib {
+
+template class RcuVectorBase<int8_t *>;
+template class RcuVectorBase<int16_t *>;
+template class RcuVectorBase<int32_t *>;
+template class RcuVectorBase<int64_t *>;
+
+}
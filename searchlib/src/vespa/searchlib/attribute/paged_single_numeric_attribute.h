@@ -0,0 +1,273 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "integerbase.h"
+#include "paged_integer_block.h"
+#include <vespa/vespalib/stllike/lrucache_map.h>
+#include <vespa/vespalib/util/rcuvector.h>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+namespace search {
+
+namespace attribute { class PagedIntegerBlockFile; }
+
+/**
+ * Single value integer attribute that keeps its saved values compressed on
+ * disk (see attribute::PagedIntegerBlock) and decodes blocks on demand
+ * through an LRU cache, instead of keeping all values resident.
+ *
+ * Blocks that are changed, or that contain documents added after the
+ * attribute was loaded, are kept resident and uncompressed until the
+ * attribute is saved to file. The saved data file then replaces the
+ * file blocks are read from, and resident blocks not changed since the
+ * save was initiated are dropped.
+ */
+template <typename B>
+class PagedSingleValueNumericAttribute final : public B {
+private:
+    using T = typename B::BaseType;
+    using DocId = typename B::DocId;
+    using EnumHandle = typename B::EnumHandle;
+    using Weighted = typename B::Weighted;
+    using WeightedEnum = typename B::WeightedEnum;
+    using WeightedFloat = typename B::WeightedFloat;
+    using WeightedInt = typename B::WeightedInt;
+    using generation_t = typename B::generation_t;
+    using largeint_t = typename B::largeint_t;
+    using Block = attribute::PagedIntegerBlock;
+    using BlockFile = attribute::PagedIntegerBlockFile;
+    using CleanBlock = std::vector<T>;
+    using CleanBlockSP = std::shared_ptr<const CleanBlock>;
+    using BlockCache = vespalib::lrucache_map<vespalib::LruParam<uint32_t, CleanBlockSP>>;
+
+    /*
+     * Block being decoded by one thread, shared with other threads
+     * missing the cache for the same block in the same file.
+     */
+    struct LoadingBlock {
+        std::shared_ptr<const BlockFile>  blockFile;
+        std::shared_future<CleanBlockSP>  block;
+    };
+
+    /*
+     * Data file written by the latest save, handed over from the save
+     * thread. Applied by the write thread if no save has been initiated
+     * since.
+     */
+    struct PendingBlockFile {
+        std::mutex                        lock;
+        uint64_t                          saveId;
+        std::shared_ptr<const BlockFile>  blockFile;
+        PendingBlockFile() : lock(), saveId(0), blockFile() {}
+    };
+
+    using B::getGenerationHolder;
+
+    std::shared_ptr<const BlockFile>     _blockFile;  // Guarded by _cacheLock when read outside write thread
+    vespalib::RcuVectorBase<T *>         _dirtyBlocks;
+    std::vector<std::unique_ptr<T[]>>    _dirtyStorage;
+    std::vector<bool>                    _changedSinceSave;
+    uint64_t                             _saveId;
+    std::shared_ptr<PendingBlockFile>    _pendingBlockFile;
+    mutable std::mutex                   _cacheLock;
+    mutable BlockCache                   _cache;
+    mutable std::unordered_map<uint32_t, LoadingBlock> _loadingBlocks;
+    mutable uint64_t                     _cacheHits;
+    mutable uint64_t                     _cacheMisses;
+
+    T getFromEnum(EnumHandle e) const override {
+        (void) e;
+        return T();
+    }
+
+    CleanBlockSP getCleanBlock(uint32_t blockId) const;
+    T *getWritableBlock(uint32_t blockId);
+    bool ensureBlocks(uint32_t numBlocks);
+    void resetBlocks();
+    void applyPendingBlockFile();
+    void setValue(DocId doc, T v) {
+        uint32_t blockId = doc >> Block::BLOCK_BITS;
+        getWritableBlock(blockId)[doc & Block::BLOCK_MASK] = v;
+        _changedSinceSave[blockId] = true;
+    }
+    bool onLoadPaged();
+    bool onLoadEnumerated(ReaderBase &attrReader);
+
+    /**
+     * Returns the values of the given block. The holder keeps a decoded
+     * clean block alive while the returned pointer is used.
+     */
+    const T *acquireBlock(uint32_t blockId, CleanBlockSP &holder) const;
+
+    /*
+     * Specialization of SearchContext, remembering the last block used.
+     */
+    template <typename M>
+    class SingleSearchContext final : public M, public AttributeVector::SearchContext
+    {
+    private:
+        const PagedSingleValueNumericAttribute &_toBeSearched;
+        mutable uint32_t      _blockId;
+        mutable const T     * _block;
+        mutable CleanBlockSP  _cleanBlock;
+
+        int32_t onFind(DocId docId, int32_t elemId, int32_t & weight) const override {
+            return find(docId, elemId, weight);
+        }
+
+        int32_t onFind(DocId docId, int elemId) const override {
+            return find(docId, elemId);
+        }
+
+        bool valid() const override;
+
+        T getValue(DocId docId) const {
+            uint32_t blockId = docId >> Block::BLOCK_BITS;
+            if (blockId != _blockId) {
+                _block = _toBeSearched.acquireBlock(blockId, _cleanBlock);
+                _blockId = blockId;
+            }
+            return _block[docId & Block::BLOCK_MASK];
+        }
+
+    public:
+        SingleSearchContext(std::unique_ptr<QueryTermSimple> qTerm, const NumericAttribute & toBeSearched);
+        int32_t find(DocId docId, int32_t elemId, int32_t & weight) const {
+            if ( elemId != 0) return -1;
+            const T v = getValue(docId);
+            weight = 1;
+            return this->match(v) ? 0 : -1;
+        }
+
+        int32_t find(DocId docId, int elemId) const {
+            if ( elemId != 0) return -1;
+            const T v = getValue(docId);
+            return this->match(v) ? 0 : -1;
+        }
+
+        Int64Range getAsIntegerTerm() const override;
+
+        std::unique_ptr<queryeval::SearchIterator>
+        createFilterIterator(fef::TermFieldMatchData * matchData, bool strict) override;
+    };
+
+protected:
+    bool findEnum(T value, EnumHandle & e) const override {
+        (void) value; (void) e;
+        return false;
+    }
+
+public:
+    struct CacheStats {
+        uint64_t hits;
+        uint64_t misses;
+        size_t   blocks;
+    };
+
+    /**
+     * Max number of decoded blocks kept in the block cache.
+     */
+    static constexpr size_t BLOCK_CACHE_SIZE = 256;
+
+    PagedSingleValueNumericAttribute(const vespalib::string & baseFileName,
+                                     const AttributeVector::Config & c =
+                                     AttributeVector::Config(AttributeVector::
+                                             BasicType::fromType(T()),
+                                             attribute::CollectionType::SINGLE));
+
+    ~PagedSingleValueNumericAttribute() override;
+
+    uint32_t getValueCount(DocId doc) const override {
+        if (doc >= B::getNumDocs()) {
+            return 0;
+        }
+        return 1;
+    }
+    void onCommit() override;
+    void onAddDocs(DocId lidLimit) override;
+    void onUpdateStat() override;
+    void removeOldGenerations(generation_t firstUsed) override;
+    void onGenerationChange(generation_t generation) override;
+    bool addDoc(DocId & doc) override;
+    bool onLoad() override;
+    uint32_t getVersion() const override;
+
+    AttributeVector::SearchContext::UP
+    getSearch(std::unique_ptr<QueryTermSimple> term, const attribute::SearchContextParams & params) const override;
+
+    T getFast(DocId doc) const {
+        const T *block = _dirtyBlocks[doc >> Block::BLOCK_BITS];
+        if (block != nullptr) {
+            return block[doc & Block::BLOCK_MASK];
+        }
+        return (*getCleanBlock(doc >> Block::BLOCK_BITS))[doc & Block::BLOCK_MASK];
+    }
+
+    CacheStats getCacheStats() const;
+    size_t getDirtyBlockCount() const;
+
+    //-------------------------------------------------------------------------
+    // new read api
+    //-------------------------------------------------------------------------
+    T get(DocId doc) const override {
+        return getFast(doc);
+    }
+    largeint_t getInt(DocId doc) const override {
+        return static_cast<largeint_t>(getFast(doc));
+    }
+    double getFloat(DocId doc) const override {
+        return static_cast<double>(getFast(doc));
+    }
+    uint32_t getEnum(DocId doc) const override {
+        (void) doc;
+        return std::numeric_limits<uint32_t>::max(); // does not have enum
+    }
+    uint32_t getAll(DocId doc, T * v, uint32_t sz) const override {
+        (void) sz;
+        v[0] = getFast(doc);
+        return 1;
+    }
+    uint32_t get(DocId doc, largeint_t * v, uint32_t sz) const override {
+        (void) sz;
+        v[0] = static_cast<largeint_t>(getFast(doc));
+        return 1;
+    }
+    uint32_t get(DocId doc, double * v, uint32_t sz) const override {
+        (void) sz;
+        v[0] = static_cast<double>(getFast(doc));
+        return 1;
+    }
+    uint32_t get(DocId doc, EnumHandle * e, uint32_t sz) const override {
+        (void) sz;
+        e[0] = getEnum(doc);
+        return 1;
+    }
+    uint32_t getAll(DocId doc, Weighted * v, uint32_t sz) const override {
+        (void) doc; (void) v; (void) sz;
+        return 0;
+    }
+    uint32_t get(DocId doc, WeightedInt * v, uint32_t sz) const override {
+        (void) sz;
+        v[0] = WeightedInt(static_cast<largeint_t>(getFast(doc)));
+        return 1;
+    }
+    uint32_t get(DocId doc, WeightedFloat * v, uint32_t sz) const override {
+        (void) sz;
+        v[0] = WeightedFloat(static_cast<double>(getFast(doc)));
+        return 1;
+    }
+    uint32_t get(DocId doc, WeightedEnum * e, uint32_t sz) const override {
+        (void) doc; (void) e; (void) sz;
+        return 0;
+    }
+
+    void clearDocs(DocId lidLow, DocId lidLimit) override;
+    void onShrinkLidSpace() override;
+    std::unique_ptr<AttributeSaver> onInitSave(vespalib::stringref fileName) override;
+};
+
+}
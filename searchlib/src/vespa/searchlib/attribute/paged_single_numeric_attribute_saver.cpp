@@ -0,0 +1,100 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "paged_single_numeric_attribute_saver.h"
+#include "attributefilesavetarget.h"
+#include "iattributefilewriter.h"
+#include "iattributesavetarget.h"
+#include "paged_integer_block_file.h"
+#include <vespa/searchcommon/common/undefinedvalues.h>
+#include <vespa/searchlib/util/bufferwriter.h>
+#include <vespa/vespalib/util/exceptions.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".searchlib.attribute.paged_single_numeric_attribute_saver");
+
+using search::attribute::PagedIntegerBlock;
+
+namespace search {
+
+template <typename T>
+PagedSingleValueNumericAttributeSaver<T>::
+PagedSingleValueNumericAttributeSaver(const attribute::AttributeHeader &header,
+                                      std::shared_ptr<const BlockFile> blockFile,
+                                      std::vector<Block> blocks,
+                                      uint32_t numDocs,
+                                      SavedCallback onSaved)
+    : AttributeSaver(vespalib::GenerationHandler::Guard(), header),
+      _blockFile(std::move(blockFile)),
+      _blocks(std::move(blocks)),
+      _numDocs(numDocs),
+      _onSaved(std::move(onSaved))
+{
+}
+
+template <typename T>
+PagedSingleValueNumericAttributeSaver<T>::~PagedSingleValueNumericAttributeSaver() = default;
+
+template <typename T>
+bool
+PagedSingleValueNumericAttributeSaver<T>::onSave(IAttributeSaveTarget &saveTarget)
+{
+    const int64_t undefined = attribute::getUndefined<T>();
+    uint32_t numBlocks = PagedIntegerBlock::numBlocks(_numDocs);
+    std::vector<PagedIntegerBlock::Entry> entries;
+    std::vector<uint64_t> words;
+    std::vector<uint64_t> cleanWords;
+    std::vector<int64_t> values(PagedIntegerBlock::BLOCK_SIZE);
+    entries.reserve(numBlocks);
+    for (uint32_t blockId = 0; blockId < numBlocks; ++blockId) {
+        uint32_t count = std::min(PagedIntegerBlock::BLOCK_SIZE,
+                                  _numDocs - (blockId << PagedIntegerBlock::BLOCK_BITS));
+        const T *block = (blockId < _blocks.size()) ? _blocks[blockId].get() : nullptr;
+        bool inFile = _blockFile && (blockId < _blockFile->getNumBlocks());
+        if (block == nullptr && inFile && _blockFile->getBlockDocs(blockId) == count) {
+            _blockFile->readWords(blockId, cleanWords);
+            PagedIntegerBlock::Entry entry = _blockFile->getEntry(blockId);
+            entry.offset = words.size();
+            words.insert(words.end(), cleanWords.begin(), cleanWords.end());
+            entries.push_back(entry);
+            continue;
+        }
+        std::fill(values.begin(), values.end(), undefined);
+        if (block != nullptr) {
+            for (uint32_t i = 0; i < count; ++i) {
+                values[i] = block[i];
+            }
+        } else if (inFile) {
+            // Lid space has been shrunk into this block since it was loaded.
+            _blockFile->readBlock(blockId, undefined, &values[0]);
+        }
+        entries.push_back(PagedIntegerBlock::encode(&values[0], count, undefined, words));
+    }
+    auto writer = saveTarget.datWriter().allocBufferWriter();
+    attribute::PagedIntegerBlockFile::write(*writer, _numDocs, entries, words);
+    writer->flush();
+    return true;
+}
+
+template <typename T>
+void
+PagedSingleValueNumericAttributeSaver<T>::onSaved(IAttributeSaveTarget &saveTarget)
+{
+    if (!_onSaved || (dynamic_cast<AttributeFileSaveTarget *>(&saveTarget) == nullptr)) {
+        // Data saved to memory is not readable as a block file.
+        return;
+    }
+    vespalib::string fileName(get_file_name() + ".dat");
+    try {
+        _onSaved(BlockFile::open(fileName));
+    } catch (const vespalib::IllegalStateException &e) {
+        LOG(warning, "Could not open saved data file '%s', keeping blocks resident: %s",
+            fileName.c_str(), e.getMessage().c_str());
+    }
+}
+
+template class PagedSingleValueNumericAttributeSaver<int8_t>;
+template class PagedSingleValueNumericAttributeSaver<int16_t>;
+template class PagedSingleValueNumericAttributeSaver<int32_t>;
+template class PagedSingleValueNumericAttributeSaver<int64_t>;
+
+}  // namespace search
@@ -0,0 +1,50 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "attributesaver.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace search {
+
+namespace attribute { class PagedIntegerBlockFile; }
+
+/*
+ * Class for saving a paged single value integer attribute.
+ *
+ * Blocks changed since the attribute was loaded are copied when the
+ * saver is created and packed when saving. Unchanged blocks are copied
+ * in packed form from the data file the attribute was loaded from.
+ *
+ * When saved to a file, the written data file is opened and handed to
+ * the given callback, so the attribute can read blocks from it.
+ */
+template <typename T>
+class PagedSingleValueNumericAttributeSaver : public AttributeSaver
+{
+public:
+    using BlockFile = attribute::PagedIntegerBlockFile;
+    using Block = std::unique_ptr<T[]>;
+    using SavedCallback = std::function<void(std::shared_ptr<const BlockFile>)>;
+
+private:
+    std::shared_ptr<const BlockFile> _blockFile;
+    std::vector<Block>               _blocks;   // nullptr for unchanged blocks
+    uint32_t                         _numDocs;
+    SavedCallback                    _onSaved;
+
+    bool onSave(IAttributeSaveTarget &saveTarget) override;
+    void onSaved(IAttributeSaveTarget &saveTarget) override;
+public:
+    PagedSingleValueNumericAttributeSaver(const attribute::AttributeHeader &header,
+                                          std::shared_ptr<const BlockFile> blockFile,
+                                          std::vector<Block> blocks,
+                                          uint32_t numDocs,
+                                          SavedCallback onSaved);
+
+    ~PagedSingleValueNumericAttributeSaver() override;
+};
+
+} // namespace search
@@ -17,6 +17,7 @@ namespace {
 const vespalib::string versionTag = "version";
 const vespalib::string docIdLimitTag = "docIdLimit";
 const vespalib::string createSerialNumTag = "createSerialNum";
+const vespalib::string deltaTag = "delta";
 
 constexpr size_t DIRECTIO_ALIGNMENT(4096);
 
@@ -44,6 +45,7 @@ ReaderBase::ReaderBase(AttributeVector &attr)
       _createSerialNum(0u),
       _fixedWidth(attr.getFixedWidth()),
       _enumerated(false),
+      _delta(false),
       _hasLoadData(false),
       _version(0),
       _docIdLimit(0),
@@ -62,6 +64,9 @@ ReaderBase::ReaderBase(AttributeVector &attr)
         _version = _datHeader.getTag(versionTag).asInteger();
     }
     _docIdLimit = _datHeader.getTag(docIdLimitTag).asInteger();
+    if (_datHeader.hasTag(deltaTag)) {
+        _delta = (_datHeader.getTag(deltaTag).asInteger() != 0);
+    }
     if (hasIdx()) {
         vespalib::FileHeader idxHeader(DIRECTIO_ALIGNMENT);
         _idxHeaderLen = idxHeader.readFile(*_idxFile);
@@ -37,6 +37,7 @@ public:
     int32_t getNextWeight() { return _weightReader.readHostOrder(); }
     uint32_t getNextEnum() { return _enumReader.readHostOrder(); }
     bool getEnumerated() const { return _enumerated; }
+    bool getDelta() const { return _delta; }
     uint32_t getNextValueCount();
     int64_t getCreateSerialNum() const { return _createSerialNum; }
     bool getHasLoadData() const { return _hasLoadData; }
@@ -60,6 +61,7 @@ private:
     uint64_t              _createSerialNum;
     size_t                _fixedWidth;
     bool                  _enumerated;
+    bool                  _delta;
     bool                  _hasLoadData;
     uint32_t              _version;
     uint32_t              _docIdLimit;
@@ -0,0 +1,434 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "single_packed_numeric_attribute.h"
+#include "attributeiterators.hpp"
+#include "attributevector.hpp"
+#include "load_utils.h"
+#include "primitivereader.h"
+#include "singlenumericattributesaver.h"
+#include <vespa/searchlib/query/query_term_simple.h>
+#include <vespa/searchlib/queryeval/emptysearch.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".searchlib.attribute.single_packed_numeric_attribute");
+
+namespace search {
+
+using attribute::PackedIntegerVector;
+
+namespace {
+
+class HeldPackedVector : public vespalib::GenerationHeldBase {
+    std::unique_ptr<PackedIntegerVector> _data;
+public:
+    HeldPackedVector(std::unique_ptr<PackedIntegerVector> data)
+        : GenerationHeldBase(data->getAllocatedBytes()),
+          _data(std::move(data))
+    { }
+};
+
+/*
+ * Strict iterators letting the search context scan packed words for the
+ * next match instead of testing one doc at a time.
+ */
+template <typename SC>
+class PackedAttributeIteratorStrict : public AttributeIteratorT<SC>
+{
+private:
+    using Trinary = vespalib::Trinary;
+    void doSeek(uint32_t docId) override {
+        uint32_t nextId = this->_concreteSearchCtx.findNextMatch(docId, this->getEndId());
+        if (this->isAtEnd(nextId)) {
+            this->setAtEnd();
+        } else {
+            this->_weight = 1;
+            this->setDocId(nextId);
+        }
+    }
+    Trinary is_strict() const override { return Trinary::True; }
+public:
+    PackedAttributeIteratorStrict(const SC &concreteSearchCtx, fef::TermFieldMatchData *matchData)
+        : AttributeIteratorT<SC>(concreteSearchCtx, matchData)
+    { }
+};
+
+template <typename SC>
+class PackedFilterAttributeIteratorStrict : public FilterAttributeIteratorT<SC>
+{
+private:
+    using Trinary = vespalib::Trinary;
+    void doSeek(uint32_t docId) override {
+        uint32_t nextId = this->_concreteSearchCtx.findNextMatch(docId, this->getEndId());
+        if (this->isAtEnd(nextId)) {
+            this->setAtEnd();
+        } else {
+            this->setDocId(nextId);
+        }
+    }
+    Trinary is_strict() const override { return Trinary::True; }
+public:
+    PackedFilterAttributeIteratorStrict(const SC &concreteSearchCtx, fef::TermFieldMatchData *matchData)
+        : FilterAttributeIteratorT<SC>(concreteSearchCtx, matchData)
+    { }
+};
+
+}
+
+template <typename B>
+SingleValuePackedNumericAttribute<B>::
+SingleValuePackedNumericAttribute(const vespalib::string & baseFileName, const AttributeVector::Config & c) :
+    B(baseFileName, c),
+    _data(std::make_unique<PackedVector>(valueType(), PackedVector::chooseLayout(valueType(), 0, 0, true),
+                                         c.getGrowStrategy().getDocsInitialCapacity())),
+    _readData(_data.get())
+{ }
+
+template <typename B>
+SingleValuePackedNumericAttribute<B>::~SingleValuePackedNumericAttribute()
+{
+    getGenerationHolder().clearHoldLists();
+}
+
+template <typename B>
+attribute::PackedIntegerVector::ValueType
+SingleValuePackedNumericAttribute<B>::valueType()
+{
+    return PackedVector::ValueType(std::numeric_limits<T>::min() + 1, std::numeric_limits<T>::max(),
+                                   attribute::getUndefined<T>());
+}
+
+template <typename B>
+void
+SingleValuePackedNumericAttribute<B>::replaceData(std::unique_ptr<PackedVector> data)
+{
+    std::unique_ptr<PackedVector> old = std::move(_data);
+    _data = std::move(data);
+    _readData.store(_data.get(), std::memory_order_release);
+    getGenerationHolder().hold(std::make_unique<HeldPackedVector>(std::move(old)));
+    this->incGeneration();
+}
+
+template <typename B>
+uint32_t
+SingleValuePackedNumericAttribute<B>::grownCapacity(uint32_t wantedCapacity) const
+{
+    const auto &growStrategy = this->getConfig().getGrowStrategy();
+    size_t capacity = _data->getCapacity();
+    size_t grown = capacity + (capacity * growStrategy.getDocsGrowPercent()) / 100 + growStrategy.getDocsGrowDelta();
+    return std::max(size_t(wantedCapacity), grown);
+}
+
+template <typename B>
+void
+SingleValuePackedNumericAttribute<B>::ensureFits(T v)
+{
+    if (_data->fits(v)) {
+        return;
+    }
+    int64_t minValue = std::min(_data->getLayout().base, int64_t(v));
+    int64_t maxValue = std::max(_data->getMaxValue(), int64_t(v));
+    auto layout = PackedVector::chooseLayout(valueType(), minValue, maxValue, true);
+    auto data = std::make_unique<PackedVector>(valueType(), layout, _data->getCapacity());
+    _data->copyTo(*data, B::getNumDocs());
+    LOG(debug, "Attribute '%s' repacked from %u to %u bits per value",
+        this->getName().c_str(), _data->getLayout().bits, layout.bits);
+    replaceData(std::move(data));
+}
+
+template <typename B>
+void
+SingleValuePackedNumericAttribute<B>::onCommit()
+{
+    this->checkSetMaxValueCount(1);
+
+    {
+        // apply updates
+        typename B::ValueModifier valueGuard(this->getValueModifier());
+        for (const auto & change : this->_changes) {
+            T v;
+            if (change._type == ChangeBase::UPDATE) {
+                v = change._data;
+            } else if (change._type >= ChangeBase::ADD && change._type <= ChangeBase::DIV) {
+                v = this->applyArithmetic(getFast(change._doc), change);
+            } else if (change._type == ChangeBase::CLEARDOC) {
+                v = this->_defaultValue._data;
+            } else {
+                continue;
+            }
+            ensureFits(v);
+            std::atomic_thread_fence(std::memory_order_release);
+            _data->set(change._doc, v);
+        }
+    }
+
+    std::atomic_thread_fence(std::memory_order_release);
+    this->removeAllOldGenerations();
+
+    this->_changes.clear();
+}
+
+template <typename B>
+void
+SingleValuePackedNumericAttribute<B>::onUpdateStat()
+{
+    vespalib::MemoryUsage usage;
+    usage.incAllocatedBytes(_data->getAllocatedBytes());
+    usage.incUsedBytes(_data->getAllocatedBytes());
+    usage.mergeGenerationHeldBytes(getGenerationHolder().getHeldBytes());
+    usage.merge(this->getChangeVectorMemoryUsage());
+    uint32_t numDocs = B::getNumDocs();
+    this->updateStatistics(numDocs, numDocs,
+                           usage.allocatedBytes(), usage.usedBytes(), usage.deadBytes(), usage.allocatedBytesOnHold());
+}
+
+template <typename B>
+void
+SingleValuePackedNumericAttribute<B>::onAddDocs(DocId lidLimit) {
+    if (lidLimit > _data->getCapacity()) {
+        auto data = std::make_unique<PackedVector>(valueType(), _data->getLayout(), lidLimit);
+        _data->copyTo(*data, B::getNumDocs());
+        replaceData(std::move(data));
+    }
+}
+
+template <typename B>
+bool
+SingleValuePackedNumericAttribute<B>::addDoc(DocId & doc) {
+    doc = B::getNumDocs();
+    bool incGen = (doc >= _data->getCapacity());
+    if (incGen) {
+        auto data = std::make_unique<PackedVector>(valueType(), _data->getLayout(), grownCapacity(doc + 1));
+        _data->copyTo(*data, doc);
+        replaceData(std::move(data));
+    }
+    _data->set(doc, attribute::getUndefined<T>());
+    std::atomic_thread_fence(std::memory_order_release);
+    B::incNumDocs();
+    this->updateUncommittedDocIdLimit(doc);
+    if (!incGen) {
+        this->removeAllOldGenerations();
+    }
+    return true;
+}
+
+template <typename B>
+void
+SingleValuePackedNumericAttribute<B>::removeOldGenerations(generation_t firstUsed)
+{
+    getGenerationHolder().trimHoldLists(firstUsed);
+}
+
+template <typename B>
+void
+SingleValuePackedNumericAttribute<B>::onGenerationChange(generation_t generation)
+{
+    getGenerationHolder().transferHoldLists(generation - 1);
+}
+
+template <typename B>
+void
+SingleValuePackedNumericAttribute<B>::loadValues(const std::vector<T> &values)
+{
+    bool hasDefined = false;
+    T minValue = T();
+    T maxValue = T();
+    for (T v : values) {
+        if (attribute::isUndefined(v)) {
+            continue;
+        }
+        minValue = hasDefined ? std::min(minValue, v) : v;
+        maxValue = hasDefined ? std::max(maxValue, v) : v;
+        hasDefined = true;
+    }
+    auto layout = PackedVector::chooseLayout(valueType(), minValue, maxValue, !hasDefined);
+    auto data = std::make_unique<PackedVector>(valueType(), layout, values.size());
+    for (uint32_t doc = 0; doc < values.size(); ++doc) {
+        data->set(doc, values[doc]);
+    }
+    getGenerationHolder().clearHoldLists();
+    replaceData(std::move(data));
+    this->setNumDocs(values.size());
+    this->setCommittedDocIdLimit(values.size());
+}
+
+template <typename B>
+bool
+SingleValuePackedNumericAttribute<B>::onLoadEnumerated(ReaderBase &attrReader)
+{
+    uint32_t numDocs = attrReader.getEnumCount();
+    auto udatBuffer = attribute::LoadUtils::loadUDAT(*this);
+    assert((udatBuffer->size() % sizeof(T)) == 0);
+    vespalib::ConstArrayRef<T> map(reinterpret_cast<const T *>(udatBuffer->buffer()),
+                                   udatBuffer->size() / sizeof(T));
+    std::vector<T> values;
+    values.reserve(numDocs);
+    for (uint32_t doc = 0; doc < numDocs; ++doc) {
+        uint32_t enumValue = attrReader.getNextEnum();
+        assert(enumValue < map.size());
+        values.push_back(map[enumValue]);
+    }
+    loadValues(values);
+    return true;
+}
+
+template <typename B>
+bool
+SingleValuePackedNumericAttribute<B>::onLoad()
+{
+    PrimitiveReader<T> attrReader(*this);
+    bool ok(attrReader.getHasLoadData());
+
+    if (!ok)
+        return false;
+
+    this->setCreateSerialNum(attrReader.getCreateSerialNum());
+
+    if (attrReader.getEnumerated())
+        return onLoadEnumerated(attrReader);
+
+    const size_t sz(attrReader.getDataCount());
+    std::vector<T> values;
+    values.reserve(sz);
+    for (uint32_t i = 0; i < sz; ++i) {
+        values.push_back(attrReader.getNextData());
+    }
+    loadValues(values);
+    LOG(debug, "Loaded attribute '%s' with %u bits per value", this->getName().c_str(), getBitsPerValue());
+    return true;
+}
+
+template <typename B>
+AttributeVector::SearchContext::UP
+SingleValuePackedNumericAttribute<B>::getSearch(QueryTermSimple::UP qTerm,
+                                                const attribute::SearchContextParams & params) const
+{
+    (void) params;
+    QueryTermSimple::RangeResult<T> res = qTerm->getRange<T>();
+    if (res.isEqual()) {
+        return std::make_unique<SingleSearchContext<NumericAttribute::Equal<T>>>(std::move(qTerm), *this);
+    } else {
+        return std::make_unique<SingleSearchContext<NumericAttribute::Range<T>>>(std::move(qTerm), *this);
+    }
+}
+
+template <typename B>
+void
+SingleValuePackedNumericAttribute<B>::clearDocs(DocId lidLow, DocId lidLimit)
+{
+    assert(lidLow <= lidLimit);
+    assert(lidLimit <= this->getNumDocs());
+    uint32_t count = 0;
+    constexpr uint32_t commit_interval = 1000;
+    for (DocId lid = lidLow; lid < lidLimit; ++lid) {
+        if (!attribute::isUndefined(getFast(lid))) {
+            this->clearDoc(lid);
+        }
+        if ((++count % commit_interval) == 0) {
+            this->commit();
+        }
+    }
+}
+
+template <typename B>
+void
+SingleValuePackedNumericAttribute<B>::onShrinkLidSpace()
+{
+    uint32_t committedDocIdLimit = this->getCommittedDocIdLimit();
+    assert(this->getNumDocs() >= committedDocIdLimit);
+    auto data = std::make_unique<PackedVector>(valueType(), _data->getLayout(), committedDocIdLimit);
+    _data->copyTo(*data, committedDocIdLimit);
+    replaceData(std::move(data));
+    this->setNumDocs(committedDocIdLimit);
+}
+
+template <typename B>
+std::unique_ptr<AttributeSaver>
+SingleValuePackedNumericAttribute<B>::onInitSave(vespalib::stringref fileName)
+{
+    const uint32_t numDocs(this->getCommittedDocIdLimit());
+    std::vector<T> values;
+    values.reserve(numDocs);
+    for (uint32_t doc = 0; doc < numDocs; ++doc) {
+        values.push_back(getFast(doc));
+    }
+    return std::make_unique<SingleValueNumericAttributeSaver>
+        (this->createAttributeHeader(fileName), values.data(), numDocs * sizeof(T));
+}
+
+template <typename B>
+template <typename M>
+bool SingleValuePackedNumericAttribute<B>::SingleSearchContext<M>::valid() const { return M::isValid(); }
+
+template <typename B>
+template <typename M>
+SingleValuePackedNumericAttribute<B>::SingleSearchContext<M>::SingleSearchContext(QueryTermSimple::UP qTerm,
+                                                                                  const NumericAttribute & toBeSearched) :
+    M(*qTerm, true),
+    AttributeVector::SearchContext(toBeSearched),
+    _data(static_cast<const SingleValuePackedNumericAttribute<B> &>(toBeSearched).data()),
+    _lowCode(0),
+    _highCode(0),
+    _hasCodes(false)
+{
+    Int64Range range = M::getRange();
+    _hasCodes = _data.getCodeRange(range.lower(), range.upper(), _lowCode, _highCode);
+}
+
+template <typename B>
+template <typename M>
+uint32_t
+SingleValuePackedNumericAttribute<B>::SingleSearchContext<M>::findNextMatch(DocId docId, DocId endId) const
+{
+    DocId packedEndId = std::min(endId, _data.getCapacity());
+    if (!_hasCodes || docId >= packedEndId) {
+        return endId;
+    }
+    DocId nextId = _data.findNextMatch(docId, packedEndId, _lowCode, _highCode);
+    return (nextId < packedEndId) ? nextId : endId;
+}
+
+template <typename B>
+template <typename M>
+std::unique_ptr<BitVector>
+SingleValuePackedNumericAttribute<B>::SingleSearchContext<M>::get_hits(uint32_t begin_id, uint32_t end_id) const
+{
+    BitVector::UP result = BitVector::create(begin_id, end_id);
+    for (uint32_t docId = findNextMatch(begin_id, end_id); docId < end_id; docId = findNextMatch(docId + 1, end_id)) {
+        result->setBit(docId);
+    }
+    result->invalidateCachedCount();
+    return result;
+}
+
+template <typename B>
+template <typename M>
+Int64Range
+SingleValuePackedNumericAttribute<B>::SingleSearchContext<M>::getAsIntegerTerm() const {
+    return M::getRange();
+}
+
+template <typename B>
+template <typename M>
+std::unique_ptr<queryeval::SearchIterator>
+SingleValuePackedNumericAttribute<B>::SingleSearchContext<M>::
+createFilterIterator(fef::TermFieldMatchData * matchData, bool strict)
+{
+    if (!valid() || !_hasCodes) {
+        return std::make_unique<queryeval::EmptySearch>();
+    }
+    if (getIsFilter()) {
+        return strict
+                 ? std::make_unique<PackedFilterAttributeIteratorStrict<SingleSearchContext<M>>>(*this, matchData)
+                 : std::make_unique<FilterAttributeIteratorT<SingleSearchContext<M>>>(*this, matchData);
+    }
+    return strict
+             ? std::make_unique<PackedAttributeIteratorStrict<SingleSearchContext<M>>>(*this, matchData)
+             : std::make_unique<AttributeIteratorT<SingleSearchContext<M>>>(*this, matchData);
+}
+
+template class SingleValuePackedNumericAttribute<IntegerAttributeTemplate<int8_t>>;
+template class SingleValuePackedNumericAttribute<IntegerAttributeTemplate<int16_t>>;
+template class SingleValuePackedNumericAttribute<IntegerAttributeTemplate<int32_t>>;
+template class SingleValuePackedNumericAttribute<IntegerAttributeTemplate<int64_t>>;
+
+}
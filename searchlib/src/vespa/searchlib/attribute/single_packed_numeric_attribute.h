@@ -0,0 +1,213 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "integerbase.h"
+#include "packed_integer_vector.h"
+#include <atomic>
+#include <limits>
+#include <vector>
+
+namespace search {
+
+/**
+ * Single value integer attribute storing its values bit packed relative to
+ * the smallest value (see attribute::PackedIntegerVector). The width is
+ * selected from the observed min and max values when loading, and is
+ * widened, with headroom, when an update does not fit.
+ *
+ * Values are saved in full width, using the same format as
+ * SingleValueNumericAttribute.
+ */
+template <typename B>
+class SingleValuePackedNumericAttribute final : public B {
+private:
+    using T = typename B::BaseType;
+    using DocId = typename B::DocId;
+    using EnumHandle = typename B::EnumHandle;
+    using Weighted = typename B::Weighted;
+    using WeightedEnum = typename B::WeightedEnum;
+    using WeightedFloat = typename B::WeightedFloat;
+    using WeightedInt = typename B::WeightedInt;
+    using generation_t = typename B::generation_t;
+    using largeint_t = typename B::largeint_t;
+    using PackedVector = attribute::PackedIntegerVector;
+
+    using B::getGenerationHolder;
+
+    std::unique_ptr<PackedVector>      _data;
+    std::atomic<const PackedVector *>  _readData;
+
+    T getFromEnum(EnumHandle e) const override {
+        (void) e;
+        return T();
+    }
+
+    static PackedVector::ValueType valueType();
+    const PackedVector &data() const { return *_readData.load(std::memory_order_acquire); }
+    void replaceData(std::unique_ptr<PackedVector> data);
+    void ensureFits(T v);
+    uint32_t grownCapacity(uint32_t wantedCapacity) const;
+    void loadValues(const std::vector<T> &values);
+
+    /*
+     * Specialization of SearchContext working on codes instead of values.
+     */
+    template <typename M>
+    class SingleSearchContext final : public M, public AttributeVector::SearchContext
+    {
+    private:
+        const PackedVector & _data;
+        uint64_t             _lowCode;
+        uint64_t             _highCode;
+        bool                 _hasCodes;
+
+        int32_t onFind(DocId docId, int32_t elemId, int32_t & weight) const override {
+            return find(docId, elemId, weight);
+        }
+
+        int32_t onFind(DocId docId, int elemId) const override {
+            return find(docId, elemId);
+        }
+
+        bool valid() const override;
+
+        bool matchCode(DocId docId) const {
+            return _hasCodes && (docId < _data.getCapacity()) &&
+                (_data.getCode(docId) - _lowCode <= _highCode - _lowCode);
+        }
+
+    public:
+        SingleSearchContext(std::unique_ptr<QueryTermSimple> qTerm, const NumericAttribute & toBeSearched);
+        int32_t find(DocId docId, int32_t elemId, int32_t & weight) const {
+            if ( elemId != 0) return -1;
+            weight = 1;
+            return matchCode(docId) ? 0 : -1;
+        }
+
+        int32_t find(DocId docId, int elemId) const {
+            if ( elemId != 0) return -1;
+            return matchCode(docId) ? 0 : -1;
+        }
+
+        /**
+         * Returns the first matching doc in [docId, endId), or endId if there is none.
+         */
+        uint32_t findNextMatch(DocId docId, DocId endId) const;
+
+        /**
+         * Returns the hits in [begin_id, end_id). Used by the attribute
+         * iterators when producing hits termwise.
+         */
+        std::unique_ptr<BitVector> get_hits(uint32_t begin_id, uint32_t end_id) const;
+
+        Int64Range getAsIntegerTerm() const override;
+
+        std::unique_ptr<queryeval::SearchIterator>
+        createFilterIterator(fef::TermFieldMatchData * matchData, bool strict) override;
+    };
+
+protected:
+    bool findEnum(T value, EnumHandle & e) const override {
+        (void) value; (void) e;
+        return false;
+    }
+
+public:
+    SingleValuePackedNumericAttribute(const vespalib::string & baseFileName,
+                                      const AttributeVector::Config & c =
+                                      AttributeVector::Config(AttributeVector::
+                                              BasicType::fromType(T()),
+                                              attribute::CollectionType::SINGLE));
+
+    ~SingleValuePackedNumericAttribute() override;
+
+    uint32_t getValueCount(DocId doc) const override {
+        if (doc >= B::getNumDocs()) {
+            return 0;
+        }
+        return 1;
+    }
+    void onCommit() override;
+    void onAddDocs(DocId lidLimit) override;
+    void onUpdateStat() override;
+    void removeOldGenerations(generation_t firstUsed) override;
+    void onGenerationChange(generation_t generation) override;
+    bool addDoc(DocId & doc) override;
+    bool onLoad() override;
+
+    bool onLoadEnumerated(ReaderBase &attrReader);
+
+    AttributeVector::SearchContext::UP
+    getSearch(std::unique_ptr<QueryTermSimple> term, const attribute::SearchContextParams & params) const override;
+
+    T getFast(DocId doc) const {
+        return static_cast<T>(data().get(doc));
+    }
+
+    /**
+     * Returns the number of bits currently used per value.
+     */
+    uint32_t getBitsPerValue() const { return data().getLayout().bits; }
+
+    //-------------------------------------------------------------------------
+    // new read api
+    //-------------------------------------------------------------------------
+    T get(DocId doc) const override {
+        return getFast(doc);
+    }
+    largeint_t getInt(DocId doc) const override {
+        return static_cast<largeint_t>(getFast(doc));
+    }
+    double getFloat(DocId doc) const override {
+        return static_cast<double>(getFast(doc));
+    }
+    uint32_t getEnum(DocId doc) const override {
+        (void) doc;
+        return std::numeric_limits<uint32_t>::max(); // does not have enum
+    }
+    uint32_t getAll(DocId doc, T * v, uint32_t sz) const override {
+        (void) sz;
+        v[0] = getFast(doc);
+        return 1;
+    }
+    uint32_t get(DocId doc, largeint_t * v, uint32_t sz) const override {
+        (void) sz;
+        v[0] = static_cast<largeint_t>(getFast(doc));
+        return 1;
+    }
+    uint32_t get(DocId doc, double * v, uint32_t sz) const override {
+        (void) sz;
+        v[0] = static_cast<double>(getFast(doc));
+        return 1;
+    }
+    uint32_t get(DocId doc, EnumHandle * e, uint32_t sz) const override {
+        (void) sz;
+        e[0] = getEnum(doc);
+        return 1;
+    }
+    uint32_t getAll(DocId doc, Weighted * v, uint32_t sz) const override {
+        (void) doc; (void) v; (void) sz;
+        return 0;
+    }
+    uint32_t get(DocId doc, WeightedInt * v, uint32_t sz) const override {
+        (void) sz;
+        v[0] = WeightedInt(static_cast<largeint_t>(getFast(doc)));
+        return 1;
+    }
+    uint32_t get(DocId doc, WeightedFloat * v, uint32_t sz) const override {
+        (void) sz;
+        v[0] = WeightedFloat(static_cast<double>(getFast(doc)));
+        return 1;
+    }
+    uint32_t get(DocId doc, WeightedEnum * e, uint32_t sz) const override {
+        (void) doc; (void) e; (void) sz;
+        return 0;
+    }
+
+    void clearDocs(DocId lidLow, DocId lidLimit) override;
+    void onShrinkLidSpace() override;
+    std::unique_ptr<AttributeSaver> onInitSave(vespalib::stringref fileName) override;
+};
+
+}
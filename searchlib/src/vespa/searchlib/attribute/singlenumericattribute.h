@@ -5,7 +5,9 @@
 #include "integerbase.h"
 #include "floatbase.h"
 #include <vespa/vespalib/util/rcuvector.h>
+#include <atomic>
 #include <limits>
+#include <vector>
 
 namespace search {
 
@@ -27,6 +29,27 @@ private:
 
     DataVector _data;
 
+    // Tracking of documents changed since the last full save, used for delta saves.
+    // The doc id limit and change count are also read by the flush engine when estimating the save size.
+    vespalib::string      _deltaBaseFileName;
+    std::atomic<uint32_t> _deltaBaseDocIdLimit;
+    std::atomic<uint32_t> _numChangedLids;
+    std::vector<bool>     _changedLids;
+    std::vector<uint32_t> _changedLidList;
+
+    void markChanged(DocId doc) {
+        if (doc < _deltaBaseDocIdLimit.load(std::memory_order_relaxed) && !_changedLids[doc]) {
+            _changedLids[doc] = true;
+            _changedLidList.push_back(doc);
+            _numChangedLids.store(_changedLidList.size(), std::memory_order_relaxed);
+        }
+    }
+    void resetDeltaBase(const vespalib::string &baseFileName, uint32_t docIdLimit);
+    uint64_t numDeltaDocs(uint32_t numDocs) const;
+    bool useDeltaSave(vespalib::stringref fileName, uint32_t numDocs) const;
+    std::unique_ptr<AttributeSaver> initDeltaSave(vespalib::stringref fileName, uint32_t numDocs);
+    bool onLoadDelta(ReaderBase &attrReader);
+
     T getFromEnum(EnumHandle e) const override {
         (void) e;
         return T();
@@ -66,6 +89,12 @@ private:
             return this->match(v) ? 0 : -1;
         }
 
+        /**
+         * Returns the hits in [begin_id, end_id), scanning the values in blocks.
+         * Used by the attribute iterators when producing hits termwise.
+         */
+        std::unique_ptr<BitVector> get_hits(uint32_t begin_id, uint32_t end_id) const;
+
         Int64Range getAsIntegerTerm() const override;
 
         std::unique_ptr<queryeval::SearchIterator>
@@ -102,6 +131,7 @@ public:
     void onGenerationChange(generation_t generation) override;
     bool addDoc(DocId & doc) override;
     bool onLoad() override;
+    uint64_t getEstimatedSaveByteSize() const override;
 
     bool onLoadEnumerated(ReaderBase &attrReader);
 
@@ -109,6 +139,7 @@ public:
     getSearch(std::unique_ptr<QueryTermSimple> term, const attribute::SearchContextParams & params) const override;
 
     void set(DocId doc, T v) {
+        markChanged(doc);
         _data[doc] = v;
     }
 
@@ -4,11 +4,16 @@
 #include "attributeiterators.hpp"
 #include "attributevector.hpp"
 #include "load_utils.h"
+#include "numeric_range_hits.h"
 #include "primitivereader.h"
 #include "singlenumericattribute.h"
 #include "singlenumericattributesaver.h"
+#include "singlenumericdeltasaver.h"
 #include <vespa/searchlib/query/query_term_simple.h>
 #include <vespa/searchlib/queryeval/emptysearch.h>
+#include <vespa/searchlib/util/fileutil.h>
+#include <vespa/vespalib/io/fileutil.h>
+#include <algorithm>
 
 namespace search {
 
@@ -19,7 +24,12 @@ SingleValueNumericAttribute(const vespalib::string & baseFileName, const Attribu
     _data(c.getGrowStrategy().getDocsInitialCapacity(),
           c.getGrowStrategy().getDocsGrowPercent(),
           c.getGrowStrategy().getDocsGrowDelta(),
-          getGenerationHolder())
+          getGenerationHolder()),
+    _deltaBaseFileName(),
+    _deltaBaseDocIdLimit(0),
+    _numChangedLids(0),
+    _changedLids(),
+    _changedLidList()
 { }
 
 template <typename B>
@@ -39,12 +49,15 @@ SingleValueNumericAttribute<B>::onCommit()
         typename B::ValueModifier valueGuard(this->getValueModifier());
         for (const auto & change : this->_changes) {
             if (change._type == ChangeBase::UPDATE) {
+                markChanged(change._doc);
                 std::atomic_thread_fence(std::memory_order_release);
                 _data[change._doc] = change._data;
             } else if (change._type >= ChangeBase::ADD && change._type <= ChangeBase::DIV) {
+                markChanged(change._doc);
                 std::atomic_thread_fence(std::memory_order_release);
                 _data[change._doc] = this->applyArithmetic(_data[change._doc], change);
             } else if (change._type == ChangeBase::CLEARDOC) {
+                markChanged(change._doc);
                 std::atomic_thread_fence(std::memory_order_release);
                 _data[change._doc] = this->_defaultValue._data;
             }
@@ -138,7 +151,14 @@ SingleValueNumericAttribute<B>::onLoad()
 
     if (attrReader.getEnumerated())
         return onLoadEnumerated(attrReader);
-    
+
+    if (attrReader.getDelta())
+        return onLoadDelta(attrReader);
+
+    // data files with another layout (e.g. newer formats) are rejected instead of misread
+    if (attrReader.getVersion() != this->getVersion())
+        return false;
+
     const size_t sz(attrReader.getDataCount());
     getGenerationHolder().clearHoldLists();
     _data.reset();
@@ -149,6 +169,59 @@ SingleValueNumericAttribute<B>::onLoad()
 
     B::setNumDocs(sz);
     B::setCommittedDocIdLimit(sz);
+    resetDeltaBase(this->getBaseFileName() + ".dat", sz);
+
+    return true;
+}
+
+template <typename B>
+bool
+SingleValueNumericAttribute<B>::onLoadDelta(ReaderBase &attrReader)
+{
+    if (attrReader.getVersion() != SingleValueNumericDeltaSaver::DELTA_VERSION) {
+        return false;
+    }
+    const vespalib::string baseFileName(this->getBaseFileName() + "." + SingleValueNumericDeltaSaver::BASE_SUFFIX);
+    if (!vespalib::fileExists(baseFileName)) {
+        return false;
+    }
+    auto baseBuffer = attribute::LoadUtils::loadFile(*this, SingleValueNumericDeltaSaver::BASE_SUFFIX);
+    if (!this->headerTypeOK(baseBuffer->getHeader())) {
+        return false;
+    }
+    auto deltaBuffer = attribute::LoadUtils::loadDAT(*this);
+    constexpr size_t recordSize = sizeof(uint32_t) + sizeof(T);
+    assert((baseBuffer->size() % sizeof(T)) == 0);
+    assert((deltaBuffer->size() % recordSize) == 0);
+    const uint32_t docIdLimit(attrReader.getDocIdLimit());
+    const uint32_t baseDocIdLimit(std::min(baseBuffer->size() / sizeof(T), size_t(docIdLimit)));
+    const size_t numRecords(deltaBuffer->size() / recordSize);
+
+    getGenerationHolder().clearHoldLists();
+    _data.reset();
+    _data.unsafe_reserve(docIdLimit);
+    const char *base = static_cast<const char *>(baseBuffer->buffer());
+    for (uint32_t lid = 0; lid < baseDocIdLimit; ++lid) {
+        T value;
+        memcpy(&value, base + lid * sizeof(T), sizeof(T));
+        _data.push_back(value);
+    }
+    for (uint32_t lid = baseDocIdLimit; lid < docIdLimit; ++lid) {
+        _data.push_back(attribute::getUndefined<T>());
+    }
+    resetDeltaBase(baseFileName, baseDocIdLimit);
+    const char *lids = static_cast<const char *>(deltaBuffer->buffer());
+    const char *values = lids + numRecords * sizeof(uint32_t);
+    for (size_t i = 0; i < numRecords; ++i) {
+        uint32_t lid;
+        memcpy(&lid, lids + i * sizeof(uint32_t), sizeof(uint32_t));
+        assert(lid < docIdLimit);
+        memcpy(&_data[lid], values + i * sizeof(T), sizeof(T));
+        markChanged(lid);
+    }
+
+    B::setNumDocs(docIdLimit);
+    B::setCommittedDocIdLimit(docIdLimit);
 
     return true;
 }
@@ -194,6 +267,88 @@ SingleValueNumericAttribute<B>::onShrinkLidSpace()
     assert(_data.size() >= committedDocIdLimit);
     _data.shrink(committedDocIdLimit);
     this->setNumDocs(committedDocIdLimit);
+    _deltaBaseDocIdLimit.store(std::min(_deltaBaseDocIdLimit.load(std::memory_order_relaxed), committedDocIdLimit),
+                               std::memory_order_relaxed);
+}
+
+template <typename B>
+void
+SingleValueNumericAttribute<B>::resetDeltaBase(const vespalib::string &baseFileName, uint32_t docIdLimit)
+{
+    _changedLids.clear();
+    _changedLidList.clear();
+    _numChangedLids.store(0, std::memory_order_relaxed);
+    if (this->getConfig().maxDeltaRatio() > 0.0) {
+        _deltaBaseFileName = baseFileName;
+        _deltaBaseDocIdLimit.store(docIdLimit, std::memory_order_relaxed);
+        _changedLids.resize(docIdLimit, false);
+    } else {
+        _deltaBaseFileName.clear();
+        _deltaBaseDocIdLimit.store(0, std::memory_order_relaxed);
+    }
+}
+
+template <typename B>
+uint64_t
+SingleValueNumericAttribute<B>::numDeltaDocs(uint32_t numDocs) const
+{
+    uint32_t addedDocs = numDocs - std::min(_deltaBaseDocIdLimit.load(std::memory_order_relaxed), numDocs);
+    return uint64_t(_numChangedLids.load(std::memory_order_relaxed)) + addedDocs;
+}
+
+template <typename B>
+bool
+SingleValueNumericAttribute<B>::useDeltaSave(vespalib::stringref fileName, uint32_t numDocs) const
+{
+    if (this->getConfig().maxDeltaRatio() <= 0.0 || _deltaBaseFileName.empty()) {
+        return false;
+    }
+    // The base data file is never copied, as that would cost as much as a full save.
+    return (numDeltaDocs(numDocs) <= this->getConfig().maxDeltaRatio() * numDocs) &&
+           SingleValueNumericDeltaSaver::canLinkBase(_deltaBaseFileName, fileName);
+}
+
+template <typename B>
+uint64_t
+SingleValueNumericAttribute<B>::getEstimatedSaveByteSize() const
+{
+    const uint32_t numDocs(this->getCommittedDocIdLimit());
+    if (this->getConfig().maxDeltaRatio() > 0.0 && _deltaBaseDocIdLimit.load(std::memory_order_relaxed) > 0) {
+        uint64_t deltaDocs = numDeltaDocs(numDocs);
+        if (deltaDocs <= this->getConfig().maxDeltaRatio() * numDocs) {
+            uint64_t headerSize = 4096;
+            return headerSize + deltaDocs * (sizeof(uint32_t) + sizeof(T));
+        }
+    }
+    return B::getEstimatedSaveByteSize();
+}
+
+template <typename B>
+std::unique_ptr<AttributeSaver>
+SingleValueNumericAttribute<B>::initDeltaSave(vespalib::stringref fileName, uint32_t numDocs)
+{
+    const uint32_t baseDocIdLimit(std::min(_deltaBaseDocIdLimit.load(std::memory_order_relaxed), numDocs));
+    std::vector<uint32_t> lids;
+    lids.reserve(_changedLidList.size() + (numDocs - baseDocIdLimit));
+    for (uint32_t lid : _changedLidList) {
+        if (lid < baseDocIdLimit) {
+            lids.push_back(lid);
+        }
+    }
+    std::sort(lids.begin(), lids.end());
+    for (uint32_t lid = baseDocIdLimit; lid < numDocs; ++lid) {
+        lids.push_back(lid);
+    }
+    std::vector<T> values;
+    values.reserve(lids.size());
+    for (uint32_t lid : lids) {
+        values.push_back(_data[lid]);
+    }
+    auto saver = std::make_unique<SingleValueNumericDeltaSaver>
+        (this->createAttributeHeader(fileName), _deltaBaseFileName, lids, values.data(), values.size() * sizeof(T));
+    // The next delta save links the base data file of this save, keeping the changes tracked so far.
+    _deltaBaseFileName = vespalib::string(fileName) + "." + SingleValueNumericDeltaSaver::BASE_SUFFIX;
+    return saver;
 }
 
 template <typename B>
@@ -202,6 +357,10 @@ SingleValueNumericAttribute<B>::onInitSave(vespalib::stringref fileName)
 {
     const uint32_t numDocs(this->getCommittedDocIdLimit());
     assert(numDocs <= _data.size());
+    if (useDeltaSave(fileName, numDocs)) {
+        return initDeltaSave(fileName, numDocs);
+    }
+    resetDeltaBase(vespalib::string(fileName) + ".dat", numDocs);
     return std::make_unique<SingleValueNumericAttributeSaver>
         (this->createAttributeHeader(fileName), &_data[0], numDocs * sizeof(T));
 }
@@ -220,6 +379,13 @@ SingleValueNumericAttribute<B>::SingleSearchContext<M>::SingleSearchContext(Quer
 { }
 
 
+template <typename B>
+template <typename M>
+std::unique_ptr<BitVector>
+SingleValueNumericAttribute<B>::SingleSearchContext<M>::get_hits(uint32_t begin_id, uint32_t end_id) const {
+    return attribute::getNumericRangeHits<T>(_data, M::getLow(), M::getHigh(), begin_id, end_id);
+}
+
 template <typename B>
 template <typename M>
 Int64Range
@@ -0,0 +1,101 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "singlenumericdeltasaver.h"
+#include "iattributesavetarget.h"
+#include <vespa/vespalib/io/fileutil.h>
+#include <vespa/vespalib/util/error.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".searchlib.attribute.singlenumericdeltasaver");
+
+using search::attribute::AttributeHeader;
+
+namespace search {
+
+namespace {
+
+const uint32_t MIN_ALIGNMENT = 4096;
+
+AttributeHeader
+deltaHeader(const AttributeHeader &header)
+{
+    AttributeHeader result(header);
+    result.setDelta(true);
+    result.setVersion(SingleValueNumericDeltaSaver::DELTA_VERSION);
+    return result;
+}
+
+bool
+linkBase(const vespalib::string &from, const vespalib::string &to)
+{
+    vespalib::unlink(to);
+    if (::link(from.c_str(), to.c_str()) != 0) {
+        LOG(warning, "Could not link '%s' to '%s': %s",
+            from.c_str(), to.c_str(), vespalib::getLastErrorString().c_str());
+        return false;
+    }
+    return true;
+}
+
+}
+
+const vespalib::string SingleValueNumericDeltaSaver::BASE_SUFFIX = "base.dat";
+
+SingleValueNumericDeltaSaver::
+SingleValueNumericDeltaSaver(const AttributeHeader &header,
+                             const vespalib::string &baseFileName,
+                             const std::vector<uint32_t> &lids,
+                             const void *values, size_t valuesSize)
+  : AttributeSaver(vespalib::GenerationHandler::Guard(), deltaHeader(header)),
+    _baseFileName(baseFileName),
+    _buf()
+{
+    size_t lidsSize = lids.size() * sizeof(uint32_t);
+    size_t size = lidsSize + valuesSize;
+    _buf = std::make_unique<BufferBuf>(size, MIN_ALIGNMENT);
+    assert(_buf->getFreeLen() >= size);
+    if (lidsSize > 0) {
+        memcpy(_buf->getFree(), &lids[0], lidsSize);
+        _buf->moveFreeToData(lidsSize);
+    }
+    if (valuesSize > 0) {
+        memcpy(_buf->getFree(), values, valuesSize);
+        _buf->moveFreeToData(valuesSize);
+    }
+    assert(_buf->getDataLen() == size);
+}
+
+SingleValueNumericDeltaSaver::~SingleValueNumericDeltaSaver() = default;
+
+bool
+SingleValueNumericDeltaSaver::canLinkBase(const vespalib::string &baseFileName, vespalib::stringref fileName)
+{
+    struct stat baseStat;
+    if (::stat(baseFileName.c_str(), &baseStat) != 0) {
+        return false;
+    }
+    vespalib::string dir = vespalib::dirname(fileName);
+    struct stat dirStat;
+    while (::stat(dir.c_str(), &dirStat) != 0) {
+        vespalib::string parent = vespalib::dirname(dir);
+        if (parent == dir) {
+            return false;
+        }
+        dir = parent;
+    }
+    return (baseStat.st_dev == dirStat.st_dev);
+}
+
+bool
+SingleValueNumericDeltaSaver::onSave(IAttributeSaveTarget &saveTarget)
+{
+    if (!linkBase(_baseFileName, get_file_name() + "." + BASE_SUFFIX)) {
+        return false;
+    }
+    saveTarget.datWriter().writeBuf(std::move(_buf));
+    return true;
+}
+
+}  // namespace search
@@ -0,0 +1,58 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "attributesaver.h"
+#include "iattributefilewriter.h"
+#include <vector>
+
+namespace search {
+
+/*
+ * Class for saving the documents of a plain attribute (i.e. single value
+ * numeric attribute) changed since its last full save.
+ *
+ * The data file of the last full save is hard linked into the new
+ * snapshot with the BASE_SUFFIX suffix, and the data file only contains
+ * the changed documents: their lids followed by their values. The data
+ * file header has the delta tag set and a data file version of its own,
+ * making readers checking the version reject it instead of reading the
+ * lids and values as plain data.
+ */
+class SingleValueNumericDeltaSaver : public AttributeSaver
+{
+public:
+    using Buffer = IAttributeFileWriter::Buffer;
+
+    static const vespalib::string BASE_SUFFIX;
+    // Distinct from the paged integer and predicate data file versions
+    static constexpr uint32_t DELTA_VERSION = 3;
+
+private:
+    using BufferBuf = IAttributeFileWriter::BufferBuf;
+
+    vespalib::string _baseFileName;
+    Buffer           _buf;
+
+    bool onSave(IAttributeSaveTarget &saveTarget) override;
+public:
+    /**
+     * Creates a saver for the given changed lids and their values.
+     * The delta tag and DELTA_VERSION are set in the given header.
+     */
+    SingleValueNumericDeltaSaver(const attribute::AttributeHeader &header,
+                                 const vespalib::string &baseFileName,
+                                 const std::vector<uint32_t> &lids,
+                                 const void *values, size_t valuesSize);
+
+    ~SingleValueNumericDeltaSaver() override;
+
+    /**
+     * Returns true if the given base data file can be hard linked into
+     * the snapshot of the given attribute file name, i.e. they are on
+     * the same file system. The snapshot directory might not exist yet.
+     */
+    static bool canLinkBase(const vespalib::string &baseFileName, vespalib::stringref fileName);
+};
+
+} // namespace search
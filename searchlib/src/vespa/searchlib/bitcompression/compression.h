@@ -75,6 +75,7 @@ private:
 #define K_VALUE_ZCPOSTING_DELTA_DOCID 22
 #define K_VALUE_ZCPOSTING_FIELD_LENGTH 9
 #define K_VALUE_ZCPOSTING_NUM_OCCS 0
+#define K_VALUE_ZCPOSTING_BLOCKMAXSIZE 10
 
 /**
  * Lookup tables used for compression / decompression.
@@ -3,6 +3,8 @@
 #include "compression.h"
 #include "posocccompression.h"
 #include "posocc_fields_params.h"
+#include <algorithm>
+#include <limits>
 #include <vespa/searchlib/fef/termfieldmatchdata.h>
 #include <vespa/searchlib/fef/termfieldmatchdataarray.h>
 #include <vespa/vespalib/stllike/asciistream.h>
@@ -62,6 +64,7 @@ readFeatures(search::index::DocIdAndFeatures &features)
     const PosOccFieldParams &fieldParams =
         _fieldsParams->getFieldParams()[0];
     uint32_t numElements = 1;
+    int32_t maxElementWeight = fieldParams._hasElementWeights ? std::numeric_limits<int32_t>::min() : 1;
     if (fieldParams._hasElements) {
         UC64_DECODEEXPGOLOMB_SMALL_NS(o,
                                       K_VALUE_POSOCC_NUMELEMENTS,
@@ -75,9 +78,11 @@ readFeatures(search::index::DocIdAndFeatures &features)
                                         K_VALUE_POSOCC_ELEMENTID,
                                         EC);
             if (fieldParams._hasElementWeights) {
-                UC64_SKIPEXPGOLOMB_SMALL_NS(o,
-                                            K_VALUE_POSOCC_ELEMENTWEIGHT,
-                                            EC);
+                UC64_DECODEEXPGOLOMB_SMALL_NS(o,
+                                              K_VALUE_POSOCC_ELEMENTWEIGHT,
+                                              EC);
+                int32_t elementWeight = this->convertToSigned(val64);
+                maxElementWeight = std::max(maxElementWeight, elementWeight);
             }
             if (__builtin_expect(oCompr >= valE, false)) {
                 while (rawFeatures < oCompr) {
@@ -138,6 +143,7 @@ readFeatures(search::index::DocIdAndFeatures &features)
         (reinterpret_cast<unsigned long>(oCompr) << 3) -
         oPreRead;
     features.set_bit_length(rawFeaturesEndBitPos - rawFeaturesStartBitPos);
+    features.set_max_element_weight(maxElementWeight);
     while (rawFeatures < oCompr) {
         features.blob().push_back(*rawFeatures);
         ++rawFeatures;
@@ -568,6 +574,7 @@ readFeatures(search::index::DocIdAndFeatures &features)
     uint32_t elementLenK = EGPosOccEncodeContext<bigEndian>::
                            calcElementLenK(fieldParams._avgElemLen);
     uint32_t numElements = 1;
+    int32_t maxElementWeight = fieldParams._hasElementWeights ? std::numeric_limits<int32_t>::min() : 1;
     if (fieldParams._hasElements) {
         UC64_DECODEEXPGOLOMB_SMALL_NS(o,
                                       K_VALUE_POSOCC_NUMELEMENTS,
@@ -580,9 +587,11 @@ readFeatures(search::index::DocIdAndFeatures &features)
                                         K_VALUE_POSOCC_ELEMENTID,
                                         EC);
             if (fieldParams._hasElementWeights) {
-                UC64_SKIPEXPGOLOMB_SMALL_NS(o,
-                                            K_VALUE_POSOCC_ELEMENTWEIGHT,
-                                            EC);
+                UC64_DECODEEXPGOLOMB_SMALL_NS(o,
+                                              K_VALUE_POSOCC_ELEMENTWEIGHT,
+                                              EC);
+                int32_t elementWeight = this->convertToSigned(val64);
+                maxElementWeight = std::max(maxElementWeight, elementWeight);
             }
             if (__builtin_expect(oCompr >= valE, false)) {
                 while (rawFeatures < oCompr) {
@@ -631,6 +640,7 @@ readFeatures(search::index::DocIdAndFeatures &features)
         (reinterpret_cast<unsigned long>(oCompr) << 3) -
         oPreRead;
     features.set_bit_length(rawFeaturesEndBitPos - rawFeaturesStartBitPos);
+    features.set_max_element_weight(maxElementWeight);
     while (rawFeatures < oCompr) {
         features.blob().push_back(*rawFeatures);
         ++rawFeatures;
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
 namespace search {
@@ -98,21 +99,29 @@ private:
     TuneControl _tuneControl;
     int         _mmapFlags;
     int         _advise;
+    uint32_t    _asyncQueueDepth;
 public:
     TuneFileRandRead()
         : _tuneControl(NORMAL),
           _mmapFlags(0),
-          _advise(0)
+          _advise(0),
+          _asyncQueueDepth(0)
     { }
 
     void setAdvise(int advise)        { _advise = advise; }
     void setWantMemoryMap() { _tuneControl = MMAP; }
     void setWantDirectIO()  { _tuneControl = DIRECTIO; }
     void setWantNormal()    { _tuneControl = NORMAL; }
+    /**
+     * Max number of reads in flight when reading batches of random reads
+     * asynchronously. 0 disables asynchronous reads.
+     */
+    void setAsyncQueueDepth(uint32_t queueDepth) { _asyncQueueDepth = queueDepth; }
     bool getWantDirectIO()   const { return _tuneControl == DIRECTIO; }
     bool getWantMemoryMap()  const { return _tuneControl == MMAP; }
     int  getMemoryMapFlags() const { return _mmapFlags; }
     int  getAdvise()         const { return _advise; }
+    uint32_t getAsyncQueueDepth() const { return _asyncQueueDepth; }
 
     template <typename TuneControlConfig, typename MMapConfig>
     void setFromConfig(const enum TuneControlConfig::Io & tuneControlConfig, const MMapConfig & mmapFlags);
@@ -120,7 +129,8 @@ public:
     void setFromMmapConfig(const MMapConfig & mmapFlags);
 
     bool operator==(const TuneFileRandRead &rhs) const {
-        return (_tuneControl == rhs._tuneControl) && (_mmapFlags == rhs._mmapFlags);
+        return (_tuneControl == rhs._tuneControl) && (_mmapFlags == rhs._mmapFlags) &&
+               (_asyncQueueDepth == rhs._asyncQueueDepth);
     }
 
     bool operator!=(const TuneFileRandRead &rhs) const {
@@ -46,7 +46,7 @@ DiskIndex::Key::Key(const Key &) = default;
 DiskIndex::Key & DiskIndex::Key::operator = (const Key &) = default;
 DiskIndex::Key::~Key() = default;
 
-DiskIndex::DiskIndex(const vespalib::string &indexDir, size_t cacheSize)
+DiskIndex::DiskIndex(const vespalib::string &indexDir, size_t cacheSize, PostingListCache::SP postingListCache)
     : _indexDir(indexDir),
       _cacheSize(cacheSize),
       _schema(),
@@ -55,6 +55,8 @@ DiskIndex::DiskIndex(const vespalib::string &indexDir, size_t cacheSize)
       _dicts(),
       _tuneFileSearch(),
       _cache(*this, cacheSize),
+      _postingListCache(std::move(postingListCache)),
+      _id(PostingListCache::nextDiskIndexId()),
       _size(0)
 {
     calculateSize();
@@ -295,30 +297,78 @@ DiskIndex::read(const Key & key, LookupResultVector & result)
 
 index::PostingListHandle::UP
 DiskIndex::readPostingList(const LookupResult &lookupRes) const
+{
+    return readPostingList(lookupRes.indexId, lookupRes.counts, lookupRes.bitOffset);
+}
+
+PostingListHandle::UP
+DiskIndex::readPostingList(uint32_t indexId, const PostingListCounts &counts, uint64_t bitOffset) const
 {
     PostingListHandle::UP handle(new PostingListHandle());
-    handle->_bitOffset = lookupRes.bitOffset;
-    handle->_bitLength = lookupRes.counts._bitLength;
-    SchemaUtil::IndexIterator it(_schema, lookupRes.indexId);
+    handle->_bitOffset = bitOffset;
+    handle->_bitLength = counts._bitLength;
+    SchemaUtil::IndexIterator it(_schema, indexId);
     handle->_file = _postingFiles[it.getIndex()].get();
     if (handle->_file == nullptr) {
         return PostingListHandle::UP();
     }
     const uint32_t firstSegment = 0;
     const uint32_t numSegments = 0; // means all segments
-    handle->_file->readPostingList(lookupRes.counts, firstSegment, numSegments,*handle);
+    handle->_file->readPostingList(counts, firstSegment, numSegments,*handle);
     return handle;
 }
 
 BitVector::UP
 DiskIndex::readBitVector(const LookupResult &lookupRes) const
 {
-    SchemaUtil::IndexIterator it(_schema, lookupRes.indexId);
+    return readBitVector(lookupRes.indexId, lookupRes.wordNum);
+}
+
+BitVector::UP
+DiskIndex::readBitVector(uint32_t indexId, uint64_t wordNum) const
+{
+    SchemaUtil::IndexIterator it(_schema, indexId);
     BitVectorDictionary * dict = _bitVectorDicts[it.getIndex()].get();
     if (dict == nullptr) {
         return BitVector::UP();
     }
-    return dict->lookup(lookupRes.wordNum);
+    return dict->lookup(wordNum);
+}
+
+std::shared_ptr<const PostingListHandle>
+DiskIndex::readCachedPostingList(const LookupResult &lookupRes) const
+{
+    if (!_postingListCache || _tuneFileSearch._read.getWantMemoryMap()) {
+        return readPostingList(lookupRes);
+    }
+    PostingListCache::Key key(_id, lookupRes.indexId, lookupRes.wordNum, false);
+    key.backing_store_file = this;
+    key.counts = &lookupRes.counts;
+    key.bit_offset = lookupRes.bitOffset;
+    return _postingListCache->read(key).posting_list;
+}
+
+std::shared_ptr<const BitVector>
+DiskIndex::readCachedBitVector(const LookupResult &lookupRes) const
+{
+    if (!_postingListCache) {
+        return readBitVector(lookupRes);
+    }
+    PostingListCache::Key key(_id, lookupRes.indexId, lookupRes.wordNum, true);
+    key.backing_store_file = this;
+    return _postingListCache->read(key).bit_vector;
+}
+
+std::shared_ptr<const PostingListHandle>
+DiskIndex::read_posting_list(const PostingListCache::Key &key) const
+{
+    return readPostingList(key.index_id, *key.counts, key.bit_offset);
+}
+
+std::shared_ptr<const BitVector>
+DiskIndex::read_bit_vector(const PostingListCache::Key &key) const
+{
+    return readBitVector(key.index_id, key.word_num);
 }
 
 void
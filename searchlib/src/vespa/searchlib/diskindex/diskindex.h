@@ -3,6 +3,7 @@
 #pragma once
 
 #include "bitvectordictionary.h"
+#include "posting_list_cache.h"
 #include "zcposoccrandread.h"
 #include <vespa/searchlib/index/dictionaryfile.h>
 #include <vespa/searchlib/index/field_length_info.h>
@@ -19,7 +20,8 @@ namespace search::diskindex {
  * Parts of the disk dictionary and all bit vector dictionaries are loaded into memory during setup.
  * All other files are just opened, ready for later access.
  */
-class DiskIndex : public queryeval::Searchable {
+class DiskIndex : public queryeval::Searchable,
+                  public PostingListCache::IPostingListFileBacking {
 public:
     /**
      * The result after performing a disk dictionary lookup.
@@ -79,10 +81,15 @@ private:
     std::vector<std::unique_ptr<index::DictionaryFileRandRead>> _dicts;
     TuneFileSearch                         _tuneFileSearch;
     Cache                                  _cache;
+    PostingListCache::SP                   _postingListCache;
+    uint64_t                               _id;
     uint64_t                               _size;
 
     void calculateSize();
     bool loadSchema();
+    index::PostingListHandle::UP readPostingList(uint32_t indexId, const index::PostingListCounts &counts,
+                                                 uint64_t bitOffset) const;
+    BitVector::UP readBitVector(uint32_t indexId, uint64_t wordNum) const;
     bool openDictionaries(const TuneFileSearch &tuneFileSearch);
     bool openField(const vespalib::string &fieldDir, const TuneFileSearch &tuneFileSearch);
 
@@ -92,8 +99,10 @@ public:
      *
      * @param indexDir the directory where the disk index is located.
      * @param cacheSize optional size (in bytes) of the disk dictionary lookup cache.
+     * @param postingListCache optional cache of posting lists and bit vectors shared with other disk indexes.
      */
-    explicit DiskIndex(const vespalib::string &indexDir, size_t cacheSize=0);
+    explicit DiskIndex(const vespalib::string &indexDir, size_t cacheSize=0,
+                       PostingListCache::SP postingListCache = PostingListCache::SP());
     ~DiskIndex() override;
 
     /**
@@ -132,6 +141,22 @@ public:
      */
     BitVector::UP readBitVector(const LookupResult &lookupRes) const;
 
+    /**
+     * Read the posting list corresponding to the given lookup result,
+     * using the shared posting list cache if present. Posting lists
+     * from memory mapped files are never cached.
+     */
+    std::shared_ptr<const index::PostingListHandle> readCachedPostingList(const LookupResult &lookupRes) const;
+
+    /**
+     * Read the bit vector corresponding to the given lookup result,
+     * using the shared posting list cache if present.
+     */
+    std::shared_ptr<const BitVector> readCachedBitVector(const LookupResult &lookupRes) const;
+
+    std::shared_ptr<const index::PostingListHandle> read_posting_list(const PostingListCache::Key &key) const override;
+    std::shared_ptr<const BitVector> read_bit_vector(const PostingListCache::Key &key) const override;
+
     queryeval::Blueprint::UP createBlueprint(const queryeval::IRequestContext & requestContext,
                                              const queryeval::FieldSpec &field,
                                              const query::Node &term) override;
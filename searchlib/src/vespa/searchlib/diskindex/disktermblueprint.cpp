@@ -72,9 +72,9 @@ DiskTermBlueprint::fetchPostings(const queryeval::ExecuteInfo &execInfo)
     (void) execInfo;
     if (!_fetchPostingsDone) {
         _hasEquivParent = areAnyParentsEquiv(getParent());
-        _bitVector = _diskIndex.readBitVector(*_lookupRes);
+        _bitVector = _diskIndex.readCachedBitVector(*_lookupRes);
         if (!_useBitVector || !_bitVector) {
-            _postingHandle = _diskIndex.readPostingList(*_lookupRes);
+            _postingHandle = _diskIndex.readCachedPostingList(*_lookupRes);
         }
     }
     _fetchPostingsDone = true;
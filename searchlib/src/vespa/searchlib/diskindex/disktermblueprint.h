@@ -19,8 +19,8 @@ private:
     bool                             _useBitVector;
     bool                             _fetchPostingsDone;
     bool                             _hasEquivParent;
-    index::PostingListHandle::UP     _postingHandle;
-    BitVector::UP                    _bitVector;
+    std::shared_ptr<const index::PostingListHandle> _postingHandle;
+    std::shared_ptr<const BitVector> _bitVector;
 
 public:
     /**
@@ -39,6 +39,7 @@ FieldWriter::open(const vespalib::string &prefix,
                   uint32_t minChunkDocs,
                   bool dynamicKPosOccFormat,
                   bool encode_interleaved_features,
+                  bool encode_block_max_weights,
                   const Schema &schema,
                   const uint32_t indexId,
                   const FieldLengthInfo &field_length_info,
@@ -65,7 +66,10 @@ FieldWriter::open(const vespalib::string &prefix,
     if (encode_interleaved_features) {
         params.set("interleaved_features", encode_interleaved_features);
     }
-    
+    if (encode_block_max_weights) {
+        params.set("block_max_weights", encode_block_max_weights);
+    }
+
     _dictFile = std::make_unique<PageDict4FileSeqWrite>();
     _dictFile->setParams(countParams);
 
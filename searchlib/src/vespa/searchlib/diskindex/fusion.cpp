@@ -357,7 +357,8 @@ Fusion::openFieldWriter(const SchemaUtil::IndexIterator &index, FieldWriter &wri
     vespalib::string dir = _outDir + "/" + index.getName();
 
     if (!writer.open(dir + "/", 64, 262144, _dynamicKPosIndexFormat,
-                     index.use_interleaved_features(), index.getSchema(),
+                     index.use_interleaved_features(), index.use_block_max_weights(),
+                     index.getSchema(),
                      index.getIndex(),
                      field_length_info,
                      _tuneFileIndexing._write, _fileHeaderContext)) {
@@ -0,0 +1,96 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "posting_list_cache.h"
+#include <vespa/searchlib/common/bitvector.h>
+#include <vespa/searchlib/index/postinglisthandle.h>
+#include <vespa/vespalib/stllike/cache.hpp>
+#include <cassert>
+
+namespace search::diskindex {
+
+namespace {
+
+std::atomic<uint64_t> _G_nextDiskIndexId(1);
+
+// Counters are sampled without locking, so guard against transient underflow.
+uint64_t clamped_sub(uint64_t a, uint64_t b) { return (b > a) ? 0 : (a - b); }
+
+}
+
+size_t
+PostingListCache::Value::size() const
+{
+    size_t result = 0;
+    if (posting_list) {
+        result += sizeof(index::PostingListHandle) + posting_list->_allocSize;
+    }
+    if (bit_vector) {
+        result += bit_vector->getFileBytes();
+    }
+    return result;
+}
+
+PostingListCache::BackingStore::BackingStore(size_t max_value_bytes)
+    : _max_value_bytes(max_value_bytes),
+      _posting_list_reads(0),
+      _bit_vector_reads(0)
+{
+}
+
+PostingListCache::BackingStore::~BackingStore() = default;
+
+bool
+PostingListCache::BackingStore::read(const Key &key, Value &value)
+{
+    assert(key.backing_store_file != nullptr);
+    if (key.bit_vector) {
+        _bit_vector_reads.fetch_add(1, std::memory_order_relaxed);
+        value = Value(key.backing_store_file->read_bit_vector(key));
+    } else {
+        _posting_list_reads.fetch_add(1, std::memory_order_relaxed);
+        value = Value(key.backing_store_file->read_posting_list(key));
+    }
+    // Not found (e.g. no bit vector for the word) or too large to be cached.
+    return (value.posting_list || value.bit_vector) && (value.size() <= _max_value_bytes);
+}
+
+PostingListCache::PostingListCache(size_t maxBytes)
+    : _store(maxBytes / 4),
+      _cache(_store, maxBytes),
+      _bit_vector_lookups(0)
+{
+}
+
+PostingListCache::~PostingListCache() = default;
+
+PostingListCache::Value
+PostingListCache::read(const Key &key)
+{
+    if (key.bit_vector) {
+        _bit_vector_lookups.fetch_add(1, std::memory_order_relaxed);
+    }
+    return _cache.read(key);
+}
+
+CacheStats
+PostingListCache::getCacheStats() const
+{
+    uint64_t lookups = clamped_sub(_cache.getHit() + _cache.getMiss(), _bit_vector_lookups.load(std::memory_order_relaxed));
+    uint64_t misses = _store.posting_list_reads();
+    return CacheStats(clamped_sub(lookups, misses), misses, _cache.size(), _cache.sizeBytes(), _cache.getInvalidate());
+}
+
+CacheStats
+PostingListCache::getBitVectorCacheStats() const
+{
+    uint64_t misses = _store.bit_vector_reads();
+    return CacheStats(clamped_sub(_bit_vector_lookups.load(std::memory_order_relaxed), misses), misses, 0, 0, 0);
+}
+
+uint64_t
+PostingListCache::nextDiskIndexId()
+{
+    return _G_nextDiskIndexId.fetch_add(1, std::memory_order_relaxed);
+}
+
+}
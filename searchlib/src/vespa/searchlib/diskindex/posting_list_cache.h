@@ -0,0 +1,152 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/searchlib/docstore/cachestats.h>
+#include <vespa/vespalib/stllike/cache.h>
+#include <atomic>
+#include <memory>
+
+namespace search { class BitVector; }
+namespace search::index {
+class PostingListCounts;
+class PostingListHandle;
+}
+
+namespace search::diskindex {
+
+/**
+ * Memory bounded LRU cache of posting lists and bit vectors read from
+ * disk indexes. A single instance is shared by all disk indexes (and
+ * thereby all queries) in a document db, so that hot terms are only
+ * read from disk once.
+ *
+ * Entries are keyed by (disk index id, field, word number). Each disk
+ * index instance gets a unique id when created, which makes the cache
+ * generation aware: when a disk index is replaced (e.g. after fusion)
+ * entries for the old instance are never looked up again and are
+ * evicted by the LRU policy. Cached values are immutable and shared
+ * with the blueprints using them.
+ *
+ * Missing entries are read through the disk index given in the key
+ * while holding the lock for that key, so concurrent lookups of the
+ * same term only read it from disk once. Bit vector lookups are
+ * tracked separately, as most words have no bit vector.
+ */
+class PostingListCache {
+public:
+    class IPostingListFileBacking;
+
+    struct Key {
+        uint64_t disk_index_id;
+        uint64_t word_num;
+        uint32_t index_id;
+        bool     bit_vector;
+        // Used to read a missing entry, not part of the identity of the key.
+        const IPostingListFileBacking *backing_store_file;
+        const index::PostingListCounts *counts;
+        uint64_t bit_offset;
+        Key() : disk_index_id(0), word_num(0), index_id(0), bit_vector(false),
+                backing_store_file(nullptr), counts(nullptr), bit_offset(0) {}
+        Key(uint64_t disk_index_id_in, uint32_t index_id_in, uint64_t word_num_in, bool bit_vector_in)
+            : disk_index_id(disk_index_id_in),
+              word_num(word_num_in),
+              index_id(index_id_in),
+              bit_vector(bit_vector_in),
+              backing_store_file(nullptr),
+              counts(nullptr),
+              bit_offset(0)
+        {}
+        uint32_t hash() const {
+            return (disk_index_id * 1000003u) ^ (word_num * 31u) ^ (uint64_t(index_id) << 1) ^ (bit_vector ? 1u : 0u);
+        }
+        bool operator==(const Key &rhs) const {
+            return (disk_index_id == rhs.disk_index_id) && (word_num == rhs.word_num) &&
+                   (index_id == rhs.index_id) && (bit_vector == rhs.bit_vector);
+        }
+    };
+
+    struct Value {
+        std::shared_ptr<const index::PostingListHandle> posting_list;
+        std::shared_ptr<const BitVector>                bit_vector;
+        Value() : posting_list(), bit_vector() {}
+        Value(std::shared_ptr<const index::PostingListHandle> posting_list_in)
+            : posting_list(std::move(posting_list_in)), bit_vector() {}
+        Value(std::shared_ptr<const BitVector> bit_vector_in)
+            : posting_list(), bit_vector(std::move(bit_vector_in)) {}
+        // Number of bytes owned by this value (used for memory accounting).
+        size_t size() const;
+    };
+
+    /**
+     * Interface used to read posting lists and bit vectors not found
+     * in the cache.
+     */
+    class IPostingListFileBacking {
+    public:
+        virtual ~IPostingListFileBacking() = default;
+        virtual std::shared_ptr<const index::PostingListHandle> read_posting_list(const Key &key) const = 0;
+        virtual std::shared_ptr<const BitVector> read_bit_vector(const Key &key) const = 0;
+    };
+
+private:
+    class BackingStore {
+    private:
+        size_t                _max_value_bytes;
+        std::atomic<uint64_t> _posting_list_reads;
+        std::atomic<uint64_t> _bit_vector_reads;
+    public:
+        explicit BackingStore(size_t max_value_bytes);
+        ~BackingStore();
+        bool read(const Key &key, Value &value);
+        void write(const Key &, const Value &) { }
+        void erase(const Key &) { }
+        uint64_t posting_list_reads() const { return _posting_list_reads.load(std::memory_order_relaxed); }
+        uint64_t bit_vector_reads() const { return _bit_vector_reads.load(std::memory_order_relaxed); }
+    };
+    using CacheParams = vespalib::CacheParam<
+                            vespalib::LruParam<Key, Value>,
+                            BackingStore,
+                            vespalib::zero<Key>,
+                            vespalib::size<Value>
+                        >;
+    using Cache = vespalib::cache<CacheParams>;
+
+    BackingStore          _store;
+    Cache                 _cache;
+    std::atomic<uint64_t> _bit_vector_lookups;
+
+public:
+    using SP = std::shared_ptr<PostingListCache>;
+
+    explicit PostingListCache(size_t maxBytes);
+    ~PostingListCache();
+
+    /**
+     * Returns the posting list or bit vector for the given key. Missing
+     * entries are read using the backing store file of the key and
+     * then cached. Values larger than a quarter of the capacity are
+     * returned but not cached, to avoid a single large posting list
+     * evicting all other entries.
+     */
+    Value read(const Key &key);
+
+    /**
+     * Stats for posting list lookups. Misses are reads from disk.
+     */
+    CacheStats getCacheStats() const;
+
+    /**
+     * Stats for bit vector lookups. Elements and memory usage are
+     * shared with posting lists and only reported by getCacheStats().
+     */
+    CacheStats getBitVectorCacheStats() const;
+    size_t capacityBytes() const { return _cache.capacityBytes(); }
+
+    /**
+     * Returns a new unique id to be used by a disk index instance.
+     */
+    static uint64_t nextDiskIndexId();
+};
+
+}
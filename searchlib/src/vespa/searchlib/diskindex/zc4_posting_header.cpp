@@ -16,6 +16,7 @@ Zc4PostingHeader::Zc4PostingHeader()
       _l3_skip_size(0u),
       _l4_skip_size(0u),
       _features_size(0u),
+      _block_max_size(0u),
       _last_doc_id(0)
 {
 }
@@ -34,6 +35,7 @@ Zc4PostingHeader::read(bitcompression::DecodeContext64Base &decode_context, cons
         _l3_skip_size = 0;
         _l4_skip_size = 0;
         _features_size = 0;
+        _block_max_size = 0;
         _last_doc_id = 0;
     } else {
         _doc_ids_size = decode_context.decode_exp_golomb(K_VALUE_ZCPOSTING_DOCIDSSIZE) + 1;
@@ -42,6 +44,7 @@ Zc4PostingHeader::read(bitcompression::DecodeContext64Base &decode_context, cons
         _l3_skip_size = (_l2_skip_size != 0) ? decode_context.decode_exp_golomb(K_VALUE_ZCPOSTING_L3SKIPSIZE) : 0;
         _l4_skip_size = (_l3_skip_size != 0) ? decode_context.decode_exp_golomb(K_VALUE_ZCPOSTING_L4SKIPSIZE) : 0;
         _features_size = params._encode_features ? decode_context.decode_exp_golomb(K_VALUE_ZCPOSTING_FEATURESSIZE) : 0;
+        _block_max_size = params._encode_block_max_weights ? decode_context.decode_exp_golomb(K_VALUE_ZCPOSTING_BLOCKMAXSIZE) : 0;
         _last_doc_id = params._doc_id_limit - 1 - decode_context.decode_exp_golomb(_doc_id_k);
         decode_context.align(8);
     }
@@ -79,6 +79,12 @@ Zc4PostingReader<bigEndian>::read_doc_id_and_features(DocIdAndFeatures &features
         }
         _decodeContext->readFeatures(features);
     }
+    if (_last_doc_id > 0) {
+        _block_max.check(features.doc_id(), _posting_params._encode_features ? features.max_element_weight() : 1);
+        if (_residue == 1) {
+            _block_max.check_end(_last_doc_id);
+        }
+    }
     --_residue;
 }
 
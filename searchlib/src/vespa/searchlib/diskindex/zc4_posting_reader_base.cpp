@@ -2,6 +2,7 @@
 
 #include "zc4_posting_reader_base.h"
 #include "zc4_posting_header.h"
+#include "zc_block_max_weights.h"
 #include <vespa/searchlib/index/docidandfeatures.h>
 
 namespace search::diskindex {
@@ -175,6 +176,53 @@ Zc4PostingReaderBase::L4Skip::check(const L3Skip &l3_skip, bool decode_features)
     assert(_l3_skip_pos == l3_skip.get_l3_skip_pos());
 }
 
+Zc4PostingReaderBase::BlockMax::BlockMax()
+    : _zc_buf(),
+      _last_doc_id(0),
+      _max_weight(0),
+      _active(false)
+{
+}
+
+Zc4PostingReaderBase::BlockMax::~BlockMax() = default;
+
+void
+Zc4PostingReaderBase::BlockMax::setup(DecodeContext &decode_context, uint32_t size, uint32_t prev_doc_id)
+{
+    _zc_buf.clearReserve(size);
+    if (size != 0) {
+        decode_context.readBytes(_zc_buf._valI, size);
+    }
+    _zc_buf._valE = _zc_buf._valI + size;
+    _last_doc_id = prev_doc_id;
+    _max_weight = 0;
+    _active = (size != 0);
+}
+
+void
+Zc4PostingReaderBase::BlockMax::check(uint32_t doc_id, int32_t max_element_weight)
+{
+    if (!_active) {
+        return;
+    }
+    if (doc_id > _last_doc_id) {
+        assert(_zc_buf._valI < _zc_buf._valE);
+        _last_doc_id += (_zc_buf.decode() + 1);
+        _max_weight = ZcBlockMaxWeights::decode_weight(_zc_buf.decode());
+    }
+    assert(doc_id <= _last_doc_id);
+    assert(max_element_weight <= _max_weight);
+}
+
+void
+Zc4PostingReaderBase::BlockMax::check_end(uint32_t last_doc_id)
+{
+    if (_active) {
+        assert(_last_doc_id == last_doc_id);
+        assert(_zc_buf._valI == _zc_buf._valE);
+    }
+}
+
 Zc4PostingReaderBase::Zc4PostingReaderBase(bool dynamic_k)
     : _doc_id_k(K_VALUE_ZCPOSTING_DELTA_DOCID),
       _num_docs(0),
@@ -187,6 +235,7 @@ Zc4PostingReaderBase::Zc4PostingReaderBase(bool dynamic_k)
       _l2_skip(),
       _l3_skip(),
       _l4_skip(),
+      _block_max(),
       _chunkNo(0),
       _features_size(0),
       _counts(),
@@ -253,6 +302,8 @@ Zc4PostingReaderBase::read_word_start_with_skip(DecodeContext64Base &decode_cont
     _l2_skip.setup(decode_context, header._l2_skip_size, prev_doc_id, _last_doc_id);
     _l3_skip.setup(decode_context, header._l3_skip_size, prev_doc_id, _last_doc_id);
     _l4_skip.setup(decode_context, header._l4_skip_size, prev_doc_id, _last_doc_id);
+    _block_max.setup(decode_context, header._block_max_size, prev_doc_id);
+    assert((header._block_max_size != 0) == _posting_params._encode_block_max_weights);
     if (_has_more || has_more) {
         assert(_last_doc_id == _counts._segments[_chunkNo]._lastDoc);
     }
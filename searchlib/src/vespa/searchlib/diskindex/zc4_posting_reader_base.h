@@ -90,6 +90,19 @@ protected:
         void setup(DecodeContext &decode_context, uint32_t size, uint32_t doc_id, uint32_t last_doc_id);
         void check(const L3Skip &l3_skip, bool decode_features);
     };
+    // Helper class for validating block max weights
+    class BlockMax {
+        ZcBuf _zc_buf;
+        uint32_t _last_doc_id;
+        int32_t _max_weight;
+        bool _active;
+    public:
+        BlockMax();
+        ~BlockMax();
+        void setup(DecodeContext &decode_context, uint32_t size, uint32_t prev_doc_id);
+        void check(uint32_t doc_id, int32_t max_element_weight);
+        void check_end(uint32_t last_doc_id);
+    };
     uint32_t _doc_id_k;
     uint32_t _num_docs;      // Documents in chunk or word
     search::ComprFileReadContext _readContext;
@@ -102,6 +115,7 @@ protected:
     L2Skip _l2_skip;
     L3Skip _l3_skip;
     L4Skip _l4_skip;
+    BlockMax _block_max;
 
     uint64_t _numWords;     // Number of words in file
     uint32_t _chunkNo;      // Chunk number
@@ -53,12 +53,16 @@ Zc4PostingWriter<bigEndian>::flush_word_with_skip(bool hasMore)
     }
 
     calc_skip_info(_encode_features != nullptr);
+    if (_encode_block_max_weights) {
+        calc_block_max_weights();
+    }
 
     uint32_t docIdsSize = _zcDocIds.size();
     uint32_t l1SkipSize = _l1Skip.size();
     uint32_t l2SkipSize = _l2Skip.size();
     uint32_t l3SkipSize = _l3Skip.size();
     uint32_t l4SkipSize = _l4Skip.size();
+    uint32_t blockMaxSize = _blockMax.size();
 
     e.encodeExpGolomb(docIdsSize - 1, K_VALUE_ZCPOSTING_DOCIDSSIZE);
     e.encodeExpGolomb(l1SkipSize, K_VALUE_ZCPOSTING_L1SKIPSIZE);
@@ -74,6 +78,9 @@ Zc4PostingWriter<bigEndian>::flush_word_with_skip(bool hasMore)
     if (_encode_features != nullptr) {
         e.encodeExpGolomb(_featureOffset, K_VALUE_ZCPOSTING_FEATURESSIZE);
     }
+    if (_encode_block_max_weights) {
+        e.encodeExpGolomb(blockMaxSize, K_VALUE_ZCPOSTING_BLOCKMAXSIZE);
+    }
 
     // Encode last document id in chunk or word.
     if (_dynamicK) {
@@ -118,6 +125,12 @@ Zc4PostingWriter<bigEndian>::flush_word_with_skip(bool hasMore)
                     0,
                     l4SkipSize * 8);
     }
+    if (blockMaxSize > 0) {
+        uint8_t *blockMax = _blockMax._mallocStart;
+        e.writeBits(reinterpret_cast<const uint64_t *>(blockMax),
+                    0,
+                    blockMaxSize * 8);
+    }
 
     // Write features
     e.writeBits(_featureWriteContext.getComprBuf(), 0, _featureOffset);
@@ -150,10 +163,10 @@ Zc4PostingWriter<bigEndian>::write_docid_and_features(const DocIdAndFeatures &fe
         uint64_t featureSize = writeOffset - _featureOffset;
         assert(static_cast<uint32_t>(featureSize) == featureSize);
         _docIds.emplace_back(features.doc_id(), features.field_length(), features.num_occs(),
-                             static_cast<uint32_t>(featureSize));
+                             static_cast<uint32_t>(featureSize), features.max_element_weight());
         _featureOffset = writeOffset;
     } else {
-        _docIds.emplace_back(features.doc_id(), features.field_length(), features.num_occs(), 0);
+        _docIds.emplace_back(features.doc_id(), features.field_length(), features.num_occs(), 0, features.max_element_weight());
     }
 }
 
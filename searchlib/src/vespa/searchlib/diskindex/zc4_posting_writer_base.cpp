@@ -1,6 +1,8 @@
 // Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "zc4_posting_writer_base.h"
+#include "zc_block_max_weights.h"
+#include <algorithm>
 #include <vespa/searchlib/index/postinglistcounts.h>
 
 using search::index::PostingListCounts;
@@ -206,11 +208,13 @@ Zc4PostingWriterBase::Zc4PostingWriterBase(PostingListCounts &counts)
       _writePos(0),
       _dynamicK(false),
       _encode_interleaved_features(false),
+      _encode_block_max_weights(false),
       _zcDocIds(),
       _l1Skip(),
       _l2Skip(),
       _l3Skip(),
       _l4Skip(),
+      _blockMax(),
       _numWords(0),
       _counts(counts),
       _writeContext(sizeof(uint64_t)),
@@ -223,6 +227,7 @@ Zc4PostingWriterBase::Zc4PostingWriterBase(PostingListCounts &counts)
     _l2Skip.maybeExpand();
     _l3Skip.maybeExpand();
     _l4Skip.maybeExpand();
+    _blockMax.maybeExpand();
 }
 
 Zc4PostingWriterBase::~Zc4PostingWriterBase()
@@ -273,6 +278,25 @@ Zc4PostingWriterBase::calc_skip_info(bool encode_features)
     l4_skip_encoder.write_partial_skip(_l4Skip, doc_id_encoder.get_doc_id());
 }
 
+void
+Zc4PostingWriterBase::calc_block_max_weights()
+{
+    uint32_t prev_doc_id = _counts._segments.empty() ? 0u : _counts._segments.back()._lastDoc;
+    uint32_t block_docs = 0;
+    int32_t block_max_weight = std::numeric_limits<int32_t>::min();
+    for (const auto &doc_id_and_feature_size : _docIds) {
+        block_max_weight = std::max(block_max_weight, doc_id_and_feature_size._max_element_weight);
+        if (++block_docs == ZcBlockMaxWeights::block_docs || &doc_id_and_feature_size == &_docIds.back()) {
+            uint32_t doc_id = doc_id_and_feature_size._doc_id;
+            _blockMax.encode(doc_id - prev_doc_id - 1);
+            _blockMax.encode(ZcBlockMaxWeights::encode_weight(block_max_weight));
+            prev_doc_id = doc_id;
+            block_docs = 0;
+            block_max_weight = std::numeric_limits<int32_t>::min();
+        }
+    }
+}
+
 void
 Zc4PostingWriterBase::clear_skip_info()
 {
@@ -281,6 +305,7 @@ Zc4PostingWriterBase::clear_skip_info()
     _l2Skip.clear();
     _l3Skip.clear();
     _l4Skip.clear();
+    _blockMax.clear();
 }
 
 void
@@ -290,6 +315,7 @@ Zc4PostingWriterBase::set_posting_list_params(const PostingListParams &params)
     params.get("minChunkDocs", _minChunkDocs);
     params.get("minSkipDocs", _minSkipDocs);
     params.get("interleaved_features", _encode_interleaved_features);
+    params.get("block_max_weights", _encode_block_max_weights);
 }
 
 }
@@ -0,0 +1,42 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace search::diskindex {
+
+/*
+ * Encoding of block max weights in zc posting lists.
+ *
+ * When enabled, each chunk with skip info gets a block max section
+ * after the L4 skip info. The section has one entry per block of
+ * ZcBlockMaxWeights::block_docs documents (the last block might be
+ * partial), containing the delta (minus one) from the last document
+ * id in the previous block to the last document id in this block,
+ * followed by the max element weight in the block. Both values are
+ * zc encoded. Weights are zigzag encoded and clamped to 31 bits, the
+ * positive saturation value is decoded as max int32_t to keep it a
+ * valid upper bound.
+ */
+struct ZcBlockMaxWeights {
+    static constexpr uint32_t block_docs = 16;
+    static constexpr int32_t min_weight = -(1 << 30);
+    static constexpr int32_t max_weight = (1 << 30) - 1;
+
+    static uint32_t encode_weight(int32_t weight) {
+        if (weight < min_weight) {
+            weight = min_weight;
+        } else if (weight > max_weight) {
+            weight = max_weight;
+        }
+        return (static_cast<uint32_t>(weight) << 1) ^ static_cast<uint32_t>(weight >> 31);
+    }
+    static int32_t decode_weight(uint32_t val) {
+        int32_t weight = static_cast<int32_t>(val >> 1) ^ -static_cast<int32_t>(val & 1);
+        return (weight == max_weight) ? std::numeric_limits<int32_t>::max() : weight;
+    }
+};
+
+}
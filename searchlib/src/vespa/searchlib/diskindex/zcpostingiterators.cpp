@@ -189,6 +189,7 @@ ZcRareWordPostingIterator<bigEndian, dynamic_k>::readWordStart(uint32_t docIdLim
 
 ZcPostingIteratorBase::ZcPostingIteratorBase(const TermFieldMatchDataArray &matchData, Position start, uint32_t docIdLimit,
                                              bool decode_normal_features, bool decode_interleaved_features,
+                                             bool decode_block_max_weights,
                                              bool unpack_normal_features, bool unpack_interleaved_features)
     : ZcIteratorBase(matchData, start, docIdLimit),
       _valI(nullptr),
@@ -199,10 +200,12 @@ ZcPostingIteratorBase::ZcPostingIteratorBase(const TermFieldMatchDataArray &matc
       _l3(),
       _l4(),
       _chunk(),
+      _blockMax(),
       _featuresSize(0),
       _hasMore(false),
       _decode_normal_features(decode_normal_features),
       _decode_interleaved_features(decode_interleaved_features),
+      _decode_block_max_weights(decode_block_max_weights),
       _unpack_normal_features(unpack_normal_features),
       _unpack_interleaved_features(unpack_interleaved_features),
       _chunkNo(0),
@@ -211,6 +214,18 @@ ZcPostingIteratorBase::ZcPostingIteratorBase(const TermFieldMatchDataArray &matc
 {
 }
 
+bool
+ZcPostingIteratorBase::get_block_max_weight(uint32_t docid, int32_t &max_weight, uint32_t &last_docid)
+{
+    // Element weights are only exposed in match data when normal features are unpacked.
+    if (!_decode_block_max_weights || !_unpack_normal_features || !_blockMax.seek(docid)) {
+        return false;
+    }
+    max_weight = _blockMax._maxWeight;
+    last_docid = _blockMax._lastDocId;
+    return true;
+}
+
 template <bool bigEndian>
 ZcPostingIterator<bigEndian>::
 ZcPostingIterator(uint32_t minChunkDocs,
@@ -219,9 +234,11 @@ ZcPostingIterator(uint32_t minChunkDocs,
                   const search::fef::TermFieldMatchDataArray &matchData,
                   Position start, uint32_t docIdLimit,
                   bool decode_normal_features, bool decode_interleaved_features,
+                  bool decode_block_max_weights,
                   bool unpack_normal_features, bool unpack_interleaved_features)
     : ZcPostingIteratorBase(matchData, start, docIdLimit,
                             decode_normal_features, decode_interleaved_features,
+                            decode_block_max_weights,
                             unpack_normal_features, unpack_interleaved_features),
       _decodeContext(nullptr),
       _minChunkDocs(minChunkDocs),
@@ -287,6 +304,11 @@ ZcPostingIterator<bigEndian>::readWordStart(uint32_t docIdLimit)
         UC64_DECODEEXPGOLOMB_NS(o, K_VALUE_ZCPOSTING_FEATURESSIZE, EC);
         _featuresSize = val64;
     }
+    uint32_t blockMaxSize = 0;
+    if (_decode_block_max_weights) {
+        UC64_DECODEEXPGOLOMB_NS(o, K_VALUE_ZCPOSTING_BLOCKMAXSIZE, EC);
+        blockMaxSize = val64;
+    }
     if (_dynamicK) {
         UC64_DECODEEXPGOLOMB_NS(o, _docIdK, EC);
     } else {
@@ -318,6 +340,7 @@ ZcPostingIterator<bigEndian>::readWordStart(uint32_t docIdLimit)
     _l2.postSetup(_l1);
     _l3.postSetup(_l2);
     _l4.postSetup(_l3);
+    _blockMax.setup(prevDocId, bcompr, blockMaxSize);
     d.setByteCompr(bcompr);
     _hasMore = hasMore;
     // Save information about start of next chunk
@@ -2,9 +2,11 @@
 
 #pragma once
 
+#include "zc_block_max_weights.h"
 #include <vespa/searchlib/index/postinglistfile.h>
 #include <vespa/searchlib/bitcompression/compression.h>
 #include <vespa/searchlib/queryeval/iterators.h>
+#include <vespa/searchlib/queryeval/iblockmaxweights.h>
 #include <vespa/fastos/dynamiclibrary.h>
 
 namespace search::diskindex {
@@ -135,7 +137,8 @@ public:
     void readWordStart(uint32_t docIdLimit) override;
 };
 
-class ZcPostingIteratorBase : public ZcIteratorBase
+class ZcPostingIteratorBase : public ZcIteratorBase,
+                              public queryeval::IBlockMaxWeights
 {
 protected:
     const uint8_t *_valI;     // docid deltas
@@ -268,15 +271,54 @@ protected:
         }
     };
 
+    // Helper class for block max weights, only moving forward within a chunk
+    class BlockMax {
+    public:
+        const uint8_t *_valI;
+        const uint8_t *_valE;
+        uint32_t _lastDocId;
+        int32_t _maxWeight;
+
+        BlockMax()
+            : _valI(nullptr),
+              _valE(nullptr),
+              _lastDocId(0),
+              _maxWeight(0)
+        {
+        }
+
+        void setup(uint32_t prevDocId, const uint8_t *&bcompr, uint32_t blockMaxSize) {
+            _valI = bcompr;
+            bcompr += blockMaxSize;
+            _valE = bcompr;
+            _lastDocId = prevDocId;
+            _maxWeight = 0;
+        }
+        bool seek(uint32_t docId) {
+            while (__builtin_expect(docId > _lastDocId, false)) {
+                if (_valI >= _valE) {
+                    return false;
+                }
+                uint32_t encodedWeight;
+                ZCDECODE(_valI, _lastDocId += 1 +);
+                ZCDECODE(_valI, encodedWeight =);
+                _maxWeight = ZcBlockMaxWeights::decode_weight(encodedWeight);
+            }
+            return true;
+        }
+    };
+
     L1Skip _l1;
     L2Skip _l2;
     L3Skip _l3;
     L4Skip _l4;
     ChunkSkip _chunk;
+    BlockMax _blockMax;
     uint64_t _featuresSize;
     bool     _hasMore;
     bool     _decode_normal_features;
     bool     _decode_interleaved_features;
+    bool     _decode_block_max_weights;
     bool     _unpack_normal_features;
     bool     _unpack_interleaved_features;
     uint32_t _chunkNo;
@@ -301,8 +343,9 @@ protected:
     void doSeek(uint32_t docId) override;
 public:
     ZcPostingIteratorBase(const fef::TermFieldMatchDataArray &matchData, Position start, uint32_t docIdLimit,
-                          bool decode_normal_features, bool decode_interleaved_features,
+                          bool decode_normal_features, bool decode_interleaved_features, bool decode_block_max_weights,
                           bool unpack_normal_features, bool unpack_interleaved_features);
+    bool get_block_max_weight(uint32_t docid, int32_t &max_weight, uint32_t &last_docid) override;
 };
 
 template <bool bigEndian>
@@ -330,7 +373,7 @@ public:
 
     ZcPostingIterator(uint32_t minChunkDocs, bool dynamicK, const PostingListCounts &counts,
                       const search::fef::TermFieldMatchDataArray &matchData, Position start, uint32_t docIdLimit,
-                      bool decode_normal_features, bool decode_interleaved_features,
+                      bool decode_normal_features, bool decode_interleaved_features, bool decode_block_max_weights,
                       bool unpack_normal_features, bool unpack_interleaved_features);
 
 
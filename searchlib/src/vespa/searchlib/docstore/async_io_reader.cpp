@@ -0,0 +1,486 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "async_io_reader.h"
+#include <vespa/vespalib/util/count_down_latch.h>
+#include <vespa/vespalib/util/error.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#define SEARCH_DOCSTORE_HAS_IO_URING 1
+#endif
+
+#include <vespa/log/log.h>
+LOG_SETUP(".search.docstore.async_io_reader");
+
+using vespalib::make_string;
+
+namespace search {
+
+namespace {
+
+ssize_t
+preadFully(int fd, void * dst, size_t size, uint64_t offset)
+{
+    size_t done = 0;
+    while (done < size) {
+        ssize_t r = ::pread(fd, static_cast<char *>(dst) + done, size - done, offset + done);
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -errno;
+        }
+        if (r == 0) {
+            break;
+        }
+        done += r;
+    }
+    return done;
+}
+
+}
+
+#ifdef SEARCH_DOCSTORE_HAS_IO_URING
+
+/**
+ * Minimal io_uring instance using the raw system calls. Only used by a
+ * single thread at a time.
+ */
+class AsyncIoReader::IoUring {
+public:
+    explicit IoUring(uint32_t entries);
+    IoUring(const IoUring &) = delete;
+    IoUring & operator=(const IoUring &) = delete;
+    ~IoUring();
+    uint32_t entries() const { return _sqEntries; }
+    void push(const Request & request, iovec * iov, uint64_t userData);
+    /**
+     * Submits pushed reads and waits for at least minComplete completions.
+     * Returns 0 or -errno.
+     */
+    int submitAndWait(uint32_t minComplete);
+    /**
+     * Takes back reads that are pushed but not yet submitted to the kernel.
+     * Returns the number of reads taken back.
+     */
+    uint32_t cancelUnsubmitted();
+    /**
+     * Waits for at least minComplete completions without submitting.
+     * Returns 0 or -errno.
+     */
+    int wait(uint32_t minComplete);
+    template <typename Func>
+    uint32_t reap(Func func);
+private:
+    void cleanup();
+    int            _fd;
+    void         * _sqRing;
+    size_t         _sqRingSize;
+    void         * _cqRing;
+    size_t         _cqRingSize;
+    io_uring_sqe * _sqes;
+    size_t         _sqesSize;
+    uint32_t     * _sqTail;
+    uint32_t     * _sqArray;
+    uint32_t       _sqMask;
+    uint32_t       _sqEntries;
+    uint32_t       _unsubmitted;
+    uint32_t     * _cqHead;
+    uint32_t     * _cqTail;
+    uint32_t       _cqMask;
+    io_uring_cqe * _cqes;
+};
+
+namespace {
+
+template <typename T>
+T *
+ringPtr(void * ring, uint32_t offset)
+{
+    return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+}
+
+}
+
+AsyncIoReader::IoUring::IoUring(uint32_t entries)
+    : _fd(-1),
+      _sqRing(MAP_FAILED),
+      _sqRingSize(0),
+      _cqRing(MAP_FAILED),
+      _cqRingSize(0),
+      _sqes(static_cast<io_uring_sqe *>(MAP_FAILED)),
+      _sqesSize(0),
+      _sqTail(nullptr),
+      _sqArray(nullptr),
+      _sqMask(0),
+      _sqEntries(0),
+      _unsubmitted(0),
+      _cqHead(nullptr),
+      _cqTail(nullptr),
+      _cqMask(0),
+      _cqes(nullptr)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    _fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (_fd < 0) {
+        throw std::runtime_error(make_string("io_uring_setup(%u) failed: %s", entries, vespalib::getLastErrorString().c_str()));
+    }
+    _sqEntries = params.sq_entries;
+    _sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    _cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    bool singleMmap = false;
+#ifdef IORING_FEAT_SINGLE_MMAP
+    singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+#endif
+    if (singleMmap) {
+        _sqRingSize = std::max(_sqRingSize, _cqRingSize);
+        _cqRingSize = 0;
+    }
+    _sqRing = mmap(nullptr, _sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+    if ((_sqRing != MAP_FAILED) && ! singleMmap) {
+        _cqRing = mmap(nullptr, _cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_CQ_RING);
+    }
+    if ((_sqRing != MAP_FAILED) && (singleMmap || (_cqRing != MAP_FAILED))) {
+        _sqes = static_cast<io_uring_sqe *>(mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                                 _fd, IORING_OFF_SQES));
+    }
+    if (_sqes == MAP_FAILED) {
+        vespalib::string error = vespalib::getLastErrorString();
+        cleanup();
+        throw std::runtime_error(make_string("Failed mapping io_uring rings: %s", error.c_str()));
+    }
+    void * cqRing = singleMmap ? _sqRing : _cqRing;
+    _sqTail = ringPtr<uint32_t>(_sqRing, params.sq_off.tail);
+    _sqArray = ringPtr<uint32_t>(_sqRing, params.sq_off.array);
+    _sqMask = *ringPtr<uint32_t>(_sqRing, params.sq_off.ring_mask);
+    _cqHead = ringPtr<uint32_t>(cqRing, params.cq_off.head);
+    _cqTail = ringPtr<uint32_t>(cqRing, params.cq_off.tail);
+    _cqMask = *ringPtr<uint32_t>(cqRing, params.cq_off.ring_mask);
+    _cqes = ringPtr<io_uring_cqe>(cqRing, params.cq_off.cqes);
+}
+
+AsyncIoReader::IoUring::~IoUring()
+{
+    cleanup();
+}
+
+void
+AsyncIoReader::IoUring::cleanup()
+{
+    if (_sqes != MAP_FAILED) {
+        munmap(_sqes, _sqesSize);
+    }
+    if (_cqRing != MAP_FAILED) {
+        munmap(_cqRing, _cqRingSize);
+    }
+    if (_sqRing != MAP_FAILED) {
+        munmap(_sqRing, _sqRingSize);
+    }
+    if (_fd >= 0) {
+        close(_fd);
+    }
+    _sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+    _cqRing = MAP_FAILED;
+    _sqRing = MAP_FAILED;
+    _fd = -1;
+}
+
+void
+AsyncIoReader::IoUring::push(const Request & request, iovec * iov, uint64_t userData)
+{
+    iov->iov_base = request.dst;
+    iov->iov_len = request.size;
+    // Only this thread produces submissions, the kernel only reads the tail.
+    uint32_t tail = *_sqTail;
+    uint32_t index = tail & _sqMask;
+    io_uring_sqe & sqe = _sqes[index];
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_READV;
+    sqe.fd = request.fd;
+    sqe.off = request.offset;
+    sqe.addr = reinterpret_cast<uint64_t>(iov);
+    sqe.len = 1;
+    sqe.user_data = userData;
+    _sqArray[index] = index;
+    __atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+    ++_unsubmitted;
+}
+
+int
+AsyncIoReader::IoUring::submitAndWait(uint32_t minComplete)
+{
+    for (;;) {
+        int r = syscall(__NR_io_uring_enter, _fd, _unsubmitted, minComplete, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (r >= 0) {
+            _unsubmitted -= std::min(uint32_t(r), _unsubmitted);
+            return 0;
+        }
+        if (errno != EINTR) {
+            return -errno;
+        }
+    }
+}
+
+uint32_t
+AsyncIoReader::IoUring::cancelUnsubmitted()
+{
+    // The kernel only reads the tail when entered, and only this thread enters.
+    uint32_t cancelled = _unsubmitted;
+    __atomic_store_n(_sqTail, *_sqTail - cancelled, __ATOMIC_RELEASE);
+    _unsubmitted = 0;
+    return cancelled;
+}
+
+int
+AsyncIoReader::IoUring::wait(uint32_t minComplete)
+{
+    for (;;) {
+        int r = syscall(__NR_io_uring_enter, _fd, 0, minComplete, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (r >= 0) {
+            return 0;
+        }
+        if ((errno != EINTR) && (errno != EAGAIN) && (errno != EBUSY)) {
+            return -errno;
+        }
+    }
+}
+
+template <typename Func>
+uint32_t
+AsyncIoReader::IoUring::reap(Func func)
+{
+    // Only this thread consumes completions, the kernel only reads the head.
+    uint32_t head = *_cqHead;
+    uint32_t tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+    uint32_t count = 0;
+    for (; head != tail; ++head, ++count) {
+        const io_uring_cqe & cqe = _cqes[head & _cqMask];
+        func(cqe.user_data, cqe.res);
+    }
+    __atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+    return count;
+}
+
+bool
+AsyncIoReader::ioUringSupported()
+{
+    static const bool supported = []() {
+        try {
+            IoUring ring(2);
+            return true;
+        } catch (const std::runtime_error & e) {
+            LOG(info, "io_uring is not available, falling back to reading with threads: %s", e.what());
+            return false;
+        }
+    }();
+    return supported;
+}
+
+#else
+
+class AsyncIoReader::IoUring {
+};
+
+bool
+AsyncIoReader::ioUringSupported()
+{
+    return false;
+}
+
+#endif
+
+AsyncIoReader::AsyncIoReader(uint32_t queueDepth, uint32_t numFallbackThreads, bool allowIoUring)
+    : _queueDepth(std::max(1u, queueDepth)),
+      _useIoUring(allowIoUring && ioUringSupported()),
+      _lock(),
+      _rings(),
+      _fallbackExecutor(),
+      _stats()
+{
+    if ( ! _useIoUring && (numFallbackThreads > 0)) {
+        _fallbackExecutor = std::make_unique<vespalib::ThreadStackExecutor>(numFallbackThreads, 128 * 1024);
+    }
+    LOG(debug, "Reading with %s, queue depth %u", (_useIoUring ? "io_uring" : "threads"), _queueDepth);
+}
+
+AsyncIoReader::~AsyncIoReader() = default;
+
+AsyncReadStats
+AsyncIoReader::getStats() const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    return _stats;
+}
+
+std::unique_ptr<AsyncIoReader::IoUring>
+AsyncIoReader::acquireRing()
+{
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if ( ! _rings.empty()) {
+            std::unique_ptr<IoUring> ring = std::move(_rings.back());
+            _rings.pop_back();
+            return ring;
+        }
+    }
+    return std::make_unique<IoUring>(_queueDepth);
+}
+
+void
+AsyncIoReader::releaseRing(std::unique_ptr<IoUring> ring)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _rings.push_back(std::move(ring));
+}
+
+void
+AsyncIoReader::completeRead(Request & request)
+{
+    if ((request.result >= 0) && (size_t(request.result) < request.size)) {
+        ssize_t rest = preadFully(request.fd, static_cast<char *>(request.dst) + request.result,
+                                  request.size - request.result, request.offset + request.result);
+        request.result = (rest < 0) ? rest : request.result + rest;
+    }
+}
+
+void
+AsyncIoReader::read(std::vector<Request> & requests)
+{
+    if (requests.empty()) {
+        return;
+    }
+    AsyncReadStats stats;
+    stats.batches = 1;
+    stats.reads = requests.size();
+    if (_useIoUring) {
+        readWithIoUring(requests, stats);
+    } else {
+        readWithThreads(requests, stats);
+    }
+    std::lock_guard<std::mutex> guard(_lock);
+    _stats += stats;
+}
+
+#ifdef SEARCH_DOCSTORE_HAS_IO_URING
+
+void
+AsyncIoReader::readWithIoUring(std::vector<Request> & requests, AsyncReadStats & stats)
+{
+    std::unique_ptr<IoUring> ring;
+    try {
+        ring = acquireRing();
+    } catch (const std::runtime_error & e) {
+        LOG(warning, "Failed creating io_uring, reading with threads instead: %s", e.what());
+        readWithThreads(requests, stats);
+        return;
+    }
+    const uint32_t maxInFlight = std::min(_queueDepth, ring->entries());
+    std::vector<iovec> iovecs(requests.size());
+    size_t next = 0;
+    size_t completed = 0;
+    uint32_t inFlight = 0;
+    while (completed < requests.size()) {
+        bool pushed = false;
+        while ((next < requests.size()) && (inFlight < maxInFlight)) {
+            ring->push(requests[next], &iovecs[next], next);
+            ++next;
+            ++inFlight;
+            pushed = true;
+        }
+        if (pushed) {
+            stats.sampleQueueDepth(inFlight);
+        }
+        int err = ring->submitAndWait(1);
+        if ((err != 0) && (err != -EAGAIN) && (err != -EBUSY)) {
+            inFlight -= ring->cancelUnsubmitted();
+            int drainErr = drainRing(*ring, inFlight, requests);
+            if (drainErr != 0) {
+                // Reads may still be in flight into the request buffers, so the ring can not
+                // be unmapped or reused. It is intentionally leaked.
+                ring.release();
+                throw std::runtime_error(make_string("io_uring_enter failed: %s, and waiting for submitted reads failed: %s",
+                                                     vespalib::getErrorString(-err).c_str(),
+                                                     vespalib::getErrorString(-drainErr).c_str()));
+            }
+            LOG(warning, "io_uring_enter failed, reading with pread instead: %s", vespalib::getErrorString(-err).c_str());
+            ring.reset();
+            readWithThreads(requests, stats);
+            return;
+        }
+        uint32_t reaped = ring->reap([&requests](uint64_t userData, int32_t res) {
+            requests[userData].result = res;
+        });
+        completed += reaped;
+        inFlight -= reaped;
+    }
+    releaseRing(std::move(ring));
+    for (Request & request : requests) {
+        completeRead(request);
+    }
+}
+
+int
+AsyncIoReader::drainRing(IoUring & ring, uint32_t inFlight, std::vector<Request> & requests)
+{
+    while (inFlight > 0) {
+        int err = ring.wait(inFlight);
+        if (err != 0) {
+            return err;
+        }
+        inFlight -= ring.reap([&requests](uint64_t userData, int32_t res) {
+            requests[userData].result = res;
+        });
+    }
+    return 0;
+}
+
+#else
+
+void
+AsyncIoReader::readWithIoUring(std::vector<Request> & requests, AsyncReadStats & stats)
+{
+    readWithThreads(requests, stats);
+}
+
+#endif
+
+void
+AsyncIoReader::readWithThreads(std::vector<Request> & requests, AsyncReadStats & stats)
+{
+    if ( ! _fallbackExecutor || (requests.size() == 1)) {
+        stats.sampleQueueDepth(1);
+        for (Request & request : requests) {
+            request.result = preadFully(request.fd, request.dst, request.size, request.offset);
+        }
+        return;
+    }
+    stats.sampleQueueDepth(std::min(requests.size(), _fallbackExecutor->getNumThreads()));
+    vespalib::CountDownLatch latch(requests.size());
+    for (Request & request : requests) {
+        auto task = vespalib::makeLambdaTask([&request, &latch]() {
+            request.result = preadFully(request.fd, request.dst, request.size, request.offset);
+            latch.countDown();
+        });
+        task = _fallbackExecutor->execute(std::move(task));
+        if (task) {
+            task->run();
+        }
+    }
+    latch.await();
+}
+
+}
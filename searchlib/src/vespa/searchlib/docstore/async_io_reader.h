@@ -0,0 +1,76 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "async_read_stats.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <sys/types.h>
+
+namespace vespalib { class ThreadStackExecutor; }
+
+namespace search {
+
+/**
+ * Issues a batch of positioned reads concurrently and waits for all of them
+ * to complete. Uses io_uring when supported by the running kernel, with at
+ * most queueDepth reads in flight per batch. Otherwise the reads are done
+ * with pread by a pool of threads.
+ *
+ * Several threads may read batches at the same time, each batch then uses
+ * its own io_uring instance taken from a pool.
+ */
+class AsyncIoReader {
+public:
+    struct Request {
+        int      fd;
+        uint64_t offset;
+        size_t   size;
+        void   * dst;
+        ssize_t  result; // Number of bytes read, or -errno on failure.
+        Request(int fd_in, uint64_t offset_in, size_t size_in, void * dst_in)
+            : fd(fd_in), offset(offset_in), size(size_in), dst(dst_in), result(0)
+        { }
+    };
+
+    AsyncIoReader(uint32_t queueDepth, uint32_t numFallbackThreads, bool allowIoUring = true);
+    ~AsyncIoReader();
+
+    /**
+     * Reads all requests and sets their result. Short reads are completed
+     * with pread, so a result below the requested size means end of file.
+     */
+    void read(std::vector<Request> & requests);
+
+    bool usesIoUring() const { return _useIoUring; }
+    uint32_t getQueueDepth() const { return _queueDepth; }
+    AsyncReadStats getStats() const;
+
+    /**
+     * Returns true if io_uring can be used in this process.
+     */
+    static bool ioUringSupported();
+private:
+    class IoUring;
+
+    std::unique_ptr<IoUring> acquireRing();
+    void releaseRing(std::unique_ptr<IoUring> ring);
+    void readWithIoUring(std::vector<Request> & requests, AsyncReadStats & stats);
+    /**
+     * Waits until the given number of submitted reads have completed.
+     * Returns 0 or -errno.
+     */
+    static int drainRing(IoUring & ring, uint32_t inFlight, std::vector<Request> & requests);
+    void readWithThreads(std::vector<Request> & requests, AsyncReadStats & stats);
+    static void completeRead(Request & request);
+
+    const uint32_t                                 _queueDepth;
+    bool                                           _useIoUring;
+    mutable std::mutex                             _lock;
+    std::vector<std::unique_ptr<IoUring>>          _rings;
+    std::unique_ptr<vespalib::ThreadStackExecutor> _fallbackExecutor;
+    AsyncReadStats                                 _stats;
+};
+
+}
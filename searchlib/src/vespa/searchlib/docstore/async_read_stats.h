@@ -0,0 +1,49 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace search {
+
+/**
+ * Statistics for batched asynchronous reads done by a data store.
+ * Queue depth is sampled each time reads are submitted.
+ */
+struct AsyncReadStats {
+    uint64_t batches;
+    uint64_t reads;
+    uint64_t queueDepthSum;
+    uint64_t queueDepthSamples;
+    uint32_t maxQueueDepth;
+
+    AsyncReadStats()
+        : batches(0),
+          reads(0),
+          queueDepthSum(0),
+          queueDepthSamples(0),
+          maxQueueDepth(0)
+    { }
+
+    void sampleQueueDepth(uint32_t queueDepth) {
+        queueDepthSum += queueDepth;
+        ++queueDepthSamples;
+        maxQueueDepth = std::max(maxQueueDepth, queueDepth);
+    }
+
+    double avgQueueDepth() const {
+        return (queueDepthSamples > 0) ? double(queueDepthSum) / queueDepthSamples : 0.0;
+    }
+
+    AsyncReadStats & operator+=(const AsyncReadStats &rhs) {
+        batches += rhs.batches;
+        reads += rhs.reads;
+        queueDepthSum += rhs.queueDepthSum;
+        queueDepthSamples += rhs.queueDepthSamples;
+        maxQueueDepth = std::max(maxQueueDepth, rhs.maxQueueDepth);
+        return *this;
+    }
+};
+
+}
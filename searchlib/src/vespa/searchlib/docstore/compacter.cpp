@@ -3,6 +3,7 @@
 #include "compacter.h"
 #include "logdatastore.h"
 #include <vespa/vespalib/util/array.hpp>
+#include <thread>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".searchlib.docstore.compacter");
@@ -28,6 +29,7 @@ BucketCompacter::BucketCompacter(size_t maxSignificantBucketBits, const Compress
     _maxBucketGuardDuration(vespalib::duration::zero()),
     _lastSample(),
     _lock(),
+    _writeLock(),
     _backingMemory(Alloc::alloc(0x40000000), &_lock),
     _tmpStore(),
     _lidGuard(ds.getLidReadGuard()),
@@ -48,11 +50,12 @@ BucketCompacter::getDestinationId(const LockGuard & guard) const {
 void
 BucketCompacter::write(LockGuard guard, uint32_t chunkId, uint32_t lid, const void *buffer, size_t sz)
 {
+    guard.unlock();
+    std::lock_guard<std::mutex> writeGuard(_writeLock);
     if (_writeCount++ == 0) {
         _bucketizerGuard = _bucketizer.getGuard();
         _lastSample = vespalib::steady_clock::now();
     }
-    guard.unlock();
     BucketId bucketId = (sz > 0) ? _bucketizer.getBucketOf(_bucketizerGuard, lid) : BucketId();
     uint64_t sortableBucketId = bucketId.toKey();
     _tmpStore[(sortableBucketId >> _unSignificantBucketBits) % _tmpStore.size()].add(bucketId, chunkId, lid, buffer, sz);
@@ -105,4 +108,51 @@ BucketCompacter::write(BucketId bucketId, uint32_t chunkId, uint32_t lid, const
     }
 }
 
+CompactionThrottler::CompactionThrottler(uint64_t nameId, uint32_t numChunks, uint32_t numThreads, uint64_t maxBytesPerSecond)
+    : _nameId(nameId),
+      _numChunks(numChunks),
+      _numThreads(numThreads),
+      _maxBytesPerSecond(maxBytesPerSecond),
+      _start(vespalib::steady_clock::now()),
+      _lock(),
+      _nextRead(_start),
+      _bytesRead(0),
+      _compactedChunks(0)
+{
+}
+
+CompactionThrottler::~CompactionThrottler() = default;
+
+void
+CompactionThrottler::beforeRead(size_t sz)
+{
+    if (_maxBytesPerSecond > 0) {
+        vespalib::steady_time readAt;
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            // No credit is given for idle time, so reads are never bursted above the budget.
+            readAt = std::max(_nextRead, vespalib::steady_clock::now());
+            _nextRead = readAt + vespalib::from_s(double(sz) / _maxBytesPerSecond);
+        }
+        std::this_thread::sleep_until(readAt);
+    }
+    _bytesRead += sz;
+}
+
+void
+CompactionThrottler::updateProgress()
+{
+    _compactedChunks++;
+}
+
+DataStoreCompactionStats
+CompactionThrottler::getStats() const
+{
+    double elapsed = vespalib::to_s(vespalib::steady_clock::now() - _start);
+    uint64_t bytesRead = _bytesRead.load(std::memory_order_relaxed);
+    return DataStoreCompactionStats(true, _nameId, _numChunks, _compactedChunks.load(std::memory_order_relaxed),
+                                    _numThreads, bytesRead, (elapsed > 0.0) ? bytesRead / elapsed : 0.0,
+                                    _maxBytesPerSecond);
+}
+
 }
@@ -2,9 +2,12 @@
 
 #pragma once
 
+#include "data_store_compaction_stats.h"
 #include "filechunk.h"
 #include "storebybucket.h"
 #include <vespa/vespalib/data/memorydatastore.h>
+#include <atomic>
+#include <mutex>
 
 namespace search { class LogDataStore; }
 
@@ -28,6 +31,7 @@ private:
  * The buckets data will then be written out in bucket order.
  * The buckets will be ordered, and the objects inside the buckets will be further ordered.
  * All data are kept compressed to minimize memory usage.
+ * Incoming data may be written by several threads.
  **/
 class BucketCompacter : public IWriteData, public StoreByBucket::IWrite
 {
@@ -52,6 +56,7 @@ private:
     vespalib::duration         _maxBucketGuardDuration;
     vespalib::steady_time      _lastSample;
     vespalib::Lock             _lock;
+    std::mutex                 _writeLock;
     vespalib::MemoryDataStore  _backingMemory;
     std::vector<StoreByBucket> _tmpStore;
     GenerationHandler::Guard   _lidGuard;
@@ -59,4 +64,28 @@ private:
     vespalib::hash_map<uint64_t, uint32_t> _stat;
 };
 
+/**
+ * Limits the bandwidth used for reading the file being compacted, and keeps
+ * track of the progress. Shared by all threads compacting the file.
+ */
+class CompactionThrottler : public IFileChunkReadThrottler, public IFileChunkVisitorProgress
+{
+public:
+    CompactionThrottler(uint64_t nameId, uint32_t numChunks, uint32_t numThreads, uint64_t maxBytesPerSecond);
+    ~CompactionThrottler() override;
+    void beforeRead(size_t sz) override;
+    void updateProgress() override;
+    DataStoreCompactionStats getStats() const;
+private:
+    const uint64_t              _nameId;
+    const uint32_t              _numChunks;
+    const uint32_t              _numThreads;
+    const uint64_t              _maxBytesPerSecond;
+    const vespalib::steady_time _start;
+    std::mutex                  _lock;
+    vespalib::steady_time       _nextRead;
+    std::atomic<uint64_t>       _bytesRead;
+    std::atomic<uint32_t>       _compactedChunks;
+};
+
 }
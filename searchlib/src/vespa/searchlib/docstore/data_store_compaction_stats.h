@@ -0,0 +1,53 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstdint>
+
+namespace search {
+
+/*
+ * Class representing the progress of the file compaction currently
+ * running in a data store, if any.
+ */
+class DataStoreCompactionStats
+{
+    bool     _active;
+    uint64_t _nameId;
+    uint32_t _numChunks;
+    uint32_t _compactedChunks;
+    uint32_t _numThreads;
+    uint64_t _bytesRead;
+    double   _bytesPerSecond;
+    uint64_t _maxBytesPerSecond;
+public:
+    DataStoreCompactionStats()
+        : DataStoreCompactionStats(false, 0, 0, 0, 0, 0, 0.0, 0)
+    { }
+    DataStoreCompactionStats(bool active_in, uint64_t nameId_in, uint32_t numChunks_in, uint32_t compactedChunks_in,
+                             uint32_t numThreads_in, uint64_t bytesRead_in, double bytesPerSecond_in,
+                             uint64_t maxBytesPerSecond_in)
+        : _active(active_in),
+          _nameId(nameId_in),
+          _numChunks(numChunks_in),
+          _compactedChunks(compactedChunks_in),
+          _numThreads(numThreads_in),
+          _bytesRead(bytesRead_in),
+          _bytesPerSecond(bytesPerSecond_in),
+          _maxBytesPerSecond(maxBytesPerSecond_in)
+    { }
+    bool     active() const            { return _active; }
+    uint64_t nameId() const            { return _nameId; }
+    uint32_t numChunks() const         { return _numChunks; }
+    uint32_t compactedChunks() const   { return _compactedChunks; }
+    uint32_t numThreads() const        { return _numThreads; }
+    uint64_t bytesRead() const         { return _bytesRead; }
+    double   bytesPerSecond() const    { return _bytesPerSecond; }
+    // 0 means unlimited.
+    uint64_t maxBytesPerSecond() const { return _maxBytesPerSecond; }
+    double progress() const {
+        return (_numChunks > 0) ? double(_compactedChunks) / _numChunks : 0.0;
+    }
+};
+
+} // namespace search
@@ -57,6 +57,7 @@ public:
 
     bool read(DocumentIdT key, Value &value) const;
     void visit(const IDocumentStore::LidVector &lids, const DocumentTypeRepo &repo, IDocumentVisitor &visitor) const;
+    void visit(const IDocumentStore::LidVector &lids, IBufferVisitor &visitor) const;
     void write(DocumentIdT, const Value &);
     void erase(DocumentIdT) {}
     const CompressionConfig &getCompression() const { return _compression; }
@@ -73,6 +74,11 @@ BackingStore::visit(const IDocumentStore::LidVector &lids, const DocumentTypeRep
     _backingStore.read(lids, adapter);
 }
 
+void
+BackingStore::visit(const IDocumentStore::LidVector &lids, IBufferVisitor &visitor) const {
+    _backingStore.read(lids, visitor);
+}
+
 bool
 BackingStore::read(DocumentIdT key, Value &value) const {
     bool found(false);
@@ -109,6 +115,33 @@ public:
     Cache(BackingStore & b, size_t maxBytes) : vespalib::cache<CacheParams>(b, maxBytes) { }
 };
 
+/**
+ * Adds the documents read from the backing store in a batch to the cache,
+ * as a single read on cache miss would have done, before passing them on.
+ */
+class CachePopulator : public IBufferVisitor {
+public:
+    CachePopulator(Cache &cache, const CompressionConfig &compression, IBufferVisitor &visitor)
+        : _cache(cache),
+          _compression(compression),
+          _visitor(visitor)
+    { }
+    void visit(uint32_t lid, vespalib::ConstBufferRef buf) override {
+        if (buf.size() > 0) {
+            vespalib::DataBuffer data(buf.size());
+            data.writeBytes(buf.c_str(), buf.size());
+            Value value;
+            value.set(std::move(data), buf.size(), _compression);
+            _cache.populate(lid, std::move(value));
+        }
+        _visitor.visit(lid, buf);
+    }
+private:
+    Cache                   &_cache;
+    const CompressionConfig &_compression;
+    IBufferVisitor          &_visitor;
+};
+
 }
 
 using VisitCache = docstore::VisitCache;
@@ -166,6 +199,29 @@ DocumentStore::visit(const LidVector & lids, const DocumentTypeRepo &repo, IDocu
     }
 }
 
+void
+DocumentStore::prefetch(const LidVector & lids, const DocumentTypeRepo &repo, IDocumentVisitor & visitor) const
+{
+    if ( ! useCache()) {
+        _store->visit(lids, repo, visitor);
+        return;
+    }
+    // Cached documents are taken from the cache, the rest are read from the backing store in one batch
+    // and added to the cache.
+    LidVector uncached;
+    for (DocumentIdT lid : lids) {
+        if (_cache->hasKey(lid)) {
+            visitor.visit(lid, read(lid, repo));
+        } else {
+            uncached.push_back(lid);
+        }
+    }
+    _uncached_lookups.fetch_add(uncached.size());
+    DocumentVisitorAdapter adapter(repo, visitor);
+    docstore::CachePopulator populator(*_cache, _store->getCompression(), adapter);
+    _store->visit(uncached, populator);
+}
+
 std::unique_ptr<document::Document>
 DocumentStore::read(DocumentIdT lid, const DocumentTypeRepo &repo) const
 {
@@ -428,6 +484,18 @@ DocumentStore::getFileChunkStats() const
     return _backingStore.getFileChunkStats();
 }
 
+AsyncReadStats
+DocumentStore::getAsyncReadStats() const
+{
+    return _backingStore.getAsyncReadStats();
+}
+
+DataStoreCompactionStats
+DocumentStore::getCompactionStats() const
+{
+    return _backingStore.getCompactionStats();
+}
+
 CacheStats DocumentStore::getCacheStats() const {
     CacheStats visitStats = _visitCache->getCacheStats();
     CacheStats singleStats(_cache->getHit(), _cache->getMiss() + _uncached_lookups,
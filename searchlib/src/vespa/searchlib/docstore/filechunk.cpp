@@ -6,6 +6,8 @@
 #include "randreaders.h"
 #include <vespa/searchlib/util/filekit.h>
 #include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/zstdcompressor.h>
+#include <vespa/vespalib/encoding/base64.h>
 #include <vespa/vespalib/data/fileheader.h>
 #include <vespa/vespalib/data/databuffer.h>
 #include <vespa/vespalib/stllike/asciistream.h>
@@ -29,6 +31,7 @@ namespace {
 constexpr size_t ALIGNMENT=0x1000;
 constexpr size_t ENTRY_BIAS_SIZE=8;
 const vespalib::string DOC_ID_LIMIT_KEY("docIdLimit");
+const vespalib::string ZSTD_DICTIONARY_KEY("zstdDictionary");
 
 }
 
@@ -83,6 +86,7 @@ FileChunk::FileChunk(FileId fileId, NameId nameId, const vespalib::string & base
       _idxHeaderLen(0u),
       _numLids(0),
       _docIdLimit(std::numeric_limits<uint32_t>::max()),
+      _dictionary(),
       _modificationTime()
 {
     FastOS_File dataFile(_dataFileName.c_str());
@@ -276,6 +280,9 @@ FileChunk::enableRead()
     if (_dataHeaderLen == 0u) {
         throw std::runtime_error(make_string("bad file header: %s", _dataFileName.c_str()));
     }
+    if ( ! _dictionary) {
+        _dictionary = readDictionary(*_file, _dataHeaderLen);
+    }
 }
 
 size_t FileChunk::adjustSize(size_t sz) {
@@ -337,28 +344,50 @@ appendChunks(FixedParams * args, Chunk::UP chunk)
 
 void
 FileChunk::appendTo(vespalib::ThreadExecutor & executor, const IGetLid & db, IWriteData & dest,
-                    uint32_t numChunks, IFileChunkVisitorProgress *visitorProgress)
+                    uint32_t numChunks, IFileChunkVisitorProgress *visitorProgress,
+                    IFileChunkReadThrottler *readThrottler, uint32_t numPartitions)
 {
     assert(frozen() || visitorProgress);
     vespalib::GenerationHandler::Guard lidReadGuard(db.getLidReadGuard());
     assert(numChunks <= getNumChunks());
     FixedParams fixedParams = {db, dest, lidReadGuard, getFileId().getId(), visitorProgress};
-    vespalib::BlockingThreadStackExecutor singleExecutor(1, 64*1024, executor.getNumThreads()*2);
-    for (size_t chunkId(0); chunkId < numChunks; chunkId++) {
-        std::promise<Chunk::UP> promisedChunk;
-        std::future<Chunk::UP> futureChunk = promisedChunk.get_future();
-        executor.execute(vespalib::makeLambdaTask([promise = std::move(promisedChunk), chunkId, this]() mutable {
-            const ChunkInfo & cInfo(_chunkInfo[chunkId]);
-            vespalib::DataBuffer whole(0ul, ALIGNMENT);
-            FileRandRead::FSP keepAlive(_file->read(cInfo.getOffset(), whole, cInfo.getSize()));
-            promise.set_value(std::make_unique<Chunk>(chunkId, whole.getData(), whole.getDataLen()));
-        }));
-
-        singleExecutor.execute(vespalib::makeLambdaTask([args = &fixedParams, chunk = std::move(futureChunk)]() mutable {
-            appendChunks(args, chunk.get());
-        }));
+    numPartitions = std::max(1u, std::min(numPartitions, numChunks));
+    const size_t maxPendingPerPartition = std::max(2ul, (executor.getNumThreads() * 2) / numPartitions);
+    std::vector<std::unique_ptr<vespalib::BlockingThreadStackExecutor>> partitions;
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    for (uint32_t i(0); i < numPartitions; i++) {
+        partitions.push_back(std::make_unique<vespalib::BlockingThreadStackExecutor>(1, 64*1024, maxPendingPerPartition));
+        ranges.emplace_back((uint64_t(numChunks) * i) / numPartitions, (uint64_t(numChunks) * (i + 1)) / numPartitions);
+    }
+    // Interleave the partitions so they all make progress.
+    for (bool more(true); more;) {
+        more = false;
+        for (uint32_t i(0); i < numPartitions; i++) {
+            if (ranges[i].first == ranges[i].second) {
+                continue;
+            }
+            more = true;
+            size_t chunkId = ranges[i].first++;
+            std::promise<Chunk::UP> promisedChunk;
+            std::future<Chunk::UP> futureChunk = promisedChunk.get_future();
+            executor.execute(vespalib::makeLambdaTask([promise = std::move(promisedChunk), chunkId, readThrottler, this]() mutable {
+                const ChunkInfo & cInfo(_chunkInfo[chunkId]);
+                if (readThrottler != nullptr) {
+                    readThrottler->beforeRead(cInfo.getSize());
+                }
+                vespalib::DataBuffer whole(0ul, ALIGNMENT);
+                FileRandRead::FSP keepAlive(_file->read(cInfo.getOffset(), whole, cInfo.getSize()));
+                promise.set_value(std::make_unique<Chunk>(chunkId, whole.getData(), whole.getDataLen(), false, _dictionary.get()));
+            }));
+
+            partitions[i]->execute(vespalib::makeLambdaTask([args = &fixedParams, chunk = std::move(futureChunk)]() mutable {
+                appendChunks(args, chunk.get());
+            }));
+        }
+    }
+    for (auto & partition : partitions) {
+        partition->sync();
     }
-    singleExecutor.sync();
     dest.close();
 }
 
@@ -386,7 +415,21 @@ FileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, ChunkInfo c
 {
     vespalib::DataBuffer whole(0ul, ALIGNMENT);
     FileRandRead::FSP keepAlive = _file->read(ci.getOffset(), whole, ci.getSize());
-    Chunk chunk(begin->getChunkId(), whole.getData(), whole.getDataLen(), _skipCrcOnRead);
+    visit(begin, count, whole, visitor);
+}
+
+FileRandRead::PreparedRead
+FileChunk::prepareRead(SubChunkId chunkId, vespalib::DataBuffer & buffer) const
+{
+    const ChunkInfo & ci = _chunkInfo[chunkId];
+    return _file->prepareRead(ci.getOffset(), buffer, ci.getSize());
+}
+
+void
+FileChunk::visit(LidInfoWithLidV::const_iterator begin, size_t count, const vespalib::DataBuffer & buffer,
+                 IBufferVisitor & visitor) const
+{
+    Chunk chunk(begin->getChunkId(), buffer.getData(), buffer.getDataLen(), _skipCrcOnRead, _dictionary.get());
     for (size_t i(0); i < count; i++) {
         const LidInfoWithLid & li = *(begin + i);
         vespalib::ConstBufferRef buf = chunk.getLid(li.getLid());
@@ -411,7 +454,7 @@ FileChunk::read(uint32_t lid, SubChunkId chunkId, const ChunkInfo & chunkInfo,
 {
     vespalib::DataBuffer whole(0ul, ALIGNMENT);
     FileRandRead::FSP keepAlive(_file->read(chunkInfo.getOffset(), whole, chunkInfo.getSize()));
-    Chunk chunk(chunkId, whole.getData(), whole.getDataLen(), _skipCrcOnRead);
+    Chunk chunk(chunkId, whole.getData(), whole.getDataLen(), _skipCrcOnRead, _dictionary.get());
     return chunk.read(lid, buffer);
 }
 
@@ -433,6 +476,37 @@ FileChunk::readDataHeader(FileRandRead &datFile)
     return dataHeaderLen;
 }
 
+FileChunk::DictionarySP
+FileChunk::readDictionary(FileRandRead &datFile, uint64_t dataHeaderLen)
+{
+    if (dataHeaderLen < GenericHeader::getMinSize()) {
+        return DictionarySP();
+    }
+    vespalib::DataBuffer h(dataHeaderLen, ALIGNMENT);
+    datFile.read(0, h, dataHeaderLen);
+    GenericHeader::BufferReader rd(h);
+    GenericHeader header;
+    header.read(rd);
+    return readDictionary(header);
+}
+
+FileChunk::DictionarySP
+FileChunk::readDictionary(const vespalib::GenericHeader &header)
+{
+    if ( ! header.hasTag(ZSTD_DICTIONARY_KEY)) {
+        return DictionarySP();
+    }
+    const vespalib::string & encoded = header.getTag(ZSTD_DICTIONARY_KEY).asString();
+    std::string dictionary = vespalib::Base64::decode(encoded.c_str(), encoded.size());
+    return std::make_shared<ZStdDictionary>(vespalib::ConstBufferRef(dictionary.data(), dictionary.size()));
+}
+
+void
+FileChunk::writeDictionary(vespalib::GenericHeader &header, const ZStdDictionary &dictionary)
+{
+    vespalib::ConstBufferRef buf = dictionary.getBuffer();
+    header.putTag(vespalib::GenericHeader::Tag(ZSTD_DICTIONARY_KEY, vespalib::Base64::encode(buf.c_str(), buf.size())));
+}
 
 uint64_t
 FileChunk::readIdxHeader(FastOS_FileInterface &idxFile, uint32_t &docIdLimit)
@@ -487,7 +561,7 @@ FileChunk::verify(bool reportOnly) const
         vespalib::DataBuffer whole(0ul, ALIGNMENT);
         FileRandRead::FSP keepAlive(_file->read(ci.getOffset(), whole, ci.getSize()));
         try {
-            Chunk chunk(chunkId++, whole.getData(), whole.getDataLen());
+            Chunk chunk(chunkId++, whole.getData(), whole.getDataLen(), false, _dictionary.get());
             assert(chunk.getLastSerial() >= lastSerial);
             lastSerial = chunk.getLastSerial();
             if (errorInPrev) {
@@ -510,6 +584,28 @@ FileChunk::getNumChunks() const
     return _chunkInfo.size();
 }
 
+void
+FileChunk::sampleChunks(size_t maxSamples, vespalib::DataBuffer & samples, std::vector<size_t> & sampleSizes) const
+{
+    const size_t numChunks(_chunkInfo.size());
+    if ((numChunks == 0) || (maxSamples == 0)) {
+        return;
+    }
+    const size_t step(std::max(1ul, numChunks / maxSamples));
+    for (size_t chunkId(0); (chunkId < numChunks) && (sampleSizes.size() < maxSamples); chunkId += step) {
+        const ChunkInfo & ci = _chunkInfo[chunkId];
+        vespalib::DataBuffer whole(0ul, ALIGNMENT);
+        FileRandRead::FSP keepAlive(_file->read(ci.getOffset(), whole, ci.getSize()));
+        const Chunk chunk(chunkId, whole.getData(), whole.getDataLen(), _skipCrcOnRead, _dictionary.get());
+        if ( ! chunk.empty()) {
+            const Chunk::Entry & last = chunk.getLids().back();
+            const size_t sz = last.getOffset() + last.size();
+            samples.writeBytes(chunk.getData().data(), sz);
+            sampleSizes.push_back(sz);
+        }
+    }
+}
+
 size_t
 FileChunk::getMemoryFootprint() const
 {
@@ -522,7 +618,7 @@ FileChunk::getMemoryFootprint() const
 size_t
 FileChunk::getMemoryMetaFootprint() const
 {
-    return sizeof(*this) + _chunkInfo.byteCapacity();
+    return sizeof(*this) + _chunkInfo.byteCapacity() + (_dictionary ? _dictionary->getBuffer().size() : 0);
 }
 
 vespalib::MemoryUsage
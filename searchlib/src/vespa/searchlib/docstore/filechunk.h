@@ -45,6 +45,17 @@ public:
     virtual void updateProgress() = 0;
 };
 
+class IFileChunkReadThrottler
+{
+public:
+    virtual ~IFileChunkReadThrottler() { }
+    /**
+     * Called before a chunk of the given size is read. May block to limit
+     * the bandwidth used. Must be thread safe.
+     */
+    virtual void beforeRead(size_t sz) = 0;
+};
+
 class BucketDensityComputer
 {
 public:
@@ -74,6 +85,8 @@ class FileChunk
 {
 public:
     using LockGuard = vespalib::LockGuard;
+    using ZStdDictionary = Chunk::ZStdDictionary;
+    using DictionarySP = std::shared_ptr<const ZStdDictionary>;
     class NameId {
     public:
         explicit NameId(size_t id) : _id(id) { }
@@ -113,6 +126,18 @@ public:
     virtual size_t updateLidMap(const LockGuard &guard, ISetLid &lidMap, uint64_t serialNum, uint32_t docIdLimit);
     virtual ssize_t read(uint32_t lid, SubChunkId chunk, vespalib::DataBuffer & buffer) const;
     virtual void read(LidInfoWithLidV::const_iterator begin, size_t count, IBufferVisitor & visitor) const;
+    /**
+     * Prepares reading the given chunk into buffer with a single positioned read that
+     * can be issued asynchronously. Returns an invalid read if not supported by the
+     * underlying file reader. Only to be used for frozen files.
+     */
+    FileRandRead::PreparedRead prepareRead(SubChunkId chunkId, vespalib::DataBuffer & buffer) const;
+    /**
+     * Visits the given lids, all in the same chunk, in the chunk that has been read
+     * into buffer as prepared by prepareRead().
+     */
+    void visit(LidInfoWithLidV::const_iterator begin, size_t count, const vespalib::DataBuffer & buffer,
+               IBufferVisitor & visitor) const;
     void remove(uint32_t lid, uint32_t size);
     virtual size_t getDiskFootprint() const { return _diskFootprint; }
     virtual size_t getMemoryFootprint() const;
@@ -164,8 +189,14 @@ public:
     virtual bool frozen() const { return true; }
     const vespalib::string & getName() const { return _name; }
     void compact(const IGetLid & iGetLid);
+    /**
+     * Writes the live entries in the first numChunks chunks to dest. Chunks are read by the executor.
+     * The chunks are split into numPartitions ranges that are written concurrently, each in chunk order.
+     * dest must then be thread safe.
+     */
     void appendTo(vespalib::ThreadExecutor & executor, const IGetLid & db, IWriteData & dest,
-                  uint32_t numChunks, IFileChunkVisitorProgress *visitorProgress);
+                  uint32_t numChunks, IFileChunkVisitorProgress *visitorProgress,
+                  IFileChunkReadThrottler *readThrottler, uint32_t numPartitions);
     /**
      * Must be called after chunk has been created to allow correct
      * underlying file object to be created.  Must be called before
@@ -184,6 +215,16 @@ public:
     void verify(bool reportOnly) const;
 
     uint32_t      getNumChunks() const;
+    /**
+     * Returns the zstd dictionary used to compress chunks in this file, if any.
+     */
+    const DictionarySP & getDictionary() const { return _dictionary; }
+    /**
+     * Reads up to maxSamples chunks evenly spread over the file and
+     * appends their uncompressed content to samples, one sample per chunk.
+     * Used to train compression dictionaries.
+     */
+    void sampleChunks(size_t maxSamples, vespalib::DataBuffer & samples, std::vector<size_t> & sampleSizes) const;
     size_t       getNumBuckets() const { return _sumNumBuckets; }
     size_t getNumUniqueBuckets() const { return _numUniqueBuckets; }
 
@@ -194,6 +235,10 @@ public:
      */
     static uint64_t readIdxHeader(FastOS_FileInterface &idxFile, uint32_t &docIdLimit);
     static uint64_t readDataHeader(FileRandRead &idxFile);
+    /**
+     * Read the zstd dictionary stored in the data file header, if any.
+     */
+    static DictionarySP readDictionary(FileRandRead &datFile, uint64_t dataHeaderLen);
     static bool isIdxFileEmpty(const vespalib::string & name);
     static void eraseIdxFile(const vespalib::string & name);
     static void eraseDatFile(const vespalib::string & name);
@@ -238,6 +283,8 @@ protected:
     void read(LidInfoWithLidV::const_iterator begin, size_t count, ChunkInfo ci, IBufferVisitor & visitor) const;
     static uint32_t readDocIdLimit(vespalib::GenericHeader &header);
     static void writeDocIdLimit(vespalib::GenericHeader &header, uint32_t docIdLimit);
+    static DictionarySP readDictionary(const vespalib::GenericHeader &header);
+    static void writeDictionary(vespalib::GenericHeader &header, const ZStdDictionary &dictionary);
 
     typedef vespalib::Array<ChunkInfo> ChunkInfoVector;
     const IBucketizer   * _bucketizer;
@@ -251,6 +298,7 @@ protected:
     uint32_t              _idxHeaderLen;
     uint32_t              _numLids;
     uint32_t              _docIdLimit; // Limit when the file was created. Stored in idx file header.
+    DictionarySP          _dictionary; // Used for zstd compression of chunks. Stored in dat file header.
     vespalib::system_time  _modificationTime;
 };
 
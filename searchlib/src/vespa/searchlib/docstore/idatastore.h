@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include "async_read_stats.h"
+#include "data_store_compaction_stats.h"
 #include "data_store_file_chunk_stats.h"
 #include <vespa/searchlib/common/i_compactable_lid_space.h>
 #include <vespa/vespalib/stllike/string.h>
@@ -172,6 +174,16 @@ public:
      */
     virtual std::vector<DataStoreFileChunkStats> getFileChunkStats() const = 0;
 
+    /*
+     * Return stats for batched asynchronous reads, if used by the data store.
+     */
+    virtual AsyncReadStats getAsyncReadStats() const { return AsyncReadStats(); }
+
+    /*
+     * Return progress of the file compaction currently running, if any.
+     */
+    virtual DataStoreCompactionStats getCompactionStats() const { return DataStoreCompactionStats(); }
+
     /**
      * Get the number of entries (including removed IDs
      * or gaps in the local ID sequence) in the data store.
@@ -87,6 +87,12 @@ public:
     virtual DocumentUP read(DocumentIdT lid, const document::DocumentTypeRepo &repo) const = 0;
     virtual void visit(const LidVector & lidVector, const document::DocumentTypeRepo &repo, IDocumentVisitor & visitor) const;
 
+    /**
+     * Read the documents for the given lids in one batch, as done before their docsums are fetched.
+     * Unlike visit(), the documents read are added to the document cache as single reads would have done.
+     **/
+    virtual void prefetch(const LidVector & lidVector, const document::DocumentTypeRepo &repo, IDocumentVisitor & visitor) const;
+
     /**
      * Serialize and store a document.
      * @param doc The document to store
@@ -216,6 +222,16 @@ public:
      * Return detailed stats about underlying files for data store.
      */
     virtual std::vector<DataStoreFileChunkStats> getFileChunkStats() const = 0;
+
+    /*
+     * Return stats for batched asynchronous reads in underlying data store.
+     */
+    virtual AsyncReadStats getAsyncReadStats() const { return AsyncReadStats(); }
+
+    /*
+     * Return progress of the file compaction currently running in underlying data store, if any.
+     */
+    virtual DataStoreCompactionStats getCompactionStats() const { return DataStoreCompactionStats(); }
 };
 
 } // namespace search
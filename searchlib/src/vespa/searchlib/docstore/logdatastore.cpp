@@ -3,12 +3,17 @@
 #include "storebybucket.h"
 #include "compacter.h"
 #include "logdatastore.h"
+#include "async_io_reader.h"
 #include <vespa/vespalib/stllike/asciistream.h>
 #include <vespa/vespalib/util/benchmark_timer.h>
 #include <vespa/vespalib/data/fileheader.h>
 #include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/zstdcompressor.h>
+#include <vespa/vespalib/data/databuffer.h>
 #include <vespa/vespalib/util/rcuvector.hpp>
+#include <vespa/vespalib/util/threadstackexecutor.h>
 #include <thread>
 
 #include <vespa/log/log.h>
@@ -19,6 +24,11 @@ namespace search {
 namespace {
     constexpr size_t DEFAULT_MAX_FILESIZE = 1000000000ul;
     constexpr uint32_t DEFAULT_MAX_LIDS_PER_FILE = 32 * 1024 * 1024;
+    // zstd recommends training on roughly 100 times the dictionary size.
+    constexpr size_t DICTIONARY_TRAINING_FACTOR = 100;
+    constexpr size_t MIN_DICTIONARY_SAMPLES = 16;
+    // Threads used for asynchronous reads when io_uring is not available.
+    constexpr uint32_t MAX_ASYNC_READ_FALLBACK_THREADS = 8;
 }
 
 using vespalib::LockGuard;
@@ -32,6 +42,8 @@ using std::runtime_error;
 using document::BucketId;
 using docstore::StoreByBucket;
 using docstore::BucketCompacter;
+using docstore::CompactionThrottler;
+using vespalib::compression::ZStdDictionary;
 using namespace std::literals;
 
 LogDataStore::Config::Config()
@@ -40,6 +52,9 @@ LogDataStore::Config::Config()
       _maxBucketSpread(2.5),
       _minFileSizeFactor(0.2),
       _maxNumLids(DEFAULT_MAX_LIDS_PER_FILE),
+      _maxDictionaryBytes(0),
+      _compactThreads(1),
+      _maxCompactBytesPerSecond(0),
       _skipCrcOnRead(false),
       _compactCompression(CompressionConfig::LZ4),
       _fileConfig()
@@ -51,6 +66,9 @@ LogDataStore::Config::operator == (const Config & rhs) const {
             (_maxDiskBloatFactor == rhs._maxDiskBloatFactor) &&
             (_maxFileSize == rhs._maxFileSize) &&
             (_minFileSizeFactor == rhs._minFileSizeFactor) &&
+            (_maxDictionaryBytes == rhs._maxDictionaryBytes) &&
+            (_compactThreads == rhs._compactThreads) &&
+            (_maxCompactBytesPerSecond == rhs._maxCompactBytesPerSecond) &&
             (_skipCrcOnRead == rhs._skipCrcOnRead) &&
             (_compactCompression == rhs._compactCompression) &&
             (_fileConfig == rhs._fileConfig);
@@ -78,11 +96,18 @@ LogDataStore::LogDataStore(vespalib::ThreadExecutor &executor, const vespalib::s
       _tlSyncer(tlSyncer),
       _bucketizer(std::move(bucketizer)),
       _currentlyCompacting(),
-      _compactLidSpaceGeneration()
+      _compactLidSpaceGeneration(),
+      _dictionary(),
+      _dictionaryTraining(),
+      _asyncReader()
 {
     // Reserve space for 1TB summary in order to avoid locking.
     _fileChunks.reserve(LidInfo::getFileIdLimit());
     _holdFileChunks.resize(LidInfo::getFileIdLimit());
+    uint32_t queueDepth = _tune._randRead.getAsyncQueueDepth();
+    if ((queueDepth > 0) && ! _tune._randRead.getWantMemoryMap()) {
+        _asyncReader = std::make_unique<AsyncIoReader>(queueDepth, std::min(queueDepth, MAX_ASYNC_READ_FALLBACK_THREADS));
+    }
 
     preload();
     updateLidMap(getLastFileChunkDocIdLimit());
@@ -107,6 +132,9 @@ LogDataStore::updateSerialNum()
 
 LogDataStore::~LogDataStore()
 {
+    if (_dictionaryTraining.valid()) {
+        _dictionaryTraining.wait();
+    }
     // Must be called before ending threads as there are sanity checks.
     _fileChunks.clear();
     _genHandler.updateFirstUsedGeneration();
@@ -143,6 +171,10 @@ LogDataStore::read(const LidVector & lids, IBufferVisitor & visitor) const
     if (orderedLids.empty()) { return; }
 
     std::sort(orderedLids.begin(), orderedLids.end());
+    if (_asyncReader) {
+        readBatched(orderedLids, visitor);
+        return;
+    }
     uint32_t prevFile = orderedLids[0].getFileId();
     uint32_t start = 0;
     for (size_t curr(1); curr < orderedLids.size(); curr++) {
@@ -158,6 +190,80 @@ LogDataStore::read(const LidVector & lids, IBufferVisitor & visitor) const
     fc.read(orderedLids.begin() + start, orderedLids.size() - start, visitor);
 }
 
+namespace {
+
+struct PendingChunkRead {
+    const FileChunk                 * file;
+    LidInfoWithLidV::const_iterator   begin;
+    size_t                            count;
+    vespalib::DataBuffer              buffer;
+    FileRandRead::PreparedRead        prepared;
+    PendingChunkRead(const FileChunk & file_in, LidInfoWithLidV::const_iterator begin_in, size_t count_in)
+        : file(&file_in), begin(begin_in), count(count_in), buffer(0ul), prepared()
+    { }
+};
+
+}
+
+void
+LogDataStore::readBatched(const LidInfoWithLidV & orderedLids, IBufferVisitor & visitor) const
+{
+    // One read per distinct chunk, as lids are ordered by file and chunk.
+    std::vector<PendingChunkRead> pending;
+    pending.reserve(orderedLids.size());
+    for (size_t start(0), curr(1); curr <= orderedLids.size(); curr++) {
+        if ((curr < orderedLids.size()) &&
+            (orderedLids[curr].getFileId() == orderedLids[start].getFileId()) &&
+            (orderedLids[curr].getChunkId() == orderedLids[start].getChunkId()))
+        {
+            continue;
+        }
+        const FileChunk & fc(*_fileChunks[orderedLids[start].getFileId()]);
+        auto begin = orderedLids.begin() + start;
+        size_t count = curr - start;
+        start = curr;
+        if (fc.frozen()) {
+            pending.emplace_back(fc, begin, count);
+            PendingChunkRead & read = pending.back();
+            read.prepared = fc.prepareRead(begin->getChunkId(), read.buffer);
+            if (read.prepared.valid()) {
+                continue;
+            }
+            pending.pop_back();
+        }
+        fc.read(begin, count, visitor);
+    }
+    std::vector<AsyncIoReader::Request> requests;
+    requests.reserve(pending.size());
+    for (const PendingChunkRead & read : pending) {
+        requests.emplace_back(read.prepared.fd, read.prepared.offset, read.prepared.size, read.prepared.dst);
+    }
+    _asyncReader->read(requests);
+    for (size_t i(0); i < pending.size(); i++) {
+        PendingChunkRead & read = pending[i];
+        if (requests[i].result >= ssize_t(read.prepared.required())) {
+            FileRandRead::finishRead(read.prepared, read.buffer);
+            read.file->visit(read.begin, read.count, read.buffer, visitor);
+        } else {
+            // Let the synchronous read report the failure.
+            read.file->read(read.begin, read.count, visitor);
+        }
+    }
+}
+
+DataStoreCompactionStats
+LogDataStore::getCompactionStats() const
+{
+    LockGuard guard(_updateLock);
+    return _compaction ? _compaction->getStats() : DataStoreCompactionStats();
+}
+
+AsyncReadStats
+LogDataStore::getAsyncReadStats() const
+{
+    return _asyncReader ? _asyncReader->getStats() : AsyncReadStats();
+}
+
 ssize_t
 LogDataStore::read(uint32_t lid, vespalib::DataBuffer& buffer) const
 {
@@ -211,6 +317,7 @@ LogDataStore::requireSpace(LockGuard guard, WriteableFileChunk & active)
     LOG(spam, "Checking file %s size %ld < %ld AND #lids %u < %u",
               active.getName().c_str(), oldSz, _config.getMaxFileSize(), active.getNumLids(), _config.getMaxNumLids());
     if ((oldSz > _config.getMaxFileSize()) || (active.getNumLids() >= _config.getMaxNumLids())) {
+        bool needDictionary = (_config.getMaxDictionaryBytes() > 0) && !_dictionary;
         FileId fileId = allocateFileId(guard);
         setNewFileChunk(guard, createWritableFile(fileId, active.getSerialNum()));
         setActive(guard, fileId);
@@ -225,6 +332,11 @@ LogDataStore::requireSpace(LockGuard guard, WriteableFileChunk & active)
         // and sync old .idx file to disk.
         active.flushPendingChunks(active.getSerialNum());
         active.freeze();
+        if (needDictionary) {
+            // First full file. The new active file is already in use, so the
+            // dictionary is used by files created after training completes.
+            startDictionaryTraining(active.getFileId());
+        }
         // TODO: Delay create of new file
         LOG(debug, "Closed file %s of size %ld and %u lids due to maxsize of %ld or maxlids %u reached. Bloat is %ld",
                    active.getName().c_str(), active.getDiskFootprint(), active.getNumLids(),
@@ -479,6 +591,10 @@ void LogDataStore::compactFile(FileId fileId)
               fc->getName().c_str(), 100*fc->getDiskBloat()/double(fc->getDiskFootprint()), fc->getBucketSpread());
     IWriteData::UP compacter;
     FileId destinationFileId = FileId::active();
+    if (_config.getMaxDictionaryBytes() > 0) {
+        // Retrain on the documents being rewritten to keep the dictionary current.
+        startDictionaryTraining(fileId);
+    }
     if (_bucketizer) {
         if ( ! shouldCompactToActiveFile(fc->getDiskFootprint() - fc->getDiskBloat())) {
             LockGuard guard(_updateLock);
@@ -492,7 +608,27 @@ void LogDataStore::compactFile(FileId fileId)
         compacter = std::make_unique<docstore::Compacter>(*this);
     }
 
-    fc->appendTo(_executor, *this, *compacter, fc->getNumChunks(), nullptr);
+    const uint32_t numThreads = std::max(1u, _config.getCompactThreads());
+    const uint64_t maxBytesPerSecond = _config.getMaxCompactBytesPerSecond();
+    auto throttler = std::make_shared<CompactionThrottler>(compactedNameId.getId(), fc->getNumChunks(), numThreads, maxBytesPerSecond);
+    {
+        LockGuard guard(_updateLock);
+        _compaction = throttler;
+    }
+    if ((numThreads > 1) || (maxBytesPerSecond > 0)) {
+        // Reads may be held back by the throttler, so they get their own threads instead of the shared executor.
+        vespalib::ThreadStackExecutor compactExecutor(numThreads, 128 * 1024);
+        fc->appendTo(compactExecutor, *this, *compacter, fc->getNumChunks(), throttler.get(), throttler.get(), numThreads);
+    } else {
+        fc->appendTo(_executor, *this, *compacter, fc->getNumChunks(), throttler.get(), throttler.get(), 1);
+    }
+    DataStoreCompactionStats compactionStats = throttler->getStats();
+    LOG(info, "Read %" PRIu64 " bytes from file '%s' using %u threads at %.0f bytes/s",
+              compactionStats.bytesRead(), fc->getName().c_str(), numThreads, compactionStats.bytesPerSecond());
+    {
+        LockGuard guard(_updateLock);
+        _compaction.reset();
+    }
 
     if (destinationFileId.isActive()) {
         flushActiveAndWait(0);
@@ -534,6 +670,51 @@ void LogDataStore::compactFile(FileId fileId)
     _currentlyCompacting.erase(compactedNameId);
 }
 
+void
+LogDataStore::startDictionaryTraining(FileId fileId)
+{
+    std::unique_ptr<FileChunkHolder> holder;
+    auto done = std::make_shared<std::promise<void>>();
+    {
+        LockGuard guard(_updateLock);
+        if (_dictionaryTraining.valid() && (_dictionaryTraining.wait_for(0s) != std::future_status::ready)) {
+            LOG(debug, "Dictionary training already in progress, skipping file '%s'",
+                       _fileChunks[fileId.getId()]->getName().c_str());
+            return;
+        }
+        // The hold keeps compaction from removing the file while it is sampled.
+        holder = holdFileChunk(fileId);
+        _dictionaryTraining = done->get_future();
+    }
+    const FileChunk & source = *_fileChunks[fileId.getId()];
+    _executor.execute(vespalib::makeLambdaTask([this, &source, holder = std::move(holder), done]() mutable {
+        trainDictionary(source);
+        holder.reset();
+        done->set_value();
+    }));
+}
+
+void
+LogDataStore::trainDictionary(const FileChunk & source)
+{
+    const size_t maxDictionaryBytes = _config.getMaxDictionaryBytes();
+    const size_t maxSamples = std::max(MIN_DICTIONARY_SAMPLES,
+                                       (DICTIONARY_TRAINING_FACTOR * maxDictionaryBytes) /
+                                       std::max(1ul, _config.getFileConfig().getMaxChunkBytes()));
+    vespalib::DataBuffer samples;
+    std::vector<size_t> sampleSizes;
+    source.sampleChunks(maxSamples, samples, sampleSizes);
+    FileChunk::DictionarySP dictionary = ZStdDictionary::train(samples.getData(), sampleSizes, maxDictionaryBytes);
+    if ( ! dictionary) {
+        LOG(debug, "Failed training zstd dictionary from %zu chunks in file '%s'", sampleSizes.size(), source.getName().c_str());
+        return;
+    }
+    LOG(info, "Trained zstd dictionary %u of %zu bytes from %zu chunks in file '%s'",
+              dictionary->getId(), dictionary->getBuffer().size(), sampleSizes.size(), source.getName().c_str());
+    LockGuard guard(_updateLock);
+    _dictionary = std::move(dictionary);
+}
+
 size_t
 LogDataStore::memoryUsed() const
 {
@@ -658,8 +839,9 @@ LogDataStore::createWritableFile(FileId fileId, SerialNum serialNum, NameId name
     }
     uint32_t docIdLimit = (getDocIdLimit() != 0) ? getDocIdLimit() : std::numeric_limits<uint32_t>::max();
     FileChunk::UP file(new WriteableFileChunk(_executor, fileId, nameId, getBaseDir(),
-                                              serialNum, docIdLimit,
-                                              _config.getFileConfig(), _tune, _fileHeaderContext,
+                                              serialNum, docIdLimit, _config.getFileConfig(),
+                                              (_config.getMaxDictionaryBytes() > 0) ? _dictionary : FileChunk::DictionarySP(),
+                                              _tune, _fileHeaderContext,
                                               _bucketizer.get(), _config.crcOnReadDisabled()));
     file->enableRead();
     return file;
@@ -805,6 +987,11 @@ LogDataStore::preload()
     }
     _active = FileId(_fileChunks.size() - 1);
     _prevActive = _active.prev();
+    for (const auto & fc : _fileChunks) {
+        if (fc->getDictionary()) {
+            _dictionary = fc->getDictionary();
+        }
+    }
 }
 
 uint32_t
@@ -1097,7 +1284,7 @@ LogDataStore::accept(IDataStoreVisitor &visitor,
     WrapVisitorProgress wrapProgress(visitorProgress, totalChunks);
     for (FileId fcId : fileChunks) {
         FileChunk & fc = *_fileChunks[fcId.getId()];
-        fc.appendTo(_executor, *this, wrap, fc.getNumChunks(), &wrapProgress);
+        fc.appendTo(_executor, *this, wrap, fc.getNumChunks(), &wrapProgress, nullptr, 1);
         if (prune) {
             internalFlushAll();
             FileChunk::UP toDie;
@@ -1108,7 +1295,7 @@ LogDataStore::accept(IDataStoreVisitor &visitor,
             toDie->erase();
         }
     }
-    lfc.appendTo(_executor, *this, wrap, lastChunks, &wrapProgress);
+    lfc.appendTo(_executor, *this, wrap, lastChunks, &wrapProgress, nullptr, 1);
     if (prune) {
         internalFlushAll();
     }
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "async_read_stats.h"
 #include "idatastore.h"
 #include "lid_info.h"
 #include "writeablefilechunk.h"
@@ -12,11 +13,14 @@
 #include <vespa/vespalib/util/rcuvector.h>
 #include <vespa/vespalib/util/threadexecutor.h>
 
+#include <future>
 #include <set>
 
 namespace search {
 
 namespace common { class FileHeaderContext; }
+class AsyncIoReader;
+namespace docstore { class CompactionThrottler; }
 
 
 /**
@@ -44,6 +48,9 @@ public:
         Config & setMaxDiskBloatFactor(double v) { _maxDiskBloatFactor = v; return *this; }
         Config & setMaxBucketSpread(double v) { _maxBucketSpread = v; return *this; }
         Config & setMinFileSizeFactor(double v) { _minFileSizeFactor = v; return *this; }
+        Config & setMaxDictionaryBytes(size_t v) { _maxDictionaryBytes = v; return *this; }
+        Config & setCompactThreads(uint32_t v) { _compactThreads = v; return *this; }
+        Config & setMaxCompactBytesPerSecond(uint64_t v) { _maxCompactBytesPerSecond = v; return *this; }
 
         Config & compactCompression(CompressionConfig v) { _compactCompression = v; return *this; }
         Config & setFileConfig(WriteableFileChunk::Config v) { _fileConfig = v; return *this; }
@@ -53,6 +60,20 @@ public:
         double getMaxBucketSpread() const { return _maxBucketSpread; }
         double getMinFileSizeFactor() const { return _minFileSizeFactor; }
         uint32_t getMaxNumLids() const { return _maxNumLids; }
+        /**
+         * Max size of the zstd dictionary trained from sampled chunks and
+         * used for compressing new files. 0 disables dictionaries.
+         */
+        size_t getMaxDictionaryBytes() const { return _maxDictionaryBytes; }
+        /**
+         * Number of threads reading and rewriting the file being compacted,
+         * each handling its own range of chunks.
+         */
+        uint32_t getCompactThreads() const { return _compactThreads; }
+        /**
+         * Max bandwidth used for reading the file being compacted. 0 means unlimited.
+         */
+        uint64_t getMaxCompactBytesPerSecond() const { return _maxCompactBytesPerSecond; }
 
         bool crcOnReadDisabled() const { return _skipCrcOnRead; }
         const CompressionConfig & compactCompression() const { return _compactCompression; }
@@ -67,6 +88,9 @@ public:
         double                      _maxBucketSpread;
         double                      _minFileSizeFactor;
         uint32_t                    _maxNumLids;
+        size_t                      _maxDictionaryBytes;
+        uint32_t                    _compactThreads;
+        uint64_t                    _maxCompactBytesPerSecond;
         bool                        _skipCrcOnRead;
         CompressionConfig           _compactCompression;
         WriteableFileChunk::Config  _fileConfig;
@@ -169,6 +193,8 @@ public:
     DataStoreStorageStats getStorageStats() const override;
     vespalib::MemoryUsage getMemoryUsage() const override;
     std::vector<DataStoreFileChunkStats> getFileChunkStats() const override;
+    AsyncReadStats getAsyncReadStats() const override;
+    DataStoreCompactionStats getCompactionStats() const override;
 
     void compactLidSpace(uint32_t wantedDocLidLimit) override;
     bool canShrinkLidSpace() const override;
@@ -187,8 +213,11 @@ private:
     // Implements ISetLid API
     void setLid(const LockGuard & guard, uint32_t lid, const LidInfo & lm) override;
 
+    void readBatched(const LidInfoWithLidV & orderedLids, IBufferVisitor & visitor) const;
     void compactWorst(double bloatLimit, double spreadLimit, bool prioritizeDiskBloat);
     void compactFile(FileId chunkId);
+    void startDictionaryTraining(FileId fileId);
+    void trainDictionary(const FileChunk & source);
 
     typedef vespalib::RcuVector<uint64_t> LidInfoVector;
     typedef std::vector<FileChunk::UP> FileChunkVector;
@@ -290,6 +319,10 @@ private:
     IBucketizer::SP                          _bucketizer;
     NameIdSet                                _currentlyCompacting;
     uint64_t                                 _compactLidSpaceGeneration;
+    FileChunk::DictionarySP                  _dictionary; // Used when creating new files
+    std::future<void>                        _dictionaryTraining;
+    std::unique_ptr<AsyncIoReader>           _asyncReader;
+    std::shared_ptr<docstore::CompactionThrottler> _compaction; // File compaction in progress, if any
 };
 
 } // namespace search
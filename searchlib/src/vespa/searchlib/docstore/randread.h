@@ -16,8 +16,31 @@ class FileRandRead
 {
 public:
     typedef std::shared_ptr<FastOS_FileInterface> FSP;
+    /**
+     * Describes a single positioned read prepared by prepareRead(), so that it
+     * can be issued on the file descriptor by someone else (e.g. asynchronously).
+     */
+    struct PreparedRead {
+        int      fd;         // -1 if the read must be done with read()
+        uint64_t offset;     // (aligned) file offset to read from
+        size_t   size;       // (padded) number of bytes to read
+        void   * dst;        // destination of the read
+        size_t   padBefore;  // number of padding bytes before the wanted data
+        size_t   wanted;     // number of wanted bytes
+        PreparedRead() : fd(-1), offset(0), size(0), dst(nullptr), padBefore(0), wanted(0) { }
+        bool valid() const { return fd >= 0; }
+        // Minimum number of bytes that must be read for the wanted data to be present.
+        size_t required() const { return padBefore + wanted; }
+    };
     virtual ~FileRandRead() { }
     virtual FSP read(size_t offset, vespalib::DataBuffer & buffer, size_t sz) = 0;
+    /**
+     * Prepares the buffer for reading sz bytes from offset with the returned read.
+     * When that read has completed, finishRead() makes the data available in the buffer.
+     * Returns an invalid read if not supported, in which case read() must be used.
+     */
+    virtual PreparedRead prepareRead(size_t, vespalib::DataBuffer &, size_t) { return PreparedRead(); }
+    static void finishRead(const PreparedRead & prepared, vespalib::DataBuffer & buffer);
     virtual int64_t getSize() = 0;
 };
 
@@ -10,8 +10,26 @@ LOG_SETUP(".search.docstore.randreaders");
 
 namespace search {
 
+namespace {
+
+int
+getFD(const FastOS_FileInterface & file)
+{
+    return static_cast<const FastOS_File &>(file).getFD();
+}
+
+}
+
+void
+FileRandRead::finishRead(const PreparedRead & prepared, vespalib::DataBuffer & buffer)
+{
+    buffer.moveFreeToData(prepared.padBefore + prepared.wanted);
+    buffer.moveDataToDead(prepared.padBefore);
+}
+
 DirectIORandRead::DirectIORandRead(const vespalib::string & fileName)
     : _file(std::make_unique<FastOS_File>(fileName.c_str())),
+      _fd(-1),
       _alignment(1),
       _granularity(1),
       _maxChunkSize(0x100000)
@@ -22,17 +40,18 @@ DirectIORandRead::DirectIORandRead(const vespalib::string & fileName)
             LOG(debug, "Direct IO setup failed for file %s due to %s",
                        _file->GetFileName(), _file->getLastErrorString().c_str());
         }
+        _fd = getFD(*_file);
     } else {
         throw SummaryException("Failed opening data file", *_file, VESPA_STRLOC);
     }
 }
 
-FileRandRead::FSP
-DirectIORandRead::read(size_t offset, vespalib::DataBuffer & buffer, size_t sz)
+FileRandRead::PreparedRead
+DirectIORandRead::setupBuffer(size_t offset, vespalib::DataBuffer & buffer, size_t sz, bool & directio)
 {
     size_t padBefore(0);
     size_t padAfter(0);
-    bool directio = _file->DirectIOPadding(offset, sz, padBefore, padAfter);
+    directio = _file->DirectIOPadding(offset, sz, padBefore, padAfter);
     buffer.clear();
     buffer.ensureFree(padBefore + sz + padAfter + _alignment - 1);
     if (directio) {
@@ -40,13 +59,39 @@ DirectIORandRead::read(size_t offset, vespalib::DataBuffer & buffer, size_t sz)
         buffer.moveFreeToData(unAligned);
         buffer.moveDataToDead(unAligned);
     }
+    PreparedRead prepared;
+    prepared.fd = _fd;
+    prepared.offset = offset - padBefore;
+    prepared.size = padBefore + sz + padAfter;
+    prepared.dst = buffer.getFree();
+    prepared.padBefore = padBefore;
+    prepared.wanted = sz;
+    return prepared;
+}
+
+FileRandRead::FSP
+DirectIORandRead::read(size_t offset, vespalib::DataBuffer & buffer, size_t sz)
+{
+    bool directio(false);
+    PreparedRead prepared = setupBuffer(offset, buffer, sz, directio);
     // XXX needs to use pread or file-position-mutex
-    _file->ReadBuf(buffer.getFree(), padBefore + sz + padAfter, offset - padBefore);
-    buffer.moveFreeToData(padBefore + sz);
-    buffer.moveDataToDead(padBefore);
+    _file->ReadBuf(prepared.dst, prepared.size, prepared.offset);
+    finishRead(prepared, buffer);
     return FSP();
 }
 
+FileRandRead::PreparedRead
+DirectIORandRead::prepareRead(size_t offset, vespalib::DataBuffer & buffer, size_t sz)
+{
+    bool directio(false);
+    PreparedRead prepared = setupBuffer(offset, buffer, sz, directio);
+    if (directio && ((prepared.size % _granularity) != 0)) {
+        // Unaligned tail at end of file is only handled by read()
+        return PreparedRead();
+    }
+    return prepared;
+}
+
 
 int64_t
 DirectIORandRead::getSize()
@@ -67,11 +112,13 @@ MMapRandRead::MMapRandRead(const vespalib::string & fileName, int mmapFlags, int
 
 
 NormalRandRead::NormalRandRead(const vespalib::string & fileName)
-    : _file(std::make_unique<FastOS_File>(fileName.c_str()))
+    : _file(std::make_unique<FastOS_File>(fileName.c_str())),
+      _fd(-1)
 {
     if ( ! _file->OpenReadOnly()) {
         throw SummaryException("Failed opening data file", *_file, VESPA_STRLOC);
     }
+    _fd = getFD(*_file);
 }
 
 FileRandRead::FSP
@@ -161,6 +208,20 @@ NormalRandRead::read(size_t offset, vespalib::DataBuffer & buffer, size_t sz)
     return FSP();
 }
 
+FileRandRead::PreparedRead
+NormalRandRead::prepareRead(size_t offset, vespalib::DataBuffer & buffer, size_t sz)
+{
+    buffer.clear();
+    buffer.ensureFree(sz);
+    PreparedRead prepared;
+    prepared.fd = _fd;
+    prepared.offset = offset;
+    prepared.size = sz;
+    prepared.dst = buffer.getFree();
+    prepared.wanted = sz;
+    return prepared;
+}
+
 int64_t
 NormalRandRead::getSize()
 {
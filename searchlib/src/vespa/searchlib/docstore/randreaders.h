@@ -15,9 +15,12 @@ class DirectIORandRead : public FileRandRead
 public:
     DirectIORandRead(const vespalib::string & fileName);
     FSP read(size_t offset, vespalib::DataBuffer & buffer, size_t sz) override;
+    PreparedRead prepareRead(size_t offset, vespalib::DataBuffer & buffer, size_t sz) override;
     int64_t getSize() override;
 private:
+    PreparedRead setupBuffer(size_t offset, vespalib::DataBuffer & buffer, size_t sz, bool & directio);
     std::unique_ptr<FastOS_FileInterface>  _file;
+    int                                    _fd;
     size_t                                 _alignment;
     size_t                                 _granularity;
     size_t                                 _maxChunkSize;
@@ -55,9 +58,11 @@ class NormalRandRead : public FileRandRead
 public:
     NormalRandRead(const vespalib::string & fileName);
     FSP read(size_t offset, vespalib::DataBuffer & buffer, size_t sz) override;
+    PreparedRead prepareRead(size_t offset, vespalib::DataBuffer & buffer, size_t sz) override;
     int64_t getSize() override;
 private:
     std::unique_ptr<FastOS_FileInterface>  _file;
+    int                                    _fd;
 };
 
 }
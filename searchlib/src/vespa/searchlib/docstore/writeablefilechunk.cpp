@@ -10,6 +10,7 @@
 #include <vespa/searchlib/common/fileheadercontext.h>
 #include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/util/zstdcompressor.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".search.writeablefilechunk");
@@ -23,6 +24,7 @@ using vespalib::nbostream;
 using vespalib::IllegalHeaderException;
 using vespalib::GenerationHandler;
 using search::common::FileHeaderContext;
+using vespalib::compression::CompressionConfig;
 
 namespace search {
 
@@ -80,6 +82,7 @@ WriteableFileChunk(vespalib::Executor &executor,
                    SerialNum initialSerialNum,
                    uint32_t docIdLimit,
                    const Config &config,
+                   const DictionarySP &dictionary,
                    const TuneFileSummary &tune,
                    const FileHeaderContext &fileHeaderContext,
                    const IBucketizer * bucketizer,
@@ -118,6 +121,9 @@ WriteableFileChunk(vespalib::Executor &executor,
     if (_dataFile.OpenReadWrite()) {
         readDataHeader();
         if (_dataHeaderLen == 0) {
+            if (_config.getCompression().type == CompressionConfig::ZSTD) {
+                setDictionary(dictionary);
+            }
             writeDataHeader(fileHeaderContext);
         }
         _dataFile.SetPosition(_dataFile.GetSize());
@@ -290,7 +296,7 @@ WriteableFileChunk::internalFlush(uint32_t chunkId, uint64_t serialNum)
     if (_alignment > 1) {
         tmp->getBuf().ensureFree(active->getMaxPackSize(_config.getCompression()) + _alignment - 1);
     }
-    active->pack(serialNum, tmp->getBuf(), _config.getCompression());
+    active->pack(serialNum, tmp->getBuf(), _config.getCompression(), _dictionary.get());
     tmp->setPayLoad();
     if (_alignment > 1) {
         const size_t padAfter((_alignment - tmp->getPayLoad() % _alignment) % _alignment);
@@ -724,6 +730,7 @@ WriteableFileChunk::readDataHeader()
         FileHeader h;
         _dataHeaderLen = h.readFile(_dataFile);
         _dataFile.SetPosition(_dataHeaderLen);
+        setDictionary(readDictionary(h));
     } catch (IllegalHeaderException &e) {
         _dataFile.SetPosition(0);
         try {
@@ -790,9 +797,23 @@ WriteableFileChunk::writeDataHeader(const FileHeaderContext &fileHeaderContext)
     assert(_dataFile.GetPosition() == 0);
     fileHeaderContext.addTags(h, _dataFile.GetFileName());
     h.putTag(Tag("desc", "Log data store chunk data"));
+    if (_dictionary) {
+        writeDictionary(h, *_dictionary);
+    }
     _dataHeaderLen = h.writeFile(_dataFile);
 }
 
+void
+WriteableFileChunk::setDictionary(const DictionarySP & dictionary)
+{
+    // The dictionary used for reading the file is also prepared for compressing new chunks.
+    if (dictionary && (_config.getCompression().type == CompressionConfig::ZSTD)) {
+        _dictionary = std::make_shared<ZStdDictionary>(dictionary->getBuffer(), _config.getCompression().compressionLevel);
+    } else {
+        _dictionary = dictionary;
+    }
+}
+
 
 uint64_t
 WriteableFileChunk::writeIdxHeader(const FileHeaderContext &fileHeaderContext, uint32_t docIdLimit, FastOS_FileInterface &file)
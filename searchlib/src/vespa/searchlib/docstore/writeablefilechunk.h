@@ -44,7 +44,7 @@ public:
     typedef std::unique_ptr<WriteableFileChunk> UP;
     WriteableFileChunk(vespalib::Executor & executor, FileId fileId, NameId nameId,
                        const vespalib::string & baseName, uint64_t initialSerialNum,
-                       uint32_t docIdLimit, const Config & config,
+                       uint32_t docIdLimit, const Config & config, const DictionarySP & dictionary,
                        const TuneFileSummary &tune, const common::FileHeaderContext &fileHeaderContext,
                        const IBucketizer * bucketizer, bool crcOnReadDisabled);
     ~WriteableFileChunk() override;
@@ -86,6 +86,7 @@ private:
     void restart(uint32_t nextChunkId);
     ProcessedChunkQ drainQ(vespalib::MonitorGuard & guard);
     void readDataHeader();
+    void setDictionary(const DictionarySP & dictionary);
     void readIdxHeader(FastOS_FileInterface & idxFile);
     void writeDataHeader(const common::FileHeaderContext &fileHeaderContext);
     bool needFlushPendingChunks(uint64_t serialNum, uint64_t datFileLen);
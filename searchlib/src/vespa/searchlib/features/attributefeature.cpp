@@ -118,6 +118,8 @@ public:
         o[3].as_number = 1;  // count
     }
     void execute(uint32_t docId) override;
+    void execute_batch(vespalib::ConstArrayRef<uint32_t> docids) override;
+    bool supports_batch() const override { return true; }
 };
 
 class BoolAttributeExecutor final : public fef::FeatureExecutor {
@@ -130,6 +132,7 @@ public:
     void execute(uint32_t docId) override {
         outputs().set_number(0, _attribute.getFloat(docId));
     }
+    bool supports_batch() const override { return true; }
 };
 
 /**
@@ -143,6 +146,7 @@ private:
 public:
     MultiAttributeExecutor(const T & attribute, uint32_t idx) : _attribute(attribute), _idx(idx) { }
     void execute(uint32_t docId) override;
+    bool supports_batch() const override { return true; }
     void handle_bind_outputs(vespalib::ArrayRef<fef::NumberOrObject> outputs_in) override {
         fef::FeatureExecutor::handle_bind_outputs(outputs_in);
         auto o = outputs().get_bound();
@@ -159,6 +163,7 @@ private:
 public:
     CountOnlyAttributeExecutor(const attribute::IAttributeVector & attribute) : _attribute(attribute) { }
     void execute(uint32_t docId) override;
+    bool supports_batch() const override { return true; }
     void handle_bind_outputs(vespalib::ArrayRef<fef::NumberOrObject> outputs_in) override {
         fef::FeatureExecutor::handle_bind_outputs(outputs_in);
         auto o = outputs().get_bound();
@@ -188,6 +193,7 @@ public:
      */
     AttributeExecutor(const attribute::IAttributeVector * attribute, uint32_t idx);
     void execute(uint32_t docId) override;
+    bool supports_batch() const override { return true; }
     void handle_bind_outputs(vespalib::ArrayRef<fef::NumberOrObject> outputs_in) override {
         fef::FeatureExecutor::handle_bind_outputs(outputs_in);
         auto o = outputs().get_bound();
@@ -220,6 +226,7 @@ public:
      */
     WeightedSetAttributeExecutor(const attribute::IAttributeVector * attribute, T key, bool useKey);
     void execute(uint32_t docId) override;
+    bool supports_batch() const override { return true; }
 };
 
 template <typename T>
@@ -234,6 +241,24 @@ SingleAttributeExecutor<T>::execute(uint32_t docId)
                      : util::getAsFeature(v);
 }
 
+template <typename T>
+void
+SingleAttributeExecutor<T>::execute_batch(vespalib::ConstArrayRef<uint32_t> docids)
+{
+    feature_t *values = outputs().get_number_column(0);
+    for (size_t i = 0; i < docids.size(); ++i) {
+        typename T::LoadedValueType v = _attribute.getFast(docids[i]);
+        values[i] = __builtin_expect(attribute::isUndefined(v), false)
+                    ? attribute::getUndefined<feature_t>()
+                    : util::getAsFeature(v);
+    }
+    // weight, contains and count are constant
+    for (size_t out_idx = 1; out_idx < outputs().size(); ++out_idx) {
+        feature_t *column = outputs().get_number_column(out_idx);
+        std::fill(column, column + docids.size(), outputs().get_number(out_idx));
+    }
+}
+
 template <typename T>
 void
 MultiAttributeExecutor<T>::execute(uint32_t docId)
@@ -458,7 +483,7 @@ createTensorAttributeExecutor(const IAttributeVector *attribute, const vespalib:
                 " Returning empty tensor.", attribute->getName().c_str());
         return ConstantTensorExecutor::createEmpty(tensorType, stash);
     }
-    if (tensorType != tensorAttribute->getTensorType()) {
+    if (tensorType != tensorAttribute->getTensorType().decay_cell_type()) {
         LOG(warning, "The tensor attribute '%s' has tensor type '%s',"
                 " while the feature executor expects type '%s'. Returning empty tensor.",
                 attribute->getName().c_str(),
@@ -511,7 +536,8 @@ AttributeBlueprint::setup(const fef::IIndexEnvironment & env,
     }
     vespalib::string attrType = type::Attribute::lookup(env.getProperties(), _attrName);
     if (!attrType.empty()) {
-        _tensorType = ValueType::from_spec(attrType);
+        // tensors with storage cell types are exposed with float cells
+        _tensorType = ValueType::from_storage_spec(attrType).decay_cell_type();
         if (_tensorType.is_error()) {
             LOG(error, "%s: invalid type: '%s'", getName().c_str(), attrType.c_str());
         }
@@ -2,24 +2,38 @@
 
 #include "dense_tensor_attribute_executor.h"
 #include <vespa/searchlib/tensor/i_tensor_attribute.h>
+#include <vespa/searchlib/tensor/dense_tensor_store.h>
 
+using search::tensor::DenseTensorStore;
 using search::tensor::ITensorAttribute;
 using vespalib::eval::Tensor;
 using vespalib::tensor::MutableDenseTensorView;
+using vespalib::tensor::TypedCells;
 
 namespace search::features {
 
 DenseTensorAttributeExecutor::
 DenseTensorAttributeExecutor(const ITensorAttribute *attribute)
     : _attribute(attribute),
-      _tensorView(_attribute->getTensorType())
+      _storedView(_attribute->getTensorType()),
+      _tensorView(_attribute->getTensorType().decay_cell_type()),
+      _decodedCells()
 {
+    if (_attribute->getTensorType().has_storage_cell_type()) {
+        _decodedCells.resize(_tensorView.fast_type().dense_subspace_size());
+        _tensorView.setCells(TypedCells(_decodedCells));
+    }
 }
 
 void
 DenseTensorAttributeExecutor::execute(uint32_t docId)
 {
-    _attribute->getTensor(docId, _tensorView);
+    if (_decodedCells.empty()) {
+        _attribute->getTensor(docId, _tensorView);
+    } else {
+        _attribute->getTensor(docId, _storedView);
+        DenseTensorStore::decode_cells(_storedView.cellsRef(), _decodedCells.data());
+    }
     outputs().set_object(0, _tensorView);
 }
 
@@ -11,13 +11,16 @@ namespace search::features {
 
 /**
  * Executor for extracting dense tensors from an underlying dense tensor attribute
- * without copying cells data.
+ * without copying cells data. Cells stored with a storage cell type (int8, bfloat16)
+ * are widened to float.
  */
 class DenseTensorAttributeExecutor : public fef::FeatureExecutor
 {
 private:
     const search::tensor::ITensorAttribute *_attribute;
+    vespalib::tensor::MutableDenseTensorView _storedView;
     vespalib::tensor::MutableDenseTensorView _tensorView;
+    std::vector<float> _decodedCells;
 
 public:
     DenseTensorAttributeExecutor(const search::tensor::ITensorAttribute *attribute);
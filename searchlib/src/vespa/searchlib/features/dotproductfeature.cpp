@@ -159,6 +159,7 @@ public:
     DotProductExecutorByEnum(const IWeightedIndexVector * attribute, std::unique_ptr<V> queryVector);
     ~DotProductExecutorByEnum() override;
     void execute(uint32_t docId) override;
+    bool supports_batch() const override { return true; }
 };
 
 DotProductExecutorByEnum::DotProductExecutorByEnum(const IWeightedIndexVector * attribute, const V & queryVector)
@@ -215,6 +216,7 @@ public:
         }
         outputs().set_number(0, 0);
     }
+    bool supports_batch() const override { return true; }
 private:
     const IWeightedIndexVector * _attribute;
     EnumHandle                   _key;
@@ -241,6 +243,7 @@ public:
         }
         outputs().set_number(0, 0);
     }
+    bool supports_batch() const override { return true; }
 private:
     const A               * _attribute;
     typename A::BaseType    _key;
@@ -129,6 +129,7 @@ public:
     DotProductExecutorBase(const V & queryVector);
     ~DotProductExecutorBase() override;
     void execute(uint32_t docId) override;
+    bool supports_batch() const override { return true; }
 };
 
 template <typename A>
@@ -164,6 +165,7 @@ public:
     DotProductExecutorByCopy(const attribute::IAttributeVector * attribute, std::unique_ptr<Vector> queryVector);
     ~DotProductExecutorByCopy() override;
     void execute(uint32_t docId) override;
+    bool supports_batch() const override { return true; }
 };
 
 }
@@ -188,6 +190,7 @@ public:
     DotProductExecutorBase(const V & queryVector);
     ~DotProductExecutorBase() override;
     void execute(uint32_t docId) final override;
+    bool supports_batch() const override { return true; }
 };
 
 /**
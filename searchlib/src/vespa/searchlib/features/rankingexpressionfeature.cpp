@@ -14,6 +14,7 @@ LOG_SETUP(".features.rankingexpression");
 using search::fef::FeatureType;
 using vespalib::ArrayRef;
 using vespalib::ConstArrayRef;
+using vespalib::eval::BatchFunction;
 using vespalib::eval::CompileCache;
 using vespalib::eval::CompiledFunction;
 using vespalib::eval::DoubleValue;
@@ -25,6 +26,7 @@ using vespalib::eval::PassParams;
 using vespalib::eval::Value;
 using vespalib::eval::ValueType;
 using vespalib::eval::gbdt::FastForest;
+using vespalib::eval::gbdt::Optimize;
 using vespalib::tensor::DefaultTensorEngine;
 
 namespace search::features {
@@ -39,6 +41,9 @@ vespalib::string list_issues(const std::vector<vespalib::string> &issues) {
     return result;
 }
 
+// use fast forest for forests without set membership checks, otherwise select as usual
+Optimize::Chain fast_forest_optimizers({FastForest::optimize, Optimize::select_best});
+
 } // namespace search::features::<unnamed>
 
 //-----------------------------------------------------------------------------
@@ -52,11 +57,14 @@ private:
     const FastForest &_forest;
     FastForest::Context::UP _ctx;
     ArrayRef<float> _params;
+    std::vector<const double *> _batch_params;
 
 public:
     FastForestExecutor(ArrayRef<float> param_space, const FastForest &forest);
     bool isPure() override { return true; }
+    bool supports_batch() const override { return true; }
     void execute(uint32_t docId) override;
+    void execute_batch(ConstArrayRef<uint32_t> docids) override;
 };
 
 //-----------------------------------------------------------------------------
@@ -70,11 +78,16 @@ private:
     typedef double (*arr_function)(const double *);
     arr_function _ranking_function;
     std::vector<double> _params;
+    const BatchFunction *_batch_function;
+    std::unique_ptr<BatchFunction::Context> _batch_context;
+    std::vector<const double *> _batch_params;
 
 public:
-    CompiledRankingExpressionExecutor(const CompiledFunction &compiled_function);
+    CompiledRankingExpressionExecutor(const CompiledFunction &compiled_function, const BatchFunction *batch_function);
     bool isPure() override { return true; }
+    bool supports_batch() const override { return true; }
     void execute(uint32_t docId) override;
+    void execute_batch(ConstArrayRef<uint32_t> docids) override;
 };
 
 //-----------------------------------------------------------------------------
@@ -132,7 +145,8 @@ public:
 FastForestExecutor::FastForestExecutor(ArrayRef<float> param_space, const FastForest &forest)
     : _forest(forest),
       _ctx(_forest.create_context()),
-      _params(param_space)
+      _params(param_space),
+      _batch_params(param_space.size(), nullptr)
 {
 }
 
@@ -152,11 +166,24 @@ FastForestExecutor::execute(uint32_t)
     outputs().set_number(0, _forest.eval(*_ctx, &_params[0]));
 }
 
+void
+FastForestExecutor::execute_batch(ConstArrayRef<uint32_t> docids)
+{
+    for (size_t i = 0; i < _batch_params.size(); ++i) {
+        _batch_params[i] = inputs().get_number_column(i);
+    }
+    _forest.eval_batch(*_ctx, _batch_params, docids.size(), outputs().get_number_column(0));
+}
+
 //-----------------------------------------------------------------------------
 
-CompiledRankingExpressionExecutor::CompiledRankingExpressionExecutor(const CompiledFunction &compiled_function)
+CompiledRankingExpressionExecutor::CompiledRankingExpressionExecutor(const CompiledFunction &compiled_function,
+                                                                     const BatchFunction *batch_function)
     : _ranking_function(compiled_function.get_function()),
-      _params(compiled_function.num_params(), 0.0)
+      _params(compiled_function.num_params(), 0.0),
+      _batch_function(batch_function),
+      _batch_context(),
+      _batch_params(compiled_function.num_params(), nullptr)
 {
 }
 
@@ -176,6 +203,29 @@ CompiledRankingExpressionExecutor::execute(uint32_t)
     outputs().set_number(0, _ranking_function(&_params[0]));
 }
 
+void
+CompiledRankingExpressionExecutor::execute_batch(ConstArrayRef<uint32_t> docids)
+{
+    feature_t *result = outputs().get_number_column(0);
+    if (_batch_function != nullptr) {
+        for (size_t i = 0; i < _batch_params.size(); ++i) {
+            _batch_params[i] = inputs().get_number_column(i);
+        }
+        if (!_batch_context) {
+            _batch_context = std::make_unique<BatchFunction::Context>(*_batch_function);
+        }
+        auto values = _batch_function->eval(*_batch_context, _batch_params, docids.size());
+        std::copy(values.begin(), values.end(), result);
+        return;
+    }
+    for (size_t doc = 0; doc < docids.size(); ++doc) {
+        for (size_t i = 0; i < _params.size(); ++i) {
+            _params[i] = inputs().get_number_column(i)[doc];
+        }
+        result[doc] = _ranking_function(&_params[0]);
+    }
+}
+
 //-----------------------------------------------------------------------------
 
 namespace {
@@ -223,6 +273,7 @@ RankingExpressionBlueprint::RankingExpressionBlueprint(rankingexpression::Expres
       _expression_replacer(std::move(replacer)),
       _intrinsic_expression(),
       _fast_forest(),
+      _batch_function(),
       _interpreted_function(),
       _compile_token(),
       _input_is_object()
@@ -317,11 +368,21 @@ RankingExpressionBlueprint::setup(const fef::IIndexEnvironment &env,
                 _fast_forest = FastForest::try_convert(*rank_function);
             }
             if (!_fast_forest) {
+                // forests that are part of a larger expression may still use fast forest evaluation
+                const auto &forest_optimizers = fef::indexproperties::eval::UseFastForest::check(env.getProperties())
+                                                ? fast_forest_optimizers : Optimize::best;
                 bool suggest_lazy = CompiledFunction::should_use_lazy_params(*rank_function);
                 if (fef::indexproperties::eval::LazyExpressions::check(env.getProperties(), suggest_lazy)) {
-                    _compile_token = CompileCache::compile(*rank_function, PassParams::LAZY);
+                    _compile_token = CompileCache::compile(*rank_function, PassParams::LAZY, forest_optimizers);
                 } else {
-                    _compile_token = CompileCache::compile(*rank_function, PassParams::ARRAY);
+                    _compile_token = CompileCache::compile(*rank_function, PassParams::ARRAY, forest_optimizers);
+                    // vectorized evaluation is used when documents are ranked in batches
+                    uint32_t batch_size = (env.getFeatureMotivation() == env.FeatureMotivation::SECOND_PHASE_RANK)
+                                          ? fef::indexproperties::matching::SecondPhaseRankBatchSize::lookup(env.getProperties())
+                                          : fef::indexproperties::matching::RankBatchSize::lookup(env.getProperties());
+                    if (fef::indexproperties::eval::UseBatchFunctions::check(env.getProperties()) && (batch_size > 0)) {
+                        _batch_function = std::make_unique<BatchFunction>(*rank_function);
+                    }
                 }
             }
         } else {
@@ -365,7 +426,7 @@ RankingExpressionBlueprint::createExecutor(const fef::IQueryEnvironment &env, ve
     }
     assert(_compile_token.get() != nullptr); // will be nullptr for VERIFY_SETUP feature motivation
     if (_compile_token->get().pass_params() == PassParams::ARRAY) {
-        return stash.create<CompiledRankingExpressionExecutor>(_compile_token->get());
+        return stash.create<CompiledRankingExpressionExecutor>(_compile_token->get(), _batch_function.get());
     } else {
         assert(_compile_token->get().pass_params() == PassParams::LAZY);
         return stash.create<LazyCompiledRankingExpressionExecutor>(_compile_token->get());
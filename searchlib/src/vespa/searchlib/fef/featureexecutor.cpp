@@ -2,6 +2,7 @@
 
 #include "featureexecutor.h"
 #include <vespa/vespalib/util/classname.h>
+#include <cassert>
 
 namespace search::fef {
 
@@ -20,6 +21,27 @@ FeatureExecutor::isPure()
     return false;
 }
 
+bool
+FeatureExecutor::supports_batch() const
+{
+    return false;
+}
+
+void
+FeatureExecutor::execute_batch(vespalib::ConstArrayRef<uint32_t> docids)
+{
+    for (size_t i = 0; i < docids.size(); ++i) {
+        _inputs.set_docid(docids[i]);
+        execute(docids[i]);
+        for (size_t out_idx = 0; out_idx < _outputs.size(); ++out_idx) {
+            feature_t *column = _outputs.get_number_column(out_idx);
+            if (column != nullptr) {
+                column[i] = _outputs.get_number(out_idx);
+            }
+        }
+    }
+}
+
 void
 FeatureExecutor::handle_bind_inputs(vespalib::ConstArrayRef<LazyValue>)
 {
@@ -49,6 +71,15 @@ FeatureExecutor::bind_outputs(vespalib::ArrayRef<NumberOrObject> outputs)
     handle_bind_outputs(outputs);
 }
 
+void
+FeatureExecutor::bind_columns(vespalib::ConstArrayRef<const feature_t *> inputs, vespalib::ArrayRef<feature_t *> outputs)
+{
+    assert(inputs.size() == _inputs.size());
+    assert(outputs.size() == _outputs.size());
+    _inputs.bind_columns(inputs);
+    _outputs.bind_columns(outputs);
+}
+
 void
 FeatureExecutor::bind_match_data(const MatchData &md)
 {
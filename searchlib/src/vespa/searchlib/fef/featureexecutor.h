@@ -47,21 +47,26 @@ public:
     class Inputs {
         uint32_t _docid;
         vespalib::ConstArrayRef<LazyValue> _inputs;
+        vespalib::ConstArrayRef<const feature_t *> _columns;
     public:
-        Inputs() : _docid(-1), _inputs() {}
+        Inputs() : _docid(-1), _inputs(), _columns() {}
         void set_docid(uint32_t docid) { _docid = docid; }
         uint32_t get_docid() const { return _docid; }
         void bind(vespalib::ConstArrayRef<LazyValue> inputs) { _inputs = inputs; }
+        void bind_columns(vespalib::ConstArrayRef<const feature_t *> columns) { _columns = columns; }
         inline feature_t get_number(size_t idx) const;
         inline vespalib::eval::Value::CREF get_object(size_t idx) const;
+        // number values of an input for all documents in a batch (nullptr for object inputs)
+        const feature_t *get_number_column(size_t idx) const { return _columns[idx]; }
         size_t size() const { return _inputs.size(); }
     };
 
     class Outputs {
     public:
         using OutputArray = vespalib::ArrayRef<NumberOrObject>;
-        Outputs() : _outputs() {}
+        Outputs() : _outputs(), _columns() {}
         void bind(OutputArray  outputs) { _outputs = outputs; }
+        void bind_columns(vespalib::ArrayRef<feature_t *> columns) { _columns = columns; }
         void set_number(size_t idx, feature_t value) {
             _outputs[idx].as_number = value;
         }
@@ -86,9 +91,14 @@ public:
         OutputArray get_bound() const {
             return _outputs;
         }
+        // number values of an output for all documents in a batch (nullptr for object outputs)
+        feature_t *get_number_column(size_t idx) const {
+            return _columns[idx];
+        }
         size_t size() const { return _outputs.size(); }
     private:
         vespalib::ArrayRef<NumberOrObject> _outputs;
+        vespalib::ArrayRef<feature_t *>    _columns;
     };
 
 private:
@@ -110,6 +120,18 @@ protected:
      **/
     virtual void execute(uint32_t docId) = 0;
 
+    /**
+     * Execute this feature executor for a batch of documents. The
+     * number value of each output for docids[i] is stored at index i
+     * of the output column, and the number values of non-constant
+     * inputs are found at the same index of the input columns. The
+     * default implementation executes the documents one by one, and
+     * is only valid for executors that have no non-constant inputs.
+     *
+     * @param docids the local document ids being evaluated
+     **/
+    virtual void execute_batch(vespalib::ConstArrayRef<uint32_t> docids);
+
 public:
     /**
      * Create a feature executor that has not yet been bound to neither
@@ -150,6 +172,37 @@ public:
      **/
     virtual bool isPure();
 
+    /**
+     * Check if this feature executor can be evaluated for a batch of
+     * documents at once. Executors supporting this must produce only
+     * number outputs that do not depend on match data, since the match
+     * data only describes the last unpacked document when a batch is
+     * evaluated. This method is implemented to return false by
+     * default.
+     *
+     * @return true if this feature executor supports batch evaluation
+     **/
+    virtual bool supports_batch() const;
+
+    /**
+     * Bind the columns used when this executor is evaluated for a
+     * batch of documents. Must be called after the outputs have been
+     * bound.
+     **/
+    void bind_columns(vespalib::ConstArrayRef<const feature_t *> inputs, vespalib::ArrayRef<feature_t *> outputs);
+
+    /**
+     * Execute this executor for a batch of documents, storing the
+     * values in the output columns. The (single) output values are
+     * left undefined afterwards.
+     *
+     * @param docids the local document ids being evaluated
+     **/
+    void batch_execute(vespalib::ConstArrayRef<uint32_t> docids) {
+        _inputs.set_docid(-1);
+        execute_batch(docids);
+    }
+
     /**
      * Make sure this executor has been executed for the given
      * document.
@@ -23,16 +23,19 @@ public:
     /**
      * This enum defines the different motivations the framework has
      * for configuring a feature blueprint. RANK means the feature is
-     * needed for ranking calculations in normal operation. DUMP means
-     * the feature is needed to perform a feature dump. VERIFY_SETUP
-     * means that we are just trying to figure out if this setup is
-     * valid; the feature will never actually be executed.
+     * needed for ranking calculations in normal operation.
+     * SECOND_PHASE_RANK is the same as RANK, but for the second
+     * ranking phase. DUMP means the feature is needed to perform a
+     * feature dump. VERIFY_SETUP means that we are just trying to
+     * figure out if this setup is valid; the feature will never
+     * actually be executed.
      **/
     enum FeatureMotivation {
         UNKNOWN = 0,
         RANK = 1,
         DUMP = 2,
-        VERIFY_SETUP = 3
+        VERIFY_SETUP = 3,
+        SECOND_PHASE_RANK = 4
     };
 
     /**
@@ -88,6 +88,10 @@ const vespalib::string UseFastForest::NAME("vespa.eval.use_fast_forest");
 const bool UseFastForest::DEFAULT_VALUE(false);
 bool UseFastForest::check(const Properties &props) { return lookupBool(props, NAME, DEFAULT_VALUE); }
 
+const vespalib::string UseBatchFunctions::NAME("vespa.eval.use_batch_functions");
+const bool UseBatchFunctions::DEFAULT_VALUE(true);
+bool UseBatchFunctions::check(const Properties &props) { return lookupBool(props, NAME, DEFAULT_VALUE); }
+
 } // namespace eval
 
 namespace rank {
@@ -229,6 +233,36 @@ TermwiseLimit::lookup(const Properties &props, double defaultValue)
     return lookupDouble(props, NAME, defaultValue);
 }
 
+const vespalib::string RankBatchSize::NAME("vespa.matching.rank_batch_size");
+const uint32_t RankBatchSize::DEFAULT_VALUE(0);
+
+uint32_t
+RankBatchSize::lookup(const Properties &props)
+{
+    return lookup(props, DEFAULT_VALUE);
+}
+
+uint32_t
+RankBatchSize::lookup(const Properties &props, uint32_t defaultValue)
+{
+    return lookupUint32(props, NAME, defaultValue);
+}
+
+const vespalib::string SecondPhaseRankBatchSize::NAME("vespa.matching.second_phase.rank_batch_size");
+const uint32_t SecondPhaseRankBatchSize::DEFAULT_VALUE(64);
+
+uint32_t
+SecondPhaseRankBatchSize::lookup(const Properties &props)
+{
+    return lookup(props, DEFAULT_VALUE);
+}
+
+uint32_t
+SecondPhaseRankBatchSize::lookup(const Properties &props, uint32_t defaultValue)
+{
+    return lookupUint32(props, NAME, defaultValue);
+}
+
 const vespalib::string NumThreadsPerSearch::NAME("vespa.matching.numthreadspersearch");
 const uint32_t NumThreadsPerSearch::DEFAULT_VALUE(std::numeric_limits<uint32_t>::max());
 
@@ -244,6 +278,21 @@ NumThreadsPerSearch::lookup(const Properties &props, uint32_t defaultValue)
     return lookupUint32(props, NAME, defaultValue);
 }
 
+const vespalib::string WorkStealing::NAME("vespa.matching.work_stealing");
+const bool WorkStealing::DEFAULT_VALUE(false);
+
+bool
+WorkStealing::check(const Properties &props)
+{
+    return check(props, DEFAULT_VALUE);
+}
+
+bool
+WorkStealing::check(const Properties &props, bool defaultValue)
+{
+    return lookupBool(props, NAME, defaultValue);
+}
+
 const vespalib::string NumSearchPartitions::NAME("vespa.matching.numsearchpartitions");
 const uint32_t NumSearchPartitions::DEFAULT_VALUE(1);
 
@@ -290,6 +339,22 @@ NearestNeighborBruteForceLimit::lookup(const Properties &props, double defaultVa
     return lookupDouble(props, NAME, defaultValue);
 }
 
+const vespalib::string NearestNeighborTargetHitsMaxAdjustmentFactor::NAME("vespa.matching.nearest_neighbor.target_hits_max_adjustment_factor");
+
+const double NearestNeighborTargetHitsMaxAdjustmentFactor::DEFAULT_VALUE(20.0);
+
+double
+NearestNeighborTargetHitsMaxAdjustmentFactor::lookup(const Properties &props)
+{
+    return lookup(props, DEFAULT_VALUE);
+}
+
+double
+NearestNeighborTargetHitsMaxAdjustmentFactor::lookup(const Properties &props, double defaultValue)
+{
+    return lookupDouble(props, NAME, defaultValue);
+}
+
 const vespalib::string GlobalFilterLimit::NAME("vespa.matching.global_filter_limit");
 
 const double GlobalFilterLimit::DEFAULT_VALUE(0.0);
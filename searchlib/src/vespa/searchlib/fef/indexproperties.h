@@ -33,6 +33,15 @@ struct UseFastForest {
     static bool check(const Properties &props);
 };
 
+// use vectorized evaluation of compiled expressions when ranking documents in batches. only
+// affects rank phases with a batch size above 0 (vespa.matching.rank_batch_size for first
+// phase and vespa.matching.second_phase.rank_batch_size for second phase)
+struct UseBatchFunctions {
+    static const vespalib::string NAME;
+    static const bool DEFAULT_VALUE;
+    static bool check(const Properties &props);
+};
+
 } // namespace eval
 
 namespace rank {
@@ -176,6 +185,34 @@ namespace matching {
         static double lookup(const Properties &props, double defaultValue);
     };
 
+    /**
+     * The number of hits ranked together when the first phase rank
+     * program is evaluated in batches. Features depending on match
+     * data are still calculated for each hit, while the executors
+     * supporting it calculate their values for all hits in a batch at
+     * once. 0 (the default) disables batched evaluation.
+     **/
+    struct RankBatchSize {
+        static const vespalib::string NAME;
+        static const uint32_t DEFAULT_VALUE;
+        static uint32_t lookup(const Properties &props);
+        static uint32_t lookup(const Properties &props, uint32_t defaultValue);
+    };
+
+    /**
+     * The number of hits re-ranked together when the second phase
+     * rank program is evaluated in batches. Used when the rank
+     * program has executors that can calculate their values for a
+     * batch of hits at once, like large tree ensembles. 0 disables
+     * batched evaluation.
+     **/
+    struct SecondPhaseRankBatchSize {
+        static const vespalib::string NAME;
+        static const uint32_t DEFAULT_VALUE;
+        static uint32_t lookup(const Properties &props);
+        static uint32_t lookup(const Properties &props, uint32_t defaultValue);
+    };
+
     /**
      * Property for the number of threads used per search.
      **/
@@ -194,6 +231,18 @@ namespace matching {
         static uint32_t lookup(const Properties &props);
         static uint32_t lookup(const Properties &props, uint32_t defaultValue);
     };
+    /**
+     * When enabled, match threads share the docid space through a
+     * lock-free work stealing scheduler instead of the scheduler
+     * selected by the number of search partitions.
+     **/
+    struct WorkStealing {
+        static const vespalib::string NAME;
+        static const bool DEFAULT_VALUE;
+        static bool check(const Properties &props);
+        static bool check(const Properties &props, bool defaultValue);
+    };
+
     /**
      * Property for the number of partitions inside the docid space.
      * A partition is a unit of work for the search threads.
@@ -219,6 +268,20 @@ namespace matching {
         static double lookup(const Properties &props, double defaultValue);
     };
 
+    /**
+     * Property to control how much the number of neighbors to explore
+     * is increased for nearest neighbor query terms searching the
+     * index with a global filter. The number of neighbors to explore
+     * is divided by the ratio of candidates in the global filter, but
+     * is increased by at most this factor.
+     **/
+    struct NearestNeighborTargetHitsMaxAdjustmentFactor {
+        static const vespalib::string NAME;
+        static const double DEFAULT_VALUE;
+        static double lookup(const Properties &props);
+        static double lookup(const Properties &props, double defaultValue);
+    };
+
     /**
      * Property to control fallback to not building a global filter
      * for a query with a blueprint that wants a global filter. If the
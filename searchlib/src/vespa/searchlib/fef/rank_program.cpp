@@ -161,7 +161,12 @@ RankProgram::RankProgram(BlueprintResolver::SP resolver)
       _cold_stash(),
       _executors(),
       _unboxed_seeds(),
-      _is_const()
+      _is_const(),
+      _batch_size(0),
+      _batch_executors(),
+      _batch_sources(),
+      _batch_docids(),
+      _batch_seed(nullptr)
 {
 }
 
@@ -239,6 +244,105 @@ RankProgram::setup(const MatchData &md,
     }
 }
 
+bool
+RankProgram::setup_batch(uint32_t batch_size)
+{
+    assert(_batch_size == 0);
+    const auto &specs = _resolver->getExecutorSpecs();
+    const auto &seeds = _resolver->getSeedMap();
+    if ((batch_size == 0) || (seeds.size() != 1)) {
+        return false;
+    }
+    auto seed = seeds.begin()->second;
+    if (specs[seed.executor].output_types[seed.output].is_object() ||
+        check_const(_executors[seed.executor]->outputs().get_raw(seed.output)))
+    {
+        return false;
+    }
+    // executors are only evaluated in batches when all executors using their values are
+    std::vector<uint32_t> consumers(_executors.size(), 0);
+    std::vector<uint32_t> batched_consumers(_executors.size(), 0);
+    std::vector<bool> batched(_executors.size(), false);
+    for (size_t i = _executors.size(); i-- > 0; ) {
+        if ((i != seed.executor) && (consumers[i] == 0)) {
+            continue;
+        }
+        FeatureExecutor *executor = _executors[i];
+        bool batch = executor->supports_batch() && (consumers[i] == batched_consumers[i]) &&
+                     (executor->outputs().size() > 0) && !check_const(executor->outputs().get_raw(0));
+        for (const auto &type: specs[i].output_types) {
+            batch = batch && !type.is_object();
+        }
+        for (const auto &ref: specs[i].inputs) {
+            const NumberOrObject *input_value = _executors[ref.executor]->outputs().get_raw(ref.output);
+            if (!check_const(input_value) && specs[ref.executor].output_types[ref.output].is_object()) {
+                batch = false;
+            }
+        }
+        batched[i] = batch;
+        for (const auto &ref: specs[i].inputs) {
+            ++consumers[ref.executor];
+            if (batch) {
+                ++batched_consumers[ref.executor];
+            }
+        }
+    }
+    if (!batched[seed.executor]) {
+        return false;
+    }
+    std::map<const NumberOrObject *, feature_t *> columns;
+    for (size_t i = 0; i < _executors.size(); ++i) {
+        if (!batched[i]) {
+            continue;
+        }
+        FeatureExecutor *executor = _executors[i];
+        size_t num_inputs = specs[i].inputs.size();
+        vespalib::ArrayRef<const feature_t *> input_columns = _hot_stash.create_array<const feature_t *>(num_inputs, nullptr);
+        for (size_t input_idx = 0; input_idx < num_inputs; ++input_idx) {
+            auto ref = specs[i].inputs[input_idx];
+            if (specs[ref.executor].output_types[ref.output].is_object()) {
+                continue;
+            }
+            FeatureExecutor *input_executor = _executors[ref.executor];
+            const NumberOrObject *input_value = input_executor->outputs().get_raw(ref.output);
+            auto pos = columns.find(input_value);
+            if (pos == columns.end()) {
+                // constant values and values from executors not evaluated in batches
+                feature_t *column = _hot_stash.create_array<feature_t>(batch_size, input_value->as_number).begin();
+                if (!check_const(input_value)) {
+                    _batch_sources.emplace_back(LazyValue(input_value, input_executor), column);
+                }
+                pos = columns.emplace(input_value, column).first;
+            }
+            input_columns[input_idx] = pos->second;
+        }
+        size_t num_outputs = specs[i].output_types.size();
+        vespalib::ArrayRef<feature_t *> output_columns = _hot_stash.create_array<feature_t *>(num_outputs, nullptr);
+        for (size_t output_idx = 0; output_idx < num_outputs; ++output_idx) {
+            output_columns[output_idx] = _hot_stash.create_array<feature_t>(batch_size, 0.0).begin();
+            columns.emplace(executor->outputs().get_raw(output_idx), output_columns[output_idx]);
+        }
+        executor->bind_columns(input_columns, output_columns);
+        _batch_executors.push_back(executor);
+    }
+    _batch_seed = columns[_executors[seed.executor]->outputs().get_raw(seed.output)];
+    _batch_docids.reserve(batch_size);
+    _batch_size = batch_size;
+    LOG(debug, "Batch size = %u, batched executors = %zu, batch sources = %zu",
+        _batch_size, _batch_executors.size(), _batch_sources.size());
+    return true;
+}
+
+vespalib::ConstArrayRef<feature_t>
+RankProgram::execute_batch()
+{
+    vespalib::ConstArrayRef<uint32_t> docids(_batch_docids);
+    for (FeatureExecutor *executor: _batch_executors) {
+        executor->batch_execute(docids);
+    }
+    return vespalib::ConstArrayRef<feature_t>(_batch_seed, docids.size());
+}
+
 FeatureResolver
 RankProgram::get_seeds(bool unbox_seeds) const
 {
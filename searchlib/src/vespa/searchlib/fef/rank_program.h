@@ -34,12 +34,23 @@ private:
     using ValueSet = vespalib::hash_set<const NumberOrObject *, vespalib::hash<const NumberOrObject *>,
                                         std::equal_to<>, vespalib::hashtable_base::and_modulator>;
 
+    struct BatchSource {
+        LazyValue  value;
+        feature_t *column;
+        BatchSource(LazyValue value_in, feature_t *column_in) : value(value_in), column(column_in) {}
+    };
+
     BlueprintResolver::SP            _resolver;
     vespalib::Stash                  _hot_stash;
     vespalib::Stash                  _cold_stash;
     std::vector<FeatureExecutor *>   _executors;
     MappedValues                     _unboxed_seeds;
     ValueSet                         _is_const;
+    uint32_t                         _batch_size;
+    std::vector<FeatureExecutor *>   _batch_executors;
+    std::vector<BatchSource>         _batch_sources;
+    std::vector<uint32_t>            _batch_docids;
+    const feature_t                 *_batch_seed;
 
     bool check_const(const NumberOrObject *value) const { return (_is_const.count(value) == 1); }
     bool check_const(FeatureExecutor *executor, const std::vector<BlueprintResolver::FeatureRef> &inputs) const;
@@ -88,6 +99,48 @@ public:
      * @params unbox_seeds make sure seeds values are numbers
      **/
     FeatureResolver get_all_features(bool unbox_seeds = true) const;
+
+    /**
+     * Prepare evaluation of the (single) seed feature for batches of
+     * documents. Executors supporting batch evaluation are evaluated
+     * for all documents in a batch at once. Values they need from
+     * other executors are calculated for each document as it is
+     * added to the batch. Must be called after setup.
+     *
+     * @return true if the seed is evaluated in batches
+     * @param batch_size max number of documents in a batch
+     **/
+    bool setup_batch(uint32_t batch_size);
+
+    /**
+     * The max number of documents in a batch, 0 if the seed is not
+     * evaluated in batches.
+     **/
+    uint32_t batch_size() const { return _batch_size; }
+
+    /**
+     * Add a document to the current batch. Values depending on match
+     * data are calculated here, so the match data must be unpacked
+     * for the document first.
+     **/
+    void add_to_batch(uint32_t docid) {
+        size_t idx = _batch_docids.size();
+        for (const auto &source: _batch_sources) {
+            source.column[idx] = source.value.as_number(docid);
+        }
+        _batch_docids.push_back(docid);
+    }
+    bool batch_full() const { return (_batch_docids.size() >= _batch_size); }
+    vespalib::ConstArrayRef<uint32_t> batch_docids() const { return _batch_docids; }
+
+    /**
+     * Evaluate the seed feature for all documents in the current
+     * batch. The values are valid until the batch is cleared.
+     *
+     * @return seed values, matching batch_docids()
+     **/
+    vespalib::ConstArrayRef<feature_t> execute_batch();
+    void clear_batch() { _batch_docids.clear(); }
 };
 
 }
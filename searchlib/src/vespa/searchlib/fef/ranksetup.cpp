@@ -37,9 +37,12 @@ RankSetup::RankSetup(const BlueprintFactory &factory, const IIndexEnvironment &i
       _split_unpacking_iterators(false),
       _delay_unpacking_iterators(false),
       _termwise_limit(1.0),
+      _rank_batch_size(0),
+      _second_phase_rank_batch_size(0),
       _numThreads(0),
       _minHitsPerThread(0),
       _numSearchPartitions(0),
+      _work_stealing(false),
       _heapSize(0),
       _arraySize(0),
       _estimatePoint(0),
@@ -63,6 +66,7 @@ RankSetup::RankSetup(const BlueprintFactory &factory, const IIndexEnvironment &i
       _softTimeoutTailCost(0.1),
       _softTimeoutFactor(0.5),
       _nearest_neighbor_brute_force_limit(0.05),
+      _nearest_neighbor_target_hits_max_adjustment_factor(20.0),
       _global_filter_limit(0.0)
 { }
 
@@ -85,9 +89,12 @@ RankSetup::configure()
     split_unpacking_iterators(matching::SplitUnpackingIterators::check(_indexEnv.getProperties()));
     delay_unpacking_iterators(matching::DelayUnpackingIterators::check(_indexEnv.getProperties()));
     set_termwise_limit(matching::TermwiseLimit::lookup(_indexEnv.getProperties()));
+    set_rank_batch_size(matching::RankBatchSize::lookup(_indexEnv.getProperties()));
+    set_second_phase_rank_batch_size(matching::SecondPhaseRankBatchSize::lookup(_indexEnv.getProperties()));
     setNumThreadsPerSearch(matching::NumThreadsPerSearch::lookup(_indexEnv.getProperties()));
     setMinHitsPerThread(matching::MinHitsPerThread::lookup(_indexEnv.getProperties()));
     setNumSearchPartitions(matching::NumSearchPartitions::lookup(_indexEnv.getProperties()));
+    set_work_stealing(matching::WorkStealing::check(_indexEnv.getProperties()));
     setHeapSize(hitcollector::HeapSize::lookup(_indexEnv.getProperties()));
     setArraySize(hitcollector::ArraySize::lookup(_indexEnv.getProperties()));
     setDegradationAttribute(matchphase::DegradationAttribute::lookup(_indexEnv.getProperties()));
@@ -107,6 +114,7 @@ RankSetup::configure()
     setSoftTimeoutTailCost(softtimeout::TailCost::lookup(_indexEnv.getProperties()));
     setSoftTimeoutFactor(softtimeout::Factor::lookup(_indexEnv.getProperties()));
     set_nearest_neighbor_brute_force_limit(matching::NearestNeighborBruteForceLimit::lookup(_indexEnv.getProperties()));
+    set_nearest_neighbor_target_hits_max_adjustment_factor(matching::NearestNeighborTargetHitsMaxAdjustmentFactor::lookup(_indexEnv.getProperties()));
     set_global_filter_limit(matching::GlobalFilterLimit::lookup(_indexEnv.getProperties()));
 }
 
@@ -176,7 +184,9 @@ RankSetup::compile()
     }
     _indexEnv.hintFeatureMotivation(IIndexEnvironment::RANK);
     _compileError |= !_first_phase_resolver->compile();
+    _indexEnv.hintFeatureMotivation(IIndexEnvironment::SECOND_PHASE_RANK);
     _compileError |= !_second_phase_resolver->compile();
+    _indexEnv.hintFeatureMotivation(IIndexEnvironment::RANK);
     _compileError |= !_summary_resolver->compile();
     _indexEnv.hintFeatureMotivation(IIndexEnvironment::DUMP);
     _compileError |= !_dumpResolver->compile();
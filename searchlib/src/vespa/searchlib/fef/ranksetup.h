@@ -34,9 +34,12 @@ private:
     bool                     _split_unpacking_iterators;
     bool                     _delay_unpacking_iterators;
     double                   _termwise_limit;
+    uint32_t                 _rank_batch_size;
+    uint32_t                 _second_phase_rank_batch_size;
     uint32_t                 _numThreads;
     uint32_t                 _minHitsPerThread;
     uint32_t                 _numSearchPartitions;
+    bool                     _work_stealing;
     uint32_t                 _heapSize;
     uint32_t                 _arraySize;
     uint32_t                 _estimatePoint;
@@ -60,6 +63,7 @@ private:
     double                   _softTimeoutTailCost;
     double                   _softTimeoutFactor;
     double                   _nearest_neighbor_brute_force_limit;
+    double                   _nearest_neighbor_target_hits_max_adjustment_factor;
     double                   _global_filter_limit;
 
 
@@ -147,6 +151,30 @@ public:
      **/
     double get_termwise_limit() const { return _termwise_limit; }
 
+    /**
+     * Set the number of hits ranked together when evaluating the
+     * first phase in batches (0 means no batching).
+     **/
+    void set_rank_batch_size(uint32_t value) { _rank_batch_size = value; }
+
+    /**
+     * Get the number of hits ranked together when evaluating the
+     * first phase in batches (0 means no batching).
+     **/
+    uint32_t get_rank_batch_size() const { return _rank_batch_size; }
+
+    /**
+     * Set the number of hits re-ranked together when evaluating the
+     * second phase in batches (0 means no batching).
+     **/
+    void set_second_phase_rank_batch_size(uint32_t value) { _second_phase_rank_batch_size = value; }
+
+    /**
+     * Get the number of hits re-ranked together when evaluating the
+     * second phase in batches (0 means no batching).
+     **/
+    uint32_t get_second_phase_rank_batch_size() const { return _second_phase_rank_batch_size; }
+
     /**
      * Sets the number of threads per search.
      *
@@ -167,6 +195,12 @@ public:
 
     uint32_t getNumSearchPartitions() const { return _numSearchPartitions; }
 
+    /**
+     * Select the work stealing docid range scheduler for the match threads.
+     **/
+    void set_work_stealing(bool value) { _work_stealing = value; }
+    bool get_work_stealing() const { return _work_stealing; }
+
     /**
      * Sets the heap size to be used in the hit collector.
      *
@@ -370,6 +404,9 @@ public:
     void set_nearest_neighbor_brute_force_limit(double v) { _nearest_neighbor_brute_force_limit = v; }
     double get_nearest_neighbor_brute_force_limit() const { return _nearest_neighbor_brute_force_limit; }
 
+    void set_nearest_neighbor_target_hits_max_adjustment_factor(double v) { _nearest_neighbor_target_hits_max_adjustment_factor = v; }
+    double get_nearest_neighbor_target_hits_max_adjustment_factor() const { return _nearest_neighbor_target_hits_max_adjustment_factor; }
+
     void set_global_filter_limit(double v) { _global_filter_limit = v; }
     double get_global_filter_limit() const { return _global_filter_limit; }
 
@@ -37,6 +37,7 @@ ImpureValueBlueprint::createExecutor(const IQueryEnvironment &, vespalib::Stash
 //-----------------------------------------------------------------------------
 
 struct DocidExecutor : FeatureExecutor {
+    bool supports_batch() const override { return true; }
     void execute(uint32_t docid) override { outputs().set_number(0, docid); }
 };
 
@@ -1,6 +1,8 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "docidandfeatures.h"
+#include <algorithm>
+#include <limits>
 #include <vespa/log/log.h>
 LOG_SETUP(".index.docidandfeatures");
 
@@ -15,6 +17,7 @@ DocIdAndFeatures::DocIdAndFeatures()
       _blob(),
       _bit_offset(0u),
       _bit_length(0u),
+      _max_element_weight(1),
       _has_raw_data(false)
 {
 }
@@ -23,4 +26,17 @@ DocIdAndFeatures::DocIdAndFeatures(const DocIdAndFeatures &) = default;
 DocIdAndFeatures & DocIdAndFeatures::operator = (const DocIdAndFeatures &) = default;
 DocIdAndFeatures::~DocIdAndFeatures() = default;
 
+int32_t
+DocIdAndFeatures::max_element_weight() const
+{
+    if (_has_raw_data || _elements.empty()) {
+        return _max_element_weight;
+    }
+    int32_t result = std::numeric_limits<int32_t>::min();
+    for (const auto &element : _elements) {
+        result = std::max(result, element.getWeight());
+    }
+    return result;
+}
+
 }
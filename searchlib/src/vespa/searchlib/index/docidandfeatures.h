@@ -104,6 +104,7 @@ protected:
     RawData _blob; // Feature data for (word, docid) pair
     uint32_t _bit_offset; // Offset of feature start ([0..63])
     uint32_t _bit_length; // Length of features
+    int32_t _max_element_weight; // Max element weight when features are raw data
     bool _has_raw_data;
 
 public:
@@ -161,6 +162,14 @@ public:
     void set_bit_length(uint32_t val) { _bit_length = val; }
     bool has_raw_data() const { return _has_raw_data; }
     void set_has_raw_data(bool val) { _has_raw_data = val; }
+
+    /**
+     * Returns the max element weight for this (word, docid) pair,
+     * used as upper bound for block max weights in posting lists.
+     * For raw data this is the value tracked by the feature decoder.
+     */
+    int32_t max_element_weight() const;
+    void set_max_element_weight(int32_t val) { _max_element_weight = val; }
 };
 
 }
@@ -87,6 +87,16 @@ public:
             return _schema.getIndexField(_index).use_interleaved_features();
         }
 
+        /**
+         * Block max weights are only written for weighted set fields,
+         * as other fields have the same weight for all elements.
+         */
+        bool use_block_max_weights() const {
+            const auto &field = _schema.getIndexField(_index);
+            return field.use_block_max_weights() &&
+                   (field.getCollectionType() == schema::CollectionType::WEIGHTEDSET);
+        }
+
         IndexIterator &operator++() {
             if (_index < _schema.getNumIndexFields()) {
                 ++_index;
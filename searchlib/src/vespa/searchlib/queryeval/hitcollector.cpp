@@ -196,6 +196,13 @@ HitCollector::reRank(DocumentScorer &scorer, std::vector<Hit> hits) {
     return hitsToReRank;
 }
 
+void
+HitCollector::setReRankedHits(std::vector<Hit> hits)
+{
+    _reRankedHits = std::move(hits);
+    _hasReRanked = true;
+}
+
 std::pair<Scores, Scores>
 HitCollector::getRanges() const
 {
@@ -186,6 +186,13 @@ public:
      **/
     size_t reRank(DocumentScorer &scorer, std::vector<Hit> hits);
 
+    /**
+     * Sets the hits that have been re-ranked elsewhere (by another
+     * thread). The hits must be a subset of the hits collected by
+     * this collector and they must be sorted on doc id.
+     **/
+    void setReRankedHits(std::vector<Hit> hits);
+
     std::pair<Scores, Scores> getRanges() const;
     void setRanges(const std::pair<Scores, Scores> &ranges);
 
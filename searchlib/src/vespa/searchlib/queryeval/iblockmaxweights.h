@@ -0,0 +1,25 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstdint>
+
+namespace search::queryeval {
+
+/**
+ * Interface implemented by search iterators over posting lists with
+ * per block max weights, used by block max wand to skip blocks of
+ * documents that cannot score above the current threshold.
+ */
+struct IBlockMaxWeights {
+    virtual ~IBlockMaxWeights() {}
+    /**
+     * Get an upper bound for the weights of the documents in the block
+     * containing the given docid, and the last docid in that block.
+     * Returns false if no block information is available for the docid.
+     * Docids must be non-decreasing between calls to initRange.
+     */
+    virtual bool get_block_max_weight(uint32_t docid, int32_t &max_weight, uint32_t &last_docid) = 0;
+};
+
+}
@@ -20,11 +20,20 @@ SearchIteratorPack::SearchIteratorPack(const std::vector<SearchIterator*> &child
                                        MatchDataUP md)
     : _children(),
       _childMatch(childMatch),
-      _md(std::move(md))
+      _md(std::move(md)),
+      _blockMaxWeights()
 {
     _children.reserve(children.size());
+    bool hasBlockMaxWeights = false;
     for (auto child: children) {
         _children.emplace_back(child);
+        hasBlockMaxWeights = hasBlockMaxWeights || (dynamic_cast<IBlockMaxWeights *>(child) != nullptr);
+    }
+    if (hasBlockMaxWeights) {
+        _blockMaxWeights.reserve(children.size());
+        for (auto child: children) {
+            _blockMaxWeights.push_back(dynamic_cast<IBlockMaxWeights *>(child));
+        }
     }
     assert((_children.size() == _childMatch.size()) || _childMatch.empty());
 }
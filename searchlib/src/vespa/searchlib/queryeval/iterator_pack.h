@@ -3,6 +3,7 @@
 #pragma once
 
 #include "searchiterator.h"
+#include "iblockmaxweights.h"
 #include <vespa/searchlib/fef/termfieldmatchdata.h>
 
 namespace search::fef { class MatchData; }
@@ -16,6 +17,7 @@ private:
     std::vector<SearchIterator::UP>        _children;
     std::vector<fef::TermFieldMatchData*>  _childMatch;
     MatchDataUP                            _md;
+    std::vector<IBlockMaxWeights*>         _blockMaxWeights; // empty if no child has block max weights
 
 public:
     SearchIteratorPack();
@@ -45,6 +47,13 @@ public:
         return _childMatch[ref]->getWeight();
     }
 
+    bool has_block_max_weights() const { return !_blockMaxWeights.empty(); }
+
+    bool get_block_max_weight(uint32_t ref, uint32_t docid, int32_t &max_weight, uint32_t &last_docid) {
+        IBlockMaxWeights *blockMaxWeights = _blockMaxWeights[ref];
+        return (blockMaxWeights != nullptr) && blockMaxWeights->get_block_max_weight(docid, max_weight, last_docid);
+    }
+
     void unpack(uint32_t ref, uint32_t docid) {
         _children[ref]->doUnpack(docid);
     }
@@ -4,33 +4,40 @@
 #include "nearest_neighbor_blueprint.h"
 #include "nearest_neighbor_iterator.h"
 #include "nns_index_iterator.h"
+#include <vespa/searchlib/common/bitvector.h>
 #include <vespa/searchlib/fef/termfieldmatchdataarray.h>
 #include <vespa/eval/tensor/dense/dense_tensor_view.h>
 #include <vespa/eval/tensor/dense/dense_tensor.h>
 #include <vespa/searchlib/tensor/dense_tensor_attribute.h>
+#include <vespa/searchlib/tensor/dense_tensor_store.h>
 #include <vespa/searchlib/tensor/distance_function_factory.h>
+#include <algorithm>
+#include <limits>
+#include <queue>
 #include <vespa/log/log.h>
 
 LOG_SETUP(".searchlib.queryeval.nearest_neighbor_blueprint");
 
 using vespalib::tensor::DenseTensorView;
 using vespalib::tensor::DenseTensor;
+using search::tensor::DenseTensorStore;
+using search::tensor::NearestNeighborIndex;
 
 namespace search::queryeval {
 
 namespace {
 
+/**
+ * Converts the query tensor cells to the cell type of the attribute tensor, the same
+ * way as cells are converted when stored in the attribute (e.g. int8 is rounded and saturated).
+ */
 template<typename LCT, typename RCT>
 void
 convert_cells(std::unique_ptr<DenseTensorView> &original, vespalib::eval::ValueType want_type)
 {
-    auto old_cells = original->cellsRef().typify<LCT>();
-    std::vector<RCT> new_cells;
-    new_cells.reserve(old_cells.size());
-    for (LCT value : old_cells) {
-        RCT conv = value;
-        new_cells.push_back(conv);
-    }
+    auto old_cells = original->cellsRef();
+    std::vector<RCT> new_cells(old_cells.size);
+    DenseTensorStore::encode_cells(old_cells, want_type.cell_type(), new_cells.data());
     original = std::make_unique<DenseTensor<RCT>>(want_type, std::move(new_cells));
 }
 
@@ -48,19 +55,89 @@ struct ConvertCellsSelector
     static auto invoke() { return convert_cells<LCT, RCT>; }
 };
 
+/**
+ * Splits a batch of query points (dense tensor of order 2) into one tensor per query point,
+ * with the type (and cell type) of the attribute tensor.
+ */
+template<typename LCT, typename RCT>
+std::vector<std::unique_ptr<DenseTensorView>>
+split_batch(const DenseTensorView &batch, const vespalib::eval::ValueType &want_type)
+{
+    const auto &dims = batch.fast_type().dimensions();
+    const auto &vector_dim = want_type.dimensions()[0];
+    size_t batch_dim_idx = (dims[0].name == vector_dim.name) ? 1 : 0;
+    size_t num_queries = dims[batch_dim_idx].size;
+    size_t num_cells = vector_dim.size;
+    size_t query_stride = (batch_dim_idx == 0) ? num_cells : 1;
+    size_t cell_stride = (batch_dim_idx == 0) ? 1 : num_queries;
+    auto old_cells = batch.cellsRef().typify<LCT>();
+    std::vector<std::unique_ptr<DenseTensorView>> result;
+    result.reserve(num_queries);
+    std::vector<LCT> query_cells(num_cells);
+    for (size_t query = 0; query < num_queries; ++query) {
+        for (size_t cell = 0; cell < num_cells; ++cell) {
+            query_cells[cell] = old_cells[query * query_stride + cell * cell_stride];
+        }
+        std::vector<RCT> new_cells(num_cells);
+        DenseTensorStore::encode_cells(vespalib::tensor::TypedCells(vespalib::ConstArrayRef<LCT>(query_cells)),
+                                       want_type.cell_type(), new_cells.data());
+        result.push_back(std::make_unique<DenseTensor<RCT>>(want_type, std::move(new_cells)));
+    }
+    return result;
+}
+
+struct SplitBatchSelector
+{
+    template <typename LCT, typename RCT>
+    static auto invoke() { return split_batch<LCT, RCT>; }
+};
+
+/**
+ * Merges the hits for each query point into the best k hits (sorted on docid),
+ * where the distance for a hit is the smallest distance to any query point.
+ */
+std::vector<NearestNeighborIndex::Neighbor>
+merge_batch_hits(const std::vector<std::vector<NearestNeighborIndex::Neighbor>>& batch_hits, uint32_t k)
+{
+    using Neighbor = NearestNeighborIndex::Neighbor;
+    std::vector<Neighbor> all;
+    for (const auto &hits : batch_hits) {
+        all.insert(all.end(), hits.begin(), hits.end());
+    }
+    std::sort(all.begin(), all.end(), [](const Neighbor &lhs, const Neighbor &rhs)
+              { return (lhs.docid < rhs.docid) || ((lhs.docid == rhs.docid) && (lhs.distance < rhs.distance)); });
+    auto end = std::unique(all.begin(), all.end(), [](const Neighbor &lhs, const Neighbor &rhs)
+                           { return lhs.docid == rhs.docid; });
+    all.erase(end, all.end());
+    if (all.size() > k) {
+        std::nth_element(all.begin(), all.begin() + k, all.end(), [](const Neighbor &lhs, const Neighbor &rhs)
+                         { return lhs.distance < rhs.distance; });
+        all.resize(k);
+        std::sort(all.begin(), all.end(), [](const Neighbor &lhs, const Neighbor &rhs)
+                  { return lhs.docid < rhs.docid; });
+    }
+    return all;
+}
+
 } // namespace <unnamed>
 
 NearestNeighborBlueprint::NearestNeighborBlueprint(const queryeval::FieldSpec& field,
                                                    const tensor::DenseTensorAttribute& attr_tensor,
                                                    std::unique_ptr<vespalib::tensor::DenseTensorView> query_tensor,
-                                                   uint32_t target_num_hits, bool approximate, uint32_t explore_additional_hits, double brute_force_limit)
+                                                   uint32_t target_num_hits, bool approximate, uint32_t explore_additional_hits,
+                                                   double brute_force_limit, double target_hits_max_adjustment_factor)
     : ComplexLeafBlueprint(field),
       _attr_tensor(attr_tensor),
       _query_tensor(std::move(query_tensor)),
+      _batch_query_tensors(),
+      _batch_query_vectors(),
       _target_num_hits(target_num_hits),
       _approximate(approximate),
       _explore_additional_hits(explore_additional_hits),
       _brute_force_limit(brute_force_limit),
+      _target_hits_max_adjustment_factor(target_hits_max_adjustment_factor),
+      _explore_k(target_num_hits + explore_additional_hits),
+      _algorithm(Algorithm::EXACT),
       _fallback_dist_fun(),
       _distance_heap(target_num_hits),
       _found_hits(),
@@ -68,9 +145,17 @@ NearestNeighborBlueprint::NearestNeighborBlueprint(const queryeval::FieldSpec& f
 {
     auto lct = _query_tensor->cellsRef().type;
     auto rct = _attr_tensor.getTensorType().cell_type();
-    using MyTypify = vespalib::eval::TypifyCellType;
-    auto fixup_fun = vespalib::typify_invoke<2,MyTypify,ConvertCellsSelector>(lct, rct);
-    fixup_fun(_query_tensor, _attr_tensor.getTensorType());
+    using MyTypify = vespalib::eval::TypifyStorageCellType;
+    if (_query_tensor->fast_type().dimensions().size() > 1) {
+        auto split_fun = vespalib::typify_invoke<2,MyTypify,SplitBatchSelector>(lct, rct);
+        _batch_query_tensors = split_fun(*_query_tensor, _attr_tensor.getTensorType());
+        for (const auto &tensor : _batch_query_tensors) {
+            _batch_query_vectors.push_back(tensor->cellsRef());
+        }
+    } else {
+        auto fixup_fun = vespalib::typify_invoke<2,MyTypify,ConvertCellsSelector>(lct, rct);
+        fixup_fun(_query_tensor, _attr_tensor.getTensorType());
+    }
     _fallback_dist_fun = search::tensor::make_distance_function(_attr_tensor.getConfig().distance_metric(), rct);
     _dist_fun = _fallback_dist_fun.get();
     auto nns_index = _attr_tensor.nearest_neighbor_index();
@@ -84,6 +169,18 @@ NearestNeighborBlueprint::NearestNeighborBlueprint(const queryeval::FieldSpec& f
 
 NearestNeighborBlueprint::~NearestNeighborBlueprint() = default;
 
+const char *
+NearestNeighborBlueprint::algorithm_name(Algorithm algorithm)
+{
+    switch (algorithm) {
+    case Algorithm::EXACT: return "exact";
+    case Algorithm::EXACT_FILTER_FIRST: return "exact_filter_first";
+    case Algorithm::INDEX_TOP_K: return "index_top_k";
+    case Algorithm::INDEX_TOP_K_WITH_FILTER: return "index_top_k_with_filter";
+    }
+    return "unknown";
+}
+
 void
 NearestNeighborBlueprint::set_global_filter(const GlobalFilter &global_filter)
 {
@@ -93,33 +190,120 @@ NearestNeighborBlueprint::set_global_filter(const GlobalFilter &global_filter)
         (_approximate ? "approximate" : "exact"),
         (nns_index ? "nns_index" : "no_index"),
         (_global_filter->has_filter() ? "has_filter" : "no_filter"));
-    if (_approximate && nns_index) {
-        uint32_t est_hits = _attr_tensor.getNumDocs();
-        if (_global_filter->has_filter()) {
-            uint32_t max_hits = _global_filter->filter()->countTrueBits();
-            LOG(debug, "set_global_filter getNumDocs: %u / max_hits %u", est_hits, max_hits);
-            double max_hit_ratio = static_cast<double>(max_hits) / est_hits;
-            if (max_hit_ratio < _brute_force_limit) {
-                _approximate = false;
-                LOG(debug, "too many hits filtered out, using brute force implementation");
-            } else {
-                est_hits = std::min(est_hits, max_hits);
-            }
+    uint32_t est_hits = _attr_tensor.getNumDocs();
+    if (_global_filter->has_filter()) {
+        uint32_t max_hits = _global_filter->filter()->countTrueBits();
+        LOG(debug, "set_global_filter getNumDocs: %u / max_hits %u", est_hits, max_hits);
+        double max_hit_ratio = static_cast<double>(max_hits) / est_hits;
+        if (_approximate && (max_hit_ratio < _brute_force_limit)) {
+            _approximate = false;
+            LOG(debug, "too many hits filtered out, using exact search over the filter");
+            perform_exact_top_k(*_global_filter->filter());
+            setEstimate(HitEstimate(_found_hits.size(), _found_hits.empty()));
+            LOG(debug, "perform_exact_top_k found %zu hits", _found_hits.size());
+            return;
+        }
+        if (_approximate && nns_index) {
+            est_hits = std::min(est_hits, max_hits);
+            // Only some of the explored neighbors pass the filter, so explore more of them.
+            double adjustment = std::min(1.0 / max_hit_ratio, _target_hits_max_adjustment_factor);
+            _explore_k = std::max(_explore_k, static_cast<uint32_t>(_explore_k * adjustment));
         }
-        if (_approximate) {
-            est_hits = std::min(est_hits, _target_num_hits);
-            setEstimate(HitEstimate(est_hits, false));
-            perform_top_k();
-            LOG(debug, "perform_top_k found %zu hits", _found_hits.size());
+    }
+    if (_approximate && nns_index) {
+        est_hits = std::min(est_hits, _target_num_hits);
+        setEstimate(HitEstimate(est_hits, false));
+        perform_top_k();
+        LOG(debug, "perform_top_k found %zu hits (explore_k %u)", _found_hits.size(), _explore_k);
+    }
+}
+
+void
+NearestNeighborBlueprint::calc_distances(const vespalib::tensor::TypedCells* rhs, size_t num_rhs,
+                                         double* result, double* tmp) const
+{
+    if (!is_batch()) {
+        _dist_fun->calc_batch(_query_tensor->cellsRef(), rhs, num_rhs, result);
+        return;
+    }
+    std::fill(result, result + num_rhs, std::numeric_limits<double>::max());
+    for (const auto &lhs : _batch_query_vectors) {
+        _dist_fun->calc_batch(lhs, rhs, num_rhs, tmp);
+        for (size_t i = 0; i < num_rhs; ++i) {
+            result[i] = std::min(result[i], tmp[i]);
         }
     }
 }
 
+void
+NearestNeighborBlueprint::perform_exact_top_k(const search::BitVector& filter)
+{
+    using Neighbor = NearestNeighborIndex::Neighbor;
+    constexpr size_t batch_size = 64;
+    auto closer = [](const Neighbor &lhs, const Neighbor &rhs) { return lhs.distance < rhs.distance; };
+    std::priority_queue<Neighbor, std::vector<Neighbor>, decltype(closer)> best(closer);
+    uint32_t k = _target_num_hits;
+    uint32_t docid_limit = std::min(filter.size(), _attr_tensor.getCommittedDocIdLimit());
+    std::vector<uint32_t> docids;
+    std::vector<vespalib::tensor::TypedCells> vectors(batch_size);
+    std::vector<double> distances(batch_size);
+    std::vector<double> tmp(batch_size);
+    docids.reserve(batch_size);
+    // distances are calculated for a batch of documents at a time
+    auto flush = [&]()
+                 {
+                     for (size_t i = 0; i < docids.size(); ++i) {
+                         vectors[i] = _attr_tensor.get_vector(docids[i]);
+                     }
+                     calc_distances(vectors.data(), docids.size(), distances.data(), tmp.data());
+                     for (size_t i = 0; i < docids.size(); ++i) {
+                         if (best.size() < k) {
+                             best.emplace(docids[i], distances[i]);
+                         } else if (distances[i] < best.top().distance) {
+                             best.pop();
+                             best.emplace(docids[i], distances[i]);
+                         }
+                     }
+                     docids.clear();
+                 };
+    if (k > 0) {
+        filter.foreach_truebit([&](uint32_t docid)
+                               {
+                                   docids.push_back(docid);
+                                   if (docids.size() == batch_size) {
+                                       flush();
+                                   }
+                               }, 1, docid_limit);
+        flush();
+    }
+    _found_hits.clear();
+    _found_hits.reserve(best.size());
+    for (; !best.empty(); best.pop()) {
+        _found_hits.push_back(best.top());
+    }
+    std::sort(_found_hits.begin(), _found_hits.end(), [](const Neighbor &lhs, const Neighbor &rhs)
+              { return lhs.docid < rhs.docid; });
+    _algorithm = Algorithm::EXACT_FILTER_FIRST;
+}
+
+void
+NearestNeighborBlueprint::perform_top_k_batch(const search::tensor::NearestNeighborIndex& nns_index)
+{
+    uint32_t k = _target_num_hits;
+    auto batch_hits = nns_index.find_top_k_batch(k, _batch_query_vectors, _global_filter->filter(), _explore_k);
+    _found_hits = merge_batch_hits(batch_hits, k);
+}
+
 void
 NearestNeighborBlueprint::perform_top_k()
 {
     auto nns_index = _attr_tensor.nearest_neighbor_index();
     if (_approximate && nns_index) {
+        _algorithm = _global_filter->has_filter() ? Algorithm::INDEX_TOP_K_WITH_FILTER : Algorithm::INDEX_TOP_K;
+    }
+    if (_approximate && nns_index && is_batch()) {
+        perform_top_k_batch(*nns_index);
+    } else if (_approximate && nns_index) {
         auto lhs_type = _query_tensor->fast_type();
         auto rhs_type = _attr_tensor.getTensorType();
         // different cell types should be converted already
@@ -128,9 +312,9 @@ NearestNeighborBlueprint::perform_top_k()
             uint32_t k = _target_num_hits;
             if (_global_filter->has_filter()) {
                 auto filter = _global_filter->filter();
-                _found_hits = nns_index->find_top_k_with_filter(k, lhs, *filter, k + _explore_additional_hits);
+                _found_hits = nns_index->find_top_k_with_filter(k, lhs, *filter, _explore_k);
             } else {
-                _found_hits = nns_index->find_top_k(k, lhs, k + _explore_additional_hits);
+                _found_hits = nns_index->find_top_k(k, lhs, _explore_k);
             }
         }
     }
@@ -141,9 +325,14 @@ NearestNeighborBlueprint::createLeafSearch(const search::fef::TermFieldMatchData
 {
     assert(tfmda.size() == 1);
     fef::TermFieldMatchData &tfmd = *tfmda[0]; // always search in only one field
-    if (! _found_hits.empty()) {
+    if (! _found_hits.empty() || (_algorithm == Algorithm::EXACT_FILTER_FIRST)) {
         return NnsIndexIterator::create(tfmd, _found_hits, _dist_fun);
     }
+    if (is_batch()) {
+        return NearestNeighborIterator::create(strict, tfmd, *_batch_query_tensors[0], _attr_tensor,
+                                               _distance_heap, _global_filter->filter(), _dist_fun,
+                                               _batch_query_vectors);
+    }
     const vespalib::tensor::DenseTensorView &qT = *_query_tensor;
     return NearestNeighborIterator::create(strict, tfmd, qT, _attr_tensor,
                                            _distance_heap, _global_filter->filter(), _dist_fun);
@@ -155,9 +344,14 @@ NearestNeighborBlueprint::visitMembers(vespalib::ObjectVisitor& visitor) const
     ComplexLeafBlueprint::visitMembers(visitor);
     visitor.visitString("attribute_tensor", _attr_tensor.getTensorType().to_spec());
     visitor.visitString("query_tensor", _query_tensor->type().to_spec());
+    if (is_batch()) {
+        visitor.visitInt("query_points", _batch_query_tensors.size());
+    }
     visitor.visitInt("target_num_hits", _target_num_hits);
     visitor.visitBool("approximate", _approximate);
     visitor.visitInt("explore_additional_hits", _explore_additional_hits);
+    visitor.visitInt("explore_k", _explore_k);
+    visitor.visitString("algorithm", algorithm_name(_algorithm));
 }
 
 bool
@@ -16,35 +16,69 @@ namespace search::queryeval {
  *
  * The search iterator matches the K nearest neighbors in a multi-dimensional vector space,
  * where the query point and document points are dense tensors of order 1.
+ *
+ * The query tensor can also be a batch of query points, given as a dense tensor of order 2
+ * where one dimension is the dimension of the attribute tensor.
+ * The distance to a document is then the smallest distance to any of the query points,
+ * and the approximate search is done for all query points in one batch against the nearest neighbor index.
+ *
+ * When a global filter is set, the ratio of documents passing the filter decides how the search is done:
+ * With a very selective filter an approximate search is replaced by finding the exact nearest neighbors
+ * up front, calculating the distances to the documents in the filter in batches. Otherwise the nearest neighbor index is searched with the filter,
+ * exploring more neighbors the more selective the filter is.
  */
 class NearestNeighborBlueprint : public ComplexLeafBlueprint {
+public:
+    enum class Algorithm {
+        EXACT,                  // brute force search by the search iterator
+        EXACT_FILTER_FIRST,     // exact search up front over the documents in the global filter
+        INDEX_TOP_K,            // approximate search in the nearest neighbor index
+        INDEX_TOP_K_WITH_FILTER // approximate search in the nearest neighbor index with the global filter
+    };
 private:
     const tensor::DenseTensorAttribute& _attr_tensor;
     std::unique_ptr<vespalib::tensor::DenseTensorView> _query_tensor;
+    std::vector<std::unique_ptr<vespalib::tensor::DenseTensorView>> _batch_query_tensors;
+    std::vector<vespalib::tensor::TypedCells> _batch_query_vectors;
     uint32_t _target_num_hits;
     bool _approximate;
     uint32_t _explore_additional_hits;
     double _brute_force_limit;
+    double _target_hits_max_adjustment_factor;
+    uint32_t _explore_k;
+    Algorithm _algorithm;
     search::tensor::DistanceFunction::UP _fallback_dist_fun;
     const search::tensor::DistanceFunction *_dist_fun;
     mutable NearestNeighborDistanceHeap _distance_heap;
     std::vector<search::tensor::NearestNeighborIndex::Neighbor> _found_hits;
     std::shared_ptr<const GlobalFilter> _global_filter;
 
+    void calc_distances(const vespalib::tensor::TypedCells* rhs, size_t num_rhs,
+                        double* result, double* tmp) const;
+    void perform_exact_top_k(const search::BitVector& filter);
     void perform_top_k();
+    void perform_top_k_batch(const search::tensor::NearestNeighborIndex& nns_index);
 public:
     NearestNeighborBlueprint(const queryeval::FieldSpec& field,
                              const tensor::DenseTensorAttribute& attr_tensor,
                              std::unique_ptr<vespalib::tensor::DenseTensorView> query_tensor,
-                             uint32_t target_num_hits, bool approximate, uint32_t explore_additional_hits, double brute_force_limit);
+                             uint32_t target_num_hits, bool approximate, uint32_t explore_additional_hits,
+                             double brute_force_limit, double target_hits_max_adjustment_factor);
     NearestNeighborBlueprint(const NearestNeighborBlueprint&) = delete;
     NearestNeighborBlueprint& operator=(const NearestNeighborBlueprint&) = delete;
     ~NearestNeighborBlueprint();
     const tensor::DenseTensorAttribute& get_attribute_tensor() const { return _attr_tensor; }
     const vespalib::tensor::DenseTensorView& get_query_tensor() const { return *_query_tensor; }
+    const std::vector<std::unique_ptr<vespalib::tensor::DenseTensorView>>& get_batch_query_tensors() const {
+        return _batch_query_tensors;
+    }
+    bool is_batch() const { return !_batch_query_tensors.empty(); }
     uint32_t get_target_num_hits() const { return _target_num_hits; }
     void set_global_filter(const GlobalFilter &global_filter) override;
     bool may_approximate() const { return _approximate; }
+    Algorithm get_algorithm() const { return _algorithm; }
+    uint32_t get_explore_k() const { return _explore_k; }
+    static const char *algorithm_name(Algorithm algorithm);
 
     std::unique_ptr<SearchIterator> createLeafSearch(const search::fef::TermFieldMatchDataArray& tfmda,
                                                      bool strict) const override;
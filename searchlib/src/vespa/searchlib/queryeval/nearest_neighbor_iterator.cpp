@@ -2,6 +2,8 @@
 
 #include "nearest_neighbor_iterator.h"
 #include <vespa/searchlib/common/bitvector.h>
+#include <algorithm>
+#include <limits>
 
 using search::tensor::DenseTensorAttribute;
 using vespalib::ConstArrayRef;
@@ -38,6 +40,7 @@ public:
     NearestNeighborImpl(Params params_in)
         : NearestNeighborIterator(params_in),
           _lhs(params().queryTensor.cellsRef()),
+          _batch(params().batchQueryVectors),
           _fieldTensor(params().tensorAttribute.getTensorType()),
           _lastScore(0.0)
     {
@@ -78,10 +81,18 @@ private:
     double computeDistance(uint32_t docId, double limit) {
         params().tensorAttribute.getTensor(docId, _fieldTensor);
         auto rhs = _fieldTensor.cellsRef();
-        return params().distanceFunction->calc_with_limit(_lhs, rhs, limit);
+        if (_batch.empty()) {
+            return params().distanceFunction->calc_with_limit(_lhs, rhs, limit);
+        }
+        double best = std::numeric_limits<double>::max();
+        for (const TypedCells &lhs : _batch) {
+            best = std::min(best, params().distanceFunction->calc_with_limit(lhs, rhs, std::min(limit, best)));
+        }
+        return best;
     }
 
     TypedCells             _lhs;
+    ConstArrayRef<TypedCells> _batch;
     MutableDenseTensorView _fieldTensor;
     double                 _lastScore;
 };
@@ -117,10 +128,11 @@ NearestNeighborIterator::create(
         const search::tensor::DenseTensorAttribute &tensorAttribute,
         NearestNeighborDistanceHeap &distanceHeap,
         const search::BitVector *filter,
-        const search::tensor::DistanceFunction *dist_fun)
+        const search::tensor::DistanceFunction *dist_fun,
+        vespalib::ConstArrayRef<TypedCells> batch_query_vectors)
 
 {
-    Params params(tfmd, queryTensor, tensorAttribute, distanceHeap, filter, dist_fun);
+    Params params(tfmd, queryTensor, tensorAttribute, distanceHeap, filter, dist_fun, batch_query_vectors);
     if (filter) {
         return resolve_strict<true>(strict, params);
     } else  {
@@ -19,6 +19,7 @@ class NearestNeighborIterator : public SearchIterator
 public:
     using DenseTensorAttribute = search::tensor::DenseTensorAttribute;
     using DenseTensorView = vespalib::tensor::DenseTensorView;
+    using TypedCells = vespalib::tensor::TypedCells;
 
     struct Params {
         fef::TermFieldMatchData &tfmd;
@@ -27,19 +28,23 @@ public:
         NearestNeighborDistanceHeap &distanceHeap;
         const search::BitVector *filter;
         const search::tensor::DistanceFunction *distanceFunction;
+        // When non-empty, the distance to a document is the smallest distance to any of these query vectors.
+        vespalib::ConstArrayRef<TypedCells> batchQueryVectors;
         
         Params(fef::TermFieldMatchData &tfmd_in,
                const DenseTensorView &queryTensor_in,
                const DenseTensorAttribute &tensorAttribute_in,
                NearestNeighborDistanceHeap &distanceHeap_in,
                const search::BitVector *filter_in,
-               const search::tensor::DistanceFunction *distanceFunction_in)
+               const search::tensor::DistanceFunction *distanceFunction_in,
+               vespalib::ConstArrayRef<TypedCells> batchQueryVectors_in)
           : tfmd(tfmd_in),
             queryTensor(queryTensor_in),
             tensorAttribute(tensorAttribute_in),
             distanceHeap(distanceHeap_in),
             filter(filter_in),
-            distanceFunction(distanceFunction_in)
+            distanceFunction(distanceFunction_in),
+            batchQueryVectors(batchQueryVectors_in)
         {}
     };
 
@@ -54,7 +59,8 @@ public:
             const search::tensor::DenseTensorAttribute &tensorAttribute,
             NearestNeighborDistanceHeap &distanceHeap,
             const search::BitVector *filter,
-            const search::tensor::DistanceFunction *dist_fun);
+            const search::tensor::DistanceFunction *dist_fun,
+            vespalib::ConstArrayRef<TypedCells> batch_query_vectors = vespalib::ConstArrayRef<TypedCells>());
 
     const Params& params() const { return _params; }
 private:
@@ -179,6 +179,10 @@ public:
 
     uint32_t seek(uint16_t ref, uint32_t docid) { return _iteratorPack.seek(ref, docid); }
     int32_t get_weight(uint16_t ref, uint32_t docid) { return _iteratorPack.get_weight(ref, docid); }
+    bool has_block_max_weights() const { return _iteratorPack.has_block_max_weights(); }
+    bool get_block_max_weight(uint16_t ref, uint32_t docid, int32_t &max_weight, uint32_t &last_docid) {
+        return _iteratorPack.get_block_max_weight(ref, docid, max_weight, last_docid);
+    }
     
     vespalib::string stringify_docid() const;
 };
@@ -338,6 +342,7 @@ public:
     }
     ref_t *present_begin() const { return _present; }
     ref_t *present_end() const { return _past; }
+    ref_t *past_end() const { return _trash; }
     vespalib::string stringify() const;
 };
 
@@ -447,6 +452,17 @@ struct DotProductScorer
     static score_t calculateScore(VectorizedTerms &terms, ref_t ref, docid_t docId) {
         return terms.weight(ref) * (score_t)terms.get_weight(ref, docId);
     }
+
+    // upper bound for the score of the term in the posting list block containing docId
+    template <typename VectorizedTerms>
+    static score_t calculate_block_max_score(VectorizedTerms &terms, ref_t ref, docid_t docId, docid_t &lastDocId) {
+        int32_t maxWeight = 0;
+        if (terms.weight(ref) >= 0 && terms.get_block_max_weight(ref, docId, maxWeight, lastDocId)) {
+            return std::min(terms.maxScore(ref), terms.weight(ref) * (score_t)maxWeight);
+        }
+        lastDocId = search::endDocId;
+        return terms.maxScore(ref);
+    }
 };
 
 //-----------------------------------------------------------------------------
@@ -618,6 +634,48 @@ public:
         return true;
     }
 
+    /**
+     * Check that the sum of block max scores for the terms that might
+     * match the current candidate is above the threshold. The block
+     * max score of a term is an upper bound for its score for all
+     * documents in the posting list block containing the candidate.
+     **/
+    template <typename VectorizedTerms, typename Heaps, typename Scorer, typename AboveThreshold>
+    bool check_block_max_constraint(VectorizedTerms &terms, Heaps &heaps, const Scorer &, AboveThreshold &&aboveThreshold, docid_t &blockEnd) {
+        blockEnd = search::endDocId;
+        if (!terms.has_block_max_weights()) {
+            return true;
+        }
+        score_t blockMaxScore = 0;
+        ref_t *end = heaps.past_end();
+        for (ref_t *ref = heaps.present_begin(); ref != end; ++ref) {
+            docid_t lastDocId = search::endDocId;
+            blockMaxScore += Scorer::calculate_block_max_score(terms, *ref, _candidate, lastDocId);
+            blockEnd = std::min(blockEnd, lastDocId);
+        }
+        return aboveThreshold(blockMaxScore);
+    }
+
+    /**
+     * Like check_block_max_constraint, but when the constraint fails
+     * the candidate is moved past the blocks used to calculate the
+     * bound, or to the next future term if it comes first. All
+     * documents skipped are guaranteed to be below the threshold.
+     **/
+    template <typename VectorizedTerms, typename Heaps, typename Scorer, typename AboveThreshold>
+    bool solve_block_max_constraint(VectorizedTerms &terms, Heaps &heaps, Scorer &&scorer, AboveThreshold &&aboveThreshold) {
+        docid_t blockEnd = search::endDocId;
+        if (check_block_max_constraint(terms, heaps, scorer, aboveThreshold, blockEnd)) {
+            return true;
+        }
+        docid_t next = (blockEnd < search::endDocId) ? (blockEnd + 1) : (_candidate + 1);
+        if (heaps.has_future()) {
+            next = std::min(next, terms.docId(heaps.future()));
+        }
+        set_candidate(terms, heaps, next);
+        return false;
+    }
+
     template <typename VectorizedTerms, typename Heaps, typename Scorer, typename AboveThreshold>
     bool check_score(VectorizedTerms &terms, Heaps &heaps, Scorer &&scorer, AboveThreshold &&aboveThreshold) {
         _partial_score = 0;
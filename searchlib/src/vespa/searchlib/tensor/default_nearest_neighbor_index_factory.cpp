@@ -2,6 +2,7 @@
 
 #include "default_nearest_neighbor_index_factory.h"
 #include "hnsw_index.h"
+#include "ivf_pq_index.h"
 #include "random_level_generator.h"
 #include "inv_log_level_generator.h"
 #include "distance_function_factory.h"
@@ -23,6 +24,12 @@ make_random_level_generator(uint32_t m)
     return std::make_unique<InvLogLevelGenerator>(m);
 }
 
+// Iterations of k-means when training the ivf-pq quantizer.
+constexpr uint32_t ivf_pq_training_iterations = 8;
+// Number of training documents per coarse centroid.
+constexpr uint32_t ivf_pq_training_docs_per_centroid = 8;
+constexpr uint32_t ivf_pq_min_probes = 8;
+
 } // namespace <unnamed>
 
 std::unique_ptr<NearestNeighborIndex>
@@ -44,5 +51,21 @@ DefaultNearestNeighborIndexFactory::make(const DocVectorAccess& vectors,
                                        cfg);
 }
 
+std::unique_ptr<NearestNeighborIndex>
+DefaultNearestNeighborIndexFactory::make(const DocVectorAccess& vectors,
+                                         size_t vector_size,
+                                         vespalib::eval::ValueType::CellType cell_type,
+                                         const search::attribute::IvfPqIndexParams& params) const
+{
+    IvfPqIndex::Config cfg(params.num_centroids(),
+                           params.num_subquantizers(),
+                           params.num_centroids() * ivf_pq_training_docs_per_centroid,
+                           ivf_pq_training_iterations,
+                           ivf_pq_min_probes,
+                           params.distance_metric());
+    return std::make_unique<IvfPqIndex>(vectors, vector_size,
+                                        make_distance_function(params.distance_metric(), cell_type),
+                                        cfg);
 }
 
+}
@@ -7,7 +7,7 @@
 namespace search::tensor {
 
 /**
- * Factory that instantiates the production hnsw index.
+ * Factory that instantiates the production hnsw and ivf-pq indexes.
  */
 class DefaultNearestNeighborIndexFactory : public NearestNeighborIndexFactory {
 public:
@@ -15,6 +15,10 @@ public:
                                                size_t vector_size,
                                                vespalib::eval::ValueType::CellType cell_type,
                                                const search::attribute::HnswIndexParams& params) const override;
+    std::unique_ptr<NearestNeighborIndex> make(const DocVectorAccess& vectors,
+                                               size_t vector_size,
+                                               vespalib::eval::ValueType::CellType cell_type,
+                                               const search::attribute::IvfPqIndexParams& params) const override;
 };
 
 }
@@ -3,6 +3,7 @@
 #include "dense_tensor_attribute.h"
 #include "dense_tensor_attribute_saver.h"
 #include "nearest_neighbor_index.h"
+#include "nearest_neighbor_index_builder.h"
 #include "nearest_neighbor_index_saver.h"
 #include "tensor_attribute.hpp"
 #include <vespa/eval/tensor/dense/dense_tensor_view.h>
@@ -30,6 +31,11 @@ namespace {
 constexpr uint32_t DENSE_TENSOR_ATTRIBUTE_VERSION = 1;
 const vespalib::string tensorTypeTag("tensortype");
 
+// Settings used when building the nearest neighbor index using multiple threads during load.
+constexpr uint32_t max_pending_index_prepares = 1000;
+constexpr uint32_t min_sequential_index_adds = 10000;
+constexpr uint32_t index_adds_per_generation = 1000;
+
 class TensorReader : public ReaderBase
 {
 private:
@@ -64,6 +70,10 @@ TensorReader::is_present() {
 bool
 can_use_index_save_file(const search::attribute::Config &config, const search::attribute::AttributeHeader &header)
 {
+    if (config.ivf_pq_index_params().has_value()) {
+        return (header.get_ivf_pq_index_params().has_value() &&
+                (config.ivf_pq_index_params().value() == header.get_ivf_pq_index_params().value()));
+    }
     if (!config.hnsw_index_params().has_value() || !header.get_hnsw_index_params().has_value()) {
         return false;
     }
@@ -111,12 +121,16 @@ DenseTensorAttribute::DenseTensorAttribute(vespalib::stringref baseFileName, con
       _denseTensorStore(cfg.tensorType()),
       _index()
 {
-    if (cfg.hnsw_index_params().has_value()) {
+    if (cfg.hnsw_index_params().has_value() || cfg.ivf_pq_index_params().has_value()) {
         auto tensor_type = cfg.tensorType();
         assert(tensor_type.dimensions().size() == 1);
         assert(tensor_type.is_dense());
         size_t vector_size = tensor_type.dimensions()[0].size;
-        _index = index_factory.make(*this, vector_size, tensor_type.cell_type(), cfg.hnsw_index_params().value());
+        if (cfg.hnsw_index_params().has_value()) {
+            _index = index_factory.make(*this, vector_size, tensor_type.cell_type(), cfg.hnsw_index_params().value());
+        } else {
+            _index = index_factory.make(*this, vector_size, tensor_type.cell_type(), cfg.ivf_pq_index_params().value());
+        }
     }
 }
 
@@ -149,7 +163,15 @@ DenseTensorAttribute::prepare_set_tensor(DocId docid, const Tensor& tensor) cons
     if (_index) {
         const auto* view = dynamic_cast<const DenseTensorView*>(&tensor);
         assert(view);
-        return _index->prepare_add_document(docid, view->cellsRef(), getGenerationHandler().takeGuard());
+        auto cells = view->cellsRef();
+        const auto &store_type = _denseTensorStore.type();
+        if (cells.type != store_type.cell_type()) {
+            std::vector<char> converted(_denseTensorStore.getBufSize());
+            DenseTensorStore::encode_cells(cells, store_type.cell_type(), converted.data());
+            vespalib::tensor::TypedCells stored_cells(converted.data(), store_type.cell_type(), cells.size);
+            return _index->prepare_add_document(docid, stored_cells, getGenerationHandler().takeGuard());
+        }
+        return _index->prepare_add_document(docid, cells, getGenerationHandler().takeGuard());
     }
     return std::unique_ptr<PrepareResult>();
 }
@@ -187,8 +209,45 @@ DenseTensorAttribute::getTensor(DocId docId, MutableDenseTensorView &tensor) con
     _denseTensorStore.getTensor(ref, tensor);
 }
 
+void
+DenseTensorAttribute::build_index(vespalib::Executor *executor)
+{
+    uint32_t doc_id_limit = _refVector.size();
+    bool multi_threaded = (executor != nullptr) &&
+                          getConfig().hnsw_index_params().has_value() &&
+                          getConfig().hnsw_index_params().value().multi_threaded_indexing();
+    if (!multi_threaded) {
+        for (uint32_t lid = 0; lid < doc_id_limit; ++lid) {
+            if (_refVector[lid].valid()) {
+                _index->add_document(lid);
+            }
+        }
+        return;
+    }
+    NearestNeighborIndexBuilder builder(*_index, *this, getGenerationHandler(), *executor,
+                                        max_pending_index_prepares, min_sequential_index_adds);
+    uint32_t added = 0;
+    for (uint32_t lid = 0; lid < doc_id_limit; ++lid) {
+        if (_refVector[lid].valid()) {
+            builder.add(lid);
+            if ((++added % index_adds_per_generation) == 0) {
+                // Allows memory held by replaced link arrays to be reused.
+                incGeneration();
+            }
+        }
+    }
+    builder.drain();
+    incGeneration();
+}
+
 bool
 DenseTensorAttribute::onLoad()
+{
+    return onLoad(nullptr);
+}
+
+bool
+DenseTensorAttribute::onLoad(vespalib::Executor *executor)
 {
     TensorReader tensorReader(*this);
     if (!tensorReader.hasData()) {
@@ -209,20 +268,19 @@ DenseTensorAttribute::onLoad()
             auto raw = _denseTensorStore.allocRawBuffer();
             tensorReader.readTensor(raw.data, _denseTensorStore.getBufSize());
             _refVector.push_back(raw.ref);
-            if (_index && !use_index_file) {
-                // This ensures that get_vector() (via getTensor()) is able to find the newly added tensor.
-                setCommittedDocIdLimit(lid + 1);
-                _index->add_document(lid);
-            }
         } else {
             _refVector.push_back(EntryRef());
         }
     }
     setNumDocs(numDocs);
     setCommittedDocIdLimit(numDocs);
+    if (_index && !use_index_file) {
+        build_index(executor);
+    }
     if (_index && use_index_file) {
+        // The index is served directly from the memory mapped file if supported by the index.
         auto buffer = LoadUtils::loadFile(*this, DenseTensorAttributeSaver::index_file_suffix());
-        if (!_index->load(*buffer)) {
+        if (!_index->load_mapped(std::move(buffer))) {
             return false;
         }
     }
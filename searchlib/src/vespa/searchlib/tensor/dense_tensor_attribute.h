@@ -25,6 +25,7 @@ private:
 
     void internal_set_tensor(DocId docid, const Tensor& tensor);
     void consider_remove_from_index(DocId docid);
+    void build_index(vespalib::Executor *executor);
     vespalib::MemoryUsage memory_usage() const override;
 
 public:
@@ -39,6 +40,7 @@ public:
     std::unique_ptr<Tensor> getTensor(DocId docId) const override;
     void getTensor(DocId docId, vespalib::tensor::MutableDenseTensorView &tensor) const override;
     bool onLoad() override;
+    bool onLoad(vespalib::Executor *executor) override;
     std::unique_ptr<AttributeSaver> onInitSave(vespalib::stringref fileName) override;
     void compactWorst() override;
     uint32_t getVersion() const override;
@@ -7,9 +7,13 @@
 #include <vespa/eval/tensor/dense/dense_tensor.h>
 #include <vespa/eval/tensor/serialization/typed_binary_format.h>
 #include <vespa/vespalib/datastore/datastore.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 using vespalib::datastore::Handle;
 using vespalib::tensor::Tensor;
+using vespalib::tensor::DenseTensor;
 using vespalib::tensor::DenseTensorView;
 using vespalib::tensor::MutableDenseTensorView;
 using vespalib::eval::ValueType;
@@ -22,14 +26,6 @@ namespace {
 constexpr size_t MIN_BUFFER_ARRAYS = 1024;
 constexpr size_t DENSE_TENSOR_ALIGNMENT = 32;
 
-size_t size_of(CellType type) {
-    switch (type) {
-    case CellType::DOUBLE: return sizeof(double);
-    case CellType::FLOAT: return sizeof(float);
-    }
-    abort();
-}
-
 size_t my_align(size_t size, size_t alignment) {
     size += alignment - 1;
     return (size - (size % alignment));
@@ -39,7 +35,7 @@ size_t my_align(size_t size, size_t alignment) {
 
 DenseTensorStore::TensorSizeCalc::TensorSizeCalc(const ValueType &type)
     : _numCells(1u),
-      _cellSize(size_of(type.cell_type()))
+      _cellSize(ValueType::cell_size(type.cell_type()))
 {
     for (const auto &dim: type.dimensions()) {
         _numCells *= dim.size;
@@ -131,6 +127,52 @@ DenseTensorStore::move(EntryRef ref)
     return newraw.ref;
 }
 
+namespace {
+
+template <typename DCT>
+struct ConvertCell {
+    template <typename SCT>
+    static DCT convert(SCT value) { return value; }
+};
+
+// int8 cells are rounded to nearest and saturated; NaN is stored as 0
+template <>
+struct ConvertCell<int8_t> {
+    template <typename SCT>
+    static int8_t convert(SCT value) {
+        double rounded = std::nearbyint(double(value));
+        if (std::isnan(rounded)) {
+            return 0;
+        }
+        return int8_t(std::clamp(rounded, double(std::numeric_limits<int8_t>::min()),
+                                 double(std::numeric_limits<int8_t>::max())));
+    }
+};
+
+template <typename SCT, typename DCT>
+void convert_cells(const void *src, DCT *dst, size_t num_cells) {
+    const SCT *cells = static_cast<const SCT *>(src);
+    for (size_t i = 0; i < num_cells; ++i) {
+        dst[i] = ConvertCell<DCT>::convert(cells[i]);
+    }
+}
+
+struct DecodeCells {
+    template <typename SCT>
+    static void invoke(const void *src, float *dst, size_t num_cells) {
+        convert_cells<SCT>(src, dst, num_cells);
+    }
+};
+
+struct EncodeCells {
+    template <typename SCT, typename DCT>
+    static void invoke(const void *src, void *dst, size_t num_cells) {
+        convert_cells<SCT>(src, static_cast<DCT *>(dst), num_cells);
+    }
+};
+
+}
+
 std::unique_ptr<Tensor>
 DenseTensorStore::getTensor(EntryRef ref) const
 {
@@ -138,9 +180,30 @@ DenseTensorStore::getTensor(EntryRef ref) const
         return std::unique_ptr<Tensor>();
     }
     vespalib::tensor::TypedCells cells_ref(getRawBuffer(ref), _type.cell_type(), getNumCells());
+    if (_type.has_storage_cell_type()) {
+        std::vector<float> cells(getNumCells());
+        decode_cells(cells_ref, &cells[0]);
+        return std::make_unique<DenseTensor<float>>(_type.decay_cell_type(), std::move(cells));
+    }
     return std::make_unique<DenseTensorView>(_type, cells_ref);
 }
 
+void
+DenseTensorStore::encode_cells(vespalib::tensor::TypedCells cells, CellType cell_type, void *dst)
+{
+    using MyTypify = vespalib::eval::TypifyStorageCellType;
+    size_t num_cells = cells.size;
+    vespalib::typify_invoke<2,MyTypify,EncodeCells>(cells.type, cell_type, cells.data, dst, num_cells);
+}
+
+void
+DenseTensorStore::decode_cells(vespalib::tensor::TypedCells cells, float *dst)
+{
+    using MyTypify = vespalib::eval::TypifyStorageCellType;
+    size_t num_cells = cells.size;
+    vespalib::typify_invoke<1,MyTypify,DecodeCells>(cells.type, cells.data, dst, num_cells);
+}
+
 void
 DenseTensorStore::getTensor(EntryRef ref, MutableDenseTensorView &tensor) const
 {
@@ -168,9 +231,13 @@ DenseTensorStore::setDenseTensor(const TensorType &tensor)
 {
     size_t numCells = tensor.cellsRef().size;
     assert(numCells == getNumCells());
-    assert(tensor.type() == _type);
     auto raw = allocRawBuffer();
-    memcpy(raw.data, tensor.cellsRef().data, getBufSize());
+    if (tensor.type() == _type) {
+        memcpy(raw.data, tensor.cellsRef().data, getBufSize());
+    } else {
+        assert(tensor.type().dimensions() == _type.dimensions());
+        encode_cells(tensor.cellsRef(), _type.cell_type(), raw.data);
+    }
     return raw.ref;
 }
 
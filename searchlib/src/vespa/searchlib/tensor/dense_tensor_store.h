@@ -13,6 +13,10 @@ namespace search::tensor {
 /**
  * Class for storing dense tensors with known bounds in memory, used
  * by DenseTensorAttribute.
+ *
+ * Cells may use a storage cell type (int8, bfloat16). Tensors set are
+ * then converted to the storage cell type, and tensors handed out for
+ * evaluation are widened to float cells.
  */
 class DenseTensorStore : public TensorStore
 {
@@ -68,6 +72,10 @@ public:
     void getTensor(EntryRef ref, vespalib::tensor::MutableDenseTensorView &tensor) const;
     vespalib::tensor::TypedCells get_typed_cells(EntryRef ref) const;
     EntryRef setTensor(const Tensor &tensor);
+    // Convert cells to the given (storage) cell type.
+    static void encode_cells(vespalib::tensor::TypedCells cells, ValueType::CellType cell_type, void *dst);
+    // Widen cells (which may have a storage cell type) to float.
+    static void decode_cells(vespalib::tensor::TypedCells cells, float *dst);
     // The following method is meant to be used only for unit tests.
     uint32_t getArraySize() const { return _bufferType.getArraySize(); }
 };
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 
 namespace vespalib::tensor { struct TypedCells; }
@@ -23,6 +24,14 @@ public:
     virtual double calc_with_limit(const vespalib::tensor::TypedCells& lhs,
                                    const vespalib::tensor::TypedCells& rhs,
                                    double limit) const = 0;
+    /**
+     * Calculates the distance between lhs and each of the num_rhs vectors in rhs,
+     * storing the distances in result. Implementations may use batched
+     * instructions that calculate several distances in one pass.
+     */
+    virtual void calc_batch(const vespalib::tensor::TypedCells& lhs,
+                            const vespalib::tensor::TypedCells* rhs,
+                            size_t num_rhs, double* result) const;
 };
 
 }
@@ -8,41 +8,33 @@ using vespalib::eval::ValueType;
 
 namespace search::tensor {
 
-DistanceFunction::UP
-make_distance_function(DistanceMetric variant, ValueType::CellType cell_type)
-{
-    switch (variant) {
+namespace {
+
+struct CreateDistanceFunction {
+    template <typename CT>
+    static DistanceFunction::UP invoke(DistanceMetric variant) {
+        switch (variant) {
         case DistanceMetric::Euclidean:
-            if (cell_type == ValueType::CellType::FLOAT) {
-                return std::make_unique<SquaredEuclideanDistance<float>>();
-            } else {
-                return std::make_unique<SquaredEuclideanDistance<double>>();
-            }
-            break;
+            return std::make_unique<SquaredEuclideanDistance<CT>>();
         case DistanceMetric::Angular:
-            if (cell_type == ValueType::CellType::FLOAT) {
-                return std::make_unique<AngularDistance<float>>();
-            } else {
-                return std::make_unique<AngularDistance<double>>();
-            }
-            break;
+            return std::make_unique<AngularDistance<CT>>();
         case DistanceMetric::GeoDegrees:
-            if (cell_type == ValueType::CellType::FLOAT) {
-                return std::make_unique<GeoDegreesDistance<float>>();
-            } else {
-                return std::make_unique<GeoDegreesDistance<double>>();
-            }
-            break;
+            return std::make_unique<GeoDegreesDistance<CT>>();
         case DistanceMetric::InnerProduct:
-            if (cell_type == ValueType::CellType::FLOAT) {
-                return std::make_unique<InnerProductDistance<float>>();
-            } else {
-                return std::make_unique<InnerProductDistance<double>>();
-            }
-            break;
+            return std::make_unique<InnerProductDistance<CT>>();
+        }
+        // not reached:
+        return DistanceFunction::UP();
     }
-    // not reached:
-    return DistanceFunction::UP();
+};
+
+}
+
+DistanceFunction::UP
+make_distance_function(DistanceMetric variant, ValueType::CellType cell_type)
+{
+    using MyTypify = vespalib::eval::TypifyStorageCellType;
+    return vespalib::typify_invoke<1,MyTypify,CreateDistanceFunction>(cell_type, variant);
 }
 
 }
@@ -4,16 +4,34 @@
 
 namespace search::tensor {
 
+void
+DistanceFunction::calc_batch(const vespalib::tensor::TypedCells& lhs,
+                             const vespalib::tensor::TypedCells* rhs,
+                             size_t num_rhs, double* result) const
+{
+    for (size_t i = 0; i < num_rhs; ++i) {
+        result[i] = calc(lhs, rhs[i]);
+    }
+}
+
 template class SquaredEuclideanDistance<float>;
 template class SquaredEuclideanDistance<double>;
+template class SquaredEuclideanDistance<vespalib::BFloat16>;
+template class SquaredEuclideanDistance<int8_t>;
 
 template class AngularDistance<float>;
 template class AngularDistance<double>;
+template class AngularDistance<vespalib::BFloat16>;
+template class AngularDistance<int8_t>;
 
 template class InnerProductDistance<float>;
 template class InnerProductDistance<double>;
+template class InnerProductDistance<vespalib::BFloat16>;
+template class InnerProductDistance<int8_t>;
 
 template class GeoDegreesDistance<float>;
 template class GeoDegreesDistance<double>;
+template class GeoDegreesDistance<vespalib::BFloat16>;
+template class GeoDegreesDistance<int8_t>;
 
 }
@@ -5,10 +5,35 @@
 #include "distance_function.h"
 #include <vespa/eval/tensor/dense/typed_cells.h>
 #include <vespa/vespalib/hwaccelrated/iaccelrated.h>
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <type_traits>
 
 namespace search::tensor {
 
+namespace distance_batch {
+
+// Max number of vectors passed to the batched distance kernels in one call.
+constexpr size_t max_rows = 64;
+
+template <typename FloatType>
+void
+gather_rows(const vespalib::tensor::TypedCells* rhs, size_t num_rhs, size_t sz, const FloatType** rows)
+{
+    for (size_t i = 0; i < num_rhs; ++i) {
+        auto rhs_vector = rhs[i].typify<FloatType>();
+        assert(sz == rhs_vector.size());
+        rows[i] = &rhs_vector[0];
+    }
+}
+
+// Result type of the batched dot product kernel for a given cell type.
+template <typename FloatType> struct DotProductResult { using type = FloatType; };
+template <> struct DotProductResult<int8_t> { using type = int64_t; };
+
+}
+
 /**
  * Calculates the square of the standard Euclidean distance.
  * Will use instruction optimal for the cpu it is running on.
@@ -46,6 +71,23 @@ public:
         }
         return sum;
     }
+    void calc_batch(const vespalib::tensor::TypedCells& lhs,
+                    const vespalib::tensor::TypedCells* rhs,
+                    size_t num_rhs, double* result) const override
+    {
+        if constexpr (std::is_same_v<FloatType, vespalib::BFloat16>) {
+            DistanceFunction::calc_batch(lhs, rhs, num_rhs, result);
+        } else {
+            auto lhs_vector = lhs.typify<FloatType>();
+            size_t sz = lhs_vector.size();
+            const FloatType *rows[distance_batch::max_rows];
+            for (size_t i = 0; i < num_rhs; i += distance_batch::max_rows) {
+                size_t n = std::min(distance_batch::max_rows, num_rhs - i);
+                distance_batch::gather_rows(rhs + i, n, sz, rows);
+                _computer.squaredEuclideanDistanceBatch(&lhs_vector[0], rows, n, sz, result + i);
+            }
+        }
+    }
 
     const vespalib::hwaccelrated::IAccelrated & _computer;
 };
@@ -122,6 +164,27 @@ public:
     {
         return calc(lhs, rhs);
     }
+    void calc_batch(const vespalib::tensor::TypedCells& lhs,
+                    const vespalib::tensor::TypedCells* rhs,
+                    size_t num_rhs, double* result) const override
+    {
+        if constexpr (std::is_same_v<FloatType, vespalib::BFloat16>) {
+            DistanceFunction::calc_batch(lhs, rhs, num_rhs, result);
+        } else {
+            auto lhs_vector = lhs.typify<FloatType>();
+            size_t sz = lhs_vector.size();
+            const FloatType *rows[distance_batch::max_rows];
+            typename distance_batch::DotProductResult<FloatType>::type dot_products[distance_batch::max_rows];
+            for (size_t i = 0; i < num_rhs; i += distance_batch::max_rows) {
+                size_t n = std::min(distance_batch::max_rows, num_rhs - i);
+                distance_batch::gather_rows(rhs + i, n, sz, rows);
+                _computer.dotProductBatch(&lhs_vector[0], rows, n, sz, dot_products);
+                for (size_t j = 0; j < n; ++j) {
+                    result[i + j] = std::max(0.0, 1.0 - dot_products[j]);
+                }
+            }
+        }
+    }
 
     const vespalib::hwaccelrated::IAccelrated & _computer;
 };
@@ -4,6 +4,7 @@
 #include "hnsw_index.h"
 #include <vespa/vespalib/datastore/array_store.hpp>
 #include <vespa/vespalib/util/rcuvector.hpp>
+#include <algorithm>
 
 namespace search::tensor {
 
@@ -11,6 +12,8 @@ HnswGraph::HnswGraph()
   : node_refs(),
     nodes(HnswIndex::make_default_node_store_config()),
     links(HnswIndex::make_default_link_store_config()),
+    base(),
+    base_node_states(),
     entry_docid_and_level()
 {
     node_refs.ensure_size(1, AtomicEntryRef());
@@ -26,6 +29,11 @@ HnswGraph::make_node_for_document(uint32_t docid, uint32_t num_levels)
     node_refs.ensure_size(docid + 1, AtomicEntryRef());
     // A document cannot be added twice.
     assert(!node_refs[docid].load_acquire().valid());
+    assert(!in_base(docid));
+    if (docid < base_node_states.size()) {
+        // A new document with this docid replaces the (removed) node in the base graph.
+        base_node_states[docid].store(BaseNodeState::REMOVED, std::memory_order_release);
+    }
     // Note: The level array instance lives as long as the document is present in the index.
     vespalib::Array<AtomicEntryRef> levels(num_levels, AtomicEntryRef());
     auto node_ref = nodes.add(levels);
@@ -37,6 +45,13 @@ void
 HnswGraph::remove_node_for_document(uint32_t docid)
 {
     auto node_ref = node_refs[docid].load_acquire();
+    if (docid < base_node_states.size()) {
+        assert(node_ref.valid() || in_base(docid));
+        base_node_states[docid].store(BaseNodeState::REMOVED, std::memory_order_release);
+        if (!node_ref.valid()) {
+            return;
+        }
+    }
     assert(node_ref.valid());
     auto levels = nodes.get(node_ref);
     vespalib::datastore::EntryRef invalid;
@@ -54,6 +69,9 @@ HnswGraph::set_link_array(uint32_t docid, uint32_t level, const LinkArrayRef& ne
 {
     auto new_links_ref = links.add(new_links);
     auto node_ref = node_refs[docid].load_acquire();
+    if (!node_ref.valid() && in_base(docid)) {
+        node_ref = copy_node_from_base(docid);
+    }
     assert(node_ref.valid());
     auto levels = nodes.get_writable(node_ref);
     assert(level < levels.size());
@@ -62,6 +80,62 @@ HnswGraph::set_link_array(uint32_t docid, uint32_t level, const LinkArrayRef& ne
     links.remove(old_links_ref);
 }
 
+HnswGraph::NodeRef
+HnswGraph::copy_node_from_base(uint32_t docid)
+{
+    uint32_t num_levels = base->get_num_levels(docid);
+    vespalib::Array<AtomicEntryRef> levels;
+    levels.reserve(num_levels);
+    for (uint32_t level = 0; level < num_levels; ++level) {
+        levels.push_back(AtomicEntryRef(links.add(base->get_link_array(docid, level))));
+    }
+    auto node_ref = nodes.add(levels);
+    // Readers seeing the node as copied must also see the new node reference.
+    node_refs[docid].store_release(node_ref);
+    base_node_states[docid].store(BaseNodeState::COPIED, std::memory_order_release);
+    return node_ref;
+}
+
+void
+HnswGraph::set_base(std::shared_ptr<const MappedHnswGraph> base_in)
+{
+    assert(!base);
+    assert(get_entry_node().docid == 0);
+    base = std::move(base_in);
+    uint32_t num_nodes = base->num_nodes();
+    base_node_states = std::vector<std::atomic<BaseNodeState>>(num_nodes);
+    node_refs.ensure_size(std::max(num_nodes, 1u), AtomicEntryRef());
+    set_entry_node({base->entry_docid(), NodeRef(), base->entry_level()});
+}
+
+HnswGraph::LinkArrayRef
+HnswGraph::get_base_link_array(uint32_t docid, uint32_t level) const
+{
+    switch (get_base_node_state(docid)) {
+    case BaseNodeState::IN_BASE:
+        return base->get_link_array(docid, level);
+    case BaseNodeState::COPIED:
+        return get_link_array(get_node_ref(docid), level);
+    case BaseNodeState::REMOVED:
+        break;
+    }
+    return LinkArrayRef();
+}
+
+uint32_t
+HnswGraph::get_base_num_levels(uint32_t docid) const
+{
+    switch (get_base_node_state(docid)) {
+    case BaseNodeState::IN_BASE:
+        return base->get_num_levels(docid);
+    case BaseNodeState::COPIED:
+        return get_level_array(get_node_ref(docid)).size();
+    case BaseNodeState::REMOVED:
+        break;
+    }
+    return 0;
+}
+
 HnswGraph::Histograms
 HnswGraph::histograms() const
 {
@@ -69,15 +143,11 @@ HnswGraph::histograms() const
     size_t num_nodes = node_refs.size();
     for (size_t i = 0; i < num_nodes; ++i) {
         auto node_ref = node_refs[i].load_acquire();
-        if (node_ref.valid()) {
-            uint32_t levels = 0;
+        if (has_node(i, node_ref)) {
+            uint32_t levels = get_num_levels(i, node_ref);
             uint32_t l0links = 0;
-            auto level_array = nodes.get(node_ref);
-            levels = level_array.size();
             if (levels > 0) {
-                auto links_ref = level_array[0].load_acquire();
-                auto link_array = links.get(links_ref);
-                l0links = link_array.size();
+                l0links = get_link_array(i, node_ref, 0).size();
             }
             while (result.level_histogram.size() <= levels) {
                 result.level_histogram.push_back(0);
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "mapped_hnsw_graph.h"
 #include <vespa/vespalib/datastore/array_store.h>
 #include <vespa/vespalib/datastore/atomic_entry_ref.h>
 #include <vespa/vespalib/datastore/entryref.h>
@@ -12,6 +13,11 @@ namespace search::tensor {
 /**
  * Stroage of a hierarchical navigable small world graph (HNSW)
  * that is used for approximate K-nearest neighbor search.
+ *
+ * The graph can have a read-only base graph that is served directly from a
+ * memory mapped save file. Nodes in the base graph have no node reference,
+ * and are copied into the node and link stores the first time they are modified.
+ * Use the accessors taking both docid and node reference to handle both cases.
  */
 struct HnswGraph {
     using AtomicEntryRef = vespalib::datastore::AtomicEntryRef;
@@ -36,9 +42,14 @@ struct HnswGraph {
     using LinkStore = vespalib::datastore::ArrayStore<uint32_t, EntryRefType>;
     using LinkArrayRef = LinkStore::ConstArrayRef;
 
+    // State of a node in the base graph, changed by the writer thread.
+    enum class BaseNodeState : uint8_t { IN_BASE = 0, COPIED = 1, REMOVED = 2 };
+
     NodeRefVector node_refs;
     NodeStore     nodes;
     LinkStore     links;
+    std::shared_ptr<const MappedHnswGraph> base;
+    std::vector<std::atomic<BaseNodeState>> base_node_states;
 
     std::atomic<uint64_t> entry_docid_and_level;
 
@@ -50,12 +61,38 @@ struct HnswGraph {
 
     void remove_node_for_document(uint32_t docid);
 
+    /**
+     * Uses the given mapped graph as read-only base for this (empty) graph.
+     */
+    void set_base(std::shared_ptr<const MappedHnswGraph> base_in);
+
     NodeRef get_node_ref(uint32_t docid) const {
         return node_refs[docid].load_acquire();
     }
 
+    BaseNodeState get_base_node_state(uint32_t docid) const {
+        if (docid < base_node_states.size() && base->get_num_levels(docid) > 0) {
+            return base_node_states[docid].load(std::memory_order_acquire);
+        }
+        return BaseNodeState::REMOVED;
+    }
+
+    // Returns true if the node for the given docid is (still) served from the base graph.
+    bool in_base(uint32_t docid) const {
+        return get_base_node_state(docid) == BaseNodeState::IN_BASE;
+    }
+
+    // Returns true if the given docid has a node, given the node reference previously read for it.
+    bool has_node(uint32_t docid, NodeRef node_ref) const {
+        return node_ref.valid() || (!base_node_states.empty() && get_base_node_state(docid) != BaseNodeState::REMOVED);
+    }
+
     bool still_valid(uint32_t docid, NodeRef node_ref) const {
-        return node_ref.valid() && (get_node_ref(docid) == node_ref);
+        if (node_ref.valid()) {
+            return (get_node_ref(docid) == node_ref);
+        }
+        // A node from the base graph stays the same node when copied.
+        return !base_node_states.empty() && (get_base_node_state(docid) != BaseNodeState::REMOVED);
     }
 
     LevelArrayRef get_level_array(NodeRef node_ref) const {
@@ -80,16 +117,36 @@ struct HnswGraph {
         return LinkArrayRef();
     }
 
-    LinkArrayRef get_link_array(uint32_t docid, uint32_t level) const {
-        auto levels = get_level_array(docid);
-        return get_link_array(levels, level);
-    }
-
     LinkArrayRef get_link_array(NodeRef node_ref, uint32_t level) const {
         auto levels = get_level_array(node_ref);
         return get_link_array(levels, level);
     }
 
+    LinkArrayRef get_link_array(uint32_t docid, NodeRef node_ref, uint32_t level) const {
+        if (node_ref.valid()) {
+            return get_link_array(node_ref, level);
+        }
+        return get_base_link_array(docid, level);
+    }
+
+    LinkArrayRef get_link_array(uint32_t docid, uint32_t level) const {
+        return get_link_array(docid, get_node_ref(docid), level);
+    }
+
+    uint32_t get_num_levels(uint32_t docid, NodeRef node_ref) const {
+        if (node_ref.valid()) {
+            return get_level_array(node_ref).size();
+        }
+        return get_base_num_levels(docid);
+    }
+
+    uint32_t get_num_levels(uint32_t docid) const {
+        return get_num_levels(docid, get_node_ref(docid));
+    }
+
+    LinkArrayRef get_base_link_array(uint32_t docid, uint32_t level) const;
+    uint32_t get_base_num_levels(uint32_t docid) const;
+
     void set_link_array(uint32_t docid, uint32_t level, const LinkArrayRef& new_links);
 
     struct EntryNode {
@@ -112,7 +169,7 @@ struct HnswGraph {
         uint64_t value = node.level;
         value <<= 32;
         value |= node.docid;
-        if (node.node_ref.valid()) {
+        if (node.node_ref.valid() || (node.docid != 0 && in_base(node.docid))) {
             assert(node.level >= 0);
             assert(node.docid > 0);
         } else {
@@ -142,7 +199,7 @@ struct HnswGraph {
             }
             if ((entry.docid > 0)
                 && (entry.level > -1)
-                && entry.node_ref.valid()
+                && has_node(entry.docid, entry.node_ref)
                 && (get_entry_atomic() == value))
             {
                 // valid in every way
@@ -158,6 +215,9 @@ struct HnswGraph {
         std::vector<uint32_t> links_histogram;
     };
     Histograms histograms() const;
+
+private:
+    NodeRef copy_node_from_base(uint32_t docid);
 };
 
 }
@@ -5,12 +5,16 @@
 #include "hnsw_index_loader.h"
 #include "hnsw_index_saver.h"
 #include "random_level_generator.h"
+#include <vespa/searchlib/util/fileutil.h>
 #include <vespa/searchlib/util/state_explorer_utils.h>
 #include <vespa/eval/tensor/dense/typed_cells.h>
 #include <vespa/vespalib/data/slime/cursor.h>
 #include <vespa/vespalib/data/slime/inserter.h>
 #include <vespa/vespalib/datastore/array_store.hpp>
 #include <vespa/vespalib/util/rcuvector.hpp>
+#include <algorithm>
+#include <deque>
+#include <limits>
 #include <vespa/log/log.h>
 
 LOG_SETUP(".searchlib.tensor.hnsw_index");
@@ -29,6 +33,22 @@ constexpr float alloc_grow_factor = 0.2;
 // TODO: Adjust these numbers to what we accept as max in config.
 constexpr size_t max_level_array_size = 16;
 constexpr size_t max_link_array_size = 64;
+// Number of input vectors searched in lock-step by HnswIndex::search_layer_batch().
+constexpr size_t batch_search_group_size = 16;
+
+/**
+ * Search state for one of the input vectors in HnswIndex::search_layer_batch().
+ */
+struct BatchSearchState {
+    NearestPriQ candidates;
+    vespalib::ReusableSetHandle visited;
+    double limit_dist;
+    BatchSearchState(vespalib::ReusableSetPool &pool, uint32_t doc_id_limit)
+        : candidates(),
+          visited(pool.get(doc_id_limit)),
+          limit_dist(std::numeric_limits<double>::max())
+    {}
+};
 
 bool has_link_to(vespalib::ConstArrayRef<uint32_t> links, uint32_t id) {
     for (uint32_t link : links) {
@@ -206,7 +226,7 @@ HnswIndex::find_nearest_in_layer(const TypedCells& input, const HnswCandidate& e
     bool keep_searching = true;
     while (keep_searching) {
         keep_searching = false;
-        for (uint32_t neighbor_docid : _graph.get_link_array(nearest.node_ref, level)) {
+        for (uint32_t neighbor_docid : _graph.get_link_array(nearest.docid, nearest.node_ref, level)) {
             auto neighbor_ref = _graph.get_node_ref(neighbor_docid);
             double dist = calc_distance(input, neighbor_docid);
             if (_graph.still_valid(neighbor_docid, neighbor_ref)
@@ -249,9 +269,9 @@ HnswIndex::search_layer(const TypedCells& input, uint32_t neighbors_to_find,
             break;
         }
         candidates.pop();
-        for (uint32_t neighbor_docid : _graph.get_link_array(cand.node_ref, level)) {
+        for (uint32_t neighbor_docid : _graph.get_link_array(cand.docid, cand.node_ref, level)) {
             auto neighbor_ref = _graph.get_node_ref(neighbor_docid);
-            if ((! neighbor_ref.valid())
+            if ((! _graph.has_node(neighbor_docid, neighbor_ref))
                 || (neighbor_docid >= doc_id_limit)
                 || visited.is_marked(neighbor_docid))
             {
@@ -273,6 +293,71 @@ HnswIndex::search_layer(const TypedCells& input, uint32_t neighbors_to_find,
     }
 }
 
+void
+HnswIndex::search_layer_batch(vespalib::ConstArrayRef<TypedCells> inputs, uint32_t neighbors_to_find,
+                              std::vector<FurthestPriQ>& best_neighbors, uint32_t level,
+                              const search::BitVector *filter) const
+{
+    assert(inputs.size() == best_neighbors.size());
+    uint32_t doc_id_limit = _graph.node_refs.size();
+    if (filter) {
+        doc_id_limit = std::min(filter->size(), doc_id_limit);
+    }
+    for (size_t group_begin = 0; group_begin < inputs.size(); group_begin += batch_search_group_size) {
+        size_t group_end = std::min(inputs.size(), group_begin + batch_search_group_size);
+        std::deque<BatchSearchState> states;
+        for (size_t i = group_begin; i < group_end; ++i) {
+            auto &state = states.emplace_back(_visited_set_pool, doc_id_limit);
+            for (const auto &entry : best_neighbors[i].peek()) {
+                if (entry.docid >= doc_id_limit) {
+                    continue;
+                }
+                state.candidates.push(entry);
+                state.visited.mark(entry.docid);
+                if (filter && !filter->testBit(entry.docid)) {
+                    assert(best_neighbors[i].size() == 1);
+                    best_neighbors[i].pop();
+                }
+            }
+        }
+        bool active = true;
+        while (active) {
+            active = false;
+            for (size_t i = group_begin; i < group_end; ++i) {
+                auto &state = states[i - group_begin];
+                auto &best = best_neighbors[i];
+                if (state.candidates.empty() || (state.candidates.top().distance > state.limit_dist)) {
+                    continue;
+                }
+                active = true;
+                auto cand = state.candidates.top();
+                state.candidates.pop();
+                for (uint32_t neighbor_docid : _graph.get_link_array(cand.docid, cand.node_ref, level)) {
+                    auto neighbor_ref = _graph.get_node_ref(neighbor_docid);
+                    if ((! _graph.has_node(neighbor_docid, neighbor_ref))
+                        || (neighbor_docid >= doc_id_limit)
+                        || state.visited.is_marked(neighbor_docid))
+                    {
+                        continue;
+                    }
+                    state.visited.mark(neighbor_docid);
+                    double dist_to_input = calc_distance(inputs[i], neighbor_docid);
+                    if (dist_to_input < state.limit_dist) {
+                        state.candidates.emplace(neighbor_docid, neighbor_ref, dist_to_input);
+                        if ((!filter) || filter->testBit(neighbor_docid)) {
+                            best.emplace(neighbor_docid, neighbor_ref, dist_to_input);
+                            if (best.size() > neighbors_to_find) {
+                                best.pop();
+                                state.limit_dist = best.top().distance;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
 HnswIndex::HnswIndex(const DocVectorAccess& vectors, DistanceFunction::UP distance_func,
                      RandomLevelGenerator::UP level_generator, const Config& cfg)
     :
@@ -324,12 +409,12 @@ HnswIndex::internal_prepare_add(uint32_t docid, TypedCells input_vector, vespali
         auto neighbors = select_neighbors(best_neighbors.peek(), _cfg.max_links_on_inserts());
         op.connections[search_level].reserve(neighbors.used.size());
         for (const auto & neighbor : neighbors.used) {
-            auto neighbor_levels = _graph.get_level_array(neighbor.node_ref);
-            if (size_t(search_level) < neighbor_levels.size()) {
+            uint32_t neighbor_levels = _graph.get_num_levels(neighbor.docid, neighbor.node_ref);
+            if (uint32_t(search_level) < neighbor_levels) {
                 op.connections[search_level].emplace_back(neighbor.docid, neighbor.node_ref);
             } else {
-                LOG(warning, "in prepare_add(%u), selected neighbor %u is missing level %d (has %zu levels)",
-                    docid, neighbor.docid, search_level, neighbor_levels.size());
+                LOG(warning, "in prepare_add(%u), selected neighbor %u is missing level %d (has %u levels)",
+                    docid, neighbor.docid, search_level, neighbor_levels);
             }
         }
         --search_level;
@@ -347,8 +432,7 @@ HnswIndex::filter_valid_docids(uint32_t level, const PreparedAddDoc::Links &neig
         HnswGraph::NodeRef node_ref = neighbor.second;
         if (_graph.still_valid(docid, node_ref)) {
             assert(docid != self_docid);
-            auto levels = _graph.get_level_array(node_ref);
-            if (level < levels.size()) {
+            if (level < _graph.get_num_levels(docid, node_ref)) {
                 valid.push_back(docid);     
             }
         }
@@ -431,8 +515,8 @@ void
 HnswIndex::remove_document(uint32_t docid)
 {
     bool need_new_entrypoint = (docid == get_entry_docid());
-    LevelArrayRef node_levels = _graph.get_level_array(docid);
-    for (int level = node_levels.size(); level-- > 0; ) {
+    uint32_t num_levels = _graph.get_num_levels(docid);
+    for (int level = num_levels; level-- > 0; ) {
         LinkArrayRef my_links = _graph.get_link_array(docid, level);
         for (uint32_t neighbor_id : my_links) {
             if (need_new_entrypoint) {
@@ -477,6 +561,11 @@ HnswIndex::memory_usage() const
     result.merge(_graph.nodes.getMemoryUsage());
     result.merge(_graph.links.getMemoryUsage());
     result.merge(_visited_set_pool.memory_usage());
+    if (!_graph.base_node_states.empty()) {
+        // The base graph itself is memory mapped, only the node state array is heap allocated.
+        result.incAllocatedBytes(_graph.base_node_states.size() * sizeof(_graph.base_node_states[0]));
+        result.incUsedBytes(_graph.base_node_states.size() * sizeof(_graph.base_node_states[0]));
+    }
     return result;
 }
 
@@ -504,6 +593,9 @@ HnswIndex::get_state(const vespalib::slime::Inserter& inserter) const
     auto entry_node = _graph.get_entry_node();
     object.setLong("entry_docid", entry_node.docid);
     object.setLong("entry_level", entry_node.level);
+    if (_graph.base) {
+        object.setLong("mapped_graph_bytes", _graph.base->mapped_bytes());
+    }
     auto& cfgObj = object.setObject("cfg");
     cfgObj.setLong("max_links_at_level_0", _cfg.max_links_at_level_0());
     cfgObj.setLong("max_links_on_inserts", _cfg.max_links_on_inserts());
@@ -525,6 +617,21 @@ HnswIndex::load(const fileutil::LoadedBuffer& buf)
     return loader.load(buf);
 }
 
+bool
+HnswIndex::load_mapped(std::unique_ptr<fileutil::LoadedBuffer> buf)
+{
+    assert(get_entry_docid() == 0); // cannot load after index has data
+    if (!MappedHnswGraph::is_mappable_format(*buf)) {
+        return load(*buf);
+    }
+    auto mapped = MappedHnswGraph::make(std::move(buf));
+    if (!mapped) {
+        return false;
+    }
+    _graph.set_base(std::move(mapped));
+    return true;
+}
+
 struct NeighborsByDocId {
     bool operator() (const NearestNeighborIndex::Neighbor &lhs,
                      const NearestNeighborIndex::Neighbor &rhs)
@@ -533,12 +640,12 @@ struct NeighborsByDocId {
     }
 };
 
+namespace {
+
 std::vector<NearestNeighborIndex::Neighbor>
-HnswIndex::top_k_by_docid(uint32_t k, TypedCells vector,
-                          const BitVector *filter, uint32_t explore_k) const
+best_by_docid(uint32_t k, FurthestPriQ &candidates)
 {
-    std::vector<Neighbor> result;
-    FurthestPriQ candidates = top_k_candidates(vector, std::max(k, explore_k), filter);
+    std::vector<NearestNeighborIndex::Neighbor> result;
     while (candidates.size() > k) {
         candidates.pop();
     }
@@ -550,6 +657,16 @@ HnswIndex::top_k_by_docid(uint32_t k, TypedCells vector,
     return result;
 }
 
+}
+
+std::vector<NearestNeighborIndex::Neighbor>
+HnswIndex::top_k_by_docid(uint32_t k, TypedCells vector,
+                          const BitVector *filter, uint32_t explore_k) const
+{
+    FurthestPriQ candidates = top_k_candidates(vector, std::max(k, explore_k), filter);
+    return best_by_docid(k, candidates);
+}
+
 std::vector<NearestNeighborIndex::Neighbor>
 HnswIndex::find_top_k(uint32_t k, TypedCells vector, uint32_t explore_k) const
 {
@@ -563,6 +680,19 @@ HnswIndex::find_top_k_with_filter(uint32_t k, TypedCells vector,
     return top_k_by_docid(k, vector, &filter, explore_k);
 }
 
+std::vector<std::vector<NearestNeighborIndex::Neighbor>>
+HnswIndex::find_top_k_batch(uint32_t k, vespalib::ConstArrayRef<TypedCells> vectors,
+                            const BitVector *filter, uint32_t explore_k) const
+{
+    auto candidates = top_k_candidates_batch(vectors, std::max(k, explore_k), filter);
+    std::vector<std::vector<Neighbor>> result;
+    result.reserve(candidates.size());
+    for (auto &query_candidates : candidates) {
+        result.push_back(best_by_docid(k, query_candidates));
+    }
+    return result;
+}
+
 FurthestPriQ
 HnswIndex::top_k_candidates(const TypedCells &vector, uint32_t k, const BitVector *filter) const
 {
@@ -585,17 +715,39 @@ HnswIndex::top_k_candidates(const TypedCells &vector, uint32_t k, const BitVecto
     return best_neighbors;
 }
 
+std::vector<FurthestPriQ>
+HnswIndex::top_k_candidates_batch(vespalib::ConstArrayRef<TypedCells> vectors, uint32_t k,
+                                  const BitVector *filter) const
+{
+    std::vector<FurthestPriQ> best_neighbors(vectors.size());
+    auto entry = _graph.get_entry_node();
+    if (entry.docid == 0) {
+        // graph has no entry point
+        return best_neighbors;
+    }
+    auto entry_vector = get_vector(entry.docid);
+    for (size_t i = 0; i < vectors.size(); ++i) {
+        HnswCandidate entry_point(entry.docid, entry.node_ref, _distance_func->calc(vectors[i], entry_vector));
+        for (int search_level = entry.level; search_level > 0; --search_level) {
+            entry_point = find_nearest_in_layer(vectors[i], entry_point, search_level);
+        }
+        best_neighbors[i].push(entry_point);
+    }
+    search_layer_batch(vectors, k, best_neighbors, 0, filter);
+    return best_neighbors;
+}
+
 HnswNode
 HnswIndex::get_node(uint32_t docid) const
 {
-    auto node_ref = _graph.node_refs[docid].load_acquire();
-    if (!node_ref.valid()) {
+    auto node_ref = _graph.get_node_ref(docid);
+    if (!_graph.has_node(docid, node_ref)) {
         return HnswNode();
     }
-    auto levels = _graph.nodes.get(node_ref);
+    uint32_t num_levels = _graph.get_num_levels(docid, node_ref);
     HnswNode::LevelArray result;
-    for (const auto& links_ref : levels) {
-        auto links = _graph.links.get(links_ref.load_acquire());
+    for (uint32_t level = 0; level < num_levels; ++level) {
+        auto links = _graph.get_link_array(docid, node_ref, level);
         HnswNode::LinkArray result_links(links.begin(), links.end());
         std::sort(result_links.begin(), result_links.end());
         result.push_back(result_links);
@@ -623,12 +775,11 @@ HnswIndex::check_link_symmetry() const
 {
     bool all_sym = true;
     for (size_t docid = 0; docid < _graph.node_refs.size(); ++docid) {
-        auto node_ref = _graph.node_refs[docid].load_acquire();
-        if (node_ref.valid()) {
-            auto levels = _graph.nodes.get(node_ref);
-            uint32_t level = 0;
-            for (const auto& links_ref : levels) {
-                auto links = _graph.links.get(links_ref.load_acquire());
+        auto node_ref = _graph.get_node_ref(docid);
+        if (_graph.has_node(docid, node_ref)) {
+            uint32_t num_levels = _graph.get_num_levels(docid, node_ref);
+            for (uint32_t level = 0; level < num_levels; ++level) {
+                auto links = _graph.get_link_array(docid, node_ref, level);
                 for (auto neighbor_docid : links) {
                     auto neighbor_links = _graph.get_link_array(neighbor_docid, level);
                     if (! has_link_to(neighbor_links, docid)) {
@@ -637,7 +788,6 @@ HnswIndex::check_link_symmetry() const
                             docid, neighbor_docid, level);
                     }
                 }
-                ++level;
             }
         }
     }
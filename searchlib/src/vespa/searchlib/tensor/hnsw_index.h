@@ -122,6 +122,16 @@ protected:
     HnswCandidate find_nearest_in_layer(const TypedCells& input, const HnswCandidate& entry_point, uint32_t level) const;
     void search_layer(const TypedCells& input, uint32_t neighbors_to_find, FurthestPriQ& found_neighbors,
                       uint32_t level, const search::BitVector *filter = nullptr) const;
+    /**
+     * Performs search_layer() for groups of input vectors in lock-step,
+     * expanding one candidate per input vector in each step.
+     * Input vectors that are close to each other then visit the same nodes at about the same time,
+     * so the fetched links and node vectors are shared via the cpu cache.
+     * The result for each input vector is the same as when calling search_layer() for it separately.
+     */
+    void search_layer_batch(vespalib::ConstArrayRef<TypedCells> inputs, uint32_t neighbors_to_find,
+                            std::vector<FurthestPriQ>& best_neighbors, uint32_t level,
+                            const search::BitVector *filter) const;
     std::vector<Neighbor> top_k_by_docid(uint32_t k, TypedCells vector,
                                          const BitVector *filter, uint32_t explore_k) const;
 
@@ -165,13 +175,18 @@ public:
 
     std::unique_ptr<NearestNeighborIndexSaver> make_saver() const override;
     bool load(const fileutil::LoadedBuffer& buf) override;
+    bool load_mapped(std::unique_ptr<fileutil::LoadedBuffer> buf) override;
 
     std::vector<Neighbor> find_top_k(uint32_t k, TypedCells vector, uint32_t explore_k) const override;
     std::vector<Neighbor> find_top_k_with_filter(uint32_t k, TypedCells vector,
                                                  const BitVector &filter, uint32_t explore_k) const override;
+    std::vector<std::vector<Neighbor>> find_top_k_batch(uint32_t k, vespalib::ConstArrayRef<TypedCells> vectors,
+                                                        const BitVector *filter, uint32_t explore_k) const override;
     const DistanceFunction *distance_function() const override { return _distance_func.get(); }
 
     FurthestPriQ top_k_candidates(const TypedCells &vector, uint32_t k, const BitVector *filter) const;
+    std::vector<FurthestPriQ> top_k_candidates_batch(vespalib::ConstArrayRef<TypedCells> vectors, uint32_t k,
+                                                     const BitVector *filter) const;
 
     uint32_t get_entry_docid() const { return _graph.get_entry_node().docid; }
     int32_t get_entry_level() const { return _graph.get_entry_node().level; }
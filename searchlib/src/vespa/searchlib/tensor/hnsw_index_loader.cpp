@@ -3,6 +3,7 @@
 #include "hnsw_index_loader.h"
 #include "hnsw_graph.h"
 #include <vespa/searchlib/util/fileutil.h>
+#include <algorithm>
 
 namespace search::tensor {
 
@@ -13,9 +14,38 @@ HnswIndexLoader::HnswIndexLoader(HnswGraph &graph)
 {
 }
 
+bool
+HnswIndexLoader::load_mappable_format(const fileutil::LoadedBuffer& buf)
+{
+    auto mapped = MappedHnswGraph::make_view(buf);
+    if (!mapped) {
+        return false;
+    }
+    uint32_t num_nodes = mapped->num_nodes();
+    std::vector<uint32_t> link_array;
+    for (uint32_t docid = 0; docid < num_nodes; ++docid) {
+        uint32_t num_levels = mapped->get_num_levels(docid);
+        if (num_levels > 0) {
+            _graph.make_node_for_document(docid, num_levels);
+            for (uint32_t level = 0; level < num_levels; ++level) {
+                auto links = mapped->get_link_array(docid, level);
+                link_array.assign(links.cbegin(), links.cend());
+                _graph.set_link_array(docid, level, link_array);
+            }
+        }
+    }
+    _graph.node_refs.ensure_size(std::max(num_nodes, 1u));
+    auto entry_node_ref = _graph.get_node_ref(mapped->entry_docid());
+    _graph.set_entry_node({mapped->entry_docid(), entry_node_ref, mapped->entry_level()});
+    return true;
+}
+
 bool
 HnswIndexLoader::load(const fileutil::LoadedBuffer& buf)
 {
+    if (MappedHnswGraph::is_mappable_format(buf)) {
+        return load_mappable_format(buf);
+    }
     size_t num_readable = buf.size(sizeof(uint32_t));
     _ptr = static_cast<const uint32_t *>(buf.buffer());
     _end = _ptr + num_readable;
@@ -12,6 +12,7 @@ struct HnswGraph;
 
 /**
  * Implements loading of HNSW graph structure from binary format.
+ * Both the mappable format (see MappedHnswGraph) and the older streamed format are supported.
  **/
 class HnswIndexLoader {
 public:
@@ -23,6 +24,7 @@ private:
     const uint32_t *_ptr;
     const uint32_t *_end;
     bool _failed;
+    bool load_mappable_format(const fileutil::LoadedBuffer& buf);
     uint32_t next_int() {
         if (__builtin_expect((_ptr == _end), false)) {
             _failed = true;
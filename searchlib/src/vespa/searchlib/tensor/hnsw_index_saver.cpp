@@ -9,13 +9,16 @@ namespace search::tensor {
 HnswIndexSaver::~HnswIndexSaver() {}
 
 HnswIndexSaver::HnswIndexSaver(const HnswGraph &graph)
-    : _graph_links(graph.links), _meta_data()
+    : _graph_links(graph.links), _graph_base(graph.base), _meta_data()
 {
     auto entry = graph.get_entry_node();
     _meta_data.entry_docid = entry.docid;
     _meta_data.entry_level = entry.level;
     size_t num_nodes = graph.node_refs.size();
     _meta_data.nodes.reserve(num_nodes);
+    if (_graph_base) {
+        _meta_data.in_base.resize(num_nodes, false);
+    }
     for (size_t i = 0; i < num_nodes; ++i) {
         LevelVector node;
         auto node_ref = graph.node_refs[i].load_acquire();
@@ -25,32 +28,68 @@ HnswIndexSaver::HnswIndexSaver(const HnswGraph &graph)
                 auto level = links_ref.load_acquire();
                 node.push_back(level);
             }
+        } else if (_graph_base && graph.in_base(i)) {
+            _meta_data.in_base[i] = true;
         }
         _meta_data.nodes.emplace_back(std::move(node));
     }
 }
 
+uint32_t
+HnswIndexSaver::num_levels(uint32_t docid) const
+{
+    if (!_meta_data.in_base.empty() && _meta_data.in_base[docid]) {
+        return _graph_base->get_num_levels(docid);
+    }
+    return _meta_data.nodes[docid].size();
+}
+
+vespalib::ConstArrayRef<uint32_t>
+HnswIndexSaver::get_link_array(uint32_t docid, uint32_t level) const
+{
+    if (!_meta_data.in_base.empty() && _meta_data.in_base[docid]) {
+        return _graph_base->get_link_array(docid, level);
+    }
+    auto links_ref = _meta_data.nodes[docid][level];
+    if (links_ref.valid()) {
+        return _graph_links.get(links_ref);
+    }
+    return vespalib::ConstArrayRef<uint32_t>();
+}
+
 void
 HnswIndexSaver::save(BufferWriter& writer) const
 {
-    writer.write(&_meta_data.entry_docid, sizeof(uint32_t));
-    writer.write(&_meta_data.entry_level, sizeof(int32_t));
     uint32_t num_nodes = _meta_data.nodes.size();
-    writer.write(&num_nodes, sizeof(uint32_t));
-    for (const auto &node : _meta_data.nodes) {
-        uint32_t num_levels = node.size();
-        writer.write(&num_levels, sizeof(uint32_t));
-        for (auto links_ref : node) {
-            if (links_ref.valid()) {
-                vespalib::ConstArrayRef<uint32_t> link_array = _graph_links.get(links_ref);
-                uint32_t num_links = link_array.size();
-                writer.write(&num_links, sizeof(uint32_t));
-                writer.write(link_array.cbegin(), sizeof(uint32_t)*num_links);
-            } else {
-                uint32_t num_links = 0;
-                writer.write(&num_links, sizeof(uint32_t));
+    uint32_t header[MappedHnswGraph::header_words] = { MappedHnswGraph::magic, MappedHnswGraph::version,
+                                                      _meta_data.entry_docid, uint32_t(_meta_data.entry_level),
+                                                      num_nodes, 0 };
+    writer.write(header, sizeof(header));
+    // First pass writes the offset of each node, the second pass writes the nodes.
+    uint64_t offset = 0;
+    writer.write(&offset, sizeof(uint64_t));
+    for (uint32_t docid = 0; docid < num_nodes; ++docid) {
+        uint32_t levels = num_levels(docid);
+        if (levels > 0) {
+            offset += 1 + levels;
+            for (uint32_t level = 0; level < levels; ++level) {
+                offset += get_link_array(docid, level).size();
             }
         }
+        writer.write(&offset, sizeof(uint64_t));
+    }
+    for (uint32_t docid = 0; docid < num_nodes; ++docid) {
+        uint32_t levels = num_levels(docid);
+        if (levels == 0) {
+            continue;
+        }
+        writer.write(&levels, sizeof(uint32_t));
+        for (uint32_t level = 0; level < levels; ++level) {
+            auto link_array = get_link_array(docid, level);
+            uint32_t num_links = link_array.size();
+            writer.write(&num_links, sizeof(uint32_t));
+            writer.write(link_array.cbegin(), sizeof(uint32_t)*num_links);
+        }
     }
     writer.flush();
 }
@@ -14,6 +14,9 @@ namespace search::tensor {
  * The constructor takes a snapshot of all meta-data, but
  * the links will be fetched from the graph in the save()
  * method.
+ *
+ * The graph is saved in the format described in MappedHnswGraph,
+ * which can be served directly from the memory mapped file after restart.
  **/
 class HnswIndexSaver : public NearestNeighborIndexSaver {
 public:
@@ -28,10 +31,16 @@ private:
         uint32_t entry_docid;
         int32_t  entry_level;
         std::vector<LevelVector> nodes;
-        MetaData() : entry_docid(0), entry_level(-1), nodes() {}
+        // Nodes that are still served from the base graph, and saved from there.
+        std::vector<bool> in_base;
+        MetaData() : entry_docid(0), entry_level(-1), nodes(), in_base() {}
     };
     const HnswGraph::LinkStore &_graph_links;
+    std::shared_ptr<const MappedHnswGraph> _graph_base;
     MetaData _meta_data;
+
+    uint32_t num_levels(uint32_t docid) const;
+    vespalib::ConstArrayRef<uint32_t> get_link_array(uint32_t docid, uint32_t level) const;
 };
 
 }
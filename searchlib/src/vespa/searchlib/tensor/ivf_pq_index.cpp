@@ -0,0 +1,658 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "ivf_pq_index.h"
+#include "ivf_pq_index_saver.h"
+#include <vespa/searchlib/common/bitvector.h>
+#include <vespa/searchlib/util/fileutil.h>
+#include <vespa/searchlib/util/state_explorer_utils.h>
+#include <vespa/vespalib/data/slime/cursor.h>
+#include <vespa/vespalib/data/slime/inserter.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/rcuvector.hpp>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <queue>
+#include <vespa/log/log.h>
+
+LOG_SETUP(".searchlib.tensor.ivf_pq_index");
+
+namespace search::tensor {
+
+using search::StateExplorerUtils;
+using search::attribute::DistanceMetric;
+
+namespace {
+
+constexpr uint32_t min_list_capacity = 4;
+
+IvfPqIndex::Config
+adjust_config(const IvfPqIndex::Config& cfg, uint32_t dims)
+{
+    uint32_t num_centroids = std::max(cfg.num_centroids(), 1u);
+    uint32_t min_training_docs = std::max(cfg.min_training_docs(), std::max(num_centroids, ProductQuantizer::codebook_size));
+    return IvfPqIndex::Config(num_centroids,
+                              ProductQuantizer::adjust_num_subquantizers(dims, cfg.num_subquantizers()),
+                              min_training_docs,
+                              cfg.training_iterations(),
+                              cfg.min_probes(),
+                              cfg.distance_metric());
+}
+
+ProductQuantizer::Metric
+quantizer_metric(DistanceMetric metric)
+{
+    // Angular distance uses squared euclidean distance between normalized vectors.
+    return (metric == DistanceMetric::InnerProduct) ? ProductQuantizer::Metric::InnerProduct
+                                                    : ProductQuantizer::Metric::SquaredEuclidean;
+}
+
+using Candidate = std::pair<float, uint32_t>;
+
+/**
+ * Returns the best k neighbors sorted by docid, as expected by the nearest neighbor blueprint.
+ */
+std::vector<NearestNeighborIndex::Neighbor>
+best_by_docid(uint32_t k, std::vector<NearestNeighborIndex::Neighbor> neighbors)
+{
+    using Neighbor = NearestNeighborIndex::Neighbor;
+    if (neighbors.size() > k) {
+        std::nth_element(neighbors.begin(), neighbors.begin() + k, neighbors.end(),
+                         [](const Neighbor &a, const Neighbor &b) { return a.distance < b.distance; });
+        neighbors.resize(k);
+    }
+    std::sort(neighbors.begin(), neighbors.end(),
+              [](const Neighbor &a, const Neighbor &b) { return a.docid < b.docid; });
+    return neighbors;
+}
+
+class BufferReader {
+private:
+    const char *_ptr;
+    const char *_end;
+public:
+    BufferReader(const fileutil::LoadedBuffer& buf)
+        : _ptr(buf.c_str()),
+          _end(buf.c_str() + buf.size())
+    {}
+    bool read(void *dst, size_t bytes) {
+        if (size_t(_end - _ptr) < bytes) {
+            return false;
+        }
+        if (bytes > 0) {
+            memcpy(dst, _ptr, bytes);
+        }
+        _ptr += bytes;
+        return true;
+    }
+    bool read(uint32_t &value) { return read(&value, sizeof(uint32_t)); }
+    bool at_end() const { return _ptr == _end; }
+};
+
+class HeldPostingList : public vespalib::GenerationHeldBase {
+private:
+    std::unique_ptr<IvfPqIndex::PostingList> _list;
+public:
+    HeldPostingList(std::unique_ptr<IvfPqIndex::PostingList> list)
+        : GenerationHeldBase(list->capacity() * sizeof(uint32_t)),
+          _list(std::move(list))
+    {}
+};
+
+}
+
+IvfPqIndex::PostingList::PostingList(uint32_t capacity)
+    : _docids(std::make_unique<std::atomic<uint32_t>[]>(capacity)),
+      _capacity(capacity),
+      _size(0),
+      _num_removed(0)
+{
+}
+
+IvfPqIndex::PostingList::~PostingList() = default;
+
+void
+IvfPqIndex::PostingList::push_back(uint32_t docid)
+{
+    uint32_t size = _size.load(std::memory_order_relaxed);
+    assert(size < _capacity);
+    _docids[size].store(docid, std::memory_order_relaxed);
+    _size.store(size + 1, std::memory_order_release);
+}
+
+bool
+IvfPqIndex::PostingList::remove(uint32_t docid)
+{
+    uint32_t size = _size.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < size; ++i) {
+        if (_docids[i].load(std::memory_order_relaxed) == docid) {
+            _docids[i].store(0, std::memory_order_relaxed);
+            _num_removed.store(_num_removed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+IvfPqIndex::TrainingResult::TrainingResult() : quantizer(), docids(), lists(), codes() {}
+IvfPqIndex::TrainingResult::~TrainingResult() = default;
+
+IvfPqIndex::PreparedAddDoc::~PreparedAddDoc() = default;
+
+IvfPqIndex::IvfPqIndex(const DocVectorAccess& vectors, size_t vector_size, DistanceFunction::UP distance_func, const Config& cfg)
+    : _vectors(vectors),
+      _distance_func(std::move(distance_func)),
+      _cfg(adjust_config(cfg, vector_size)),
+      _dims(vector_size),
+      _normalize(cfg.distance_metric() == DistanceMetric::Angular),
+      _quantizer(),
+      _quantizer_ptr(nullptr),
+      _doc_lists(),
+      _codes(),
+      _lists(_cfg.num_centroids()),
+      _list_ptrs(_cfg.num_centroids()),
+      _list_holder(),
+      _num_not_encoded(0),
+      _training(false),
+      _removed_while_training(),
+      _training_lock(),
+      _training_result(),
+      _training_executor()
+{
+    _doc_lists.ensure_size(1, 0);
+}
+
+IvfPqIndex::~IvfPqIndex()
+{
+    if (_training_executor) {
+        // The training task must be done before the rest of the index is destroyed.
+        _training_executor->shutdown().sync();
+    }
+    _list_holder.clearHoldLists();
+}
+
+void
+IvfPqIndex::to_float(TypedCells vector, std::vector<float>& result) const
+{
+    result.resize(_dims);
+    double sum_squares = 0.0;
+    for (uint32_t i = 0; i < _dims; ++i) {
+        result[i] = vector.get(i);
+        sum_squares += double(result[i]) * result[i];
+    }
+    if (_normalize && (sum_squares > 0.0)) {
+        float scale = 1.0 / std::sqrt(sum_squares);
+        for (auto& cell : result) {
+            cell *= scale;
+        }
+    }
+}
+
+std::vector<uint32_t>
+IvfPqIndex::get_list(uint32_t list) const
+{
+    std::vector<uint32_t> result;
+    const PostingList *posting_list = get_posting_list(list);
+    if (posting_list != nullptr) {
+        result.reserve(posting_list->size());
+        posting_list->for_each([&result](uint32_t docid) { result.push_back(docid); });
+    }
+    return result;
+}
+
+IvfPqIndex::PostingList *
+IvfPqIndex::replace_list(uint32_t list)
+{
+    // Copies the document ids still present into a new list with room to grow,
+    // and holds the old list until no readers can reference it.
+    std::unique_ptr<PostingList> old_list = std::move(_lists[list]);
+    uint32_t num_docs = old_list ? old_list->num_docs() : 0;
+    auto new_list = std::make_unique<PostingList>(std::max(min_list_capacity, num_docs + (num_docs / 2) + 1));
+    if (old_list) {
+        old_list->for_each([&new_list](uint32_t docid) { new_list->push_back(docid); });
+    }
+    _lists[list] = std::move(new_list);
+    _list_ptrs[list].store(_lists[list].get(), std::memory_order_release);
+    if (old_list) {
+        _list_holder.hold(std::make_unique<HeldPostingList>(std::move(old_list)));
+    }
+    return _lists[list].get();
+}
+
+void
+IvfPqIndex::set_codes(uint32_t docid, const uint8_t *codes)
+{
+    size_t code_size = _cfg.num_subquantizers();
+    _codes.ensure_size((size_t(docid) + 1) * code_size, 0);
+    memcpy(&_codes[size_t(docid) * code_size], codes, code_size);
+}
+
+void
+IvfPqIndex::add_to_list(uint32_t docid, uint32_t list, const uint8_t *codes)
+{
+    // The codes must be in place before the document is visible in the list.
+    set_codes(docid, codes);
+    PostingList *posting_list = _lists[list].get();
+    if ((posting_list == nullptr) || posting_list->full()) {
+        posting_list = replace_list(list);
+    }
+    posting_list->push_back(docid);
+    _doc_lists[docid] = list + 1;
+}
+
+void
+IvfPqIndex::remove_from_list(uint32_t docid, uint32_t list)
+{
+    PostingList *posting_list = _lists[list].get();
+    if ((posting_list == nullptr) || !posting_list->remove(docid)) {
+        return;
+    }
+    // Compact the list when most of it is removed, to bound the space and scan time used by removed entries.
+    if (posting_list->num_removed() * 2 > posting_list->size()) {
+        replace_list(list);
+    }
+}
+
+void
+IvfPqIndex::encode_and_add(uint32_t docid, const ProductQuantizer& quantizer)
+{
+    std::vector<float> input;
+    to_float(_vectors.get_vector(docid), input);
+    uint32_t list = quantizer.assign(input.data());
+    std::vector<uint8_t> codes(quantizer.code_size());
+    quantizer.encode(input.data(), list, codes.data());
+    add_to_list(docid, list, codes.data());
+}
+
+void
+IvfPqIndex::start_training()
+{
+    // The training sample is a copy of the vectors of the documents not yet encoded,
+    // and is only kept until the quantizer is trained.
+    std::vector<uint32_t> docids;
+    for (uint32_t docid = 1; docid < _doc_lists.size(); ++docid) {
+        if (_doc_lists[docid] == not_encoded) {
+            docids.push_back(docid);
+        }
+    }
+    std::vector<float> sample(docids.size() * _dims);
+    std::vector<float> vector;
+    for (size_t i = 0; i < docids.size(); ++i) {
+        to_float(_vectors.get_vector(docids[i]), vector);
+        std::copy(vector.begin(), vector.end(), sample.begin() + i * _dims);
+    }
+    _training = true;
+    if (!_training_executor) {
+        _training_executor = std::make_unique<vespalib::ThreadStackExecutor>(1, 128 * 1024);
+    }
+    auto task = vespalib::makeLambdaTask([this, docids = std::move(docids), sample = std::move(sample)]() mutable {
+        auto result = std::make_unique<TrainingResult>();
+        result->quantizer = std::make_shared<ProductQuantizer>(_dims, _cfg.num_centroids(), _cfg.num_subquantizers(),
+                                                               quantizer_metric(_cfg.distance_metric()));
+        result->quantizer->train(sample, _cfg.training_iterations());
+        size_t code_size = _cfg.num_subquantizers();
+        result->lists.resize(docids.size());
+        result->codes.resize(docids.size() * code_size);
+        for (size_t i = 0; i < docids.size(); ++i) {
+            const float *doc_vector = &sample[i * _dims];
+            result->lists[i] = result->quantizer->assign(doc_vector);
+            result->quantizer->encode(doc_vector, result->lists[i], &result->codes[i * code_size]);
+        }
+        LOG(debug, "Trained quantizer with %u centroids and %u sub-quantizers using %zu documents",
+            _cfg.num_centroids(), _cfg.num_subquantizers(), docids.size());
+        result->docids = std::move(docids);
+        std::lock_guard<std::mutex> guard(_training_lock);
+        _training_result = std::move(result);
+    });
+    _training_executor->execute(std::move(task));
+}
+
+void
+IvfPqIndex::install_trained_quantizer()
+{
+    std::unique_ptr<TrainingResult> result;
+    {
+        std::lock_guard<std::mutex> guard(_training_lock);
+        result = std::move(_training_result);
+    }
+    if (!result) {
+        return;
+    }
+    // Training documents that were removed while training might have been added again with a new vector.
+    std::sort(_removed_while_training.begin(), _removed_while_training.end());
+    size_t code_size = _cfg.num_subquantizers();
+    for (size_t i = 0; i < result->docids.size(); ++i) {
+        uint32_t docid = result->docids[i];
+        if ((_doc_lists[docid] == not_encoded) &&
+            !std::binary_search(_removed_while_training.begin(), _removed_while_training.end(), docid))
+        {
+            add_to_list(docid, result->lists[i], &result->codes[i * code_size]);
+        }
+    }
+    // Encode the documents added while training.
+    for (uint32_t docid = 1; docid < _doc_lists.size(); ++docid) {
+        if (_doc_lists[docid] == not_encoded) {
+            encode_and_add(docid, *result->quantizer);
+        }
+    }
+    // Readers switch from exhaustive search to probing the lists when the quantizer is published.
+    _quantizer = std::move(result->quantizer);
+    _quantizer_ptr.store(_quantizer.get(), std::memory_order_release);
+    _num_not_encoded = 0;
+    _training = false;
+    _removed_while_training.clear();
+    _removed_while_training.shrink_to_fit();
+}
+
+void
+IvfPqIndex::wait_for_training()
+{
+    if (_training_executor) {
+        _training_executor->sync();
+    }
+    install_trained_quantizer();
+}
+
+void
+IvfPqIndex::add_document(uint32_t docid)
+{
+    vespalib::GenerationHandler::Guard no_guard_needed;
+    complete_add_document(docid, prepare_add_document(docid, _vectors.get_vector(docid), std::move(no_guard_needed)));
+}
+
+std::unique_ptr<PrepareResult>
+IvfPqIndex::prepare_add_document(uint32_t docid,
+                                 TypedCells vector,
+                                 vespalib::GenerationHandler::Guard read_guard) const
+{
+    auto result = std::make_unique<PreparedAddDoc>(docid, std::move(read_guard));
+    const ProductQuantizer *quantizer = get_quantizer();
+    if (quantizer != nullptr) {
+        std::vector<float> input;
+        to_float(vector, input);
+        result->quantizer = quantizer;
+        result->list = quantizer->assign(input.data());
+        result->codes.resize(quantizer->code_size());
+        quantizer->encode(input.data(), result->list, result->codes.data());
+    }
+    return result;
+}
+
+void
+IvfPqIndex::complete_add_document(uint32_t docid, std::unique_ptr<PrepareResult> prepare_result)
+{
+    _doc_lists.ensure_size(docid + 1, 0);
+    // A document cannot be added twice.
+    assert(_doc_lists[docid] == 0);
+    const ProductQuantizer *quantizer = get_quantizer();
+    if (quantizer == nullptr) {
+        _doc_lists[docid] = not_encoded;
+        if ((++_num_not_encoded >= _cfg.min_training_docs()) && !_training) {
+            start_training();
+        }
+        return;
+    }
+    auto prepared = dynamic_cast<PreparedAddDoc *>(prepare_result.get());
+    if (prepared && (prepared->docid == docid) && (prepared->quantizer == quantizer)) {
+        add_to_list(docid, prepared->list, prepared->codes.data());
+    } else {
+        // The quantizer was installed after the prepare step.
+        encode_and_add(docid, *quantizer);
+    }
+}
+
+void
+IvfPqIndex::remove_document(uint32_t docid)
+{
+    assert(has_document(docid));
+    uint32_t value = _doc_lists[docid];
+    _doc_lists[docid] = 0;
+    if (value == not_encoded) {
+        --_num_not_encoded;
+        if (_training) {
+            _removed_while_training.push_back(docid);
+        }
+        return;
+    }
+    remove_from_list(docid, value - 1);
+}
+
+void
+IvfPqIndex::transfer_hold_lists(generation_t current_gen)
+{
+    if (_training) {
+        install_trained_quantizer();
+    }
+    // Note: RcuVector transfers hold lists as part of reallocation based on current generation.
+    //       We need to set the next generation here, as it is incremented on a higher level right after this call.
+    _doc_lists.setGeneration(current_gen + 1);
+    _codes.setGeneration(current_gen + 1);
+    _list_holder.transferHoldLists(current_gen);
+}
+
+void
+IvfPqIndex::trim_hold_lists(generation_t first_used_gen)
+{
+    _doc_lists.removeOldGenerations(first_used_gen);
+    _codes.removeOldGenerations(first_used_gen);
+    _list_holder.trimHoldLists(first_used_gen);
+}
+
+vespalib::MemoryUsage
+IvfPqIndex::memory_usage() const
+{
+    vespalib::MemoryUsage result;
+    result.merge(_doc_lists.getMemoryUsage());
+    result.merge(_codes.getMemoryUsage());
+    size_t list_bytes = _list_ptrs.size() * (sizeof(std::unique_ptr<PostingList>) + sizeof(std::atomic<const PostingList *>));
+    result.incAllocatedBytes(list_bytes);
+    result.incUsedBytes(list_bytes);
+    for (const auto& list : _lists) {
+        if (list) {
+            result.incAllocatedBytes(sizeof(PostingList) + list->capacity() * sizeof(uint32_t));
+            result.incUsedBytes(sizeof(PostingList) + list->size() * sizeof(uint32_t));
+            result.incDeadBytes(list->num_removed() * sizeof(uint32_t));
+        }
+    }
+    result.incAllocatedBytesOnHold(_list_holder.getHeldBytes());
+    if (_quantizer) {
+        size_t quantizer_bytes = (_quantizer->centroids().size() + _quantizer->codebooks().size()) * sizeof(float);
+        result.incAllocatedBytes(quantizer_bytes);
+        result.incUsedBytes(quantizer_bytes);
+    }
+    return result;
+}
+
+void
+IvfPqIndex::get_state(const vespalib::slime::Inserter& inserter) const
+{
+    auto& object = inserter.insertObject();
+    StateExplorerUtils::memory_usage_to_slime(memory_usage(), object.setObject("memory_usage"));
+    uint32_t valid_nodes = 0;
+    for (uint32_t docid = 1; docid < _doc_lists.size(); ++docid) {
+        if (_doc_lists[docid] != 0) {
+            ++valid_nodes;
+        }
+    }
+    object.setLong("nodes", _doc_lists.size());
+    object.setLong("valid_nodes", valid_nodes);
+    object.setBool("trained", is_trained());
+    object.setBool("training", _training);
+    object.setLong("not_encoded_nodes", _num_not_encoded);
+    object.setLong("num_centroids", _cfg.num_centroids());
+    object.setLong("num_subquantizers", _cfg.num_subquantizers());
+    size_t max_list_size = 0;
+    for (uint32_t list = 0; list < _cfg.num_centroids(); ++list) {
+        const PostingList *posting_list = get_posting_list(list);
+        if (posting_list != nullptr) {
+            max_list_size = std::max(max_list_size, size_t(posting_list->num_docs()));
+        }
+    }
+    object.setLong("max_list_size", max_list_size);
+}
+
+std::unique_ptr<NearestNeighborIndexSaver>
+IvfPqIndex::make_saver() const
+{
+    return std::make_unique<IvfPqIndexSaver>(*this);
+}
+
+bool
+IvfPqIndex::load(const fileutil::LoadedBuffer& buf)
+{
+    // cannot load after index has data
+    assert(_doc_lists.size() <= 1 && !is_trained());
+    BufferReader reader(buf);
+    uint32_t header[6];
+    if (!reader.read(header, sizeof(header)) ||
+        (header[0] != IvfPqIndexSaver::magic) || (header[1] != IvfPqIndexSaver::version) ||
+        (header[2] != _dims) || (header[3] != _cfg.num_centroids()) || (header[4] != _cfg.num_subquantizers()))
+    {
+        return false;
+    }
+    bool trained = (header[5] != 0);
+    std::shared_ptr<ProductQuantizer> quantizer;
+    if (trained) {
+        size_t sub_dims = _dims / _cfg.num_subquantizers();
+        std::vector<float> centroids(size_t(_cfg.num_centroids()) * _dims);
+        std::vector<float> codebooks(size_t(_cfg.num_subquantizers()) * ProductQuantizer::codebook_size * sub_dims);
+        if (!reader.read(centroids.data(), centroids.size() * sizeof(float)) ||
+            !reader.read(codebooks.data(), codebooks.size() * sizeof(float))) {
+            return false;
+        }
+        quantizer = std::make_shared<ProductQuantizer>(_dims, _cfg.num_centroids(), _cfg.num_subquantizers(),
+                                                       quantizer_metric(_cfg.distance_metric()),
+                                                       std::move(centroids), std::move(codebooks));
+    }
+    uint32_t num_not_encoded = 0;
+    if (!reader.read(num_not_encoded)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < num_not_encoded; ++i) {
+        uint32_t docid = 0;
+        if (!reader.read(docid) || docid == 0) {
+            return false;
+        }
+        _doc_lists.ensure_size(docid + 1, 0);
+        _doc_lists[docid] = not_encoded;
+        ++_num_not_encoded;
+    }
+    if (trained) {
+        size_t code_size = _cfg.num_subquantizers();
+        std::vector<uint32_t> docids;
+        std::vector<uint8_t> codes;
+        for (uint32_t list = 0; list < _cfg.num_centroids(); ++list) {
+            uint32_t num_docs = 0;
+            if (!reader.read(num_docs)) {
+                return false;
+            }
+            docids.resize(num_docs);
+            codes.resize(num_docs * code_size);
+            if (!reader.read(docids.data(), docids.size() * sizeof(uint32_t)) ||
+                !reader.read(codes.data(), codes.size())) {
+                return false;
+            }
+            for (uint32_t i = 0; i < num_docs; ++i) {
+                uint32_t docid = docids[i];
+                if (docid == 0) {
+                    return false;
+                }
+                _doc_lists.ensure_size(docid + 1, 0);
+                add_to_list(docid, list, &codes[i * code_size]);
+            }
+        }
+        _quantizer = std::move(quantizer);
+        _quantizer_ptr.store(_quantizer.get(), std::memory_order_release);
+    }
+    return reader.at_end();
+}
+
+std::vector<NearestNeighborIndex::Neighbor>
+IvfPqIndex::exact_top_k(uint32_t k, TypedCells vector, const BitVector *filter) const
+{
+    std::vector<Neighbor> result;
+    uint32_t doc_id_limit = _doc_lists.size();
+    if (filter) {
+        doc_id_limit = std::min(doc_id_limit, filter->size());
+    }
+    for (uint32_t docid = 1; docid < doc_id_limit; ++docid) {
+        if ((_doc_lists[docid] == 0) || (filter && !filter->testBit(docid))) {
+            continue;
+        }
+        result.emplace_back(docid, _distance_func->calc(vector, _vectors.get_vector(docid)));
+    }
+    return best_by_docid(k, std::move(result));
+}
+
+std::vector<NearestNeighborIndex::Neighbor>
+IvfPqIndex::top_k(uint32_t k, TypedCells vector, const BitVector *filter, uint32_t explore_k) const
+{
+    const ProductQuantizer *quantizer = get_quantizer();
+    if (quantizer == nullptr) {
+        return exact_top_k(k, vector, filter);
+    }
+    std::vector<float> query;
+    to_float(vector, query);
+    std::vector<float> centroid_distances;
+    quantizer->centroid_distances(query.data(), centroid_distances);
+    std::vector<uint32_t> probe_order(centroid_distances.size());
+    std::iota(probe_order.begin(), probe_order.end(), 0);
+    std::sort(probe_order.begin(), probe_order.end(),
+              [&](uint32_t a, uint32_t b) { return centroid_distances[a] < centroid_distances[b]; });
+
+    // Probe the closest lists until enough candidates are found, keeping the best by approximate distance.
+    uint32_t wanted = std::max(k, explore_k);
+    std::priority_queue<Candidate> candidates;
+    std::vector<float> table;
+    size_t scanned = 0;
+    for (uint32_t probe = 0; probe < probe_order.size(); ++probe) {
+        if ((probe >= _cfg.min_probes()) && (scanned >= wanted)) {
+            break;
+        }
+        uint32_t list = probe_order[probe];
+        const PostingList *docids = get_posting_list(list);
+        if ((docids == nullptr) || (docids->num_docs() == 0)) {
+            continue;
+        }
+        float bias = quantizer->make_distance_table(query.data(), list, table);
+        docids->for_each([&](uint32_t docid) {
+            if (filter && ((docid >= filter->size()) || !filter->testBit(docid))) {
+                return;
+            }
+            ++scanned;
+            float distance = quantizer->approx_distance(table.data(), get_codes(docid), bias);
+            if (candidates.size() < wanted) {
+                candidates.emplace(distance, docid);
+            } else if (distance < candidates.top().first) {
+                candidates.pop();
+                candidates.emplace(distance, docid);
+            }
+        });
+    }
+    // Re-rank the candidates using the document vectors in the attribute.
+    std::vector<Neighbor> result;
+    result.reserve(candidates.size());
+    for (; !candidates.empty(); candidates.pop()) {
+        uint32_t docid = candidates.top().second;
+        result.emplace_back(docid, _distance_func->calc(vector, _vectors.get_vector(docid)));
+    }
+    return best_by_docid(k, std::move(result));
+}
+
+std::vector<NearestNeighborIndex::Neighbor>
+IvfPqIndex::find_top_k(uint32_t k, TypedCells vector, uint32_t explore_k) const
+{
+    return top_k(k, vector, nullptr, explore_k);
+}
+
+std::vector<NearestNeighborIndex::Neighbor>
+IvfPqIndex::find_top_k_with_filter(uint32_t k, TypedCells vector,
+                                   const BitVector &filter, uint32_t explore_k) const
+{
+    return top_k(k, vector, &filter, explore_k);
+}
+
+}
@@ -0,0 +1,216 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "distance_function.h"
+#include "doc_vector_access.h"
+#include "nearest_neighbor_index.h"
+#include "product_quantizer.h"
+#include <vespa/eval/tensor/dense/typed_cells.h>
+#include <vespa/searchcommon/attribute/distance_metric.h>
+#include <vespa/vespalib/util/generationholder.h>
+#include <vespa/vespalib/util/rcuvector.h>
+#include <atomic>
+#include <limits>
+#include <mutex>
+
+namespace vespalib { class ThreadStackExecutor; }
+
+namespace search::tensor {
+
+/**
+ * Implementation of an inverted file index with product quantization (IVF-PQ)
+ * that is used for approximate K-nearest neighbor search.
+ *
+ * Each document is assigned to the closest coarse centroid, and the list of that centroid
+ * contains the document. The residual of the document vector is encoded using a ProductQuantizer,
+ * using num_subquantizers bytes per document. The index does not keep the document vectors.
+ * A search probes the lists of the closest centroids, calculates approximate distances using the codes,
+ * and re-ranks the best candidates using the distance function and the vectors in the attribute.
+ *
+ * The quantizer is trained using k-means in a background thread when min_training_docs documents are added.
+ * Until the trained quantizer is installed by the write thread the index is searched exhaustively.
+ * The approximate distances follow the distance metric: inner product tables are used for the
+ * inner product metric, and squared euclidean distance between normalized vectors for the angular metric.
+ *
+ * The implementation supports 1 write thread and multiple search threads without the use of mutexes.
+ * Lists are updated in place, and are only copied when full or when most of the list is removed.
+ * Old lists are kept until no readers can reference them using generation tracking.
+ */
+class IvfPqIndex : public NearestNeighborIndex {
+public:
+    class Config {
+    private:
+        uint32_t _num_centroids;
+        uint32_t _num_subquantizers;
+        uint32_t _min_training_docs;
+        uint32_t _training_iterations;
+        uint32_t _min_probes;
+        search::attribute::DistanceMetric _distance_metric;
+
+    public:
+        Config(uint32_t num_centroids_in,
+               uint32_t num_subquantizers_in,
+               uint32_t min_training_docs_in,
+               uint32_t training_iterations_in,
+               uint32_t min_probes_in,
+               search::attribute::DistanceMetric distance_metric_in)
+            : _num_centroids(num_centroids_in),
+              _num_subquantizers(num_subquantizers_in),
+              _min_training_docs(min_training_docs_in),
+              _training_iterations(training_iterations_in),
+              _min_probes(min_probes_in),
+              _distance_metric(distance_metric_in)
+        {}
+        uint32_t num_centroids() const { return _num_centroids; }
+        uint32_t num_subquantizers() const { return _num_subquantizers; }
+        uint32_t min_training_docs() const { return _min_training_docs; }
+        uint32_t training_iterations() const { return _training_iterations; }
+        uint32_t min_probes() const { return _min_probes; }
+        search::attribute::DistanceMetric distance_metric() const { return _distance_metric; }
+    };
+
+    /**
+     * List of the document ids assigned to a coarse centroid.
+     *
+     * The write thread appends document ids after the current size, which is then published with release semantics.
+     * A removed document id is overwritten with 0 in place, and is skipped by readers.
+     */
+    class PostingList {
+    private:
+        std::unique_ptr<std::atomic<uint32_t>[]> _docids;
+        uint32_t _capacity;
+        std::atomic<uint32_t> _size;
+        std::atomic<uint32_t> _num_removed;
+
+    public:
+        explicit PostingList(uint32_t capacity);
+        ~PostingList();
+        uint32_t capacity() const { return _capacity; }
+        uint32_t size() const { return _size.load(std::memory_order_acquire); }
+        uint32_t num_removed() const { return _num_removed.load(std::memory_order_relaxed); }
+        uint32_t num_docs() const { return size() - num_removed(); }
+        bool full() const { return size() == _capacity; }
+        void push_back(uint32_t docid);
+        bool remove(uint32_t docid);
+        template <typename Func>
+        void for_each(Func func) const {
+            uint32_t size = _size.load(std::memory_order_acquire);
+            for (uint32_t i = 0; i < size; ++i) {
+                uint32_t docid = _docids[i].load(std::memory_order_relaxed);
+                if (docid != 0) {
+                    func(docid);
+                }
+            }
+        }
+    };
+
+    // Value in the docid -> list mapping for documents added before the quantizer is trained.
+    static constexpr uint32_t not_encoded = std::numeric_limits<uint32_t>::max();
+
+private:
+    using TypedCells = vespalib::tensor::TypedCells;
+
+    // Quantizer trained in the background, with the codes of the training documents.
+    struct TrainingResult {
+        std::shared_ptr<ProductQuantizer> quantizer;
+        std::vector<uint32_t> docids;
+        std::vector<uint32_t> lists;
+        std::vector<uint8_t> codes;
+        TrainingResult();
+        ~TrainingResult();
+    };
+
+    const DocVectorAccess& _vectors;
+    DistanceFunction::UP _distance_func;
+    Config _cfg;
+    uint32_t _dims;
+    bool _normalize;
+    // Owned by the write thread, and published to readers via _quantizer_ptr when trained.
+    std::shared_ptr<const ProductQuantizer> _quantizer;
+    std::atomic<const ProductQuantizer *> _quantizer_ptr;
+    // Provides mapping from document id -> list id + 1 (0 means not present, not_encoded means not yet encoded).
+    vespalib::RcuVector<uint32_t> _doc_lists;
+    // Provides mapping from document id -> codes (num_subquantizers bytes per document).
+    vespalib::RcuVector<uint8_t> _codes;
+    // Lists owned by the write thread, and published to readers via _list_ptrs.
+    std::vector<std::unique_ptr<PostingList>> _lists;
+    std::vector<std::atomic<const PostingList *>> _list_ptrs;
+    vespalib::GenerationHolder _list_holder;
+    uint32_t _num_not_encoded;
+    // Training state used by the write thread.
+    bool _training;
+    std::vector<uint32_t> _removed_while_training;
+    std::mutex _training_lock;
+    std::unique_ptr<TrainingResult> _training_result;
+    std::unique_ptr<vespalib::ThreadStackExecutor> _training_executor;
+
+    struct PreparedAddDoc : public PrepareResult {
+        using ReadGuard = vespalib::GenerationHandler::Guard;
+        uint32_t docid;
+        const ProductQuantizer *quantizer;
+        uint32_t list;
+        std::vector<uint8_t> codes;
+        ReadGuard read_guard;
+        PreparedAddDoc(uint32_t docid_in, ReadGuard read_guard_in)
+            : docid(docid_in), quantizer(nullptr), list(0), codes(), read_guard(std::move(read_guard_in))
+        {}
+        ~PreparedAddDoc() override;
+    };
+
+    void to_float(TypedCells vector, std::vector<float>& result) const;
+    const ProductQuantizer *get_quantizer() const { return _quantizer_ptr.load(std::memory_order_acquire); }
+    const PostingList *get_posting_list(uint32_t list) const { return _list_ptrs[list].load(std::memory_order_acquire); }
+    PostingList *replace_list(uint32_t list);
+    void set_codes(uint32_t docid, const uint8_t *codes);
+    void add_to_list(uint32_t docid, uint32_t list, const uint8_t *codes);
+    void remove_from_list(uint32_t docid, uint32_t list);
+    void encode_and_add(uint32_t docid, const ProductQuantizer& quantizer);
+    void start_training();
+    void install_trained_quantizer();
+    std::vector<Neighbor> exact_top_k(uint32_t k, TypedCells vector, const BitVector *filter) const;
+    std::vector<Neighbor> top_k(uint32_t k, TypedCells vector, const BitVector *filter, uint32_t explore_k) const;
+
+public:
+    IvfPqIndex(const DocVectorAccess& vectors, size_t vector_size, DistanceFunction::UP distance_func, const Config& cfg);
+    ~IvfPqIndex() override;
+
+    const Config& config() const { return _cfg; }
+    uint32_t dims() const { return _dims; }
+    bool is_trained() const { return get_quantizer() != nullptr; }
+    std::shared_ptr<const ProductQuantizer> quantizer() const { return _quantizer; }
+    uint32_t doc_id_limit() const { return _doc_lists.size(); }
+    bool has_document(uint32_t docid) const { return (docid < _doc_lists.size()) && (_doc_lists[docid] != 0); }
+    bool is_encoded(uint32_t docid) const { return has_document(docid) && (_doc_lists[docid] != not_encoded); }
+    // Returns a copy of the document ids in the given list.
+    std::vector<uint32_t> get_list(uint32_t list) const;
+    const uint8_t *get_codes(uint32_t docid) const { return &_codes[size_t(docid) * _cfg.num_subquantizers()]; }
+
+    /**
+     * Waits for pending training of the quantizer, and installs the trained quantizer.
+     * This is otherwise done by the write thread in transfer_hold_lists() when training is done.
+     */
+    void wait_for_training();
+
+    // Implements NearestNeighborIndex
+    void add_document(uint32_t docid) override;
+    std::unique_ptr<PrepareResult> prepare_add_document(uint32_t docid,
+            TypedCells vector,
+            vespalib::GenerationHandler::Guard read_guard) const override;
+    void complete_add_document(uint32_t docid, std::unique_ptr<PrepareResult> prepare_result) override;
+    void remove_document(uint32_t docid) override;
+    void transfer_hold_lists(generation_t current_gen) override;
+    void trim_hold_lists(generation_t first_used_gen) override;
+    vespalib::MemoryUsage memory_usage() const override;
+    void get_state(const vespalib::slime::Inserter& inserter) const override;
+
+    std::unique_ptr<NearestNeighborIndexSaver> make_saver() const override;
+    bool load(const fileutil::LoadedBuffer& buf) override;
+
+    std::vector<Neighbor> find_top_k(uint32_t k, TypedCells vector, uint32_t explore_k) const override;
+    std::vector<Neighbor> find_top_k_with_filter(uint32_t k, TypedCells vector,
+                                                 const BitVector &filter, uint32_t explore_k) const override;
+    const DistanceFunction *distance_function() const override { return _distance_func.get(); }
+};
+
+}
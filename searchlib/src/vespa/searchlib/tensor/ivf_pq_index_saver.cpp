@@ -0,0 +1,70 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "ivf_pq_index_saver.h"
+#include "ivf_pq_index.h"
+#include <vespa/searchlib/util/bufferwriter.h>
+
+namespace search::tensor {
+
+IvfPqIndexSaver::List::List() : docids(), codes() {}
+IvfPqIndexSaver::List::~List() = default;
+
+IvfPqIndexSaver::IvfPqIndexSaver(const IvfPqIndex &index)
+    : _dims(index.dims()),
+      _num_centroids(index.config().num_centroids()),
+      _num_subquantizers(index.config().num_subquantizers()),
+      _quantizer(index.quantizer()),
+      _not_encoded(),
+      _lists()
+{
+    uint32_t doc_id_limit = index.doc_id_limit();
+    for (uint32_t docid = 1; docid < doc_id_limit; ++docid) {
+        if (index.has_document(docid) && !index.is_encoded(docid)) {
+            _not_encoded.push_back(docid);
+        }
+    }
+    if (_quantizer) {
+        _lists.resize(_num_centroids);
+        for (uint32_t list = 0; list < _num_centroids; ++list) {
+            auto docids = index.get_list(list);
+            auto &dst = _lists[list];
+            dst.docids.assign(docids.begin(), docids.end());
+            dst.codes.reserve(docids.size() * _num_subquantizers);
+            for (uint32_t docid : docids) {
+                const uint8_t *codes = index.get_codes(docid);
+                dst.codes.insert(dst.codes.end(), codes, codes + _num_subquantizers);
+            }
+        }
+    }
+}
+
+IvfPqIndexSaver::~IvfPqIndexSaver() = default;
+
+void
+IvfPqIndexSaver::save(BufferWriter& writer) const
+{
+    uint32_t header[6] = { magic, version, _dims, _num_centroids, _num_subquantizers, (_quantizer ? 1u : 0u) };
+    writer.write(header, sizeof(header));
+    if (_quantizer) {
+        const auto &centroids = _quantizer->centroids();
+        const auto &codebooks = _quantizer->codebooks();
+        writer.write(centroids.data(), centroids.size() * sizeof(float));
+        writer.write(codebooks.data(), codebooks.size() * sizeof(float));
+    }
+    uint32_t num_not_encoded = _not_encoded.size();
+    writer.write(&num_not_encoded, sizeof(uint32_t));
+    if (!_not_encoded.empty()) {
+        writer.write(_not_encoded.data(), _not_encoded.size() * sizeof(uint32_t));
+    }
+    for (const auto &list : _lists) {
+        uint32_t num_docs = list.docids.size();
+        writer.write(&num_docs, sizeof(uint32_t));
+        if (num_docs > 0) {
+            writer.write(list.docids.data(), list.docids.size() * sizeof(uint32_t));
+            writer.write(list.codes.data(), list.codes.size());
+        }
+    }
+    writer.flush();
+}
+
+}
@@ -0,0 +1,53 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "nearest_neighbor_index_saver.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace search::tensor {
+
+class IvfPqIndex;
+class ProductQuantizer;
+
+/**
+ * Implements saving of an ivf-pq index in binary format.
+ * The constructor takes a snapshot of the quantizer, lists and codes.
+ *
+ * Layout (native endian):
+ *   uint32_t magic, version, dims, num_centroids, num_subquantizers, trained
+ *   if trained:
+ *     float centroids[num_centroids * dims]
+ *     float codebooks[num_subquantizers * 256 * dims / num_subquantizers]
+ *   uint32_t num_not_encoded, docids[num_not_encoded]
+ *   if trained, for each list:
+ *     uint32_t num_docs, docids[num_docs]
+ *     uint8_t codes[num_docs * num_subquantizers]
+ **/
+class IvfPqIndexSaver : public NearestNeighborIndexSaver {
+public:
+    static constexpr uint32_t magic = 0x71707669; // "ivpq"
+    static constexpr uint32_t version = 1;
+
+    IvfPqIndexSaver(const IvfPqIndex &index);
+    ~IvfPqIndexSaver() override;
+    void save(BufferWriter& writer) const override;
+
+private:
+    struct List {
+        std::vector<uint32_t> docids;
+        std::vector<uint8_t> codes;
+        List();
+        ~List();
+    };
+    uint32_t _dims;
+    uint32_t _num_centroids;
+    uint32_t _num_subquantizers;
+    std::shared_ptr<const ProductQuantizer> _quantizer;
+    std::vector<uint32_t> _not_encoded;
+    std::vector<List> _lists;
+};
+
+}
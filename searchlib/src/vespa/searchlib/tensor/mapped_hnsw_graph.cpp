@@ -0,0 +1,105 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "mapped_hnsw_graph.h"
+#include <vespa/searchlib/util/fileutil.h>
+
+namespace search::tensor {
+
+MappedHnswGraph::MappedHnswGraph()
+    : _owned_buffer(),
+      _node_offsets(nullptr),
+      _node_data(nullptr),
+      _node_data_size(0),
+      _num_nodes(0),
+      _entry_docid(0),
+      _entry_level(-1)
+{
+}
+
+MappedHnswGraph::~MappedHnswGraph() = default;
+
+bool
+MappedHnswGraph::init(const void *buf, size_t size)
+{
+    const uint32_t *words = static_cast<const uint32_t *>(buf);
+    size_t num_words = size / sizeof(uint32_t);
+    if (num_words < header_words || words[0] != magic || words[1] != version) {
+        return false;
+    }
+    _entry_docid = words[2];
+    _entry_level = static_cast<int32_t>(words[3]);
+    _num_nodes = words[4];
+    size_t offsets_words = (size_t(_num_nodes) + 1) * (sizeof(uint64_t) / sizeof(uint32_t));
+    if (num_words < header_words + offsets_words) {
+        return false;
+    }
+    _node_offsets = reinterpret_cast<const char *>(words + header_words);
+    _node_data = words + header_words + offsets_words;
+    _node_data_size = num_words - header_words - offsets_words;
+    if (node_offset(0) != 0 || node_offset(_num_nodes) != _node_data_size) {
+        return false;
+    }
+    return (_entry_level < 0) || (get_num_levels(_entry_docid) > uint32_t(_entry_level));
+}
+
+bool
+MappedHnswGraph::is_mappable_format(const fileutil::LoadedBuffer& buf)
+{
+    return (buf.size() >= sizeof(uint32_t)) && (static_cast<const uint32_t *>(buf.buffer())[0] == magic);
+}
+
+std::unique_ptr<MappedHnswGraph>
+MappedHnswGraph::make_view(const fileutil::LoadedBuffer& buf)
+{
+    auto result = std::make_unique<MappedHnswGraph>();
+    if (!result->init(buf.buffer(), buf.size())) {
+        return std::unique_ptr<MappedHnswGraph>();
+    }
+    return result;
+}
+
+std::unique_ptr<MappedHnswGraph>
+MappedHnswGraph::make(std::unique_ptr<fileutil::LoadedBuffer> buf)
+{
+    auto result = make_view(*buf);
+    if (result) {
+        result->_owned_buffer = std::move(buf);
+    }
+    return result;
+}
+
+MappedHnswGraph::LinkArrayRef
+MappedHnswGraph::get_link_array(uint32_t docid, uint32_t level) const
+{
+    if (docid >= _num_nodes) {
+        return LinkArrayRef();
+    }
+    uint64_t pos = node_offset(docid);
+    uint64_t end = node_offset(docid + 1);
+    if (pos >= end || end > _node_data_size) {
+        return LinkArrayRef();
+    }
+    uint32_t num_levels = _node_data[pos++];
+    if (level >= num_levels) {
+        return LinkArrayRef();
+    }
+    for (uint32_t i = 0; pos < end; ++i) {
+        uint32_t num_links = _node_data[pos++];
+        if (pos + num_links > end) {
+            break;
+        }
+        if (i == level) {
+            return LinkArrayRef(_node_data + pos, num_links);
+        }
+        pos += num_links;
+    }
+    return LinkArrayRef();
+}
+
+size_t
+MappedHnswGraph::mapped_bytes() const
+{
+    return (header_words + (size_t(_num_nodes) + 1) * 2 + _node_data_size) * sizeof(uint32_t);
+}
+
+}
@@ -0,0 +1,91 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/util/arrayref.h>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace search::fileutil { class LoadedBuffer; }
+
+namespace search::tensor {
+
+/**
+ * Read-only view of an HNSW graph saved in the mappable binary format,
+ * used to serve the graph directly from a memory mapped save file.
+ *
+ * Layout (native endian):
+ *   uint32_t magic, version, entry_docid
+ *   int32_t  entry_level
+ *   uint32_t num_nodes, padding
+ *   uint64_t node_offsets[num_nodes + 1] (in uint32_t units, relative to start of node data)
+ *   uint32_t node_data[]: for each node: num_levels, then for each level: num_links, links
+ *
+ * The magic value is an invalid entry docid, which distinguishes this format
+ * from the old streamed format where the first value is the entry docid.
+ **/
+class MappedHnswGraph {
+public:
+    using LinkArrayRef = vespalib::ConstArrayRef<uint32_t>;
+    static constexpr uint32_t magic = 0xffffffffu;
+    static constexpr uint32_t version = 1;
+    static constexpr size_t header_words = 6;
+
+private:
+    std::unique_ptr<fileutil::LoadedBuffer> _owned_buffer;
+    const char     *_node_offsets;
+    const uint32_t *_node_data;
+    uint64_t        _node_data_size;
+    uint32_t        _num_nodes;
+    uint32_t        _entry_docid;
+    int32_t         _entry_level;
+
+    uint64_t node_offset(uint32_t docid) const {
+        uint64_t result;
+        memcpy(&result, _node_offsets + docid * sizeof(uint64_t), sizeof(result));
+        return result;
+    }
+    bool init(const void *buf, size_t size);
+
+public:
+    MappedHnswGraph();
+    ~MappedHnswGraph();
+
+    static bool is_mappable_format(const fileutil::LoadedBuffer& buf);
+
+    /**
+     * Creates a view of the given buffer without taking ownership of it.
+     * Returns nullptr if the buffer does not contain a graph in the mappable format.
+     */
+    static std::unique_ptr<MappedHnswGraph> make_view(const fileutil::LoadedBuffer& buf);
+
+    /**
+     * Creates a graph that owns (and keeps mapped) the given buffer.
+     * Returns nullptr if the buffer does not contain a graph in the mappable format.
+     */
+    static std::unique_ptr<MappedHnswGraph> make(std::unique_ptr<fileutil::LoadedBuffer> buf);
+
+    uint32_t num_nodes() const { return _num_nodes; }
+    uint32_t entry_docid() const { return _entry_docid; }
+    int32_t entry_level() const { return _entry_level; }
+
+    uint32_t get_num_levels(uint32_t docid) const {
+        if (docid >= _num_nodes) {
+            return 0;
+        }
+        uint64_t begin = node_offset(docid);
+        uint64_t end = node_offset(docid + 1);
+        return ((begin < end) && (end <= _node_data_size)) ? _node_data[begin] : 0;
+    }
+
+    LinkArrayRef get_link_array(uint32_t docid, uint32_t level) const;
+
+    /**
+     * Returns the number of bytes of the mapped file that are needed to
+     * serve the graph; these are paged in on demand and not counted as heap memory.
+     */
+    size_t mapped_bytes() const;
+};
+
+}
@@ -1,3 +1,30 @@
 // Copyright 2020 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "nearest_neighbor_index.h"
+#include <vespa/searchlib/util/fileutil.h>
+
+namespace search::tensor {
+
+bool
+NearestNeighborIndex::load_mapped(std::unique_ptr<fileutil::LoadedBuffer> buf)
+{
+    return load(*buf);
+}
+
+std::vector<std::vector<NearestNeighborIndex::Neighbor>>
+NearestNeighborIndex::find_top_k_batch(uint32_t k, vespalib::ConstArrayRef<vespalib::tensor::TypedCells> vectors,
+                                       const BitVector *filter, uint32_t explore_k) const
+{
+    std::vector<std::vector<Neighbor>> result;
+    result.reserve(vectors.size());
+    for (const auto &vector : vectors) {
+        if (filter) {
+            result.push_back(find_top_k_with_filter(k, vector, *filter, explore_k));
+        } else {
+            result.push_back(find_top_k(k, vector, explore_k));
+        }
+    }
+    return result;
+}
+
+}
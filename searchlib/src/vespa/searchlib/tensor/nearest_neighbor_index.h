@@ -5,6 +5,7 @@
 #include "distance_function.h"
 #include "prepare_result.h"
 #include <vespa/eval/tensor/dense/typed_cells.h>
+#include <vespa/vespalib/util/arrayref.h>
 #include <vespa/vespalib/util/generationhandler.h>
 #include <vespa/vespalib/util/memoryusage.h>
 #include <cstdint>
@@ -72,6 +73,14 @@ public:
     virtual std::unique_ptr<NearestNeighborIndexSaver> make_saver() const = 0;
     virtual bool load(const fileutil::LoadedBuffer& buf) = 0;
 
+    /**
+     * Loads the index from the given (memory mapped) buffer, taking ownership of it.
+     *
+     * An implementation can serve the index directly from the buffer instead of
+     * building it in memory. The default implementation calls load().
+     */
+    virtual bool load_mapped(std::unique_ptr<fileutil::LoadedBuffer> buf);
+
     virtual std::vector<Neighbor> find_top_k(uint32_t k,
                                              vespalib::tensor::TypedCells vector,
                                              uint32_t explore_k) const = 0;
@@ -82,6 +91,20 @@ public:
                                                          const BitVector &filter,
                                                          uint32_t explore_k) const = 0;
 
+    /**
+     * Finds the top k neighbors for each of the given query vectors,
+     * where element i in the result contains the neighbors of query vector i.
+     * If a filter is given, only neighbors where the corresponding filter bit is set are returned.
+     *
+     * An implementation can share work between the query vectors, e.g. by calculating
+     * distances for several query vectors each time a document vector is fetched.
+     * The default implementation searches for each query vector separately.
+     */
+    virtual std::vector<std::vector<Neighbor>> find_top_k_batch(uint32_t k,
+                                                                vespalib::ConstArrayRef<vespalib::tensor::TypedCells> vectors,
+                                                                const BitVector *filter,
+                                                                uint32_t explore_k) const;
+
     virtual const DistanceFunction *distance_function() const = 0;
 };
 
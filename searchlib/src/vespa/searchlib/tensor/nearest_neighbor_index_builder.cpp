@@ -0,0 +1,78 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "nearest_neighbor_index_builder.h"
+#include "doc_vector_access.h"
+#include "nearest_neighbor_index.h"
+#include "prepare_result.h"
+#include <vespa/vespalib/util/lambdatask.h>
+#include <algorithm>
+#include <cassert>
+
+namespace search::tensor {
+
+NearestNeighborIndexBuilder::NearestNeighborIndexBuilder(NearestNeighborIndex& index, const DocVectorAccess& vectors,
+                                                         vespalib::GenerationHandler& generation_handler,
+                                                         vespalib::Executor& executor,
+                                                         uint32_t max_pending, uint32_t min_sequential_adds)
+    : _index(index),
+      _vectors(vectors),
+      _generation_handler(generation_handler),
+      _executor(executor),
+      _max_pending(std::max(max_pending, 1u)),
+      _min_sequential_adds(min_sequential_adds),
+      _added(0),
+      _pending()
+{
+}
+
+NearestNeighborIndexBuilder::~NearestNeighborIndexBuilder()
+{
+    // Outstanding prepare tasks reference this object, and must finish before it goes away.
+    drain();
+}
+
+void
+NearestNeighborIndexBuilder::complete_oldest()
+{
+    assert(!_pending.empty());
+    Pending& oldest = _pending.front();
+    auto prepare_result = oldest.result.get();
+    _index.complete_add_document(oldest.docid, std::move(prepare_result));
+    _pending.pop_front();
+}
+
+void
+NearestNeighborIndexBuilder::add(uint32_t docid)
+{
+    if (_added < _min_sequential_adds) {
+        assert(_pending.empty());
+        _index.add_document(docid);
+        ++_added;
+        return;
+    }
+    while (_pending.size() >= _max_pending) {
+        complete_oldest();
+    }
+    auto promise = std::make_shared<std::promise<PrepareResultUP>>();
+    _pending.emplace_back(docid, promise->get_future());
+    auto task = vespalib::makeLambdaTask([this, docid, promise, guard = _generation_handler.takeGuard()]() mutable
+                                         {
+                                             auto vector = _vectors.get_vector(docid);
+                                             promise->set_value(_index.prepare_add_document(docid, vector, std::move(guard)));
+                                         });
+    auto rejected = _executor.execute(std::move(task));
+    if (rejected) {
+        rejected->run();
+    }
+    ++_added;
+}
+
+void
+NearestNeighborIndexBuilder::drain()
+{
+    while (!_pending.empty()) {
+        complete_oldest();
+    }
+}
+
+}
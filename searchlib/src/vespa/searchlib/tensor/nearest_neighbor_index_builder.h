@@ -0,0 +1,73 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/util/generationhandler.h>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+
+namespace vespalib { class Executor; }
+
+namespace search::tensor {
+
+class DocVectorAccess;
+class NearestNeighborIndex;
+class PrepareResult;
+
+/**
+ * Class used to (re)build a nearest neighbor index for documents whose vectors
+ * are already available via the given DocVectorAccess, e.g. when loading a
+ * dense tensor attribute without a saved index.
+ *
+ * The costly prepare step of the two-phase add is fanned out over the given executor,
+ * while the complete step is performed by the thread calling add() and drain(),
+ * which must be the (only) writer of the index. Documents are completed in the order
+ * they are added, and at most 'max_pending' prepare steps are outstanding at any time.
+ *
+ * The first 'min_sequential_adds' documents are added using the single-threaded add path,
+ * to ensure that prepare steps in the parallel phase are run against a reasonably sized graph.
+ */
+class NearestNeighborIndexBuilder {
+private:
+    using PrepareResultUP = std::unique_ptr<PrepareResult>;
+    struct Pending {
+        uint32_t docid;
+        std::future<PrepareResultUP> result;
+        Pending(uint32_t docid_in, std::future<PrepareResultUP> result_in)
+            : docid(docid_in), result(std::move(result_in))
+        {}
+    };
+
+    NearestNeighborIndex& _index;
+    const DocVectorAccess& _vectors;
+    vespalib::GenerationHandler& _generation_handler;
+    vespalib::Executor& _executor;
+    uint32_t _max_pending;
+    uint32_t _min_sequential_adds;
+    uint32_t _added;
+    std::deque<Pending> _pending;
+
+    void complete_oldest();
+
+public:
+    NearestNeighborIndexBuilder(NearestNeighborIndex& index, const DocVectorAccess& vectors,
+                                vespalib::GenerationHandler& generation_handler, vespalib::Executor& executor,
+                                uint32_t max_pending, uint32_t min_sequential_adds);
+    ~NearestNeighborIndexBuilder();
+
+    /**
+     * Adds the given document to the index. Might complete previously added documents.
+     */
+    void add(uint32_t docid);
+
+    /**
+     * Completes all outstanding documents.
+     */
+    void drain();
+
+    uint32_t pending() const { return _pending.size(); }
+};
+
+}
@@ -5,7 +5,10 @@
 #include <vespa/eval/eval/value_type.h>
 #include <memory>
 
-namespace search::attribute { class HnswIndexParams; }
+namespace search::attribute {
+class HnswIndexParams;
+class IvfPqIndexParams;
+}
 
 namespace search::tensor {
 
@@ -22,6 +25,10 @@ public:
                                                        size_t vector_size,
                                                        vespalib::eval::ValueType::CellType cell_type,
                                                        const search::attribute::HnswIndexParams& params) const = 0;
+    virtual std::unique_ptr<NearestNeighborIndex> make(const DocVectorAccess& vectors,
+                                                       size_t vector_size,
+                                                       vespalib::eval::ValueType::CellType cell_type,
+                                                       const search::attribute::IvfPqIndexParams& params) const = 0;
 };
 
 }
@@ -0,0 +1,199 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "product_quantizer.h"
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+namespace search::tensor {
+
+using vespalib::hwaccelrated::IAccelrated;
+
+namespace {
+
+uint32_t
+find_closest(const float *vector, const float *centroids, uint32_t k, uint32_t dims, const IAccelrated &computer)
+{
+    uint32_t best = 0;
+    double best_dist = std::numeric_limits<double>::max();
+    for (uint32_t c = 0; c < k; ++c) {
+        double dist = computer.squaredEuclideanDistance(vector, centroids + size_t(c) * dims, dims);
+        if (dist < best_dist) {
+            best_dist = dist;
+            best = c;
+        }
+    }
+    return best;
+}
+
+/**
+ * Lloyd's k-means on n vectors (stored one after another).
+ * Centroids are initialized deterministically using vectors evenly spread in the data,
+ * and a centroid that loses all its vectors keeps its previous position.
+ */
+std::vector<float>
+kmeans(const float *data, size_t n, uint32_t dims, uint32_t k, uint32_t iterations, const IAccelrated &computer)
+{
+    assert(n > 0);
+    std::vector<float> centroids(size_t(k) * dims);
+    for (uint32_t c = 0; c < k; ++c) {
+        size_t src = size_t(c) * n / k;
+        memcpy(&centroids[size_t(c) * dims], data + src * dims, dims * sizeof(float));
+    }
+    std::vector<double> sums(size_t(k) * dims);
+    std::vector<uint32_t> counts(k);
+    for (uint32_t iter = 0; iter < iterations; ++iter) {
+        std::fill(sums.begin(), sums.end(), 0.0);
+        std::fill(counts.begin(), counts.end(), 0u);
+        for (size_t i = 0; i < n; ++i) {
+            const float *vector = data + i * dims;
+            uint32_t c = find_closest(vector, centroids.data(), k, dims, computer);
+            double *sum = &sums[size_t(c) * dims];
+            for (uint32_t d = 0; d < dims; ++d) {
+                sum[d] += vector[d];
+            }
+            ++counts[c];
+        }
+        for (uint32_t c = 0; c < k; ++c) {
+            if (counts[c] > 0) {
+                for (uint32_t d = 0; d < dims; ++d) {
+                    centroids[size_t(c) * dims + d] = sums[size_t(c) * dims + d] / counts[c];
+                }
+            }
+        }
+    }
+    return centroids;
+}
+
+}
+
+ProductQuantizer::ProductQuantizer(uint32_t dims, uint32_t num_centroids, uint32_t num_subquantizers, Metric metric)
+    : ProductQuantizer(dims, num_centroids, num_subquantizers, metric,
+                       std::vector<float>(size_t(num_centroids) * dims),
+                       std::vector<float>(size_t(num_subquantizers) * codebook_size * (dims / num_subquantizers)))
+{
+}
+
+ProductQuantizer::ProductQuantizer(uint32_t dims, uint32_t num_centroids, uint32_t num_subquantizers, Metric metric,
+                                   std::vector<float> centroids, std::vector<float> codebooks)
+    : _dims(dims),
+      _num_centroids(num_centroids),
+      _num_subquantizers(num_subquantizers),
+      _sub_dims(dims / num_subquantizers),
+      _metric(metric),
+      _centroids(std::move(centroids)),
+      _codebooks(std::move(codebooks)),
+      _computer(IAccelrated::getAccelerator())
+{
+    assert(_num_centroids > 0);
+    assert(_num_subquantizers > 0);
+    assert((_dims % _num_subquantizers) == 0);
+    assert(_centroids.size() == size_t(_num_centroids) * _dims);
+    assert(_codebooks.size() == size_t(_num_subquantizers) * codebook_size * _sub_dims);
+}
+
+ProductQuantizer::~ProductQuantizer() = default;
+
+void
+ProductQuantizer::train(vespalib::ConstArrayRef<float> sample, uint32_t iterations)
+{
+    size_t n = sample.size() / _dims;
+    _centroids = kmeans(sample.cbegin(), n, _dims, _num_centroids, iterations, _computer);
+    std::vector<float> residuals(n * _dims);
+    for (size_t i = 0; i < n; ++i) {
+        const float *vector = sample.cbegin() + i * _dims;
+        const float *c = centroid(assign(vector));
+        for (uint32_t d = 0; d < _dims; ++d) {
+            residuals[i * _dims + d] = vector[d] - c[d];
+        }
+    }
+    std::vector<float> sub_vectors(n * _sub_dims);
+    for (uint32_t sub = 0; sub < _num_subquantizers; ++sub) {
+        for (size_t i = 0; i < n; ++i) {
+            memcpy(&sub_vectors[i * _sub_dims], &residuals[i * _dims + sub * _sub_dims], _sub_dims * sizeof(float));
+        }
+        auto codebook = kmeans(sub_vectors.data(), n, _sub_dims, codebook_size, iterations, _computer);
+        std::copy(codebook.begin(), codebook.end(), _codebooks.begin() + size_t(sub) * codebook_size * _sub_dims);
+    }
+}
+
+uint32_t
+ProductQuantizer::assign(const float *vector) const
+{
+    return find_closest(vector, _centroids.data(), _num_centroids, _dims, _computer);
+}
+
+void
+ProductQuantizer::encode(const float *vector, uint32_t centroid_id, uint8_t *codes) const
+{
+    const float *c = centroid(centroid_id);
+    std::vector<float> residual(_dims);
+    for (uint32_t d = 0; d < _dims; ++d) {
+        residual[d] = vector[d] - c[d];
+    }
+    for (uint32_t sub = 0; sub < _num_subquantizers; ++sub) {
+        codes[sub] = find_closest(&residual[sub * _sub_dims], codebook_entry(sub, 0), codebook_size, _sub_dims, _computer);
+    }
+}
+
+void
+ProductQuantizer::centroid_distances(const float *query, std::vector<float>& distances) const
+{
+    distances.resize(_num_centroids);
+    for (uint32_t c = 0; c < _num_centroids; ++c) {
+        if (_metric == Metric::InnerProduct) {
+            distances[c] = -_computer.dotProduct(query, centroid(c), _dims);
+        } else {
+            distances[c] = _computer.squaredEuclideanDistance(query, centroid(c), _dims);
+        }
+    }
+}
+
+float
+ProductQuantizer::make_distance_table(const float *query, uint32_t centroid_id, std::vector<float>& table) const
+{
+    const float *c = centroid(centroid_id);
+    table.resize(size_t(_num_subquantizers) * codebook_size);
+    // the distances to all entries in a codebook are calculated in one batch
+    const float *entries[codebook_size];
+    if (_metric == Metric::InnerProduct) {
+        // -dot(query, centroid + residual) = -dot(query, centroid) - sum over sub-spaces of dot(query_sub, residual_sub)
+        float dot_products[codebook_size];
+        for (uint32_t sub = 0; sub < _num_subquantizers; ++sub) {
+            const float *query_sub = query + sub * _sub_dims;
+            codebook_entries(sub, entries);
+            _computer.dotProductBatch(query_sub, entries, codebook_size, _sub_dims, dot_products);
+            for (uint32_t code = 0; code < codebook_size; ++code) {
+                table[sub * codebook_size + code] = -dot_products[code];
+            }
+        }
+        return -_computer.dotProduct(query, c, _dims);
+    }
+    std::vector<float> residual(_dims);
+    for (uint32_t d = 0; d < _dims; ++d) {
+        residual[d] = query[d] - c[d];
+    }
+    double distances[codebook_size];
+    for (uint32_t sub = 0; sub < _num_subquantizers; ++sub) {
+        const float *query_sub = &residual[sub * _sub_dims];
+        codebook_entries(sub, entries);
+        _computer.squaredEuclideanDistanceBatch(query_sub, entries, codebook_size, _sub_dims, distances);
+        std::copy(distances, distances + codebook_size, table.begin() + sub * codebook_size);
+    }
+    return 0.0;
+}
+
+uint32_t
+ProductQuantizer::adjust_num_subquantizers(uint32_t dims, uint32_t wanted)
+{
+    for (uint32_t result = std::min(wanted, dims); result > 1; --result) {
+        if ((dims % result) == 0) {
+            return result;
+        }
+    }
+    return 1;
+}
+
+}
@@ -0,0 +1,106 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/util/arrayref.h>
+#include <cstdint>
+#include <vector>
+
+namespace vespalib::hwaccelrated { class IAccelrated; }
+
+namespace search::tensor {
+
+/**
+ * Trained quantizer used by an ivf-pq index.
+ *
+ * A vector is first assigned to the closest coarse centroid. The residual
+ * (vector - centroid) is then split into num_subquantizers sub-vectors, where each
+ * sub-vector is encoded as the index (one byte) of the closest entry in the codebook
+ * of that sub-space. The approximate distance between a query and an encoded vector is
+ * calculated using a distance table per (query, coarse centroid), holding the distance
+ * contribution of all codebook entries in each sub-space.
+ *
+ * With the squared euclidean metric the table holds the distance from the query residual
+ * to each codebook entry. With the inner product metric the table holds the negated dot
+ * product between the query and each codebook entry, and the negated dot product between
+ * the query and the coarse centroid is added as a bias.
+ *
+ * All vectors are float vectors with dims cells, and instances are immutable after training.
+ */
+class ProductQuantizer {
+public:
+    static constexpr uint32_t codebook_size = 256;
+
+    enum class Metric { SquaredEuclidean, InnerProduct };
+
+private:
+    uint32_t _dims;
+    uint32_t _num_centroids;
+    uint32_t _num_subquantizers;
+    uint32_t _sub_dims;
+    Metric _metric;
+    // num_centroids x dims
+    std::vector<float> _centroids;
+    // num_subquantizers x codebook_size x sub_dims
+    std::vector<float> _codebooks;
+    const vespalib::hwaccelrated::IAccelrated & _computer;
+
+    const float *centroid(uint32_t id) const { return &_centroids[size_t(id) * _dims]; }
+    const float *codebook_entry(uint32_t sub, uint32_t code) const {
+        return &_codebooks[(size_t(sub) * codebook_size + code) * _sub_dims];
+    }
+    void codebook_entries(uint32_t sub, const float **entries) const {
+        for (uint32_t code = 0; code < codebook_size; ++code) {
+            entries[code] = codebook_entry(sub, code);
+        }
+    }
+
+public:
+    ProductQuantizer(uint32_t dims, uint32_t num_centroids, uint32_t num_subquantizers, Metric metric);
+    ProductQuantizer(uint32_t dims, uint32_t num_centroids, uint32_t num_subquantizers, Metric metric,
+                     std::vector<float> centroids, std::vector<float> codebooks);
+    ~ProductQuantizer();
+
+    /**
+     * Trains the coarse centroids and the codebooks using k-means on the given
+     * sample of vectors (stored one after another).
+     */
+    void train(vespalib::ConstArrayRef<float> sample, uint32_t iterations);
+
+    uint32_t dims() const { return _dims; }
+    uint32_t num_centroids() const { return _num_centroids; }
+    uint32_t num_subquantizers() const { return _num_subquantizers; }
+    uint32_t code_size() const { return _num_subquantizers; }
+    Metric metric() const { return _metric; }
+    const std::vector<float>& centroids() const { return _centroids; }
+    const std::vector<float>& codebooks() const { return _codebooks; }
+
+    // Returns the id of the coarse centroid closest to the given vector.
+    uint32_t assign(const float *vector) const;
+
+    // Encodes the residual of the given vector relative to the given coarse centroid.
+    void encode(const float *vector, uint32_t centroid_id, uint8_t *codes) const;
+
+    // Calculates the distance (using the metric) from the query to all coarse centroids.
+    void centroid_distances(const float *query, std::vector<float>& distances) const;
+
+    /**
+     * Calculates the distance table (num_subquantizers x codebook_size) used to
+     * calculate approximate distances from the query to vectors encoded relative to the given coarse centroid.
+     * Returns the bias to pass to approx_distance.
+     */
+    float make_distance_table(const float *query, uint32_t centroid_id, std::vector<float>& table) const;
+
+    float approx_distance(const float *table, const uint8_t *codes, float bias = 0.0) const {
+        float result = bias;
+        for (uint32_t sub = 0; sub < _num_subquantizers; ++sub) {
+            result += table[sub * codebook_size + codes[sub]];
+        }
+        return result;
+    }
+
+    // Returns the largest number of sub-quantizers <= wanted that divides dims.
+    static uint32_t adjust_num_subquantizers(uint32_t dims, uint32_t wanted);
+};
+
+}
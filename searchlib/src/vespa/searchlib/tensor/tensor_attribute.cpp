@@ -68,7 +68,7 @@ TensorAttribute::TensorAttribute(vespalib::stringref name, const Config &cfg, Te
                  cfg.getGrowStrategy().getDocsGrowDelta(),
                  getGenerationHolder()),
       _tensorStore(tensorStore),
-      _emptyTensor(createEmptyTensor(cfg.tensorType())),
+      _emptyTensor(createEmptyTensor(cfg.tensorType().decay_cell_type())),
       _compactGeneration(0)
 {
 }
@@ -157,7 +157,12 @@ TensorAttribute::checkTensorType(const Tensor &tensor)
 {
     const ValueType &fieldTensorType = getConfig().tensorType();
     const ValueType &tensorType = tensor.type();
-    if (!TensorDataType::isAssignableType(fieldTensorType, tensorType)) {
+    if (fieldTensorType.has_storage_cell_type()) {
+        // cells are converted to the storage cell type when stored
+        if (!tensorType.is_dense() || (fieldTensorType.dimensions() != tensorType.dimensions())) {
+            throw WrongTensorTypeException(makeWrongTensorTypeMsg(fieldTensorType, tensorType), VESPA_STRLOC);
+        }
+    } else if (!TensorDataType::isAssignableType(fieldTensorType, tensorType)) {
         throw WrongTensorTypeException(makeWrongTensorTypeMsg(fieldTensorType, tensorType), VESPA_STRLOC);
     }
 }
@@ -89,6 +89,17 @@ private:
 
 int makeDirectory(const char * dir);
 
+/**
+ * Implemented by done callbacks given to Writer::commit() that want to
+ * know when their commit failed. commitFailed() is called before such a
+ * callback is released. Otherwise releasing the callback signals success.
+ */
+class ICommitFailureHandler {
+public:
+    virtual ~ICommitFailureHandler() = default;
+    virtual void commitFailed(const vespalib::string & reason) = 0;
+};
+
 class Writer {
 public:
     using DoneCallback = std::shared_ptr<IDestructorCallback>;
@@ -3,6 +3,7 @@
 #include "domain.h"
 #include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/util/closuretask.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
 #include <vespa/vespalib/io/fileutil.h>
 #include <vespa/fastos/file.h>
 #include <algorithm>
@@ -25,11 +26,14 @@ using namespace std::chrono_literals;
 namespace search::transactionlog {
 
 Domain::Domain(const string &domainName, const string & baseDir, Executor & commitExecutor,
-               Executor & sessionExecutor, uint64_t domainPartSize, DomainPart::Crc defaultCrcType,
+               Executor & sessionExecutor, uint64_t domainPartSize,
+               DomainPart::Crc defaultCrcType, const GroupCommitConfig & groupCommitConfig,
                const FileHeaderContext &fileHeaderContext) :
     _defaultCrcType(defaultCrcType),
     _commitExecutor(commitExecutor),
     _sessionExecutor(sessionExecutor),
+    _groupCommitExecutor(),
+    _groupCommitConfig(groupCommitConfig),
     _sessionId(1),
     _syncMonitor(),
     _pendingSync(false),
@@ -42,7 +46,16 @@ Domain::Domain(const string &domainName, const string & baseDir, Executor & comm
     _maxSessionRunTime(),
     _baseDir(baseDir),
     _fileHeaderContext(fileHeaderContext),
-    _markedDeleted(false)
+    _markedDeleted(false),
+    _commitLock(),
+    _pendingLock(),
+    _pendingPacket(),
+    _pendingDone(),
+    _windowScheduled(false),
+    _closing(false),
+    _closingCond(),
+    _commitError(),
+    _commitStats()
 {
     int retval(0);
     if ((retval = makeDirectory(_baseDir.c_str())) != 0) {
@@ -63,6 +76,9 @@ Domain::Domain(const string &domainName, const string & baseDir, Executor & comm
         _parts[lastPart] = std::make_shared<DomainPart>(_name, dir(), lastPart, _defaultCrcType, _fileHeaderContext, false);
         vespalib::File::sync(dir());
     }
+    if (_groupCommitConfig.enabled()) {
+        _groupCommitExecutor = std::make_unique<vespalib::ThreadStackExecutor>(1, 128*1024);
+    }
 }
 
 void Domain::addPart(int64_t partId, bool isLastPart) {
@@ -104,7 +120,68 @@ private:
     bool              & _pendingSync;
 };
 
-Domain::~Domain() { }
+namespace {
+
+void waitPendingSync(vespalib::Monitor &syncMonitor, bool &pendingSync)
+{
+    MonitorGuard guard(syncMonitor);
+    while (pendingSync) {
+        guard.wait();
+    }
+}
+
+}
+
+class Domain::GroupCommitTask : public vespalib::Executor::Task
+{
+public:
+    GroupCommitTask(Domain &domain, std::chrono::steady_clock::time_point windowEnd)
+        : _domain(domain),
+          _windowEnd(windowEnd)
+    { }
+private:
+    void run() override {
+        {
+            std::unique_lock<std::mutex> guard(_domain._pendingLock);
+            if (_domain._closingCond.wait_until(guard, _windowEnd, [this]() { return _domain._closing; })) {
+                return; // The domain handles the pending commits when destroyed.
+            }
+        }
+        _domain.onGroupCommitWindowEnd();
+    }
+
+    Domain                               & _domain;
+    std::chrono::steady_clock::time_point  _windowEnd;
+};
+
+Domain::~Domain()
+{
+    if (_groupCommitExecutor) {
+        {
+            std::lock_guard<std::mutex> guard(_pendingLock);
+            _closing = true;
+        }
+        _closingCond.notify_all();
+        // Pending group commit tasks refer to this domain.
+        _groupCommitExecutor->shutdown();
+        _groupCommitExecutor->sync();
+    }
+    if (_markedDeleted) {
+        std::lock_guard<std::mutex> guard(_commitLock);
+        std::lock_guard<std::mutex> pendingGuard(_pendingLock);
+        failCommits(_pendingDone, "Domain '" + _name + "' is deleted");
+        return;
+    }
+    try {
+        commitPending();
+        waitPendingSync(_syncMonitor, _pendingSync);
+        if ( ! _parts.empty()) {
+            _parts.rbegin()->second->sync();
+        }
+    } catch (const std::exception & e) {
+        LOG(error, "Failed writing pending commits to domain '%s' on shutdown: %s", _name.c_str(), e.what());
+    }
+}
 
 DomainInfo
 Domain::getDomainInfo() const
@@ -115,6 +192,7 @@ Domain::getDomainInfo() const
         const DomainPart &part = *entry.second;
         info.parts.emplace_back(PartInfo(part.range(), part.size(), part.byteSize(), part.fileName()));
     }
+    info.commitStats = _commitStats;
     return info;
 }
 
@@ -267,19 +345,155 @@ void Domain::cleanSessions()
     }
 }
 
-namespace {
+void Domain::commit(const Packet & packet)
+{
+    std::lock_guard<std::mutex> guard(_commitLock);
+    DoneCallbacks pendingDone;
+    Packet pendingPacket;
+    {
+        std::lock_guard<std::mutex> pendingGuard(_pendingLock);
+        checkCommitError();
+        std::swap(pendingPacket, _pendingPacket);
+        std::swap(pendingDone, _pendingDone);
+    }
+    if ( ! pendingPacket.empty()) {
+        writeBatch(pendingPacket, std::move(pendingDone), guard);
+    }
+    writeBatch(packet, DoneCallbacks(), guard);
+}
 
-void waitPendingSync(vespalib::Monitor &syncMonitor, bool &pendingSync)
+void Domain::commit(const Packet & packet, Writer::DoneCallback onDone)
 {
-    MonitorGuard guard(syncMonitor);
-    while (pendingSync) {
-        guard.wait();
+    if ( ! _groupCommitConfig.enabled()) {
+        std::lock_guard<std::mutex> guard(_commitLock);
+        {
+            std::lock_guard<std::mutex> pendingGuard(_pendingLock);
+            checkCommitError();
+        }
+        DoneCallbacks done;
+        done.push_back(std::move(onDone));
+        writeBatch(packet, std::move(done), guard);
+        return;
+    }
+    if (packet.empty()) {
+        return;
+    }
+    bool scheduleWindow(false);
+    bool full(false);
+    {
+        std::lock_guard<std::mutex> guard(_pendingLock);
+        checkCommitError();
+        if (_pendingPacket.empty()) {
+            _pendingPacket = packet;
+        } else if ( ! _pendingPacket.merge(packet)) {
+            throw runtime_error(make_string("Incomming serial number(%" PRIu64 ") must be bigger than the last one (%" PRIu64 ").",
+                                            packet.range().from(), _pendingPacket.range().to()));
+        }
+        _pendingDone.push_back(std::move(onDone));
+        full = (_pendingPacket.sizeBytes() >= _groupCommitConfig.getMaxBytes());
+        if ( ! full && ! _windowScheduled) {
+            _windowScheduled = true;
+            scheduleWindow = true;
+        }
+    }
+    if (full) {
+        commitPending();
+    } else if (scheduleWindow) {
+        auto windowEnd = std::chrono::steady_clock::now() + _groupCommitConfig.getWindow();
+        _groupCommitExecutor->execute(std::make_unique<GroupCommitTask>(*this, windowEnd));
     }
 }
 
+void Domain::onGroupCommitWindowEnd()
+{
+    {
+        std::lock_guard<std::mutex> guard(_pendingLock);
+        _windowScheduled = false;
+    }
+    try {
+        commitPending();
+    } catch (const std::exception & e) {
+        // The committers are told through their done callbacks and later commits.
+        LOG(error, "Group commit to domain '%s' failed: %s", _name.c_str(), e.what());
+    }
 }
 
-void Domain::commit(const Packet & packet)
+void Domain::commitPending()
+{
+    std::lock_guard<std::mutex> guard(_commitLock);
+    DoneCallbacks pendingDone;
+    Packet pendingPacket;
+    {
+        std::lock_guard<std::mutex> pendingGuard(_pendingLock);
+        if (_pendingPacket.empty()) {
+            return;
+        }
+        std::swap(pendingPacket, _pendingPacket);
+        std::swap(pendingDone, _pendingDone);
+    }
+    writeBatch(pendingPacket, std::move(pendingDone), guard);
+}
+
+void Domain::failCommits(DoneCallbacks & done, const vespalib::string & reason)
+{
+    for (const auto & onDone : done) {
+        auto failureHandler = dynamic_cast<ICommitFailureHandler *>(onDone.get());
+        if (failureHandler != nullptr) {
+            failureHandler->commitFailed(reason);
+        }
+    }
+    done.clear();
+}
+
+void Domain::checkCommitError() const
+{
+    if ( ! _commitError.empty()) {
+        throw runtime_error(make_string("Domain '%s' can not be committed to after failed write: %s",
+                                        _name.c_str(), _commitError.c_str()));
+    }
+}
+
+void Domain::writeBatch(const Packet & packet, DoneCallbacks done, const std::lock_guard<std::mutex> & commitGuard)
+{
+    (void) commitGuard;
+    DurationSeconds syncTime(0);
+    bool synced(false);
+    try {
+        DomainPart::SP dp = write(packet);
+        if (_groupCommitConfig.useFsync()) {
+            auto syncStart = std::chrono::steady_clock::now();
+            dp->sync();
+            syncTime = std::chrono::steady_clock::now() - syncStart;
+            synced = true;
+        }
+    } catch (const std::exception & e) {
+        // Releasing the callbacks would signal success, so they are failed first.
+        std::lock_guard<std::mutex> pendingGuard(_pendingLock);
+        _commitError = e.what();
+        failCommits(done, _commitError);
+        failCommits(_pendingDone, _commitError);
+        _pendingPacket = Packet();
+        throw;
+    }
+    uint64_t commits = std::max(done.size(), size_t(1));
+    {
+        LockGuard guard(_lock);
+        _commitStats.batches++;
+        _commitStats.commits += commits;
+        _commitStats.entries += packet.size();
+        _commitStats.bytes += packet.sizeBytes();
+        _commitStats.maxBatchCommits = std::max(_commitStats.maxBatchCommits, commits);
+        if (synced) {
+            _commitStats.syncs++;
+            _commitStats.syncTime += syncTime;
+            _commitStats.maxSyncTime = std::max(_commitStats.maxSyncTime, syncTime);
+        }
+    }
+    // Releasing the callbacks signals that the commits are done.
+    done.clear();
+}
+
+DomainPart::SP Domain::write(const Packet & packet)
 {
     DomainPart::SP dp(_parts.rbegin()->second);
     vespalib::nbostream_longlivedbuf is(packet.getHandle().data(), packet.getHandle().size());
@@ -300,6 +514,7 @@ void Domain::commit(const Packet & packet)
     }
     dp->commit(entry.serial(), packet);
     cleanSessions();
+    return dp;
 }
 
 bool Domain::erase(SerialNum to)
@@ -4,7 +4,10 @@
 #include "domainpart.h"
 #include "session.h"
 #include <vespa/vespalib/util/threadexecutor.h>
+#include <vespa/vespalib/util/time.h>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 
 namespace search::transactionlog {
 
@@ -20,6 +23,25 @@ struct PartInfo {
           file(file_in) {}
 };
 
+/**
+ * Statistics for the writes done to a domain. A batch is one write of one
+ * or more commits, followed by a sync when fsync is enabled.
+ */
+struct CommitStats {
+    using DurationSeconds = std::chrono::duration<double>;
+    uint64_t batches;
+    uint64_t commits;
+    uint64_t entries;
+    uint64_t bytes;
+    uint64_t maxBatchCommits;
+    uint64_t syncs;
+    DurationSeconds syncTime;
+    DurationSeconds maxSyncTime;
+    CommitStats()
+        : batches(0), commits(0), entries(0), bytes(0), maxBatchCommits(0),
+          syncs(0), syncTime(), maxSyncTime() {}
+};
+
 struct DomainInfo {
     using DurationSeconds = std::chrono::duration<double>;
     SerialNumRange range;
@@ -27,10 +49,33 @@ struct DomainInfo {
     size_t byteSize;
     DurationSeconds maxSessionRunTime;
     std::vector<PartInfo> parts;
+    CommitStats commitStats;
     DomainInfo(SerialNumRange range_in, size_t numEntries_in, size_t byteSize_in, DurationSeconds maxSessionRunTime_in)
-        : range(range_in), numEntries(numEntries_in), byteSize(byteSize_in), maxSessionRunTime(maxSessionRunTime_in), parts() {}
+        : range(range_in), numEntries(numEntries_in), byteSize(byteSize_in), maxSessionRunTime(maxSessionRunTime_in), parts(), commitStats() {}
     DomainInfo()
-        : range(), numEntries(0), byteSize(0), maxSessionRunTime(), parts() {}
+        : range(), numEntries(0), byteSize(0), maxSessionRunTime(), parts(), commitStats() {}
+};
+
+/**
+ * Configures group commit for a domain. With a non-zero window, commits
+ * with a done callback are buffered and written together with a single
+ * write when the window has passed since the first of them, or when
+ * maxBytes are buffered. The callbacks are released when the batch is
+ * written, and synced when useFsync is set.
+ */
+class GroupCommitConfig {
+public:
+    GroupCommitConfig() : _window(vespalib::duration::zero()), _maxBytes(1024*1024), _useFsync(false) { }
+    GroupCommitConfig(vespalib::duration window, size_t maxBytes, bool useFsync)
+        : _window(window), _maxBytes(maxBytes), _useFsync(useFsync) { }
+    vespalib::duration getWindow() const { return _window; }
+    size_t getMaxBytes() const { return _maxBytes; }
+    bool useFsync() const { return _useFsync; }
+    bool enabled() const { return _window > vespalib::duration::zero(); }
+private:
+    vespalib::duration _window;
+    size_t             _maxBytes;
+    bool               _useFsync;
 };
 
 typedef std::map<vespalib::string, DomainInfo> DomainStats;
@@ -41,7 +86,8 @@ public:
     using SP = std::shared_ptr<Domain>;
     using Executor = vespalib::SyncableThreadExecutor;
     Domain(const vespalib::string &name, const vespalib::string &baseDir, Executor & commitExecutor,
-           Executor & sessionExecutor, uint64_t domainPartSize, DomainPart::Crc defaultCrcType,
+           Executor & sessionExecutor, uint64_t domainPartSize,
+           DomainPart::Crc defaultCrcType, const GroupCommitConfig & groupCommitConfig,
            const common::FileHeaderContext &fileHeaderContext);
 
     virtual ~Domain();
@@ -51,6 +97,17 @@ public:
     bool erase(SerialNum to);
 
     void commit(const Packet & packet);
+    /**
+     * Commits the packet and releases the done callback when it is written.
+     * With group commit enabled this returns before the packet is written.
+     * If the write fails, a done callback implementing ICommitFailureHandler
+     * is told so before it is released, and later commits throw.
+     */
+    void commit(const Packet & packet, Writer::DoneCallback onDone);
+    /**
+     * Writes commits buffered by group commit.
+     */
+    void commitPending();
     int visit(const Domain::SP & self, SerialNum from, SerialNum to, std::unique_ptr<Session::Destination> dest);
 
     SerialNum begin() const;
@@ -79,6 +136,9 @@ public:
     uint64_t size() const;
 
 private:
+    class GroupCommitTask;
+    using DoneCallbacks = std::vector<Writer::DoneCallback>;
+
     SerialNum begin(const vespalib::LockGuard & guard) const;
     SerialNum end(const vespalib::LockGuard & guard) const;
     size_t byteSize(const vespalib::LockGuard & guard) const;
@@ -86,6 +146,11 @@ private:
     void cleanSessions();
     vespalib::string dir() const { return getDir(_baseDir, _name); }
     void addPart(int64_t partId, bool isLastPart);
+    DomainPart::SP write(const Packet & packet);
+    void writeBatch(const Packet & packet, DoneCallbacks done, const std::lock_guard<std::mutex> & commitGuard);
+    void failCommits(DoneCallbacks & done, const vespalib::string & reason);
+    void checkCommitError() const;
+    void onGroupCommitWindowEnd();
 
     using SerialNumList = std::vector<SerialNum>;
 
@@ -98,6 +163,8 @@ private:
     DomainPart::Crc     _defaultCrcType;
     Executor          & _commitExecutor;
     Executor          & _sessionExecutor;
+    std::unique_ptr<Executor> _groupCommitExecutor; // Ends the group commit windows of this domain.
+    GroupCommitConfig   _groupCommitConfig;
     std::atomic<int>    _sessionId;
     vespalib::Monitor   _syncMonitor;
     bool                _pendingSync;
@@ -111,6 +178,15 @@ private:
     vespalib::string    _baseDir;
     const common::FileHeaderContext &_fileHeaderContext;
     bool                _markedDeleted;
+    std::mutex          _commitLock;      // Serializes writes to the domain parts.
+    std::mutex          _pendingLock;     // Protects the commits buffered by group commit below.
+    Packet              _pendingPacket;
+    DoneCallbacks       _pendingDone;
+    bool                _windowScheduled;
+    bool                _closing;         // Ends group commit windows early, protected by _pendingLock.
+    std::condition_variable _closingCond;
+    vespalib::string    _commitError;     // Set when a write fails, protected by _pendingLock.
+    CommitStats         _commitStats;     // Protected by _lock
 };
 
 }
@@ -34,8 +34,8 @@ string
 handleWriteError(const char *text,
                  FastOS_FileInterface &file,
                  int64_t lastKnownGoodPos,
-                 const Packet::Entry &entry,
-                 int bufLen) __attribute__ ((noinline));
+                 SerialNumRange range,
+                 size_t bufLen) __attribute__ ((noinline));
 
 bool
 handleReadError(const char *text,
@@ -75,13 +75,13 @@ string
 handleWriteError(const char *text,
                  FastOS_FileInterface &file,
                  int64_t lastKnownGoodPos,
-                 const Packet::Entry &entry,
-                 int bufLen)
+                 SerialNumRange range,
+                 size_t bufLen)
 {
     string last(FastOS_File::getLastErrorString());
-    string e(make_string("%s. File '%s' at position %" PRId64 " for entry %" PRIu64 " of length %u. "
+    string e(make_string("%s. File '%s' at position %" PRId64 " for entries [%" PRIu64 ", %" PRIu64 "] of length %zu. "
                          "OS says '%s'. Rewind to last known good position %" PRId64 ".",
-                         text, file.GetFileName(), file.GetPosition(), entry.serial(), bufLen,
+                         text, file.GetFileName(), file.GetPosition(), range.from(), range.to(), bufLen,
                          last.c_str(), lastKnownGoodPos));
     LOG(error, "%s",  e.c_str());
     if ( ! file.SetPosition(lastKnownGoodPos) ) {
@@ -409,21 +409,27 @@ DomainPart::commit(SerialNum firstSerial, const Packet &packet)
     if (_range.from() == 0) {
         _range.from(firstSerial);
     }
-    for (size_t i(0); h.size() > 0; i++) {
-        //LOG(spam,
-        //"Pos(%d) Len(%d), Lim(%d), Remaining(%d)",
-        //h.getPos(), h.getLength(), h.getLimit(), h.getRemaining());
+    // All entries in the packet are serialized up front and written with a single write.
+    nbostream os(packet.sizeBytes() + packet.size() * (sizeof(uint8_t) + sizeof(uint32_t) + sizeof(int32_t)));
+    SerialNum lastSerial(_range.to());
+    size_t numEntries(0);
+    while (h.size() > 0) {
         Packet::Entry entry;
         entry.deserialize(h);
-        if (_range.to() < entry.serial()) {
-            write(*_transLog, entry);
-            _sz++;
-            _range.to(entry.serial());
+        if (lastSerial < entry.serial()) {
+            serialize(os, entry);
+            lastSerial = entry.serial();
+            numEntries++;
         } else {
             throw runtime_error(make_string("Incomming serial number(%" PRIu64 ") must be bigger than the last one (%" PRIu64 ").",
-                                            entry.serial(), _range.to()));
+                                            entry.serial(), lastSerial));
         }
     }
+    if (numEntries > 0) {
+        write(*_transLog, SerialNumRange(firstSerial, lastSerial), os);
+        _sz += numEntries;
+        _range.to(lastSerial);
+    }
 
     bool merged(false);
     LockGuard guard(_lock);
@@ -576,12 +582,11 @@ DomainPart::visit(FastOS_FileInterface &file, SerialNumRange &r, Packet &packet)
 }
 
 void
-DomainPart::write(FastOS_FileInterface &file, const Packet::Entry &entry)
+DomainPart::serialize(nbostream &os, const Packet::Entry &entry) const
 {
-    int64_t lastKnownGoodPos(byteSize());
     int32_t crc(0);
     uint32_t len(entry.serializedSize() + sizeof(crc));
-    nbostream os;
+    size_t entryStart(os.size());
     os << static_cast<uint8_t>(_defaultCrc);
     os << len;
     size_t start(os.size());
@@ -589,15 +594,20 @@ DomainPart::write(FastOS_FileInterface &file, const Packet::Entry &entry)
     size_t end(os.size());
     crc = calcCrc(_defaultCrc, os.data() + start, end - start);
     os << crc;
-    size_t osSize = os.size();
-    assert(osSize == len + sizeof(len) + sizeof(uint8_t));
+    assert(os.size() - entryStart == len + sizeof(len) + sizeof(uint8_t));
+    (void) entryStart;
+}
 
+void
+DomainPart::write(FastOS_FileInterface &file, SerialNumRange range, const nbostream &os)
+{
+    int64_t lastKnownGoodPos(byteSize());
     LockGuard guard(_writeLock);
-    if ( ! file.CheckedWrite(os.data(), osSize) ) {
-        throw runtime_error(handleWriteError("Failed writing the entry.", file, lastKnownGoodPos, entry, end - start));
+    if ( ! file.CheckedWrite(os.data(), os.size()) ) {
+        throw runtime_error(handleWriteError("Failed writing the entries.", file, lastKnownGoodPos, range, os.size()));
     }
-    _writtenSerial = entry.serial();
-    _byteSize.store(lastKnownGoodPos + osSize, std::memory_order_release);
+    _writtenSerial = range.to();
+    _byteSize.store(lastKnownGoodPos + os.size(), std::memory_order_release);
 }
 
 bool
@@ -54,7 +54,8 @@ private:
 
     static bool read(FastOS_FileInterface &file, Packet::Entry &entry, vespalib::alloc::Alloc &buf, bool allowTruncate);
 
-    void write(FastOS_FileInterface &file, const Packet::Entry &entry);
+    void serialize(vespalib::nbostream &os, const Packet::Entry &entry) const;
+    void write(FastOS_FileInterface &file, SerialNumRange range, const vespalib::nbostream &os);
     static int32_t calcCrc(Crc crc, const void * buf, size_t len);
     void writeHeader(const common::FileHeaderContext &fileHeaderContext);
 
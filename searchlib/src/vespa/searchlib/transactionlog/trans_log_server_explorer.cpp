@@ -23,6 +23,18 @@ struct DomainExplorer : vespalib::StateExplorer {
         state.setLong("to", info.range.to());
         state.setLong("numEntries", info.numEntries);
         state.setLong("byteSize", info.byteSize);
+        {
+            const CommitStats &stats = info.commitStats;
+            Cursor &commit = state.setObject("commit");
+            commit.setLong("batches", stats.batches);
+            commit.setLong("commits", stats.commits);
+            commit.setLong("entries", stats.entries);
+            commit.setLong("bytes", stats.bytes);
+            commit.setLong("maxBatchCommits", stats.maxBatchCommits);
+            commit.setLong("syncs", stats.syncs);
+            commit.setDouble("syncTime", stats.syncTime.count());
+            commit.setDouble("maxSyncTime", stats.maxSyncTime.count());
+        }
         if (full) {
             Cursor &array = state.setArray("parts");
             for (const PartInfo &part_in: info.parts) {
@@ -86,11 +86,20 @@ TransLogServer::TransLogServer(const vespalib::string &name, int listenPort, con
 TransLogServer::TransLogServer(const vespalib::string &name, int listenPort, const vespalib::string &baseDir,
                                const FileHeaderContext &fileHeaderContext, uint64_t domainPartSize,
                                size_t maxThreads, DomainPart::Crc defaultCrcType)
+    : TransLogServer(name, listenPort, baseDir, fileHeaderContext, domainPartSize, maxThreads, defaultCrcType,
+                     GroupCommitConfig())
+{}
+
+TransLogServer::TransLogServer(const vespalib::string &name, int listenPort, const vespalib::string &baseDir,
+                               const FileHeaderContext &fileHeaderContext, uint64_t domainPartSize,
+                               size_t maxThreads, DomainPart::Crc defaultCrcType,
+                               const GroupCommitConfig &groupCommitConfig)
     : FRT_Invokable(),
       _name(name),
       _baseDir(baseDir),
       _domainPartSize(domainPartSize),
       _defaultCrcType(defaultCrcType),
+      _groupCommitConfig(groupCommitConfig),
       _commitExecutor(maxThreads, 128*1024),
       _sessionExecutor(maxThreads, 128*1024),
       _threadPool(std::make_unique<FastOS_ThreadPool>(1024*60)),
@@ -110,7 +119,8 @@ TransLogServer::TransLogServer(const vespalib::string &name, int listenPort, con
                 if ( ! domainName.empty()) {
                     try {
                         auto domain = std::make_shared<Domain>(domainName, dir(), _commitExecutor, _sessionExecutor,
-                                                               _domainPartSize, _defaultCrcType,_fileHeaderContext);
+                                                               _domainPartSize, _defaultCrcType,
+                                                               _groupCommitConfig, _fileHeaderContext);
                         _domains[domain->name()] = domain;
                     } catch (const std::exception & e) {
                         LOG(warning, "Failed creating %s domain on startup. Exception = %s", domainName.c_str(), e.what());
@@ -146,6 +156,14 @@ TransLogServer::~TransLogServer()
 {
     stop();
     join();
+    {
+        // Domains write their pending commits when destroyed, which might need the executors.
+        DomainList domains;
+        {
+            Guard domainGuard(_lock);
+            std::swap(domains, _domains);
+        }
+    }
     _commitExecutor.shutdown();
     _commitExecutor.sync();
     _sessionExecutor.shutdown();
@@ -432,7 +450,8 @@ TransLogServer::createDomain(FRT_RPCRequest *req)
     if ( !domain ) {
         try {
             domain = std::make_shared<Domain>(domainName, dir(), _commitExecutor, _sessionExecutor,
-                                              _domainPartSize, _defaultCrcType, _fileHeaderContext);
+                                              _domainPartSize, _defaultCrcType,
+                                              _groupCommitConfig, _fileHeaderContext);
             Guard domainGuard(_lock);
             _domains[domain->name()] = domain;
             writeDomainDir(domainGuard, dir(), domainList(), _domains);
@@ -541,10 +560,9 @@ TransLogServer::domainStatus(FRT_RPCRequest *req)
 void
 TransLogServer::commit(const vespalib::string & domainName, const Packet & packet, DoneCallback done)
 {
-    (void) done;
     Domain::SP domain(findDomain(domainName));
     if (domain) {
-        domain->commit(packet);
+        domain->commit(packet, std::move(done));
     } else {
         throw IllegalArgumentException("Could not find domain " + domainName);
     }
@@ -25,6 +25,10 @@ public:
     typedef std::unique_ptr<TransLogServer> UP;
     typedef std::shared_ptr<TransLogServer> SP;
 
+    TransLogServer(const vespalib::string &name, int listenPort, const vespalib::string &baseDir,
+                   const common::FileHeaderContext &fileHeaderContext,
+                   uint64_t domainPartSize, size_t maxThreads, DomainPart::Crc defaultCrc,
+                   const GroupCommitConfig &groupCommitConfig);
     TransLogServer(const vespalib::string &name, int listenPort, const vespalib::string &baseDir,
                    const common::FileHeaderContext &fileHeaderContext,
                    uint64_t domainPartSize, size_t maxThreads, DomainPart::Crc defaultCrc);
@@ -84,6 +88,7 @@ private:
     vespalib::string                    _baseDir;
     const uint64_t                      _domainPartSize;
     const DomainPart::Crc               _defaultCrcType;
+    const GroupCommitConfig             _groupCommitConfig;
     vespalib::ThreadStackExecutor       _commitExecutor;
     vespalib::ThreadStackExecutor       _sessionExecutor;
     std::unique_ptr<FastOS_ThreadPool>  _threadPool;
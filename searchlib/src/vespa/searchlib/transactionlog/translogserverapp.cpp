@@ -42,8 +42,9 @@ void
 TransLogServerApp::start()
 {
     std::shared_ptr<searchlib::TranslogserverConfig> c = _tlsConfig.get();
+    GroupCommitConfig groupCommit(vespalib::from_s(c->groupcommit.window), c->groupcommit.maxbytes, c->usefsync);
     auto tls = std::make_shared<TransLogServer>(c->servername, c->listenport, c->basedir, _fileHeaderContext,
-                                            c->filesizemax, c->maxthreads, getCrc(c->crcmethod));
+                                            c->filesizemax, c->maxthreads, getCrc(c->crcmethod), groupCommit);
     std::lock_guard<std::mutex> guard(_lock);
     _tls = std::move(tls);
 }
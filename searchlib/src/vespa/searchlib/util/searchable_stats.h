@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #pragma once
 
+#include <vespa/searchlib/docstore/cachestats.h>
 #include <vespa/vespalib/util/memoryusage.h>
 
 namespace search {
@@ -16,9 +17,11 @@ private:
     vespalib::MemoryUsage _memoryUsage;
     size_t _docsInMemory;
     size_t _sizeOnDisk;
+    CacheStats _postingListCacheStats;
+    CacheStats _bitVectorCacheStats;
 
 public:
-    SearchableStats() : _memoryUsage(), _docsInMemory(0), _sizeOnDisk(0) {}
+    SearchableStats() : _memoryUsage(), _docsInMemory(0), _sizeOnDisk(0), _postingListCacheStats(), _bitVectorCacheStats() {}
     SearchableStats &memoryUsage(const vespalib::MemoryUsage &usage) {
         _memoryUsage = usage;
         return *this;
@@ -34,10 +37,22 @@ public:
         return *this;
     }
     size_t sizeOnDisk() const { return _sizeOnDisk; }
+    SearchableStats &postingListCacheStats(const CacheStats &stats) {
+        _postingListCacheStats = stats;
+        return *this;
+    }
+    const CacheStats &postingListCacheStats() const { return _postingListCacheStats; }
+    SearchableStats &bitVectorCacheStats(const CacheStats &stats) {
+        _bitVectorCacheStats = stats;
+        return *this;
+    }
+    const CacheStats &bitVectorCacheStats() const { return _bitVectorCacheStats; }
     SearchableStats &add(const SearchableStats &rhs) {
         _memoryUsage.merge(rhs._memoryUsage);
         _docsInMemory += rhs._docsInMemory;
         _sizeOnDisk += rhs._sizeOnDisk;
+        _postingListCacheStats += rhs._postingListCacheStats;
+        _bitVectorCacheStats += rhs._bitVectorCacheStats;
         return *this;
     }
 };
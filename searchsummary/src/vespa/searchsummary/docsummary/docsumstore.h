@@ -3,6 +3,7 @@
 #pragma once
 
 #include "docsumstorevalue.h"
+#include <vector>
 
 namespace search::docsummary {
 
@@ -38,6 +39,12 @@ public:
      **/
     virtual DocsumStoreValue getMappedDocsum(uint32_t docid) = 0;
 
+    /**
+     * Hint that docsums for the given local document ids will be
+     * fetched shortly, so that they can be read in one batch.
+     **/
+    virtual void prefetch(const std::vector<uint32_t> &) { }
+
     /**
      * Will return default input class used.
      **/
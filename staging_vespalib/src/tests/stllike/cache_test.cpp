@@ -48,6 +48,20 @@ TEST("testCache") {
     EXPECT_TRUE(cache.size() == 1);
 }
 
+TEST("testCachePopulate") {
+    B m;
+    cache< CacheParam<P, B> > cache(m, -1);
+    cache.populate(1, "Read elsewhere");
+    EXPECT_TRUE( cache.hasKey(1) );
+    EXPECT_TRUE( m.empty() );
+    EXPECT_EQUAL( cache.read(1), "Read elsewhere");
+    EXPECT_EQUAL(1u, cache.getInsert());
+    cache.write(2, "Written through");
+    cache.populate(2, "Stale copy");
+    EXPECT_EQUAL( cache.read(2), "Written through");
+    EXPECT_EQUAL(2u, cache.size());
+}
+
 TEST("testCacheSize")
 {
     B m;
@@ -103,6 +103,13 @@ public:
      */
     void write(const K & key, V value);
 
+    /**
+     * Insert an object that has already been read from the backing store by other means.
+     * Nothing is written to the backing store, and an object already in the cache is kept.
+     * Object is then put at head of LRU list.
+     */
+    void populate(const K & key, V value);
+
     /**
      * Tell if an object with given key exists in the cache.
      * Does not alter the LRU list.
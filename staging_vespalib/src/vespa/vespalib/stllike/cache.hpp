@@ -142,6 +142,22 @@ cache<P>::write(const K & key, V value)
     }
 }
 
+template< typename P >
+void
+cache<P>::populate(const K & key, V value)
+{
+    vespalib::LockGuard storeGuard(getLock(key));
+    vespalib::LockGuard guard(_hashLock);
+    if (Lru::hasKey(key)) {
+        _race++;
+        return;
+    }
+    size_t newSize = calcSize(key, value);
+    Lru::insert(key, std::move(value));
+    _sizeBytes += newSize;
+    _insert++;
+}
+
 template< typename P >
 void
 cache<P>::erase(const K & key)
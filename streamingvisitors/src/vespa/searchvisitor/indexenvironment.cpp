@@ -38,7 +38,7 @@ IndexEnvironment::hintAttributeAccess(const string & name) const {
     if (name.empty()) {
         return;
     }
-    if (_motivation == RANK) {
+    if ((_motivation == RANK) || (_motivation == SECOND_PHASE_RANK)) {
         _rankAttributes.insert(name);
     } else {
         _dumpAttributes.insert(name);
@@ -3,6 +3,8 @@
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/vespalib/stllike/string.h>
 #include <vespa/vespalib/util/compressor.h>
+#include <vespa/vespalib/util/zstdcompressor.h>
+#include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/data/databuffer.h>
 
 #include <vespa/log/log.h>
@@ -67,6 +69,73 @@ TEST("requiret that zstd compression/decompression works") {
     EXPECT_EQUAL(_G_compressableText, vespalib::string(decompress.data(), decompress.size()));
 }
 
+namespace {
+
+vespalib::string
+make_document(uint32_t id)
+{
+    return make_string("{\"id\":\"id:music:song::%u\",\"fields\":{\"title\":\"Song number %u\","
+                       "\"artist\":\"Artist %u\",\"year\":%u,\"genre\":\"%s\"}}",
+                       id, id * 7, id % 97, 1950 + (id % 70), ((id % 3) == 0) ? "rock" : "pop");
+}
+
+std::unique_ptr<ZStdDictionary>
+train_dictionary(size_t maxSize)
+{
+    vespalib::string samples;
+    std::vector<size_t> sampleSizes;
+    for (uint32_t i(0); i < 2000; i++) {
+        vespalib::string doc = make_document(i);
+        samples += doc;
+        sampleSizes.push_back(doc.size());
+    }
+    return ZStdDictionary::train(samples.data(), sampleSizes, maxSize);
+}
+
+}
+
+TEST("require that zstd compression with trained dictionary works") {
+    auto decompressOnly = train_dictionary(4096);
+    ASSERT_TRUE(decompressOnly);
+    EXPECT_FALSE(decompressOnly->canCompress());
+    EXPECT_NOT_EQUAL(0u, decompressOnly->getId());
+    EXPECT_LESS_EQUAL(decompressOnly->getBuffer().size(), 4096u);
+    auto dictionary = std::make_unique<ZStdDictionary>(decompressOnly->getBuffer(), 9);
+    EXPECT_TRUE(dictionary->canCompress());
+    EXPECT_EQUAL(decompressOnly->getId(), dictionary->getId());
+
+    CompressionConfig cfg(CompressionConfig::Type::ZSTD, 9, 100);
+    vespalib::string doc = make_document(12345);
+    ConstBufferRef ref(doc.c_str(), doc.size());
+    DataBuffer plain;
+    DataBuffer withDictionary;
+    EXPECT_EQUAL(CompressionConfig::Type::ZSTD, compress(cfg, ref, plain, false));
+    EXPECT_EQUAL(CompressionConfig::Type::ZSTD, compress(cfg, dictionary.get(), ref, withDictionary, false));
+    EXPECT_LESS(withDictionary.getDataLen(), plain.getDataLen());
+    EXPECT_EQUAL(dictionary->getId(),
+                 ZStdDictionary::getFrameDictionaryId(withDictionary.getData(), withDictionary.getDataLen()));
+    EXPECT_EQUAL(0u, ZStdDictionary::getFrameDictionaryId(plain.getData(), plain.getDataLen()));
+
+    DataBuffer uncompressed;
+    decompress(CompressionConfig::Type::ZSTD, decompressOnly.get(), doc.size(),
+               ConstBufferRef(withDictionary.getData(), withDictionary.getDataLen()), uncompressed, false);
+    EXPECT_EQUAL(doc, vespalib::string(uncompressed.getData(), uncompressed.getDataLen()));
+    DataBuffer uncompressedPlain;
+    decompress(CompressionConfig::Type::ZSTD, decompressOnly.get(), doc.size(),
+               ConstBufferRef(plain.getData(), plain.getDataLen()), uncompressedPlain, false);
+    EXPECT_EQUAL(doc, vespalib::string(uncompressedPlain.getData(), uncompressedPlain.getDataLen()));
+
+    ZStdCompressor noDictionary;
+    vespalib::string output(doc.size(), '\0');
+    size_t outputLen(output.size());
+    EXPECT_FALSE(noDictionary.unprocess(withDictionary.getData(), withDictionary.getDataLen(), &output[0], outputLen));
+}
+
+TEST("require that dictionary training fails without enough samples") {
+    std::vector<size_t> sampleSizes = {10};
+    EXPECT_FALSE(ZStdDictionary::train("0123456789", sampleSizes, 4096));
+}
+
 TEST_MAIN() {
     TEST_RUN_ALL();
 }
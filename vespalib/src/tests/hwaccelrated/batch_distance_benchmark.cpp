@@ -0,0 +1,104 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace vespalib;
+using vespalib::hwaccelrated::IAccelrated;
+
+/**
+ * Compares computing one query vector against many rows one pair at a
+ * time with the batched one-to-many kernels. The rows of each batch are
+ * picked at random from a large set of documents, similar to the
+ * neighbors visited when exploring an hnsw graph, and consecutive runs
+ * use different batches so that the rows are mostly not cached.
+ */
+template <typename Q, typename C>
+struct Setup {
+    static constexpr size_t numBatches = 1024;
+    std::vector<Q> query;
+    std::vector<C> cells;
+    std::vector<const C *> rows;
+    Setup(size_t dims, size_t numDocs, size_t numRows)
+        : query(dims),
+          cells(dims * numDocs),
+          rows()
+    {
+        for (auto & q : query) {
+            q = rand()%200 - 100;
+        }
+        for (auto & c : cells) {
+            c = rand()%200 - 100;
+        }
+        for (size_t i(0); i < numRows * numBatches; i++) {
+            rows.push_back(&cells[(rand() % numDocs) * dims]);
+        }
+    }
+};
+
+template <typename Q, typename C, typename PairOp, typename BatchOp>
+void
+benchmark(const char * name, size_t dims, size_t numDocs, size_t numRows, PairOp pairOp, BatchOp batchOp)
+{
+    Setup<Q, C> setup(dims, numDocs, numRows);
+    std::vector<double> result(numRows);
+    const Q * query = &setup.query[0];
+    size_t batch = 0;
+    double pair_time = BenchmarkTimer::benchmark([&]() {
+        const C * const * rows = &setup.rows[(batch++ % setup.numBatches) * numRows];
+        for (size_t i(0); i < numRows; i++) {
+            result[i] = pairOp(query, rows[i], dims);
+        }
+    }, 1.0);
+    double batch_time = BenchmarkTimer::benchmark([&]() {
+        const C * const * rows = &setup.rows[(batch++ % setup.numBatches) * numRows];
+        batchOp(query, rows, numRows, dims, &result[0]);
+    }, 1.0);
+    fprintf(stderr, "%-36s pair: %8.2f ns/row, batch: %8.2f ns/row, speedup: %5.2f\n", name,
+            pair_time * 1e9 / numRows, batch_time * 1e9 / numRows, pair_time / batch_time);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t dims = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 768;
+    size_t numRows = (argc > 2) ? strtoul(argv[2], nullptr, 0) : 64;
+    size_t numDocs = (argc > 3) ? strtoul(argv[3], nullptr, 0) : 100000;
+    fprintf(stderr, "dims=%zu, rows per batch=%zu, docs=%zu\n", dims, numRows, numDocs);
+    const IAccelrated & accel = IAccelrated::getAccelerator();
+    srand(1);
+    benchmark<float, float>("float euclidean distance", dims, numDocs, numRows,
+            [&](const float * a, const float * b, size_t sz) { return accel.squaredEuclideanDistance(a, b, sz); },
+            [&](const float * a, const float * const * b, size_t n, size_t sz, double * r) {
+                accel.squaredEuclideanDistanceBatch(a, b, n, sz, r);
+            });
+    std::vector<float> dotProducts(numRows);
+    benchmark<float, float>("float dot product", dims, numDocs, numRows,
+            [&](const float * a, const float * b, size_t sz) { return accel.dotProduct(a, b, sz); },
+            [&](const float * a, const float * const * b, size_t n, size_t sz, double *) {
+                accel.dotProductBatch(a, b, n, sz, &dotProducts[0]);
+            });
+    benchmark<double, double>("double euclidean distance", dims, numDocs / 2, numRows,
+            [&](const double * a, const double * b, size_t sz) { return accel.squaredEuclideanDistance(a, b, sz); },
+            [&](const double * a, const double * const * b, size_t n, size_t sz, double * r) {
+                accel.squaredEuclideanDistanceBatch(a, b, n, sz, r);
+            });
+    benchmark<int8_t, int8_t>("int8 euclidean distance", dims, numDocs, numRows,
+            [&](const int8_t * a, const int8_t * b, size_t sz) { return accel.squaredEuclideanDistance(a, b, sz); },
+            [&](const int8_t * a, const int8_t * const * b, size_t n, size_t sz, double * r) {
+                accel.squaredEuclideanDistanceBatch(a, b, n, sz, r);
+            });
+    benchmark<float, int8_t>("float/int8 euclidean distance", dims, numDocs, numRows,
+            [&](const float * a, const int8_t * b, size_t sz) { return accel.squaredEuclideanDistance(a, b, sz); },
+            [&](const float * a, const int8_t * const * b, size_t n, size_t sz, double * r) {
+                accel.squaredEuclideanDistanceBatch(a, b, n, sz, r);
+            });
+    benchmark<float, BFloat16>("float/bfloat16 euclidean distance", dims, numDocs, numRows,
+            [&](const float * a, const BFloat16 * b, size_t sz) { return accel.squaredEuclideanDistance(a, b, sz); },
+            [&](const float * a, const BFloat16 * const * b, size_t n, size_t sz, double * r) {
+                accel.squaredEuclideanDistanceBatch(a, b, n, sz, r);
+            });
+    return 0;
+}
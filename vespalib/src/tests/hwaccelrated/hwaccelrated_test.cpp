@@ -3,6 +3,9 @@
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/vespalib/hwaccelrated/iaccelrated.h>
 #include <vespa/vespalib/hwaccelrated/generic.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <cmath>
+#include <limits>
 
 using namespace vespalib;
 
@@ -37,4 +40,188 @@ TEST("test euclidean distance") {
     verifyEuclideanDistance<double >(genericAccelrator);
 }
 
+void verifyInt8(const hwaccelrated::IAccelrated & accel) {
+    const size_t testLength(1027);
+    srand(1);
+    std::vector<int8_t> a(testLength);
+    std::vector<int8_t> b(testLength);
+    for (size_t i(0); i < testLength; i++) {
+        a[i] = rand()%256 - 128;
+        b[i] = rand()%256 - 128;
+    }
+    for (size_t j(0); j < 0x40; j++) {
+        int64_t dotProduct(0);
+        int64_t distance(0);
+        for (size_t i(j); i < testLength; i++) {
+            dotProduct += a[i] * b[i];
+            distance += (a[i] - b[i]) * (a[i] - b[i]);
+        }
+        EXPECT_EQUAL(dotProduct, accel.dotProduct(&a[j], &b[j], testLength - j));
+        EXPECT_EQUAL(double(distance), accel.squaredEuclideanDistance(&a[j], &b[j], testLength - j));
+    }
+}
+
+TEST("test int8 dot product and euclidean distance") {
+    hwaccelrated::GenericAccelrator genericAccelrator;
+    verifyInt8(genericAccelrator);
+    verifyInt8(hwaccelrated::IAccelrated::getAccelerator());
+}
+
+TEST("test int8 sums do not overflow") {
+    std::vector<int8_t> a(1000000, -128);
+    std::vector<int8_t> b(1000000, 127);
+    const auto & accel = hwaccelrated::IAccelrated::getAccelerator();
+    EXPECT_EQUAL(int64_t(-128*127) * 1000000, accel.dotProduct(&a[0], &b[0], a.size()));
+    EXPECT_EQUAL(double(255*255) * 1000000, accel.squaredEuclideanDistance(&a[0], &b[0], a.size()));
+}
+
+void verifyBFloat16(const hwaccelrated::IAccelrated & accel) {
+    const size_t testLength(1027);
+    srand(1);
+    std::vector<BFloat16> a(testLength);
+    std::vector<BFloat16> b(testLength);
+    for (size_t i(0); i < testLength; i++) {
+        // small integers are exactly representable as bfloat16
+        a[i] = float(rand()%200) - 100.0f;
+        b[i] = float(rand()%200) - 100.0f;
+    }
+    for (size_t j(0); j < 0x20; j++) {
+        double dotProduct(0);
+        double distance(0);
+        for (size_t i(j); i < testLength; i++) {
+            dotProduct += a[i] * b[i];
+            distance += (a[i] - b[i]) * (a[i] - b[i]);
+        }
+        EXPECT_EQUAL(dotProduct, accel.dotProduct(&a[j], &b[j], testLength - j));
+        EXPECT_EQUAL(distance, accel.squaredEuclideanDistance(&a[j], &b[j], testLength - j));
+    }
+}
+
+TEST("test bfloat16 dot product and euclidean distance") {
+    hwaccelrated::GenericAccelrator genericAccelrator;
+    verifyBFloat16(genericAccelrator);
+    verifyBFloat16(hwaccelrated::IAccelrated::getAccelerator());
+}
+
+void verifyMixed(const hwaccelrated::IAccelrated & accel) {
+    const size_t testLength(1027);
+    srand(1);
+    std::vector<float> a(testLength);
+    std::vector<int8_t> b8(testLength);
+    std::vector<BFloat16> b16(testLength);
+    for (size_t i(0); i < testLength; i++) {
+        a[i] = float(rand()%200) - 100.0f;
+        b8[i] = rand()%256 - 128;
+        b16[i] = float(rand()%200) - 100.0f;
+    }
+    for (size_t j(0); j < 0x20; j++) {
+        double dotProduct8(0);
+        double distance8(0);
+        double dotProduct16(0);
+        double distance16(0);
+        for (size_t i(j); i < testLength; i++) {
+            dotProduct8 += a[i] * b8[i];
+            distance8 += (a[i] - b8[i]) * (a[i] - b8[i]);
+            dotProduct16 += a[i] * b16[i];
+            distance16 += (a[i] - b16[i]) * (a[i] - b16[i]);
+        }
+        EXPECT_EQUAL(dotProduct8, accel.dotProduct(&a[j], &b8[j], testLength - j));
+        EXPECT_EQUAL(distance8, accel.squaredEuclideanDistance(&a[j], &b8[j], testLength - j));
+        EXPECT_EQUAL(dotProduct16, accel.dotProduct(&a[j], &b16[j], testLength - j));
+        EXPECT_EQUAL(distance16, accel.squaredEuclideanDistance(&a[j], &b16[j], testLength - j));
+    }
+}
+
+TEST("test mixed float/int8 and float/bfloat16 dot product and euclidean distance") {
+    hwaccelrated::GenericAccelrator genericAccelrator;
+    verifyMixed(genericAccelrator);
+    verifyMixed(hwaccelrated::IAccelrated::getAccelerator());
+}
+
+template <typename A, typename B, typename DotProduct>
+void verifyBatch(const hwaccelrated::IAccelrated & accel, size_t numRows, size_t testLength) {
+    std::vector<A> a(testLength);
+    std::vector<std::vector<B>> rows(numRows, std::vector<B>(testLength));
+    std::vector<const B *> rowPtrs;
+    for (size_t i(0); i < testLength; i++) {
+        a[i] = rand()%200 - 100;
+    }
+    for (auto & row : rows) {
+        for (size_t i(0); i < testLength; i++) {
+            row[i] = rand()%200 - 100;
+        }
+        rowPtrs.push_back(&row[0]);
+    }
+    std::vector<DotProduct> dotProducts(numRows);
+    std::vector<double> distances(numRows);
+    accel.dotProductBatch(&a[0], &rowPtrs[0], numRows, testLength, &dotProducts[0]);
+    accel.squaredEuclideanDistanceBatch(&a[0], &rowPtrs[0], numRows, testLength, &distances[0]);
+    for (size_t row(0); row < numRows; row++) {
+        EXPECT_EQUAL(accel.dotProduct(&a[0], rowPtrs[row], testLength), dotProducts[row]);
+        EXPECT_EQUAL(accel.squaredEuclideanDistance(&a[0], rowPtrs[row], testLength), distances[row]);
+    }
+}
+
+void verifyBatch(const hwaccelrated::IAccelrated & accel) {
+    srand(1);
+    for (size_t numRows : {1, 2, 7}) {
+        for (size_t testLength : {1, 31, 257}) {
+            TEST_STATE(make_string("numRows=%zu, testLength=%zu", numRows, testLength).c_str());
+            verifyBatch<float, float, float>(accel, numRows, testLength);
+            verifyBatch<double, double, double>(accel, numRows, testLength);
+            verifyBatch<int8_t, int8_t, int64_t>(accel, numRows, testLength);
+            verifyBatch<float, int8_t, float>(accel, numRows, testLength);
+            verifyBatch<float, BFloat16, float>(accel, numRows, testLength);
+        }
+    }
+}
+
+TEST("test batched dot product and euclidean distance gives same result as one pair at a time") {
+    hwaccelrated::GenericAccelrator genericAccelrator;
+    verifyBatch(genericAccelrator);
+    verifyBatch(hwaccelrated::IAccelrated::getAccelerator());
+}
+
+template<typename T>
+void verifyRangeBits(const hwaccelrated::IAccelrated & accel, T low, T high) {
+    const size_t testLength(1024);
+    srand(1);
+    std::vector<T> a = createAndFill<T>(testLength);
+    a[7] = low;
+    a[8] = high;
+    std::vector<uint64_t> bits(testLength / 64, 0x5555555555555555ul);
+    accel.rangeBits(&a[0], testLength, low, high, &bits[0]);
+    size_t hits = 0;
+    for (size_t i(0); i < testLength; i++) {
+        bool expected = (low <= a[i]) && (a[i] <= high);
+        EXPECT_EQUAL(expected, ((bits[i / 64] >> (i % 64)) & 1) != 0);
+        hits += expected ? 1 : 0;
+    }
+    EXPECT_LESS(2u, hits);
+}
+
+TEST("test range bits") {
+    hwaccelrated::GenericAccelrator genericAccelrator;
+    for (const hwaccelrated::IAccelrated * accel : { static_cast<const hwaccelrated::IAccelrated *>(&genericAccelrator),
+                                                    &hwaccelrated::IAccelrated::getAccelerator() })
+    {
+        verifyRangeBits<int8_t>(*accel, 10, 90);
+        verifyRangeBits<int16_t>(*accel, 100, 250);
+        verifyRangeBits<int32_t>(*accel, 0, 0);
+        verifyRangeBits<int64_t>(*accel, 300, 499);
+        verifyRangeBits<float>(*accel, 10.5, 200.0);
+        verifyRangeBits<double>(*accel, -1.0, 42.0);
+    }
+}
+
+TEST("require that bfloat16 conversion rounds to nearest even") {
+    EXPECT_EQUAL(1.0f, float(BFloat16(1.0f)));
+    EXPECT_EQUAL(-2.5f, float(BFloat16(-2.5f)));
+    EXPECT_EQUAL(1.0f, float(BFloat16(1.0f + 1.0f/512)));
+    EXPECT_EQUAL(1.0f + 1.0f/64, float(BFloat16(1.0f + 1.0f/64 + 1.0f/512)));
+    EXPECT_EQUAL(1.0f + 1.0f/128, float(BFloat16(1.0f + 1.0f/128 - 1.0f/1024)));
+    EXPECT_TRUE(std::isnan(float(BFloat16(std::numeric_limits<float>::quiet_NaN()))));
+    EXPECT_TRUE(std::isinf(float(BFloat16(std::numeric_limits<float>::infinity()))));
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
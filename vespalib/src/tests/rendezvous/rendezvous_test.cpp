@@ -53,6 +53,15 @@ struct Swap : Rendezvous<T, T> {
     }
 };
 
+struct Reverse : Rendezvous<size_t, size_t> {
+    Reverse(size_t n) : Rendezvous<size_t, size_t>(n) {}
+    void mingle() override {
+        for (size_t i = 0; i < size(); ++i) {
+            out(i) = in(size() - 1 - i);
+        }
+    }
+};
+
 TEST("require that creating an empty rendezvous will fail") {
     EXPECT_EXCEPTION(Add(0), IllegalArgumentException, "");
 }
@@ -117,4 +126,15 @@ TEST_MT_F("require that threads can exchange non-copyable state", 2, Swap<std::u
     EXPECT_EQUAL(*other, 1 - thread_id);
 }
 
+TEST_MT_F("require that participation id can be explicitly defined", 10, Reverse(num_threads)) {
+    for (size_t i = 0; i < 128; ++i) {
+        size_t my_id = ((thread_id + i) % num_threads);
+        EXPECT_EQUAL(f1.rendezvous(my_id, my_id), num_threads - 1 - my_id);
+    }
+}
+
+TEST_MT_F("require that participation id works for single thread", 1, Reverse(num_threads)) {
+    EXPECT_EQUAL(f1.rendezvous(5, 0), 5u);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -5,6 +5,12 @@
 
 namespace vespalib::hwaccelrated {
 
+int64_t
+Avx2Accelrator::dotProduct(const int8_t * a, const int8_t * b, size_t sz) const
+{
+    return avx::dotProductInt8<32>(a, b, sz);
+}
+
 size_t
 Avx2Accelrator::populationCount(const uint64_t *a, size_t sz) const {
     return helper::populationCount(a, sz);
@@ -20,6 +26,81 @@ Avx2Accelrator::squaredEuclideanDistance(const double * a, const double * b, siz
     return avx::euclideanDistanceSelectAlignment<double, 32>(a, b, sz);
 }
 
+double
+Avx2Accelrator::squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const {
+    return avx::euclideanDistanceInt8<32>(a, b, sz);
+}
+
+float
+Avx2Accelrator::dotProduct(const float * a, const int8_t * b, size_t sz) const {
+    return avx::dotProductMixed<32>(a, b, sz);
+}
+
+float
+Avx2Accelrator::dotProduct(const float * a, const BFloat16 * b, size_t sz) const {
+    return avx::dotProductMixed<32>(a, b, sz);
+}
+
+double
+Avx2Accelrator::squaredEuclideanDistance(const float * a, const int8_t * b, size_t sz) const {
+    return avx::euclideanDistanceMixed<32>(a, b, sz);
+}
+
+double
+Avx2Accelrator::squaredEuclideanDistance(const float * a, const BFloat16 * b, size_t sz) const {
+    return avx::euclideanDistanceMixed<32>(a, b, sz);
+}
+
+void
+Avx2Accelrator::dotProductBatch(const float * a, const float * const * rows, size_t numRows, size_t sz, float * result) const {
+    avx::dotProductBatch<float, 32>(a, rows, numRows, sz, result);
+}
+
+void
+Avx2Accelrator::dotProductBatch(const double * a, const double * const * rows, size_t numRows, size_t sz, double * result) const {
+    avx::dotProductBatch<double, 32>(a, rows, numRows, sz, result);
+}
+
+void
+Avx2Accelrator::squaredEuclideanDistanceBatch(const float * a, const float * const * rows, size_t numRows, size_t sz, double * result) const {
+    avx::euclideanDistanceBatch<float, 32>(a, rows, numRows, sz, result);
+}
+
+void
+Avx2Accelrator::squaredEuclideanDistanceBatch(const double * a, const double * const * rows, size_t numRows, size_t sz, double * result) const {
+    avx::euclideanDistanceBatch<double, 32>(a, rows, numRows, sz, result);
+}
+
+void
+Avx2Accelrator::rangeBits(const int8_t * a, size_t sz, int8_t low, int8_t high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
+void
+Avx2Accelrator::rangeBits(const int16_t * a, size_t sz, int16_t low, int16_t high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
+void
+Avx2Accelrator::rangeBits(const int32_t * a, size_t sz, int32_t low, int32_t high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
+void
+Avx2Accelrator::rangeBits(const int64_t * a, size_t sz, int64_t low, int64_t high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
+void
+Avx2Accelrator::rangeBits(const float * a, size_t sz, float low, float high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
+void
+Avx2Accelrator::rangeBits(const double * a, size_t sz, double low, double high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
 void
 Avx2Accelrator::and64(size_t offset, const std::vector<std::pair<const void *, bool>> &src, void *dest) const {
     helper::andChunks<32u, 2u>(offset, src, dest);
@@ -12,9 +12,25 @@ namespace vespalib::hwaccelrated {
 class Avx2Accelrator : public GenericAccelrator
 {
 public:
+    int64_t dotProduct(const int8_t * a, const int8_t * b, size_t sz) const override;
     size_t populationCount(const uint64_t *a, size_t sz) const override;
     double squaredEuclideanDistance(const float * a, const float * b, size_t sz) const override;
     double squaredEuclideanDistance(const double * a, const double * b, size_t sz) const override;
+    double squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const override;
+    float dotProduct(const float * a, const int8_t * b, size_t sz) const override;
+    float dotProduct(const float * a, const BFloat16 * b, size_t sz) const override;
+    double squaredEuclideanDistance(const float * a, const int8_t * b, size_t sz) const override;
+    double squaredEuclideanDistance(const float * a, const BFloat16 * b, size_t sz) const override;
+    void dotProductBatch(const float * a, const float * const * rows, size_t numRows, size_t sz, float * result) const override;
+    void dotProductBatch(const double * a, const double * const * rows, size_t numRows, size_t sz, double * result) const override;
+    void squaredEuclideanDistanceBatch(const float * a, const float * const * rows, size_t numRows, size_t sz, double * result) const override;
+    void squaredEuclideanDistanceBatch(const double * a, const double * const * rows, size_t numRows, size_t sz, double * result) const override;
+    void rangeBits(const int8_t * a, size_t sz, int8_t low, int8_t high, uint64_t * bits) const override;
+    void rangeBits(const int16_t * a, size_t sz, int16_t low, int16_t high, uint64_t * bits) const override;
+    void rangeBits(const int32_t * a, size_t sz, int32_t low, int32_t high, uint64_t * bits) const override;
+    void rangeBits(const int64_t * a, size_t sz, int64_t low, int64_t high, uint64_t * bits) const override;
+    void rangeBits(const float * a, size_t sz, float low, float high, uint64_t * bits) const override;
+    void rangeBits(const double * a, size_t sz, double low, double high, uint64_t * bits) const override;
     void and64(size_t offset, const std::vector<std::pair<const void *, bool>> &src, void *dest) const override;
     void or64(size_t offset, const std::vector<std::pair<const void *, bool>> &src, void *dest) const override;
 };
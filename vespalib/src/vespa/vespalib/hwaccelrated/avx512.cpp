@@ -17,6 +17,12 @@ Avx512Accelrator::dotProduct(const double * af, const double * bf, size_t sz) co
     return avx::dotProductSelectAlignment<double, 64>(af, bf, sz);
 }
 
+int64_t
+Avx512Accelrator::dotProduct(const int8_t * a, const int8_t * b, size_t sz) const
+{
+    return avx::dotProductInt8<64>(a, b, sz);
+}
+
 size_t
 Avx512Accelrator::populationCount(const uint64_t *a, size_t sz) const {
     return helper::populationCount(a, sz);
@@ -32,6 +38,81 @@ Avx512Accelrator::squaredEuclideanDistance(const double * a, const double * b, s
     return avx::euclideanDistanceSelectAlignment<double, 64>(a, b, sz);
 }
 
+double
+Avx512Accelrator::squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const {
+    return avx::euclideanDistanceInt8<64>(a, b, sz);
+}
+
+float
+Avx512Accelrator::dotProduct(const float * a, const int8_t * b, size_t sz) const {
+    return avx::dotProductMixed<64>(a, b, sz);
+}
+
+float
+Avx512Accelrator::dotProduct(const float * a, const BFloat16 * b, size_t sz) const {
+    return avx::dotProductMixed<64>(a, b, sz);
+}
+
+double
+Avx512Accelrator::squaredEuclideanDistance(const float * a, const int8_t * b, size_t sz) const {
+    return avx::euclideanDistanceMixed<64>(a, b, sz);
+}
+
+double
+Avx512Accelrator::squaredEuclideanDistance(const float * a, const BFloat16 * b, size_t sz) const {
+    return avx::euclideanDistanceMixed<64>(a, b, sz);
+}
+
+void
+Avx512Accelrator::dotProductBatch(const float * a, const float * const * rows, size_t numRows, size_t sz, float * result) const {
+    avx::dotProductBatch<float, 64>(a, rows, numRows, sz, result);
+}
+
+void
+Avx512Accelrator::dotProductBatch(const double * a, const double * const * rows, size_t numRows, size_t sz, double * result) const {
+    avx::dotProductBatch<double, 64>(a, rows, numRows, sz, result);
+}
+
+void
+Avx512Accelrator::squaredEuclideanDistanceBatch(const float * a, const float * const * rows, size_t numRows, size_t sz, double * result) const {
+    avx::euclideanDistanceBatch<float, 64>(a, rows, numRows, sz, result);
+}
+
+void
+Avx512Accelrator::squaredEuclideanDistanceBatch(const double * a, const double * const * rows, size_t numRows, size_t sz, double * result) const {
+    avx::euclideanDistanceBatch<double, 64>(a, rows, numRows, sz, result);
+}
+
+void
+Avx512Accelrator::rangeBits(const int8_t * a, size_t sz, int8_t low, int8_t high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
+void
+Avx512Accelrator::rangeBits(const int16_t * a, size_t sz, int16_t low, int16_t high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
+void
+Avx512Accelrator::rangeBits(const int32_t * a, size_t sz, int32_t low, int32_t high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
+void
+Avx512Accelrator::rangeBits(const int64_t * a, size_t sz, int64_t low, int64_t high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
+void
+Avx512Accelrator::rangeBits(const float * a, size_t sz, float low, float high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
+void
+Avx512Accelrator::rangeBits(const double * a, size_t sz, double low, double high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
 void
 Avx512Accelrator::and64(size_t offset, const std::vector<std::pair<const void *, bool>> &src, void *dest) const {
     helper::andChunks<64, 1>(offset, src, dest);
@@ -3,7 +3,9 @@
 #pragma once
 
 #include "private_helpers.hpp"
+#include <vespa/vespalib/util/bfloat16.h>
 #include <vespa/fastos/dynamiclibrary.h>
+#include <algorithm>
 
 namespace vespalib::hwaccelrated::avx {
 
@@ -115,6 +117,45 @@ euclideanDistanceT(const T * af, const T * bf, size_t sz)
     return sum + sumT<T, V>(partial[0]);
 }
 
+/**
+ * Applies a pairwise operation on int8 cells widened to int32 and sums
+ * the result. Plain loops are used since the compiler vectorizes them
+ * using the full width of the target cpu, while widening conversions of
+ * vector types are not reliably vectorized. The block sums are flushed
+ * to a 64-bit sum often enough that they cannot overflow.
+ **/
+template <unsigned VLEN, typename Op>
+int64_t
+widenedSum(const int8_t * af, const int8_t * bf, size_t sz, Op op)
+{
+    // |op(a,b)| <= 255*255 < 2^16, so 2^15 cells keep the block sum below 2^31
+    constexpr size_t BlockSize = 32768;
+    int64_t sum(0);
+    for (size_t i(0); i < sz; i += BlockSize) {
+        const size_t n = std::min(BlockSize, sz - i);
+        int32_t blockSum(0);
+        for (size_t j(0); j < n; j++) {
+            blockSum += op(int32_t(af[i+j]), int32_t(bf[i+j]));
+        }
+        sum += blockSum;
+    }
+    return sum;
+}
+
+template <unsigned VLEN>
+int64_t
+dotProductInt8(const int8_t * af, const int8_t * bf, size_t sz)
+{
+    return widenedSum<VLEN>(af, bf, sz, [](int32_t a, int32_t b) { return a * b; });
+}
+
+template <unsigned VLEN>
+double
+euclideanDistanceInt8(const int8_t * af, const int8_t * bf, size_t sz)
+{
+    return widenedSum<VLEN>(af, bf, sz, [](int32_t a, int32_t b) { return (a - b) * (a - b); });
+}
+
 template <typename T, unsigned VLEN>
 double euclideanDistanceSelectAlignment(const T * af, const T * bf, size_t sz)
 {
@@ -134,4 +175,129 @@ double euclideanDistanceSelectAlignment(const T * af, const T * bf, size_t sz)
     }
 }
 
+namespace detail {
+
+inline float widen(int8_t v) { return v; }
+
+inline float
+widen(BFloat16 v)
+{
+    uint32_t bits = uint32_t(v.get_bits()) << 16;
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+}
+
+/**
+ * Applies a float operation on a float vector and a vector of int8 or
+ * bfloat16 cells. The narrow cells are widened one block at a time to a
+ * small buffer that stays in L1 cache, using a plain loop that the
+ * compiler vectorizes.
+ **/
+template <typename T, typename FloatOp>
+double
+mixedBlockSum(const float * af, const T * bf, size_t sz, FloatOp floatOp)
+{
+    constexpr size_t BlockSize = 256;
+    float tmp[BlockSize] __attribute__((aligned(64)));
+    double sum(0);
+    for (size_t i(0); i < sz; i += BlockSize) {
+        const size_t n = std::min(BlockSize, sz - i);
+        for (size_t j(0); j < n; j++) {
+            tmp[j] = detail::widen(bf[i+j]);
+        }
+        sum += floatOp(af + i, tmp, n);
+    }
+    return sum;
+}
+
+template <unsigned VLEN, typename T>
+float
+dotProductMixed(const float * af, const T * bf, size_t sz)
+{
+    return mixedBlockSum(af, bf, sz, [](const float * a, const float * b, size_t n) {
+        return dotProductSelectAlignment<float, VLEN>(a, b, n);
+    });
+}
+
+template <unsigned VLEN, typename T>
+double
+euclideanDistanceMixed(const float * af, const T * bf, size_t sz)
+{
+    return mixedBlockSum(af, bf, sz, [](const float * a, const float * b, size_t n) {
+        return euclideanDistanceSelectAlignment<float, VLEN>(a, b, n);
+    });
+}
+
+/**
+ * Applies a pairwise operation on one vector and two rows at a time,
+ * summing the result per row. Each chunk of the vector is loaded once
+ * for both rows, and the next two rows are prefetched in step with the
+ * chunks of the current rows. An odd last row is paired with itself.
+ **/
+template <typename T, unsigned VLEN, typename R, typename Op>
+void
+batchedSumT(const T * af, const T * const * rows, size_t numRows, size_t sz, R * result, Op op)
+{
+    constexpr size_t Lanes = VLEN/sizeof(T);
+    constexpr size_t VectorsPerChunk = 2;
+    constexpr size_t ChunkSize = Lanes*VectorsPerChunk;
+    constexpr size_t CacheLineSize = 64;
+    typedef T V __attribute__ ((vector_size (VLEN)));
+    const size_t numChunks(sz/ChunkSize);
+    for (size_t row(0); row < numRows; row += 2) {
+        const T * b0 = rows[row];
+        const T * b1 = (row + 1 < numRows) ? rows[row + 1] : b0;
+        const char * next0 = reinterpret_cast<const char *>((row + 2 < numRows) ? rows[row + 2] : b0);
+        const char * next1 = reinterpret_cast<const char *>((row + 3 < numRows) ? rows[row + 3] : b1);
+        V partial0[VectorsPerChunk];
+        V partial1[VectorsPerChunk];
+        memset(partial0, 0, sizeof(partial0));
+        memset(partial1, 0, sizeof(partial1));
+        for (size_t i(0); i < numChunks; i++) {
+            for (size_t line(0); line < ChunkSize*sizeof(T); line += CacheLineSize) {
+                __builtin_prefetch(next0 + i*ChunkSize*sizeof(T) + line);
+                __builtin_prefetch(next1 + i*ChunkSize*sizeof(T) + line);
+            }
+            for (size_t j(0); j < VectorsPerChunk; j++) {
+                const size_t offset = (i*VectorsPerChunk + j)*Lanes;
+                V a, x, y;
+                memcpy(&a, af + offset, sizeof(V));
+                memcpy(&x, b0 + offset, sizeof(V));
+                memcpy(&y, b1 + offset, sizeof(V));
+                partial0[j] += op(a, x);
+                partial1[j] += op(a, y);
+            }
+        }
+        R sum0(0);
+        R sum1(0);
+        for (size_t i(numChunks*ChunkSize); i < sz; i++) {
+            sum0 += op(af[i], b0[i]);
+            sum1 += op(af[i], b1[i]);
+        }
+        partial0[0] = sumR<V, VectorsPerChunk>(partial0);
+        partial1[0] = sumR<V, VectorsPerChunk>(partial1);
+        result[row] = sum0 + sumT<T, V>(partial0[0]);
+        if (row + 1 < numRows) {
+            result[row + 1] = sum1 + sumT<T, V>(partial1[0]);
+        }
+    }
+}
+
+template <typename T, unsigned VLEN, typename R>
+void
+dotProductBatch(const T * af, const T * const * rows, size_t numRows, size_t sz, R * result)
+{
+    batchedSumT<T, VLEN>(af, rows, numRows, sz, result, [](auto a, auto b) { return a * b; });
+}
+
+template <typename T, unsigned VLEN>
+void
+euclideanDistanceBatch(const T * af, const T * const * rows, size_t numRows, size_t sz, double * result)
+{
+    batchedSumT<T, VLEN>(af, rows, numRows, sz, result, [](auto a, auto b) { return (a - b) * (a - b); });
+}
+
 }
@@ -3,6 +3,7 @@
 #include "generic.h"
 #include "private_helpers.hpp"
 #include <cblas.h>
+#include <algorithm>
 
 namespace vespalib::hwaccelrated {
 
@@ -32,11 +33,11 @@ multiplyAdd(const T * a, const T * b, size_t sz)
     return sum;
 }
 
-template <typename T, size_t UNROLL>
+template <typename ACCUM, typename T, size_t UNROLL>
 double
 euclideanDistanceT(const T * a, const T * b, size_t sz)
 {
-    T partial[UNROLL];
+    ACCUM partial[UNROLL];
     for (size_t i(0); i < UNROLL; i++) {
         partial[i] = 0;
     }
@@ -56,6 +57,46 @@ euclideanDistanceT(const T * a, const T * b, size_t sz)
     return sum;
 }
 
+// bfloat16 cells are widened to float one block at a time and
+// handed to the (possibly cpu specific) float implementation.
+template <typename FloatOp>
+double
+bfloat16BlockOperation(const BFloat16 * a, const BFloat16 * b, size_t sz, FloatOp floatOp)
+{
+    constexpr size_t BLOCK_SIZE = 256;
+    float af[BLOCK_SIZE] __attribute__((aligned(64)));
+    float bf[BLOCK_SIZE] __attribute__((aligned(64)));
+    double sum(0);
+    for (size_t i(0); i < sz; i += BLOCK_SIZE) {
+        size_t n = std::min(BLOCK_SIZE, sz - i);
+        for (size_t j(0); j < n; j++) {
+            af[j] = a[i+j];
+            bf[j] = b[i+j];
+        }
+        sum += floatOp(af, bf, n);
+    }
+    return sum;
+}
+
+// int8 and bfloat16 cells are widened to float one block at a time and
+// handed to the (possibly cpu specific) float implementation together with the float vector.
+template <typename T, typename FloatOp>
+double
+mixedBlockOperation(const float * a, const T * b, size_t sz, FloatOp floatOp)
+{
+    constexpr size_t BLOCK_SIZE = 256;
+    float bf[BLOCK_SIZE] __attribute__((aligned(64)));
+    double sum(0);
+    for (size_t i(0); i < sz; i += BLOCK_SIZE) {
+        size_t n = std::min(BLOCK_SIZE, sz - i);
+        for (size_t j(0); j < n; j++) {
+            bf[j] = b[i+j];
+        }
+        sum += floatOp(a + i, bf, n);
+    }
+    return sum;
+}
+
 template<size_t UNROLL, typename Operation>
 void
 bitOperation(Operation operation, void * aOrg, const void * bOrg, size_t bytes) {
@@ -119,6 +160,14 @@ GenericAccelrator::dotProduct(const int64_t * a, const int64_t * b, size_t sz) c
     return multiplyAdd<long long, int64_t, 8>(a, b, sz);
 }
 
+float
+GenericAccelrator::dotProduct(const BFloat16 * a, const BFloat16 * b, size_t sz) const
+{
+    return bfloat16BlockOperation(a, b, sz, [this](const float * af, const float * bf, size_t n) {
+        return dotProduct(af, bf, n);
+    });
+}
+
 void
 GenericAccelrator::orBit(void * aOrg, const void * bOrg, size_t bytes) const
 {
@@ -157,12 +206,166 @@ GenericAccelrator::populationCount(const uint64_t *a, size_t sz) const {
 
 double
 GenericAccelrator::squaredEuclideanDistance(const float * a, const float * b, size_t sz) const {
-    return euclideanDistanceT<float, 8>(a, b, sz);
+    return euclideanDistanceT<float, float, 8>(a, b, sz);
 }
 
 double
 GenericAccelrator::squaredEuclideanDistance(const double * a, const double * b, size_t sz) const {
-    return euclideanDistanceT<double, 4>(a, b, sz);
+    return euclideanDistanceT<double, double, 4>(a, b, sz);
+}
+
+double
+GenericAccelrator::squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const {
+    return euclideanDistanceT<int64_t, int8_t, 8>(a, b, sz);
+}
+
+double
+GenericAccelrator::squaredEuclideanDistance(const BFloat16 * a, const BFloat16 * b, size_t sz) const {
+    return bfloat16BlockOperation(a, b, sz, [this](const float * af, const float * bf, size_t n) {
+        return squaredEuclideanDistance(af, bf, n);
+    });
+}
+
+float
+GenericAccelrator::dotProduct(const float * a, const int8_t * b, size_t sz) const
+{
+    return mixedBlockOperation(a, b, sz, [this](const float * af, const float * bf, size_t n) {
+        return dotProduct(af, bf, n);
+    });
+}
+
+float
+GenericAccelrator::dotProduct(const float * a, const BFloat16 * b, size_t sz) const
+{
+    return mixedBlockOperation(a, b, sz, [this](const float * af, const float * bf, size_t n) {
+        return dotProduct(af, bf, n);
+    });
+}
+
+double
+GenericAccelrator::squaredEuclideanDistance(const float * a, const int8_t * b, size_t sz) const
+{
+    return mixedBlockOperation(a, b, sz, [this](const float * af, const float * bf, size_t n) {
+        return squaredEuclideanDistance(af, bf, n);
+    });
+}
+
+double
+GenericAccelrator::squaredEuclideanDistance(const float * a, const BFloat16 * b, size_t sz) const
+{
+    return mixedBlockOperation(a, b, sz, [this](const float * af, const float * bf, size_t n) {
+        return squaredEuclideanDistance(af, bf, n);
+    });
+}
+
+void
+GenericAccelrator::dotProductBatch(const float * a, const float * const * rows, size_t numRows, size_t sz, float * result) const
+{
+    helper::batchOperation(a, rows, numRows, sz, result, [this](const float * af, const float * bf, size_t n) {
+        return dotProduct(af, bf, n);
+    });
+}
+
+void
+GenericAccelrator::dotProductBatch(const double * a, const double * const * rows, size_t numRows, size_t sz, double * result) const
+{
+    helper::batchOperation(a, rows, numRows, sz, result, [this](const double * af, const double * bf, size_t n) {
+        return dotProduct(af, bf, n);
+    });
+}
+
+void
+GenericAccelrator::dotProductBatch(const int8_t * a, const int8_t * const * rows, size_t numRows, size_t sz, int64_t * result) const
+{
+    helper::batchOperation(a, rows, numRows, sz, result, [this](const int8_t * af, const int8_t * bf, size_t n) {
+        return dotProduct(af, bf, n);
+    });
+}
+
+void
+GenericAccelrator::dotProductBatch(const float * a, const int8_t * const * rows, size_t numRows, size_t sz, float * result) const
+{
+    helper::batchOperation(a, rows, numRows, sz, result, [this](const float * af, const int8_t * bf, size_t n) {
+        return dotProduct(af, bf, n);
+    });
+}
+
+void
+GenericAccelrator::dotProductBatch(const float * a, const BFloat16 * const * rows, size_t numRows, size_t sz, float * result) const
+{
+    helper::batchOperation(a, rows, numRows, sz, result, [this](const float * af, const BFloat16 * bf, size_t n) {
+        return dotProduct(af, bf, n);
+    });
+}
+
+void
+GenericAccelrator::squaredEuclideanDistanceBatch(const float * a, const float * const * rows, size_t numRows, size_t sz, double * result) const
+{
+    helper::batchOperation(a, rows, numRows, sz, result, [this](const float * af, const float * bf, size_t n) {
+        return squaredEuclideanDistance(af, bf, n);
+    });
+}
+
+void
+GenericAccelrator::squaredEuclideanDistanceBatch(const double * a, const double * const * rows, size_t numRows, size_t sz, double * result) const
+{
+    helper::batchOperation(a, rows, numRows, sz, result, [this](const double * af, const double * bf, size_t n) {
+        return squaredEuclideanDistance(af, bf, n);
+    });
+}
+
+void
+GenericAccelrator::squaredEuclideanDistanceBatch(const int8_t * a, const int8_t * const * rows, size_t numRows, size_t sz, double * result) const
+{
+    helper::batchOperation(a, rows, numRows, sz, result, [this](const int8_t * af, const int8_t * bf, size_t n) {
+        return squaredEuclideanDistance(af, bf, n);
+    });
+}
+
+void
+GenericAccelrator::squaredEuclideanDistanceBatch(const float * a, const int8_t * const * rows, size_t numRows, size_t sz, double * result) const
+{
+    helper::batchOperation(a, rows, numRows, sz, result, [this](const float * af, const int8_t * bf, size_t n) {
+        return squaredEuclideanDistance(af, bf, n);
+    });
+}
+
+void
+GenericAccelrator::squaredEuclideanDistanceBatch(const float * a, const BFloat16 * const * rows, size_t numRows, size_t sz, double * result) const
+{
+    helper::batchOperation(a, rows, numRows, sz, result, [this](const float * af, const BFloat16 * bf, size_t n) {
+        return squaredEuclideanDistance(af, bf, n);
+    });
+}
+
+void
+GenericAccelrator::rangeBits(const int8_t * a, size_t sz, int8_t low, int8_t high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
+void
+GenericAccelrator::rangeBits(const int16_t * a, size_t sz, int16_t low, int16_t high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
+void
+GenericAccelrator::rangeBits(const int32_t * a, size_t sz, int32_t low, int32_t high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
+void
+GenericAccelrator::rangeBits(const int64_t * a, size_t sz, int64_t low, int64_t high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
+void
+GenericAccelrator::rangeBits(const float * a, size_t sz, float low, float high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
+}
+
+void
+GenericAccelrator::rangeBits(const double * a, size_t sz, double low, double high, uint64_t * bits) const {
+    helper::rangeBits(a, sz, low, high, bits);
 }
 
 void
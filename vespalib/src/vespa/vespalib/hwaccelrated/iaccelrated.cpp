@@ -86,6 +86,88 @@ verifyEuclideanDistance(const IAccelrated & accel) {
     }
 }
 
+void
+verifyInt8(const IAccelrated & accel) {
+    const size_t testLength(255);
+    srand(1);
+    std::vector<int8_t> a(testLength);
+    std::vector<int8_t> b(testLength);
+    for (size_t i(0); i < testLength; i++) {
+        a[i] = rand()%256 - 128;
+        b[i] = rand()%256 - 128;
+    }
+    for (size_t j(0); j < 0x20; j++) {
+        int64_t dotProduct(0);
+        int64_t distance(0);
+        for (size_t i(j); i < testLength; i++) {
+            dotProduct += a[i] * b[i];
+            distance += (a[i] - b[i]) * (a[i] - b[i]);
+        }
+        if (dotProduct != accel.dotProduct(&a[j], &b[j], testLength - j)) {
+            fprintf(stderr, "Accelrator is not computing int8 dotproduct correctly.\n");
+            LOG_ABORT("should not be reached");
+        }
+        if (double(distance) != accel.squaredEuclideanDistance(&a[j], &b[j], testLength - j)) {
+            fprintf(stderr, "Accelrator is not computing int8 euclidean distance correctly.\n");
+            LOG_ABORT("should not be reached");
+        }
+    }
+}
+
+template<typename T>
+void
+verifyBatch(const IAccelrated & accel) {
+    const size_t testLength(255);
+    const size_t numRows(5);
+    srand(1);
+    std::vector<T> a = createAndFill<T>(testLength);
+    std::vector<std::vector<T>> rows;
+    std::vector<const T *> rowPtrs;
+    for (size_t i(0); i < numRows; i++) {
+        rows.push_back(createAndFill<T>(testLength));
+    }
+    for (const auto & row : rows) {
+        rowPtrs.push_back(&row[0]);
+    }
+    std::vector<T> dotProducts(numRows);
+    std::vector<double> distances(numRows);
+    accel.dotProductBatch(&a[0], &rowPtrs[0], numRows, testLength, &dotProducts[0]);
+    accel.squaredEuclideanDistanceBatch(&a[0], &rowPtrs[0], numRows, testLength, &distances[0]);
+    for (size_t i(0); i < numRows; i++) {
+        if (dotProducts[i] != accel.dotProduct(&a[0], rowPtrs[i], testLength)) {
+            fprintf(stderr, "Accelrator is not computing batched dotproduct correctly.\n");
+            LOG_ABORT("should not be reached");
+        }
+        if (distances[i] != accel.squaredEuclideanDistance(&a[0], rowPtrs[i], testLength)) {
+            fprintf(stderr, "Accelrator is not computing batched euclidean distance correctly.\n");
+            LOG_ABORT("should not be reached");
+        }
+    }
+}
+
+void
+verifyMixed(const IAccelrated & accel) {
+    const size_t testLength(255);
+    srand(1);
+    std::vector<float> a = createAndFill<float>(testLength);
+    std::vector<int8_t> b(testLength);
+    std::vector<float> bf(testLength);
+    for (size_t i(0); i < testLength; i++) {
+        b[i] = rand()%256 - 128;
+        bf[i] = b[i];
+    }
+    for (size_t j(0); j < 0x20; j++) {
+        if (accel.dotProduct(&a[j], &bf[j], testLength - j) != accel.dotProduct(&a[j], &b[j], testLength - j)) {
+            fprintf(stderr, "Accelrator is not computing mixed float/int8 dotproduct correctly.\n");
+            LOG_ABORT("should not be reached");
+        }
+        if (accel.squaredEuclideanDistance(&a[j], &bf[j], testLength - j) != accel.squaredEuclideanDistance(&a[j], &b[j], testLength - j)) {
+            fprintf(stderr, "Accelrator is not computing mixed float/int8 euclidean distance correctly.\n");
+            LOG_ABORT("should not be reached");
+        }
+    }
+}
+
 void
 verifyPopulationCount(const IAccelrated & accel)
 {
@@ -104,6 +186,23 @@ verifyPopulationCount(const IAccelrated & accel)
     }
 }
 
+template<typename T>
+void
+verifyRangeBits(const IAccelrated & accel) {
+    const size_t testLength(256);
+    srand(1);
+    std::vector<T> a = createAndFill<T>(testLength);
+    std::vector<uint64_t> bits(testLength / 64);
+    accel.rangeBits(&a[0], testLength, T(20), T(60), &bits[0]);
+    for (size_t i(0); i < testLength; i++) {
+        bool expected = (T(20) <= a[i]) && (a[i] <= T(60));
+        if (((bits[i / 64] >> (i % 64)) & 1) != expected) {
+            fprintf(stderr, "Accelrator is not computing rangeBits correctly.\n");
+            LOG_ABORT("should not be reached");
+        }
+    }
+}
+
 void
 fill(std::vector<uint64_t> & v, size_t n) {
     v.reserve(n);
@@ -228,7 +327,17 @@ private:
         verifyDotproduct<int64_t>(accelrated);
         verifyEuclideanDistance<float>(accelrated);
         verifyEuclideanDistance<double>(accelrated);
+        verifyInt8(accelrated);
+        verifyBatch<float>(accelrated);
+        verifyBatch<double>(accelrated);
+        verifyMixed(accelrated);
         verifyPopulationCount(accelrated);
+        verifyRangeBits<int8_t>(accelrated);
+        verifyRangeBits<int16_t>(accelrated);
+        verifyRangeBits<int32_t>(accelrated);
+        verifyRangeBits<int64_t>(accelrated);
+        verifyRangeBits<float>(accelrated);
+        verifyRangeBits<double>(accelrated);
         verifyAnd64(accelrated);
         verifyOr64(accelrated);
     }
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <vespa/vespalib/util/bfloat16.h>
 #include <memory>
 #include <cstdint>
 #include <vector>
@@ -23,6 +24,7 @@ public:
     virtual int64_t dotProduct(const int16_t * a, const int16_t * b, size_t sz) const = 0;
     virtual int64_t dotProduct(const int32_t * a, const int32_t * b, size_t sz) const = 0;
     virtual long long dotProduct(const int64_t * a, const int64_t * b, size_t sz) const = 0;
+    virtual float dotProduct(const BFloat16 * a, const BFloat16 * b, size_t sz) const = 0;
     virtual void orBit(void * a, const void * b, size_t bytes) const = 0;
     virtual void andBit(void * a, const void * b, size_t bytes) const = 0;
     virtual void andNotBit(void * a, const void * b, size_t bytes) const = 0;
@@ -30,6 +32,31 @@ public:
     virtual size_t populationCount(const uint64_t *a, size_t sz) const = 0;
     virtual double squaredEuclideanDistance(const float * a, const float * b, size_t sz) const = 0;
     virtual double squaredEuclideanDistance(const double * a, const double * b, size_t sz) const = 0;
+    virtual double squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const = 0;
+    virtual double squaredEuclideanDistance(const BFloat16 * a, const BFloat16 * b, size_t sz) const = 0;
+    // Mixed precision; a float vector (typically the query) against int8 or bfloat16 cells
+    virtual float dotProduct(const float * a, const int8_t * b, size_t sz) const = 0;
+    virtual float dotProduct(const float * a, const BFloat16 * b, size_t sz) const = 0;
+    virtual double squaredEuclideanDistance(const float * a, const int8_t * b, size_t sz) const = 0;
+    virtual double squaredEuclideanDistance(const float * a, const BFloat16 * b, size_t sz) const = 0;
+    // One vector against numRows vectors of sz cells each; result[i] is computed from a and rows[i]
+    virtual void dotProductBatch(const float * a, const float * const * rows, size_t numRows, size_t sz, float * result) const = 0;
+    virtual void dotProductBatch(const double * a, const double * const * rows, size_t numRows, size_t sz, double * result) const = 0;
+    virtual void dotProductBatch(const int8_t * a, const int8_t * const * rows, size_t numRows, size_t sz, int64_t * result) const = 0;
+    virtual void dotProductBatch(const float * a, const int8_t * const * rows, size_t numRows, size_t sz, float * result) const = 0;
+    virtual void dotProductBatch(const float * a, const BFloat16 * const * rows, size_t numRows, size_t sz, float * result) const = 0;
+    virtual void squaredEuclideanDistanceBatch(const float * a, const float * const * rows, size_t numRows, size_t sz, double * result) const = 0;
+    virtual void squaredEuclideanDistanceBatch(const double * a, const double * const * rows, size_t numRows, size_t sz, double * result) const = 0;
+    virtual void squaredEuclideanDistanceBatch(const int8_t * a, const int8_t * const * rows, size_t numRows, size_t sz, double * result) const = 0;
+    virtual void squaredEuclideanDistanceBatch(const float * a, const int8_t * const * rows, size_t numRows, size_t sz, double * result) const = 0;
+    virtual void squaredEuclideanDistanceBatch(const float * a, const BFloat16 * const * rows, size_t numRows, size_t sz, double * result) const = 0;
+    // Sets bit i of bits when low <= a[i] <= high; sz must be a multiple of 64 and bits holds sz/64 words
+    virtual void rangeBits(const int8_t * a, size_t sz, int8_t low, int8_t high, uint64_t * bits) const = 0;
+    virtual void rangeBits(const int16_t * a, size_t sz, int16_t low, int16_t high, uint64_t * bits) const = 0;
+    virtual void rangeBits(const int32_t * a, size_t sz, int32_t low, int32_t high, uint64_t * bits) const = 0;
+    virtual void rangeBits(const int64_t * a, size_t sz, int64_t low, int64_t high, uint64_t * bits) const = 0;
+    virtual void rangeBits(const float * a, size_t sz, float low, float high, uint64_t * bits) const = 0;
+    virtual void rangeBits(const double * a, size_t sz, double low, double high, uint64_t * bits) const = 0;
     // AND 64 bytes from multiple, optionally inverted sources
     virtual void and64(size_t offset, const std::vector<std::pair<const void *, bool>> &src, void *dest) const = 0;
     // OR 64 bytes from multiple, optionally inverted sources
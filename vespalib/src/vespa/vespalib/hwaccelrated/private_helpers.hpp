@@ -3,6 +3,7 @@
 #pragma once
 
 #include <vespa/vespalib/util/optimized.h>
+#include <algorithm>
 #include <cstring>
 
 namespace vespalib::hwaccelrated::helper {
@@ -24,6 +25,57 @@ populationCount(const uint64_t *a, size_t sz) {
     return count;
 }
 
+// Prefetches the start of a vector; the hardware prefetcher takes care of the rest when it is streamed.
+template <typename T>
+void
+prefetchRow(const T * row, size_t sz) {
+    constexpr size_t CacheLineSize = 64;
+    constexpr size_t MaxPrefetchBytes = 16 * CacheLineSize;
+    const char * p = reinterpret_cast<const char *>(row);
+    const size_t bytes = std::min(sz * sizeof(T), MaxPrefetchBytes);
+    for (size_t i(0); i < bytes; i += CacheLineSize) {
+        __builtin_prefetch(p + i);
+    }
+}
+
+/**
+ * Computes result[i] = pairOp(a, rows[i], sz) for all rows, prefetching
+ * the next row while the current one is computed.
+ */
+template <typename A, typename B, typename R, typename PairOp>
+void
+batchOperation(const A * a, const B * const * rows, size_t numRows, size_t sz, R * result, PairOp pairOp) {
+    for (size_t i(0); i < numRows; i++) {
+        if (i + 1 < numRows) {
+            prefetchRow(rows[i + 1], sz);
+        }
+        result[i] = pairOp(a, rows[i], sz);
+    }
+}
+
+/**
+ * Sets one bit per value telling if it is in [low, high]. The comparisons
+ * for 64 values are done into a byte mask first, which the compiler can
+ * vectorize, and the byte mask is then packed 8 bytes at a time into bits.
+ */
+template <typename T>
+void
+rangeBits(const T * a, size_t sz, T low, T high, uint64_t * bits) {
+    for (size_t i(0); (i + 64) <= sz; i += 64) {
+        uint8_t matches[64];
+        for (size_t j(0); j < 64; j++) {
+            matches[j] = (low <= a[i + j]) & (a[i + j] <= high);
+        }
+        uint64_t word(0);
+        for (size_t j(0); j < 64; j += 8) {
+            uint64_t packed;
+            memcpy(&packed, matches + j, sizeof(packed));
+            word |= ((packed * 0x0102040810204080ul) >> 56) << j;
+        }
+        bits[i / 64] = word;
+    }
+}
+
 template<typename T>
 T get(const void * base, bool invert) {
     T v;
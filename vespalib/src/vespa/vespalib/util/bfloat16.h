@@ -0,0 +1,50 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace vespalib {
+
+/**
+ * 16-bit brain floating point number; the upper half of an IEEE 754
+ * single precision float. Keeps the full exponent range of float
+ * with 8 bits of mantissa precision. Conversion from float rounds
+ * to nearest even, conversion to float is exact.
+ **/
+class BFloat16 {
+private:
+    uint16_t _bits;
+
+    static uint16_t float_to_bits(float value) noexcept {
+        uint32_t as_u32;
+        memcpy(&as_u32, &value, sizeof(as_u32));
+        if ((as_u32 & 0x7fffffffu) > 0x7f800000u) {
+            // NaN: truncate, but keep it a (quiet) NaN
+            return (as_u32 >> 16) | 0x0040u;
+        }
+        uint32_t rounding_bias = 0x7fffu + ((as_u32 >> 16) & 1u);
+        return (as_u32 + rounding_bias) >> 16;
+    }
+public:
+    constexpr BFloat16() noexcept : _bits(0) {}
+    BFloat16(float value) noexcept : _bits(float_to_bits(value)) {}
+    float to_float() const noexcept {
+        uint32_t as_u32 = uint32_t(_bits) << 16;
+        float result;
+        memcpy(&result, &as_u32, sizeof(result));
+        return result;
+    }
+    operator float() const noexcept { return to_float(); }
+    uint16_t get_bits() const noexcept { return _bits; }
+    static BFloat16 from_bits(uint16_t bits) noexcept {
+        BFloat16 result;
+        result._bits = bits;
+        return result;
+    }
+};
+
+static_assert(sizeof(BFloat16) == sizeof(uint16_t), "BFloat16 must be 2 bytes");
+
+}
@@ -56,7 +56,7 @@ compress(ICompressor & compressor, const CompressionConfig & compression, const
 }
 
 CompressionConfig::Type
-docompress(const CompressionConfig & compression, const ConstBufferRef & org, DataBuffer & dest)
+docompress(const CompressionConfig & compression, const ZStdDictionary * dictionary, const ConstBufferRef & org, DataBuffer & dest)
 {
     CompressionConfig::Type type(CompressionConfig::NONE);
     switch (compression.type) {
@@ -68,7 +68,7 @@ docompress(const CompressionConfig & compression, const ConstBufferRef & org, Da
         break;
     case CompressionConfig::ZSTD:
         {
-            ZStdCompressor zstd;
+            ZStdCompressor zstd(dictionary);
             type = compress(zstd, compression, org, dest);
         }
         break;
@@ -81,10 +81,16 @@ docompress(const CompressionConfig & compression, const ConstBufferRef & org, Da
 
 CompressionConfig::Type
 compress(const CompressionConfig & compression, const ConstBufferRef & org, DataBuffer & dest, bool allowSwap)
+{
+    return compress(compression, nullptr, org, dest, allowSwap);
+}
+
+CompressionConfig::Type
+compress(const CompressionConfig & compression, const ZStdDictionary * dictionary, const ConstBufferRef & org, DataBuffer & dest, bool allowSwap)
 {
     CompressionConfig::Type type(CompressionConfig::NONE);
     if (org.size() >= compression.minSize) {
-        type = docompress(compression, org, dest);
+        type = docompress(compression, dictionary, org, dest);
     }
     if (type == CompressionConfig::NONE) {
         if (allowSwap) {
@@ -124,6 +130,13 @@ decompress(ICompressor & decompressor, size_t uncompressedLen, const ConstBuffer
 
 void
 decompress(const CompressionConfig::Type & type, size_t uncompressedLen, const ConstBufferRef & org, DataBuffer & dest, bool allowSwap)
+{
+    decompress(type, nullptr, uncompressedLen, org, dest, allowSwap);
+}
+
+void
+decompress(const CompressionConfig::Type & type, const ZStdDictionary * dictionary, size_t uncompressedLen,
+           const ConstBufferRef & org, DataBuffer & dest, bool allowSwap)
 {
     switch (type) {
     case CompressionConfig::LZ4:
@@ -134,7 +147,7 @@ decompress(const CompressionConfig::Type & type, size_t uncompressedLen, const C
         break;
         case CompressionConfig::ZSTD:
         {
-            ZStdCompressor zstd;
+            ZStdCompressor zstd(dictionary);
             decompress(zstd, uncompressedLen, org, dest, allowSwap);
         }
         break;
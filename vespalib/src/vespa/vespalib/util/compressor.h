@@ -9,6 +9,8 @@ namespace vespalib { class DataBuffer; }
 
 namespace vespalib::compression {
 
+class ZStdDictionary;
+
 class ICompressor
 {
 public:
@@ -29,6 +31,12 @@ public:
  */
 CompressionConfig::Type compress(const CompressionConfig & compression, const vespalib::ConstBufferRef & org, vespalib::DataBuffer & dest, bool allowSwap);
 
+/**
+ * As above, but zstd compression will use the given dictionary unless it is nullptr.
+ */
+CompressionConfig::Type compress(const CompressionConfig & compression, const ZStdDictionary * dictionary,
+                                 const vespalib::ConstBufferRef & org, vespalib::DataBuffer & dest, bool allowSwap);
+
 /**
  * Will try to decompress a buffer according to the config.
  * be met it will return NONE and dest will get the input buffer.
@@ -42,6 +50,13 @@ CompressionConfig::Type compress(const CompressionConfig & compression, const ve
  */
 void decompress(const CompressionConfig::Type & compression, size_t uncompressedLen, const vespalib::ConstBufferRef & org, vespalib::DataBuffer & dest, bool allowSwap);
 
+/**
+ * As above, but zstd frames compressed with a dictionary will be
+ * decompressed with the given one. It must be the dictionary used for compression.
+ */
+void decompress(const CompressionConfig::Type & compression, const ZStdDictionary * dictionary, size_t uncompressedLen,
+                const vespalib::ConstBufferRef & org, vespalib::DataBuffer & dest, bool allowSwap);
+
 size_t computeMaxCompressedsize(CompressionConfig::Type type, size_t uncompressedSize);
 
 //-----------------------------------------------------------------------------
@@ -35,6 +35,12 @@ private:
      **/
     virtual void mingle() = 0;
 
+    /**
+     * Wait for all threads to be present and let the last thread
+     * arriving perform the mingle operation.
+     **/
+    void meet_others(IN &input, OUT &ret, size_t my_id, MonitorGuard &guard);
+
 protected:
     /**
      * Obtain the number of input and output values to be handled by
@@ -81,6 +87,21 @@ public:
      * @param input input parameter for a single thread
      **/
     OUT rendezvous(IN input);
+
+    /**
+     * Called by individual threads to synchronize execution and share
+     * state with the mingle function where each caller has a
+     * pre-defined participation id (enable external thread
+     * identification). All threads meeting in the same rendezvous
+     * must use different ids in the range [0 .. size-1]. The input
+     * and output values of a thread will be available to the mingle
+     * function using its id as index.
+     *
+     * @return output parameter for a single thread
+     * @param input input parameter for a single thread
+     * @param my_id participation id for this thread
+     **/
+    OUT rendezvous(IN input, size_t my_id);
 };
 
 } // namespace vespalib
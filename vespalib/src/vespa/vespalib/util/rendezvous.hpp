@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "exceptions.h"
+#include <cassert>
 
 namespace vespalib {
 
@@ -21,6 +22,25 @@ Rendezvous<IN, OUT>::Rendezvous(size_t n)
 template <typename IN, typename OUT>
 Rendezvous<IN, OUT>::~Rendezvous() = default;
 
+template <typename IN, typename OUT>
+void
+Rendezvous<IN, OUT>::meet_others(IN &input, OUT &ret, size_t my_id, MonitorGuard &guard)
+{
+    _in[my_id] = &input;
+    _out[my_id] = &ret;
+    if (++_next == _size) {
+        mingle();
+        _next = 0;
+        ++_gen;
+        guard.broadcast();
+    } else {
+        size_t oldgen = _gen;
+        while (oldgen == _gen) {
+            guard.wait();
+        }
+    }
+}
+
 template <typename IN, typename OUT>
 OUT
 Rendezvous<IN, OUT>::rendezvous(IN input)
@@ -32,20 +52,24 @@ Rendezvous<IN, OUT>::rendezvous(IN input)
         mingle();
     } else {
         MonitorGuard guard(_monitor);
-        size_t me = _next++;
-        _in[me] = &input;
-        _out[me] = &ret;
-        if (_next == _size) {
-            mingle();
-            _next = 0;
-            ++_gen;
-            guard.broadcast();
-        } else {
-            size_t oldgen = _gen;
-            while (oldgen == _gen) {
-                guard.wait();
-            }
-        }
+        meet_others(input, ret, _next, guard);
+    }
+    return ret;
+}
+
+template <typename IN, typename OUT>
+OUT
+Rendezvous<IN, OUT>::rendezvous(IN input, size_t my_id)
+{
+    OUT ret = OUT();
+    assert(my_id < _size);
+    if (_size == 1) {
+        _in[0] = &input;
+        _out[0] = &ret;
+        mingle();
+    } else {
+        MonitorGuard guard(_monitor);
+        meet_others(input, ret, my_id, guard);
     }
     return ret;
 }
@@ -3,7 +3,10 @@
 #include "zstdcompressor.h"
 #include <vespa/vespalib/util/alloc.h>
 #include <vespa/vespalib/util/sync.h>
+#include <vespa/vespalib/util/stringfmt.h>
 #include <zstd.h>
+#include <zdict.h>
+#include <stdexcept>
 #include <vector>
 #include <cassert>
 
@@ -35,6 +38,51 @@ thread_local std::unique_ptr<DecompressContext> _tlDecompressState;
 
 }
 
+ZStdDictionary::ZStdDictionary(ConstBufferRef dictionary)
+    : _buffer(dictionary.c_str(), dictionary.c_str() + dictionary.size()),
+      _id(ZSTD_getDictID_fromDict(_buffer.data(), _buffer.size())),
+      _cdict(nullptr),
+      _ddict(ZSTD_createDDict(_buffer.data(), _buffer.size()))
+{
+    if (_ddict == nullptr) {
+        throw std::runtime_error(make_string("Failed creating zstd decompression dictionary of %zu bytes", _buffer.size()));
+    }
+}
+
+ZStdDictionary::ZStdDictionary(ConstBufferRef dictionary, int compressionLevel)
+    : ZStdDictionary(dictionary)
+{
+    _cdict = ZSTD_createCDict(_buffer.data(), _buffer.size(), compressionLevel);
+    if (_cdict == nullptr) {
+        ZSTD_freeDDict(_ddict);
+        throw std::runtime_error(make_string("Failed creating zstd compression dictionary of %zu bytes", _buffer.size()));
+    }
+}
+
+ZStdDictionary::~ZStdDictionary()
+{
+    ZSTD_freeCDict(_cdict);
+    ZSTD_freeDDict(_ddict);
+}
+
+std::unique_ptr<ZStdDictionary>
+ZStdDictionary::train(const void * samples, const std::vector<size_t> & sampleSizes, size_t maxSize)
+{
+    std::vector<char> dictionary(maxSize);
+    size_t sz = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), samples,
+                                      sampleSizes.data(), sampleSizes.size());
+    if (ZDICT_isError(sz)) {
+        return std::unique_ptr<ZStdDictionary>();
+    }
+    return std::make_unique<ZStdDictionary>(ConstBufferRef(dictionary.data(), sz));
+}
+
+uint32_t
+ZStdDictionary::getFrameDictionaryId(const void * frame, size_t frameLen)
+{
+    return ZSTD_getDictID_fromFrame(frame, frameLen);
+}
+
 size_t ZStdCompressor::adjustProcessLen(uint16_t, size_t len)   const { return ZSTD_compressBound(len); }
 
 bool
@@ -44,7 +92,9 @@ ZStdCompressor::process(const CompressionConfig& config, const void * inputV, si
     if ( ! _tlCompressState) {
         _tlCompressState = std::make_unique<CompressContext>();
     }
-    size_t sz = ZSTD_compressCCtx(_tlCompressState->get(), outputV, maxOutputLen, inputV, inputLen, config.compressionLevel);
+    size_t sz = ((_dictionary != nullptr) && _dictionary->canCompress())
+                ? ZSTD_compress_usingCDict(_tlCompressState->get(), outputV, maxOutputLen, inputV, inputLen, _dictionary->getCDict())
+                : ZSTD_compressCCtx(_tlCompressState->get(), outputV, maxOutputLen, inputV, inputLen, config.compressionLevel);
     assert( ! ZSTD_isError(sz) );
     outputLenV = sz;
     return ! ZSTD_isError(sz);
@@ -56,7 +106,13 @@ ZStdCompressor::unprocess(const void * inputV, size_t inputLen, void * outputV,
     if ( ! _tlDecompressState) {
         _tlDecompressState = std::make_unique<DecompressContext>();
     }
-    size_t sz = ZSTD_decompressDCtx(_tlDecompressState->get(), outputV, outputLenV, inputV, inputLen);
+    uint32_t dictId = ZSTD_getDictID_fromFrame(inputV, inputLen);
+    if ((dictId != 0) && ((_dictionary == nullptr) || (_dictionary->getId() != dictId))) {
+        return false;
+    }
+    size_t sz = (dictId != 0)
+                ? ZSTD_decompress_usingDDict(_tlDecompressState->get(), outputV, outputLenV, inputV, inputLen, _dictionary->getDDict())
+                : ZSTD_decompressDCtx(_tlDecompressState->get(), outputV, outputLenV, inputV, inputLen);
     assert( ! ZSTD_isError(sz) );
     outputLenV = sz;
     return ! ZSTD_isError(sz);
@@ -2,15 +2,72 @@
 #pragma once
 
 #include "compressor.h"
+#include <memory>
+#include <vector>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
 
 namespace vespalib::compression {
 
+/**
+ * A zstd dictionary, typically trained from samples of the data to be
+ * compressed. Using a dictionary improves the compression ratio of
+ * small inputs sharing a common vocabulary, as each input does not need
+ * to learn it again. The dictionary is always prepared for
+ * decompression, and also for compression when constructed with a
+ * compression level.
+ */
+class ZStdDictionary
+{
+public:
+    using SP = std::shared_ptr<const ZStdDictionary>;
+    explicit ZStdDictionary(ConstBufferRef dictionary);
+    ZStdDictionary(ConstBufferRef dictionary, int compressionLevel);
+    ZStdDictionary(const ZStdDictionary &) = delete;
+    ZStdDictionary & operator = (const ZStdDictionary &) = delete;
+    ~ZStdDictionary();
+    uint32_t getId() const { return _id; }
+    ConstBufferRef getBuffer() const { return ConstBufferRef(_buffer.data(), _buffer.size()); }
+    bool canCompress() const { return _cdict != nullptr; }
+    const ZSTD_CDict_s * getCDict() const { return _cdict; }
+    const ZSTD_DDict_s * getDDict() const { return _ddict; }
+
+    /**
+     * Train a dictionary of at most maxSize bytes from the given samples,
+     * which are stored back to back in one buffer. The returned
+     * dictionary is only prepared for decompression. Returns an empty
+     * pointer if training failed, e.g. due to too few samples.
+     */
+    static std::unique_ptr<ZStdDictionary> train(const void * samples, const std::vector<size_t> & sampleSizes, size_t maxSize);
+    /**
+     * Returns the id of the dictionary needed to decompress the given
+     * zstd frame, or 0 if no dictionary is needed.
+     */
+    static uint32_t getFrameDictionaryId(const void * frame, size_t frameLen);
+private:
+    std::vector<char> _buffer;
+    uint32_t          _id;
+    ZSTD_CDict_s    * _cdict;
+    ZSTD_DDict_s    * _ddict;
+};
+
 class ZStdCompressor : public ICompressor
 {
 public:
+    ZStdCompressor() : _dictionary(nullptr) { }
+    /**
+     * Use the given dictionary for compression (if it can compress) and
+     * for decompressing frames that were compressed with it. The
+     * compression level of the dictionary takes precedence over the one
+     * in the config.
+     */
+    explicit ZStdCompressor(const ZStdDictionary * dictionary) : _dictionary(dictionary) { }
     bool process(const CompressionConfig& config, const void * input, size_t inputLen, void * output, size_t & outputLen) override;
     bool unprocess(const void * input, size_t inputLen, void * output, size_t & outputLen) override;
     size_t adjustProcessLen(uint16_t options, size_t len)   const override;
+private:
+    const ZStdDictionary * _dictionary;
 };
 
 }